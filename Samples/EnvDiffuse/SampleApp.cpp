@@ -30,6 +30,7 @@
 
 #include <DemoFramework/Direct3D12/Shader.hpp>
 #include <DemoFramework/Direct3D12/Sync.hpp>
+#include <DemoFramework/Direct3D12/UploadRing.hpp>
 #include <DemoFramework/Direct3D12/WavefrontObj.hpp>
 
 #include <DemoFramework/Utility/Math.hpp>
@@ -478,10 +479,17 @@ bool SampleApp::prv_loadExternalFiles()
 		return false;
 	}
 
+	// Staging memory for all the data uploaded below.
+	D3D12::UploadRing::Ptr uploadRing = D3D12::UploadRing::Create(device);
+	if(!uploadRing)
+	{
+		return false;
+	}
+
 	const char* const modelFilePath = "models/common/head.obj";
 
 	// Load the object that will be displayed in the center of the environment.
-	m_object = D3D12::WavefrontObj::Load(device, cmdList, "Object", modelFilePath);
+	m_object = D3D12::WavefrontObj::Load(device, cmdList, uploadRing, "Object", modelFilePath);
 	if(!m_object)
 	{
 		LOG_ERROR("Failed to load OBJ file: \"%s\"", modelFilePath);
@@ -490,15 +498,23 @@ bool SampleApp::prv_loadExternalFiles()
 
 	const char* const textureFilePath = "textures/common/pine_attic_2k.hdr";
 
+	D3D12::Texture2D::LoadOptions textureOptions;
+	textureOptions.mipCount = 1;
+
+	// Cache the decoded environment map so later runs don't need to decode the HDR file again.
+	// If the cache directory can't be created, the texture is just loaded without it.
+	textureOptions.cache = D3D12::TextureCache::Create("cache/textures");
+
 	// Load the image file that will be used for the environment map.
 	D3D12::Texture2D::Ptr envTexture = D3D12::Texture2D::Load(
 		device,
 		cmdList,
+		uploadRing,
 		descAlloc,
-		D3D12::Texture2D::DataType::Float,
+		D3D12::Texture2D::DataType::HalfFloat,
 		D3D12::Texture2D::Channel::RGBA,
 		textureFilePath,
-		1);
+		textureOptions);
 	if(!envTexture)
 	{
 		LOG_ERROR("Failed to load environment map texture: \"%s\"", textureFilePath);
@@ -513,8 +529,11 @@ bool SampleApp::prv_loadExternalFiles()
 		return false;
 	}
 
+	// Cache the baked probe as well so later runs can upload it instead of running the bake again.
+	const D3D12::ProbeCache::Ptr probeCache = D3D12::ProbeCache::Create("cache/probes");
+
 	// Attempt to generate the environment map resources from the environment texture.
-	if(!m_reflectionProbe->LoadEnvironmentMap(device, cmdList, envTexture))
+	if(!m_reflectionProbe->LoadEnvironmentMap(device, cmdList, envTexture, probeCache, uploadRing))
 	{
 		LOG_ERROR("Failed to load environment map into reflection probe");
 		return false;
@@ -523,10 +542,16 @@ bool SampleApp::prv_loadExternalFiles()
 	// Stop recording commands in the command list and begin executing it.
 	cmdCtx->Submit(cmdQueue);
 
+	// Let the upload ring know which commands read from its memory.
+	uploadRing->Signal(cmdQueue);
+
 	// Wait for the command list to finish executing.
 	cmdSync->Signal(cmdQueue);
 	cmdSync->Wait();
 
+	// Now that the bake has finished on the GPU, its results can be stored in the probe cache.
+	m_reflectionProbe->CompleteLoad(device, cmdQueue);
+
 	return true;
 }
 
@@ -0,0 +1,354 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ChunkedUploader.hpp"
+
+#include "LowLevel/Event.hpp"
+#include "LowLevel/Fence.hpp"
+#include "LowLevel/Resource.hpp"
+
+#include "../Application/Log.hpp"
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ChunkedUploader::ChunkedUploader()
+	: m_cmdQueue()
+	, m_window()
+	, m_fence()
+	, m_event()
+	, m_contexts()
+	, m_splitter()
+	, m_pData(nullptr)
+	, m_segmentFenceValues()
+	, m_segmentSize(0)
+	, m_lastSignaledValue(0)
+	, m_segment(0)
+	, m_recording(false)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ChunkedUploader::~ChunkedUploader()
+{
+	// The GPU may still be reading from the window, so make sure it's done before letting it go.
+	WaitForIdle();
+
+	if(m_pData)
+	{
+		m_window->Unmap(0, nullptr);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ChunkedUploader::Ptr DemoFramework::D3D12::ChunkedUploader::Create(
+	const Device::Ptr& device,
+	const CommandQueue::Ptr& cmdQueue,
+	const uint64_t windowSize)
+{
+	if(!device || !cmdQueue)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	// Each segment has to start on a placement boundary so bands can be copied from the start of it.
+	const uint64_t segmentSize = (windowSize / DF_CHUNKED_UPLOADER_SEGMENT_COUNT) & ~uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+	if(segmentSize == 0)
+	{
+		LOG_ERROR("Chunked uploader window is too small: windowSize=%" PRIu64, windowSize);
+		return Ptr();
+	}
+
+	constexpr D3D12_HEAP_PROPERTIES uploadHeapProps =
+	{
+		D3D12_HEAP_TYPE_UPLOAD,          // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	const D3D12_RESOURCE_DESC windowDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER,                 // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                               // UINT64 Alignment
+		segmentSize * DF_CHUNKED_UPLOADER_SEGMENT_COUNT, // UINT64 Width
+		1,                                               // UINT Height
+		1,                                               // UINT16 DepthOrArraySize
+		1,                                               // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,                             // DXGI_FORMAT Format
+		defaultSampleDesc,                               // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,                  // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,                        // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	constexpr D3D12_RANGE disableCpuReadRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	const D3D12_COMMAND_LIST_TYPE cmdListType = cmdQueue->GetDesc().Type;
+
+	Ptr output = std::make_shared<ChunkedUploader>();
+
+	output->m_window = CreateCommittedResource(
+		device,
+		windowDesc,
+		uploadHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_GENERIC_READ);
+	if(!output->m_window)
+	{
+		LOG_ERROR("Failed to create chunked uploader window: windowSize=%" PRIu64, windowSize);
+		return Ptr();
+	}
+
+	for(size_t index = 0; index < DF_CHUNKED_UPLOADER_SEGMENT_COUNT; ++index)
+	{
+		output->m_contexts[index] = GraphicsCommandContext::Create(device, cmdListType);
+		if(!output->m_contexts[index])
+		{
+			return Ptr();
+		}
+	}
+
+	output->m_fence = CreateFence(device, D3D12_FENCE_FLAG_NONE, 0);
+	if(!output->m_fence)
+	{
+		return Ptr();
+	}
+
+	output->m_event = CreateEvent(nullptr, false, false, nullptr);
+	if(!output->m_event)
+	{
+		return Ptr();
+	}
+
+	// Upload heap memory can stay mapped for the lifetime of the resource.
+	const HRESULT mapResult = output->m_window->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(&output->m_pData));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map chunked uploader window: result=0x%08" PRIX32, mapResult);
+		return Ptr();
+	}
+
+	output->m_cmdQueue = cmdQueue;
+	output->m_segmentSize = segmentSize;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ChunkedUploader::Upload(
+	const Resource::Ptr& texture,
+	const Utility::TextureFootprint::FormatInfo& formatInfo,
+	const uint32_t firstMip,
+	const Source* const pSources)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!texture || !pSources)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const D3D12_RESOURCE_DESC textureDesc = texture->GetDesc();
+
+	const uint32_t width = uint32_t(textureDesc.Width);
+	const uint32_t height = textureDesc.Height;
+	const uint32_t mipCount = textureDesc.MipLevels;
+
+	if(textureDesc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || textureDesc.DepthOrArraySize != 1 || firstMip >= mipCount)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	TextureFootprint::Subresource layouts[D3D12_REQ_MIP_LEVELS];
+
+	if(TextureFootprint::Compute(formatInfo, width, height, mipCount, layouts) == 0)
+	{
+		LOG_ERROR("Unsupported chunked upload format: format=%" PRIu32, uint32_t(textureDesc.Format));
+		return false;
+	}
+
+	if(!m_splitter.Reset(layouts + firstMip, mipCount - firstMip, m_segmentSize))
+	{
+		LOG_ERROR(
+			"Texture rows do not fit in the chunked uploader window: width=%" PRIu32 ", segmentSize=%" PRIu64,
+			width,
+			m_segmentSize);
+		return false;
+	}
+
+	D3D12_TEXTURE_COPY_LOCATION srcLoc;
+	srcLoc.pResource = m_window.Get();
+	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+	D3D12_TEXTURE_COPY_LOCATION destLoc;
+	destLoc.pResource = texture.Get();
+	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+	UploadBandSplitter::Band band;
+
+	uint32_t submission = 0;
+
+	while(m_splitter.Next(band))
+	{
+		if(!m_recording || band.submission != submission)
+		{
+			// The current segment is full, so send off its copies and move on to the next segment.
+			if(m_recording)
+			{
+				_endSubmission();
+			}
+
+			_beginSubmission();
+
+			submission = band.submission;
+		}
+
+		const uint32_t mipIndex = firstMip + band.subresource;
+
+		const TextureFootprint::Subresource& layout = layouts[mipIndex];
+		const Source& source = pSources[band.subresource];
+
+		const uint64_t segmentOffset = m_segmentSize * m_segment;
+
+		uint8_t* const pBandData = m_pData + segmentOffset + band.windowOffset;
+		const uint8_t* const pSourceData = source.pData + (source.rowPitch * band.firstRow);
+
+		// Copy the rows of the band into the window, padding each one out to the pitch required by the GPU.
+		for(uint32_t row = 0; row < band.rowCount; ++row)
+		{
+			memcpy(pBandData + (uint64_t(layout.rowPitch) * row), pSourceData + (source.rowPitch * row), size_t(layout.rowSize));
+		}
+
+		const uint32_t mipWidth = TextureFootprint::GetMipDimension(width, mipIndex);
+		const uint32_t mipHeight = TextureFootprint::GetMipDimension(height, mipIndex);
+
+		const uint32_t destY = band.firstRow * formatInfo.blockHeight;
+		const uint32_t bandHeight = band.rowCount * formatInfo.blockHeight;
+
+		srcLoc.PlacedFootprint.Offset = segmentOffset + band.windowOffset;
+		srcLoc.PlacedFootprint.Footprint.Format = textureDesc.Format;
+		srcLoc.PlacedFootprint.Footprint.Width = layout.width;
+		srcLoc.PlacedFootprint.Footprint.Height = bandHeight;
+		srcLoc.PlacedFootprint.Footprint.Depth = 1;
+		srcLoc.PlacedFootprint.Footprint.RowPitch = layout.rowPitch;
+		destLoc.SubresourceIndex = mipIndex;
+
+		// Block-compressed mips that aren't a whole number of blocks in size only copy the texels that actually exist.
+		const D3D12_BOX srcBox =
+		{
+			0,                                       // UINT left
+			0,                                       // UINT top
+			0,                                       // UINT front
+			mipWidth,                                // UINT right
+			std::min(bandHeight, mipHeight - destY), // UINT bottom
+			1,                                       // UINT back
+		};
+
+		m_contexts[m_segment]->GetCmdList()->CopyTextureRegion(&destLoc, 0, destY, 0, &srcLoc, &srcBox);
+	}
+
+	if(m_recording)
+	{
+		_endSubmission();
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ChunkedUploader::WaitForIdle()
+{
+	if(!m_fence)
+	{
+		return;
+	}
+
+	_waitForFence(m_lastSignaledValue);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ChunkedUploader::_beginSubmission()
+{
+	m_segment = (m_segment + 1) % DF_CHUNKED_UPLOADER_SEGMENT_COUNT;
+
+	// The segment and its command allocator can't be touched until the GPU is done with the last submission using them.
+	_waitForFence(m_segmentFenceValues[m_segment]);
+
+	m_contexts[m_segment]->Reset();
+	m_recording = true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ChunkedUploader::_endSubmission()
+{
+	m_contexts[m_segment]->Submit(m_cmdQueue);
+	m_recording = false;
+
+	const uint64_t fenceValue = m_lastSignaledValue + 1;
+
+	const HRESULT result = m_cmdQueue->Signal(m_fence.Get(), fenceValue);
+	if(FAILED(result))
+	{
+		LOG_ERROR("Failed to enqueue chunked uploader fence signal: result=0x%08" PRIX32, result);
+		return;
+	}
+
+	m_segmentFenceValues[m_segment] = fenceValue;
+	m_lastSignaledValue = fenceValue;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ChunkedUploader::_waitForFence(const uint64_t fenceValue)
+{
+	if(m_fence->GetCompletedValue() >= fenceValue)
+	{
+		return;
+	}
+
+	const HRESULT result = m_fence->SetEventOnCompletion(fenceValue, m_event->GetHandle());
+	if(FAILED(result))
+	{
+		LOG_ERROR("Failed to set completion event on chunked uploader fence: result=0x%08" PRIX32, result);
+		return;
+	}
+
+	::WaitForSingleObject(m_event->GetHandle(), INFINITE);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
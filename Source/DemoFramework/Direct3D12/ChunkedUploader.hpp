@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "CommandContext.hpp"
+
+#include "../Utility/UploadBandSplitter.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_CHUNKED_UPLOADER_DEFAULT_WINDOW_SIZE (32 * 1024 * 1024)
+#define DF_CHUNKED_UPLOADER_SEGMENT_COUNT 2
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class ChunkedUploader;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Uploads textures of any size through a fixed-size staging window. Each subresource is split into bands of rows that
+// fit in the window, and the copies for as many bands as fit are recorded and submitted together on the uploader's own
+// command list. The window is divided into segments that are used in turn by successive submissions, so the CPU can
+// fill one segment while the GPU is still copying from another, and each segment is only reused once the fence
+// signaled after its last submission has been reached. Peak upload memory is the window size no matter how large the
+// texture is.
+//
+// Every copy is submitted on the uploader's command queue before Upload() returns, so command lists submitted to the
+// same queue afterward see the uploaded data. Not thread-safe.
+class DF_API DemoFramework::D3D12::ChunkedUploader
+{
+public:
+
+	typedef std::shared_ptr<ChunkedUploader> Ptr;
+
+	// Texel data for one subresource, with rows (or rows of blocks for compressed formats) 'rowPitch' bytes apart.
+	struct Source
+	{
+		const uint8_t* pData;
+		uint64_t rowPitch;
+	};
+
+	ChunkedUploader();
+	ChunkedUploader(const ChunkedUploader&) = delete;
+	ChunkedUploader(ChunkedUploader&&) = delete;
+	~ChunkedUploader();
+
+	ChunkedUploader& operator =(const ChunkedUploader&) = delete;
+	ChunkedUploader& operator =(ChunkedUploader&&) = delete;
+
+	static Ptr Create(
+		const Device::Ptr& device,
+		const CommandQueue::Ptr& cmdQueue,
+		uint64_t windowSize = DF_CHUNKED_UPLOADER_DEFAULT_WINDOW_SIZE
+	);
+
+	// Upload mips [firstMip, mipCount) of a 2D texture in the COPY_DEST state, reading the data for each mip from the
+	// matching entry of 'pSources'. The texture is left in the COPY_DEST state.
+	bool Upload(
+		const Resource::Ptr& texture,
+		const Utility::TextureFootprint::FormatInfo& formatInfo,
+		uint32_t firstMip,
+		const Source* pSources);
+
+	// Block until the GPU has finished every copy submitted so far.
+	void WaitForIdle();
+
+	uint64_t GetWindowSize() const;
+	uint64_t GetSegmentSize() const;
+
+
+private:
+
+	void _beginSubmission();
+	void _endSubmission();
+	void _waitForFence(uint64_t);
+
+	CommandQueue::Ptr m_cmdQueue;
+
+	Resource::Ptr m_window;
+	Fence::Ptr m_fence;
+	Event::Ptr m_event;
+
+	GraphicsCommandContext::Ptr m_contexts[DF_CHUNKED_UPLOADER_SEGMENT_COUNT];
+
+	Utility::UploadBandSplitter m_splitter;
+
+	uint8_t* m_pData;
+
+	uint64_t m_segmentFenceValues[DF_CHUNKED_UPLOADER_SEGMENT_COUNT];
+	uint64_t m_segmentSize;
+	uint64_t m_lastSignaledValue;
+
+	uint32_t m_segment;
+
+	bool m_recording;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::ChunkedUploader>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::ChunkedUploader::GetWindowSize() const
+{
+	return m_segmentSize * DF_CHUNKED_UPLOADER_SEGMENT_COUNT;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::ChunkedUploader::GetSegmentSize() const
+{
+	return m_segmentSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -68,6 +68,7 @@ namespace DemoFramework { namespace D3D12 {
 	DF_DECL_WRL_COM_TYPE(ID3D12Fence, Fence);
 	DF_DECL_WRL_COM_TYPE(ID3D12GraphicsCommandList, GraphicsCommandList);
 	DF_DECL_WRL_COM_TYPE(ID3D12PipelineState, PipelineState);
+	DF_DECL_WRL_COM_TYPE(ID3D12QueryHeap, QueryHeap);
 	DF_DECL_WRL_COM_TYPE(ID3D12Resource, Resource);
 	DF_DECL_WRL_COM_TYPE(ID3D12RootSignature, RootSignature);
 
@@ -0,0 +1,796 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ProgressiveMesh.hpp"
+
+#include "../LowLevel/Resource.hpp"
+
+#include "../../Application/Log.hpp"
+#include "../../Utility/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <math.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Grid resolution used to generate LOD 1. Each coarser level halves the resolution,
+// which roughly quarters the triangle count for typical closed surfaces.
+#define DF_PROGRESSIVE_MESH_BASE_GRID_RESOLUTION 256
+
+// Smallest grid resolution worth generating a level for.
+#define DF_PROGRESSIVE_MESH_MIN_GRID_RESOLUTION 8
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct DemoFramework::D3D12::ProgressiveMesh::Lod
+{
+	// CPU copy of the level's geometry; released as soon as the level has been fully written to the GPU buffers.
+	StaticMesh::Geometry geometry;
+
+	Resource::Ptr vertexResource;
+	Resource::Ptr indexResource;
+
+	uint64_t vertexByteSize;
+	uint64_t indexByteSize;
+
+	uint32_t vertexCount;
+	uint32_t indexCount;
+
+	Utility::StreamScheduler::RequestId requestId;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// State shared between a mesh and the background job generating its finer levels. The job decimates the source into
+// each level from the coarsest still missing to LOD 1, then publishes it by lowering 'readyLod'. A published level (and
+// the source, once LOD 0 is published) is never touched by the job again, so the mesh is free to move it out.
+struct DemoFramework::D3D12::ProgressiveMesh::BuildJob
+{
+	StaticMesh::Geometry source;
+	StaticMesh::Geometry levels[DF_PROGRESSIVE_MESH_MAX_LOD_COUNT];
+
+	uint32_t lodCount;
+
+	std::atomic<uint32_t> readyLod;
+	std::atomic<bool> cancel;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct ProgressiveMeshCluster
+{
+	float32_t pos[3];
+	float32_t tex[2];
+	float32_t norm[3];
+	float32_t tan[3];
+	float32_t bin[3];
+
+	uint32_t count;
+	uint32_t firstVertex;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void NormalizeClusterVector(float32_t* const pVector, const float32_t* const pFallback)
+{
+	const float32_t length = sqrtf((pVector[0] * pVector[0]) + (pVector[1] * pVector[1]) + (pVector[2] * pVector[2]));
+
+	if(length > FLT_EPSILON)
+	{
+		pVector[0] /= length;
+		pVector[1] /= length;
+		pVector[2] /= length;
+	}
+	else
+	{
+		// The averaged vectors cancelled each other out, so use the one from the first vertex in the cluster instead.
+		pVector[0] = pFallback[0];
+		pVector[1] = pFallback[1];
+		pVector[2] = pFallback[2];
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetLodGridResolution(const uint32_t lodIndex)
+{
+	// Each coarser level halves the resolution, which roughly quarters the triangle count for typical closed surfaces.
+	return (lodIndex > 0) ? (DF_PROGRESSIVE_MESH_BASE_GRID_RESOLUTION >> (lodIndex - 1)) : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ProgressiveMesh::~ProgressiveMesh()
+{
+	if(m_buildJob)
+	{
+		// The job holds its own reference to the shared state, so it only needs to be told to stop.
+		m_buildJob->cancel.store(true, std::memory_order_release);
+	}
+
+	if(m_pLods)
+	{
+		if(m_uploadRing)
+		{
+			// Copies into levels that were still being streamed in may not have executed yet.
+			for(uint32_t i = 0; i < m_residentLod; ++i)
+			{
+				m_uploadRing->DeferRelease(m_pLods[i].vertexResource);
+				m_uploadRing->DeferRelease(m_pLods[i].indexResource);
+			}
+		}
+
+		delete[] m_pLods;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ProgressiveMesh::Ptr DemoFramework::D3D12::ProgressiveMesh::Create(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const char* const name,
+	StaticMesh::Geometry&& geometry,
+	const uint32_t lodCount)
+{
+	if(!device
+		|| !cmdList
+		|| !uploadRing
+		|| !name
+		|| name[0] == '\0'
+		|| geometry.vertexBuffer.GetCount() == 0
+		|| geometry.indexBuffer.GetCount() == 0
+		|| lodCount == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	ProgressiveMesh::Ptr output = std::make_shared<ProgressiveMesh>();
+
+	snprintf(output->m_name, DF_MESH_NAME_MAX_SIZE, "%s", name);
+
+	uint32_t levelCount = std::min(lodCount, uint32_t(DF_PROGRESSIVE_MESH_MAX_LOD_COUNT));
+
+	while(levelCount > 1 && GetLodGridResolution(levelCount - 1) < DF_PROGRESSIVE_MESH_MIN_GRID_RESOLUTION)
+	{
+		--levelCount;
+	}
+
+	const size_t sourceIndexCount = geometry.indexBuffer.GetCount();
+
+	StaticMesh::Geometry coarsestLevel;
+
+	// Only the coarsest level is generated here, directly from the source, so the mesh is drawable after a single
+	// decimation pass over a small grid. The finer levels are left to the background job.
+	while(levelCount > 1)
+	{
+		coarsestLevel = Decimate(geometry, GetLodGridResolution(levelCount - 1));
+
+		if(coarsestLevel.indexBuffer.GetCount() >= sourceIndexCount)
+		{
+			// Even the coarsest grid is finer than the mesh itself, so no level would be any simpler than the source.
+			levelCount = 1;
+			break;
+		}
+
+		if(coarsestLevel.indexBuffer.GetCount() > 0)
+		{
+			break;
+		}
+
+		// The mesh collapsed entirely, so try again on a finer grid.
+		--levelCount;
+	}
+
+	output->m_lodCount = levelCount;
+	output->m_pLods = new Lod[output->m_lodCount]();
+
+	for(uint32_t i = 0; i < output->m_lodCount; ++i)
+	{
+		output->m_pLods[i].requestId = Utility::StreamScheduler::InvalidRequestId;
+	}
+
+	const uint32_t coarsestLod = output->m_lodCount - 1;
+
+	Lod& lod = output->m_pLods[coarsestLod];
+
+	lod.geometry = (coarsestLod > 0) ? std::move(coarsestLevel) : std::move(geometry);
+	lod.vertexCount = uint32_t(lod.geometry.vertexBuffer.GetCount());
+	lod.indexCount = uint32_t(lod.geometry.indexBuffer.GetCount());
+	lod.vertexByteSize = sizeof(StaticMesh::Geometry::Vertex) * uint64_t(lod.vertexCount);
+	lod.indexByteSize = sizeof(StaticMesh::Geometry::Index) * uint64_t(lod.indexCount);
+
+	if(!output->_createLodResources(device, lod))
+	{
+		LOG_ERROR("Failed to create progressive mesh resources: name=\"%s\", lod=%" PRIu32, name, coarsestLod);
+		return Ptr();
+	}
+
+	output->m_device = device;
+	output->m_uploadRing = uploadRing;
+
+	// Upload the coarsest level immediately so the mesh is drawable right away.
+	if(!output->_uploadLodData(cmdList, lod, 0, lod.vertexByteSize + lod.indexByteSize))
+	{
+		LOG_ERROR("Failed to upload progressive mesh data: name=\"%s\", lod=%" PRIu32, name, coarsestLod);
+		return Ptr();
+	}
+
+	output->m_residentLod = coarsestLod;
+	output->m_queuedLod = coarsestLod;
+	output->_finalizeLod(cmdList, coarsestLod);
+
+	if(coarsestLod == 0)
+	{
+		// The only level is already uploaded.
+		output->m_device = Device::Ptr();
+		output->m_uploadRing.reset();
+	}
+	else
+	{
+		const std::shared_ptr<BuildJob> job = std::make_shared<BuildJob>();
+
+		job->source = std::move(geometry);
+		job->lodCount = output->m_lodCount;
+		job->readyLod.store(coarsestLod, std::memory_order_relaxed);
+		job->cancel.store(false, std::memory_order_relaxed);
+
+		output->m_buildJob = job;
+
+		// Levels are picked up by Stream() as the job publishes them.
+		Utility::ThreadPool::GetShared()->Submit([job]() { _runBuildJob(*job); });
+	}
+
+	LOG_WRITE(
+		"Created progressive mesh: name=\"%s\", lodCount=%" PRIu32 ", triangles=%" PRIu32 ", coarsestTriangles=%" PRIu32,
+		name,
+		output->m_lodCount,
+		uint32_t(sourceIndexCount / 3),
+		output->m_pLods[coarsestLod].indexCount / 3);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::StaticMesh::Geometry DemoFramework::D3D12::ProgressiveMesh::Decimate(
+	const StaticMesh::Geometry& geometry,
+	const uint32_t gridResolution)
+{
+	typedef StaticMesh::Geometry::Vertex Vertex;
+	typedef StaticMesh::Geometry::Index Index;
+
+	StaticMesh::Geometry output;
+
+	const size_t vertexCount = geometry.vertexBuffer.GetCount();
+	const size_t indexCount = geometry.indexBuffer.GetCount();
+
+	if(vertexCount == 0 || indexCount < 3 || gridResolution == 0)
+	{
+		return output;
+	}
+
+	const Vertex* const pVertices = geometry.vertexBuffer.GetData();
+	const Index* const pIndices = geometry.indexBuffer.GetData();
+
+	float32_t boundsMin[3] = { pVertices[0].pos.x, pVertices[0].pos.y, pVertices[0].pos.z };
+	float32_t boundsMax[3] = { pVertices[0].pos.x, pVertices[0].pos.y, pVertices[0].pos.z };
+
+	// Find the bounds of the geometry.
+	for(size_t i = 1; i < vertexCount; ++i)
+	{
+		const Vertex::Position& pos = pVertices[i].pos;
+
+		boundsMin[0] = std::min(boundsMin[0], pos.x);
+		boundsMin[1] = std::min(boundsMin[1], pos.y);
+		boundsMin[2] = std::min(boundsMin[2], pos.z);
+
+		boundsMax[0] = std::max(boundsMax[0], pos.x);
+		boundsMax[1] = std::max(boundsMax[1], pos.y);
+		boundsMax[2] = std::max(boundsMax[2], pos.z);
+	}
+
+	const float32_t maxExtent = std::max(
+		boundsMax[0] - boundsMin[0],
+		std::max(boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2]));
+
+	// Use cubic cells sized from the longest axis so the decimation is uniform in every direction.
+	const uint32_t maxCell = std::min(gridResolution, 1u << 20) - 1;
+	const float32_t cellScale = (maxExtent > 0.0f) ? float32_t(maxCell + 1) / maxExtent : 0.0f;
+
+	auto getCell = [cellScale, maxCell](const float32_t value, const float32_t minValue) -> uint64_t
+	{
+		return uint64_t(std::min(uint32_t((value - minValue) * cellScale), maxCell));
+	};
+
+	std::unordered_map<uint64_t, uint32_t> clusterLookup;
+	clusterLookup.reserve(std::min(vertexCount, size_t(gridResolution) * gridResolution * 8));
+
+	std::vector<ProgressiveMeshCluster> clusters;
+	std::vector<uint32_t> remap(vertexCount);
+
+	// Assign each vertex to a cluster. The octant of the vertex normal is part of the cluster key
+	// so the opposite sides of thin surfaces don't get merged into a single vertex.
+	for(size_t i = 0; i < vertexCount; ++i)
+	{
+		const Vertex& vertex = pVertices[i];
+
+		const uint64_t normalOctant = ((vertex.norm.x < 0.0f) ? 1ull : 0ull)
+			| ((vertex.norm.y < 0.0f) ? 2ull : 0ull)
+			| ((vertex.norm.z < 0.0f) ? 4ull : 0ull);
+
+		const uint64_t key = getCell(vertex.pos.x, boundsMin[0])
+			| (getCell(vertex.pos.y, boundsMin[1]) << 20)
+			| (getCell(vertex.pos.z, boundsMin[2]) << 40)
+			| (normalOctant << 60);
+
+		auto clusterKv = clusterLookup.find(key);
+		if(clusterKv == clusterLookup.end())
+		{
+			clusterKv = clusterLookup.emplace(key, uint32_t(clusters.size())).first;
+			clusters.push_back(ProgressiveMeshCluster());
+			clusters.back().firstVertex = uint32_t(i);
+		}
+
+		ProgressiveMeshCluster& cluster = clusters[clusterKv->second];
+
+		cluster.pos[0] += vertex.pos.x;
+		cluster.pos[1] += vertex.pos.y;
+		cluster.pos[2] += vertex.pos.z;
+
+		cluster.tex[0] += vertex.tex.u;
+		cluster.tex[1] += vertex.tex.v;
+
+		cluster.norm[0] += vertex.norm.x;
+		cluster.norm[1] += vertex.norm.y;
+		cluster.norm[2] += vertex.norm.z;
+
+		cluster.tan[0] += vertex.tan.x;
+		cluster.tan[1] += vertex.tan.y;
+		cluster.tan[2] += vertex.tan.z;
+
+		cluster.bin[0] += vertex.bin.x;
+		cluster.bin[1] += vertex.bin.y;
+		cluster.bin[2] += vertex.bin.z;
+
+		++cluster.count;
+
+		remap[i] = clusterKv->second;
+	}
+
+	std::vector<Index> indices;
+	indices.reserve(indexCount);
+
+	// Remap the triangles to the clustered vertices, dropping any triangle that collapsed into a line or a point.
+	for(size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const Index i0 = remap[pIndices[i + 0]];
+		const Index i1 = remap[pIndices[i + 1]];
+		const Index i2 = remap[pIndices[i + 2]];
+
+		if(i0 == i1 || i1 == i2 || i0 == i2)
+		{
+			continue;
+		}
+
+		indices.push_back(i0);
+		indices.push_back(i1);
+		indices.push_back(i2);
+	}
+
+	if(indices.empty())
+	{
+		return output;
+	}
+
+	output.vertexBuffer = StaticMesh::Geometry::VertexArray::Create(clusters.size());
+	output.indexBuffer = StaticMesh::Geometry::IndexArray::Create(indices.size());
+
+	Vertex* const pOutVertices = output.vertexBuffer.GetData();
+	Index* const pOutIndices = output.indexBuffer.GetData();
+
+	// Resolve each cluster into its representative vertex.
+	for(size_t i = 0; i < clusters.size(); ++i)
+	{
+		ProgressiveMeshCluster& cluster = clusters[i];
+		const Vertex& fallback = pVertices[cluster.firstVertex];
+
+		const float32_t invCount = 1.0f / float32_t(cluster.count);
+
+		NormalizeClusterVector(cluster.norm, &fallback.norm.x);
+		NormalizeClusterVector(cluster.tan, &fallback.tan.x);
+		NormalizeClusterVector(cluster.bin, &fallback.bin.x);
+
+		Vertex& vertex = pOutVertices[i];
+
+		vertex.pos.x = cluster.pos[0] * invCount;
+		vertex.pos.y = cluster.pos[1] * invCount;
+		vertex.pos.z = cluster.pos[2] * invCount;
+
+		vertex.tex.u = cluster.tex[0] * invCount;
+		vertex.tex.v = cluster.tex[1] * invCount;
+
+		vertex.norm.x = cluster.norm[0];
+		vertex.norm.y = cluster.norm[1];
+		vertex.norm.z = cluster.norm[2];
+
+		vertex.tan.x = cluster.tan[0];
+		vertex.tan.y = cluster.tan[1];
+		vertex.tan.z = cluster.tan[2];
+
+		vertex.bin.x = cluster.bin[0];
+		vertex.bin.y = cluster.bin[1];
+		vertex.bin.z = cluster.bin[2];
+	}
+
+	memcpy(pOutIndices, indices.data(), sizeof(Index) * indices.size());
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::ProgressiveMesh::Stream(const GraphicsCommandList::Ptr& cmdList, const uint64_t byteBudget)
+{
+	if(!cmdList || !m_uploadRing)
+	{
+		return 0;
+	}
+
+	if(m_buildJob)
+	{
+		// Queue any levels the background job has finished since the last call.
+		const uint32_t readyLod = m_buildJob->readyLod.load(std::memory_order_acquire);
+
+		while(m_queuedLod > readyLod)
+		{
+			--m_queuedLod;
+			_queueLod(m_queuedLod);
+		}
+
+		if(m_queuedLod == 0)
+		{
+			// Every level has been handed over, so the job has returned.
+			m_buildJob.reset();
+		}
+	}
+
+	Utility::StreamScheduler::Chunk chunks[DF_PROGRESSIVE_MESH_MAX_LOD_COUNT];
+
+	const size_t chunkCount = m_scheduler.Schedule(byteBudget, chunks, _countof(chunks));
+
+	uint64_t bytesWritten = 0;
+	bool streamFailed = false;
+
+	for(size_t chunkIndex = 0; chunkIndex < chunkCount && !streamFailed; ++chunkIndex)
+	{
+		const Utility::StreamScheduler::Chunk& chunk = chunks[chunkIndex];
+
+		for(uint32_t lodIndex = 0; lodIndex < m_lodCount; ++lodIndex)
+		{
+			Lod& lod = m_pLods[lodIndex];
+
+			if(lod.requestId == chunk.requestId)
+			{
+				if(!_uploadLodData(cmdList, lod, chunk.offset, chunk.size))
+				{
+					// Without staging memory, the level can't be completed, so stop refining the mesh at the levels
+					// that are already resident.
+					LOG_ERROR("Failed to stream progressive mesh data: name=\"%s\", lod=%" PRIu32, m_name, lodIndex);
+
+					for(uint32_t i = 0; i < m_residentLod; ++i)
+					{
+						Lod& unfinishedLod = m_pLods[i];
+
+						// Copies into the unfinished levels may not have executed yet.
+						m_uploadRing->DeferRelease(unfinishedLod.vertexResource);
+						m_uploadRing->DeferRelease(unfinishedLod.indexResource);
+
+						unfinishedLod.vertexResource = Resource::Ptr();
+						unfinishedLod.indexResource = Resource::Ptr();
+						unfinishedLod.geometry = StaticMesh::Geometry();
+						unfinishedLod.requestId = Utility::StreamScheduler::InvalidRequestId;
+					}
+
+					m_scheduler.Clear();
+
+					if(m_buildJob)
+					{
+						// There's no point in generating levels that can't be streamed in.
+						m_buildJob->cancel.store(true, std::memory_order_release);
+						m_buildJob.reset();
+					}
+
+					streamFailed = true;
+					break;
+				}
+
+				if(chunk.lastChunk)
+				{
+					_finalizeLod(cmdList, lodIndex);
+				}
+
+				bytesWritten += chunk.size;
+				break;
+			}
+		}
+	}
+
+	if(m_scheduler.GetPendingCount() == 0 && !m_buildJob)
+	{
+		// Nothing is left to stage, so there is no reason to hold onto the upload ring any longer.
+		m_device = Device::Ptr();
+		m_uploadRing.reset();
+	}
+
+	return bytesWritten;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ProgressiveMesh::Draw(
+	const GraphicsCommandList::Ptr& cmdList,
+	const uint32_t instanceCount,
+	const uint32_t baseInstanceId) const
+{
+	const DXGI_FORMAT indexFormat = (sizeof(StaticMesh::Geometry::Index) == 2)
+		? DXGI_FORMAT_R16_UINT
+		: DXGI_FORMAT_R32_UINT;
+
+	const Lod& lod = m_pLods[m_residentLod];
+
+	const D3D12_VERTEX_BUFFER_VIEW vertexBufferView =
+	{
+		lod.vertexResource->GetGPUVirtualAddress(), // D3D12_GPU_VIRTUAL_ADDRESS BufferLocation
+		UINT(lod.vertexByteSize),                   // UINT SizeInBytes
+		sizeof(StaticMesh::Geometry::Vertex),       // UINT StrideInBytes
+	};
+
+	const D3D12_INDEX_BUFFER_VIEW indexBufferView =
+	{
+		lod.indexResource->GetGPUVirtualAddress(), // D3D12_GPU_VIRTUAL_ADDRESS BufferLocation
+		UINT(lod.indexByteSize),                   // UINT SizeInBytes
+		indexFormat,                               // DXGI_FORMAT Format
+	};
+
+	cmdList->IASetVertexBuffers(0, 1, &vertexBufferView);
+	cmdList->IASetIndexBuffer(&indexBufferView);
+	cmdList->DrawIndexedInstanced(lod.indexCount, instanceCount, 0, 0, baseInstanceId);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const char* DemoFramework::D3D12::ProgressiveMesh::GetName() const
+{
+	return m_name;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ProgressiveMesh::_runBuildJob(BuildJob& job)
+{
+	// Every level is decimated from the source rather than from the level above it, so the levels can be finished
+	// from coarsest to finest, in the same order they're streamed in.
+	for(uint32_t lodIndex = job.lodCount - 2; lodIndex > 0; --lodIndex)
+	{
+		if(job.cancel.load(std::memory_order_acquire))
+		{
+			return;
+		}
+
+		job.levels[lodIndex] = Decimate(job.source, GetLodGridResolution(lodIndex));
+		job.readyLod.store(lodIndex, std::memory_order_release);
+	}
+
+	// The source is LOD 0 and needs no work, but it can't be handed over until the job is done reading it.
+	job.readyLod.store(0, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ProgressiveMesh::_queueLod(const uint32_t lodIndex)
+{
+	Lod& lod = m_pLods[lodIndex];
+
+	lod.geometry = std::move((lodIndex > 0) ? m_buildJob->levels[lodIndex] : m_buildJob->source);
+	lod.vertexCount = uint32_t(lod.geometry.vertexBuffer.GetCount());
+	lod.indexCount = uint32_t(lod.geometry.indexBuffer.GetCount());
+	lod.vertexByteSize = sizeof(StaticMesh::Geometry::Vertex) * uint64_t(lod.vertexCount);
+	lod.indexByteSize = sizeof(StaticMesh::Geometry::Index) * uint64_t(lod.indexCount);
+
+	uint32_t coarserIndexCount = 0;
+
+	for(uint32_t i = lodIndex + 1; i < m_lodCount && coarserIndexCount == 0; ++i)
+	{
+		coarserIndexCount = m_pLods[i].indexCount;
+	}
+
+	// A level that collapsed, or that isn't any more detailed than the level it would replace, is skipped, leaving the
+	// mesh to go straight to the next finer level.
+	const bool skipLevel = (lodIndex > 0) && (lod.indexCount == 0 || lod.indexCount <= coarserIndexCount);
+
+	if(!skipLevel)
+	{
+		if(_createLodResources(m_device, lod))
+		{
+			lod.requestId = m_scheduler.Enqueue(lod.vertexByteSize + lod.indexByteSize, 0);
+			return;
+		}
+
+		LOG_ERROR("Failed to create progressive mesh resources: name=\"%s\", lod=%" PRIu32, m_name, lodIndex);
+	}
+
+	lod.geometry = StaticMesh::Geometry();
+	lod.vertexResource = Resource::Ptr();
+	lod.indexResource = Resource::Ptr();
+	lod.vertexCount = 0;
+	lod.indexCount = 0;
+	lod.vertexByteSize = 0;
+	lod.indexByteSize = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ProgressiveMesh::_createLodResources(const Device::Ptr& device, Lod& lod)
+{
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	constexpr D3D12_HEAP_PROPERTIES heapProps =
+	{
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	D3D12_RESOURCE_DESC bufferDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                               // UINT64 Alignment
+		lod.vertexByteSize,              // UINT64 Width
+		1,                               // UINT Height
+		1,                               // UINT16 DepthOrArraySize
+		1,                               // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,             // DXGI_FORMAT Format
+		defaultSampleDesc,               // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	lod.vertexResource = CreateCommittedResource(
+		device,
+		bufferDesc,
+		heapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!lod.vertexResource)
+	{
+		return false;
+	}
+
+	bufferDesc.Width = lod.indexByteSize;
+
+	lod.indexResource = CreateCommittedResource(
+		device,
+		bufferDesc,
+		heapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!lod.indexResource)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ProgressiveMesh::_uploadLodData(
+	const GraphicsCommandList::Ptr& cmdList,
+	Lod& lod,
+	uint64_t offset,
+	uint64_t size)
+{
+	UploadRing::Allocation staging;
+
+	// Only a flush can free up space used by uploads that haven't been submitted yet, which can't be done from here,
+	// so fall back to a dedicated upload buffer when the ring is full.
+	if(!m_uploadRing->Allocate(size, 16, staging) && !m_uploadRing->AllocateDedicated(m_device, size, staging))
+	{
+		return false;
+	}
+
+	uint64_t stagingOffset = 0;
+
+	// Each level is streamed as a single request covering the vertex data followed by the index data.
+	if(offset < lod.vertexByteSize)
+	{
+		const uint64_t vertexChunkSize = std::min(size, lod.vertexByteSize - offset);
+
+		memcpy(
+			staging.pData,
+			reinterpret_cast<const uint8_t*>(lod.geometry.vertexBuffer.GetData()) + offset,
+			size_t(vertexChunkSize));
+
+		cmdList->CopyBufferRegion(lod.vertexResource.Get(), offset, staging.pResource, staging.offset, vertexChunkSize);
+
+		stagingOffset = vertexChunkSize;
+		offset += vertexChunkSize;
+		size -= vertexChunkSize;
+	}
+
+	if(size > 0)
+	{
+		const uint64_t indexOffset = offset - lod.vertexByteSize;
+
+		memcpy(
+			staging.pData + stagingOffset,
+			reinterpret_cast<const uint8_t*>(lod.geometry.indexBuffer.GetData()) + indexOffset,
+			size_t(size));
+
+		cmdList->CopyBufferRegion(lod.indexResource.Get(), indexOffset, staging.pResource, staging.offset + stagingOffset, size);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ProgressiveMesh::_finalizeLod(const GraphicsCommandList::Ptr& cmdList, const uint32_t lodIndex)
+{
+	Lod& lod = m_pLods[lodIndex];
+
+	D3D12_RESOURCE_BARRIER barrier[2];
+	barrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier[0].Transition.pResource = lod.vertexResource.Get();
+	barrier[0].Transition.Subresource = 0;
+	barrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+	barrier[0].Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+
+	barrier[1] = barrier[0];
+	barrier[1].Transition.pResource = lod.indexResource.Get();
+	barrier[1].Transition.StateAfter = D3D12_RESOURCE_STATE_INDEX_BUFFER;
+
+	// Every copy into the level has been recorded, so transition its buffers for use by the input assembler. Draws
+	// recorded after this on the same command list will see the finished level.
+	cmdList->ResourceBarrier(_countof(barrier), barrier);
+
+	// All of the level's data has been copied to staging memory, so the CPU copy is no longer needed.
+	lod.geometry = StaticMesh::Geometry();
+	lod.requestId = Utility::StreamScheduler::InvalidRequestId;
+
+	// Levels are streamed from coarsest to finest, so a finished level is always finer than the current one.
+	if(lodIndex < m_residentLod)
+	{
+		m_residentLod = lodIndex;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "StaticMesh.hpp"
+
+#include "../../Utility/StreamScheduler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_PROGRESSIVE_MESH_MAX_LOD_COUNT 8
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class ProgressiveMesh;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Mesh that becomes drawable as soon as its coarsest level of detail has been uploaded, with each finer level streamed
+// in over later frames through a per-frame byte budget. LOD 0 is always the full-detail source geometry; every other
+// level is generated by clustering the vertices of the source on a grid that doubles in resolution with each finer
+// level. Only the coarsest level is generated up front. The rest are generated from coarsest to finest by a job on the
+// shared thread pool, and each one is queued for streaming as soon as the job finishes it. Every level lives in
+// default heap buffers that are filled with copies from staging memory in the upload ring.
+class DF_API DemoFramework::D3D12::ProgressiveMesh
+	: public DemoFramework::D3D12::IMesh
+{
+public:
+
+	typedef std::shared_ptr<ProgressiveMesh> Ptr;
+	typedef Utility::Array<Ptr>              PtrArray;
+
+	ProgressiveMesh();
+	virtual ~ProgressiveMesh();
+
+	// The geometry becomes LOD 0 and is kept until that level has been streamed in, so it's moved in rather than copied.
+	// The upload of the coarsest level is recorded on the command list, and the upload ring is kept for staging the
+	// remaining levels until the mesh is fully resident. Finer levels are generated in the background afterward.
+	static ProgressiveMesh::Ptr Create(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
+		const char* name,
+		StaticMesh::Geometry&& geometry,
+		uint32_t lodCount);
+
+	// Simplify the input geometry by merging all vertices that fall inside the same cell of a uniform grid spanning
+	// the geometry's bounds. Triangles that collapse as a result are removed.
+	static StaticMesh::Geometry Decimate(const StaticMesh::Geometry& geometry, uint32_t gridResolution);
+
+	// Queue any levels the background job has finished, then record copies for up to 'byteBudget' bytes of pending LOD
+	// data and return the number of bytes recorded. This should be called once per frame on the command list for that
+	// frame, before any draws using the mesh.
+	uint64_t Stream(const GraphicsCommandList::Ptr& cmdList, uint64_t byteBudget);
+
+	virtual void Draw(
+		const GraphicsCommandList::Ptr& cmdList,
+		uint32_t instanceCount,
+		uint32_t baseInstanceId) const override;
+
+	virtual const char* GetName() const override;
+
+	uint32_t GetLodCount() const;
+	uint32_t GetResidentLod() const;
+
+	// Bytes of the levels that have been generated but not streamed in yet.
+	uint64_t GetPendingBytes() const;
+
+	bool IsFullyResident() const;
+
+
+private:
+
+	struct Lod;
+	struct BuildJob;
+
+	static void _runBuildJob(BuildJob&);
+
+	void _queueLod(uint32_t);
+
+	bool _createLodResources(const Device::Ptr&, Lod&);
+	bool _uploadLodData(const GraphicsCommandList::Ptr&, Lod&, uint64_t, uint64_t);
+	void _finalizeLod(const GraphicsCommandList::Ptr&, uint32_t);
+
+	char m_name[DF_MESH_NAME_MAX_SIZE];
+
+	// Only held while there are levels left to stream.
+	Device::Ptr m_device;
+	UploadRing::Ptr m_uploadRing;
+
+	Lod* m_pLods;
+
+	// Only held while the background job has levels left to generate.
+	std::shared_ptr<BuildJob> m_buildJob;
+
+	Utility::StreamScheduler m_scheduler;
+
+	uint32_t m_lodCount;
+	uint32_t m_residentLod;
+
+	// Finest level handed to the stream scheduler so far.
+	uint32_t m_queuedLod;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API DemoFramework::D3D12::ProgressiveMesh::Ptr;
+template class DF_API DemoFramework::D3D12::ProgressiveMesh::PtrArray;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::ProgressiveMesh::ProgressiveMesh()
+	: m_name()
+	, m_device()
+	, m_uploadRing()
+	, m_pLods(nullptr)
+	, m_buildJob()
+	, m_scheduler()
+	, m_lodCount(0)
+	, m_residentLod(0)
+	, m_queuedLod(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::D3D12::ProgressiveMesh::GetLodCount() const
+{
+	return m_lodCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::D3D12::ProgressiveMesh::GetResidentLod() const
+{
+	return m_residentLod;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::ProgressiveMesh::GetPendingBytes() const
+{
+	return m_scheduler.GetPendingBytes();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::ProgressiveMesh::IsFullyResident() const
+{
+	return m_residentLod == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
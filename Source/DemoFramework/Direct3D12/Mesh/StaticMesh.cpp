@@ -27,11 +27,13 @@
 DemoFramework::D3D12::StaticMesh::Ptr DemoFramework::D3D12::StaticMesh::Create(
 	const Device::Ptr& device,
 	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
 	const char* const name,
 	const Geometry& geometry)
 {
 	if(!device
 		|| !cmdList
+		|| !uploadRing
 		|| !name
 		|| name[0] == '\0'
 		|| geometry.vertexBuffer.GetCount() == 0
@@ -56,9 +58,9 @@ DemoFramework::D3D12::StaticMesh::Ptr DemoFramework::D3D12::StaticMesh::Create(
 
 	constexpr D3D12_HEAP_PROPERTIES heapProps =
 	{
-		D3D12_HEAP_TYPE_CUSTOM,         // D3D12_HEAP_TYPE Type
-		D3D12_CPU_PAGE_PROPERTY_WRITE_COMBINE, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
-		D3D12_MEMORY_POOL_L0,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
 		0,                               // UINT CreationNodeMask
 		0,                               // UINT VisibleNodeMask
 	};
@@ -96,8 +98,8 @@ DemoFramework::D3D12::StaticMesh::Ptr DemoFramework::D3D12::StaticMesh::Create(
 		device,
 		vertexDesc,
 		heapProps,
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		D3D12_RESOURCE_STATE_GENERIC_READ);
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
 	if(!output->m_vertexResource)
 	{
 		LOG_ERROR("Failed to create model vertex buffer: name=\"%s\"", name);
@@ -108,53 +110,44 @@ DemoFramework::D3D12::StaticMesh::Ptr DemoFramework::D3D12::StaticMesh::Create(
 		device,
 		indexDesc,
 		heapProps,
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		D3D12_RESOURCE_STATE_GENERIC_READ);
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
 	if(!output->m_indexResource)
 	{
 		LOG_ERROR("Failed to create model index buffer: name=\"%s\"", name);
 		return Ptr();
 	}
 
-	constexpr D3D12_RANGE dummyReadRange =
-	{
-		0, // SIZE_T Begin
-		0, // SIZE_T End
-	};
+	const uint64_t vertexDataSize = vertexDesc.Width;
+	const uint64_t indexDataSize = indexDesc.Width;
 
-	Geometry::Vertex* pVertexBuffer = nullptr;
-	Geometry::Index* pIndexBuffer = nullptr;
+	// The index data is placed after the vertex data.
+	const uint64_t indexDataOffset = ((vertexDataSize + 15) / 16) * 16;
 
-	// Map the vertex buffer to CPU-accessible memory.
-	const HRESULT mapVertexBufferResult = output->m_vertexResource->Map(0, &dummyReadRange, reinterpret_cast<void**>(&pVertexBuffer));
-	if(FAILED(mapVertexBufferResult))
-	{
-		LOG_ERROR("Failed to map static mesh vertex buffer; name=\"%s\", result='0x%08" PRIX32 "'", name, mapVertexBufferResult);
-		return Ptr();
-	}
-
-	// Copy the vertex data to the GPU resource.
-	memcpy(pVertexBuffer, geometry.vertexBuffer.GetData(), sizeof(Geometry::Vertex) * geometry.vertexBuffer.GetCount());
-	output->m_vertexResource->Unmap(0, nullptr);
+	UploadRing::Allocation staging;
 
-	// Map the index buffer to CPU-accessible memory.
-	const HRESULT mapIndexBufferResult = output->m_indexResource->Map(0, &dummyReadRange, reinterpret_cast<void**>(&pIndexBuffer));
-	if(FAILED(mapVertexBufferResult))
+	// Stage the vertex and index data in the upload ring. Only a flush can free up space used by uploads that haven't
+	// been submitted yet, which can't be done from here, so fall back to a dedicated upload buffer when it's full.
+	if(!uploadRing->Allocate(indexDataOffset + indexDataSize, 16, staging)
+		&& !uploadRing->AllocateDedicated(device, indexDataOffset + indexDataSize, staging))
 	{
-		LOG_ERROR("Failed to map static mesh index buffer; name=\"%s\", result='0x%08" PRIX32 "'", name, mapIndexBufferResult);
+		LOG_ERROR("Failed to allocate static mesh staging data: name=\"%s\"", name);
 		return Ptr();
 	}
 
-	// Copy the index data to the GPU resource.
-	memcpy(pIndexBuffer, geometry.indexBuffer.GetData(), sizeof(Geometry::Index) * geometry.indexBuffer.GetCount());
-	output->m_indexResource->Unmap(0, nullptr);
+	// Copy the vertex and index data to the staging memory, then from there to the GPU resources.
+	memcpy(staging.pData, geometry.vertexBuffer.GetData(), size_t(vertexDataSize));
+	memcpy(staging.pData + indexDataOffset, geometry.indexBuffer.GetData(), size_t(indexDataSize));
+
+	cmdList->CopyBufferRegion(output->m_vertexResource.Get(), 0, staging.pResource, staging.offset, vertexDataSize);
+	cmdList->CopyBufferRegion(output->m_indexResource.Get(), 0, staging.pResource, staging.offset + indexDataOffset, indexDataSize);
 
 	D3D12_RESOURCE_BARRIER barrier[2];
 	barrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 	barrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 	barrier[0].Transition.pResource = output->m_vertexResource.Get();
 	barrier[0].Transition.Subresource = 0;
-	barrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ;
+	barrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
 	barrier[0].Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
 
 	barrier[1] = barrier[0];
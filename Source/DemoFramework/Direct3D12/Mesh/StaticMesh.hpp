@@ -21,6 +21,8 @@
 
 #include "Mesh.hpp"
 
+#include "../UploadRing.hpp"
+
 #include "../../Utility/Array.hpp"
 
 #include <vector>
@@ -70,9 +72,11 @@ public:
 	StaticMesh();
 	virtual ~StaticMesh() {}
 
+	// The geometry is copied to GPU-resident buffers on the command list through staging memory from the upload ring.
 	static StaticMesh::Ptr Create(
 		const Device::Ptr& device,
 		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
 		const char* name,
 		const Geometry& geometry);
 
@@ -91,9 +95,6 @@ private:
 	Resource::Ptr m_vertexResource;
 	Resource::Ptr m_indexResource;
 
-	Resource::Ptr m_stagingVertexResource;
-	Resource::Ptr m_stagingIndexResource;
-
 	uint32_t m_vertexCount;
 	uint32_t m_indexCount;
 };
@@ -111,8 +112,6 @@ inline DemoFramework::D3D12::StaticMesh::StaticMesh()
 	: m_name()
 	, m_vertexResource()
 	, m_indexResource()
-	, m_stagingVertexResource()
-	, m_stagingIndexResource()
 	, m_vertexCount(0)
 	, m_indexCount(0)
 {
@@ -17,11 +17,11 @@
 //
 
 #include "Model.hpp"
-#include "Sync.hpp"
 
 #include "LowLevel/Resource.hpp"
 
 #include "../Application/Log.hpp"
+#include "../Utility/PixelConvert.hpp"
 
 #include <tiny_obj_loader.h>
 
@@ -68,11 +68,31 @@ constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
 	0, // UINT Quality
 };
 
-constexpr D3D12_RANGE disabledCpuReadRange =
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool AllocateStaging(
+	const DemoFramework::D3D12::CommandQueue::Ptr& cmdQueue,
+	const DemoFramework::D3D12::GraphicsCommandContext::Ptr& uploadContext,
+	const DemoFramework::D3D12::UploadRing::Ptr& uploadRing,
+	const uint64_t size,
+	DemoFramework::D3D12::UploadRing::Allocation& outAllocation)
 {
-	0, // SIZE_T Begin
-	0, // SIZE_T End
-};
+	// Buffer copies have no alignment requirements, but keeping the source data aligned is cheap.
+	constexpr uint64_t alignment = 16;
+
+	if(uploadRing->Allocate(size, alignment, outAllocation))
+	{
+		return true;
+	}
+
+	// The copies recorded so far are holding on to the rest of the ring, so flush them to make room.
+	uploadContext->Submit(cmdQueue);
+	uploadRing->Signal(cmdQueue);
+	uploadRing->WaitForIdle();
+	uploadContext->Reset();
+
+	return uploadRing->Allocate(size, alignment, outAllocation);
+}
 
 //---------------------------------------------------------------------------------------------------------------------
 
@@ -80,11 +100,13 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 	const Device::Ptr& device,
 	const CommandQueue::Ptr& cmdQueue,
 	const GraphicsCommandContext::Ptr& uploadContext,
-	const char* const filePath)
+	const UploadRing::Ptr& uploadRing,
+	const char* const filePath,
+	const CpuDataRetention retention)
 {
 	using namespace DirectX;
 
-	if(!device || !filePath || filePath[0] == '\0')
+	if(!device || !cmdQueue || !uploadContext || !uploadRing || !filePath || filePath[0] == '\0')
 	{
 		LOG_ERROR("Invalid parameter");
 		return Ptr();
@@ -105,9 +127,13 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 		return Ptr();
 	}
 
+	// Pack all of the vertex colors in one pass so resolving each unique vertex only has to look its color up.
+	std::vector<uint32_t> packedColors(attrib.colors.size() / 3);
+	Utility::PixelConvert::FloatRgbToUnormRgba(attrib.colors.data(), packedColors.data(), packedColors.size());
+
 	if(shapes.size() > 0)
 	{
-		auto createMesh = [&device, &cmdQueue, &uploadContext, &attrib](const tinyobj::shape_t& shape) -> Mesh*
+		auto createMesh = [&device, &cmdQueue, &uploadContext, &uploadRing, &attrib, &packedColors, retention](const tinyobj::shape_t& shape) -> Mesh*
 		{
 			std::unordered_map<
 				tinyobj::index_t,
@@ -121,7 +147,7 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 
 			uint32_t largestVertexIndex = 0;
 
-			auto mapIndex = [&attrib, &indexLookupTable, &resolvedVertices, &resolvedIndicies, &largestVertexIndex](const tinyobj::index_t& index)
+			auto mapIndex = [&attrib, &packedColors, &indexLookupTable, &resolvedVertices, &resolvedIndicies, &largestVertexIndex](const tinyobj::index_t& index)
 			{
 				auto indexKv = indexLookupTable.find(index);
 				if(indexKv == indexLookupTable.end())
@@ -141,11 +167,7 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 					vertex.tex.u = attrib.texcoords[(2 * index.texcoord_index) + 0];
 					vertex.tex.v = attrib.texcoords[(2 * index.texcoord_index) + 1];
 
-					const float32_t r = attrib.colors[(3 * index.vertex_index) + 0];
-					const float32_t g = attrib.colors[(3 * index.vertex_index) + 1];
-					const float32_t b = attrib.colors[(3 * index.vertex_index) + 2];
-
-					vertex.col = 0xFF000000 | (uint32_t(b * 255.0f) << 16) | (uint32_t(g * 255.0f) << 8) | uint32_t(r * 255.0f);
+					vertex.col = packedColors[index.vertex_index];
 
 					XMVECTORF32 normal;
 					normal.f[0] = vertex.nrm.x;
@@ -293,15 +315,6 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 				0,                               // UINT VisibleNodeMask
 			};
 
-			const D3D12_HEAP_PROPERTIES uploadHeapProps =
-			{
-				D3D12_HEAP_TYPE_UPLOAD,          // D3D12_HEAP_TYPE Type
-				D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
-				D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
-				0,                               // UINT CreationNodeMask
-				0,                               // UINT VisibleNodeMask
-			};
-
 			const D3D12_RESOURCE_DESC vertexBufferDesc =
 			{
 				D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
@@ -330,32 +343,6 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 				D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
 			};
 
-			// Create the staging vertex buffer.
-			Resource::Ptr stagingVertexBuffer = CreateCommittedResource(
-				device,
-				vertexBufferDesc,
-				uploadHeapProps,
-				D3D12_HEAP_FLAG_NONE,
-				D3D12_RESOURCE_STATE_GENERIC_READ);
-			if(!stagingVertexBuffer)
-			{
-				delete pMesh;
-				return nullptr;
-			}
-
-			// Create the staging index buffer;
-			Resource::Ptr stagingIndexBuffer = CreateCommittedResource(
-				device,
-				indexBufferDesc,
-				uploadHeapProps,
-				D3D12_HEAP_FLAG_NONE,
-				D3D12_RESOURCE_STATE_GENERIC_READ);
-			if(!stagingIndexBuffer)
-			{
-				delete pMesh;
-				return nullptr;
-			}
-
 			// Create the mesh vertex buffer.
 			pMesh->vertexBuffer = CreateCommittedResource(
 				device,
@@ -382,33 +369,29 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 				return nullptr;
 			}
 
-			// Create the staging command synchronization primitive so we can wait for
-			// all staging resource copies to complete at the end of initialization.
-			D3D12::Sync::Ptr stagingCmdSync = D3D12::Sync::Create(device, D3D12_FENCE_FLAG_NONE);
-			if(!stagingCmdSync)
+			const uint64_t vertexDataSize = sizeof(Vertex) * uint64_t(pMesh->vertexCount);
+			const uint64_t indexDataSize = uint64_t(pMesh->indexStride) * pMesh->indexCount;
+
+			// The index data is placed after the vertex data.
+			const uint64_t indexDataOffset = ((vertexDataSize + 15) / 16) * 16;
+
+			UploadRing::Allocation staging;
+
+			// Stage the vertex and index data together in a single allocation. Allocating them separately could
+			// flush the uploads in between, which would free the first allocation before its copy was recorded.
+			if(!AllocateStaging(cmdQueue, uploadContext, uploadRing, indexDataOffset + indexDataSize, staging))
 			{
+				LOG_ERROR(
+					"Mesh data does not fit in the upload ring: name=\"%s\", size=%" PRIu64 ", ringCapacity=%" PRIu64,
+					shape.name.c_str(),
+					indexDataOffset + indexDataSize,
+					uploadRing->GetCapacity());
 				delete pMesh;
 				return nullptr;
 			}
 
-			void* pStagingVertexData = nullptr;
-			void* pStagingIndexData = nullptr;
-
-			// Map the staging vertex buffer with CPU read access disabled.
-			const HRESULT mapVertexBufferResult = stagingVertexBuffer->Map(0, &disabledCpuReadRange, &pStagingVertexData);
-			assert(mapVertexBufferResult == S_OK); (void) mapVertexBufferResult;
-
-			// Copy the vertex data into the staging buffer, then unmap it.
-			memcpy(pStagingVertexData, pMesh->pVertices, sizeof(Vertex) * pMesh->vertexCount);
-			stagingVertexBuffer->Unmap(0, nullptr);
-
-			// Map the staging index buffer with CPU read access disabled.
-			const HRESULT mapIndexBufferResult = stagingIndexBuffer->Map(0, &disabledCpuReadRange, &pStagingIndexData);
-			assert(mapIndexBufferResult == S_OK); (void) mapIndexBufferResult;
-
-			// Copy the index data into the staging buffer, then unmap it.
-			memcpy(pStagingIndexData, pMesh->pIndices, pMesh->indexStride * pMesh->indexCount);
-			stagingIndexBuffer->Unmap(0, nullptr);
+			memcpy(staging.pData, pMesh->pVertices, size_t(vertexDataSize));
+			memcpy(staging.pData + indexDataOffset, pMesh->pIndices, size_t(indexDataSize));
 
 			D3D12_RESOURCE_BARRIER vertexBufferBarrier, indexBufferBarrier;
 
@@ -434,20 +417,44 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 
 			ID3D12GraphicsCommandList* const pUploadCmdList = uploadContext->GetCmdList().Get();
 
-			// Before rendering begins, use a temporary command list to copy all buffer data.
-			pUploadCmdList->CopyResource(pMesh->vertexBuffer.Get(), stagingVertexBuffer.Get());
-			pUploadCmdList->CopyResource(pMesh->indexBuffer.Get(), stagingIndexBuffer.Get());
+			// Before rendering begins, use the upload command list to copy all buffer data.
+			pUploadCmdList->CopyBufferRegion(pMesh->vertexBuffer.Get(), 0, staging.pResource, staging.offset, vertexDataSize);
+			pUploadCmdList->CopyBufferRegion(pMesh->indexBuffer.Get(), 0, staging.pResource, staging.offset + indexDataOffset, indexDataSize);
 			pUploadCmdList->ResourceBarrier(_countof(bufferBarriers), bufferBarriers);
 
-			// Stop recording commands in the staging command list and begin executing it.
-			uploadContext->Submit(cmdQueue);
+			// The data is in the upload ring now, so the CPU-side copies of the mesh data can be trimmed right away.
+			switch(retention)
+			{
+				case CpuDataRetention::Full:
+					break;
+
+				case CpuDataRetention::Compact:
+				{
+					pMesh->pPositions = new Vertex::Vec3[pMesh->vertexCount];
 
-			// Wait for the staging command list to finish executing.
-			stagingCmdSync->Signal(cmdQueue);
-			stagingCmdSync->Wait();
+					// Keep only the vertex positions since the remaining attributes are not needed outside of rendering.
+					for(uint32_t i = 0; i < pMesh->vertexCount; ++i)
+					{
+						pMesh->pPositions[i] = pMesh->pVertices[i].pos;
+					}
+
+					delete[] pMesh->pVertices;
+					pMesh->pVertices = nullptr;
+					break;
+				}
 
-			// Reset the command list so it can be used again.
-			uploadContext->Reset();
+				case CpuDataRetention::Discard:
+					delete[] pMesh->pVertices;
+
+					pMesh->pVertices = nullptr;
+					pMesh->FreeIndices();
+					break;
+
+				default:
+					// This should never happen.
+					assert(false);
+					break;
+			}
 
 			return pMesh;
 		};
@@ -480,8 +487,23 @@ DemoFramework::D3D12::Model::Ptr DemoFramework::D3D12::Model::CreateFromObj(
 		}
 	}
 
+	// Submit the remaining copies and wait for them so the model is ready to render once this returns.
+	uploadContext->Submit(cmdQueue);
+	uploadRing->Signal(cmdQueue);
+	uploadRing->WaitForIdle();
+	uploadContext->Reset();
+
 	output->m_initialized = true;
 
+	const MemoryStats memStats = output->GetMemoryStats();
+
+	LOG_WRITE(
+		"Loaded model \"%s\": meshCount=%zu, cpuBytes=%zu, gpuBytes=%zu",
+		filePath,
+		output->m_meshCount,
+		memStats.cpuBytes,
+		memStats.gpuBytes);
+
 	return output;
 }
 
@@ -523,3 +545,39 @@ void DemoFramework::D3D12::Model::Render(
 }
 
 //---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Model::MemoryStats DemoFramework::D3D12::Model::GetMemoryStats() const
+{
+	MemoryStats output;
+	output.cpuBytes = 0;
+	output.gpuBytes = 0;
+
+	for(size_t meshIndex = 0; meshIndex < m_meshCount; ++meshIndex)
+	{
+		const Mesh* const pMesh = m_ppMeshes[meshIndex];
+
+		const size_t vertexDataSize = sizeof(Vertex) * size_t(pMesh->vertexCount);
+		const size_t indexDataSize = size_t(pMesh->indexStride) * size_t(pMesh->indexCount);
+
+		if(pMesh->pVertices)
+		{
+			output.cpuBytes += vertexDataSize;
+		}
+
+		if(pMesh->pPositions)
+		{
+			output.cpuBytes += sizeof(Vertex::Vec3) * size_t(pMesh->vertexCount);
+		}
+
+		if(pMesh->pIndices)
+		{
+			output.cpuBytes += indexDataSize;
+		}
+
+		output.gpuBytes += vertexDataSize + indexDataSize;
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
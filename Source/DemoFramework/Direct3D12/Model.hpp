@@ -20,6 +20,7 @@
 //---------------------------------------------------------------------------------------------------------------------
 
 #include "CommandContext.hpp"
+#include "UploadRing.hpp"
 
 #include <memory>
 
@@ -41,6 +42,20 @@ public:
 
 	typedef std::shared_ptr<Model> Ptr;
 
+	// Controls which CPU-side copies of the mesh data are kept after the data has been uploaded to the GPU.
+	enum class CpuDataRetention
+	{
+		Full,    // Keep the full vertex and index arrays.
+		Compact, // Keep only the vertex positions and the index array (e.g., for CPU picking and collision).
+		Discard, // Free all CPU-side copies once the GPU buffers have been written.
+	};
+
+	struct MemoryStats
+	{
+		size_t cpuBytes; // Total size of the CPU-side copies of the mesh data.
+		size_t gpuBytes; // Total size of the vertex and index buffers on the GPU.
+	};
+
 	struct Vertex
 	{
 		struct Vec3
@@ -66,10 +81,14 @@ public:
 		Mesh();
 		~Mesh();
 
+		// Delete the CPU copy of the indices through the integer type they were allocated as.
+		void FreeIndices();
+
 		Resource::Ptr vertexBuffer;
 		Resource::Ptr indexBuffer;
 
 		Vertex* pVertices;
+		Vertex::Vec3* pPositions;
 		void* pIndices;
 
 		uint32_t vertexCount;
@@ -95,10 +114,14 @@ public:
 		const Device::Ptr& device,
 		const CommandQueue::Ptr& cmdQueue,
 		const GraphicsCommandContext::Ptr& uploadContext,
-		const char* filePath);
+		const UploadRing::Ptr& uploadRing,
+		const char* filePath,
+		CpuDataRetention retention = CpuDataRetention::Full);
 
 	void Render(const GraphicsCommandList::Ptr& cmdList, uint32_t instanceCount, D3D12_PRIMITIVE_TOPOLOGY topology);
 
+	MemoryStats GetMemoryStats() const;
+
 
 private:
 
@@ -143,6 +166,7 @@ inline DemoFramework::D3D12::Model::Mesh::Mesh()
 	: vertexBuffer()
 	, indexBuffer()
 	, pVertices(nullptr)
+	, pPositions(nullptr)
 	, pIndices(nullptr)
 	, vertexCount(0)
 	, indexCount(0)
@@ -162,10 +186,33 @@ inline DemoFramework::D3D12::Model::Mesh::~Mesh()
 		delete[] pVertices;
 	}
 
-	if(pIndices)
+	if(pPositions)
+	{
+		delete[] pPositions;
+	}
+
+	FreeIndices();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::D3D12::Model::Mesh::FreeIndices()
+{
+	if(!pIndices)
 	{
-		delete[] pIndices;
+		return;
 	}
+
+	if(indexStride == sizeof(uint16_t))
+	{
+		delete[] reinterpret_cast<uint16_t*>(pIndices);
+	}
+	else
+	{
+		delete[] reinterpret_cast<uint32_t*>(pIndices);
+	}
+
+	pIndices = nullptr;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ProbeCache.hpp"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Hash.hpp"
+#include "../Utility/Math.hpp"
+
+#include <stdio.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_PROBE_CACHE_MAGIC   0x42525044ul // "DPRB"
+#define DF_PROBE_CACHE_VERSION 1
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct ProbeCacheFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	DemoFramework::D3D12::ProbeCache::Key key;
+	DemoFramework::Utility::ShProjection::Coefficients coefficients;
+
+	uint64_t envDataOffset;
+	uint64_t envDataSize;
+	uint64_t irrDataOffset;
+	uint64_t irrDataSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::ProbeCache::Ptr DemoFramework::D3D12::ProbeCache::Create(const char* const directoryPath)
+{
+	if(!directoryPath || directoryPath[0] == '\0' || strlen(directoryPath) >= MAX_PATH)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<ProbeCache>();
+
+	snprintf(output->m_directoryPath, MAX_PATH, "%s", directoryPath);
+
+	char partialPath[MAX_PATH];
+
+	// Create each directory along the path. Failures are ignored here since most of
+	// them will simply be directories that already exist; the final check catches the rest.
+	for(size_t i = 0; directoryPath[i] != '\0'; ++i)
+	{
+		partialPath[i] = directoryPath[i];
+
+		if((directoryPath[i + 1] == '/' || directoryPath[i + 1] == '\\' || directoryPath[i + 1] == '\0')
+			&& directoryPath[i] != ':')
+		{
+			partialPath[i + 1] = '\0';
+			CreateDirectoryA(partialPath, nullptr);
+		}
+	}
+
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if(!GetFileAttributesExA(directoryPath, GetFileExInfoStandard, &attributes)
+		|| (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+	{
+		LOG_ERROR("Failed to create probe cache directory: path=\"%s\"", directoryPath);
+		return Ptr();
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ProbeCache::MakeKey(
+	const char* const sourceFilePath,
+	const uint64_t paramHash,
+	Key& outKey) const
+{
+	if(!sourceFilePath || sourceFilePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const Utility::MappedFile::Ptr sourceFile = Utility::MappedFile::Open(sourceFilePath);
+	if(!sourceFile)
+	{
+		return false;
+	}
+
+	outKey.pathHash = Utility::Hash::Compute(sourceFilePath, strlen(sourceFilePath));
+	outKey.paramHash = paramHash;
+	outKey.contentHash = Utility::Hash::Compute(sourceFile->GetData(), size_t(sourceFile->GetSize()));
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ProbeCache::Find(const Key& key, Entry& outEntry) const
+{
+	char entryPath[MAX_PATH];
+	_getEntryPath(key, entryPath, sizeof(entryPath));
+
+	Utility::MappedFile::Ptr file = Utility::MappedFile::Open(entryPath);
+	if(!file)
+	{
+		// No cache entry exists.
+		return false;
+	}
+
+	if(file->GetSize() < sizeof(ProbeCacheFileHeader))
+	{
+		return false;
+	}
+
+	ProbeCacheFileHeader header;
+	memcpy(&header, file->GetData(), sizeof(header));
+
+	// Reject entries from other versions, entries baked from a different version of the source
+	// file, and any entry that was truncated while being written.
+	if(header.magic != DF_PROBE_CACHE_MAGIC
+		|| header.version != DF_PROBE_CACHE_VERSION
+		|| header.key.pathHash != key.pathHash
+		|| header.key.paramHash != key.paramHash
+		|| header.key.contentHash != key.contentHash
+		|| header.envDataOffset < sizeof(ProbeCacheFileHeader)
+		|| header.envDataOffset + header.envDataSize > header.irrDataOffset
+		|| header.irrDataOffset + header.irrDataSize > file->GetSize())
+	{
+		return false;
+	}
+
+	outEntry.coefficients = header.coefficients;
+	outEntry.pEnvData = file->GetData() + header.envDataOffset;
+	outEntry.pIrrData = file->GetData() + header.irrDataOffset;
+	outEntry.envDataSize = header.envDataSize;
+	outEntry.irrDataSize = header.irrDataSize;
+	outEntry.file = file;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ProbeCache::Store(
+	const Key& key,
+	const Utility::ShProjection::Coefficients& coefficients,
+	const uint8_t* const pEnvData,
+	const uint64_t envDataSize,
+	const uint8_t* const pIrrData,
+	const uint64_t irrDataSize) const
+{
+	using namespace DemoFramework::Utility;
+
+	if(!pEnvData
+		|| envDataSize == 0
+		|| !pIrrData
+		|| irrDataSize == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	ProbeCacheFileHeader header;
+	header.magic = DF_PROBE_CACHE_MAGIC;
+	header.version = DF_PROBE_CACHE_VERSION;
+	header.key = key;
+	header.coefficients = coefficients;
+	header.envDataOffset = Math::GetAlignedSize(uint64_t(sizeof(ProbeCacheFileHeader)), uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+	header.envDataSize = envDataSize;
+	header.irrDataOffset = Math::GetAlignedSize(header.envDataOffset + envDataSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+	header.irrDataSize = irrDataSize;
+
+	char entryPath[MAX_PATH];
+	_getEntryPath(key, entryPath, sizeof(entryPath));
+
+	FILE* const pFile = fopen(entryPath, "wb");
+	if(!pFile)
+	{
+		LOG_ERROR("Failed to open probe cache entry for writing: path=\"%s\"", entryPath);
+		return false;
+	}
+
+	uint8_t padding[D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT] = {};
+
+	const size_t headerPaddingSize = size_t(header.envDataOffset - sizeof(header));
+	const size_t envPaddingSize = size_t(header.irrDataOffset - header.envDataOffset - envDataSize);
+
+	// Each block of texel data starts on an aligned offset so it can be copied
+	// straight from the mapped file into staging memory at the same alignment.
+	const bool result = (fwrite(&header, sizeof(header), 1, pFile) == 1)
+		&& (headerPaddingSize == 0 || fwrite(padding, headerPaddingSize, 1, pFile) == 1)
+		&& (fwrite(pEnvData, size_t(envDataSize), 1, pFile) == 1)
+		&& (envPaddingSize == 0 || fwrite(padding, envPaddingSize, 1, pFile) == 1)
+		&& (fwrite(pIrrData, size_t(irrDataSize), 1, pFile) == 1);
+
+	fclose(pFile);
+
+	if(!result)
+	{
+		LOG_ERROR("Failed to write probe cache entry: path=\"%s\"", entryPath);
+
+		// Don't leave a partial entry behind.
+		remove(entryPath);
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ProbeCache::_getEntryPath(const Key& key, char* const outPath, const size_t pathSize) const
+{
+	// Only the path and parameters go into the entry name so a changed source file replaces its old entry
+	// instead of leaving it behind. The content hash is verified against the header on lookup.
+	const uint64_t nameHash = Utility::Hash::Combine(key.pathHash, key.paramHash);
+
+	snprintf(outPath, pathSize, "%s/%016" PRIx64 DF_PROBE_CACHE_FILE_EXTENSION, m_directoryPath, nameHash);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
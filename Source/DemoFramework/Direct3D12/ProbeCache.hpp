@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "LowLevel/Types.hpp"
+
+#include "../Utility/MappedFile.hpp"
+#include "../Utility/ShProjection.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_PROBE_CACHE_FILE_EXTENSION ".dfprobe"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class ProbeCache;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// On-disk cache of baked reflection probe results. Each entry holds the SH coefficients of the environment along with
+// the texel data of the environment and irradiance cube maps, laid out exactly the way the probe copies them to and
+// from its resources, so a cache hit is just a matter of mapping the file and copying it into staging memory.
+//
+// Keys work the same way as TextureCache keys. Entries are named after the source path and bake parameters, and the
+// hash of the source file's contents is checked on lookup so editing the source image invalidates its entry.
+class DF_API DemoFramework::D3D12::ProbeCache
+{
+public:
+
+	typedef std::shared_ptr<ProbeCache> Ptr;
+
+	struct Key
+	{
+		uint64_t pathHash;
+		uint64_t paramHash;
+		uint64_t contentHash;
+	};
+
+	struct Entry
+	{
+		Utility::MappedFile::Ptr file;
+
+		Utility::ShProjection::Coefficients coefficients;
+
+		const uint8_t* pEnvData;
+		const uint8_t* pIrrData;
+
+		uint64_t envDataSize;
+		uint64_t irrDataSize;
+	};
+
+	ProbeCache();
+	ProbeCache(const ProbeCache&) = delete;
+	ProbeCache(ProbeCache&&) = delete;
+
+	ProbeCache& operator =(const ProbeCache&) = delete;
+	ProbeCache& operator =(ProbeCache&&) = delete;
+
+	static Ptr Create(const char* directoryPath);
+
+	// Build the key for a source file. This reads the entire source file to hash its contents.
+	bool MakeKey(const char* sourceFilePath, uint64_t paramHash, Key& outKey) const;
+
+	bool Find(const Key& key, Entry& outEntry) const;
+
+	bool Store(
+		const Key& key,
+		const Utility::ShProjection::Coefficients& coefficients,
+		const uint8_t* pEnvData,
+		uint64_t envDataSize,
+		const uint8_t* pIrrData,
+		uint64_t irrDataSize) const;
+
+
+private:
+
+	void _getEntryPath(const Key&, char*, size_t) const;
+
+	char m_directoryPath[MAX_PATH];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::ProbeCache>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::ProbeCache::ProbeCache()
+	: m_directoryPath()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
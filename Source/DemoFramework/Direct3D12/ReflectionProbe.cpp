@@ -23,34 +23,135 @@
 
 #include "LowLevel/DescriptorHeap.hpp"
 #include "LowLevel/PipelineState.hpp"
+#include "LowLevel/QueryHeap.hpp"
 #include "LowLevel/Resource.hpp"
 #include "LowLevel/RootSignature.hpp"
 
 #include "Shaders/reflection-probe/common.hlsli"
 
 #include "../Application/Log.hpp"
+#include "../Utility/Hash.hpp"
+#include "../Utility/Math.hpp"
+#include "../Utility/SpecularPrefilter.hpp"
 
 #include <DirectXTex.h>
 #include <stb_image.h>
 
+#include <utility>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Bumping this invalidates every probe cache entry baked by older versions of the probe code. Changes to the
+// shaders don't need it since their bytecode is already part of the cache key.
+#define DF_REFL_PROBE_CACHE_PARAM_VERSION 2
+
+// Most steps the update scheduler can hand out in a single frame. Budgets big enough to need more than this are
+// better served by LoadEnvironmentMap().
+#define DF_REFL_PROBE_MAX_UPDATE_STEPS 64
+
+// One timestamp is written before and after the update work recorded each frame.
+#define DF_REFL_PROBE_TIMESTAMP_SLOT_COUNT (DF_REFL_PROBE_MAX_FRAMES_IN_FLIGHT + 1)
+
+// Bakes write a timestamp at their start, before the specular prefilter and at their end, following the update slots.
+#define DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX (DF_REFL_PROBE_TIMESTAMP_SLOT_COUNT * 2)
+#define DF_REFL_PROBE_LOAD_TIMESTAMP_COUNT 3
+
+#define DF_REFL_PROBE_TIMESTAMP_COUNT (DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX + DF_REFL_PROBE_LOAD_TIMESTAMP_COUNT)
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool ValidateEnvTexture(const DemoFramework::D3D12::Texture2D::Ptr& envTexture)
+{
+	if(envTexture->GetFormat() != DXGI_FORMAT_R32G32B32A32_FLOAT
+		&& envTexture->GetFormat() != DXGI_FORMAT_R16G16B16A16_FLOAT
+		&& envTexture->GetFormat() != DXGI_FORMAT_R9G9B9E5_SHAREDEXP)
+	{
+		// The environment map is only read through an SRV, so any HDR format that reads back as float will work.
+		LOG_ERROR("Environment texture does not have the correct format");
+		return false;
+	}
+	else if(envTexture->GetWidth() != envTexture->GetHeight() * 2)
+	{
+		LOG_ERROR(
+			"Invalid environment texture dimensions; width must be equal to double the height: width=%" PRIu32 ", height=%" PRIu32,
+			envTexture->GetWidth(), envTexture->GetHeight());
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* GetEnvMapQualityName(const DemoFramework::D3D12::EnvMapQuality quality)
+{
+	switch(quality)
+	{
+		case DemoFramework::D3D12::EnvMapQuality::Low:  return "Low";
+		case DemoFramework::D3D12::EnvMapQuality::Mid:  return "Mid";
+		case DemoFramework::D3D12::EnvMapQuality::High: return "High";
+
+		default:
+			break;
+	}
+
+	return "Unknown";
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static SpecPrefilterRootConstant GetSpecPrefilterRootConstant(
+	const uint32_t envEdgeLength,
+	const uint32_t envMipCount,
+	const uint32_t mipIndex,
+	const uint32_t faceIndex,
+	const uint32_t rowOffset)
+{
+	const uint32_t mipSize = ((envEdgeLength >> mipIndex) > 0) ? (envEdgeLength >> mipIndex) : 1;
+
+	SpecPrefilterRootConstant output;
+	output.faceIndex = faceIndex;
+	output.edgeLength = mipSize;
+	output.invEdgeLength = 1.0f / float32_t(mipSize);
+	output.rowOffset = rowOffset;
+	output.sampleCount = DF_REFL_SPEC_SAMPLE_COUNT;
+	output.invSampleCount = 1.0f / float32_t(DF_REFL_SPEC_SAMPLE_COUNT);
+	output.roughness = DemoFramework::Utility::SpecularPrefilter::GetMipRoughness(mipIndex, envMipCount);
+	output.srcTexelSolidAngle = M_4_PI / (float32_t(DF_CUBE_FACE__COUNT) * float32_t(envEdgeLength) * float32_t(envEdgeLength));
+	output.srcMaxLod = float32_t(envMipCount - 1);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Where each part of a probe's baked results goes in staging memory, both for uploads from the probe cache and for
+// readbacks to it. The cube maps are laid out by the device's copyable footprints, with the final SH coefficients
+// following them. The probe cache stores two blobs per entry, so the specular map rides along after the environment
+// map in the first one.
+struct DemoFramework::D3D12::ReflectionProbe::CacheLayout
+{
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT envLayouts[DF_CUBE_FACE__COUNT * D3D12_REQ_MIP_LEVELS];
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT specLayouts[DF_CUBE_FACE__COUNT * D3D12_REQ_MIP_LEVELS];
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT irrLayouts[DF_CUBE_FACE__COUNT];
+
+	uint64_t envDataSize; // Includes the specular map
+	uint64_t irrDataSize;
+	uint64_t specOffset;
+	uint64_t irrOffset;
+	uint64_t coeffOffset;
+	uint64_t totalSize;
+};
+
 //---------------------------------------------------------------------------------------------------------------------
 
 DemoFramework::D3D12::ReflectionProbe::~ReflectionProbe()
 {
 	if(m_alloc)
 	{
-		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
-		{
-			for(uint32_t mipIndex = 0; mipIndex < m_envMipCount; ++mipIndex)
-			{
-				m_alloc->Free(m_envFaceUavDescriptor[(faceIndex * DF_CUBE_FACE__COUNT) + mipIndex]);
-			}
-
-			m_alloc->Free(m_irrFaceUavDescriptor[faceIndex]);
-		}
+		_freeCubeMaps(m_front);
+		_freeCubeMaps(m_back);
 
-		m_alloc->Free(m_envSrvDescriptor);
-		m_alloc->Free(m_irrSrvDescriptor);
 		m_alloc->Free(m_coeffSrvDescriptor);
 		m_alloc->Free(m_coeffUavDescriptor);
 		m_alloc->Free(m_weightSrvDescriptor);
@@ -123,6 +224,7 @@ DemoFramework::D3D12::ReflectionProbe::Ptr DemoFramework::D3D12::ReflectionProbe
 	output->m_envMipCount = calculateMipCount();
 	output->m_envEdgeLength = envMapEdgeLength;
 	output->m_irrEdgeLength = irrMapEdgeLength;
+	output->m_quality = mapQuality;
 
 	// Create the equi-to-cube pipeline.
 	if(!output->_initEquiToCubePipeline(device))
@@ -154,8 +256,14 @@ DemoFramework::D3D12::ReflectionProbe::Ptr DemoFramework::D3D12::ReflectionProbe
 		return Ptr();
 	}
 
-	// Create the environment and irradiance cube maps.
-	if(!output->_initCubeMaps(device))
+	// Create the spec-prefilter pipeline.
+	if(!output->_initSpecPrefilterPipeline(device))
+	{
+		return Ptr();
+	}
+
+	// Create the environment, irradiance and specular cube maps.
+	if(!output->_initCubeMaps(device, output->m_front))
 	{
 		return Ptr();
 	}
@@ -174,28 +282,57 @@ DemoFramework::D3D12::ReflectionProbe::Ptr DemoFramework::D3D12::ReflectionProbe
 bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 	const Device::Ptr& device,
 	const GraphicsCommandList::Ptr& cmdList,
-	const Texture2D::Ptr& envTexture)
+	const Texture2D::Ptr& envTexture,
+	const ProbeCache::Ptr& cache,
+	const UploadRing::Ptr& uploadRing)
 {
-	constexpr DXGI_FORMAT expectedFormat = DXGI_FORMAT_R32G32B32A32_FLOAT;
-
 	if(!device || !cmdList || !envTexture)
 	{
 		LOG_ERROR("Invalid parameter");
 		return false;
 	}
-	else if(envTexture->GetFormat() != expectedFormat)
+	else if(!ValidateEnvTexture(envTexture))
 	{
-		LOG_ERROR("Environment texture does not have the correct format");
 		return false;
 	}
-	else if(envTexture->GetWidth() != envTexture->GetHeight() * 2)
+	else if(cache && !uploadRing)
 	{
-		LOG_ERROR(
-			"Invalid environment texture dimensions; width must be equal to double the height: width=%" PRIu32 ", height=%" PRIu32,
-			envTexture->GetWidth(), envTexture->GetHeight());
+		LOG_ERROR("Loading a reflection probe through a probe cache requires an upload ring");
 		return false;
 	}
 
+	// Loading replaces the visible cube maps outright, so there's no point in finishing an update in progress.
+	CancelUpdate();
+
+	m_loadStopwatch.Restart();
+	m_loadPending = true;
+	m_loadFromCache = false;
+	m_loadTimed = false;
+
+	m_readbackResource.Reset();
+	m_cache.reset();
+
+	const char* const filePath = envTexture->GetFilePath();
+
+	if(cache && filePath[0] != '\0' && cache->MakeKey(filePath, _getCacheParamHash(envTexture), m_cacheKey))
+	{
+		ProbeCache::Entry cacheEntry;
+		if(cache->Find(m_cacheKey, cacheEntry))
+		{
+			if(_uploadCacheEntry(device, cmdList, uploadRing, cacheEntry))
+			{
+				m_loadFromCache = true;
+				m_loadRecordTime = m_loadStopwatch.GetElapsedMs();
+				return true;
+			}
+
+			LOG_WRITE("(warning) Reflection probe cache entry could not be used; baking the probe again: path=\"%s\"", filePath);
+		}
+
+		// Hold onto the cache so the baked results can be stored once the GPU is done with them.
+		m_cache = cache;
+	}
+
 	ID3D12DescriptorHeap* const pDescHeaps[] =
 	{
 		m_alloc->GetHeap().Get(),
@@ -203,6 +340,15 @@ bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 
 	cmdList->SetDescriptorHeaps(_countof(pDescHeaps), pDescHeaps);
 
+	// Time the bake on the GPU so CompleteLoad() can report what it costs at this quality. The probe is still baked
+	// when the timer can't be created, it just won't be timed.
+	m_loadTimed = m_timestampQueryHeap || _initGpuTimer(device);
+
+	if(m_loadTimed)
+	{
+		cmdList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX);
+	}
+
 	// Convert the equirectangular environment map to a cubemap.
 	{
 		EquiToCubeRootConstant constData;
@@ -210,7 +356,7 @@ bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 		D3D12_RESOURCE_BARRIER envMapBarrier[2];
 		envMapBarrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 		envMapBarrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		envMapBarrier[0].Transition.pResource = m_envResource.Get();
+		envMapBarrier[0].Transition.pResource = m_front.envResource.Get();
 		envMapBarrier[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 		envMapBarrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
 		envMapBarrier[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
@@ -247,6 +393,7 @@ bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 			constData.mipIndex = mipIndex;
 			constData.edgeLength = mipSize;
 			constData.invEdgeLength = 1.0f / float32_t(mipSize);
+			constData.rowOffset = 0;
 
 			cmdList->SetComputeRootDescriptorTable(1, envTexture->GetDescriptor().gpuHandle);
 
@@ -256,18 +403,7 @@ bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 				// Set the face-specific constant properties.
 				constData.faceIndex = faceIndex;
 
-				D3D12_UNORDERED_ACCESS_VIEW_DESC faceUavDesc;
-				faceUavDesc.Format = expectedFormat;
-				faceUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
-				faceUavDesc.Texture2DArray.MipSlice = mipIndex;
-				faceUavDesc.Texture2DArray.FirstArraySlice = faceIndex;
-				faceUavDesc.Texture2DArray.ArraySize = 1;
-				faceUavDesc.Texture2DArray.PlaneSlice = 0;
-
-				const Descriptor faceDescriptor = m_alloc->AllocateTemp();
-				assert(faceDescriptor.index != Descriptor::Invalid.index);
-
-				device->CreateUnorderedAccessView(m_envResource.Get(), nullptr, &faceUavDesc, faceDescriptor.cpuHandle);
+				const Descriptor& faceDescriptor = m_front.envFaceUavDescriptor[(faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex];
 
 				cmdList->SetComputeRoot32BitConstants(0, sizeof(EquiToCubeRootConstant) / sizeof(uint32_t), &constData, 0);
 				cmdList->SetComputeRootDescriptorTable(2, faceDescriptor.gpuHandle);
@@ -283,11 +419,335 @@ bool DemoFramework::D3D12::ReflectionProbe::LoadEnvironmentMap(
 
 	_generateIrradiance(cmdList);
 
+	if(m_loadTimed)
+	{
+		cmdList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX + 1);
+	}
+
+	_generateSpecular(cmdList);
+
+	if(m_loadTimed)
+	{
+		cmdList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX + 2);
+		cmdList->ResolveQueryData(
+			m_timestampQueryHeap.Get(),
+			D3D12_QUERY_TYPE_TIMESTAMP,
+			DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX,
+			DF_REFL_PROBE_LOAD_TIMESTAMP_COUNT,
+			m_timestampResource.Get(),
+			uint64_t(DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX) * sizeof(uint64_t));
+	}
+
+	if(m_cache && !_copyToReadback(device, cmdList))
+	{
+		// The probe is still baked, the results just won't be cached.
+		m_cache.reset();
+	}
+
+	m_loadRecordTime = m_loadStopwatch.GetElapsedMs();
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::CompleteLoad(const Device::Ptr& device, const CommandQueue::Ptr& cmdQueue)
+{
+	if(!m_loadPending)
+	{
+		return;
+	}
+
+	m_loadPending = false;
+
+	// This includes the time spent by the GPU, so it can be compared between cache hits and misses.
+	const float64_t readyTime = m_loadStopwatch.GetElapsedMs();
+
+	if(m_loadFromCache)
+	{
+		LOG_WRITE(
+			"Loaded reflection probe from cache: edgeLength=%" PRIu32 ", recordTime=%.2fms, readyTime=%.2fms",
+			m_envEdgeLength,
+			m_loadRecordTime,
+			readyTime);
+		return;
+	}
+
+	if(m_loadTimed && cmdQueue)
+	{
+		_reportLoadTimes(cmdQueue);
+	}
+
+	if(!m_readbackResource || !device)
+	{
+		LOG_WRITE(
+			"Baked reflection probe: edgeLength=%" PRIu32 ", recordTime=%.2fms, readyTime=%.2fms",
+			m_envEdgeLength,
+			m_loadRecordTime,
+			readyTime);
+
+		m_readbackResource.Reset();
+		m_cache.reset();
+		return;
+	}
+
+	Utility::Stopwatch stopwatch;
+
+	CacheLayout layout;
+	_getCacheLayout(device, layout);
+
+	const D3D12_RANGE readRange =
+	{
+		0,                        // SIZE_T Begin
+		SIZE_T(layout.totalSize), // SIZE_T End
+	};
+
+	constexpr D3D12_RANGE disableCpuWriteRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	uint8_t* pData = nullptr;
+
+	const HRESULT mapResult = m_readbackResource->Map(0, &readRange, reinterpret_cast<void**>(&pData));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map reflection probe readback buffer: result=0x%08" PRIX32, mapResult);
+	}
+	else
+	{
+		Utility::ShProjection::Coefficients coefficients;
+		memcpy(&coefficients, pData + layout.coeffOffset, sizeof(coefficients));
+
+		const bool stored = m_cache->Store(
+			m_cacheKey,
+			coefficients,
+			pData,
+			layout.envDataSize,
+			pData + layout.irrOffset,
+			layout.irrDataSize);
+
+		m_readbackResource->Unmap(0, &disableCpuWriteRange);
+
+		LOG_WRITE(
+			"Baked reflection probe: edgeLength=%" PRIu32 ", recordTime=%.2fms, readyTime=%.2fms, storeTime=%.2fms, stored=%s, entrySize=%" PRIu64,
+			m_envEdgeLength,
+			m_loadRecordTime,
+			readyTime,
+			stopwatch.GetElapsedMs(),
+			stored ? "true" : "false",
+			layout.envDataSize + layout.irrDataSize);
+	}
+
+	m_readbackResource.Reset();
+	m_cache.reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ReflectionProbe::BeginUpdate(
+	const Device::Ptr& device,
+	const CommandQueue::Ptr& cmdQueue,
+	const Texture2D::Ptr& envTexture,
+	const uint32_t framesInFlight)
+{
+	if(!device || !cmdQueue || !envTexture || framesInFlight == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+	else if(framesInFlight > DF_REFL_PROBE_MAX_FRAMES_IN_FLIGHT)
+	{
+		LOG_ERROR(
+			"Too many frames in flight for a reflection probe update: framesInFlight=%" PRIu32 ", max=%" PRIu32,
+			framesInFlight,
+			uint32_t(DF_REFL_PROBE_MAX_FRAMES_IN_FLIGHT));
+		return false;
+	}
+	else if(!ValidateEnvTexture(envTexture))
+	{
+		return false;
+	}
+
+	// The back cube maps aren't needed by probes that are only ever loaded all at once.
+	if(!m_back.envResource && !_initCubeMaps(device, m_back))
+	{
+		_freeCubeMaps(m_back);
+		return false;
+	}
+
+	if(!m_timestampQueryHeap && !_initGpuTimer(device))
+	{
+		return false;
+	}
+
+	const HRESULT freqResult = cmdQueue->GetTimestampFrequency(&m_timestampFrequency);
+	if(FAILED(freqResult))
+	{
+		LOG_ERROR("Failed to get command queue timestamp frequency: result=0x%08" PRIX32, freqResult);
+		return false;
+	}
+
+	if(framesInFlight != m_framesInFlight)
+	{
+		Utility::ProbeUpdateScheduler::Desc desc;
+		desc.envEdgeLength = m_envEdgeLength;
+		desc.envMipCount = m_envMipCount;
+		desc.irrEdgeLength = m_irrEdgeLength;
+		desc.rowAlignment = DF_REFL_THREAD_COUNT_Y;
+		desc.reduceSegmentSize = DF_SH_REDUCE_SEGMENT_SIZE;
+		desc.reduceGroupSize = DF_REFL_SH_LINEAR_THREAD_COUNT;
+		desc.swapDelay = framesInFlight;
+		desc.specSampleCount = DF_REFL_SPEC_SAMPLE_COUNT;
+
+		if(!m_updateScheduler.Reset(desc))
+		{
+			LOG_ERROR("Failed to set up reflection probe update scheduler");
+			return false;
+		}
+
+		// Timestamps recorded under the old frame numbering can't be matched to their frames anymore.
+		for(size_t i = 0; i < DF_REFL_PROBE_TIMESTAMP_SLOT_COUNT; ++i)
+		{
+			m_timestampFrame[i] = 0;
+		}
+
+		m_framesInFlight = framesInFlight;
+	}
+
+	m_updateTexture = envTexture;
+	m_updateScheduler.Begin();
+
 	return true;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 
+bool DemoFramework::D3D12::ReflectionProbe::Update(const GraphicsCommandList::Ptr& cmdList, const float64_t gpuBudgetMs)
+{
+	if(!cmdList)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	if(m_framesInFlight == 0)
+	{
+		// No update has ever been started.
+		return false;
+	}
+
+	_reportUpdateTimes();
+
+	// The scheduler counts frames even when there's nothing to do so it knows when the back cube maps are safe to write.
+	Utility::ProbeUpdateScheduler::Step steps[DF_REFL_PROBE_MAX_UPDATE_STEPS];
+	const size_t stepCount = m_updateScheduler.Update(gpuBudgetMs, steps, DF_REFL_PROBE_MAX_UPDATE_STEPS);
+	if(stepCount == 0)
+	{
+		return false;
+	}
+
+	const uint64_t frameIndex = m_updateScheduler.GetFrameIndex();
+	const uint32_t timestampIndex = uint32_t(frameIndex % DF_REFL_PROBE_TIMESTAMP_SLOT_COUNT) * 2;
+
+	ID3D12DescriptorHeap* const pDescHeaps[] =
+	{
+		m_alloc->GetHeap().Get(),
+	};
+
+	cmdList->SetDescriptorHeaps(_countof(pDescHeaps), pDescHeaps);
+	cmdList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampIndex);
+
+	bool swapped = false;
+
+	for(size_t stepIndex = 0; stepIndex < stepCount; ++stepIndex)
+	{
+		const Utility::ProbeUpdateScheduler::Step& step = steps[stepIndex];
+
+		if(step.pass == Utility::ProbeUpdateScheduler::Pass::Swap)
+		{
+			D3D12_RESOURCE_BARRIER barriers[3];
+			uint32_t barrierCount = 0;
+
+			D3D12_RESOURCE_BARRIER transition;
+			transition.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			transition.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+			transition.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+			transition.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+			transition.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+			if(m_backEnvWritable)
+			{
+				barriers[barrierCount] = transition;
+				barriers[barrierCount].Transition.pResource = m_back.envResource.Get();
+				++barrierCount;
+			}
+
+			if(m_backIrrWritable)
+			{
+				barriers[barrierCount] = transition;
+				barriers[barrierCount].Transition.pResource = m_back.irrResource.Get();
+				++barrierCount;
+			}
+
+			if(m_backSpecWritable)
+			{
+				barriers[barrierCount] = transition;
+				barriers[barrierCount].Transition.pResource = m_back.specResource.Get();
+				++barrierCount;
+			}
+
+			// Transition the finished cube maps to SRVs before they become visible.
+			if(barrierCount > 0)
+			{
+				cmdList->ResourceBarrier(barrierCount, barriers);
+			}
+
+			std::swap(m_front, m_back);
+
+			m_updateTexture.reset();
+			m_backEnvWritable = false;
+			m_backIrrWritable = false;
+			m_backSpecWritable = false;
+
+			swapped = true;
+			continue;
+		}
+
+		// Steps only need to wait on the SH buffers when they read results from a different pass than the step before
+		// them. The first step of a frame always waits since the last frame's steps could have been anything.
+		const bool waitForShBuffers = (stepIndex == 0)
+			|| (steps[stepIndex - 1].pass != step.pass)
+			|| (steps[stepIndex - 1].mipIndex != step.mipIndex);
+
+		_recordUpdateStep(cmdList, step, waitForShBuffers);
+	}
+
+	cmdList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampIndex + 1);
+	cmdList->ResolveQueryData(
+		m_timestampQueryHeap.Get(),
+		D3D12_QUERY_TYPE_TIMESTAMP,
+		timestampIndex,
+		2,
+		m_timestampResource.Get(),
+		uint64_t(timestampIndex) * sizeof(uint64_t));
+
+	m_timestampFrame[timestampIndex / 2] = frameIndex;
+
+	return swapped;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::CancelUpdate()
+{
+	m_updateScheduler.Cancel();
+	m_updateTexture.reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 bool DemoFramework::D3D12::ReflectionProbe::_initEquiToCubePipeline(const Device::Ptr& device)
 {
 	const char* const shaderFilePath = "shaders/framework/equi-to-cube.cs.sbin";
@@ -300,6 +760,9 @@ bool DemoFramework::D3D12::ReflectionProbe::_initEquiToCubePipeline(const Device
 		return false;
 	}
 
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
 	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
 		shader->GetBufferPointer(), // const void *pShaderBytecode
@@ -414,6 +877,9 @@ bool DemoFramework::D3D12::ReflectionProbe::_initShProjectPipeline(const Device:
 		return false;
 	}
 
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
 	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
 		shader->GetBufferPointer(), // const void *pShaderBytecode
@@ -548,6 +1014,9 @@ bool DemoFramework::D3D12::ReflectionProbe::_initShReducePipeline(const Device::
 		return false;
 	}
 
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
 	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
 		shader->GetBufferPointer(), // const void *pShaderBytecode
@@ -663,6 +1132,9 @@ bool DemoFramework::D3D12::ReflectionProbe::_initShNormalizePipeline(const Devic
 		return false;
 	}
 
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
 	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
 		shader->GetBufferPointer(), // const void *pShaderBytecode
@@ -775,6 +1247,9 @@ bool DemoFramework::D3D12::ReflectionProbe::_initShReconstructPipeline(const Dev
 		return false;
 	}
 
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
 	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
 		shader->GetBufferPointer(), // const void *pShaderBytecode
@@ -875,18 +1350,135 @@ bool DemoFramework::D3D12::ReflectionProbe::_initShReconstructPipeline(const Dev
 
 //---------------------------------------------------------------------------------------------------------------------
 
-bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& device)
+bool DemoFramework::D3D12::ReflectionProbe::_initSpecPrefilterPipeline(const Device::Ptr& device)
 {
-	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	const char* const shaderFilePath = "shaders/framework/spec-prefilter.cs.sbin";
+
+	// Load the shader from the specified file path.
+	Blob::Ptr shader = LoadShaderFromFile(shaderFilePath);
+	if(!shader)
 	{
-		1, // UINT Count
-		0, // UINT Quality
-	};
+		LOG_ERROR("Failed to load shader: %s", shaderFilePath);
+		return false;
+	}
 
-	constexpr D3D12_HEAP_PROPERTIES defaultHeapProps =
+	// Fold the bytecode into the hash that versions probe cache entries.
+	m_shaderHash = Utility::Hash::Combine(m_shaderHash, Utility::Hash::Compute(shader->GetBufferPointer(), shader->GetBufferSize()));
+
+	const D3D12_SHADER_BYTECODE shaderBytecode =
 	{
-		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
-		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		shader->GetBufferPointer(), // const void *pShaderBytecode
+		shader->GetBufferSize(),    // SIZE_T BytecodeLength
+	};
+
+	constexpr D3D12_DESCRIPTOR_RANGE srvDescRange =
+	{
+		D3D12_DESCRIPTOR_RANGE_TYPE_SRV, // D3D12_DESCRIPTOR_RANGE_TYPE RangeType
+		1,                               // UINT NumDescriptors
+		0,                               // UINT BaseShaderRegister
+		0,                               // UINT RegisterSpace
+		0,                               // UINT OffsetInDescriptorsFromTableStart
+	};
+
+	constexpr D3D12_DESCRIPTOR_RANGE uavDescRange =
+	{
+		D3D12_DESCRIPTOR_RANGE_TYPE_UAV, // D3D12_DESCRIPTOR_RANGE_TYPE RangeType
+		1,                               // UINT NumDescriptors
+		0,                               // UINT BaseShaderRegister
+		0,                               // UINT RegisterSpace
+		0,                               // UINT OffsetInDescriptorsFromTableStart
+	};
+
+	// Root constants
+	D3D12_ROOT_PARAMETER rootConstParam;
+	rootConstParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	rootConstParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	rootConstParam.Constants.ShaderRegister = 0;
+	rootConstParam.Constants.RegisterSpace = 0;
+	rootConstParam.Constants.Num32BitValues = sizeof(SpecPrefilterRootConstant) / sizeof(uint32_t);
+
+	// SRV table
+	D3D12_ROOT_PARAMETER srvTableParam;
+	srvTableParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	srvTableParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	srvTableParam.DescriptorTable.NumDescriptorRanges = 1;
+	srvTableParam.DescriptorTable.pDescriptorRanges = &srvDescRange;
+
+	// UAV table
+	D3D12_ROOT_PARAMETER uavTableParam;
+	uavTableParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	uavTableParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	uavTableParam.DescriptorTable.NumDescriptorRanges = 1;
+	uavTableParam.DescriptorTable.pDescriptorRanges = &uavDescRange;
+
+	const D3D12_ROOT_PARAMETER rootParams[] =
+	{
+		rootConstParam,
+		srvTableParam,
+		uavTableParam,
+	};
+
+	const D3D12_STATIC_SAMPLER_DESC staticSamplerDesc = _getStaticSamplerDesc();
+
+	constexpr D3D12_ROOT_SIGNATURE_FLAGS rootSigFlags = D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS
+		| D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
+
+	const D3D12_ROOT_SIGNATURE_DESC rootSigDesc =
+	{
+		_countof(rootParams), // UINT NumParameters
+		rootParams,           // const D3D12_ROOT_PARAMETER *pParameters
+		1,                    // UINT NumStaticSamplers
+		&staticSamplerDesc,   // const D3D12_STATIC_SAMPLER_DESC *pStaticSamplers
+		rootSigFlags,         // D3D12_ROOT_SIGNATURE_FLAGS Flags
+	};
+
+	// Create the shader root signature.
+	m_specPrefilterRootSig = CreateRootSignature(device, rootSigDesc);
+	if(!m_specPrefilterRootSig)
+	{
+		LOG_ERROR("Failed to create root signature for spec-prefilter shader");
+		return false;
+	}
+
+	const D3D12_COMPUTE_PIPELINE_STATE_DESC pipelineDesc =
+	{
+		m_specPrefilterRootSig.Get(),   // ID3D12RootSignature *pRootSignature
+		shaderBytecode,                 // D3D12_SHADER_BYTECODE CS
+		0,                              // UINT NodeMask
+		{},                             // D3D12_CACHED_PIPELINE_STATE CachedPSO
+		D3D12_PIPELINE_STATE_FLAG_NONE, // D3D12_PIPELINE_STATE_FLAGS Flags
+	};
+
+	// Create the shader pipeline.
+	m_specPrefilterPipeline = CreatePipelineState(device, pipelineDesc);
+	if(!m_specPrefilterPipeline)
+	{
+		LOG_ERROR("Failed to create pipeline for spec-prefilter shader");
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& device, CubeMaps& cubeMaps)
+{
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	constexpr D3D12_HEAP_PROPERTIES defaultHeapProps =
+	{
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
 		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
 		0,                               // UINT CreationNodeMask
 		0,                               // UINT VisibleNodeMask
@@ -920,26 +1512,54 @@ bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& dev
 		D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, // D3D12_RESOURCE_FLAGS Flags
 	};
 
+	// The specular map is only ever sampled, so it's stored at half precision to keep its full mip chain from
+	// doubling the memory used by the environment map.
+	const D3D12_RESOURCE_DESC specResDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_TEXTURE2D,         // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                          // UINT64 Alignment
+		uint64_t(m_envEdgeLength),                  // UINT64 Width
+		m_envEdgeLength,                            // UINT Height
+		DF_CUBE_FACE__COUNT,                        // UINT16 DepthOrArraySize
+		uint16_t(m_envMipCount),                    // UINT16 MipLevels
+		DXGI_FORMAT_R16G16B16A16_FLOAT,             // DXGI_FORMAT Format
+		defaultSampleDesc,                          // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_UNKNOWN,               // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, // D3D12_RESOURCE_FLAGS Flags
+	};
+
 	// Create the resource for the environment cube map.
-	m_envResource = CreateCommittedResource(
+	cubeMaps.envResource = CreateCommittedResource(
 		device,
 		envResDesc,
 		defaultHeapProps,
 		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
 		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-	if(!m_envResource)
+	if(!cubeMaps.envResource)
 	{
 		return false;
 	}
 
 	// Create the resource for the irradiance cube map.
-	m_irrResource = CreateCommittedResource(
+	cubeMaps.irrResource = CreateCommittedResource(
 		device,
 		irrResDesc,
 		defaultHeapProps,
 		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
 		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-	if(!m_irrResource)
+	if(!cubeMaps.irrResource)
+	{
+		return false;
+	}
+
+	// Create the resource for the specular cube map.
+	cubeMaps.specResource = CreateCommittedResource(
+		device,
+		specResDesc,
+		defaultHeapProps,
+		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	if(!cubeMaps.specResource)
 	{
 		return false;
 	}
@@ -954,10 +1574,10 @@ bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& dev
 		srvDesc.TextureCube.MipLevels = m_envMipCount;
 		srvDesc.TextureCube.ResourceMinLODClamp = 0.0f;
 
-		m_envSrvDescriptor = m_alloc->Allocate();
-		assert(m_envSrvDescriptor.index != Descriptor::Invalid.index);
+		cubeMaps.envSrvDescriptor = m_alloc->Allocate();
+		assert(cubeMaps.envSrvDescriptor.index != Descriptor::Invalid.index);
 
-		device->CreateShaderResourceView(m_envResource.Get(), &srvDesc, m_envSrvDescriptor.cpuHandle);
+		device->CreateShaderResourceView(cubeMaps.envResource.Get(), &srvDesc, cubeMaps.envSrvDescriptor.cpuHandle);
 
 		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
 		{
@@ -971,12 +1591,12 @@ bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& dev
 				faceUavDesc.Texture2DArray.ArraySize = 1;
 				faceUavDesc.Texture2DArray.PlaneSlice = 0;
 
-				const uint32_t uavDescIndex = (faceIndex * DF_CUBE_FACE__COUNT) + mipIndex;
+				const uint32_t uavDescIndex = (faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex;
 
-				m_envFaceUavDescriptor[uavDescIndex] = m_alloc->Allocate();
-				assert(m_envFaceUavDescriptor[uavDescIndex].index != Descriptor::Invalid.index);
+				cubeMaps.envFaceUavDescriptor[uavDescIndex] = m_alloc->Allocate();
+				assert(cubeMaps.envFaceUavDescriptor[uavDescIndex].index != Descriptor::Invalid.index);
 
-				device->CreateUnorderedAccessView(m_envResource.Get(), nullptr, &faceUavDesc, m_envFaceUavDescriptor[uavDescIndex].cpuHandle);
+				device->CreateUnorderedAccessView(cubeMaps.envResource.Get(), nullptr, &faceUavDesc, cubeMaps.envFaceUavDescriptor[uavDescIndex].cpuHandle);
 			}
 		}
 	}
@@ -991,10 +1611,10 @@ bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& dev
 		srvDesc.TextureCube.MipLevels = 1;
 		srvDesc.TextureCube.ResourceMinLODClamp = 0.0f;
 
-		m_irrSrvDescriptor = m_alloc->Allocate();
-		assert(m_irrSrvDescriptor.index != Descriptor::Invalid.index);
+		cubeMaps.irrSrvDescriptor = m_alloc->Allocate();
+		assert(cubeMaps.irrSrvDescriptor.index != Descriptor::Invalid.index);
 
-		device->CreateShaderResourceView(m_irrResource.Get(), &srvDesc, m_irrSrvDescriptor.cpuHandle);
+		device->CreateShaderResourceView(cubeMaps.irrResource.Get(), &srvDesc, cubeMaps.irrSrvDescriptor.cpuHandle);
 
 		// Create a UAV per cube map face.
 		D3D12_UNORDERED_ACCESS_VIEW_DESC faceUavDesc[DF_CUBE_FACE__COUNT];
@@ -1007,10 +1627,47 @@ bool DemoFramework::D3D12::ReflectionProbe::_initCubeMaps(const Device::Ptr& dev
 			faceUavDesc[i].Texture2DArray.ArraySize = 1;
 			faceUavDesc[i].Texture2DArray.PlaneSlice = 0;
 
-			m_irrFaceUavDescriptor[i] = m_alloc->Allocate();
-			assert(m_irrFaceUavDescriptor[i].index != Descriptor::Invalid.index);
+			cubeMaps.irrFaceUavDescriptor[i] = m_alloc->Allocate();
+			assert(cubeMaps.irrFaceUavDescriptor[i].index != Descriptor::Invalid.index);
+
+			device->CreateUnorderedAccessView(cubeMaps.irrResource.Get(), nullptr, &faceUavDesc[i], cubeMaps.irrFaceUavDescriptor[i].cpuHandle);
+		}
+	}
+
+	// Create the SRV and UAVs for the specular map.
+	{
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
+		srvDesc.Format = specResDesc.Format;
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.TextureCube.MostDetailedMip = 0;
+		srvDesc.TextureCube.MipLevels = m_envMipCount;
+		srvDesc.TextureCube.ResourceMinLODClamp = 0.0f;
+
+		cubeMaps.specSrvDescriptor = m_alloc->Allocate();
+		assert(cubeMaps.specSrvDescriptor.index != Descriptor::Invalid.index);
+
+		device->CreateShaderResourceView(cubeMaps.specResource.Get(), &srvDesc, cubeMaps.specSrvDescriptor.cpuHandle);
+
+		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
+		{
+			for(uint32_t mipIndex = 0; mipIndex < m_envMipCount; ++mipIndex)
+			{
+				D3D12_UNORDERED_ACCESS_VIEW_DESC faceUavDesc;
+				faceUavDesc.Format = specResDesc.Format;
+				faceUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
+				faceUavDesc.Texture2DArray.MipSlice = mipIndex;
+				faceUavDesc.Texture2DArray.FirstArraySlice = faceIndex;
+				faceUavDesc.Texture2DArray.ArraySize = 1;
+				faceUavDesc.Texture2DArray.PlaneSlice = 0;
+
+				const uint32_t uavDescIndex = (faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex;
 
-			device->CreateUnorderedAccessView(m_irrResource.Get(), nullptr, &faceUavDesc[i], m_irrFaceUavDescriptor[i].cpuHandle);
+				cubeMaps.specFaceUavDescriptor[uavDescIndex] = m_alloc->Allocate();
+				assert(cubeMaps.specFaceUavDescriptor[uavDescIndex].index != Descriptor::Invalid.index);
+
+				device->CreateUnorderedAccessView(cubeMaps.specResource.Get(), nullptr, &faceUavDesc, cubeMaps.specFaceUavDescriptor[uavDescIndex].cpuHandle);
+			}
 		}
 	}
 
@@ -1175,6 +1832,71 @@ bool DemoFramework::D3D12::ReflectionProbe::_initUavResources(const Device::Ptr&
 
 //---------------------------------------------------------------------------------------------------------------------
 
+bool DemoFramework::D3D12::ReflectionProbe::_initGpuTimer(const Device::Ptr& device)
+{
+	constexpr D3D12_HEAP_PROPERTIES readbackHeapProps =
+	{
+		D3D12_HEAP_TYPE_READBACK,        // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	constexpr D3D12_QUERY_HEAP_DESC queryHeapDesc =
+	{
+		D3D12_QUERY_HEAP_TYPE_TIMESTAMP, // D3D12_QUERY_HEAP_TYPE Type
+		DF_REFL_PROBE_TIMESTAMP_COUNT,   // UINT Count
+		0,                               // UINT NodeMask
+	};
+
+	const D3D12_RESOURCE_DESC timestampResDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER,                                // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                                              // UINT64 Alignment
+		uint64_t(DF_REFL_PROBE_TIMESTAMP_COUNT * sizeof(uint64_t)),     // UINT64 Width
+		1,                                                              // UINT Height
+		1,                                                              // UINT16 DepthOrArraySize
+		1,                                                              // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,                                            // DXGI_FORMAT Format
+		defaultSampleDesc,                                              // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,                                 // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,                                       // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	// Create the query heap the update and bake timestamps are written to.
+	m_timestampQueryHeap = CreateQueryHeap(device, queryHeapDesc);
+	if(!m_timestampQueryHeap)
+	{
+		LOG_ERROR("Failed to create reflection probe timestamp query heap");
+		return false;
+	}
+
+	// Create the buffer the timestamps are resolved to.
+	m_timestampResource = CreateCommittedResource(
+		device,
+		timestampResDesc,
+		readbackHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!m_timestampResource)
+	{
+		LOG_ERROR("Failed to create reflection probe timestamp readback buffer");
+		m_timestampQueryHeap.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCommandList::Ptr& cmdList)
 {
 	D3D12_RESOURCE_BARRIER uavBarrier[2];
@@ -1193,6 +1915,7 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 		ShProjectRootConstant constData;
 		constData.edgeLength = m_envEdgeLength;
 		constData.invEdgeLength = 1.0f / float32_t(m_envEdgeLength);
+		constData.rowOffset = 0;
 
 		// Bind the shader pipeline.
 		cmdList->SetComputeRootSignature(m_shProjectRootSig.Get());
@@ -1200,7 +1923,7 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 
 		// Set the shader inputs.
 		cmdList->SetComputeRoot32BitConstants(0, sizeof(ShProjectRootConstant) / sizeof(uint32_t), &constData, 0);
-		cmdList->SetComputeRootDescriptorTable(1, m_envSrvDescriptor.gpuHandle);
+		cmdList->SetComputeRootDescriptorTable(1, m_front.envSrvDescriptor.gpuHandle);
 		cmdList->SetComputeRootDescriptorTable(2, m_coeffUavDescriptor.gpuHandle);
 		cmdList->SetComputeRootDescriptorTable(3, m_weightUavDescriptor.gpuHandle);
 
@@ -1218,6 +1941,7 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 		ShReduceRootConstant constData;
 		constData.headIndex = 0;
 		constData.tailIndex = mipLength;
+		constData.outputOffset = 0;
 
 		// Bind the shader pipeline.
 		cmdList->SetComputeRootSignature(m_shReduceRootSig.Get());
@@ -1279,7 +2003,7 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 		D3D12_RESOURCE_BARRIER irrMapBarrier[2];
 		irrMapBarrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 		irrMapBarrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		irrMapBarrier[0].Transition.pResource = m_irrResource.Get();
+		irrMapBarrier[0].Transition.pResource = m_front.irrResource.Get();
 		irrMapBarrier[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 		irrMapBarrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
 		irrMapBarrier[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
@@ -1288,8 +2012,9 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 		irrMapBarrier[1].Transition.StateBefore = irrMapBarrier[0].Transition.StateAfter;
 		irrMapBarrier[1].Transition.StateAfter = irrMapBarrier[0].Transition.StateBefore;
 
-		const uint32_t groupCountX = m_irrEdgeLength / DF_REFL_THREAD_COUNT_X;
-		const uint32_t groupCountY = m_irrEdgeLength / DF_REFL_THREAD_COUNT_Y;
+		// The low quality irradiance map is smaller than a single thread group.
+		const uint32_t groupCountX = (m_irrEdgeLength > DF_REFL_THREAD_COUNT_X) ? (m_irrEdgeLength / DF_REFL_THREAD_COUNT_X) : 1;
+		const uint32_t groupCountY = (m_irrEdgeLength > DF_REFL_THREAD_COUNT_Y) ? (m_irrEdgeLength / DF_REFL_THREAD_COUNT_Y) : 1;
 
 		// Set the constant properties that will not change between faces.
 		constData.coeffIndex = m_uavArrayLength - 1; // The final coefficients will always be in the last element of the array.
@@ -1314,7 +2039,7 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 
 			// Set the per-face shader inputs.
 			cmdList->SetComputeRoot32BitConstants(0, sizeof(ShReconstructRootConstant) / sizeof(uint32_t), &constData, 0);
-			cmdList->SetComputeRootDescriptorTable(2, m_irrFaceUavDescriptor[faceIndex].gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_front.irrFaceUavDescriptor[faceIndex].gpuHandle);
 
 			// Dispatch the SH reconstruction job for the current face texture.
 			cmdList->Dispatch(groupCountX, groupCountY, 1);
@@ -1326,3 +2051,708 @@ void DemoFramework::D3D12::ReflectionProbe::_generateIrradiance(const GraphicsCo
 }
 
 //---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_generateSpecular(const GraphicsCommandList::Ptr& cmdList)
+{
+	D3D12_RESOURCE_BARRIER specMapBarrier[2];
+	specMapBarrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	specMapBarrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	specMapBarrier[0].Transition.pResource = m_front.specResource.Get();
+	specMapBarrier[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	specMapBarrier[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	specMapBarrier[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+	specMapBarrier[1] = specMapBarrier[0];
+	specMapBarrier[1].Transition.StateBefore = specMapBarrier[0].Transition.StateAfter;
+	specMapBarrier[1].Transition.StateAfter = specMapBarrier[0].Transition.StateBefore;
+
+	// Transition the specular map to a UAV so we can update the face texels.
+	cmdList->ResourceBarrier(1, &specMapBarrier[0]);
+
+	// Bind the shader pipeline.
+	cmdList->SetComputeRootSignature(m_specPrefilterRootSig.Get());
+	cmdList->SetPipelineState(m_specPrefilterPipeline.Get());
+
+	// Every mip of the specular map is filtered from the full environment map mip chain.
+	cmdList->SetComputeRootDescriptorTable(1, m_front.envSrvDescriptor.gpuHandle);
+
+	// Filter each mip level of the specular map for its own roughness.
+	for(uint32_t mipIndex = 0; mipIndex < m_envMipCount; ++mipIndex)
+	{
+		const uint32_t mipSize = m_envEdgeLength >> mipIndex;
+		const uint32_t groupCountX = (mipSize > DF_REFL_THREAD_COUNT_X) ? (mipSize / DF_REFL_THREAD_COUNT_X) : 1;
+		const uint32_t groupCountY = (mipSize > DF_REFL_THREAD_COUNT_Y) ? (mipSize / DF_REFL_THREAD_COUNT_Y) : 1;
+
+		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
+		{
+			const SpecPrefilterRootConstant constData = GetSpecPrefilterRootConstant(m_envEdgeLength, m_envMipCount, mipIndex, faceIndex, 0);
+			const Descriptor& faceDescriptor = m_front.specFaceUavDescriptor[(faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex];
+
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(SpecPrefilterRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(2, faceDescriptor.gpuHandle);
+			cmdList->Dispatch(groupCountX, groupCountY, 1);
+		}
+	}
+
+	// Transition the specular map back to an SRV so it can be used as a shader cube map input again.
+	cmdList->ResourceBarrier(1, &specMapBarrier[1]);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_recordUpdateStep(
+	const GraphicsCommandList::Ptr& cmdList,
+	const Utility::ProbeUpdateScheduler::Step& step,
+	const bool waitForShBuffers)
+{
+	typedef Utility::ProbeUpdateScheduler::Pass Pass;
+
+	D3D12_RESOURCE_BARRIER uavBarrier[2];
+	uavBarrier[0].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+	uavBarrier[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	uavBarrier[0].UAV.pResource = m_shCoeffResource.Get();
+
+	uavBarrier[1] = uavBarrier[0];
+	uavBarrier[1].UAV.pResource = m_shWeightResource.Get();
+
+	D3D12_RESOURCE_BARRIER transition;
+	transition.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	transition.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	transition.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+	// Texture passes cover a band of rows, so only the row dimension is dispatched partially.
+	auto getGroupCount = [](const uint32_t threadCount, const uint32_t groupSize) -> uint32_t
+	{
+		return (threadCount + groupSize - 1) / groupSize;
+	};
+
+	switch(step.pass)
+	{
+		case Pass::EquiToCube:
+		{
+			if(!m_backEnvWritable)
+			{
+				// Transition the back environment map to a UAV for the first step writing to it.
+				transition.Transition.pResource = m_back.envResource.Get();
+				transition.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+				transition.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+				cmdList->ResourceBarrier(1, &transition);
+				m_backEnvWritable = true;
+			}
+
+			const uint32_t mipSize = (m_envEdgeLength >> step.mipIndex) > 0 ? (m_envEdgeLength >> step.mipIndex) : 1;
+
+			EquiToCubeRootConstant constData;
+			constData.mipIndex = step.mipIndex;
+			constData.faceIndex = step.faceIndex;
+			constData.edgeLength = mipSize;
+			constData.invEdgeLength = 1.0f / float32_t(mipSize);
+			constData.rowOffset = step.firstRow;
+
+			cmdList->SetComputeRootSignature(m_equiToCubeRootSig.Get());
+			cmdList->SetPipelineState(m_equiToCubePipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(EquiToCubeRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_updateTexture->GetDescriptor().gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_back.envFaceUavDescriptor[(step.faceIndex * D3D12_REQ_MIP_LEVELS) + step.mipIndex].gpuHandle);
+			cmdList->Dispatch(getGroupCount(mipSize, DF_REFL_THREAD_COUNT_X), getGroupCount(step.rowCount, DF_REFL_THREAD_COUNT_Y), 1);
+			break;
+		}
+
+		case Pass::ShProject:
+		{
+			if(m_backEnvWritable)
+			{
+				// Every mip level of the back environment map has been written, so it can be read from now on.
+				transition.Transition.pResource = m_back.envResource.Get();
+				transition.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+				transition.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+				cmdList->ResourceBarrier(1, &transition);
+				m_backEnvWritable = false;
+			}
+
+			ShProjectRootConstant constData;
+			constData.edgeLength = m_envEdgeLength;
+			constData.invEdgeLength = 1.0f / float32_t(m_envEdgeLength);
+			constData.rowOffset = step.firstRow;
+
+			cmdList->SetComputeRootSignature(m_shProjectRootSig.Get());
+			cmdList->SetPipelineState(m_shProjectPipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(ShProjectRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_back.envSrvDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_coeffUavDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(3, m_weightUavDescriptor.gpuHandle);
+			cmdList->Dispatch(getGroupCount(m_envEdgeLength, DF_REFL_THREAD_COUNT_X), getGroupCount(step.rowCount, DF_REFL_THREAD_COUNT_Y), 1);
+			break;
+		}
+
+		case Pass::ShReduce:
+		{
+			if(waitForShBuffers)
+			{
+				cmdList->ResourceBarrier(2, uavBarrier);
+			}
+
+			// Find the range of the SH buffers read by this reduction pass the same way _generateIrradiance() walks them.
+			uint32_t mipLength = m_uavArrayBaseLength;
+
+			ShReduceRootConstant constData;
+			constData.headIndex = 0;
+			constData.tailIndex = mipLength;
+			constData.outputOffset = step.firstRow;
+
+			for(uint32_t passIndex = 0; passIndex < step.mipIndex; ++passIndex)
+			{
+				mipLength /= DF_SH_REDUCE_SEGMENT_SIZE;
+
+				constData.headIndex = constData.tailIndex;
+				constData.tailIndex = constData.headIndex + mipLength;
+			}
+
+			cmdList->SetComputeRootSignature(m_shReduceRootSig.Get());
+			cmdList->SetPipelineState(m_shReducePipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(ShReduceRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_coeffUavDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_weightUavDescriptor.gpuHandle);
+			cmdList->Dispatch(getGroupCount(step.rowCount, DF_REFL_SH_LINEAR_THREAD_COUNT), 1, 1);
+			break;
+		}
+
+		case Pass::ShNormalize:
+		{
+			if(waitForShBuffers)
+			{
+				cmdList->ResourceBarrier(2, uavBarrier);
+			}
+
+			ShNormalizeRootConstant constData;
+			constData.index = m_uavArrayLength - 1;
+
+			cmdList->SetComputeRootSignature(m_shNormalizeRootSig.Get());
+			cmdList->SetPipelineState(m_shNormalizePipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(ShNormalizeRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_weightSrvDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_coeffUavDescriptor.gpuHandle);
+			cmdList->Dispatch(1, 1, 1);
+			break;
+		}
+
+		case Pass::ShReconstruct:
+		{
+			if(waitForShBuffers)
+			{
+				cmdList->ResourceBarrier(1, &uavBarrier[0]);
+			}
+
+			if(!m_backIrrWritable)
+			{
+				transition.Transition.pResource = m_back.irrResource.Get();
+				transition.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+				transition.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+				cmdList->ResourceBarrier(1, &transition);
+				m_backIrrWritable = true;
+			}
+
+			ShReconstructRootConstant constData;
+			constData.faceIndex = step.faceIndex;
+			constData.coeffIndex = m_uavArrayLength - 1;
+			constData.edgeLength = m_irrEdgeLength;
+			constData.invEdgeLength = 1.0f / float32_t(m_irrEdgeLength);
+
+			cmdList->SetComputeRootSignature(m_shReconstructRootSig.Get());
+			cmdList->SetPipelineState(m_shReconstructPipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(ShReconstructRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_coeffSrvDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_back.irrFaceUavDescriptor[step.faceIndex].gpuHandle);
+			cmdList->Dispatch(getGroupCount(m_irrEdgeLength, DF_REFL_THREAD_COUNT_X), getGroupCount(m_irrEdgeLength, DF_REFL_THREAD_COUNT_Y), 1);
+			break;
+		}
+
+		case Pass::SpecPrefilter:
+		{
+			if(!m_backSpecWritable)
+			{
+				// The back environment map was made readable by the SH projection, so only the specular map moves.
+				transition.Transition.pResource = m_back.specResource.Get();
+				transition.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+				transition.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+				cmdList->ResourceBarrier(1, &transition);
+				m_backSpecWritable = true;
+			}
+
+			const SpecPrefilterRootConstant constData = GetSpecPrefilterRootConstant(
+				m_envEdgeLength,
+				m_envMipCount,
+				step.mipIndex,
+				step.faceIndex,
+				step.firstRow);
+
+			cmdList->SetComputeRootSignature(m_specPrefilterRootSig.Get());
+			cmdList->SetPipelineState(m_specPrefilterPipeline.Get());
+			cmdList->SetComputeRoot32BitConstants(0, sizeof(SpecPrefilterRootConstant) / sizeof(uint32_t), &constData, 0);
+			cmdList->SetComputeRootDescriptorTable(1, m_back.envSrvDescriptor.gpuHandle);
+			cmdList->SetComputeRootDescriptorTable(2, m_back.specFaceUavDescriptor[(step.faceIndex * D3D12_REQ_MIP_LEVELS) + step.mipIndex].gpuHandle);
+			cmdList->Dispatch(getGroupCount(constData.edgeLength, DF_REFL_THREAD_COUNT_X), getGroupCount(step.rowCount, DF_REFL_THREAD_COUNT_Y), 1);
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_reportUpdateTimes()
+{
+	constexpr D3D12_RANGE disableCpuWriteRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	// Update() is called once per frame, so every frame up to this many frames before the one about to be recorded
+	// has finished on the GPU.
+	const uint64_t nextFrameIndex = m_updateScheduler.GetFrameIndex() + 1;
+
+	for(uint32_t slotIndex = 0; slotIndex < DF_REFL_PROBE_TIMESTAMP_SLOT_COUNT; ++slotIndex)
+	{
+		const uint64_t frameIndex = m_timestampFrame[slotIndex];
+
+		if(frameIndex == 0 || frameIndex + m_framesInFlight > nextFrameIndex)
+		{
+			continue;
+		}
+
+		m_timestampFrame[slotIndex] = 0;
+
+		const D3D12_RANGE readRange =
+		{
+			SIZE_T(slotIndex) * 2 * sizeof(uint64_t),     // SIZE_T Begin
+			SIZE_T(slotIndex + 1) * 2 * sizeof(uint64_t), // SIZE_T End
+		};
+
+		uint64_t* pTimestamps = nullptr;
+
+		const HRESULT mapResult = m_timestampResource->Map(0, &readRange, reinterpret_cast<void**>(&pTimestamps));
+		if(FAILED(mapResult))
+		{
+			LOG_ERROR("Failed to map reflection probe timestamp readback buffer: result=0x%08" PRIX32, mapResult);
+			continue;
+		}
+
+		const uint64_t beginTime = pTimestamps[slotIndex * 2];
+		const uint64_t endTime = pTimestamps[(slotIndex * 2) + 1];
+
+		m_timestampResource->Unmap(0, &disableCpuWriteRange);
+
+		if(endTime > beginTime && m_timestampFrequency > 0)
+		{
+			m_updateScheduler.ReportGpuTime(frameIndex, float64_t(endTime - beginTime) * 1000.0 / float64_t(m_timestampFrequency));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_reportLoadTimes(const CommandQueue::Ptr& cmdQueue)
+{
+	constexpr D3D12_RANGE readRange =
+	{
+		SIZE_T(DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX) * sizeof(uint64_t), // SIZE_T Begin
+		SIZE_T(DF_REFL_PROBE_TIMESTAMP_COUNT) * sizeof(uint64_t),      // SIZE_T End
+	};
+
+	constexpr D3D12_RANGE disableCpuWriteRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	m_loadTimed = false;
+
+	const HRESULT freqResult = cmdQueue->GetTimestampFrequency(&m_timestampFrequency);
+	if(FAILED(freqResult))
+	{
+		LOG_ERROR("Failed to get command queue timestamp frequency: result=0x%08" PRIX32, freqResult);
+		return;
+	}
+
+	uint64_t* pTimestamps = nullptr;
+
+	const HRESULT mapResult = m_timestampResource->Map(0, &readRange, reinterpret_cast<void**>(&pTimestamps));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map reflection probe timestamp readback buffer: result=0x%08" PRIX32, mapResult);
+		return;
+	}
+
+	const uint64_t beginTime = pTimestamps[DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX];
+	const uint64_t specBeginTime = pTimestamps[DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX + 1];
+	const uint64_t endTime = pTimestamps[DF_REFL_PROBE_LOAD_TIMESTAMP_INDEX + 2];
+
+	m_timestampResource->Unmap(0, &disableCpuWriteRange);
+
+	if(m_timestampFrequency == 0 || specBeginTime < beginTime || endTime < specBeginTime)
+	{
+		return;
+	}
+
+	const float64_t ticksToMs = 1000.0 / float64_t(m_timestampFrequency);
+
+	LOG_WRITE(
+		"Reflection probe bake GPU time: quality=%s, edgeLength=%" PRIu32 ", gpuTime=%.2fms, specularTime=%.2fms, specularSamples=%" PRIu32,
+		GetEnvMapQualityName(m_quality),
+		m_envEdgeLength,
+		float64_t(endTime - beginTime) * ticksToMs,
+		float64_t(endTime - specBeginTime) * ticksToMs,
+		uint32_t(DF_REFL_SPEC_SAMPLE_COUNT));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_freeCubeMaps(CubeMaps& cubeMaps)
+{
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < m_envMipCount; ++mipIndex)
+		{
+			m_alloc->Free(cubeMaps.envFaceUavDescriptor[(faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex]);
+			m_alloc->Free(cubeMaps.specFaceUavDescriptor[(faceIndex * D3D12_REQ_MIP_LEVELS) + mipIndex]);
+		}
+
+		m_alloc->Free(cubeMaps.irrFaceUavDescriptor[faceIndex]);
+	}
+
+	m_alloc->Free(cubeMaps.envSrvDescriptor);
+	m_alloc->Free(cubeMaps.irrSrvDescriptor);
+	m_alloc->Free(cubeMaps.specSrvDescriptor);
+
+	cubeMaps.envResource.Reset();
+	cubeMaps.irrResource.Reset();
+	cubeMaps.specResource.Reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ReflectionProbe::_uploadCacheEntry(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const ProbeCache::Entry& entry)
+{
+	CacheLayout layout;
+	_getCacheLayout(device, layout);
+
+	// Entries are only valid for resources with the same layout as the ones they were read back from.
+	if(entry.envDataSize != layout.envDataSize || entry.irrDataSize != layout.irrDataSize)
+	{
+		return false;
+	}
+
+	UploadRing::Allocation staging;
+
+	// The environment and specular mip chains rarely fit in the upload ring, so most entries end up in a dedicated upload buffer.
+	if(!uploadRing->Allocate(layout.totalSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT), staging)
+		&& !uploadRing->AllocateDedicated(device, layout.totalSize, staging))
+	{
+		return false;
+	}
+
+	memcpy(staging.pData, entry.pEnvData, size_t(entry.envDataSize));
+	memcpy(staging.pData + layout.irrOffset, entry.pIrrData, size_t(entry.irrDataSize));
+	memcpy(staging.pData + layout.coeffOffset, &entry.coefficients, sizeof(entry.coefficients));
+
+	D3D12_RESOURCE_BARRIER barriers[8];
+	barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barriers[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barriers[0].Transition.pResource = m_front.envResource.Get();
+	barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+
+	barriers[1] = barriers[0];
+	barriers[1].Transition.pResource = m_front.irrResource.Get();
+
+	barriers[2] = barriers[0];
+	barriers[2].Transition.pResource = m_front.specResource.Get();
+
+	barriers[3] = barriers[0];
+	barriers[3].Transition.pResource = m_shCoeffResource.Get();
+	barriers[3].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		barriers[i + 4] = barriers[i];
+		barriers[i + 4].Transition.StateBefore = barriers[i].Transition.StateAfter;
+		barriers[i + 4].Transition.StateAfter = barriers[i].Transition.StateBefore;
+	}
+
+	// Transition the probe resources so they can be copied to.
+	cmdList->ResourceBarrier(4, &barriers[0]);
+
+	D3D12_TEXTURE_COPY_LOCATION srcLoc;
+	srcLoc.pResource = staging.pResource;
+	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+	D3D12_TEXTURE_COPY_LOCATION destLoc;
+	destLoc.pResource = m_front.envResource.Get();
+	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+	// Copy every mip level of every face of the environment map.
+	for(uint32_t subresourceIndex = 0; subresourceIndex < DF_CUBE_FACE__COUNT * m_envMipCount; ++subresourceIndex)
+	{
+		srcLoc.PlacedFootprint = layout.envLayouts[subresourceIndex];
+		srcLoc.PlacedFootprint.Offset += staging.offset;
+		destLoc.SubresourceIndex = subresourceIndex;
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	destLoc.pResource = m_front.specResource.Get();
+
+	// Copy every mip level of every face of the specular map.
+	for(uint32_t subresourceIndex = 0; subresourceIndex < DF_CUBE_FACE__COUNT * m_envMipCount; ++subresourceIndex)
+	{
+		srcLoc.PlacedFootprint = layout.specLayouts[subresourceIndex];
+		srcLoc.PlacedFootprint.Offset += staging.offset;
+		destLoc.SubresourceIndex = subresourceIndex;
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	destLoc.pResource = m_front.irrResource.Get();
+
+	// Copy every face of the irradiance map.
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
+	{
+		srcLoc.PlacedFootprint = layout.irrLayouts[faceIndex];
+		srcLoc.PlacedFootprint.Offset += staging.offset;
+		destLoc.SubresourceIndex = faceIndex;
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	// Put the coefficients where the bake would have left them so the coefficient buffer matches a baked probe.
+	cmdList->CopyBufferRegion(
+		m_shCoeffResource.Get(),
+		uint64_t(sizeof(ShColorCoefficients)) * (m_uavArrayLength - 1),
+		staging.pResource,
+		staging.offset + layout.coeffOffset,
+		sizeof(ShColorCoefficients));
+
+	// Transition the probe resources back to their usual states.
+	cmdList->ResourceBarrier(4, &barriers[4]);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::ReflectionProbe::_copyToReadback(const Device::Ptr& device, const GraphicsCommandList::Ptr& cmdList)
+{
+	constexpr D3D12_HEAP_PROPERTIES readbackHeapProps =
+	{
+		D3D12_HEAP_TYPE_READBACK,        // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	CacheLayout layout;
+	_getCacheLayout(device, layout);
+
+	const D3D12_RESOURCE_DESC readbackResDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                               // UINT64 Alignment
+		layout.totalSize,                // UINT64 Width
+		1,                               // UINT Height
+		1,                               // UINT16 DepthOrArraySize
+		1,                               // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,             // DXGI_FORMAT Format
+		defaultSampleDesc,               // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	// Create the buffer the baked results will be read back through.
+	m_readbackResource = CreateCommittedResource(
+		device,
+		readbackResDesc,
+		readbackHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!m_readbackResource)
+	{
+		LOG_ERROR("Failed to create reflection probe readback buffer: size=%" PRIu64, layout.totalSize);
+		return false;
+	}
+
+	D3D12_RESOURCE_BARRIER barriers[8];
+	barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barriers[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barriers[0].Transition.pResource = m_front.envResource.Get();
+	barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+	barriers[1] = barriers[0];
+	barriers[1].Transition.pResource = m_front.irrResource.Get();
+
+	barriers[2] = barriers[0];
+	barriers[2].Transition.pResource = m_front.specResource.Get();
+
+	barriers[3] = barriers[0];
+	barriers[3].Transition.pResource = m_shCoeffResource.Get();
+	barriers[3].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		barriers[i + 4] = barriers[i];
+		barriers[i + 4].Transition.StateBefore = barriers[i].Transition.StateAfter;
+		barriers[i + 4].Transition.StateAfter = barriers[i].Transition.StateBefore;
+	}
+
+	// Transition the probe resources so they can be copied from.
+	cmdList->ResourceBarrier(4, &barriers[0]);
+
+	D3D12_TEXTURE_COPY_LOCATION srcLoc;
+	srcLoc.pResource = m_front.envResource.Get();
+	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+	D3D12_TEXTURE_COPY_LOCATION destLoc;
+	destLoc.pResource = m_readbackResource.Get();
+	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+	// Copy every mip level of every face of the environment map.
+	for(uint32_t subresourceIndex = 0; subresourceIndex < DF_CUBE_FACE__COUNT * m_envMipCount; ++subresourceIndex)
+	{
+		srcLoc.SubresourceIndex = subresourceIndex;
+		destLoc.PlacedFootprint = layout.envLayouts[subresourceIndex];
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	srcLoc.pResource = m_front.specResource.Get();
+
+	// Copy every mip level of every face of the specular map.
+	for(uint32_t subresourceIndex = 0; subresourceIndex < DF_CUBE_FACE__COUNT * m_envMipCount; ++subresourceIndex)
+	{
+		srcLoc.SubresourceIndex = subresourceIndex;
+		destLoc.PlacedFootprint = layout.specLayouts[subresourceIndex];
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	srcLoc.pResource = m_front.irrResource.Get();
+
+	// Copy every face of the irradiance map.
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_FACE__COUNT; ++faceIndex)
+	{
+		srcLoc.SubresourceIndex = faceIndex;
+		destLoc.PlacedFootprint = layout.irrLayouts[faceIndex];
+
+		cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	}
+
+	// Copy the final coefficients out of the coefficient buffer.
+	cmdList->CopyBufferRegion(
+		m_readbackResource.Get(),
+		layout.coeffOffset,
+		m_shCoeffResource.Get(),
+		uint64_t(sizeof(ShColorCoefficients)) * (m_uavArrayLength - 1),
+		sizeof(ShColorCoefficients));
+
+	// Transition the probe resources back to their usual states.
+	cmdList->ResourceBarrier(4, &barriers[4]);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::ReflectionProbe::_getCacheParamHash(const Texture2D::Ptr& envTexture) const
+{
+	using namespace DemoFramework::Utility;
+
+	uint64_t paramHash = Hash::Combine(DF_REFL_PROBE_CACHE_PARAM_VERSION, uint64_t(m_quality));
+	paramHash = Hash::Combine(paramHash, uint64_t(m_envEdgeLength));
+	paramHash = Hash::Combine(paramHash, uint64_t(m_envMipCount));
+	paramHash = Hash::Combine(paramHash, uint64_t(m_irrEdgeLength));
+	paramHash = Hash::Combine(paramHash, uint64_t(DF_REFL_SPEC_SAMPLE_COUNT));
+	paramHash = Hash::Combine(paramHash, m_shaderHash);
+
+	// The bake reads the texture as it was loaded, not the source file, so how it was loaded matters as well.
+	paramHash = Hash::Combine(paramHash, uint64_t(envTexture->GetFormat()));
+	paramHash = Hash::Combine(paramHash, uint64_t(envTexture->GetWidth()));
+	paramHash = Hash::Combine(paramHash, uint64_t(envTexture->GetHeight()));
+	paramHash = Hash::Combine(paramHash, uint64_t(envTexture->GetMipCount()));
+
+	return paramHash;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::ReflectionProbe::_getCacheLayout(const Device::Ptr& device, CacheLayout& outLayout) const
+{
+	using namespace DemoFramework::Utility;
+
+	const D3D12_RESOURCE_DESC envResDesc = m_front.envResource->GetDesc();
+	const D3D12_RESOURCE_DESC irrResDesc = m_front.irrResource->GetDesc();
+	const D3D12_RESOURCE_DESC specResDesc = m_front.specResource->GetDesc();
+
+	uint64_t envMapDataSize = 0;
+	uint64_t specMapDataSize = 0;
+
+	// Subresources of a cube map are ordered by face first, then by mip level within each face.
+	device->GetCopyableFootprints(
+		&envResDesc,
+		0,
+		DF_CUBE_FACE__COUNT * m_envMipCount,
+		0,
+		outLayout.envLayouts,
+		nullptr,
+		nullptr,
+		&envMapDataSize);
+
+	outLayout.specOffset = Math::GetAlignedSize(envMapDataSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+
+	device->GetCopyableFootprints(
+		&specResDesc,
+		0,
+		DF_CUBE_FACE__COUNT * m_envMipCount,
+		outLayout.specOffset,
+		outLayout.specLayouts,
+		nullptr,
+		nullptr,
+		&specMapDataSize);
+
+	outLayout.envDataSize = outLayout.specOffset + specMapDataSize;
+	outLayout.irrOffset = Math::GetAlignedSize(outLayout.envDataSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+
+	device->GetCopyableFootprints(
+		&irrResDesc,
+		0,
+		DF_CUBE_FACE__COUNT,
+		outLayout.irrOffset,
+		outLayout.irrLayouts,
+		nullptr,
+		nullptr,
+		&outLayout.irrDataSize);
+
+	outLayout.coeffOffset = Math::GetAlignedSize(outLayout.irrOffset + outLayout.irrDataSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+	outLayout.totalSize = outLayout.coeffOffset + sizeof(ShColorCoefficients);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
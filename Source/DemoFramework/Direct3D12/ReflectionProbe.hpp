@@ -21,7 +21,12 @@
 
 #include "CommandContext.hpp"
 #include "DescriptorAllocator.hpp"
+#include "ProbeCache.hpp"
 #include "Texture2D.hpp"
+#include "UploadRing.hpp"
+
+#include "../Utility/ProbeUpdateScheduler.hpp"
+#include "../Utility/Stopwatch.hpp"
 
 #include "Shaders/global-common.hlsli"
 
@@ -29,6 +34,11 @@
 
 //---------------------------------------------------------------------------------------------------------------------
 
+// Maximum number of frames the GPU can run behind the CPU while a probe is being updated over several frames.
+#define DF_REFL_PROBE_MAX_FRAMES_IN_FLIGHT 7
+
+//---------------------------------------------------------------------------------------------------------------------
+
 namespace DemoFramework { namespace D3D12 {
 	class ReflectionProbe;
 
@@ -62,15 +72,52 @@ public:
 		const DescriptorAllocator::Ptr& srvUavAlloc,
 		EnvMapQuality mapQuality);
 
+	// Record the commands that bake the environment, irradiance and specular maps from an equirectangular environment
+	// texture.
+	//
+	// When a probe cache is given, the results of previous bakes of the same source file at the same quality are
+	// uploaded from the cache through the upload ring instead, skipping every compute pass. On a miss, the baked
+	// results are copied to a readback buffer so they can be written to the cache by CompleteLoad(). Textures that
+	// weren't loaded from a file are always baked.
 	bool LoadEnvironmentMap(
 		const Device::Ptr& device,
 		const GraphicsCommandList::Ptr& cmdList,
-		const Texture2D::Ptr& envTexture);
+		const Texture2D::Ptr& envTexture,
+		const ProbeCache::Ptr& cache = ProbeCache::Ptr(),
+		const UploadRing::Ptr& uploadRing = UploadRing::Ptr());
+
+	// Finish the last call to LoadEnvironmentMap(), storing newly baked results in the probe cache and releasing the
+	// readback buffer. This must not be called until the GPU has finished executing the commands it recorded. When
+	// given the queue the commands were executed on, the GPU time of the bake is logged along with the probe quality.
+	void CompleteLoad(const Device::Ptr& device, const CommandQueue::Ptr& cmdQueue = CommandQueue::Ptr());
+
+	// Start updating the probe from an equirectangular environment texture over several frames. The update is baked
+	// into a second set of cube maps while the current ones stay visible, and the two are swapped once it finishes.
+	// The number of frames in flight is how far the GPU can run behind the CPU; it decides how long the old cube maps
+	// are left alone after a swap and how long it takes for the GPU time of each frame's work to be known. Starting an
+	// update while another one is in progress starts it over with the new texture. The caller needs to keep the texture
+	// alive until the GPU has finished every frame the update is recorded in.
+	bool BeginUpdate(
+		const Device::Ptr& device,
+		const CommandQueue::Ptr& cmdQueue,
+		const Texture2D::Ptr& envTexture,
+		uint32_t framesInFlight);
+
+	// Record the next slice of the update in progress, keeping its estimated GPU time within the given budget. This
+	// needs to be called once per frame. Returns true when the slice finished the update and swapped the cube maps.
+	bool Update(const GraphicsCommandList::Ptr& cmdList, float64_t gpuBudgetMs);
+
+	void CancelUpdate();
+
+	bool IsUpdating() const;
 
 	const DescriptorAllocator::Ptr& GetSrvAllocator() const;
 	const Descriptor& GetEnvMapDescriptor() const;
 	const Descriptor& GetIrrMapDescriptor() const;
 
+	// GGX prefiltered environment map, with one roughness per mip as given by Utility::SpecularPrefilter.
+	const Descriptor& GetSpecMapDescriptor() const;
+
 	uint32_t GetEnvMapMipLevelCount() const;
 	uint32_t GetEnvMapEdgeLength() const;
 	uint32_t GetIrrMapEdgeLength() const;
@@ -78,14 +125,43 @@ public:
 
 private:
 
+	struct CacheLayout;
+
+	struct CubeMaps
+	{
+		Resource::Ptr envResource;
+		Resource::Ptr irrResource;
+		Resource::Ptr specResource;
+
+		Descriptor envSrvDescriptor;
+		Descriptor irrSrvDescriptor;
+		Descriptor specSrvDescriptor;
+
+		Descriptor envFaceUavDescriptor[DF_CUBE_FACE__COUNT * D3D12_REQ_MIP_LEVELS];
+		Descriptor irrFaceUavDescriptor[DF_CUBE_FACE__COUNT];
+		Descriptor specFaceUavDescriptor[DF_CUBE_FACE__COUNT * D3D12_REQ_MIP_LEVELS];
+	};
+
 	bool _initEquiToCubePipeline(const Device::Ptr&);
 	bool _initShProjectPipeline(const Device::Ptr&);
 	bool _initShReducePipeline(const Device::Ptr&);
 	bool _initShNormalizePipeline(const Device::Ptr&);
 	bool _initShReconstructPipeline(const Device::Ptr&);
-	bool _initCubeMaps(const Device::Ptr&);
+	bool _initSpecPrefilterPipeline(const Device::Ptr&);
+	bool _initCubeMaps(const Device::Ptr&, CubeMaps&);
 	bool _initUavResources(const Device::Ptr&);
+	bool _initGpuTimer(const Device::Ptr&);
 	void _generateIrradiance(const GraphicsCommandList::Ptr&);
+	void _generateSpecular(const GraphicsCommandList::Ptr&);
+	void _recordUpdateStep(const GraphicsCommandList::Ptr&, const Utility::ProbeUpdateScheduler::Step&, bool);
+	void _reportUpdateTimes();
+	void _reportLoadTimes(const CommandQueue::Ptr&);
+	void _freeCubeMaps(CubeMaps&);
+	bool _uploadCacheEntry(const Device::Ptr&, const GraphicsCommandList::Ptr&, const UploadRing::Ptr&, const ProbeCache::Entry&);
+	bool _copyToReadback(const Device::Ptr&, const GraphicsCommandList::Ptr&);
+
+	uint64_t _getCacheParamHash(const Texture2D::Ptr&) const;
+	void _getCacheLayout(const Device::Ptr&, CacheLayout&) const;
 
 	D3D12_STATIC_SAMPLER_DESC _getStaticSamplerDesc() const;
 
@@ -106,16 +182,27 @@ private:
 	RootSignature::Ptr m_shReconstructRootSig;
 	PipelineState::Ptr m_shReconstructPipeline;
 
-	Resource::Ptr m_envResource;
-	Resource::Ptr m_irrResource;
+	RootSignature::Ptr m_specPrefilterRootSig;
+	PipelineState::Ptr m_specPrefilterPipeline;
+
 	Resource::Ptr m_shCoeffResource;
 	Resource::Ptr m_shWeightResource;
+	Resource::Ptr m_readbackResource;
+	Resource::Ptr m_timestampResource;
 
-	Descriptor m_envSrvDescriptor;
-	Descriptor m_irrSrvDescriptor;
+	QueryHeap::Ptr m_timestampQueryHeap;
 
-	Descriptor m_envFaceUavDescriptor[DF_CUBE_FACE__COUNT * D3D12_REQ_MIP_LEVELS];
-	Descriptor m_irrFaceUavDescriptor[DF_CUBE_FACE__COUNT];
+	Texture2D::Ptr m_updateTexture;
+
+	ProbeCache::Ptr m_cache;
+	ProbeCache::Key m_cacheKey;
+
+	Utility::Stopwatch m_loadStopwatch;
+
+	Utility::ProbeUpdateScheduler m_updateScheduler;
+
+	CubeMaps m_front;
+	CubeMaps m_back; // Only created once the first update begins
 
 	Descriptor m_coeffSrvDescriptor;
 	Descriptor m_coeffUavDescriptor;
@@ -127,6 +214,24 @@ private:
 	uint32_t m_irrEdgeLength;
 	uint32_t m_uavArrayLength;
 	uint32_t m_uavArrayBaseLength;
+
+	EnvMapQuality m_quality;
+
+	uint64_t m_shaderHash;
+
+	float64_t m_loadRecordTime;
+
+	uint64_t m_timestampFrequency;
+	uint64_t m_timestampFrame[DF_REFL_PROBE_MAX_FRAMES_IN_FLIGHT + 1];
+
+	uint32_t m_framesInFlight;
+
+	bool m_loadPending;
+	bool m_loadFromCache;
+	bool m_loadTimed;
+	bool m_backEnvWritable;
+	bool m_backIrrWritable;
+	bool m_backSpecWritable;
 };
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -147,13 +252,20 @@ inline DemoFramework::D3D12::ReflectionProbe::ReflectionProbe()
 	, m_shNormalizePipeline()
 	, m_shReconstructRootSig()
 	, m_shReconstructPipeline()
-	, m_envResource()
-	, m_irrResource()
+	, m_specPrefilterRootSig()
+	, m_specPrefilterPipeline()
 	, m_shCoeffResource()
 	, m_shWeightResource()
-	, m_envSrvDescriptor(Descriptor::Invalid)
-	, m_irrSrvDescriptor(Descriptor::Invalid)
-	, m_irrFaceUavDescriptor()
+	, m_readbackResource()
+	, m_timestampResource()
+	, m_timestampQueryHeap()
+	, m_updateTexture()
+	, m_cache()
+	, m_cacheKey()
+	, m_loadStopwatch()
+	, m_updateScheduler()
+	, m_front()
+	, m_back()
 	, m_coeffSrvDescriptor(Descriptor::Invalid)
 	, m_coeffUavDescriptor(Descriptor::Invalid)
 	, m_weightSrvDescriptor(Descriptor::Invalid)
@@ -163,15 +275,41 @@ inline DemoFramework::D3D12::ReflectionProbe::ReflectionProbe()
 	, m_irrEdgeLength(0)
 	, m_uavArrayLength(0)
 	, m_uavArrayBaseLength(0)
+	, m_quality(EnvMapQuality::Low)
+	, m_shaderHash(0)
+	, m_loadRecordTime(0.0)
+	, m_timestampFrequency(0)
+	, m_timestampFrame()
+	, m_framesInFlight(0)
+	, m_loadPending(false)
+	, m_loadFromCache(false)
+	, m_loadTimed(false)
+	, m_backEnvWritable(false)
+	, m_backIrrWritable(false)
+	, m_backSpecWritable(false)
 {
-	for(size_t i = 0; i < DF_CUBE_FACE__COUNT; ++i)
+	CubeMaps* const pCubeMaps[] =
 	{
-		for(size_t j = 0; j < D3D12_REQ_MIP_LEVELS; ++j)
+		&m_front,
+		&m_back,
+	};
+
+	for(CubeMaps* const pMaps : pCubeMaps)
+	{
+		pMaps->envSrvDescriptor = Descriptor::Invalid;
+		pMaps->irrSrvDescriptor = Descriptor::Invalid;
+		pMaps->specSrvDescriptor = Descriptor::Invalid;
+
+		for(size_t i = 0; i < DF_CUBE_FACE__COUNT; ++i)
 		{
-			m_envFaceUavDescriptor[(i * DF_CUBE_FACE__COUNT) + j] = Descriptor::Invalid;
-		}
+			for(size_t j = 0; j < D3D12_REQ_MIP_LEVELS; ++j)
+			{
+				pMaps->envFaceUavDescriptor[(i * D3D12_REQ_MIP_LEVELS) + j] = Descriptor::Invalid;
+				pMaps->specFaceUavDescriptor[(i * D3D12_REQ_MIP_LEVELS) + j] = Descriptor::Invalid;
+			}
 
-		m_irrFaceUavDescriptor[i] = Descriptor::Invalid;
+			pMaps->irrFaceUavDescriptor[i] = Descriptor::Invalid;
+		}
 	}
 }
 
@@ -186,14 +324,28 @@ inline const DemoFramework::D3D12::DescriptorAllocator::Ptr& DemoFramework::D3D1
 
 inline const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::ReflectionProbe::GetEnvMapDescriptor() const
 {
-	return m_envSrvDescriptor;
+	return m_front.envSrvDescriptor;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 
 inline const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::ReflectionProbe::GetIrrMapDescriptor() const
 {
-	return m_irrSrvDescriptor;
+	return m_front.irrSrvDescriptor;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::ReflectionProbe::GetSpecMapDescriptor() const
+{
+	return m_front.specSrvDescriptor;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::ReflectionProbe::IsUpdating() const
+{
+	return m_updateScheduler.IsUpdating();
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -32,6 +32,8 @@
 
 #define DF_SH_REDUCE_SEGMENT_SIZE 4
 
+#define DF_REFL_SPEC_SAMPLE_COUNT 64
+
 #define DF_SH_CONST_Y00  0.28209479177387814347403972578039f // sqrt(1 / 4pi)
 #define DF_SH_CONST_Y1_1 0.48860251190291992158638462283835f // sqrt(3 / 4pi)
 #define DF_SH_CONST_Y10  0.48860251190291992158638462283835f // sqrt(3 / 4pi)
@@ -65,6 +67,7 @@ struct EquiToCubeRootConstant
 	uint faceIndex;
 	uint edgeLength;
 	float invEdgeLength;
+	uint rowOffset; // First face row covered by the dispatch
 };
 
 struct ClearRootConstant
@@ -76,12 +79,14 @@ struct ShProjectRootConstant
 {
 	uint edgeLength;
 	float invEdgeLength;
+	uint rowOffset; // First face row covered by the dispatch
 };
 
 struct ShReduceRootConstant
 {
 	uint headIndex;
 	uint tailIndex;
+	uint outputOffset; // First output of the reduction pass covered by the dispatch
 };
 
 struct ShNormalizeRootConstant
@@ -97,6 +102,19 @@ struct ShReconstructRootConstant
 	float invEdgeLength;
 };
 
+struct SpecPrefilterRootConstant
+{
+	uint faceIndex;
+	uint edgeLength;
+	float invEdgeLength;
+	uint rowOffset; // First face row covered by the dispatch
+	uint sampleCount;
+	float invSampleCount;
+	float roughness;
+	float srcTexelSolidAngle; // Solid angle of a texel in the top mip of the environment map
+	float srcMaxLod;
+};
+
 struct ShColorCoefficients
 {
 	// SH coefficients for a given normal on the sphere.
@@ -32,15 +32,18 @@ RWTexture2D<float4> envFaceMap : register(u0, space0);
 [numthreads(DF_REFL_THREAD_COUNT_X, DF_REFL_THREAD_COUNT_Y, 1)]
 void ComputeMain(uint2 threadId : SV_DispatchThreadID)
 {
-	if(threadId.x >= rootConst.edgeLength || threadId.y >= rootConst.edgeLength)
+	// Faces can be converted a band of rows at a time, so offset the thread to the first row of the band.
+	const uint2 coord = uint2(threadId.x, threadId.y + rootConst.rowOffset);
+
+	if(coord.x >= rootConst.edgeLength || coord.y >= rootConst.edgeLength)
 	{
 		return;
 	}
 
-	const float3 normal = CalculateNormalFromPixelCoord(threadId, rootConst.faceIndex, rootConst.invEdgeLength);
+	const float3 normal = CalculateNormalFromPixelCoord(coord, rootConst.faceIndex, rootConst.invEdgeLength);
 	const float2 texCoord = CalculateEquirectUvFromNormal(normal);
 
-	envFaceMap[threadId] = equirectMap.SampleLevel(mapSampler, texCoord, rootConst.mipIndex);
+	envFaceMap[coord] = equirectMap.SampleLevel(mapSampler, texCoord, rootConst.mipIndex);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -33,13 +33,14 @@ RWStructuredBuffer<float> shWeights : register(u1, space0);
 [numthreads(DF_REFL_THREAD_COUNT_X, DF_REFL_THREAD_COUNT_Y, 1)]
 void ComputeMain(uint2 threadId : SV_DispatchThreadID)
 {
-	if(threadId.x >= rootConst.edgeLength || threadId.y >= rootConst.edgeLength)
+	// The projection can be run a band of rows at a time, so offset the thread to the first row of the band.
+	const uint2 coord = uint2(threadId.x, threadId.y + rootConst.rowOffset);
+
+	if(coord.x >= rootConst.edgeLength || coord.y >= rootConst.edgeLength)
 	{
 		return;
 	}
 
-	const uint2 coord = threadId.xy;
-
 	// Project the left-facing normal and color into a set of spherical harmonic coefficients.
 	const float3 normalLeft = CalculateNormalFromPixelCoord(coord, DF_CUBE_FACE_LEFT, rootConst.invEdgeLength);
 	const float3 colorLeft = envMap.SampleLevel(mapSampler, normalLeft, 0).xyz;
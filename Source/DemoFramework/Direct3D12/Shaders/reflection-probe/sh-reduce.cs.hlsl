@@ -30,9 +30,12 @@ RWStructuredBuffer<float> shWeights : register(u1, space0);
 [numthreads(DF_REFL_SH_LINEAR_THREAD_COUNT, 1, 1)]
 void ComputeMain(uint threadId : SV_DispatchThreadID)
 {
+	// A reduction pass can be split over several dispatches, each starting at a different output.
+	const uint segmentIndex = threadId + rootConst.outputOffset;
+
 	// Calculate the start of the current segment based on the index range.
-	const uint inputIndex = rootConst.headIndex + (threadId * DF_SH_REDUCE_SEGMENT_SIZE);
-	const uint outputIndex = rootConst.tailIndex + threadId;
+	const uint inputIndex = rootConst.headIndex + (segmentIndex * DF_SH_REDUCE_SEGMENT_SIZE);
+	const uint outputIndex = rootConst.tailIndex + segmentIndex;
 
 	if(inputIndex + DF_SH_REDUCE_SEGMENT_SIZE > rootConst.tailIndex)
 	{
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "common.hlsli"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+ConstantBuffer<SpecPrefilterRootConstant> rootConst : register(b0, space0);
+
+TextureCube envMap : register(t0, space0);
+SamplerState mapSampler : register(s0, space0);
+
+RWTexture2D<float4> specFaceMap : register(u0, space0);
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float2 Hammersley(const uint index)
+{
+	return float2((float)index * rootConst.invSampleCount, (float)reversebits(index) * 2.3283064365386963e-10f);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+[numthreads(DF_REFL_THREAD_COUNT_X, DF_REFL_THREAD_COUNT_Y, 1)]
+void ComputeMain(uint2 threadId : SV_DispatchThreadID)
+{
+	// Faces can be filtered a band of rows at a time, so offset the thread to the first row of the band.
+	const uint2 coord = uint2(threadId.x, threadId.y + rootConst.rowOffset);
+
+	if(coord.x >= rootConst.edgeLength || coord.y >= rootConst.edgeLength)
+	{
+		return;
+	}
+
+	const float3 normal = CalculateNormalFromPixelCoord(coord, rootConst.faceIndex, rootConst.invEdgeLength);
+
+	// A mirror reflects the environment unfiltered.
+	if(rootConst.roughness <= 0.0f)
+	{
+		specFaceMap[coord] = envMap.SampleLevel(mapSampler, normal, 0.0f);
+		return;
+	}
+
+	// Tangent frame around the normal. The choice of frame only rotates the sample pattern about the normal.
+	const float3 up = (abs(normal.z) < 0.999f) ? float3(0.0f, 0.0f, 1.0f) : float3(1.0f, 0.0f, 0.0f);
+
+	WorldBasis basis;
+	basis.normal = normal;
+	basis.tangent = normalize(cross(up, normal));
+	basis.binormal = cross(normal, basis.tangent);
+
+	const float alphaSq = (rootConst.roughness * rootConst.roughness) * (rootConst.roughness * rootConst.roughness);
+
+	float4 color = 0.0f;
+	float weightSum = 0.0f;
+
+	for(uint sampleIndex = 0; sampleIndex < rootConst.sampleCount; ++sampleIndex)
+	{
+		const float2 xi = Hammersley(sampleIndex);
+
+		// Half vector from the inverse CDF of the GGX distribution. The view direction is assumed to be the normal,
+		// so the light direction is the normal reflected about the half vector.
+		const float phi = M_TAU * xi.x;
+		const float cosThetaSq = (1.0f - xi.y) / (1.0f + ((alphaSq - 1.0f) * xi.y));
+		const float cosTheta = sqrt(cosThetaSq);
+		const float sinTheta = sqrt(1.0f - cosThetaSq);
+		const float nDotL = (2.0f * cosThetaSq) - 1.0f;
+
+		if(nDotL <= 0.0f)
+		{
+			continue;
+		}
+
+		// With N = V, the pdf of the light direction, D * NdotH / (4 * VdotH), reduces to D / 4.
+		const float denom = (cosThetaSq * (alphaSq - 1.0f)) + 1.0f;
+		const float pdf = (alphaSq / (M_PI * denom * denom)) * 0.25f;
+
+		// Filtered importance sampling: fetch from the mip whose texels cover the solid angle this sample stands for.
+		const float sampleSolidAngle = 1.0f / ((float)rootConst.sampleCount * pdf);
+		const float lod = clamp(0.5f * log2(sampleSolidAngle / rootConst.srcTexelSolidAngle), 0.0f, rootConst.srcMaxLod);
+
+		const float3 lightDir = ((2.0f * cosTheta * sinTheta) * float3(cos(phi), sin(phi), 0.0f)) + float3(0.0f, 0.0f, nDotL);
+
+		color += envMap.SampleLevel(mapSampler, TangentToWorld(lightDir, basis), lod) * nDotL;
+		weightSum += nDotL;
+	}
+
+	specFaceMap[coord] = color / weightSum;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../global-common.hlsli"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Page ID layout: [31:28] mip, [27:14] page y, [13:0] page x.
+#define DF_VT_PAGE_ID_MIP_SHIFT  28
+#define DF_VT_PAGE_ID_Y_SHIFT    14
+#define DF_VT_PAGE_ID_COORD_MASK 0x3FFF
+
+// Feedback texels that didn't sample the virtual texture hold this value.
+#define DF_VT_INVALID_PAGE_ID 0xFFFFFFFF
+
+#define DF_VT_MAX_MIP_COUNT 15
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#ifdef _WIN32
+	#define uint uint32_t
+
+	struct uint4
+	{
+		uint32_t x, y, z, w;
+	};
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Constant buffer layout describing a virtual texture to the shaders sampling it.
+struct VirtualTextureConstants
+{
+	uint width;
+	uint height;
+	uint pageSize;
+	uint borderSize;
+
+	uint tileSize;
+	uint mipCount;
+	float invPhysicalWidth;
+	float invPhysicalHeight;
+
+	// Index of the first indirection entry of each mip, four mips to an element.
+	uint4 mipOffsets[(DF_VT_MAX_MIP_COUNT + 3) / 4];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint2 GetVirtualMipSize(const VirtualTextureConstants vt, const uint mipIndex)
+{
+	return max(uint2(vt.width, vt.height) >> mipIndex, (uint2)1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint2 GetVirtualPageCoord(const VirtualTextureConstants vt, const float2 uv, const uint mipIndex)
+{
+	const uint2 mipSize = GetVirtualMipSize(vt, mipIndex);
+	const uint2 texel = min(uint2(saturate(uv) * float2(mipSize)), mipSize - 1);
+
+	return texel / vt.pageSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float CalculateVirtualMip(const VirtualTextureConstants vt, const float2 uvDx, const float2 uvDy)
+{
+	// Same footprint estimate the hardware uses to pick a mip: the longer of the two screen space
+	// derivatives, measured in texels of the most detailed mip.
+	const float2 texelDx = uvDx * float2(vt.width, vt.height);
+	const float2 texelDy = uvDy * float2(vt.width, vt.height);
+	const float lengthSq = max(dot(texelDx, texelDx), dot(texelDy, texelDy));
+
+	return clamp(0.5f * log2(max(lengthSq, M_EPSILON)), 0.0f, float(vt.mipCount - 1));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint CalculateVirtualPageId(const VirtualTextureConstants vt, const float2 uv, const float2 uvDx, const float2 uvDy)
+{
+	// This is the value written to the feedback buffer.
+	const uint mipIndex = uint(CalculateVirtualMip(vt, uvDx, uvDy));
+	const uint2 page = GetVirtualPageCoord(vt, uv, mipIndex);
+
+	return (mipIndex << DF_VT_PAGE_ID_MIP_SHIFT) | (page.y << DF_VT_PAGE_ID_Y_SHIFT) | page.x;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float4 SampleVirtualTexture(
+	const VirtualTextureConstants vt,
+	const Buffer<uint> indirection,
+	const Texture2D physicalTexture,
+	const SamplerState physicalSampler,
+	const float2 uv,
+	const float2 uvDx,
+	const float2 uvDy)
+{
+	const uint mipIndex = uint(CalculateVirtualMip(vt, uvDx, uvDy));
+	const uint2 page = GetVirtualPageCoord(vt, uv, mipIndex);
+	const uint pageCountX = (GetVirtualMipSize(vt, mipIndex).x + vt.pageSize - 1) / vt.pageSize;
+	const uint entry = indirection[vt.mipOffsets[mipIndex >> 2][mipIndex & 3] + (page.y * pageCountX) + page.x];
+
+	if((entry >> 24) == 0)
+	{
+		// Not even the least detailed mip is resident yet.
+		return 0.0f;
+	}
+
+	// Unmapped pages point at the page of an ancestor, so the position within the page
+	// needs to come from whichever mip actually got mapped.
+	const uint2 slot = uint2(entry & 0xFF, (entry >> 8) & 0xFF);
+	const uint mappedMip = (entry >> 16) & 0xFF;
+
+	const float2 mappedSize = float2(GetVirtualMipSize(vt, mappedMip));
+	const float2 texel = saturate(uv) * mappedSize;
+	const float2 pageOrigin = float2(GetVirtualPageCoord(vt, uv, mappedMip) * vt.pageSize);
+
+	const float2 invPhysicalSize = float2(vt.invPhysicalWidth, vt.invPhysicalHeight);
+	const float2 physicalTexel = float2(slot * vt.tileSize + vt.borderSize) + (texel - pageOrigin);
+	const float2 gradientScale = mappedSize * invPhysicalSize;
+
+	return physicalTexture.SampleGrad(
+		physicalSampler,
+		physicalTexel * invPhysicalSize,
+		uvDx * gradientScale,
+		uvDy * gradientScale);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -24,247 +24,291 @@
 #include "LowLevel/Resource.hpp"
 
 #include "../Application/Log.hpp"
+#include "../Utility/Hash.hpp"
+#include "../Utility/HdrDecoder.hpp"
+#include "../Utility/MappedFile.hpp"
 #include "../Utility/Math.hpp"
+#include "../Utility/MipStreamScheduler.hpp"
+#include "../Utility/Stopwatch.hpp"
+#include "../Utility/SupercompressedTexture.hpp"
+#include "../Utility/TextureFootprint.hpp"
+#include "../Utility/ThreadPool.hpp"
 
 #include <DirectXTex.h>
 #include <stb_image.h>
 
-//---------------------------------------------------------------------------------------------------------------------
-
-DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::Load(
-	const Device::Ptr& device,
-	const GraphicsCommandList::Ptr& uploadCmdList,
-	const DescriptorAllocator::Ptr& srvAlloc,
-	const DataType dataType,
-	const Channel channel,
-	const char* const filePath,
-	const uint32_t mipCount)
-{
-	using namespace DemoFramework::Utility;
-
-	if(!device || !uploadCmdList || !srvAlloc || !filePath || filePath[0] == '\0' || mipCount == 0)
-	{
-		LOG_ERROR("Invalid parameter");
-		return Ptr();
-	}
+#include <atomic>
+#include <mutex>
+#include <vector>
 
-	uint32_t width = 0;
-	uint32_t height = 0;
-	uint32_t channelCount = 0;
-	uint32_t channelSize = 0;
+//---------------------------------------------------------------------------------------------------------------------
 
-	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+// Bumping this invalidates every texture cache entry made by older versions of the texture processing code.
+#define DF_TEXTURE2D_CACHE_PARAM_VERSION 3
 
-	void* pImgData = nullptr;
+// Size of the cached staging buffers shared by the images of a batch load.
+#define DF_TEXTURE2D_STAGING_BLOCK_SIZE (32 * 1024 * 1024)
 
-	switch(channel)
-	{
-		case Channel::L:    channelCount = 1; break;
-		case Channel::LA:   channelCount = 2; break;
-		case Channel::RGBA: channelCount = 4; break;
+//---------------------------------------------------------------------------------------------------------------------
 
-		default:
-			LOG_ERROR("Invalid parameter");
-			return Ptr();
-	}
+static DXGI_FORMAT GetBlockCompressedFormat(
+	const DemoFramework::D3D12::Texture2D::DataType dataType,
+	const DemoFramework::D3D12::Texture2D::Channel channel)
+{
+	using namespace DemoFramework::D3D12;
 
 	switch(dataType)
 	{
-		case DataType::Unorm:
-		{
-			pImgData = stbi_load(filePath, reinterpret_cast<int32_t*>(&width), reinterpret_cast<int32_t*>(&height), nullptr, channelCount);
-			channelSize = sizeof(uint8_t);
-
+		case Texture2D::DataType::Unorm:
 			switch(channel)
 			{
-				case Channel::L:    format = DXGI_FORMAT_R8_UNORM;       break;
-				case Channel::LA:   format = DXGI_FORMAT_R8G8_UNORM;     break;
-				case Channel::RGBA: format = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+				case Texture2D::Channel::L:    return DXGI_FORMAT_BC4_UNORM;
+				case Texture2D::Channel::LA:   return DXGI_FORMAT_BC5_UNORM;
+				case Texture2D::Channel::RGBA: return DXGI_FORMAT_BC7_UNORM;
 
 				default:
-					// This should never happen.
-					assert(false);
 					break;
 			}
 			break;
-		}
-
-		case DataType::Float:
-		{
-			pImgData = stbi_loadf(filePath, reinterpret_cast<int32_t*>(&width), reinterpret_cast<int32_t*>(&height), nullptr, channelCount);
-			channelSize = sizeof(float32_t);
 
-			switch(channel)
+		case Texture2D::DataType::Float:
+			// BC6H is the only block-compressed HDR format and it has no alpha channel; image files
+			// decoded as float are all HDR color, so the alpha channel isn't expected to matter.
+			if(channel == Texture2D::Channel::RGBA)
 			{
-				case Channel::L:    format = DXGI_FORMAT_R32_FLOAT;          break;
-				case Channel::LA:   format = DXGI_FORMAT_R32G32_FLOAT;       break;
-				case Channel::RGBA: format = DXGI_FORMAT_R32G32B32A32_FLOAT; break;
-
-				default:
-					// This should never happen.
-					assert(false);
-					break;
+				return DXGI_FORMAT_BC6H_UF16;
 			}
 			break;
-		}
 
 		default:
-			LOG_ERROR("Invalid parameter");
-			return Ptr();
+			break;
 	}
 
-	if(!pImgData)
-	{
-		LOG_ERROR("Failed to load image file: %s", filePath);
-		return Ptr();
-	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
 
-	auto calculateMipLevelMaxCount = [&width, &height]() -> uint32_t
+static bool GetCompressorFormat(const DXGI_FORMAT format, DemoFramework::Utility::BlockCompressor::Format& outFormat)
+{
+	using Format = DemoFramework::Utility::BlockCompressor::Format;
+
+	switch(format)
 	{
-		uint32_t mipWidth = width;
-		uint32_t mipHeight = height;
-		uint32_t mipLevels = 1;
+		case DXGI_FORMAT_BC1_UNORM:  outFormat = Format::BC1;  return true;
+		case DXGI_FORMAT_BC3_UNORM:  outFormat = Format::BC3;  return true;
+		case DXGI_FORMAT_BC4_UNORM:  outFormat = Format::BC4;  return true;
+		case DXGI_FORMAT_BC5_UNORM:  outFormat = Format::BC5;  return true;
+		case DXGI_FORMAT_BC6H_UF16:  outFormat = Format::BC6H; return true;
+		case DXGI_FORMAT_BC7_UNORM:  outFormat = Format::BC7;  return true;
 
-		while(mipWidth > 1 || mipHeight > 1)
-		{
-			if(mipWidth > 1)
-			{
-				mipWidth >>= 1;
-			}
+		default:
+			break;
+	}
 
-			if(mipHeight > 1)
-			{
-				mipHeight >>= 1;
-			}
+	return false;
+}
 
-			++mipLevels;
-		}
+//---------------------------------------------------------------------------------------------------------------------
 
-		return mipLevels;
-	};
+static bool CompressImages(
+	const DirectX::Image* const pImages,
+	const size_t imageCount,
+	const DXGI_FORMAT compressedFormat,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	DemoFramework::Utility::ThreadPool* const pThreadPool,
+	DirectX::ScratchImage& output,
+	DemoFramework::Utility::BlockCompressor::Stats& outStats)
+{
+	using namespace DemoFramework::Utility;
 
-	const uint32_t mipLevelMaxCount = calculateMipLevelMaxCount();
-	const uint32_t mipLevelCount = (mipCount < mipLevelMaxCount) ? mipCount : mipLevelMaxCount;
+	BlockCompressor::Format format;
 
-	auto alignStagingDataPitch = [](const uint32_t basePitch) -> uint32_t
+	if(!GetCompressorFormat(compressedFormat, format))
 	{
-		return (basePitch + (D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1)) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
-	};
+		return false;
+	}
 
-	auto alignStagingDataPlacement = [](const uint32_t levelOffset) -> uint32_t
+	const HRESULT initResult = output.Initialize2D(compressedFormat, pImages[0].width, pImages[0].height, 1, imageCount);
+	if(FAILED(initResult))
 	{
-		return (levelOffset + (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1)) & ~(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
-	};
+		LOG_ERROR("Failed to allocate block-compressed image: result=0x%08" PRIX32, initResult);
+		return false;
+	}
 
-	DirectX::Image baseImage;
-	baseImage.width = size_t(width);
-	baseImage.height = size_t(height);
-	baseImage.format = format;
-	baseImage.rowPitch = size_t(width * channelCount * channelSize);
-	baseImage.slicePitch = baseImage.height * baseImage.rowPitch;
-	baseImage.pixels = reinterpret_cast<uint8_t*>(pImgData);
+	outStats.squaredError = 0.0;
+	outStats.sampleCount = 0;
 
-	const uint32_t desiredWidth = Math::GetPowerOfTwo(width);
-	const uint32_t desiredHeight = Math::GetPowerOfTwo(height);
+	for(size_t imageIndex = 0; imageIndex < imageCount; ++imageIndex)
+	{
+		const DirectX::Image& srcImage = pImages[imageIndex];
+		const DirectX::Image* const pDstImage = output.GetImage(imageIndex, 0, 0);
 
-	DirectX::ScratchImage resizedImage;
+		const ImageResampler::ConstImage src =
+		{
+			srcImage.pixels,          // const uint8_t* pData
+			srcImage.rowPitch,        // size_t rowPitch
+			uint32_t(srcImage.width), // uint32_t width
+			uint32_t(srcImage.height) // uint32_t height
+		};
 
-	// Textures need to be power-of-2, so resize the image if necessary.
-	if(width != desiredWidth || height != desiredHeight)
-	{
-		const HRESULT resizeImageResult = DirectX::Resize(baseImage, desiredWidth, desiredHeight, DirectX::TEX_FILTER_CUBIC, resizedImage);
-		if(FAILED(resizeImageResult))
+		BlockCompressor::Stats imageStats;
+
+		if(!BlockCompressor::Compress(src, format, quality, pDstImage->pixels, pDstImage->rowPitch, pThreadPool, &imageStats))
 		{
-			LOG_ERROR("Failed to resize Texture2D base image: result=0x%08" PRIX32, resizeImageResult);
-			return Ptr();
+			return false;
 		}
 
-		// Overwrite the image properties with the resized copy.
-		baseImage = *resizedImage.GetImage(0, 0, 0);
+		outStats.squaredError += imageStats.squaredError;
+		outStats.sampleCount += imageStats.sampleCount;
 	}
 
-	DirectX::ScratchImage mipChain;
+	return true;
+}
 
-	if(mipLevelCount > 1)
+//---------------------------------------------------------------------------------------------------------------------
+
+static DemoFramework::Utility::TextureFootprint::FormatInfo GetFootprintFormatInfo(const DXGI_FORMAT format)
+{
+	const uint32_t bitsPerPixel = uint32_t(DirectX::BitsPerPixel(format));
+
+	DemoFramework::Utility::TextureFootprint::FormatInfo output;
+
+	if(DirectX::IsCompressed(format))
 	{
-		// Generate the mip chain up to the selected number of mip levels.
-		const HRESULT generateMipsResult = DirectX::GenerateMipMaps(baseImage, DirectX::TEX_FILTER_BOX, size_t(mipLevelCount), mipChain);
-		if(FAILED(generateMipsResult))
-		{
-			LOG_ERROR("Failed to generate Texture2D mipmaps: result=0x%08" PRIX32, generateMipsResult);
-			return Ptr();
-		}
+		// Every block-compressed format uses 4x4 texel blocks.
+		output.blockWidth = 4;
+		output.blockHeight = 4;
+		output.bytesPerBlock = (bitsPerPixel * 16) / 8;
 	}
 	else
 	{
-		// There is only a single mip level, so we can initialize the mip chain from just the base image.
-		mipChain.InitializeFromImage(baseImage);
+		output.blockWidth = 1;
+		output.blockHeight = 1;
+		output.bytesPerBlock = bitsPerPixel / 8;
 	}
 
-	// Free the original image data now that we no longer need it.
-	stbi_image_free(pImgData);
+	return output;
+}
 
-	// If there is a resized image, we can release its held resources now.
-	resizedImage.Release();
+//---------------------------------------------------------------------------------------------------------------------
+
+static DemoFramework::Utility::ImageResampler::Format GetResamplerFormat(
+	const DemoFramework::D3D12::Texture2D::DataType dataType,
+	const DemoFramework::D3D12::Texture2D::Channel channel)
+{
+	using namespace DemoFramework::D3D12;
+	using Format = DemoFramework::Utility::ImageResampler::Format;
 
-	auto calculateStagingDataSize = [
-		&width,
-		&height,
-		&channelCount,
-		&channelSize,
-		&mipLevelCount,
-		alignStagingDataPitch,
-		alignStagingDataPlacement]() -> uint32_t
+	// Half float and shared exponent images are always RGBA.
+	switch(dataType)
 	{
-		const uint32_t texelSize = channelSize * channelCount;
+		case Texture2D::DataType::HalfFloat:      return Format::RGBA16Float;
+		case Texture2D::DataType::SharedExponent: return Format::RGB9E5;
 
-		uint32_t mipWidth = width;
-		uint32_t mipHeight = height;
+		default:
+			break;
+	}
 
-		uint32_t totalSize = 0;
+	const bool isFloat = (dataType == Texture2D::DataType::Float);
 
-		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
-		{
-			// Adjust the total size by the required alignment of the current level offset.
-			totalSize = alignStagingDataPlacement(totalSize);
+	switch(channel)
+	{
+		case Texture2D::Channel::L:  return isFloat ? Format::R32Float : Format::R8Unorm;
+		case Texture2D::Channel::LA: return isFloat ? Format::RG32Float : Format::RG8Unorm;
 
-			const uint32_t rowPitch = alignStagingDataPitch(mipWidth * texelSize);
-			const uint32_t levelSize = mipHeight * rowPitch;
+		default:
+			break;
+	}
 
-			totalSize += levelSize;
+	return isFloat ? Format::RGBA32Float : Format::RGBA8Unorm;
+}
 
-			if(mipWidth > 1)
-			{
-				mipWidth >>= 1;
-			}
+//---------------------------------------------------------------------------------------------------------------------
 
-			if(mipHeight > 1)
-			{
-				mipHeight >>= 1;
-			}
-		}
+static uint64_t ComputeStagingLayout(
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT* const pOutLayouts,
+	UINT* const pOutRowCounts,
+	UINT64* const pOutRowSizes)
+{
+	DemoFramework::Utility::TextureFootprint::Subresource footprints[D3D12_REQ_MIP_LEVELS];
 
-		return totalSize;
-	};
+	const uint64_t totalSize = DemoFramework::Utility::TextureFootprint::Compute(
+		GetFootprintFormatInfo(format),
+		width,
+		height,
+		mipCount,
+		footprints);
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount && totalSize > 0; ++mipIndex)
+	{
+		const DemoFramework::Utility::TextureFootprint::Subresource& footprint = footprints[mipIndex];
 
-	const uint32_t stagingTotalSize = calculateStagingDataSize();
+		pOutLayouts[mipIndex].Offset = footprint.offset;
+		pOutLayouts[mipIndex].Footprint.Format = format;
+		pOutLayouts[mipIndex].Footprint.Width = footprint.width;
+		pOutLayouts[mipIndex].Footprint.Height = footprint.height;
+		pOutLayouts[mipIndex].Footprint.Depth = 1;
+		pOutLayouts[mipIndex].Footprint.RowPitch = footprint.rowPitch;
 
-	constexpr D3D12_HEAP_PROPERTIES gpuHeapProps =
+		pOutRowCounts[mipIndex] = footprint.rowCount;
+		pOutRowSizes[mipIndex] = footprint.rowSize;
+	}
+
+	return totalSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void CopyToStaging(
+	uint8_t* const pStagingData,
+	const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout,
+	const UINT rowCount,
+	const UINT64 rowSize,
+	const uint8_t* const pSrcData,
+	const uint64_t srcRowPitch)
+{
+	uint8_t* const pStagingMip = pStagingData + layout.Offset;
+
+	if(srcRowPitch == layout.Footprint.RowPitch)
 	{
-		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
-		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
-		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
-		0,                               // UINT CreationNodeMask
-		0,                               // UINT VisibleNodeMask
-	};
+		// The staging texture and image data both have the same pitch, meaning we can copy all the data in one batch.
+		memcpy(pStagingMip, pSrcData, size_t((uint64_t(layout.Footprint.RowPitch) * (rowCount - 1)) + rowSize));
+	}
+	else
+	{
+		// The input image and staging texture have different row pitches, so we'll need to copy the data for one row at a time.
+		for(uint32_t row = 0; row < rowCount; ++row)
+		{
+			memcpy(
+				pStagingMip + (uint64_t(layout.Footprint.RowPitch) * row),
+				pSrcData + (srcRowPitch * row),
+				size_t(rowSize));
+		}
+	}
+}
 
-	constexpr D3D12_HEAP_PROPERTIES uploadHeapProps =
+//---------------------------------------------------------------------------------------------------------------------
+
+static DemoFramework::D3D12::Resource::Ptr CreateCachedStagingBuffer(
+	const DemoFramework::D3D12::Device::Ptr& device,
+	const uint64_t size,
+	uint8_t** const ppOutData)
+{
+	// Upload heaps are write-combined, which makes reading them back from the CPU extremely slow. Mip generation reads
+	// each level back to produce the next one, so images processed in place get their staging memory from buffers in
+	// cached system memory instead. The GPU reads them over the bus the same way it would read an upload heap.
+	constexpr D3D12_HEAP_PROPERTIES cachedHeapProps =
 	{
-		D3D12_HEAP_TYPE_UPLOAD,          // D3D12_HEAP_TYPE Type
-		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
-		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
-		0,                               // UINT CreationNodeMask
-		0,                               // UINT VisibleNodeMask
+		D3D12_HEAP_TYPE_CUSTOM,             // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_L0,               // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                                  // UINT CreationNodeMask
+		0,                                  // UINT VisibleNodeMask
 	};
 
 	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
@@ -273,25 +317,11 @@ DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::Load(
 		0, // UINT Quality
 	};
 
-	const D3D12_RESOURCE_DESC gpuResDesc =
-	{
-		D3D12_RESOURCE_DIMENSION_TEXTURE2D, // D3D12_RESOURCE_DIMENSION Dimension
-		0,                                  // UINT64 Alignment
-		uint64_t(width),                    // UINT64 Width
-		height,                             // UINT Height
-		1,                                  // UINT16 DepthOrArraySize
-		uint16_t(mipLevelCount),            // UINT16 MipLevels
-		format,                             // DXGI_FORMAT Format
-		defaultSampleDesc,                  // DXGI_SAMPLE_DESC SampleDesc
-		D3D12_TEXTURE_LAYOUT_UNKNOWN,       // D3D12_TEXTURE_LAYOUT Layout
-		D3D12_RESOURCE_FLAG_NONE,           // D3D12_RESOURCE_FLAGS Flags
-	};
-
 	const D3D12_RESOURCE_DESC stagingResDesc =
 	{
 		D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
 		0,                               // UINT64 Alignment
-		uint64_t(stagingTotalSize),      // UINT64 Width
+		size,                            // UINT64 Width
 		1,                               // UINT Height
 		1,                               // UINT16 DepthOrArraySize
 		1,                               // UINT16 MipLevels
@@ -301,143 +331,2639 @@ DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::Load(
 		D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
 	};
 
-	constexpr D3D12_RANGE disableCpuReadRange =
-	{
-		0, // SIZE_T Begin
-		0, // SIZE_T End
-	};
-
-	// Create the staging texture resource.
-	Resource::Ptr stagingTexture = CreateCommittedResource(
+	DemoFramework::D3D12::Resource::Ptr stagingBuffer = DemoFramework::D3D12::CreateCommittedResource(
 		device,
 		stagingResDesc,
-		uploadHeapProps,
+		cachedHeapProps,
 		D3D12_HEAP_FLAG_NONE,
 		D3D12_RESOURCE_STATE_GENERIC_READ);
-	if(!stagingTexture)
+	if(!stagingBuffer)
 	{
-		return Ptr();
+		return DemoFramework::D3D12::Resource::Ptr();
 	}
 
-	// Create the GPU-resident texture resource.
-	Resource::Ptr gpuTexture = CreateCommittedResource(
-		device,
-		gpuResDesc,
-		gpuHeapProps,
-		D3D12_HEAP_FLAG_NONE,
-		D3D12_RESOURCE_STATE_COPY_DEST);
-	if(!gpuTexture)
+	constexpr D3D12_RANGE disableCpuReadRange =
 	{
-		return Ptr();
-	}
-
-	D3D12_TEXTURE_COPY_LOCATION srcLoc;
-	srcLoc.pResource = stagingTexture.Get();
-	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-	srcLoc.PlacedFootprint.Footprint.Format = format;
-
-	D3D12_TEXTURE_COPY_LOCATION destLoc;
-	destLoc.pResource = gpuTexture.Get();
-	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-
-	void* pStagingData = nullptr;
-
-	// Map the staging texture.
-	const HRESULT mapResult = stagingTexture->Map(0, &disableCpuReadRange, &pStagingData);
-	assert(SUCCEEDED(mapResult)); (void) mapResult;
-
-	uint32_t outputOffset = 0;
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
 
-	// Copy each mip level of the input image to the staging texture.
-	for(uint32_t mipIndex = 0; mipIndex < uint32_t(gpuResDesc.MipLevels); ++mipIndex)
+	// Map the staging buffer.
+	const HRESULT mapResult = stagingBuffer->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(ppOutData));
+	if(FAILED(mapResult))
 	{
-		const DirectX::Image* const pMipImage = mipChain.GetImage(mipIndex, 0, 0);
-
-		const uint32_t stagingPitch = alignStagingDataPitch(uint32_t(pMipImage->rowPitch));
+		LOG_ERROR("Failed to map Texture2D staging buffer: result=0x%08" PRIX32, mapResult);
+		return DemoFramework::D3D12::Resource::Ptr();
+	}
 
-		// Correct the current mip level's staging offset since the end of the
-		// last level may not be packed against the start of the current level.
-		outputOffset = alignStagingDataPlacement(outputOffset);
+	return stagingBuffer;
+}
 
-		srcLoc.PlacedFootprint.Offset = outputOffset;
-		srcLoc.PlacedFootprint.Footprint.Width = uint32_t(pMipImage->width);
-		srcLoc.PlacedFootprint.Footprint.Height = uint32_t(pMipImage->height);
-		srcLoc.PlacedFootprint.Footprint.Depth = 1;
-		srcLoc.PlacedFootprint.Footprint.RowPitch = stagingPitch;
+//---------------------------------------------------------------------------------------------------------------------
 
-		destLoc.SubresourceIndex = mipIndex;
+static bool LoadHdrImage(
+	const char* const filePath,
+	const DemoFramework::Utility::HdrDecoder::Format format,
+	uint32_t& outWidth,
+	uint32_t& outHeight,
+	std::vector<uint8_t>& outImage)
+{
+	using namespace DemoFramework::Utility;
 
-		if(pMipImage->rowPitch != stagingPitch)
-		{
-			// The input image and staging texture have different row pitches, so we'll need to copy the data for one row at a time.
-			for(size_t y = 0; y < size_t(pMipImage->height); ++y)
-			{
-				const size_t inputOffset = y * pMipImage->rowPitch;
+	Stopwatch stopwatch;
 
-				memcpy(
-					reinterpret_cast<uint8_t*>(pStagingData) + outputOffset,
-					pMipImage->pixels + inputOffset,
-					pMipImage->rowPitch);
+	const MappedFile::Ptr file = MappedFile::Open(filePath);
+	if(!file)
+	{
+		LOG_ERROR("Failed to open image file: %s", filePath);
+		return false;
+	}
 
-				// Update the staging data offset.
-				outputOffset += stagingPitch;
-			}
-		}
-		else
-		{
-			// The staging texture and image data both have the same pitch, meaning we can copy all the data in one batch.
-			memcpy(reinterpret_cast<uint8_t*>(pStagingData) + outputOffset, pMipImage->pixels, pMipImage->slicePitch);
+	const uint8_t* const pFileData = file->GetData();
+	const size_t fileSize = size_t(file->GetSize());
 
-			// Update the staging data offset.
-			outputOffset += uint32_t(pMipImage->slicePitch);
-		}
+	HdrDecoder::Header header;
 
-		// Copy the staging data to the GPU-resident texture.
-		uploadCmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+	if(!HdrDecoder::ReadHeader(pFileData, fileSize, header))
+	{
+		LOG_ERROR("Image file is not a supported Radiance HDR image: %s", filePath);
+		return false;
 	}
 
-	// Unmap the staging texture.
-	stagingTexture->Unmap(0, nullptr);
+	const size_t rowPitch = size_t(header.width) * HdrDecoder::GetTexelSize(format);
 
-	// Release the mip chain now that all of its data has been copied into the staging image.
-	mipChain.Release();
+	outImage.resize(rowPitch * size_t(header.height));
 
-	D3D12_RESOURCE_BARRIER barrier;
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource = gpuTexture.Get();
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	if(!HdrDecoder::Decode(pFileData, fileSize, header, format, outImage.data(), rowPitch, ThreadPool::GetShared()))
+	{
+		LOG_ERROR("Failed to decode HDR image file: %s", filePath);
+		outImage.clear();
+		return false;
+	}
 
-	uploadCmdList->ResourceBarrier(1, &barrier);
+	outWidth = header.width;
+	outHeight = header.height;
+
+	// Compare against the RGBA32 float image the same file would have been expanded to when decoded by stb_image.
+	LOG_WRITE(
+		"Decoded HDR image: path=\"%s\", size=%" PRIu32 "x%" PRIu32 ", format=%s, time=%.2fms, decodedSize=%zu, float32Size=%zu",
+		filePath,
+		header.width,
+		header.height,
+		(format == HdrDecoder::Format::RGB9E5) ? "RGB9E5" : "RGBA16Float",
+		stopwatch.GetElapsedMs(),
+		outImage.size(),
+		size_t(header.width) * size_t(header.height) * sizeof(float32_t) * 4);
+
+	return true;
+}
 
-	const Descriptor descriptor = srvAlloc->Allocate();
+//---------------------------------------------------------------------------------------------------------------------
 
+static void CreateTextureSrv(
+	const DemoFramework::D3D12::Device::Ptr& device,
+	const DemoFramework::D3D12::Resource::Ptr& resource,
+	const DXGI_FORMAT format,
+	const uint32_t mipCount,
+	const uint32_t residentMip,
+	const DemoFramework::D3D12::Descriptor& descriptor)
+{
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
-	srvDesc.Format = gpuResDesc.Format;
+	srvDesc.Format = format;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.Texture2D.MostDetailedMip = 0;
-	srvDesc.Texture2D.MipLevels = uint32_t(gpuResDesc.MipLevels);
+	srvDesc.Texture2D.MipLevels = mipCount;
 	srvDesc.Texture2D.PlaneSlice = 0;
-	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+	srvDesc.Texture2D.ResourceMinLODClamp = float(residentMip);
 
-	// Create the SRV from the resource.
-	device->CreateShaderResourceView(gpuTexture.Get(), &srvDesc, descriptor.cpuHandle);
+	device->CreateShaderResourceView(resource.Get(), &srvDesc, descriptor.cpuHandle);
+}
 
-	Ptr output = std::make_shared<Texture2D>();
+//---------------------------------------------------------------------------------------------------------------------
 
-	output->m_resource = gpuTexture;
-	output->m_staging = stagingTexture;
-	output->m_alloc = srvAlloc;
-	output->m_descriptor = descriptor;
-	output->m_width = width;
-	output->m_height = height;
-	output->m_mipCount = mipLevelCount;
-	output->m_format = format;
+static uint32_t GetStreamTailMip(
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	const uint32_t tailSize)
+{
+	using namespace DemoFramework::Utility;
 
-	return output;
+	uint32_t tailMip = 0;
+
+	// The tail starts at the first mip that fits within the tail size on both axes.
+	while((tailMip + 1) < mipCount
+		&& (TextureFootprint::GetMipDimension(width, tailMip) > tailSize
+			|| TextureFootprint::GetMipDimension(height, tailMip) > tailSize))
+	{
+		++tailMip;
+	}
+
+	return tailMip;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static D3D12_RESOURCE_DESC GetTextureResourceDesc(
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	const uint32_t firstMip)
+{
+	using namespace DemoFramework::Utility;
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	// A texture with its first mips dropped is the same as a texture created at the size of its first resident mip.
+	const uint32_t mipWidth = TextureFootprint::GetMipDimension(width, firstMip);
+	const uint32_t mipHeight = TextureFootprint::GetMipDimension(height, firstMip);
+
+	const D3D12_RESOURCE_DESC resDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_TEXTURE2D, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                  // UINT64 Alignment
+		uint64_t(mipWidth),                 // UINT64 Width
+		mipHeight,                          // UINT Height
+		1,                                  // UINT16 DepthOrArraySize
+		uint16_t(mipCount - firstMip),      // UINT16 MipLevels
+		format,                             // DXGI_FORMAT Format
+		defaultSampleDesc,                  // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_UNKNOWN,       // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,           // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	return resDesc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// State shared between a streamed texture and the background job processing its mips. The job writes each finished
+// mip straight into the texture's dedicated staging buffer, then publishes it by lowering 'readyMip'. When the job
+// can't process the rest of the mips, it sets 'failed' instead, and the texture stops streaming at whichever mips
+// made it to the GPU.
+struct DemoFramework::D3D12::Texture2D::StreamJob
+{
+	StreamJob();
+	~StreamJob();
+
+	void* pSourceImage;
+	std::vector<uint8_t> hdrImage;
+
+	Utility::ImageResampler::ConstImage source;
+	Utility::ImageResampler::Format resampleFormat;
+	Utility::ImageResampler::Filter resizeFilter;
+	Utility::ImageResampler::Filter mipFilter;
+
+	DXGI_FORMAT format;
+	DXGI_FORMAT textureFormat;
+
+	Utility::BlockCompressor::Quality compressQuality;
+
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipCount;
+	uint32_t tailMip;
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[D3D12_REQ_MIP_LEVELS];
+	UINT rowCounts[D3D12_REQ_MIP_LEVELS];
+	UINT64 rowSizes[D3D12_REQ_MIP_LEVELS];
+
+	Resource::Ptr staging;
+	uint8_t* pStagingData;
+
+	std::atomic<uint32_t> readyMip;
+	std::atomic<bool> cancel;
+	std::atomic<bool> failed;
+
+	char filePath[MAX_PATH];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Texture side of the streaming state; only ever touched from the thread calling Stream().
+struct DemoFramework::D3D12::Texture2D::StreamData
+{
+	Device::Ptr device;
+	UploadRing::Ptr uploadRing;
+	std::shared_ptr<StreamJob> job;
+
+	Utility::MipStreamScheduler scheduler;
+
+	// Lowest mip index handed to the scheduler so far.
+	uint32_t queuedMip;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Output of the CPU side of loading a texture, ready to have its upload recorded. The texel data lives in whichever of
+// the cache entry, the mip chains or the stream job produced it.
+struct DemoFramework::D3D12::Texture2D::ProcessedImage
+{
+	ProcessedImage();
+
+	void Release();
+
+	// Get the part of the staging buffer holding mips [firstMip, mipCount).
+	UploadRing::Allocation GetStaging(uint32_t firstMip) const;
+
+	TextureCache::Entry cacheEntry;
+
+	DirectX::ScratchImage mipChain;
+	DirectX::ScratchImage compressedChain;
+
+	std::shared_ptr<StreamJob> streamJob;
+
+	// Staging buffer the image was processed in, already laid out the way the upload copies read it. When set, the
+	// subresources point into it.
+	Resource::Ptr staging;
+	UploadRing::Allocation stagingAllocation;
+
+	SubresourceData subresources[D3D12_REQ_MIP_LEVELS];
+
+	DXGI_FORMAT format;
+
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipCount;
+
+	// Bytes of texel data copied around on the CPU, not counting decoding, resampling or compression.
+	uint64_t copiedSize;
+
+	float64_t processTime;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// State shared between a texture being restored and the background job reloading it. The job owns the image until
+// it publishes it by setting 'done'.
+struct DemoFramework::D3D12::Texture2D::RestoreJob
+{
+	RestoreJob();
+
+	ProcessedImage image;
+
+	std::atomic<bool> done;
+	bool succeeded;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Texture side of a restore; only ever touched from the thread driving the residency change.
+struct DemoFramework::D3D12::Texture2D::RestoreData
+{
+	std::shared_ptr<RestoreJob> job;
+
+	Utility::Stopwatch stopwatch;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cached staging memory for images to be processed in. Rather than every image getting a committed buffer of its own,
+// the images of a load are carved out of a few large blocks in the order they ask for them. Allocations are never
+// freed individually; each block stays alive for as long as an image placed in it holds a reference, and the images
+// hand their references to the upload ring once their copies are recorded, so the block is released with the fence.
+struct DemoFramework::D3D12::Texture2D::StagingArena
+{
+	struct Block
+	{
+		Resource::Ptr resource;
+		uint8_t* pData;
+
+		uint64_t size;
+		uint64_t usedSize;
+	};
+
+	// A block size of zero gives every allocation a block sized exactly to it.
+	StagingArena(const Device::Ptr& device, uint64_t blockSize);
+
+	// Thread-safe, since the images of a batch are processed on pool workers.
+	bool Allocate(uint64_t size, UploadRing::Allocation& outAllocation, Resource::Ptr& outResource);
+
+	Device::Ptr device;
+
+	std::mutex mutex;
+	std::vector<Block> blocks;
+
+	uint64_t blockSize;
+	uint64_t allocatedSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Everything needed to load a texture again after it has been evicted.
+struct DemoFramework::D3D12::Texture2D::LoadSource
+{
+	DataType dataType;
+	Channel channel;
+
+	LoadOptions options;
+
+	char filePath[MAX_PATH];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::StreamJob::StreamJob()
+	: pSourceImage(nullptr)
+	, hdrImage()
+	, source()
+	, resampleFormat(Utility::ImageResampler::Format::RGBA8Unorm)
+	, resizeFilter(Utility::ImageResampler::Filter::Lanczos)
+	, mipFilter(Utility::ImageResampler::Filter::Box)
+	, format(DXGI_FORMAT_UNKNOWN)
+	, textureFormat(DXGI_FORMAT_UNKNOWN)
+	, compressQuality(Utility::BlockCompressor::Quality::Quality)
+	, width(0)
+	, height(0)
+	, mipCount(0)
+	, tailMip(0)
+	, layouts()
+	, rowCounts()
+	, rowSizes()
+	, staging()
+	, pStagingData(nullptr)
+	, readyMip(0)
+	, cancel(false)
+	, failed(false)
+	, filePath()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::StreamJob::~StreamJob()
+{
+	if(pSourceImage)
+	{
+		stbi_image_free(pSourceImage);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::ProcessedImage::ProcessedImage()
+	: cacheEntry()
+	, mipChain()
+	, compressedChain()
+	, streamJob()
+	, staging()
+	, stagingAllocation()
+	, subresources()
+	, format(DXGI_FORMAT_UNKNOWN)
+	, width(0)
+	, height(0)
+	, mipCount(0)
+	, copiedSize(0)
+	, processTime(0.0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::Texture2D::ProcessedImage::Release()
+{
+	cacheEntry = TextureCache::Entry();
+	mipChain.Release();
+	compressedChain.Release();
+	streamJob.reset();
+	staging = Resource::Ptr();
+	stagingAllocation = UploadRing::Allocation();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::UploadRing::Allocation DemoFramework::D3D12::Texture2D::ProcessedImage::GetStaging(const uint32_t firstMip) const
+{
+	assert(staging);
+	assert(firstMip < mipCount);
+
+	const uint64_t mipOffset = uint64_t(subresources[firstMip].pData - stagingAllocation.pData);
+
+	UploadRing::Allocation output = stagingAllocation;
+
+	output.pData += mipOffset;
+	output.offset += mipOffset;
+	output.size -= mipOffset;
+	output.gpuAddress += mipOffset;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::StagingArena::StagingArena(const Device::Ptr& device, const uint64_t blockSize)
+	: device(device)
+	, mutex()
+	, blocks()
+	, blockSize(blockSize)
+	, allocatedSize(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::StagingArena::Allocate(
+	const uint64_t size,
+	UploadRing::Allocation& outAllocation,
+	Resource::Ptr& outResource)
+{
+	using namespace DemoFramework::Utility;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	size_t blockIndex = blocks.size();
+	uint64_t offset = 0;
+
+	if(!blocks.empty())
+	{
+		offset = Math::GetAlignedSize(blocks.back().usedSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+
+		if(offset + size <= blocks.back().size)
+		{
+			blockIndex = blocks.size() - 1;
+		}
+	}
+
+	if(blockIndex == blocks.size())
+	{
+		Block block;
+
+		block.size = (size > blockSize) ? size : blockSize;
+		block.usedSize = 0;
+		block.resource = CreateCachedStagingBuffer(device, block.size, &block.pData);
+		if(!block.resource)
+		{
+			return false;
+		}
+
+		allocatedSize += block.size;
+
+		// Allocations too big for a regular block get one of their own without taking the place of the current block.
+		if(size >= blockSize && !blocks.empty())
+		{
+			blocks.insert(blocks.end() - 1, block);
+			blockIndex = blocks.size() - 2;
+		}
+		else
+		{
+			blocks.push_back(block);
+		}
+
+		offset = 0;
+	}
+
+	Block& block = blocks[blockIndex];
+
+	block.usedSize = offset + size;
+
+	outAllocation.pResource = block.resource.Get();
+	outAllocation.pData = block.pData + offset;
+	outAllocation.offset = offset;
+	outAllocation.size = size;
+	outAllocation.gpuAddress = block.resource->GetGPUVirtualAddress() + offset;
+
+	outResource = block.resource;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::RestoreJob::RestoreJob()
+	: image()
+	, done(false)
+	, succeeded(false)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::Load(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const DataType dataType,
+	const Channel channel,
+	const char* const filePath,
+	const uint32_t mipCount)
+{
+	LoadOptions options;
+	options.mipCount = mipCount;
+
+	return Load(device, uploadCmdList, uploadRing, srvAlloc, dataType, channel, filePath, options);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::Load(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const DataType dataType,
+	const Channel channel,
+	const char* const filePath,
+	const LoadOptions& options)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device || !uploadCmdList || !uploadRing || !srvAlloc || !filePath || filePath[0] == '\0' || options.mipCount == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Stopwatch stopwatch;
+
+	// A single image has no one to share staging memory with, so it gets a buffer sized exactly to it.
+	StagingArena stagingArena(device, 0);
+
+	ProcessedImage image;
+
+	if(!_processImage(device, dataType, channel, filePath, options, &stagingArena, image))
+	{
+		return Ptr();
+	}
+
+	Ptr output = _createProcessed(device, uploadCmdList, uploadRing, options.chunkedUploader, srvAlloc, image, nullptr);
+	if(!output)
+	{
+		return Ptr();
+	}
+
+	output->_setSource(dataType, channel, filePath, options);
+
+	LOG_WRITE(
+		"Loaded Texture2D: path=\"%s\", time=%.2fms, copiedSize=%" PRIu64,
+		filePath,
+		stopwatch.GetElapsedMs(),
+		image.copiedSize);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::LoadMany(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const LoadRequest* const pRequests,
+	const size_t requestCount,
+	Ptr* const pOutTextures)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device || !uploadCmdList || !uploadRing || !srvAlloc || !pRequests || requestCount == 0 || !pOutTextures)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	for(size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+	{
+		const LoadRequest& request = pRequests[requestIndex];
+
+		if(!request.filePath || request.filePath[0] == '\0' || request.options.mipCount == 0)
+		{
+			LOG_ERROR("Invalid parameter: requestIndex=%zu", requestIndex);
+			return false;
+		}
+	}
+
+	Stopwatch stopwatch;
+
+	std::vector<ProcessedImage> images(requestCount);
+	std::vector<uint8_t> processed(requestCount, 0);
+
+	// Images processed in place share a few large staging blocks instead of each getting a buffer of their own.
+	StagingArena stagingArena(device, DF_TEXTURE2D_STAGING_BLOCK_SIZE);
+
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	// Each image is processed entirely on one thread. The resampling and compression inside each task runs serially
+	// since it's called from a pool worker, so the batch scales with the number of images rather than their size.
+	pThreadPool->ParallelFor(
+		requestCount,
+		[&device, pRequests, &images, &processed, &stagingArena](const size_t requestIndex)
+		{
+			const LoadRequest& request = pRequests[requestIndex];
+
+			processed[requestIndex] = _processImage(
+				device,
+				request.dataType,
+				request.channel,
+				request.filePath,
+				request.options,
+				&stagingArena,
+				images[requestIndex]) ? 1 : 0;
+		});
+
+	const float64_t processTime = stopwatch.GetElapsedMs();
+
+	std::vector<uint64_t> stagingOffsets(requestCount, 0);
+
+	uint64_t stagingTotalSize = 0;
+	float64_t serialProcessTime = 0.0;
+
+	// Pack the staging data for every non-streamed texture into one block, each at the placement alignment D3D12
+	// requires for the start of a texture's data. Images that were processed in the batch's staging blocks are
+	// already laid out where their copies read from, and streamed textures keep their own staging buffers.
+	for(size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+	{
+		const ProcessedImage& image = images[requestIndex];
+
+		serialProcessTime += image.processTime;
+
+		if(!processed[requestIndex] || image.streamJob || image.staging)
+		{
+			continue;
+		}
+
+		const uint64_t stagingSize = TextureFootprint::Compute(
+			GetFootprintFormatInfo(image.format),
+			image.width,
+			image.height,
+			image.mipCount,
+			nullptr);
+
+		stagingOffsets[requestIndex] = Math::GetAlignedSize(stagingTotalSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+		stagingTotalSize = stagingOffsets[requestIndex] + stagingSize;
+	}
+
+	UploadRing::Allocation batchStaging = {};
+
+	const bool useBatchStaging = (stagingTotalSize > 0)
+		&& uploadRing->Allocate(stagingTotalSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, batchStaging);
+
+	if(stagingTotalSize > 0 && !useBatchStaging)
+	{
+		LOG_WRITE(
+			"(warning) Texture2D batch staging data does not fit in the upload ring; staging each texture separately: size=%" PRIu64 ", ringCapacity=%" PRIu64,
+			stagingTotalSize,
+			uploadRing->GetCapacity());
+	}
+
+	size_t loadedCount = 0;
+	uint64_t copiedSize = 0;
+
+	// Record the uploads in request order so the command list and descriptor allocation order are deterministic.
+	for(size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+	{
+		ProcessedImage& image = images[requestIndex];
+
+		pOutTextures[requestIndex] = Ptr();
+
+		if(!processed[requestIndex])
+		{
+			continue;
+		}
+
+		const bool useSharedStaging = useBatchStaging && !image.streamJob && !image.staging;
+
+		UploadRing::Allocation staging = batchStaging;
+
+		if(useSharedStaging)
+		{
+			staging.pData += stagingOffsets[requestIndex];
+			staging.offset += stagingOffsets[requestIndex];
+			staging.gpuAddress += stagingOffsets[requestIndex];
+			staging.size -= stagingOffsets[requestIndex];
+		}
+
+		pOutTextures[requestIndex] = _createProcessed(
+			device,
+			uploadCmdList,
+			uploadRing,
+			pRequests[requestIndex].options.chunkedUploader,
+			srvAlloc,
+			image,
+			useSharedStaging ? &staging : nullptr);
+
+		if(pOutTextures[requestIndex])
+		{
+			const LoadRequest& request = pRequests[requestIndex];
+
+			pOutTextures[requestIndex]->_setSource(request.dataType, request.channel, request.filePath, request.options);
+
+			++loadedCount;
+		}
+
+		copiedSize += image.copiedSize;
+
+		// The texel data has been copied to staging memory, so there's no reason to hold onto it for the rest of the batch.
+		image.Release();
+	}
+
+	const float64_t totalTime = stopwatch.GetElapsedMs();
+
+	// The sum of the per-image processing times is roughly what loading the batch one texture at a time would cost,
+	// so comparing it to the wall time of the parallel phase gives the speedup gained from the thread pool.
+	LOG_WRITE(
+		"Loaded Texture2D batch: count=%zu, loaded=%zu, threadCount=%" PRIu32 ", time=%.2fms, processTime=%.2fms, serialProcessTime=%.2fms, speedup=%.2fx, recordTime=%.2fms, stagingSize=%" PRIu64 ", cachedStagingSize=%" PRIu64 ", cachedStagingBlocks=%zu, copiedSize=%" PRIu64,
+		requestCount,
+		loadedCount,
+		pThreadPool->GetWorkerCount() + 1,
+		totalTime,
+		processTime,
+		serialProcessTime,
+		(processTime > 0.0) ? (serialProcessTime / processTime) : 1.0,
+		totalTime - processTime,
+		stagingTotalSize,
+		stagingArena.allocatedSize,
+		stagingArena.blocks.size(),
+		copiedSize);
+
+	return loadedCount == requestCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::~Texture2D()
+{
+	if(m_pStream)
+	{
+		// Let the background job know it can stop early. It holds its own reference to
+		// everything it writes to, so it's safe for it to still be running after this.
+		m_pStream->job->cancel = true;
+
+		// Copies recorded by Stream() may still be reading from the staging buffer.
+		m_pStream->uploadRing->DeferRelease(m_pStream->job->staging);
+
+		delete m_pStream;
+	}
+
+	if(m_pRestore)
+	{
+		// Nothing has been recorded from a reload still in flight, so the job is free to finish and release the image.
+		delete m_pRestore;
+	}
+
+	if(m_pSource)
+	{
+		delete m_pSource;
+	}
+
+	if(m_alloc)
+	{
+		m_alloc->Free(m_descriptor);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::Texture2D::GetParamHash(const DataType dataType, const Channel channel, const LoadOptions& options)
+{
+	using namespace DemoFramework::Utility;
+
+	uint64_t paramHash = Hash::Combine(DF_TEXTURE2D_CACHE_PARAM_VERSION, uint64_t(dataType));
+	paramHash = Hash::Combine(paramHash, uint64_t(channel));
+	paramHash = Hash::Combine(paramHash, uint64_t(options.mipCount));
+	paramHash = Hash::Combine(paramHash, options.blockCompress ? 1 : 0);
+	paramHash = Hash::Combine(paramHash, uint64_t(options.resizeFilter));
+	paramHash = Hash::Combine(paramHash, uint64_t(options.mipFilter));
+	paramHash = Hash::Combine(paramHash, options.keepDimensions ? 1 : 0);
+	paramHash = Hash::Combine(paramHash, uint64_t(options.compressedFormat));
+	paramHash = Hash::Combine(paramHash, uint64_t(options.compressQuality));
+
+	return paramHash;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::Texture2D::Stream(const GraphicsCommandList::Ptr& cmdList, const uint64_t byteBudget)
+{
+	if(!m_pStream || !cmdList)
+	{
+		return 0;
+	}
+
+	StreamData& stream = *m_pStream;
+	StreamJob& job = *stream.job;
+
+	if(job.failed.load(std::memory_order_acquire))
+	{
+		// The job won't publish any more mips, so stop streaming with the clamp left at the last fully uploaded mip
+		// (never above the tail mip, which was uploaded with the texture). Letting go of the stream also lets the
+		// residency manager trim or evict the texture again.
+		LOG_ERROR(
+			"Stopped streaming Texture2D after a processing failure: path=\"%s\", residentMip=%" PRIu32,
+			job.filePath,
+			m_residentMip);
+
+		// The job has already returned, but copies recorded by earlier calls may still be reading from the staging
+		// buffer.
+		stream.uploadRing->DeferRelease(job.staging);
+		job.staging = Resource::Ptr();
+
+		delete m_pStream;
+		m_pStream = nullptr;
+
+		return 0;
+	}
+
+	// Queue any mips the background job has finished since the last call.
+	const uint32_t readyMip = job.readyMip.load(std::memory_order_acquire);
+
+	while(stream.queuedMip > readyMip)
+	{
+		--stream.queuedMip;
+		stream.scheduler.MarkMipReady(stream.queuedMip);
+	}
+
+	Utility::MipStreamScheduler::RowCopy copies[D3D12_REQ_MIP_LEVELS];
+
+	const size_t copyCount = stream.scheduler.Update(byteBudget, copies, _countof(copies));
+
+	uint64_t bytesRecorded = 0;
+
+	if(copyCount > 0)
+	{
+		const Utility::TextureFootprint::FormatInfo formatInfo = GetFootprintFormatInfo(m_format);
+
+		D3D12_RESOURCE_BARRIER barriers[D3D12_REQ_MIP_LEVELS];
+
+		// Every mip is in the shader resource state while the texture is in use, so each mip
+		// being copied to needs to be transitioned to the copy destination state and back.
+		for(size_t copyIndex = 0; copyIndex < copyCount; ++copyIndex)
+		{
+			D3D12_RESOURCE_BARRIER& barrier = barriers[copyIndex];
+
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+			barrier.Transition.pResource = m_resource.Get();
+			barrier.Transition.Subresource = copies[copyIndex].mipIndex;
+			barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+			barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+		}
+
+		cmdList->ResourceBarrier(UINT(copyCount), barriers);
+
+		D3D12_TEXTURE_COPY_LOCATION srcLoc;
+		srcLoc.pResource = job.staging.Get();
+		srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+		D3D12_TEXTURE_COPY_LOCATION destLoc;
+		destLoc.pResource = m_resource.Get();
+		destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+		for(size_t copyIndex = 0; copyIndex < copyCount; ++copyIndex)
+		{
+			const Utility::MipStreamScheduler::RowCopy& copy = copies[copyIndex];
+			const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = job.layouts[copy.mipIndex];
+
+			const uint32_t mipWidth = Utility::TextureFootprint::GetMipDimension(m_width, copy.mipIndex);
+			const uint32_t mipHeight = Utility::TextureFootprint::GetMipDimension(m_height, copy.mipIndex);
+
+			// For block-compressed formats, the copied rows are rows of blocks. The box is allowed
+			// to end on a partial block only when it reaches the edge of the mip.
+			const uint32_t top = copy.firstRow * formatInfo.blockHeight;
+			const uint32_t bottom = (copy.firstRow + copy.rowCount) * formatInfo.blockHeight;
+
+			const D3D12_BOX srcBox =
+			{
+				0,                                         // UINT left
+				top,                                       // UINT top
+				0,                                         // UINT front
+				mipWidth,                                  // UINT right
+				(bottom < mipHeight) ? bottom : mipHeight, // UINT bottom
+				1,                                         // UINT back
+			};
+
+			srcLoc.PlacedFootprint = layout;
+			destLoc.SubresourceIndex = copy.mipIndex;
+
+			cmdList->CopyTextureRegion(&destLoc, 0, top, 0, &srcLoc, &srcBox);
+
+			bytesRecorded += uint64_t(layout.Footprint.RowPitch) * copy.rowCount;
+
+			// Flip the barrier around to transition the mip back.
+			barriers[copyIndex].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+			barriers[copyIndex].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		}
+
+		cmdList->ResourceBarrier(UINT(copyCount), barriers);
+	}
+
+	const uint32_t residentMip = stream.scheduler.GetResidentMip();
+
+	if(residentMip != m_residentMip)
+	{
+		// Lower the clamp to let the shaders sample the newly uploaded mips.
+		CreateTextureSrv(stream.device, m_resource, m_format, m_mipCount, residentMip, m_descriptor);
+
+		m_residentMip = residentMip;
+	}
+
+	if(stream.scheduler.IsFullyResident())
+	{
+		LOG_WRITE("Finished streaming Texture2D: path=\"%s\"", job.filePath);
+
+		// Every mip has been written by now, so the job is done with the staging buffer. It only
+		// needs to stay alive until the GPU is done with the copies recorded above.
+		stream.uploadRing->DeferRelease(job.staging);
+		job.staging = Resource::Ptr();
+
+		delete m_pStream;
+		m_pStream = nullptr;
+	}
+
+	return bytesRecorded;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::BeginResidencyChange(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const uint32_t residentMip)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device || !cmdList || !uploadRing || residentMip > m_mipCount)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	if(m_pStream || m_residencyPending)
+	{
+		LOG_ERROR("Cannot change the residency of a Texture2D while it is streaming or already changing residency");
+		return false;
+	}
+
+	if(residentMip == m_residentMip)
+	{
+		return true;
+	}
+
+	Resource::Ptr newResource;
+
+	if(residentMip == m_mipCount)
+	{
+		// Evicting the texture doesn't need anything on the GPU; the resource is released once the change completes.
+	}
+	else if(residentMip > m_residentMip)
+	{
+		constexpr D3D12_HEAP_PROPERTIES gpuHeapProps =
+		{
+			D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+			D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+			D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+			0,                               // UINT CreationNodeMask
+			0,                               // UINT VisibleNodeMask
+		};
+
+		// Committed resources can't give back part of their memory, so the mips being kept
+		// are copied into a new resource that is only big enough to hold them.
+		newResource = CreateCommittedResource(
+			device,
+			GetTextureResourceDesc(m_format, m_width, m_height, m_mipCount, residentMip),
+			gpuHeapProps,
+			D3D12_HEAP_FLAG_NONE,
+			D3D12_RESOURCE_STATE_COPY_DEST);
+		if(!newResource)
+		{
+			return false;
+		}
+
+		D3D12_RESOURCE_BARRIER barriers[2];
+
+		barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barriers[0].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barriers[0].Transition.pResource = m_resource.Get();
+		barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+		cmdList->ResourceBarrier(1, barriers);
+
+		D3D12_TEXTURE_COPY_LOCATION srcLoc;
+		srcLoc.pResource = m_resource.Get();
+		srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+		D3D12_TEXTURE_COPY_LOCATION destLoc;
+		destLoc.pResource = newResource.Get();
+		destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+		// Subresource indices in both resources are relative to their own first resident mip.
+		for(uint32_t mipIndex = residentMip; mipIndex < m_mipCount; ++mipIndex)
+		{
+			srcLoc.SubresourceIndex = mipIndex - m_residentMip;
+			destLoc.SubresourceIndex = mipIndex - residentMip;
+
+			cmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+		}
+
+		// Frames still queued on the GPU keep sampling the old resource, so it goes back to the shader resource state.
+		barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+		barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+		barriers[1] = barriers[0];
+		barriers[1].Transition.pResource = newResource.Get();
+		barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+
+		cmdList->ResourceBarrier(2, barriers);
+	}
+	else
+	{
+		if(!m_pSource)
+		{
+			LOG_ERROR("Cannot restore a Texture2D that was not loaded from a file");
+			return false;
+		}
+
+		// The whole mip chain needs to be in memory before it can be uploaded, so there's nothing to gain from streaming it.
+		LoadOptions options = m_pSource->options;
+		options.stream = false;
+
+		const std::shared_ptr<RestoreJob> job = std::make_shared<RestoreJob>();
+
+		const DataType dataType = m_pSource->dataType;
+		const Channel channel = m_pSource->channel;
+
+		char filePath[MAX_PATH];
+		snprintf(filePath, sizeof(filePath), "%s", m_pSource->filePath);
+
+		// Decoding and processing the image can take a good part of a frame, so it's kept off the thread driving
+		// residency. The upload is recorded by UpdateResidencyChange() once the job is done.
+		ThreadPool::GetShared()->Submit(
+			[job, device, dataType, channel, options, filePath]()
+			{
+				StagingArena stagingArena(device, 0);
+
+				job->succeeded = _processImage(device, dataType, channel, filePath, options, &stagingArena, job->image);
+				job->done.store(true, std::memory_order_release);
+			}
+		);
+
+		m_pRestore = new RestoreData();
+		m_pRestore->job = job;
+	}
+
+	m_pendingResource = newResource;
+	m_pendingMip = residentMip;
+	m_residencyPending = true;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::UpdateResidencyChange(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device || !cmdList || !uploadRing)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	if(!m_pRestore || !m_pRestore->job->done.load(std::memory_order_acquire))
+	{
+		return true;
+	}
+
+	RestoreJob& job = *m_pRestore->job;
+	ProcessedImage& image = job.image;
+
+	bool succeeded = job.succeeded;
+
+	if(succeeded
+		&& (image.format != m_format || image.width != m_width || image.height != m_height || image.mipCount != m_mipCount))
+	{
+		LOG_ERROR("Reloaded Texture2D does not match the original texture: path=\"%s\"", m_pSource->filePath);
+		succeeded = false;
+	}
+
+	if(succeeded)
+	{
+		const UploadRing::Allocation imageStaging = image.staging ? image.GetStaging(m_pendingMip) : UploadRing::Allocation();
+
+		// Only upload the mips being made resident, into a resource sized to the first of them.
+		m_pendingResource = _createResource(
+			device,
+			cmdList,
+			uploadRing,
+			m_pSource->options.chunkedUploader,
+			m_format,
+			TextureFootprint::GetMipDimension(m_width, m_pendingMip),
+			TextureFootprint::GetMipDimension(m_height, m_pendingMip),
+			m_mipCount - m_pendingMip,
+			0,
+			image.subresources + m_pendingMip,
+			image.staging ? &imageStaging : nullptr,
+			nullptr);
+
+		succeeded = bool(m_pendingResource);
+	}
+
+	if(image.staging)
+	{
+		uploadRing->DeferRelease(image.staging);
+	}
+
+	if(succeeded)
+	{
+		LOG_WRITE(
+			"Reloaded Texture2D: path=\"%s\", residentMip=%" PRIu32 ", mipCount=%" PRIu32 ", time=%.2fms",
+			m_pSource->filePath,
+			m_pendingMip,
+			m_mipCount,
+			m_pRestore->stopwatch.GetElapsedMs());
+	}
+	else
+	{
+		// Nothing was switched over yet, so the texture simply stays the way it was.
+		m_pendingMip = m_residentMip;
+		m_residencyPending = false;
+	}
+
+	delete m_pRestore;
+	m_pRestore = nullptr;
+
+	return succeeded;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::Texture2D::CompleteResidencyChange(const Device::Ptr& device, const UploadRing::Ptr& uploadRing)
+{
+	if(!m_residencyPending || !device || !uploadRing)
+	{
+		return;
+	}
+
+	if(m_pRestore)
+	{
+		// The reload hasn't been uploaded, so there's nothing to switch to. The job finishes on its own and the
+		// texture keeps its current residency.
+		delete m_pRestore;
+		m_pRestore = nullptr;
+
+		m_pendingMip = m_residentMip;
+		m_residencyPending = false;
+		return;
+	}
+
+	if(m_resource)
+	{
+		// Frames queued since the descriptor was last written may still be sampling the old resource.
+		uploadRing->DeferRelease(m_resource);
+	}
+
+	m_resource = m_pendingResource;
+	m_residentMip = m_pendingMip;
+
+	m_pendingResource = Resource::Ptr();
+	m_residencyPending = false;
+
+	if(m_resource)
+	{
+		CreateTextureSrv(device, m_resource, m_format, m_mipCount - m_residentMip, 0, m_descriptor);
+	}
+	else
+	{
+		// Evicted textures get a null descriptor, which reads as zero in the shaders.
+		CreateTextureSrv(device, m_resource, m_format, 1, 0, m_descriptor);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::Texture2D::GetAllocationSize(const Device::Ptr& device, const uint32_t residentMip) const
+{
+	if(!device || residentMip >= m_mipCount)
+	{
+		return 0;
+	}
+
+	const D3D12_RESOURCE_DESC resDesc = GetTextureResourceDesc(m_format, m_width, m_height, m_mipCount, residentMip);
+
+	return device->GetResourceAllocationInfo(0, 1, &resDesc).SizeInBytes;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::D3D12::Texture2D::GetMaxTrimMip(const uint32_t tailSize) const
+{
+	using namespace DemoFramework::Utility;
+
+	if(m_mipCount == 0)
+	{
+		return 0;
+	}
+
+	const TextureFootprint::FormatInfo formatInfo = GetFootprintFormatInfo(m_format);
+
+	uint32_t maxMip = GetStreamTailMip(m_width, m_height, m_mipCount, tailSize);
+
+	// The top level of a block-compressed texture has to be a whole number of blocks.
+	while(maxMip > 0
+		&& formatInfo.blockWidth > 0
+		&& formatInfo.blockHeight > 0
+		&& (TextureFootprint::GetMipDimension(m_width, maxMip) % formatInfo.blockWidth != 0
+			|| TextureFootprint::GetMipDimension(m_height, maxMip) % formatInfo.blockHeight != 0))
+	{
+		--maxMip;
+	}
+
+	return maxMip;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const char* DemoFramework::D3D12::Texture2D::GetFilePath() const
+{
+	return m_pSource ? m_pSource->filePath : "";
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::_create(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const ChunkedUploader::Ptr& chunkedUploader,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipLevelCount,
+	const uint32_t firstMip,
+	const SubresourceData* const pSubresources,
+	const UploadRing::Allocation* const pStaging,
+	Resource::Ptr* const pOutStaging)
+{
+	const Resource::Ptr gpuTexture = _createResource(
+		device,
+		uploadCmdList,
+		uploadRing,
+		chunkedUploader,
+		format,
+		width,
+		height,
+		mipLevelCount,
+		firstMip,
+		pSubresources,
+		pStaging,
+		pOutStaging);
+	if(!gpuTexture)
+	{
+		return Ptr();
+	}
+
+	const Descriptor descriptor = srvAlloc->Allocate();
+
+	// Create the SRV from the resource, clamped to the mips that were uploaded.
+	CreateTextureSrv(device, gpuTexture, format, mipLevelCount, firstMip, descriptor);
+
+	Ptr output = std::make_shared<Texture2D>();
+
+	output->m_resource = gpuTexture;
+	output->m_alloc = srvAlloc;
+	output->m_descriptor = descriptor;
+	output->m_width = width;
+	output->m_height = height;
+	output->m_mipCount = mipLevelCount;
+	output->m_residentMip = firstMip;
+	output->m_format = format;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Resource::Ptr DemoFramework::D3D12::Texture2D::_createResource(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const ChunkedUploader::Ptr& chunkedUploader,
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipLevelCount,
+	const uint32_t firstMip,
+	const SubresourceData* const pSubresources,
+	const UploadRing::Allocation* const pStaging,
+	Resource::Ptr* const pOutStaging)
+{
+	constexpr D3D12_HEAP_PROPERTIES gpuHeapProps =
+	{
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr D3D12_HEAP_PROPERTIES uploadHeapProps =
+	{
+		D3D12_HEAP_TYPE_UPLOAD,          // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	const D3D12_RESOURCE_DESC gpuResDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_TEXTURE2D, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                  // UINT64 Alignment
+		uint64_t(width),                    // UINT64 Width
+		height,                             // UINT Height
+		1,                                  // UINT16 DepthOrArraySize
+		uint16_t(mipLevelCount),            // UINT16 MipLevels
+		format,                             // DXGI_FORMAT Format
+		defaultSampleDesc,                  // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_UNKNOWN,       // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,           // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[D3D12_REQ_MIP_LEVELS];
+	UINT rowCounts[D3D12_REQ_MIP_LEVELS];
+	UINT64 rowSizes[D3D12_REQ_MIP_LEVELS];
+
+	// Calculate the layout of every mip level in the staging buffer.
+	const uint64_t stagingTotalSize = ComputeStagingLayout(format, width, height, mipLevelCount, layouts, rowCounts, rowSizes);
+	if(stagingTotalSize == 0)
+	{
+		LOG_ERROR("Unsupported Texture2D format: format=%" PRIu32, uint32_t(format));
+		return Resource::Ptr();
+	}
+
+#if !defined(NDEBUG)
+	{
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT deviceLayouts[D3D12_REQ_MIP_LEVELS];
+		UINT64 deviceTotalSize = 0;
+
+		// Make sure the portable layout agrees with what the device reports.
+		device->GetCopyableFootprints(&gpuResDesc, 0, mipLevelCount, 0, deviceLayouts, nullptr, nullptr, &deviceTotalSize);
+		assert(deviceTotalSize == stagingTotalSize);
+
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			assert(deviceLayouts[mipIndex].Offset == layouts[mipIndex].Offset);
+			assert(deviceLayouts[mipIndex].Footprint.RowPitch == layouts[mipIndex].Footprint.RowPitch);
+		}
+	}
+#endif
+
+	UploadRing::Allocation staging = {};
+	Resource::Ptr stagingBuffer;
+
+	bool useChunkedUpload = false;
+
+	if(pOutStaging)
+	{
+		// Streamed textures keep writing into their staging data while the rest of the mips are processed in the
+		// background, so they get a staging buffer of their own instead of memory from the upload ring.
+		const D3D12_RESOURCE_DESC stagingResDesc =
+		{
+			D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
+			0,                               // UINT64 Alignment
+			stagingTotalSize,                // UINT64 Width
+			1,                               // UINT Height
+			1,                               // UINT16 DepthOrArraySize
+			1,                               // UINT16 MipLevels
+			DXGI_FORMAT_UNKNOWN,             // DXGI_FORMAT Format
+			defaultSampleDesc,               // DXGI_SAMPLE_DESC SampleDesc
+			D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  // D3D12_TEXTURE_LAYOUT Layout
+			D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
+		};
+
+		constexpr D3D12_RANGE disableCpuReadRange =
+		{
+			0, // SIZE_T Begin
+			0, // SIZE_T End
+		};
+
+		// Create the staging buffer.
+		stagingBuffer = CreateCommittedResource(
+			device,
+			stagingResDesc,
+			uploadHeapProps,
+			D3D12_HEAP_FLAG_NONE,
+			D3D12_RESOURCE_STATE_GENERIC_READ);
+		if(!stagingBuffer)
+		{
+			return Resource::Ptr();
+		}
+
+		// Map the staging buffer.
+		const HRESULT mapResult = stagingBuffer->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(&staging.pData));
+		assert(SUCCEEDED(mapResult)); (void) mapResult;
+
+		staging.pResource = stagingBuffer.Get();
+		staging.offset = 0;
+		staging.size = stagingTotalSize;
+		staging.gpuAddress = stagingBuffer->GetGPUVirtualAddress();
+	}
+	else if(pStaging)
+	{
+		// The caller already set aside staging memory for this texture.
+		assert(pStaging->size >= stagingTotalSize);
+
+		staging = (*pStaging);
+	}
+	else if(!uploadRing->Allocate(stagingTotalSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging))
+	{
+		if(chunkedUploader)
+		{
+			// Upload the texture in bands through the uploader's window rather than one staging buffer holding all of it.
+			useChunkedUpload = true;
+
+			LOG_WRITE(
+				"Texture2D staging data does not fit in the upload ring; uploading it in bands: size=%" PRIu64 ", ringCapacity=%" PRIu64 ", windowSize=%" PRIu64,
+				stagingTotalSize,
+				uploadRing->GetCapacity(),
+				chunkedUploader->GetWindowSize());
+		}
+		else
+		{
+			LOG_WRITE(
+				"(warning) Texture2D staging data does not fit in the upload ring; using a dedicated upload buffer: size=%" PRIu64 ", ringCapacity=%" PRIu64,
+				stagingTotalSize,
+				uploadRing->GetCapacity());
+
+			if(!uploadRing->AllocateDedicated(device, stagingTotalSize, staging))
+			{
+				return Resource::Ptr();
+			}
+		}
+	}
+
+	// Create the GPU-resident texture resource.
+	Resource::Ptr gpuTexture = CreateCommittedResource(
+		device,
+		gpuResDesc,
+		gpuHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!gpuTexture)
+	{
+		return Resource::Ptr();
+	}
+
+	if(useChunkedUpload)
+	{
+		ChunkedUploader::Source sources[D3D12_REQ_MIP_LEVELS];
+
+		for(uint32_t mipIndex = firstMip; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			sources[mipIndex - firstMip].pData = pSubresources[mipIndex].pData;
+			sources[mipIndex - firstMip].rowPitch = pSubresources[mipIndex].rowPitch;
+		}
+
+		// The copies are submitted on the uploader's queue right away, leaving only the transition for the upload command list.
+		if(!chunkedUploader->Upload(gpuTexture, GetFootprintFormatInfo(format), firstMip, sources))
+		{
+			return Resource::Ptr();
+		}
+	}
+	else
+	{
+		D3D12_TEXTURE_COPY_LOCATION srcLoc;
+		srcLoc.pResource = staging.pResource;
+		srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+		D3D12_TEXTURE_COPY_LOCATION destLoc;
+		destLoc.pResource = gpuTexture.Get();
+		destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+		// The layouts are relative to the start of the staging data, wherever that ended up.
+		uint8_t* const pStagingData = staging.pData;
+
+		// Only the mips from 'firstMip' down are uploaded here; streamed textures fill in the rest later.
+		bool matchesStagingLayout = (firstMip == 0);
+
+		// Check if the input data is already laid out exactly like the staging buffer (which is the case for data coming
+		// from the texture cache). When it is, the whole mip chain can be copied into the staging buffer all at once.
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount && matchesStagingLayout; ++mipIndex)
+		{
+			const SubresourceData& subresource = pSubresources[mipIndex];
+
+			matchesStagingLayout = (subresource.pData == pSubresources[0].pData + layouts[mipIndex].Offset)
+				&& (subresource.rowPitch == layouts[mipIndex].Footprint.RowPitch)
+				&& (subresource.rowSize == rowSizes[mipIndex])
+				&& (subresource.rowCount == rowCounts[mipIndex]);
+		}
+
+		if(matchesStagingLayout)
+		{
+			// Images processed in place are already sitting in the staging buffer.
+			if(pStagingData != pSubresources[0].pData)
+			{
+				memcpy(pStagingData, pSubresources[0].pData, size_t(stagingTotalSize));
+			}
+		}
+		else
+		{
+			// Copy each mip level of the input image to the staging buffer.
+			for(uint32_t mipIndex = firstMip; mipIndex < mipLevelCount; ++mipIndex)
+			{
+				const SubresourceData& subresource = pSubresources[mipIndex];
+
+				CopyToStaging(
+					pStagingData,
+					layouts[mipIndex],
+					rowCounts[mipIndex],
+					rowSizes[mipIndex],
+					subresource.pData,
+					subresource.rowPitch);
+			}
+		}
+
+		// Copy the staging data to the GPU-resident texture.
+		for(uint32_t mipIndex = firstMip; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			srcLoc.PlacedFootprint = layouts[mipIndex];
+			srcLoc.PlacedFootprint.Offset += staging.offset;
+			destLoc.SubresourceIndex = mipIndex;
+
+			uploadCmdList->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, nullptr);
+		}
+	}
+
+	if(pOutStaging)
+	{
+		stagingBuffer->Unmap(0, nullptr);
+
+		(*pOutStaging) = stagingBuffer;
+	}
+
+	D3D12_RESOURCE_BARRIER barrier;
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = gpuTexture.Get();
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+	uploadCmdList->ResourceBarrier(1, &barrier);
+
+	return gpuTexture;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::_createStreamed(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const std::shared_ptr<StreamJob>& job)
+{
+	using namespace DemoFramework::Utility;
+
+	const uint32_t tailMip = job->tailMip;
+	const uint32_t tailMipCount = job->mipCount - tailMip;
+
+	// Build the mip tail right away by downsampling the source image directly to the size of the first tail mip.
+	DirectX::ScratchImage tailChain;
+
+	const HRESULT initTailResult = tailChain.Initialize2D(
+		job->format,
+		size_t(TextureFootprint::GetMipDimension(job->width, tailMip)),
+		size_t(TextureFootprint::GetMipDimension(job->height, tailMip)),
+		1,
+		size_t(tailMipCount));
+	if(FAILED(initTailResult))
+	{
+		LOG_ERROR("Failed to allocate Texture2D mip tail: result=0x%08" PRIX32, initTailResult);
+		return Ptr();
+	}
+
+	ImageResampler::Image tailImages[D3D12_REQ_MIP_LEVELS];
+
+	for(uint32_t tailIndex = 0; tailIndex < tailMipCount; ++tailIndex)
+	{
+		const DirectX::Image* const pMipImage = tailChain.GetImage(tailIndex, 0, 0);
+
+		tailImages[tailIndex].pData = pMipImage->pixels;
+		tailImages[tailIndex].rowPitch = pMipImage->rowPitch;
+		tailImages[tailIndex].width = uint32_t(pMipImage->width);
+		tailImages[tailIndex].height = uint32_t(pMipImage->height);
+	}
+
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	if(!ImageResampler::Resample(job->source, tailImages[0], job->resampleFormat, job->mipFilter, pThreadPool)
+		|| !ImageResampler::GenerateMips(tailImages, tailMipCount, job->resampleFormat, job->mipFilter, pThreadPool))
+	{
+		LOG_ERROR("Failed to generate Texture2D mip tail: path=\"%s\"", job->filePath);
+		return Ptr();
+	}
+
+	DirectX::ScratchImage compressedTail;
+
+	if(job->textureFormat != job->format)
+	{
+		BlockCompressor::Stats compressStats;
+
+		if(!CompressImages(
+			tailChain.GetImages(),
+			tailChain.GetImageCount(),
+			job->textureFormat,
+			job->compressQuality,
+			pThreadPool,
+			compressedTail,
+			compressStats))
+		{
+			LOG_ERROR("Failed to block compress Texture2D mip tail: path=\"%s\"", job->filePath);
+			return Ptr();
+		}
+	}
+
+	const DirectX::ScratchImage& finalTail = (compressedTail.GetImageCount() > 0) ? compressedTail : tailChain;
+
+	SubresourceData subresources[D3D12_REQ_MIP_LEVELS] = {};
+
+	for(uint32_t tailIndex = 0; tailIndex < tailMipCount; ++tailIndex)
+	{
+		const DirectX::Image* const pMipImage = finalTail.GetImage(tailIndex, 0, 0);
+
+		SubresourceData& subresource = subresources[tailMip + tailIndex];
+
+		subresource.pData = pMipImage->pixels;
+		subresource.rowPitch = pMipImage->rowPitch;
+		subresource.rowSize = pMipImage->rowPitch;
+		subresource.rowCount = uint32_t(pMipImage->slicePitch / pMipImage->rowPitch);
+	}
+
+	Resource::Ptr staging;
+
+	// Create the texture with its full mip chain, but only upload the tail for now.
+	Ptr output = _create(
+		device,
+		uploadCmdList,
+		uploadRing,
+		ChunkedUploader::Ptr(),
+		srvAlloc,
+		job->textureFormat,
+		job->width,
+		job->height,
+		job->mipCount,
+		tailMip,
+		subresources,
+		nullptr,
+		&staging);
+	if(!output)
+	{
+		return Ptr();
+	}
+
+	ComputeStagingLayout(
+		job->textureFormat,
+		job->width,
+		job->height,
+		job->mipCount,
+		job->layouts,
+		job->rowCounts,
+		job->rowSizes);
+
+	constexpr D3D12_RANGE disableCpuReadRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	// The staging buffer stays mapped for the background job to write the remaining mips into.
+	const HRESULT mapResult = staging->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(&job->pStagingData));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map Texture2D staging buffer: result=0x%08" PRIX32, mapResult);
+		return Ptr();
+	}
+
+	job->staging = staging;
+	job->readyMip = tailMip;
+
+	StreamData* const pStream = new StreamData();
+
+	pStream->device = device;
+	pStream->uploadRing = uploadRing;
+	pStream->job = job;
+	pStream->queuedMip = tailMip;
+
+	// Wait for as many frames as there can be in flight before lowering the clamp over a newly copied mip,
+	// since a descriptor rewritten on the CPU is seen immediately by every frame still queued on the GPU.
+	pStream->scheduler.Reset(job->mipCount, tailMip, DF_SWAP_CHAIN_BUFFER_MAX_COUNT);
+
+	for(uint32_t mipIndex = 0; mipIndex < tailMip; ++mipIndex)
+	{
+		pStream->scheduler.SetMipLayout(mipIndex, job->layouts[mipIndex].Footprint.RowPitch, job->rowCounts[mipIndex]);
+	}
+
+	output->m_pStream = pStream;
+
+	ThreadPool::GetShared()->Submit([job]() { _runStreamJob(*job); });
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::_processImage(
+	const Device::Ptr& device,
+	const DataType dataType,
+	const Channel channel,
+	const char* const filePath,
+	const LoadOptions& options,
+	StagingArena* const pStagingArena,
+	ProcessedImage& outImage)
+{
+	using namespace DemoFramework::Utility;
+
+	// Supercompressed textures are transcoded straight to their final format, which is about as fast as reading a
+	// cache entry would be.
+	if(SupercompressedTexture::HasFileExtension(filePath))
+	{
+		return _processSupercompressed(device, dataType, channel, filePath, options, pStagingArena, outImage);
+	}
+
+	Stopwatch stopwatch;
+
+	TextureCache::Key cacheKey = {};
+	bool hasCacheKey = false;
+
+	if(options.cache)
+	{
+		hasCacheKey = options.cache->MakeKey(filePath, GetParamHash(dataType, channel, options), cacheKey);
+
+		TextureCache::Entry& cacheEntry = outImage.cacheEntry;
+
+		if(hasCacheKey && options.cache->Find(cacheKey, cacheEntry))
+		{
+			if(TextureFootprint::Compute(GetFootprintFormatInfo(cacheEntry.format), cacheEntry.width, cacheEntry.height, cacheEntry.mipCount, nullptr) > 0)
+			{
+				for(uint32_t mipIndex = 0; mipIndex < cacheEntry.mipCount; ++mipIndex)
+				{
+					const TextureCache::Subresource& cachedSubresource = cacheEntry.pSubresources[mipIndex];
+
+					// The cached data is already fully processed, so it can go straight into the upload buffer.
+					outImage.subresources[mipIndex].pData = cacheEntry.pData + cachedSubresource.offset;
+					outImage.subresources[mipIndex].rowPitch = cachedSubresource.rowPitch;
+					outImage.subresources[mipIndex].rowSize = cachedSubresource.rowSize;
+					outImage.subresources[mipIndex].rowCount = cachedSubresource.rowCount;
+				}
+
+				outImage.format = cacheEntry.format;
+				outImage.width = cacheEntry.width;
+				outImage.height = cacheEntry.height;
+				outImage.mipCount = cacheEntry.mipCount;
+				outImage.processTime = stopwatch.GetElapsedMs();
+
+				LOG_WRITE("Read Texture2D from cache: path=\"%s\", time=%.2fms", filePath, outImage.processTime);
+				return true;
+			}
+
+			LOG_WRITE("(warning) Texture2D cache entry has an unsupported format; reloading source image: path=\"%s\"", filePath);
+
+			cacheEntry = TextureCache::Entry();
+		}
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t channelCount = 0;
+
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+	// Images decoded by stb_image, and images decoded natively by the HDR decoder.
+	void* pImgData = nullptr;
+	std::vector<uint8_t> hdrImage;
+
+	switch(channel)
+	{
+		case Channel::L:    channelCount = 1; break;
+		case Channel::LA:   channelCount = 2; break;
+		case Channel::RGBA: channelCount = 4; break;
+
+		default:
+			LOG_ERROR("Invalid parameter");
+			return false;
+	}
+
+	switch(dataType)
+	{
+		case DataType::Unorm:
+		{
+			pImgData = stbi_load(filePath, reinterpret_cast<int32_t*>(&width), reinterpret_cast<int32_t*>(&height), nullptr, channelCount);
+
+			switch(channel)
+			{
+				case Channel::L:    format = DXGI_FORMAT_R8_UNORM;       break;
+				case Channel::LA:   format = DXGI_FORMAT_R8G8_UNORM;     break;
+				case Channel::RGBA: format = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+
+				default:
+					// This should never happen.
+					assert(false);
+					break;
+			}
+			break;
+		}
+
+		case DataType::Float:
+		{
+			pImgData = stbi_loadf(filePath, reinterpret_cast<int32_t*>(&width), reinterpret_cast<int32_t*>(&height), nullptr, channelCount);
+
+			switch(channel)
+			{
+				case Channel::L:    format = DXGI_FORMAT_R32_FLOAT;          break;
+				case Channel::LA:   format = DXGI_FORMAT_R32G32_FLOAT;       break;
+				case Channel::RGBA: format = DXGI_FORMAT_R32G32B32A32_FLOAT; break;
+
+				default:
+					// This should never happen.
+					assert(false);
+					break;
+			}
+			break;
+		}
+
+		case DataType::HalfFloat:
+		case DataType::SharedExponent:
+		{
+			if(channel != Channel::RGBA)
+			{
+				LOG_ERROR("Half float and shared exponent textures must be loaded with RGBA channels: path=\"%s\"", filePath);
+				return false;
+			}
+
+			const HdrDecoder::Format hdrFormat = (dataType == DataType::HalfFloat)
+				? HdrDecoder::Format::RGBA16Float
+				: HdrDecoder::Format::RGB9E5;
+
+			if(!LoadHdrImage(filePath, hdrFormat, width, height, hdrImage))
+			{
+				return false;
+			}
+
+			format = (dataType == DataType::HalfFloat)
+				? DXGI_FORMAT_R16G16B16A16_FLOAT
+				: DXGI_FORMAT_R9G9B9E5_SHAREDEXP;
+			break;
+		}
+
+		default:
+			LOG_ERROR("Invalid parameter");
+			return false;
+	}
+
+	if(!pImgData && hdrImage.empty())
+	{
+		LOG_ERROR("Failed to load image file: %s", filePath);
+		return false;
+	}
+
+	const ImageResampler::Format resampleFormat = GetResamplerFormat(dataType, channel);
+	const size_t texelSize = ImageResampler::GetTexelSize(resampleFormat);
+
+	const ImageResampler::ConstImage baseImage =
+	{
+		pImgData ? reinterpret_cast<const uint8_t*>(pImgData) : hdrImage.data(), // const uint8_t* pData
+		size_t(width) * texelSize,                                                // size_t rowPitch
+		width,                                                                    // uint32_t width
+		height,                                                                   // uint32_t height
+	};
+
+	// Textures are resized up to the next power of 2 unless the caller wants the original dimensions kept. D3D12 handles
+	// non-power-of-2 textures (including their mip chains) natively, so keeping them avoids both the resampling cost and
+	// the extra memory of the larger image.
+	const uint32_t desiredWidth = options.keepDimensions ? width : Math::GetPowerOfTwo(width);
+	const uint32_t desiredHeight = options.keepDimensions ? height : Math::GetPowerOfTwo(height);
+
+	const uint32_t mipLevelMaxCount = TextureFootprint::GetMaxMipCount(desiredWidth, desiredHeight);
+	const uint32_t mipLevelCount = (options.mipCount < mipLevelMaxCount) ? options.mipCount : mipLevelMaxCount;
+
+	const DXGI_FORMAT compressedFormat = !options.blockCompress
+		? DXGI_FORMAT_UNKNOWN
+		: (options.compressedFormat != DXGI_FORMAT_UNKNOWN)
+			? options.compressedFormat
+			: GetBlockCompressedFormat(dataType, channel);
+
+	BlockCompressor::Format compressorFormat = BlockCompressor::Format::BC7;
+
+	// The encoder needs the decoded image in the layout it expects for the format, and block-compressed
+	// textures need the top level to be a whole number of blocks.
+	const bool useBlockCompression = GetCompressorFormat(compressedFormat, compressorFormat)
+		&& BlockCompressor::GetSourceFormat(compressorFormat) == resampleFormat
+		&& (desiredWidth % 4) == 0
+		&& (desiredHeight % 4) == 0;
+
+	if(options.blockCompress && !useBlockCompression)
+	{
+		LOG_WRITE("(warning) Texture2D cannot be block compressed; loading uncompressed: path=\"%s\"", filePath);
+	}
+
+	if(options.stream)
+	{
+		const uint32_t tailMip = GetStreamTailMip(desiredWidth, desiredHeight, mipLevelCount, options.streamTailSize);
+
+		// Textures small enough to fit entirely in the mip tail are just loaded normally.
+		if(tailMip > 0)
+		{
+			std::shared_ptr<StreamJob> job = std::make_shared<StreamJob>();
+
+			// The job takes ownership of the decoded image from here on.
+			job->pSourceImage = pImgData;
+			job->hdrImage.swap(hdrImage);
+			job->source = baseImage;
+			job->resampleFormat = resampleFormat;
+			job->resizeFilter = options.resizeFilter;
+			job->mipFilter = options.mipFilter;
+			job->format = format;
+			job->textureFormat = useBlockCompression ? compressedFormat : format;
+			job->compressQuality = options.compressQuality;
+			job->width = desiredWidth;
+			job->height = desiredHeight;
+			job->mipCount = mipLevelCount;
+			job->tailMip = tailMip;
+
+			snprintf(job->filePath, sizeof(job->filePath), "%s", filePath);
+
+			// The mip tail is built when the texture is created.
+			outImage.streamJob = job;
+			outImage.format = job->textureFormat;
+			outImage.width = desiredWidth;
+			outImage.height = desiredHeight;
+			outImage.mipCount = mipLevelCount;
+			outImage.processTime = stopwatch.GetElapsedMs();
+
+			return true;
+		}
+	}
+
+	DirectX::ScratchImage& mipChain = outImage.mipChain;
+
+	ImageResampler::Image mipImages[D3D12_REQ_MIP_LEVELS];
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT stagingLayouts[D3D12_REQ_MIP_LEVELS];
+	UINT stagingRowCounts[D3D12_REQ_MIP_LEVELS];
+	UINT64 stagingRowSizes[D3D12_REQ_MIP_LEVELS];
+
+	// Uncompressed images are resized and mipmapped straight into a staging buffer laid out exactly the way the
+	// upload copies read it, so there's no mip chain to copy over, row by row, once processing is done. Compressed
+	// images still need the uncompressed chain as input to the encoder.
+	//
+	// The source image itself isn't decoded into the staging buffer. stb_image only decodes into memory it allocates,
+	// and both it and the HDR decoder produce the tightly packed rows the resampler reads from when resizing, so the
+	// base level costs one copy (or the resize) on its way into the staging layout.
+	if(pStagingArena && !useBlockCompression)
+	{
+		const uint64_t stagingSize = ComputeStagingLayout(
+			format,
+			desiredWidth,
+			desiredHeight,
+			mipLevelCount,
+			stagingLayouts,
+			stagingRowCounts,
+			stagingRowSizes);
+
+		UploadRing::Allocation& staging = outImage.stagingAllocation;
+
+		// Images too large for the chunked uploader's window are uploaded in bands instead, so there's no point in
+		// giving them a staging buffer the size of their whole mip chain.
+		const bool useChunkedUpload = options.chunkedUploader && (stagingSize > options.chunkedUploader->GetWindowSize());
+
+		if(stagingSize > 0 && !useChunkedUpload)
+		{
+			pStagingArena->Allocate(stagingSize, staging, outImage.staging);
+		}
+
+		if(outImage.staging)
+		{
+			for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+			{
+				const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = stagingLayouts[mipIndex];
+
+				mipImages[mipIndex].pData = staging.pData + layout.Offset;
+				mipImages[mipIndex].rowPitch = layout.Footprint.RowPitch;
+				mipImages[mipIndex].width = layout.Footprint.Width;
+				mipImages[mipIndex].height = layout.Footprint.Height;
+			}
+		}
+		else if(!useChunkedUpload)
+		{
+			LOG_WRITE("(warning) Failed to create Texture2D staging buffer; processing in system memory: path=\"%s\"", filePath);
+		}
+	}
+
+	if(!outImage.staging)
+	{
+		// Allocate the whole mip chain up front so the resampler can write each level directly into it.
+		const HRESULT initMipChainResult = mipChain.Initialize2D(format, size_t(desiredWidth), size_t(desiredHeight), 1, size_t(mipLevelCount));
+		if(FAILED(initMipChainResult))
+		{
+			LOG_ERROR("Failed to allocate Texture2D mip chain: result=0x%08" PRIX32, initMipChainResult);
+			stbi_image_free(pImgData);
+			return false;
+		}
+
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			const DirectX::Image* const pMipImage = mipChain.GetImage(mipIndex, 0, 0);
+
+			mipImages[mipIndex].pData = pMipImage->pixels;
+			mipImages[mipIndex].rowPitch = pMipImage->rowPitch;
+			mipImages[mipIndex].width = uint32_t(pMipImage->width);
+			mipImages[mipIndex].height = uint32_t(pMipImage->height);
+		}
+	}
+
+	// When this is processing one image of a batch, it's running on a pool worker and the resampler and encoder will
+	// do their work serially on this thread.
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	if(width != desiredWidth || height != desiredHeight)
+	{
+		if(!ImageResampler::Resample(baseImage, mipImages[0], resampleFormat, options.resizeFilter, pThreadPool))
+		{
+			LOG_ERROR("Failed to resize Texture2D base image: path=\"%s\"", filePath);
+			stbi_image_free(pImgData);
+			return false;
+		}
+
+		width = desiredWidth;
+		height = desiredHeight;
+	}
+	else
+	{
+		for(uint32_t row = 0; row < height; ++row)
+		{
+			memcpy(mipImages[0].pData + (size_t(row) * mipImages[0].rowPitch), baseImage.pData + (size_t(row) * baseImage.rowPitch), baseImage.rowPitch);
+		}
+
+		outImage.copiedSize += uint64_t(baseImage.rowPitch) * height;
+	}
+
+	// Free the original image data now that we no longer need it.
+	stbi_image_free(pImgData);
+	std::vector<uint8_t>().swap(hdrImage);
+
+	// Generate the mip chain up to the selected number of mip levels.
+	if(!ImageResampler::GenerateMips(mipImages, mipLevelCount, resampleFormat, options.mipFilter, pThreadPool))
+	{
+		LOG_ERROR("Failed to generate Texture2D mipmaps: path=\"%s\"", filePath);
+		return false;
+	}
+
+	const float64_t resampleTime = stopwatch.GetElapsedMs();
+
+	DirectX::ScratchImage& compressedChain = outImage.compressedChain;
+
+	if(useBlockCompression)
+	{
+		BlockCompressor::Stats compressStats;
+
+		if(!CompressImages(
+			mipChain.GetImages(),
+			mipChain.GetImageCount(),
+			compressedFormat,
+			options.compressQuality,
+			pThreadPool,
+			compressedChain,
+			compressStats))
+		{
+			LOG_ERROR("Failed to block compress Texture2D: path=\"%s\"", filePath);
+			return false;
+		}
+
+		const float64_t compressTime = stopwatch.GetElapsedMs() - resampleTime;
+
+		const uint64_t uncompressedSize = TextureFootprint::Compute(GetFootprintFormatInfo(format), width, height, mipLevelCount, nullptr);
+		const uint64_t compressedSize = TextureFootprint::Compute(GetFootprintFormatInfo(compressedFormat), width, height, mipLevelCount, nullptr);
+
+		// Throughput is measured against the uncompressed input so different formats are comparable.
+		const float64_t throughput = (compressTime > 0.0)
+			? (float64_t(mipChain.GetPixelsSize()) / (1024.0 * 1024.0)) / (compressTime / 1000.0)
+			: 0.0;
+
+		LOG_WRITE(
+			"Block compressed Texture2D: path=\"%s\", format=%" PRIu32 ", time=%.2fms, throughput=%.1fMB/s, psnr=%.2fdB, uncompressedSize=%" PRIu64 ", compressedSize=%" PRIu64,
+			filePath,
+			uint32_t(compressedFormat),
+			compressTime,
+			throughput,
+			compressStats.GetPsnr(compressorFormat),
+			uncompressedSize,
+			compressedSize);
+
+		// The uncompressed mip chain is no longer needed.
+		mipChain.Release();
+	}
+
+	const DXGI_FORMAT finalFormat = (compressedChain.GetImageCount() > 0) ? compressedFormat : format;
+
+	if(outImage.staging)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			outImage.subresources[mipIndex].pData = mipImages[mipIndex].pData;
+			outImage.subresources[mipIndex].rowPitch = mipImages[mipIndex].rowPitch;
+			outImage.subresources[mipIndex].rowSize = stagingRowSizes[mipIndex];
+			outImage.subresources[mipIndex].rowCount = stagingRowCounts[mipIndex];
+		}
+	}
+	else
+	{
+		const DirectX::ScratchImage& finalChain = (compressedChain.GetImageCount() > 0) ? compressedChain : mipChain;
+
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			const DirectX::Image* const pMipImage = finalChain.GetImage(mipIndex, 0, 0);
+
+			// For block-compressed formats, each "row" is a row of blocks.
+			outImage.subresources[mipIndex].pData = pMipImage->pixels;
+			outImage.subresources[mipIndex].rowPitch = pMipImage->rowPitch;
+			outImage.subresources[mipIndex].rowSize = pMipImage->rowPitch;
+			outImage.subresources[mipIndex].rowCount = uint32_t(pMipImage->slicePitch / pMipImage->rowPitch);
+		}
+	}
+
+	outImage.format = finalFormat;
+	outImage.width = width;
+	outImage.height = height;
+	outImage.mipCount = mipLevelCount;
+
+	const float64_t processTime = stopwatch.GetElapsedMs();
+
+	if(hasCacheKey)
+	{
+		TextureCache::SourceSubresource cacheSubresources[D3D12_REQ_MIP_LEVELS];
+
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			cacheSubresources[mipIndex].pData = outImage.subresources[mipIndex].pData;
+			cacheSubresources[mipIndex].rowPitch = outImage.subresources[mipIndex].rowPitch;
+			cacheSubresources[mipIndex].rowSize = outImage.subresources[mipIndex].rowSize;
+			cacheSubresources[mipIndex].rowCount = outImage.subresources[mipIndex].rowCount;
+			cacheSubresources[mipIndex].width = TextureFootprint::GetMipDimension(width, mipIndex);
+			cacheSubresources[mipIndex].height = TextureFootprint::GetMipDimension(height, mipIndex);
+		}
+
+		// Failing to write the cache entry isn't fatal since we already have the processed image. The staging buffer
+		// is in cached memory, so reading it back to write the entry is as fast as reading any other buffer.
+		options.cache->Store(
+			cacheKey,
+			finalFormat,
+			width,
+			height,
+			mipLevelCount,
+			cacheSubresources);
+	}
+
+	outImage.processTime = stopwatch.GetElapsedMs();
+
+	LOG_WRITE(
+		"Processed Texture2D: path=\"%s\", time=%.2fms, decodeAndResampleTime=%.2fms, cacheWriteTime=%.2fms, inPlace=%s",
+		filePath,
+		outImage.processTime,
+		resampleTime,
+		outImage.processTime - processTime,
+		outImage.staging ? "true" : "false");
+
+	if(width != Math::GetPowerOfTwo(width) || height != Math::GetPowerOfTwo(height))
+	{
+		// Report how much memory keeping the original dimensions saved compared to resizing to a power of 2.
+		const TextureFootprint::FormatInfo formatInfo = GetFootprintFormatInfo(finalFormat);
+
+		const uint32_t potWidth = Math::GetPowerOfTwo(width);
+		const uint32_t potHeight = Math::GetPowerOfTwo(height);
+		const uint32_t potMaxMipCount = TextureFootprint::GetMaxMipCount(potWidth, potHeight);
+		const uint32_t potMipCount = (options.mipCount < potMaxMipCount) ? options.mipCount : potMaxMipCount;
+
+		const uint64_t actualSize = TextureFootprint::Compute(formatInfo, width, height, mipLevelCount, nullptr);
+		const uint64_t potSize = TextureFootprint::Compute(formatInfo, potWidth, potHeight, potMipCount, nullptr);
+
+		LOG_WRITE(
+			"Kept non-power-of-2 Texture2D dimensions: path=\"%s\", size=%" PRIu32 "x%" PRIu32 ", uploadSize=%" PRIu64 ", powerOf2UploadSize=%" PRIu64 ", savedBytes=%" PRIu64,
+			filePath,
+			width,
+			height,
+			actualSize,
+			potSize,
+			potSize - actualSize);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::Texture2D::_processSupercompressed(
+	const Device::Ptr& device,
+	const DataType dataType,
+	const Channel channel,
+	const char* const filePath,
+	const LoadOptions& options,
+	StagingArena* const pStagingArena,
+	ProcessedImage& outImage)
+{
+	using namespace DemoFramework::Utility;
+
+	Stopwatch stopwatch;
+
+	const SupercompressedTexture::Ptr texture = SupercompressedTexture::Open(filePath);
+	if(!texture)
+	{
+		return false;
+	}
+
+	const SupercompressedTexture::Desc& desc = texture->GetDesc();
+
+	// Each layout transcodes to the block-compressed format matching the channels it holds. RGBA textures use BC7
+	// unless BC1 is asked for explicitly.
+	BlockCompressor::Format compressorFormat = BlockCompressor::Format::BC7;
+	DXGI_FORMAT format = DXGI_FORMAT_BC7_UNORM;
+
+	switch(channel)
+	{
+		case Channel::L:
+			compressorFormat = BlockCompressor::Format::BC4;
+			format = DXGI_FORMAT_BC4_UNORM;
+			break;
+
+		case Channel::LA:
+			compressorFormat = BlockCompressor::Format::BC5;
+			format = DXGI_FORMAT_BC5_UNORM;
+			break;
+
+		case Channel::RGBA:
+			if(options.blockCompress && options.compressedFormat == DXGI_FORMAT_BC1_UNORM)
+			{
+				compressorFormat = BlockCompressor::Format::BC1;
+				format = DXGI_FORMAT_BC1_UNORM;
+			}
+			break;
+
+		default:
+			LOG_ERROR("Invalid parameter");
+			return false;
+	}
+
+	if(dataType != DataType::Unorm || !texture->CanTranscode(compressorFormat))
+	{
+		LOG_ERROR("Supercompressed texture doesn't match the requested data type and channels: path=\"%s\"", filePath);
+		return false;
+	}
+
+	// Block-compressed textures need the top level to be a whole number of blocks.
+	if((desc.width % 4) != 0 || (desc.height % 4) != 0)
+	{
+		LOG_ERROR("Supercompressed texture is not a multiple of 4 in size: path=\"%s\"", filePath);
+		return false;
+	}
+
+	const uint32_t mipLevelCount = (options.mipCount < desc.mipCount) ? options.mipCount : desc.mipCount;
+
+	if(mipLevelCount == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	ImageResampler::Image mipImages[D3D12_REQ_MIP_LEVELS];
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT stagingLayouts[D3D12_REQ_MIP_LEVELS];
+	UINT stagingRowCounts[D3D12_REQ_MIP_LEVELS];
+	UINT64 stagingRowSizes[D3D12_REQ_MIP_LEVELS];
+
+	const uint64_t stagingSize = ComputeStagingLayout(
+		format,
+		desc.width,
+		desc.height,
+		mipLevelCount,
+		stagingLayouts,
+		stagingRowCounts,
+		stagingRowSizes);
+
+	// Blocks are transcoded straight into a staging buffer whenever one can be used, the same as uncompressed images.
+	if(pStagingArena)
+	{
+		UploadRing::Allocation& staging = outImage.stagingAllocation;
+
+		const bool useChunkedUpload = options.chunkedUploader && (stagingSize > options.chunkedUploader->GetWindowSize());
+
+		if(stagingSize > 0 && !useChunkedUpload)
+		{
+			pStagingArena->Allocate(stagingSize, staging, outImage.staging);
+		}
+
+		if(outImage.staging)
+		{
+			for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+			{
+				const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = stagingLayouts[mipIndex];
+
+				mipImages[mipIndex].pData = staging.pData + layout.Offset;
+				mipImages[mipIndex].rowPitch = layout.Footprint.RowPitch;
+				mipImages[mipIndex].width = layout.Footprint.Width;
+				mipImages[mipIndex].height = layout.Footprint.Height;
+
+				outImage.subresources[mipIndex].pData = mipImages[mipIndex].pData;
+				outImage.subresources[mipIndex].rowPitch = layout.Footprint.RowPitch;
+				outImage.subresources[mipIndex].rowSize = stagingRowSizes[mipIndex];
+				outImage.subresources[mipIndex].rowCount = stagingRowCounts[mipIndex];
+			}
+		}
+		else if(!useChunkedUpload)
+		{
+			LOG_WRITE("(warning) Failed to create Texture2D staging buffer; transcoding in system memory: path=\"%s\"", filePath);
+		}
+	}
+
+	if(!outImage.staging)
+	{
+		DirectX::ScratchImage& compressedChain = outImage.compressedChain;
+
+		const HRESULT initChainResult = compressedChain.Initialize2D(format, size_t(desc.width), size_t(desc.height), 1, size_t(mipLevelCount));
+		if(FAILED(initChainResult))
+		{
+			LOG_ERROR("Failed to allocate Texture2D mip chain: result=0x%08" PRIX32, initChainResult);
+			return false;
+		}
+
+		for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+		{
+			const DirectX::Image* const pMipImage = compressedChain.GetImage(mipIndex, 0, 0);
+
+			mipImages[mipIndex].pData = pMipImage->pixels;
+			mipImages[mipIndex].rowPitch = pMipImage->rowPitch;
+			mipImages[mipIndex].width = uint32_t(pMipImage->width);
+			mipImages[mipIndex].height = uint32_t(pMipImage->height);
+
+			// For block-compressed formats, each "row" is a row of blocks.
+			outImage.subresources[mipIndex].pData = pMipImage->pixels;
+			outImage.subresources[mipIndex].rowPitch = pMipImage->rowPitch;
+			outImage.subresources[mipIndex].rowSize = pMipImage->rowPitch;
+			outImage.subresources[mipIndex].rowCount = uint32_t(pMipImage->slicePitch / pMipImage->rowPitch);
+		}
+	}
+
+	const float64_t openTime = stopwatch.GetElapsedMs();
+
+	if(!texture->Transcode(compressorFormat, mipImages, mipLevelCount, ThreadPool::GetShared()))
+	{
+		LOG_ERROR("Failed to transcode supercompressed Texture2D: path=\"%s\"", filePath);
+		outImage.Release();
+		return false;
+	}
+
+	const float64_t transcodeTime = stopwatch.GetElapsedMs() - openTime;
+
+	uint64_t pixelCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipLevelCount; ++mipIndex)
+	{
+		pixelCount += uint64_t(TextureFootprint::GetMipDimension(desc.width, mipIndex))
+			* uint64_t(TextureFootprint::GetMipDimension(desc.height, mipIndex));
+	}
+
+	outImage.format = format;
+	outImage.width = desc.width;
+	outImage.height = desc.height;
+	outImage.mipCount = mipLevelCount;
+	outImage.processTime = stopwatch.GetElapsedMs();
+
+	const float64_t throughput = (transcodeTime > 0.0)
+		? (float64_t(pixelCount) / 1000000.0) / (transcodeTime / 1000.0)
+		: 0.0;
+
+	LOG_WRITE(
+		"Transcoded supercompressed Texture2D: path=\"%s\", format=%" PRIu32 ", time=%.2fms, transcodeTime=%.2fms, throughput=%.1fMpix/s, fileSize=%" PRIu64 ", transcodedSize=%" PRIu64 ", inPlace=%s",
+		filePath,
+		uint32_t(format),
+		outImage.processTime,
+		transcodeTime,
+		throughput,
+		texture->GetFileSize(),
+		stagingSize,
+		outImage.staging ? "true" : "false");
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::Texture2D::_createProcessed(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const ChunkedUploader::Ptr& chunkedUploader,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	ProcessedImage& image,
+	const UploadRing::Allocation* const pStaging)
+{
+	if(image.streamJob)
+	{
+		Ptr output = _createStreamed(device, uploadCmdList, uploadRing, srvAlloc, image.streamJob);
+		if(output)
+		{
+			LOG_WRITE(
+				"Created Texture2D mip tail: path=\"%s\", residentMip=%" PRIu32 ", mipCount=%" PRIu32,
+				image.streamJob->filePath,
+				image.streamJob->tailMip,
+				image.mipCount);
+		}
+
+		return output;
+	}
+
+	UploadRing::Allocation imageStaging;
+
+	if(image.staging)
+	{
+		// The image was processed in its own staging buffer, which only needs to live until the GPU is done copying it.
+		imageStaging = image.GetStaging(0);
+		uploadRing->DeferRelease(image.staging);
+	}
+	else
+	{
+		image.copiedSize += Utility::TextureFootprint::Compute(GetFootprintFormatInfo(image.format), image.width, image.height, image.mipCount, nullptr);
+	}
+
+	return _create(
+		device,
+		uploadCmdList,
+		uploadRing,
+		chunkedUploader,
+		srvAlloc,
+		image.format,
+		image.width,
+		image.height,
+		image.mipCount,
+		0,
+		image.subresources,
+		image.staging ? &imageStaging : pStaging,
+		nullptr);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::Texture2D::_setSource(
+	const DataType dataType,
+	const Channel channel,
+	const char* const filePath,
+	const LoadOptions& options)
+{
+	if(!m_pSource)
+	{
+		m_pSource = new LoadSource();
+	}
+
+	m_pSource->dataType = dataType;
+	m_pSource->channel = channel;
+	m_pSource->options = options;
+
+	snprintf(m_pSource->filePath, sizeof(m_pSource->filePath), "%s", filePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::Texture2D::_runStreamJob(StreamJob& job)
+{
+	using namespace DemoFramework::Utility;
+
+	Stopwatch stopwatch;
+
+	const uint32_t streamedMipCount = job.tailMip;
+
+	// Process every mip above the tail at once, since each mip is downsampled from the one above it anyway.
+	DirectX::ScratchImage mipChain;
+
+	const HRESULT initMipChainResult = mipChain.Initialize2D(job.format, size_t(job.width), size_t(job.height), 1, size_t(streamedMipCount));
+	if(FAILED(initMipChainResult))
+	{
+		LOG_ERROR("Failed to allocate streamed Texture2D mip chain: result=0x%08" PRIX32, initMipChainResult);
+		job.failed.store(true, std::memory_order_release);
+		return;
+	}
+
+	ImageResampler::Image mipImages[D3D12_REQ_MIP_LEVELS];
+
+	for(uint32_t mipIndex = 0; mipIndex < streamedMipCount; ++mipIndex)
+	{
+		const DirectX::Image* const pMipImage = mipChain.GetImage(mipIndex, 0, 0);
+
+		mipImages[mipIndex].pData = pMipImage->pixels;
+		mipImages[mipIndex].rowPitch = pMipImage->rowPitch;
+		mipImages[mipIndex].width = uint32_t(pMipImage->width);
+		mipImages[mipIndex].height = uint32_t(pMipImage->height);
+	}
+
+	// This runs on a pool worker, so the resampler will do its work serially on this thread.
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	if(job.source.width != job.width || job.source.height != job.height)
+	{
+		if(!ImageResampler::Resample(job.source, mipImages[0], job.resampleFormat, job.resizeFilter, pThreadPool))
+		{
+			LOG_ERROR("Failed to resize streamed Texture2D base image: path=\"%s\"", job.filePath);
+			job.failed.store(true, std::memory_order_release);
+			return;
+		}
+	}
+	else
+	{
+		for(uint32_t row = 0; row < job.height; ++row)
+		{
+			memcpy(mipImages[0].pData + (size_t(row) * mipImages[0].rowPitch), job.source.pData + (size_t(row) * job.source.rowPitch), job.source.rowPitch);
+		}
+	}
+
+	// Free the original image data now that we no longer need it.
+	stbi_image_free(job.pSourceImage);
+	job.pSourceImage = nullptr;
+	std::vector<uint8_t>().swap(job.hdrImage);
+
+	if(!ImageResampler::GenerateMips(mipImages, streamedMipCount, job.resampleFormat, job.mipFilter, pThreadPool))
+	{
+		LOG_ERROR("Failed to generate streamed Texture2D mipmaps: path=\"%s\"", job.filePath);
+		job.failed.store(true, std::memory_order_release);
+		return;
+	}
+
+	BlockCompressor::Stats compressStats = {};
+
+	// Publish the mips from smallest to largest so the clamp can start dropping as early as possible.
+	for(uint32_t mipIndex = streamedMipCount; mipIndex > 0; --mipIndex)
+	{
+		if(job.cancel)
+		{
+			return;
+		}
+
+		const uint32_t currentMip = mipIndex - 1;
+
+		const DirectX::Image* pMipImage = mipChain.GetImage(currentMip, 0, 0);
+
+		DirectX::ScratchImage compressedMip;
+
+		if(job.textureFormat != job.format)
+		{
+			BlockCompressor::Stats mipStats;
+
+			if(!CompressImages(pMipImage, 1, job.textureFormat, job.compressQuality, pThreadPool, compressedMip, mipStats))
+			{
+				LOG_ERROR("Failed to block compress streamed Texture2D mip: path=\"%s\", mip=%" PRIu32, job.filePath, currentMip);
+				job.failed.store(true, std::memory_order_release);
+				return;
+			}
+
+			compressStats.squaredError += mipStats.squaredError;
+			compressStats.sampleCount += mipStats.sampleCount;
+
+			pMipImage = compressedMip.GetImage(0, 0, 0);
+		}
+
+		CopyToStaging(
+			job.pStagingData,
+			job.layouts[currentMip],
+			job.rowCounts[currentMip],
+			job.rowSizes[currentMip],
+			pMipImage->pixels,
+			pMipImage->rowPitch);
+
+		job.readyMip.store(currentMip, std::memory_order_release);
+	}
+
+	BlockCompressor::Format compressorFormat;
+
+	if(GetCompressorFormat(job.textureFormat, compressorFormat))
+	{
+		LOG_WRITE(
+			"Processed streamed Texture2D mips: path=\"%s\", mipCount=%" PRIu32 ", time=%.2fms, psnr=%.2fdB",
+			job.filePath,
+			streamedMipCount,
+			stopwatch.GetElapsedMs(),
+			compressStats.GetPsnr(compressorFormat));
+	}
+	else
+	{
+		LOG_WRITE("Processed streamed Texture2D mips: path=\"%s\", mipCount=%" PRIu32 ", time=%.2fms", job.filePath, streamedMipCount, stopwatch.GetElapsedMs());
+	}
 }
 
 //---------------------------------------------------------------------------------------------------------------------
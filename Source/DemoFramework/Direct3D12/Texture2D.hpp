@@ -19,13 +19,22 @@
 
 //---------------------------------------------------------------------------------------------------------------------
 
+#include "ChunkedUploader.hpp"
 #include "CommandContext.hpp"
 #include "DescriptorAllocator.hpp"
+#include "TextureCache.hpp"
+#include "UploadRing.hpp"
+
+#include "../Utility/BlockCompressor.hpp"
 
 #include <memory>
 
 //---------------------------------------------------------------------------------------------------------------------
 
+#define DF_TEXTURE2D_DEFAULT_STREAM_TAIL_SIZE 64
+
+//---------------------------------------------------------------------------------------------------------------------
+
 namespace DemoFramework { namespace D3D12 {
 	class Texture2D;
 }}
@@ -40,6 +49,11 @@ public:
 	{
 		Unorm,
 		Float,
+
+		// Radiance (.hdr) images decoded natively into half float or shared exponent texels, taking a half or a
+		// quarter of the memory of Float. Only RGBA channels are supported, and neither can be block compressed.
+		HalfFloat,      // R16G16B16A16_FLOAT
+		SharedExponent, // R9G9B9E5_SHAREDEXP
 	};
 
 	enum class Channel
@@ -49,6 +63,67 @@ public:
 		RGBA, // 4-channel: red, green, blue, alpha
 	};
 
+	struct LoadOptions
+	{
+		LoadOptions();
+
+		uint32_t mipCount;
+
+		// Store the texture in a block-compressed format (BC4 for L, BC5 for LA, BC7 for RGBA and BC6H for
+		// floating point RGBA). Combinations without a suitable format are loaded uncompressed.
+		bool blockCompress;
+
+		// Block-compressed format to use instead of the default one picked for the data type and channels. Must be
+		// one of BC1, BC3 or BC7 for RGBA, BC4 for L, BC5 for LA, or BC6H_UF16 for floating point RGBA; anything else
+		// loads the texture uncompressed. Only used when 'blockCompress' is set.
+		DXGI_FORMAT compressedFormat;
+
+		// Speed/quality tradeoff of the block compression encoder.
+		Utility::BlockCompressor::Quality compressQuality;
+
+		// Keep non-power-of-2 images at their original size instead of resizing them up to the next power of 2.
+		bool keepDimensions;
+
+		// Filter used when resizing non-power-of-2 images up to the next power of 2.
+		Utility::ImageResampler::Filter resizeFilter;
+
+		// Filter used to downsample each mip level from the one above it.
+		Utility::ImageResampler::Filter mipFilter;
+
+		// Only upload the mip tail during Load(). The rest of the mip chain is processed on a background thread and
+		// uploaded through Stream(), with sampling clamped to the most detailed mip uploaded so far. Streamed loads
+		// are not written back to the texture cache, but are still loaded from it when an entry already exists. If the
+		// background processing fails, streaming ends with the texture clamped to the mips uploaded before the failure.
+		bool stream;
+
+		// Largest dimension of the mips uploaded up front when streaming.
+		uint32_t streamTailSize;
+
+		// Optional cache of processed texture data. When set, the result of decoding, resizing, mipmapping and
+		// compressing the source image is saved to the cache and reused the next time the same file is loaded
+		// with the same options.
+		TextureCache::Ptr cache;
+
+		// Optional uploader for textures whose staging data doesn't fit in the upload ring. Without one, those get a
+		// dedicated upload buffer holding the whole mip chain; with one, they're uploaded in bands of rows through its
+		// fixed-size window instead, which keeps upload memory bounded no matter how large the texture is. Its copies
+		// are submitted on its own queue during the load, so the upload command list must go to that same queue.
+		ChunkedUploader::Ptr chunkedUploader;
+	};
+
+	// One texture in a call to LoadMany().
+	struct LoadRequest
+	{
+		LoadRequest();
+
+		const char* filePath;
+
+		DataType dataType;
+		Channel channel;
+
+		LoadOptions options;
+	};
+
 	typedef std::shared_ptr<Texture2D> Ptr;
 
 	Texture2D();
@@ -59,9 +134,17 @@ public:
 	Texture2D& operator =(const Texture2D&) = delete;
 	Texture2D& operator =(Texture2D&&) = delete;
 
+	// The copies to the texture are recorded on the upload command list, reading from staging memory allocated from
+	// the upload ring. Signal the ring once the command list has been submitted so the memory can be reused.
+	//
+	// Files ending in DF_SUPERCOMPRESSED_TEXTURE_FILE_EXTENSION hold a Utility::SupercompressedTexture, which is
+	// transcoded on the shared thread pool to BC7 for RGBA (or BC1 when 'compressedFormat' asks for it), BC4 for L and
+	// BC5 for LA. They must be loaded as Unorm and come already mipmapped, so of the load options only 'mipCount',
+	// 'compressedFormat' and 'chunkedUploader' apply to them; they're never cached or streamed.
 	static Ptr Load(
 		const Device::Ptr& device,
 		const GraphicsCommandList::Ptr& uploadCmdList,
+		const UploadRing::Ptr& uploadRing,
 		const DescriptorAllocator::Ptr& srvAlloc,
 		DataType dataType,
 		Channel channel,
@@ -69,29 +152,187 @@ public:
 		uint32_t mipCount = D3D12_REQ_MIP_LEVELS
 	);
 
+	static Ptr Load(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& uploadCmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		DataType dataType,
+		Channel channel,
+		const char* filePath,
+		const LoadOptions& options
+	);
+
+	// Load a batch of textures, decoding and processing all of them in parallel on the shared thread pool. The uploads
+	// are then recorded on the upload command list in request order, so the recorded commands and the descriptors
+	// allocated for the textures do not depend on which image finishes processing first. The staging data for every
+	// non-streamed texture in the batch is packed into a single allocation from the upload ring when it fits.
+	//
+	// Each texture is written to the matching entry of 'pOutTextures', which is left empty when that texture fails to
+	// load. Returns true only when every texture was loaded.
+	static bool LoadMany(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& uploadCmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		const LoadRequest* pRequests,
+		size_t requestCount,
+		Ptr* pOutTextures
+	);
+
+	// Hash of the load parameters that affect the processed texture data. Loads of the same source with the same
+	// parameter hash produce the same texture.
+	static uint64_t GetParamHash(DataType dataType, Channel channel, const LoadOptions& options);
+
+	// Record copies for up to 'byteBudget' bytes of streamed mip data and return the number of bytes recorded. This
+	// should be called once per frame on the command list for that frame, before any draws using the texture. Does
+	// nothing for textures that aren't being streamed.
+	uint64_t Stream(const GraphicsCommandList::Ptr& cmdList, uint64_t byteBudget);
+
+	// Change which mips of the texture are resident, keeping mips [residentMip, mipCount) in memory. A resident mip equal
+	// to the mip count evicts the texture entirely, leaving a null descriptor in its place. Dropping mips copies the
+	// remaining ones into a smaller resource on the GPU right away. Bringing mips back reloads the texture from its
+	// source file (or the texture cache) on the shared thread pool, and UpdateResidencyChange() has to be called each
+	// frame until the reload is done and its upload has been recorded. Either way, the descriptor keeps pointing at the
+	// old resource until CompleteResidencyChange() is called, which shouldn't happen until the GPU has finished every
+	// frame that was queued before the change was recorded. Textures that are still streaming can't change residency.
+	//
+	// These are normally driven by a TextureResidencyManager.
+	bool BeginResidencyChange(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
+		uint32_t residentMip);
+
+	// Record the upload for a restore once its reload has finished in the background. Returns false when the reload
+	// failed, in which case the change is abandoned and the texture keeps its current residency.
+	bool UpdateResidencyChange(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing);
+
+	// Switch the descriptor over to the new resource. A restore whose upload hasn't been recorded yet is abandoned.
+	void CompleteResidencyChange(const Device::Ptr& device, const UploadRing::Ptr& uploadRing);
+
+	// Size of the GPU allocation backing the texture while mips [residentMip, mipCount) are resident.
+	uint64_t GetAllocationSize(const Device::Ptr& device, uint32_t residentMip) const;
+
+	// Least detailed mip the texture can be trimmed down to while keeping every mip that fits within 'tailSize' on
+	// both axes. Block-compressed textures are further limited to mips that are a whole number of blocks in size.
+	uint32_t GetMaxTrimMip(uint32_t tailSize) const;
+
+	// Path the texture was loaded from, or an empty string.
+	const char* GetFilePath() const;
+
+	const Resource::Ptr& GetResource() const;
 	const DescriptorAllocator::Ptr& GetSrvAllocator() const;
 	const Descriptor& GetDescriptor() const;
 
 	uint32_t GetWidth() const;
 	uint32_t GetHeight() const;
 	uint32_t GetMipCount() const;
+	uint32_t GetResidentMip() const;
 	DXGI_FORMAT GetFormat() const;
 
+	bool IsFullyResident() const;
+	bool IsEvicted() const;
+	bool IsStreaming() const;
+	bool IsResidencyChangePending() const;
+
+	// Whether the pending residency change has everything it needs recorded on the GPU and only has to be completed.
+	bool IsResidencyChangeRecorded() const;
+
 
 private:
 
+	struct StreamJob;
+	struct StreamData;
+	struct RestoreJob;
+	struct RestoreData;
+	struct StagingArena;
+	struct ProcessedImage;
+	struct LoadSource;
+
+	struct SubresourceData
+	{
+		const uint8_t* pData;
+		uint64_t rowPitch;
+		uint64_t rowSize;
+		uint32_t rowCount;
+	};
+
+	static Ptr _create(
+		const Device::Ptr&,
+		const GraphicsCommandList::Ptr&,
+		const UploadRing::Ptr&,
+		const ChunkedUploader::Ptr&,
+		const DescriptorAllocator::Ptr&,
+		DXGI_FORMAT,
+		uint32_t,
+		uint32_t,
+		uint32_t,
+		uint32_t,
+		const SubresourceData*,
+		const UploadRing::Allocation*,
+		Resource::Ptr*);
+
+	static Resource::Ptr _createResource(
+		const Device::Ptr&,
+		const GraphicsCommandList::Ptr&,
+		const UploadRing::Ptr&,
+		const ChunkedUploader::Ptr&,
+		DXGI_FORMAT,
+		uint32_t,
+		uint32_t,
+		uint32_t,
+		uint32_t,
+		const SubresourceData*,
+		const UploadRing::Allocation*,
+		Resource::Ptr*);
+
+	static Ptr _createStreamed(
+		const Device::Ptr&,
+		const GraphicsCommandList::Ptr&,
+		const UploadRing::Ptr&,
+		const DescriptorAllocator::Ptr&,
+		const std::shared_ptr<StreamJob>&);
+
+	static bool _processImage(const Device::Ptr&, DataType, Channel, const char*, const LoadOptions&, StagingArena*, ProcessedImage&);
+	static bool _processSupercompressed(const Device::Ptr&, DataType, Channel, const char*, const LoadOptions&, StagingArena*, ProcessedImage&);
+
+	static Ptr _createProcessed(
+		const Device::Ptr&,
+		const GraphicsCommandList::Ptr&,
+		const UploadRing::Ptr&,
+		const ChunkedUploader::Ptr&,
+		const DescriptorAllocator::Ptr&,
+		ProcessedImage&,
+		const UploadRing::Allocation*);
+
+	static void _runStreamJob(StreamJob&);
+
+	void _setSource(DataType, Channel, const char*, const LoadOptions&);
+
 	Resource::Ptr m_resource;
-	Resource::Ptr m_staging;
+	Resource::Ptr m_pendingResource;
 
 	DescriptorAllocator::Ptr m_alloc;
 
 	Descriptor m_descriptor;
 
+	StreamData* m_pStream;
+	RestoreData* m_pRestore;
+	LoadSource* m_pSource;
+
 	uint32_t m_width;
 	uint32_t m_height;
 	uint32_t m_mipCount;
+	uint32_t m_residentMip;
+	uint32_t m_pendingMip;
 
 	DXGI_FORMAT m_format;
+
+	bool m_residencyPending;
 };
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -100,26 +341,56 @@ template class DF_API std::shared_ptr<DemoFramework::D3D12::Texture2D>;
 
 //---------------------------------------------------------------------------------------------------------------------
 
+inline DemoFramework::D3D12::Texture2D::LoadOptions::LoadOptions()
+	: mipCount(D3D12_REQ_MIP_LEVELS)
+	, blockCompress(false)
+	, compressedFormat(DXGI_FORMAT_UNKNOWN)
+	, compressQuality(Utility::BlockCompressor::Quality::Quality)
+	, keepDimensions(false)
+	, resizeFilter(Utility::ImageResampler::Filter::Lanczos)
+	, mipFilter(Utility::ImageResampler::Filter::Box)
+	, stream(false)
+	, streamTailSize(DF_TEXTURE2D_DEFAULT_STREAM_TAIL_SIZE)
+	, cache()
+	, chunkedUploader()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::Texture2D::LoadRequest::LoadRequest()
+	: filePath(nullptr)
+	, dataType(DataType::Unorm)
+	, channel(Channel::RGBA)
+	, options()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 inline DemoFramework::D3D12::Texture2D::Texture2D()
 	: m_resource()
-	, m_staging()
+	, m_pendingResource()
 	, m_alloc()
 	, m_descriptor()
+	, m_pStream(nullptr)
+	, m_pRestore(nullptr)
+	, m_pSource(nullptr)
 	, m_width(0)
 	, m_height(0)
 	, m_mipCount(0)
+	, m_residentMip(0)
+	, m_pendingMip(0)
 	, m_format(DXGI_FORMAT_UNKNOWN)
+	, m_residencyPending(false)
 {
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 
-inline DemoFramework::D3D12::Texture2D::~Texture2D()
+inline const DemoFramework::D3D12::Resource::Ptr& DemoFramework::D3D12::Texture2D::GetResource() const
 {
-	if(m_alloc)
-	{
-		m_alloc->Free(m_descriptor);
-	}
+	return m_resource;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -159,9 +430,51 @@ inline uint32_t DemoFramework::D3D12::Texture2D::GetMipCount() const
 
 //---------------------------------------------------------------------------------------------------------------------
 
+inline uint32_t DemoFramework::D3D12::Texture2D::GetResidentMip() const
+{
+	return m_residentMip;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 inline DXGI_FORMAT DemoFramework::D3D12::Texture2D::GetFormat() const
 {
 	return m_format;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::Texture2D::IsFullyResident() const
+{
+	return m_residentMip == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::Texture2D::IsEvicted() const
+{
+	return m_residentMip == m_mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::Texture2D::IsStreaming() const
+{
+	return m_pStream != nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::Texture2D::IsResidencyChangePending() const
+{
+	return m_residencyPending;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::Texture2D::IsResidencyChangeRecorded() const
+{
+	return m_residencyPending && !m_pRestore;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,588 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "TextureAtlas.hpp"
+
+#include "LowLevel/Resource.hpp"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Math.hpp"
+#include "../Utility/SkylinePacker.hpp"
+#include "../Utility/Stopwatch.hpp"
+#include "../Utility/TextureFootprint.hpp"
+
+#include <DirectXTex.h>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the group list using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::D3D12::TextureAtlas::GroupList
+{
+	struct Group
+	{
+		Resource::Ptr resource;
+		Descriptor descriptor;
+
+		DXGI_FORMAT format;
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipCount;
+		uint32_t sliceCount;
+	};
+
+	std::vector<Group> groups;
+	std::vector<Placement> placements;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static D3D12_RESOURCE_DESC GetArrayResourceDesc(
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	const uint32_t sliceCount)
+{
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	const D3D12_RESOURCE_DESC resDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_TEXTURE2D, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                  // UINT64 Alignment
+		uint64_t(width),                    // UINT64 Width
+		height,                             // UINT Height
+		uint16_t(sliceCount),               // UINT16 DepthOrArraySize
+		uint16_t(mipCount),                 // UINT16 MipLevels
+		format,                             // DXGI_FORMAT Format
+		defaultSampleDesc,                  // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_UNKNOWN,       // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,           // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	return resDesc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Pick the atlas page size that packs the rectangles into the least total memory, preferring fewer, larger pages on
+// ties. Returns the number of pages, or 0 when nothing fits.
+static uint32_t ChoosePageSize(
+	const std::vector<DemoFramework::Utility::SkylinePacker::Size>& sizes,
+	const uint32_t maxPageSize,
+	uint32_t& outPageSize,
+	std::vector<DemoFramework::Utility::SkylinePacker::PagePlacement>& outPlacements)
+{
+	using namespace DemoFramework::Utility;
+
+	uint32_t largestSize = 0;
+
+	for(const SkylinePacker::Size& size : sizes)
+	{
+		largestSize = std::max(largestSize, std::max(size.width, size.height));
+	}
+
+	std::vector<SkylinePacker::PagePlacement> placements(sizes.size());
+
+	uint64_t bestArea = 0;
+	uint32_t bestPageCount = 0;
+
+	for(uint32_t pageSize = Math::GetPowerOfTwo(largestSize); pageSize <= maxPageSize; pageSize *= 2)
+	{
+		const uint32_t pageCount = SkylinePacker::PackPages(pageSize, pageSize, sizes.data(), sizes.size(), placements.data());
+		if(pageCount == 0)
+		{
+			continue;
+		}
+
+		const uint64_t area = uint64_t(pageSize) * uint64_t(pageSize) * pageCount;
+
+		if(bestPageCount == 0 || area <= bestArea)
+		{
+			bestArea = area;
+			bestPageCount = pageCount;
+			outPageSize = pageSize;
+			outPlacements = placements;
+		}
+	}
+
+	return bestPageCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureAtlas::TextureAtlas()
+	: m_alloc()
+	, m_pGroups(new GroupList())
+	, m_stats()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureAtlas::~TextureAtlas()
+{
+	if(m_pGroups)
+	{
+		if(m_alloc)
+		{
+			for(const GroupList::Group& group : m_pGroups->groups)
+			{
+				m_alloc->Free(group.descriptor);
+			}
+		}
+
+		delete m_pGroups;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureAtlas::Ptr DemoFramework::D3D12::TextureAtlas::Build(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const Texture2D::Ptr* const pTextures,
+	const size_t textureCount,
+	const Options& options)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device
+		|| !cmdList
+		|| !uploadRing
+		|| !srvAlloc
+		|| !pTextures
+		|| textureCount == 0
+		|| options.maxPageSize == 0
+		|| options.maxTextureSize == 0
+		|| options.maxTextureSize > options.maxPageSize)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	constexpr D3D12_HEAP_PROPERTIES gpuHeapProps =
+	{
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	const Placement unpacked =
+	{
+		InvalidGroup,   // uint32_t groupIndex
+		0,              // uint32_t arraySlice
+		0,              // uint32_t mipCount
+		{ 1.0f, 1.0f }, // float32_t uvScale[2]
+		{ 0.0f, 0.0f }, // float32_t uvOffset[2]
+	};
+
+	Stopwatch stopwatch;
+
+	Ptr output = std::make_shared<TextureAtlas>();
+
+	output->m_alloc = srvAlloc;
+	output->m_stats.textureCount = textureCount;
+
+	std::vector<GroupList::Group>& groups = output->m_pGroups->groups;
+	std::vector<Placement>& placements = output->m_pGroups->placements;
+
+	placements.assign(textureCount, unpacked);
+
+	// Ordered maps keep the group order, and with it the recorded copies, independent of the texture addresses.
+	typedef std::tuple<uint32_t, uint32_t, uint32_t, uint32_t> ArrayKey;
+
+	std::map<ArrayKey, std::vector<size_t>> arrayBuckets;
+	std::map<uint32_t, std::vector<size_t>> atlasBuckets;
+
+	for(size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex)
+	{
+		const Texture2D::Ptr& texture = pTextures[textureIndex];
+
+		if(!texture
+			|| !texture->IsFullyResident()
+			|| texture->IsStreaming()
+			|| texture->IsResidencyChangePending()
+			|| texture->GetWidth() > options.maxTextureSize
+			|| texture->GetHeight() > options.maxTextureSize)
+		{
+			continue;
+		}
+
+		const ArrayKey key(uint32_t(texture->GetFormat()), texture->GetWidth(), texture->GetHeight(), texture->GetMipCount());
+
+		arrayBuckets[key].push_back(textureIndex);
+	}
+
+	// Textures without enough others of the same size to fill an array go to the atlas pages for their format instead.
+	for(auto it = arrayBuckets.begin(); it != arrayBuckets.end();)
+	{
+		if(it->second.size() < std::max(options.minArraySize, 2u))
+		{
+			std::vector<size_t>& atlasBucket = atlasBuckets[std::get<0>(it->first)];
+
+			atlasBucket.insert(atlasBucket.end(), it->second.begin(), it->second.end());
+
+			it = arrayBuckets.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	std::vector<D3D12_RESOURCE_BARRIER> groupBarriers;
+
+	const auto createGroup = [&](
+		const DXGI_FORMAT format,
+		const uint32_t width,
+		const uint32_t height,
+		const uint32_t mipCount,
+		const uint32_t sliceCount)
+	{
+		GroupList::Group group;
+
+		group.resource = CreateCommittedResource(
+			device,
+			GetArrayResourceDesc(format, width, height, mipCount, sliceCount),
+			gpuHeapProps,
+			D3D12_HEAP_FLAG_NONE,
+			D3D12_RESOURCE_STATE_COPY_DEST);
+		if(!group.resource)
+		{
+			return false;
+		}
+
+		group.descriptor = Descriptor::Invalid;
+		group.format = format;
+		group.width = width;
+		group.height = height;
+		group.mipCount = mipCount;
+		group.sliceCount = sliceCount;
+
+		groups.push_back(group);
+
+		D3D12_RESOURCE_BARRIER barrier;
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barrier.Transition.pResource = group.resource.Get();
+		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+		barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+		groupBarriers.push_back(barrier);
+
+		return true;
+	};
+
+	struct Copy
+	{
+		size_t textureIndex;
+		uint32_t groupIndex;
+		uint32_t arraySlice;
+		uint32_t x;
+		uint32_t y;
+	};
+
+	std::vector<Copy> copies;
+
+	// Texture arrays of identically sized textures.
+	for(const auto& pair : arrayBuckets)
+	{
+		const std::vector<size_t>& bucket = pair.second;
+		const Texture2D::Ptr& firstTexture = pTextures[bucket[0]];
+
+		const bool created = createGroup(
+			firstTexture->GetFormat(),
+			firstTexture->GetWidth(),
+			firstTexture->GetHeight(),
+			firstTexture->GetMipCount(),
+			uint32_t(bucket.size()));
+		if(!created)
+		{
+			return Ptr();
+		}
+
+		for(size_t sliceIndex = 0; sliceIndex < bucket.size(); ++sliceIndex)
+		{
+			Placement& placement = placements[bucket[sliceIndex]];
+
+			placement.groupIndex = uint32_t(groups.size() - 1);
+			placement.arraySlice = uint32_t(sliceIndex);
+			placement.mipCount = firstTexture->GetMipCount();
+
+			const Copy copy =
+			{
+				bucket[sliceIndex],   // size_t textureIndex
+				placement.groupIndex, // uint32_t groupIndex
+				placement.arraySlice, // uint32_t arraySlice
+				0,                    // uint32_t x
+				0,                    // uint32_t y
+			};
+
+			copies.push_back(copy);
+		}
+
+		++output->m_stats.arrayCount;
+	}
+
+	// Atlas pages for everything else, one texture array of pages per format.
+	for(const auto& pair : atlasBuckets)
+	{
+		const std::vector<size_t>& bucket = pair.second;
+
+		if(bucket.size() < 2)
+		{
+			continue;
+		}
+
+		const DXGI_FORMAT format = DXGI_FORMAT(pair.first);
+		const uint32_t blockSize = DirectX::IsCompressed(format) ? 4 : 1;
+
+		uint32_t mipCount = D3D12_REQ_MIP_LEVELS;
+		uint32_t minDimension = UINT32_MAX;
+
+		for(const size_t textureIndex : bucket)
+		{
+			const Texture2D::Ptr& texture = pTextures[textureIndex];
+
+			mipCount = std::min(mipCount, texture->GetMipCount());
+			minDimension = std::min(minDimension, std::min(texture->GetWidth(), texture->GetHeight()));
+		}
+
+		// Each texture is placed at an offset that stays a whole number of blocks at every mip of the page, so the
+		// page only gets as many mips as the smallest texture can keep aligned.
+		while(mipCount > 1 && (blockSize << (mipCount - 1)) > minDimension)
+		{
+			--mipCount;
+		}
+
+		const uint32_t alignment = blockSize << (mipCount - 1);
+
+		std::vector<SkylinePacker::Size> sizes(bucket.size());
+
+		for(size_t bucketIndex = 0; bucketIndex < bucket.size(); ++bucketIndex)
+		{
+			const Texture2D::Ptr& texture = pTextures[bucket[bucketIndex]];
+
+			sizes[bucketIndex].width = Math::GetAlignedSize(texture->GetWidth() + options.padding, alignment);
+			sizes[bucketIndex].height = Math::GetAlignedSize(texture->GetHeight() + options.padding, alignment);
+		}
+
+		uint32_t pageSize = 0;
+		std::vector<SkylinePacker::PagePlacement> pagePlacements;
+
+		const uint32_t pageCount = ChoosePageSize(sizes, options.maxPageSize, pageSize, pagePlacements);
+		if(pageCount == 0)
+		{
+			// The padding pushed a texture over the page size; leave the whole format out.
+			LOG_WRITE(
+				"(warning) Texture atlas pages are too small for the textures; leaving them unpacked: format=%" PRIu32 ", maxPageSize=%" PRIu32,
+				uint32_t(format),
+				options.maxPageSize);
+			continue;
+		}
+
+		if(!createGroup(format, pageSize, pageSize, mipCount, pageCount))
+		{
+			return Ptr();
+		}
+
+		const float32_t texelSize = 1.0f / float32_t(pageSize);
+
+		for(size_t bucketIndex = 0; bucketIndex < bucket.size(); ++bucketIndex)
+		{
+			const Texture2D::Ptr& texture = pTextures[bucket[bucketIndex]];
+			const SkylinePacker::PagePlacement& pagePlacement = pagePlacements[bucketIndex];
+
+			Placement& placement = placements[bucket[bucketIndex]];
+
+			placement.groupIndex = uint32_t(groups.size() - 1);
+			placement.arraySlice = pagePlacement.pageIndex;
+			placement.mipCount = mipCount;
+			placement.uvScale[0] = float32_t(texture->GetWidth()) * texelSize;
+			placement.uvScale[1] = float32_t(texture->GetHeight()) * texelSize;
+			placement.uvOffset[0] = float32_t(pagePlacement.rect.x) * texelSize;
+			placement.uvOffset[1] = float32_t(pagePlacement.rect.y) * texelSize;
+
+			const Copy copy =
+			{
+				bucket[bucketIndex],  // size_t textureIndex
+				placement.groupIndex, // uint32_t groupIndex
+				placement.arraySlice, // uint32_t arraySlice
+				pagePlacement.rect.x, // uint32_t x
+				pagePlacement.rect.y, // uint32_t y
+			};
+
+			copies.push_back(copy);
+		}
+
+		output->m_stats.pageCount += pageCount;
+	}
+
+	if(copies.empty())
+	{
+		LOG_WRITE("Built TextureAtlas: textures=%zu, packed=0", textureCount);
+		return output;
+	}
+
+	std::vector<D3D12_RESOURCE_BARRIER> sourceBarriers(copies.size());
+
+	// Every texture going into a group is copied from, so they all need to be in the copy source state first.
+	for(size_t copyIndex = 0; copyIndex < copies.size(); ++copyIndex)
+	{
+		D3D12_RESOURCE_BARRIER& barrier = sourceBarriers[copyIndex];
+
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barrier.Transition.pResource = pTextures[copies[copyIndex].textureIndex]->GetResource().Get();
+		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+	}
+
+	cmdList->ResourceBarrier(UINT(sourceBarriers.size()), sourceBarriers.data());
+
+	D3D12_TEXTURE_COPY_LOCATION srcLoc;
+	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+	D3D12_TEXTURE_COPY_LOCATION destLoc;
+	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+	for(const Copy& copy : copies)
+	{
+		const Texture2D::Ptr& texture = pTextures[copy.textureIndex];
+		const GroupList::Group& group = groups[copy.groupIndex];
+
+		srcLoc.pResource = texture->GetResource().Get();
+		destLoc.pResource = group.resource.Get();
+
+		for(uint32_t mipIndex = 0; mipIndex < group.mipCount; ++mipIndex)
+		{
+			srcLoc.SubresourceIndex = mipIndex;
+			destLoc.SubresourceIndex = mipIndex + (copy.arraySlice * group.mipCount);
+
+			cmdList->CopyTextureRegion(&destLoc, copy.x >> mipIndex, copy.y >> mipIndex, 0, &srcLoc, nullptr);
+		}
+
+		// The caller is free to release the texture now, but the copies above still need its resource.
+		uploadRing->DeferRelease(texture->GetResource());
+
+		output->m_stats.sourceSize += texture->GetAllocationSize(device, 0);
+	}
+
+	// Flip the source barriers around to put the textures back the way they were.
+	for(D3D12_RESOURCE_BARRIER& barrier : sourceBarriers)
+	{
+		barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+		barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	}
+
+	sourceBarriers.insert(sourceBarriers.end(), groupBarriers.begin(), groupBarriers.end());
+
+	cmdList->ResourceBarrier(UINT(sourceBarriers.size()), sourceBarriers.data());
+
+	for(GroupList::Group& group : groups)
+	{
+		group.descriptor = srvAlloc->Allocate();
+
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
+		srvDesc.Format = group.format;
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.Texture2DArray.MostDetailedMip = 0;
+		srvDesc.Texture2DArray.MipLevels = group.mipCount;
+		srvDesc.Texture2DArray.FirstArraySlice = 0;
+		srvDesc.Texture2DArray.ArraySize = group.sliceCount;
+		srvDesc.Texture2DArray.PlaneSlice = 0;
+		srvDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+
+		device->CreateShaderResourceView(group.resource.Get(), &srvDesc, group.descriptor.cpuHandle);
+
+		const D3D12_RESOURCE_DESC resDesc = GetArrayResourceDesc(group.format, group.width, group.height, group.mipCount, group.sliceCount);
+
+		output->m_stats.packedSize += device->GetResourceAllocationInfo(0, 1, &resDesc).SizeInBytes;
+	}
+
+	output->m_stats.packedCount = copies.size();
+	output->m_stats.sourceDescriptorCount = copies.size();
+	output->m_stats.packedDescriptorCount = groups.size();
+
+	const Stats& stats = output->m_stats;
+
+	LOG_WRITE(
+		"Built TextureAtlas: textures=%zu, packed=%zu, arrays=%zu, atlasPages=%zu, sourceSize=%" PRIu64 ", packedSize=%" PRIu64 ", sourceDescriptors=%zu, packedDescriptors=%zu, time=%.2fms",
+		stats.textureCount,
+		stats.packedCount,
+		stats.arrayCount,
+		stats.pageCount,
+		stats.sourceSize,
+		stats.packedSize,
+		stats.sourceDescriptorCount,
+		stats.packedDescriptorCount,
+		stopwatch.GetElapsedMs());
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::D3D12::TextureAtlas::Placement& DemoFramework::D3D12::TextureAtlas::GetPlacement(const size_t textureIndex) const
+{
+	assert(textureIndex < m_pGroups->placements.size());
+
+	return m_pGroups->placements[textureIndex];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::D3D12::TextureAtlas::GetGroupCount() const
+{
+	return m_pGroups->groups.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::D3D12::Resource::Ptr& DemoFramework::D3D12::TextureAtlas::GetResource(const size_t groupIndex) const
+{
+	assert(groupIndex < m_pGroups->groups.size());
+
+	return m_pGroups->groups[groupIndex].resource;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::TextureAtlas::GetDescriptor(const size_t groupIndex) const
+{
+	assert(groupIndex < m_pGroups->groups.size());
+
+	return m_pGroups->groups[groupIndex].descriptor;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Texture2D.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_TEXTURE_ATLAS_DEFAULT_MAX_PAGE_SIZE    2048
+#define DF_TEXTURE_ATLAS_DEFAULT_MAX_TEXTURE_SIZE 256
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class TextureAtlas;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Packs many small textures into a handful of texture arrays to save on the 64KB alignment every committed resource
+// pays, and on the descriptor each texture would otherwise need. Textures sharing a format, size and mip count are
+// copied into the slices of a texture array. The rest are grouped by format and packed into atlas pages with a
+// skyline packer, and the pages of each format are stored as the slices of one more texture array. Every group ends
+// up with a single SRV, and every texture gets a slice index and a UV transform into its group.
+//
+// Textures are placed in atlas pages at offsets aligned to their least detailed shared mip, so only that many mips are
+// kept for the page; see Placement::mipCount. Shaders sampling from atlas pages should clamp their UVs to the region
+// of the texture (and wrap them manually, if needed) since neighboring textures are only separated by the padding.
+//
+// Everything is copied on the GPU from the already loaded textures, which can be released as soon as the atlas is
+// built; their resources are kept alive through the upload ring until the copies are done.
+class DF_API DemoFramework::D3D12::TextureAtlas
+{
+public:
+
+	typedef std::shared_ptr<TextureAtlas> Ptr;
+
+	static constexpr uint32_t InvalidGroup = UINT32_MAX;
+
+	struct Options
+	{
+		Options();
+
+		// Largest width and height of an atlas page. Smaller pages are used when they waste less memory.
+		uint32_t maxPageSize;
+
+		// Textures larger than this on either axis are left out of the atlas.
+		uint32_t maxTextureSize;
+
+		// Minimum number of texels between textures in an atlas page.
+		uint32_t padding;
+
+		// Minimum number of identically sized textures needed to get a texture array of their own.
+		uint32_t minArraySize;
+	};
+
+	// Where a texture ended up. Textures that were left out have an invalid group index.
+	struct Placement
+	{
+		uint32_t groupIndex;
+		uint32_t arraySlice;
+
+		// Mips available to the texture in its group.
+		uint32_t mipCount;
+
+		// Maps the [0, 1] UV range of the original texture to its region of the array slice.
+		float32_t uvScale[2];
+		float32_t uvOffset[2];
+	};
+
+	struct Stats
+	{
+		size_t textureCount;
+		size_t packedCount;
+		size_t arrayCount;
+		size_t pageCount;
+
+		// Allocation sizes of the packed textures as separate resources, and of the groups they were packed into.
+		uint64_t sourceSize;
+		uint64_t packedSize;
+
+		// Descriptors used by the packed textures on their own, and by the groups they were packed into.
+		size_t sourceDescriptorCount;
+		size_t packedDescriptorCount;
+	};
+
+	TextureAtlas();
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas(TextureAtlas&&) = delete;
+	~TextureAtlas();
+
+	TextureAtlas& operator =(const TextureAtlas&) = delete;
+	TextureAtlas& operator =(TextureAtlas&&) = delete;
+
+	// Record the copies packing the textures on the command list. Textures that are streaming, have mips trimmed or
+	// evicted, or are too large are left out, as is any texture with nothing to share a group with.
+	static Ptr Build(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		const Texture2D::Ptr* pTextures,
+		size_t textureCount,
+		const Options& options = Options()
+	);
+
+	// Placement of the texture at the given index of the array passed to Build().
+	const Placement& GetPlacement(size_t textureIndex) const;
+	bool IsPacked(size_t textureIndex) const;
+
+	size_t GetGroupCount() const;
+	const Resource::Ptr& GetResource(size_t groupIndex) const;
+	const Descriptor& GetDescriptor(size_t groupIndex) const;
+
+	const Stats& GetStats() const;
+
+
+private:
+
+	struct GroupList;
+
+	DescriptorAllocator::Ptr m_alloc;
+
+	GroupList* m_pGroups;
+
+	Stats m_stats;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::TextureAtlas>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::TextureAtlas::Options::Options()
+	: maxPageSize(DF_TEXTURE_ATLAS_DEFAULT_MAX_PAGE_SIZE)
+	, maxTextureSize(DF_TEXTURE_ATLAS_DEFAULT_MAX_TEXTURE_SIZE)
+	, padding(4)
+	, minArraySize(2)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::TextureAtlas::IsPacked(const size_t textureIndex) const
+{
+	return GetPlacement(textureIndex).groupIndex != InvalidGroup;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::TextureAtlas::Stats& DemoFramework::D3D12::TextureAtlas::GetStats() const
+{
+	return m_stats;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,305 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "TextureCache.hpp"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Hash.hpp"
+#include "../Utility/Math.hpp"
+
+#include <stdio.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_TEXTURE_CACHE_MAGIC   0x58455444ul // "DTEX"
+#define DF_TEXTURE_CACHE_VERSION 1
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct TextureCacheFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	DemoFramework::D3D12::TextureCache::Key key;
+
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipCount;
+
+	uint64_t dataOffset;
+	uint64_t dataSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureCache::Ptr DemoFramework::D3D12::TextureCache::Create(const char* const directoryPath)
+{
+	if(!directoryPath || directoryPath[0] == '\0' || strlen(directoryPath) >= MAX_PATH)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<TextureCache>();
+
+	snprintf(output->m_directoryPath, MAX_PATH, "%s", directoryPath);
+
+	char partialPath[MAX_PATH];
+
+	// Create each directory along the path. Failures are ignored here since most of
+	// them will simply be directories that already exist; the final check catches the rest.
+	for(size_t i = 0; directoryPath[i] != '\0'; ++i)
+	{
+		partialPath[i] = directoryPath[i];
+
+		if((directoryPath[i + 1] == '/' || directoryPath[i + 1] == '\\' || directoryPath[i + 1] == '\0')
+			&& directoryPath[i] != ':')
+		{
+			partialPath[i + 1] = '\0';
+			CreateDirectoryA(partialPath, nullptr);
+		}
+	}
+
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if(!GetFileAttributesExA(directoryPath, GetFileExInfoStandard, &attributes)
+		|| (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+	{
+		LOG_ERROR("Failed to create texture cache directory: path=\"%s\"", directoryPath);
+		return Ptr();
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureCache::MakeKey(
+	const char* const sourceFilePath,
+	const uint64_t paramHash,
+	Key& outKey) const
+{
+	if(!sourceFilePath || sourceFilePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const Utility::MappedFile::Ptr sourceFile = Utility::MappedFile::Open(sourceFilePath);
+	if(!sourceFile)
+	{
+		return false;
+	}
+
+	outKey.pathHash = Utility::Hash::Compute(sourceFilePath, strlen(sourceFilePath));
+	outKey.paramHash = paramHash;
+	outKey.contentHash = Utility::Hash::Compute(sourceFile->GetData(), size_t(sourceFile->GetSize()));
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureCache::Find(const Key& key, Entry& outEntry) const
+{
+	char entryPath[MAX_PATH];
+	_getEntryPath(key, entryPath, sizeof(entryPath));
+
+	Utility::MappedFile::Ptr file = Utility::MappedFile::Open(entryPath);
+	if(!file)
+	{
+		// No cache entry exists.
+		return false;
+	}
+
+	if(file->GetSize() < sizeof(TextureCacheFileHeader))
+	{
+		return false;
+	}
+
+	TextureCacheFileHeader header;
+	memcpy(&header, file->GetData(), sizeof(header));
+
+	const uint64_t subresourceTableEnd = sizeof(TextureCacheFileHeader) + (sizeof(Subresource) * uint64_t(header.mipCount));
+
+	// Reject entries from other versions, entries made from a different version of the source
+	// file, and any entry that was truncated while being written.
+	if(header.magic != DF_TEXTURE_CACHE_MAGIC
+		|| header.version != DF_TEXTURE_CACHE_VERSION
+		|| header.key.pathHash != key.pathHash
+		|| header.key.paramHash != key.paramHash
+		|| header.key.contentHash != key.contentHash
+		|| header.mipCount == 0
+		|| header.mipCount > D3D12_REQ_MIP_LEVELS
+		|| header.dataOffset < subresourceTableEnd
+		|| header.dataOffset + header.dataSize > file->GetSize())
+	{
+		return false;
+	}
+
+	outEntry.pSubresources = reinterpret_cast<const Subresource*>(file->GetData() + sizeof(TextureCacheFileHeader));
+	outEntry.pData = file->GetData() + header.dataOffset;
+	outEntry.dataSize = header.dataSize;
+	outEntry.format = DXGI_FORMAT(header.format);
+	outEntry.width = header.width;
+	outEntry.height = header.height;
+	outEntry.mipCount = header.mipCount;
+	outEntry.file = file;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureCache::Store(
+	const Key& key,
+	const DXGI_FORMAT format,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	const SourceSubresource* const pSubresources) const
+{
+	using namespace DemoFramework::Utility;
+
+	if(format == DXGI_FORMAT_UNKNOWN
+		|| width == 0
+		|| height == 0
+		|| mipCount == 0
+		|| mipCount > D3D12_REQ_MIP_LEVELS
+		|| !pSubresources)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	Subresource subresources[D3D12_REQ_MIP_LEVELS];
+
+	uint64_t dataSize = 0;
+
+	// Lay the subresources out the same way they will be placed in the upload buffer.
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const SourceSubresource& source = pSubresources[mipIndex];
+		Subresource& subresource = subresources[mipIndex];
+
+		subresource.offset = Math::GetAlignedSize(dataSize, uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+		subresource.rowSize = source.rowSize;
+		subresource.rowPitch = uint32_t(Math::GetAlignedSize(source.rowSize, uint64_t(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT)));
+		subresource.rowCount = source.rowCount;
+		subresource.width = source.width;
+		subresource.height = source.height;
+
+		// The last row of a subresource doesn't need any padding after it.
+		dataSize = subresource.offset + (uint64_t(subresource.rowPitch) * (subresource.rowCount - 1)) + subresource.rowSize;
+	}
+
+	TextureCacheFileHeader header;
+	header.magic = DF_TEXTURE_CACHE_MAGIC;
+	header.version = DF_TEXTURE_CACHE_VERSION;
+	header.key = key;
+	header.format = uint32_t(format);
+	header.width = width;
+	header.height = height;
+	header.mipCount = mipCount;
+	header.dataOffset = Math::GetAlignedSize(
+		uint64_t(sizeof(TextureCacheFileHeader) + (sizeof(Subresource) * mipCount)),
+		uint64_t(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
+	header.dataSize = dataSize;
+
+	char entryPath[MAX_PATH];
+	_getEntryPath(key, entryPath, sizeof(entryPath));
+
+	FILE* const pFile = fopen(entryPath, "wb");
+	if(!pFile)
+	{
+		LOG_ERROR("Failed to open texture cache entry for writing: path=\"%s\"", entryPath);
+		return false;
+	}
+
+	uint8_t padding[D3D12_TEXTURE_DATA_PITCH_ALIGNMENT] = {};
+
+	auto writePadding = [&pFile, &padding](uint64_t size) -> bool
+	{
+		while(size > 0)
+		{
+			const size_t writeSize = size_t((size < sizeof(padding)) ? size : sizeof(padding));
+			if(fwrite(padding, 1, writeSize, pFile) != writeSize)
+			{
+				return false;
+			}
+
+			size -= writeSize;
+		}
+
+		return true;
+	};
+
+	bool result = (fwrite(&header, sizeof(header), 1, pFile) == 1)
+		&& (fwrite(subresources, sizeof(Subresource), mipCount, pFile) == mipCount)
+		&& writePadding(header.dataOffset - sizeof(header) - (sizeof(Subresource) * mipCount));
+
+	uint64_t writeOffset = 0;
+
+	// Write the texel data for each subresource, padding each row out to the aligned row pitch.
+	for(uint32_t mipIndex = 0; result && mipIndex < mipCount; ++mipIndex)
+	{
+		const SourceSubresource& source = pSubresources[mipIndex];
+		const Subresource& subresource = subresources[mipIndex];
+
+		result = writePadding(subresource.offset - writeOffset);
+		writeOffset = subresource.offset;
+
+		for(uint32_t row = 0; result && row < subresource.rowCount; ++row)
+		{
+			result = (fwrite(source.pData + (source.rowPitch * row), size_t(source.rowSize), 1, pFile) == 1);
+			writeOffset += source.rowSize;
+
+			if(result && row + 1 < subresource.rowCount)
+			{
+				result = writePadding(subresource.rowPitch - subresource.rowSize);
+				writeOffset += subresource.rowPitch - subresource.rowSize;
+			}
+		}
+	}
+
+	fclose(pFile);
+
+	if(!result)
+	{
+		LOG_ERROR("Failed to write texture cache entry: path=\"%s\"", entryPath);
+
+		// Don't leave a partial entry behind.
+		remove(entryPath);
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::TextureCache::_getEntryPath(const Key& key, char* const outPath, const size_t pathSize) const
+{
+	// Only the path and parameters go into the entry name so a changed source file replaces its old entry
+	// instead of leaving it behind. The content hash is verified against the header on lookup.
+	const uint64_t nameHash = Utility::Hash::Combine(key.pathHash, key.paramHash);
+
+	snprintf(outPath, pathSize, "%s/%016" PRIx64 DF_TEXTURE_CACHE_FILE_EXTENSION, m_directoryPath, nameHash);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
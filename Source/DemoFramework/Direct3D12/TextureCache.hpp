@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "LowLevel/Types.hpp"
+
+#include "../Utility/MappedFile.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_TEXTURE_CACHE_FILE_EXTENSION ".dftex"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class TextureCache;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// On-disk cache of fully processed texture data (resized, mipmapped and optionally block compressed). Each entry is a
+// single file holding a small header, a table of subresource layouts and the texel data laid out exactly the way
+// D3D12 expects it in an upload buffer, so a cache hit only needs to map the file and copy it into staging memory.
+//
+// Entries are named after the source path and load parameters. The hash of the source file's contents is stored in
+// the entry as well, so editing the source file invalidates the entry the next time it's looked up.
+class DF_API DemoFramework::D3D12::TextureCache
+{
+public:
+
+	typedef std::shared_ptr<TextureCache> Ptr;
+
+	struct Key
+	{
+		uint64_t pathHash;
+		uint64_t paramHash;
+		uint64_t contentHash;
+	};
+
+	struct Subresource
+	{
+		uint64_t offset;   // Byte offset of the subresource from the start of the entry's texel data
+		uint64_t rowSize;  // Size in bytes of the meaningful data in each row
+		uint32_t rowPitch; // Byte stride between rows
+		uint32_t rowCount; // Number of rows (block rows for block-compressed formats)
+		uint32_t width;
+		uint32_t height;
+	};
+
+	struct Entry
+	{
+		Utility::MappedFile::Ptr file;
+
+		const Subresource* pSubresources;
+		const uint8_t* pData;
+		uint64_t dataSize;
+
+		DXGI_FORMAT format;
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipCount;
+	};
+
+	// Describes the texel data of one subresource to be stored in the cache.
+	struct SourceSubresource
+	{
+		const uint8_t* pData;
+		uint64_t rowPitch;
+		uint64_t rowSize;
+		uint32_t rowCount;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	TextureCache();
+	TextureCache(const TextureCache&) = delete;
+	TextureCache(TextureCache&&) = delete;
+
+	TextureCache& operator =(const TextureCache&) = delete;
+	TextureCache& operator =(TextureCache&&) = delete;
+
+	static Ptr Create(const char* directoryPath);
+
+	// Build the key for a source file. This reads the entire source file to hash its contents.
+	bool MakeKey(const char* sourceFilePath, uint64_t paramHash, Key& outKey) const;
+
+	bool Find(const Key& key, Entry& outEntry) const;
+
+	bool Store(
+		const Key& key,
+		DXGI_FORMAT format,
+		uint32_t width,
+		uint32_t height,
+		uint32_t mipCount,
+		const SourceSubresource* pSubresources) const;
+
+
+private:
+
+	void _getEntryPath(const Key&, char*, size_t) const;
+
+	char m_directoryPath[MAX_PATH];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::TextureCache>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::TextureCache::TextureCache()
+	: m_directoryPath()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
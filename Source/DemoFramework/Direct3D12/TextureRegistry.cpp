@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "TextureRegistry.hpp"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Hash.hpp"
+#include "../Utility/MappedFile.hpp"
+
+#include <ctype.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureRegistry::Ptr DemoFramework::D3D12::TextureRegistry::Create(const KeyMode keyMode)
+{
+	Ptr output = std::make_shared<TextureRegistry>();
+
+	output->m_keyMode = keyMode;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::TextureRegistry::Load(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const Texture2D::DataType dataType,
+	const Texture2D::Channel channel,
+	const char* const filePath,
+	const uint32_t mipCount)
+{
+	Texture2D::LoadOptions options;
+	options.mipCount = mipCount;
+
+	return Load(device, uploadCmdList, uploadRing, srvAlloc, dataType, channel, filePath, options);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::Texture2D::Ptr DemoFramework::D3D12::TextureRegistry::Load(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& uploadCmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const Texture2D::DataType dataType,
+	const Texture2D::Channel channel,
+	const char* const filePath,
+	const Texture2D::LoadOptions& options)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Texture2D::Ptr();
+	}
+
+	uint64_t key = 0;
+
+	if(!_makeKey(dataType, channel, filePath, options, key))
+	{
+		return Texture2D::Ptr();
+	}
+
+	const Utility::ResourceRegistry::ObjectPtr object = m_registry.FindOrLoad(
+		key,
+		[&]() -> Utility::ResourceRegistry::ObjectPtr
+		{
+			return Texture2D::Load(device, uploadCmdList, uploadRing, srvAlloc, dataType, channel, filePath, options);
+		});
+
+	return std::static_pointer_cast<Texture2D>(object);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureRegistry::_makeKey(
+	const Texture2D::DataType dataType,
+	const Texture2D::Channel channel,
+	const char* const filePath,
+	const Texture2D::LoadOptions& options,
+	uint64_t& outKey) const
+{
+	using namespace DemoFramework::Utility;
+
+	uint64_t sourceHash = Hash::DefaultSeed;
+
+	if(m_keyMode == KeyMode::Content)
+	{
+		const MappedFile::Ptr sourceFile = MappedFile::Open(filePath);
+		if(!sourceFile)
+		{
+			LOG_ERROR("Failed to open texture source file: path=\"%s\"", filePath);
+			return false;
+		}
+
+		sourceHash = Hash::Compute(sourceFile->GetData(), size_t(sourceFile->GetSize()));
+	}
+	else
+	{
+		// Windows paths aren't case-sensitive and take either kind of slash, so those differences are folded away.
+		for(const char* pChar = filePath; *pChar != '\0'; ++pChar)
+		{
+			const char c = (*pChar == '\\') ? '/' : char(tolower(uint8_t(*pChar)));
+
+			sourceHash = Hash::Combine(sourceHash, uint64_t(uint8_t(c)));
+		}
+	}
+
+	// A streamed texture is a different object from a fully loaded one, even with the same data.
+	uint64_t key = Hash::Combine(sourceHash, Texture2D::GetParamHash(dataType, channel, options));
+	key = Hash::Combine(key, options.stream ? 1 : 0);
+
+	if(options.stream)
+	{
+		key = Hash::Combine(key, uint64_t(options.streamTailSize));
+	}
+
+	outKey = key;
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
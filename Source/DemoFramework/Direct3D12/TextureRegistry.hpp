@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Texture2D.hpp"
+
+#include "../Utility/ResourceRegistry.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class TextureRegistry;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Makes sure each texture is only loaded once. Loads go through the registry, which hands back the texture that's
+// already loaded for the same source and parameters for as long as it's still alive, instead of decoding the image
+// again and creating another resource and descriptor for it. When several threads ask for the same texture at the
+// same time, the first one loads it and the rest wait for that load to finish.
+//
+// Sources are identified either by their path or by a hash of their contents. Hashing contents also catches copies of
+// the same image under different names, but means reading every source file in full before it can be looked up.
+//
+// The registry itself is thread-safe, but the upload command list, upload ring and descriptor allocator passed to
+// Load() still belong to the caller and must not be shared between threads loading at the same time. A texture handed
+// to a waiting caller was uploaded on the command list of the caller that loaded it, so it can't be drawn with until
+// that command list has been submitted.
+class DF_API DemoFramework::D3D12::TextureRegistry
+{
+public:
+
+	typedef std::shared_ptr<TextureRegistry> Ptr;
+
+	enum class KeyMode
+	{
+		Path,    // Paths are compared case-insensitively, with either kind of slash
+		Content, // Source files are compared by a hash of their contents
+	};
+
+	TextureRegistry();
+	TextureRegistry(const TextureRegistry&) = delete;
+	TextureRegistry(TextureRegistry&&) = delete;
+
+	TextureRegistry& operator =(const TextureRegistry&) = delete;
+	TextureRegistry& operator =(TextureRegistry&&) = delete;
+
+	static Ptr Create(KeyMode keyMode = KeyMode::Path);
+
+	// Same as Texture2D::Load(), except the texture is shared with every other load of the same source and
+	// parameters through this registry.
+	Texture2D::Ptr Load(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& uploadCmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		Texture2D::DataType dataType,
+		Texture2D::Channel channel,
+		const char* filePath,
+		uint32_t mipCount = D3D12_REQ_MIP_LEVELS
+	);
+
+	Texture2D::Ptr Load(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& uploadCmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		Texture2D::DataType dataType,
+		Texture2D::Channel channel,
+		const char* filePath,
+		const Texture2D::LoadOptions& options
+	);
+
+	// Remove the entries of textures that have been destroyed.
+	void Prune();
+
+	size_t GetEntryCount() const;
+	Utility::ResourceRegistry::Stats GetStats() const;
+
+	KeyMode GetKeyMode() const;
+
+
+private:
+
+	bool _makeKey(Texture2D::DataType, Texture2D::Channel, const char*, const Texture2D::LoadOptions&, uint64_t&) const;
+
+	Utility::ResourceRegistry m_registry;
+
+	KeyMode m_keyMode;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::TextureRegistry>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::TextureRegistry::TextureRegistry()
+	: m_registry()
+	, m_keyMode(KeyMode::Path)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::D3D12::TextureRegistry::Prune()
+{
+	m_registry.Prune();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::D3D12::TextureRegistry::GetEntryCount() const
+{
+	return m_registry.GetEntryCount();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::ResourceRegistry::Stats DemoFramework::D3D12::TextureRegistry::GetStats() const
+{
+	return m_registry.GetStats();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::TextureRegistry::KeyMode DemoFramework::D3D12::TextureRegistry::GetKeyMode() const
+{
+	return m_keyMode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,350 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "TextureResidencyManager.hpp"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Stopwatch.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the texture map using PIMPL to make MSVC shut up about std::map<> needing a DLL interface.
+struct DemoFramework::D3D12::TextureResidencyManager::TextureMap
+{
+	struct Entry
+	{
+		std::weak_ptr<Texture2D> texture;
+
+		// Only used as a key into 'ids'; never dereferenced.
+		const Texture2D* pTexture;
+
+		// Update() call that recorded the texture's pending residency change.
+		uint64_t changeFrame;
+
+		// Set when a texture fails to change residency, so the same change isn't retried every frame.
+		bool locked;
+	};
+
+	std::map<Utility::ResidencyPolicy::EntryId, Entry> entries;
+	std::unordered_map<const Texture2D*, Utility::ResidencyPolicy::EntryId> ids;
+
+	std::vector<Utility::ResidencyPolicy::Action> actions;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureResidencyManager::TextureResidencyManager()
+	: m_device()
+	, m_uploadRing()
+	, m_policy()
+	, m_pTextures(new TextureMap())
+	, m_frameIndex(0)
+	, m_tailSize(DF_TEXTURE_RESIDENCY_MANAGER_DEFAULT_TAIL_SIZE)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureResidencyManager::~TextureResidencyManager()
+{
+	if(m_pTextures)
+	{
+		// Finish any changes still in flight so no texture is left with a pending resource it will never switch to.
+		for(auto& pair : m_pTextures->entries)
+		{
+			const Texture2D::Ptr texture = pair.second.texture.lock();
+
+			if(texture)
+			{
+				texture->CompleteResidencyChange(m_device, m_uploadRing);
+			}
+		}
+
+		delete m_pTextures;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::TextureResidencyManager::Ptr DemoFramework::D3D12::TextureResidencyManager::Create(
+	const Device::Ptr& device,
+	const UploadRing::Ptr& uploadRing,
+	const uint64_t byteBudget,
+	const uint32_t tailSize)
+{
+	if(!device || !uploadRing || tailSize == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<TextureResidencyManager>();
+
+	output->m_device = device;
+	output->m_uploadRing = uploadRing;
+	output->m_tailSize = tailSize;
+	output->m_policy.SetBudget(byteBudget);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureResidencyManager::Register(const Texture2D::Ptr& texture)
+{
+	if(!texture)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	auto idIt = m_pTextures->ids.find(texture.get());
+	if(idIt != m_pTextures->ids.end())
+	{
+		if(!m_pTextures->entries[idIt->second].texture.expired())
+		{
+			// Already registered.
+			return true;
+		}
+
+		// A texture that was destroyed before the last update left its entry behind at the same address.
+		m_policy.Unregister(idIt->second);
+		m_pTextures->entries.erase(idIt->second);
+		m_pTextures->ids.erase(idIt);
+	}
+
+	const uint32_t mipCount = texture->GetMipCount();
+
+	uint64_t residentSizes[D3D12_REQ_MIP_LEVELS];
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount && mipIndex < D3D12_REQ_MIP_LEVELS; ++mipIndex)
+	{
+		residentSizes[mipIndex] = texture->GetAllocationSize(m_device, mipIndex);
+	}
+
+	// Streamed textures hold all of their mips in memory no matter where the clamp is.
+	const uint32_t residentMip = texture->IsStreaming() ? 0 : texture->GetResidentMip();
+
+	const Utility::ResidencyPolicy::EntryId id = m_policy.Register(
+		mipCount,
+		residentSizes,
+		texture->GetMaxTrimMip(m_tailSize),
+		residentMip);
+	if(id == Utility::ResidencyPolicy::InvalidEntryId)
+	{
+		LOG_ERROR("Failed to register Texture2D for residency management: path=\"%s\"", texture->GetFilePath());
+		return false;
+	}
+
+	TextureMap::Entry entry;
+
+	entry.texture = texture;
+	entry.pTexture = texture.get();
+	entry.changeFrame = 0;
+	entry.locked = false;
+
+	m_pTextures->entries[id] = entry;
+	m_pTextures->ids[texture.get()] = id;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::TextureResidencyManager::Unregister(const Texture2D::Ptr& texture)
+{
+	if(!texture)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	auto idIt = m_pTextures->ids.find(texture.get());
+	if(idIt == m_pTextures->ids.end())
+	{
+		return false;
+	}
+
+	// The texture is left in whatever state it's in, but can't be left waiting on a change that will never complete.
+	texture->CompleteResidencyChange(m_device, m_uploadRing);
+
+	m_policy.Unregister(idIt->second);
+	m_pTextures->entries.erase(idIt->second);
+	m_pTextures->ids.erase(idIt);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::TextureResidencyManager::MarkUsed(const Texture2D::Ptr& texture)
+{
+	if(!texture)
+	{
+		return;
+	}
+
+	auto idIt = m_pTextures->ids.find(texture.get());
+	if(idIt != m_pTextures->ids.end())
+	{
+		// The frame being built is the one the next update will advance to.
+		m_policy.Touch(idIt->second, m_frameIndex + 1);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::TextureResidencyManager::Update(const GraphicsCommandList::Ptr& cmdList)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!cmdList)
+	{
+		LOG_ERROR("Invalid parameter");
+		return;
+	}
+
+	Stopwatch stopwatch;
+
+	++m_frameIndex;
+
+	for(auto it = m_pTextures->entries.begin(); it != m_pTextures->entries.end();)
+	{
+		TextureMap::Entry& entry = it->second;
+
+		const Texture2D::Ptr texture = entry.texture.lock();
+
+		if(!texture)
+		{
+			// Stop tracking textures that have been destroyed.
+			m_policy.Unregister(it->first);
+			m_pTextures->ids.erase(entry.pTexture);
+
+			it = m_pTextures->entries.erase(it);
+			continue;
+		}
+
+		if(texture->IsResidencyChangePending() && !texture->IsResidencyChangeRecorded())
+		{
+			// Restores wait on their reload before anything can be recorded for them.
+			if(!texture->UpdateResidencyChange(m_device, cmdList, m_uploadRing))
+			{
+				LOG_ERROR(
+					"Failed to restore Texture2D; locking it at its current residency: path=\"%s\", residentMip=%" PRIu32,
+					texture->GetFilePath(),
+					texture->GetResidentMip());
+
+				m_policy.SetResidentMip(it->first, texture->GetResidentMip());
+				m_policy.SetPendingSize(it->first, 0);
+
+				entry.locked = true;
+			}
+			else if(texture->IsResidencyChangeRecorded())
+			{
+				entry.changeFrame = m_frameIndex;
+			}
+		}
+		else if(texture->IsResidencyChangePending() && (m_frameIndex - entry.changeFrame) >= DF_SWAP_CHAIN_BUFFER_MAX_COUNT)
+		{
+			// Switch the descriptor over once every frame queued with the old contents has had time to finish.
+			texture->CompleteResidencyChange(m_device, m_uploadRing);
+
+			m_policy.SetPendingSize(it->first, 0);
+		}
+
+		m_policy.SetPinned(it->first, entry.locked || texture->IsStreaming() || texture->IsResidencyChangePending());
+
+		++it;
+	}
+
+	std::vector<ResidencyPolicy::Action>& actions = m_pTextures->actions;
+
+	// Each texture gets at most one action per update.
+	actions.resize(m_pTextures->entries.size());
+
+	const size_t actionCount = actions.empty() ? 0 : m_policy.Update(m_frameIndex, actions.data(), actions.size());
+
+	uint32_t trimCount = 0;
+	uint32_t evictCount = 0;
+	uint32_t restoreCount = 0;
+
+	for(size_t actionIndex = 0; actionIndex < actionCount; ++actionIndex)
+	{
+		const ResidencyPolicy::Action& action = actions[actionIndex];
+
+		TextureMap::Entry& entry = m_pTextures->entries[action.id];
+
+		const Texture2D::Ptr texture = entry.texture.lock();
+		assert(texture);
+
+		// The resource being replaced stays allocated until the change completes.
+		const uint32_t oldResidentMip = texture->GetResidentMip();
+		const uint64_t oldSize = (oldResidentMip < texture->GetMipCount())
+			? texture->GetAllocationSize(m_device, oldResidentMip)
+			: 0;
+
+		if(!texture->BeginResidencyChange(m_device, cmdList, m_uploadRing, action.targetMip))
+		{
+			LOG_ERROR(
+				"Failed to change Texture2D residency; locking it at its current residency: path=\"%s\", residentMip=%" PRIu32 ", targetMip=%" PRIu32,
+				texture->GetFilePath(),
+				texture->GetResidentMip(),
+				action.targetMip);
+
+			// Put the policy back in line with what's actually resident.
+			m_policy.SetResidentMip(action.id, texture->GetResidentMip());
+			m_policy.SetPinned(action.id, true);
+
+			entry.locked = true;
+			continue;
+		}
+
+		entry.changeFrame = m_frameIndex;
+
+		m_policy.SetPendingSize(action.id, oldSize);
+
+		switch(action.type)
+		{
+			case ResidencyPolicy::ActionType::Trim:    ++trimCount;    break;
+			case ResidencyPolicy::ActionType::Evict:   ++evictCount;   break;
+			case ResidencyPolicy::ActionType::Restore: ++restoreCount; break;
+
+			default:
+				break;
+		}
+	}
+
+	if(actionCount > 0)
+	{
+		LOG_WRITE(
+			"Updated texture residency: frame=%" PRIu64 ", trimmed=%" PRIu32 ", evicted=%" PRIu32 ", restored=%" PRIu32 ", residentSize=%" PRIu64 ", pendingSize=%" PRIu64 ", budget=%" PRIu64 ", time=%.2fms",
+			m_frameIndex,
+			trimCount,
+			evictCount,
+			restoreCount,
+			m_policy.GetResidentSize(),
+			m_policy.GetPendingSize(),
+			m_policy.GetBudget(),
+			stopwatch.GetElapsedMs());
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
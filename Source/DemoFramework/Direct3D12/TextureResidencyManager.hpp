@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Texture2D.hpp"
+
+#include "../Utility/ResidencyPolicy.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_TEXTURE_RESIDENCY_MANAGER_DEFAULT_TAIL_SIZE 64
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class TextureResidencyManager;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Keeps the GPU memory used by a set of textures under a budget. Every registered texture is tracked by the size of
+// its allocation and the last frame it was marked as used on. When the total goes over the budget, the least recently
+// used textures first have their most detailed mips dropped, down to a small mip tail, and are then evicted entirely.
+// Textures marked as used that aren't fully resident are reloaded. The decisions are made by a ResidencyPolicy; this
+// class only applies them to the textures.
+//
+// Changes are recorded on the command list passed to Update(), with the texture descriptors switched over to the new
+// resources DF_SWAP_CHAIN_BUFFER_MAX_COUNT updates later, once no queued frame can still be using the old contents.
+// Restored textures are reloaded on the shared thread pool, and their uploads are recorded by whichever update finds
+// the reload done. The old resources are released through the upload ring, so the ring should be signaled after every
+// frame as usual. Until a change completes, the resource being replaced still counts against the budget.
+//
+// Not thread-safe. Textures are only referenced weakly, so destroying a texture is enough to stop tracking it.
+class DF_API DemoFramework::D3D12::TextureResidencyManager
+{
+public:
+
+	typedef std::shared_ptr<TextureResidencyManager> Ptr;
+
+	TextureResidencyManager();
+	TextureResidencyManager(const TextureResidencyManager&) = delete;
+	TextureResidencyManager(TextureResidencyManager&&) = delete;
+	~TextureResidencyManager();
+
+	TextureResidencyManager& operator =(const TextureResidencyManager&) = delete;
+	TextureResidencyManager& operator =(TextureResidencyManager&&) = delete;
+
+	// Textures are never trimmed past the mips that fit within 'tailSize' on both axes.
+	static Ptr Create(
+		const Device::Ptr& device,
+		const UploadRing::Ptr& uploadRing,
+		uint64_t byteBudget,
+		uint32_t tailSize = DF_TEXTURE_RESIDENCY_MANAGER_DEFAULT_TAIL_SIZE
+	);
+
+	bool Register(const Texture2D::Ptr& texture);
+	bool Unregister(const Texture2D::Ptr& texture);
+
+	// Mark a texture as used on the current frame. This should be called for every texture a frame draws with
+	// before calling Update() for that frame.
+	void MarkUsed(const Texture2D::Ptr& texture);
+
+	// Advance to the next frame and record the residency changes for it.
+	void Update(const GraphicsCommandList::Ptr& cmdList);
+
+	void SetBudget(uint64_t byteBudget);
+
+	uint64_t GetBudget() const;
+	uint64_t GetResidentSize() const;
+
+	// Size of the resources that have been replaced but are still waiting on their residency changes to complete.
+	uint64_t GetPendingSize() const;
+
+	size_t GetTextureCount() const;
+
+
+private:
+
+	struct TextureMap;
+
+	Device::Ptr m_device;
+	UploadRing::Ptr m_uploadRing;
+
+	Utility::ResidencyPolicy m_policy;
+
+	TextureMap* m_pTextures;
+
+	uint64_t m_frameIndex;
+
+	uint32_t m_tailSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::TextureResidencyManager>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::D3D12::TextureResidencyManager::SetBudget(const uint64_t byteBudget)
+{
+	m_policy.SetBudget(byteBudget);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::TextureResidencyManager::GetBudget() const
+{
+	return m_policy.GetBudget();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::TextureResidencyManager::GetResidentSize() const
+{
+	return m_policy.GetResidentSize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::TextureResidencyManager::GetPendingSize() const
+{
+	return m_policy.GetPendingSize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::D3D12::TextureResidencyManager::GetTextureCount() const
+{
+	return m_policy.GetEntryCount();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "UploadRing.hpp"
+
+#include "LowLevel/Event.hpp"
+#include "LowLevel/Fence.hpp"
+#include "LowLevel/Resource.hpp"
+
+#include "../Application/Log.hpp"
+
+#include <deque>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the release queue using PIMPL to make MSVC shut up about std::deque<> needing a DLL interface.
+struct DemoFramework::D3D12::UploadRing::ReleaseQueue
+{
+	struct Entry
+	{
+		Resource::Ptr resource;
+		uint64_t fenceValue;
+	};
+
+	// Entries are added in fence order, so the front of the queue is always the next to be released.
+	std::deque<Entry> list;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static DemoFramework::D3D12::Resource::Ptr CreateUploadBuffer(const DemoFramework::D3D12::Device::Ptr& device, const uint64_t size)
+{
+	constexpr D3D12_HEAP_PROPERTIES uploadHeapProps =
+	{
+		D3D12_HEAP_TYPE_UPLOAD,          // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	const D3D12_RESOURCE_DESC bufferDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                               // UINT64 Alignment
+		size,                            // UINT64 Width
+		1,                               // UINT Height
+		1,                               // UINT16 DepthOrArraySize
+		1,                               // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,             // DXGI_FORMAT Format
+		defaultSampleDesc,               // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	return DemoFramework::D3D12::CreateCommittedResource(
+		device,
+		bufferDesc,
+		uploadHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_GENERIC_READ);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::UploadRing::UploadRing()
+	: m_resource()
+	, m_fence()
+	, m_event()
+	, m_allocator()
+	, m_pReleaseQueue(new ReleaseQueue())
+	, m_pData(nullptr)
+	, m_gpuAddress(0)
+	, m_lastSignaledValue(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::UploadRing::~UploadRing()
+{
+	// The GPU may still be reading from the buffer, so make sure it's done before letting it go.
+	WaitForIdle();
+
+	if(m_pData)
+	{
+		m_resource->Unmap(0, nullptr);
+	}
+
+	if(m_pReleaseQueue)
+	{
+		delete m_pReleaseQueue;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::UploadRing::Ptr DemoFramework::D3D12::UploadRing::Create(const Device::Ptr& device, const uint64_t capacity)
+{
+	if(!device || capacity == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	constexpr D3D12_RANGE disableCpuReadRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	Ptr output = std::make_shared<UploadRing>();
+
+	output->m_resource = CreateUploadBuffer(device, capacity);
+	if(!output->m_resource)
+	{
+		LOG_ERROR("Failed to create upload ring buffer: capacity=%" PRIu64, capacity);
+		return Ptr();
+	}
+
+	output->m_fence = CreateFence(device, D3D12_FENCE_FLAG_NONE, 0);
+	if(!output->m_fence)
+	{
+		return Ptr();
+	}
+
+	output->m_event = CreateEvent(nullptr, false, false, nullptr);
+	if(!output->m_event)
+	{
+		return Ptr();
+	}
+
+	// Upload heap memory can stay mapped for the lifetime of the resource.
+	const HRESULT mapResult = output->m_resource->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(&output->m_pData));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map upload ring buffer: result=0x%08" PRIX32, mapResult);
+		return Ptr();
+	}
+
+	output->m_gpuAddress = output->m_resource->GetGPUVirtualAddress();
+	output->m_allocator.Reset(capacity);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::UploadRing::Allocate(const uint64_t size, const uint64_t alignment, Allocation& outAllocation)
+{
+	Retire();
+
+	uint64_t offset = m_allocator.Allocate(size, alignment);
+
+	uint64_t oldestFenceValue = 0;
+
+	// Wait on the signaled batches one at a time, oldest first, until enough space has been freed.
+	while(offset == Utility::RingAllocator::InvalidOffset && m_allocator.GetOldestFenceValue(oldestFenceValue))
+	{
+		_waitForFence(oldestFenceValue);
+		Retire();
+
+		offset = m_allocator.Allocate(size, alignment);
+	}
+
+	if(offset == Utility::RingAllocator::InvalidOffset)
+	{
+		return false;
+	}
+
+	outAllocation.pResource = m_resource.Get();
+	outAllocation.pData = m_pData + offset;
+	outAllocation.offset = offset;
+	outAllocation.size = size;
+	outAllocation.gpuAddress = m_gpuAddress + offset;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::UploadRing::AllocateDedicated(const Device::Ptr& device, const uint64_t size, Allocation& outAllocation)
+{
+	if(!device || size == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	constexpr D3D12_RANGE disableCpuReadRange =
+	{
+		0, // SIZE_T Begin
+		0, // SIZE_T End
+	};
+
+	Resource::Ptr buffer = CreateUploadBuffer(device, size);
+	if(!buffer)
+	{
+		LOG_ERROR("Failed to create dedicated upload buffer: size=%" PRIu64, size);
+		return false;
+	}
+
+	uint8_t* pData = nullptr;
+
+	// Releasing the buffer unmaps it, so there's no need to keep track of it after this.
+	const HRESULT mapResult = buffer->Map(0, &disableCpuReadRange, reinterpret_cast<void**>(&pData));
+	if(FAILED(mapResult))
+	{
+		LOG_ERROR("Failed to map dedicated upload buffer: result=0x%08" PRIX32, mapResult);
+		return false;
+	}
+
+	outAllocation.pResource = buffer.Get();
+	outAllocation.pData = pData;
+	outAllocation.offset = 0;
+	outAllocation.size = size;
+	outAllocation.gpuAddress = buffer->GetGPUVirtualAddress();
+
+	DeferRelease(buffer);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::UploadRing::DeferRelease(const Resource::Ptr& resource)
+{
+	if(!resource)
+	{
+		return;
+	}
+
+	// Tagged with the value the next Signal() will use, since the copies reading the resource haven't been submitted yet.
+	const ReleaseQueue::Entry entry =
+	{
+		resource,                // Resource::Ptr resource
+		m_lastSignaledValue + 1, // uint64_t fenceValue
+	};
+
+	m_pReleaseQueue->list.push_back(entry);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::UploadRing::Signal(const CommandQueue::Ptr& cmdQueue)
+{
+	if(!cmdQueue)
+	{
+		return;
+	}
+
+	const uint64_t fenceValue = m_lastSignaledValue + 1;
+
+	const HRESULT result = cmdQueue->Signal(m_fence.Get(), fenceValue);
+	if(FAILED(result))
+	{
+		LOG_ERROR("Failed to enqueue upload ring fence signal: result=0x%08" PRIX32, result);
+		return;
+	}
+
+	m_allocator.Close(fenceValue);
+	m_lastSignaledValue = fenceValue;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::UploadRing::Retire()
+{
+	if(!m_fence)
+	{
+		return;
+	}
+
+	const uint64_t completedValue = m_fence->GetCompletedValue();
+
+	m_allocator.Retire(completedValue);
+
+	std::deque<ReleaseQueue::Entry>& list = m_pReleaseQueue->list;
+
+	while(!list.empty() && list.front().fenceValue <= completedValue)
+	{
+		list.pop_front();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::UploadRing::WaitForIdle()
+{
+	if(!m_fence)
+	{
+		return;
+	}
+
+	_waitForFence(m_lastSignaledValue);
+	Retire();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::UploadRing::_waitForFence(const uint64_t fenceValue)
+{
+	if(m_fence->GetCompletedValue() >= fenceValue)
+	{
+		return;
+	}
+
+	const HRESULT result = m_fence->SetEventOnCompletion(fenceValue, m_event->GetHandle());
+	if(FAILED(result))
+	{
+		LOG_ERROR("Failed to set completion event on upload ring fence: result=0x%08" PRIX32, result);
+		return;
+	}
+
+	::WaitForSingleObject(m_event->GetHandle(), INFINITE);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "LowLevel/Types.hpp"
+
+#include "../Utility/RingAllocator.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_UPLOAD_RING_DEFAULT_CAPACITY (64 * 1024 * 1024)
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class UploadRing;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// A single persistently mapped upload buffer shared by all loaders for staging data on its way to GPU-resident
+// resources. Allocations made while recording a batch of uploads are tagged with a fence value when Signal() is
+// called after submitting the command list those uploads were recorded on, and their memory is reused once the GPU
+// has passed that fence.
+//
+// Not thread-safe; allocations are expected to be made from the thread recording the upload command list.
+class DF_API DemoFramework::D3D12::UploadRing
+{
+public:
+
+	typedef std::shared_ptr<UploadRing> Ptr;
+
+	struct Allocation
+	{
+		ID3D12Resource* pResource;
+		uint8_t* pData;
+
+		uint64_t offset;
+		uint64_t size;
+
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress;
+	};
+
+	UploadRing();
+	UploadRing(const UploadRing&) = delete;
+	UploadRing(UploadRing&&) = delete;
+	~UploadRing();
+
+	UploadRing& operator =(const UploadRing&) = delete;
+	UploadRing& operator =(UploadRing&&) = delete;
+
+	static Ptr Create(const Device::Ptr& device, uint64_t capacity = DF_UPLOAD_RING_DEFAULT_CAPACITY);
+
+	// Allocate staging memory. When the ring is full, this blocks until the GPU releases enough of the memory that has
+	// already been signaled. Returns false when the allocations made since the last Signal() leave no room, in which
+	// case the caller either needs to submit its uploads and signal, or fall back to a dedicated staging resource.
+	bool Allocate(uint64_t size, uint64_t alignment, Allocation& outAllocation);
+
+	// Create a separate upload buffer for data that can't be allocated from the ring. The buffer is released the same
+	// way as memory in the ring, once the GPU passes the next fence value signaled by the ring.
+	bool AllocateDedicated(const Device::Ptr& device, uint64_t size, Allocation& outAllocation);
+
+	// Keep a resource alive until the GPU passes the next fence value signaled by the ring. This is for staging
+	// resources that live outside of the ring, but still need to outlive the copies reading from them.
+	void DeferRelease(const Resource::Ptr& resource);
+
+	// Tag all allocations made since the last call with a new fence value and signal it on the command queue. This
+	// must be called after submitting the command lists that read from those allocations.
+	void Signal(const CommandQueue::Ptr& cmdQueue);
+
+	// Reclaim the memory of every allocation the GPU is finished with without blocking.
+	void Retire();
+
+	// Block until the GPU has passed every fence value signaled so far, then reclaim everything.
+	void WaitForIdle();
+
+	const Resource::Ptr& GetResource() const;
+
+	uint64_t GetCapacity() const;
+	uint64_t GetUsedSize() const;
+
+
+private:
+
+	struct ReleaseQueue;
+
+	void _waitForFence(uint64_t);
+
+	Resource::Ptr m_resource;
+	Fence::Ptr m_fence;
+	Event::Ptr m_event;
+
+	Utility::RingAllocator m_allocator;
+
+	ReleaseQueue* m_pReleaseQueue;
+
+	uint8_t* m_pData;
+
+	D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress;
+
+	uint64_t m_lastSignaledValue;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::UploadRing>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Resource::Ptr& DemoFramework::D3D12::UploadRing::GetResource() const
+{
+	return m_resource;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::UploadRing::GetCapacity() const
+{
+	return m_allocator.GetCapacity();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::D3D12::UploadRing::GetUsedSize() const
+{
+	return m_allocator.GetUsedSize();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
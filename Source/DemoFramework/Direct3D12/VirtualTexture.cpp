@@ -0,0 +1,499 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "VirtualTexture.hpp"
+
+#include "LowLevel/Resource.hpp"
+
+#include "Shaders/virtual-texture/common.hlsli"
+
+#include "../Application/Log.hpp"
+#include "../Utility/Math.hpp"
+
+#include <DirectXTex.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static_assert(DF_VT_PAGE_ID_MIP_SHIFT == DemoFramework::Utility::VirtualPageTable::PageIdMipShift, "Page ID layout mismatch");
+static_assert(DF_VT_PAGE_ID_Y_SHIFT == DemoFramework::Utility::VirtualPageTable::PageIdYShift, "Page ID layout mismatch");
+static_assert(DF_VT_PAGE_ID_COORD_MASK == DemoFramework::Utility::VirtualPageTable::PageIdCoordMask, "Page ID layout mismatch");
+static_assert(DF_VT_INVALID_PAGE_ID == DemoFramework::Utility::VirtualPageTable::InvalidPageId, "Page ID layout mismatch");
+static_assert(DF_VT_MAX_MIP_COUNT == DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT, "Virtual texture mip count mismatch");
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void TransitionResource(
+	const DemoFramework::D3D12::GraphicsCommandList::Ptr& cmdList,
+	const DemoFramework::D3D12::Resource::Ptr& resource,
+	const D3D12_RESOURCE_STATES stateBefore,
+	const D3D12_RESOURCE_STATES stateAfter)
+{
+	D3D12_RESOURCE_BARRIER barrier;
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = resource.Get();
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = stateBefore;
+	barrier.Transition.StateAfter = stateAfter;
+
+	cmdList->ResourceBarrier(1, &barrier);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::VirtualTexture::VirtualTexture()
+	: m_uploadRing()
+	, m_srvAlloc()
+	, m_file()
+	, m_physicalTexture()
+	, m_indirectionBuffer()
+	, m_physicalDescriptor(Descriptor::Invalid)
+	, m_indirectionDescriptor(Descriptor::Invalid)
+	, m_pageTable()
+	, m_pageCache()
+	, m_feedback()
+	, m_stats()
+	, m_frameIndex(0)
+	, m_format(DXGI_FORMAT_UNKNOWN)
+	, m_slotCountX(0)
+	, m_slotCountY(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::VirtualTexture::~VirtualTexture()
+{
+	if(m_srvAlloc)
+	{
+		m_srvAlloc->Free(m_physicalDescriptor);
+		m_srvAlloc->Free(m_indirectionDescriptor);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::VirtualTexture::Ptr DemoFramework::D3D12::VirtualTexture::Create(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const DescriptorAllocator::Ptr& srvAlloc,
+	const char* const filePath,
+	const uint32_t slotCountX,
+	const uint32_t slotCountY)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!device
+		|| !cmdList
+		|| !uploadRing
+		|| !srvAlloc
+		|| !filePath
+		|| filePath[0] == '\0'
+		|| slotCountX == 0
+		|| slotCountY == 0
+		|| slotCountX > VirtualPageTable::MaxSlotCountPerAxis
+		|| slotCountY > VirtualPageTable::MaxSlotCountPerAxis)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<VirtualTexture>();
+
+	output->m_file = VirtualTextureFile::Open(filePath);
+	if(!output->m_file)
+	{
+		return Ptr();
+	}
+
+	const VirtualTextureFile::Desc& fileDesc = output->m_file->GetDesc();
+	const DXGI_FORMAT format = DXGI_FORMAT(fileDesc.format);
+	const uint32_t tileSize = output->m_file->GetTileSize();
+
+	// Tiles are copied texel for texel, so the format needs to match what the file was written with.
+	if(DirectX::IsCompressed(format) || uint32_t(DirectX::BitsPerPixel(format)) != fileDesc.texelSize * 8)
+	{
+		LOG_ERROR("Unsupported virtual texture format: path=\"%s\", format=%" PRIu32, filePath, fileDesc.format);
+		return Ptr();
+	}
+
+	if(uint64_t(slotCountX) * tileSize > D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION
+		|| uint64_t(slotCountY) * tileSize > D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+	{
+		LOG_ERROR("Virtual texture page cache is too large: slotCount=%" PRIu32 "x%" PRIu32 ", tileSize=%" PRIu32, slotCountX, slotCountY, tileSize);
+		return Ptr();
+	}
+
+	output->m_pageTable.Reset(fileDesc.width, fileDesc.height, fileDesc.pageSize, fileDesc.mipCount);
+	output->m_pageCache.Reset(slotCountX * slotCountY);
+
+	const uint32_t lastMip = fileDesc.mipCount - 1;
+	const uint32_t lastMipPageCountX = output->m_pageTable.GetPageCountX(lastMip);
+	const uint32_t lastMipPageCountY = output->m_pageTable.GetPageCountY(lastMip);
+
+	// The least detailed mip stays resident, so it can't take up the whole cache.
+	if(lastMipPageCountX * lastMipPageCountY >= slotCountX * slotCountY)
+	{
+		LOG_ERROR(
+			"Virtual texture page cache is too small for its last mip: path=\"%s\", slotCount=%" PRIu32 ", pageCount=%" PRIu32,
+			filePath,
+			slotCountX * slotCountY,
+			lastMipPageCountX * lastMipPageCountY);
+		return Ptr();
+	}
+
+	constexpr D3D12_HEAP_PROPERTIES gpuHeapProps =
+	{
+		D3D12_HEAP_TYPE_DEFAULT,         // D3D12_HEAP_TYPE Type
+		D3D12_CPU_PAGE_PROPERTY_UNKNOWN, // D3D12_CPU_PAGE_PROPERTY CPUPageProperty
+		D3D12_MEMORY_POOL_UNKNOWN,       // D3D12_MEMORY_POOL MemoryPoolPreference
+		0,                               // UINT CreationNodeMask
+		0,                               // UINT VisibleNodeMask
+	};
+
+	constexpr DXGI_SAMPLE_DESC defaultSampleDesc =
+	{
+		1, // UINT Count
+		0, // UINT Quality
+	};
+
+	const D3D12_RESOURCE_DESC physicalDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_TEXTURE2D, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                                  // UINT64 Alignment
+		uint64_t(slotCountX) * tileSize,    // UINT64 Width
+		slotCountY * tileSize,              // UINT Height
+		1,                                  // UINT16 DepthOrArraySize
+		1,                                  // UINT16 MipLevels
+		format,                             // DXGI_FORMAT Format
+		defaultSampleDesc,                  // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_UNKNOWN,       // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,           // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	const uint64_t indirectionSize = uint64_t(output->m_pageTable.GetIndirectionSize()) * sizeof(uint32_t);
+
+	const D3D12_RESOURCE_DESC indirectionDesc =
+	{
+		D3D12_RESOURCE_DIMENSION_BUFFER, // D3D12_RESOURCE_DIMENSION Dimension
+		0,                               // UINT64 Alignment
+		indirectionSize,                 // UINT64 Width
+		1,                               // UINT Height
+		1,                               // UINT16 DepthOrArraySize
+		1,                               // UINT16 MipLevels
+		DXGI_FORMAT_UNKNOWN,             // DXGI_FORMAT Format
+		defaultSampleDesc,               // DXGI_SAMPLE_DESC SampleDesc
+		D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  // D3D12_TEXTURE_LAYOUT Layout
+		D3D12_RESOURCE_FLAG_NONE,        // D3D12_RESOURCE_FLAGS Flags
+	};
+
+	output->m_physicalTexture = CreateCommittedResource(
+		device,
+		physicalDesc,
+		gpuHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!output->m_physicalTexture)
+	{
+		return Ptr();
+	}
+
+	output->m_indirectionBuffer = CreateCommittedResource(
+		device,
+		indirectionDesc,
+		gpuHeapProps,
+		D3D12_HEAP_FLAG_NONE,
+		D3D12_RESOURCE_STATE_COPY_DEST);
+	if(!output->m_indirectionBuffer)
+	{
+		return Ptr();
+	}
+
+	output->m_uploadRing = uploadRing;
+	output->m_format = format;
+	output->m_slotCountX = slotCountX;
+	output->m_slotCountY = slotCountY;
+
+	// Load the least detailed mip and pin it so it can't be evicted.
+	for(uint32_t pageY = 0; pageY < lastMipPageCountY; ++pageY)
+	{
+		for(uint32_t pageX = 0; pageX < lastMipPageCountX; ++pageX)
+		{
+			const VirtualPageTable::PageId pageId = VirtualPageTable::MakePageId(lastMip, pageX, pageY);
+
+			VirtualPageTable::PageId evictedPageId = VirtualPageTable::InvalidPageId;
+			const VirtualPageTable::SlotIndex slot = output->m_pageCache.Allocate(pageId, 0, evictedPageId);
+
+			if(!output->_uploadPage(cmdList, pageId, slot))
+			{
+				return Ptr();
+			}
+
+			output->m_pageCache.SetPinned(slot, true);
+			output->m_pageTable.Map(pageId, slot);
+		}
+	}
+
+	if(!output->_uploadIndirection(cmdList))
+	{
+		return Ptr();
+	}
+
+	TransitionResource(cmdList, output->m_physicalTexture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	TransitionResource(cmdList, output->m_indirectionBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	const Descriptor physicalDescriptor = srvAlloc->Allocate();
+	const Descriptor indirectionDescriptor = srvAlloc->Allocate();
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	srvDesc.Format = format;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.Texture2D.PlaneSlice = 0;
+	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+
+	device->CreateShaderResourceView(output->m_physicalTexture.Get(), &srvDesc, physicalDescriptor.cpuHandle);
+
+	srvDesc.Format = DXGI_FORMAT_R32_UINT;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = UINT(output->m_pageTable.GetIndirectionSize());
+	srvDesc.Buffer.StructureByteStride = 0;
+	srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
+
+	device->CreateShaderResourceView(output->m_indirectionBuffer.Get(), &srvDesc, indirectionDescriptor.cpuHandle);
+
+	output->m_srvAlloc = srvAlloc;
+	output->m_physicalDescriptor = physicalDescriptor;
+	output->m_indirectionDescriptor = indirectionDescriptor;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::VirtualTexture::Update(
+	const GraphicsCommandList::Ptr& cmdList,
+	const uint32_t* const pFeedback,
+	const uint32_t feedbackWidth,
+	const uint32_t feedbackHeight,
+	const size_t feedbackRowPitch,
+	const uint32_t maxUploadCount)
+{
+	using namespace DemoFramework::Utility;
+
+	if(!cmdList)
+	{
+		LOG_ERROR("Invalid parameter");
+		return;
+	}
+
+	++m_frameIndex;
+
+	m_stats = Stats();
+
+	m_feedback.Clear();
+
+	if(pFeedback)
+	{
+		m_feedback.Parse(pFeedback, feedbackWidth, feedbackHeight, feedbackRowPitch, m_pageTable);
+	}
+
+	m_feedback.Resolve(m_pageTable);
+
+	const VirtualPageTable::PageId* const pUsedPages = m_feedback.GetUsedPages();
+	const size_t usedPageCount = m_feedback.GetUsedPageCount();
+
+	// Pages seen this frame move to the front of the cache before anything is evicted, so none of them get
+	// replaced by the pages being loaded.
+	for(size_t pageIndex = 0; pageIndex < usedPageCount; ++pageIndex)
+	{
+		const VirtualPageTable::SlotIndex slot = m_pageCache.Find(pUsedPages[pageIndex]);
+		if(slot != VirtualPageTable::InvalidSlot)
+		{
+			m_pageCache.Touch(slot, m_frameIndex);
+		}
+	}
+
+	const VirtualTextureFeedback::Request* const pRequests = m_feedback.GetRequests();
+	const size_t requestCount = m_feedback.GetRequestCount();
+
+	m_stats.usedPageCount = uint32_t(usedPageCount);
+	m_stats.requestedPageCount = uint32_t(requestCount);
+
+	for(size_t requestIndex = 0; requestIndex < requestCount && m_stats.uploadedPageCount < maxUploadCount; ++requestIndex)
+	{
+		const VirtualPageTable::PageId pageId = pRequests[requestIndex].pageId;
+
+		VirtualPageTable::PageId evictedPageId = VirtualPageTable::InvalidPageId;
+		const VirtualPageTable::SlotIndex slot = m_pageCache.Allocate(pageId, m_frameIndex, evictedPageId);
+
+		if(slot == VirtualPageTable::InvalidSlot)
+		{
+			// Every slot holds a page this frame needs, so the rest of the requests will have to wait.
+			break;
+		}
+
+		if(evictedPageId != VirtualPageTable::InvalidPageId)
+		{
+			m_pageTable.Unmap(evictedPageId);
+			++m_stats.evictedPageCount;
+		}
+
+		if(m_stats.uploadedPageCount == 0)
+		{
+			TransitionResource(cmdList, m_physicalTexture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+		}
+
+		if(!_uploadPage(cmdList, pageId, slot))
+		{
+			m_pageCache.Free(slot);
+
+			if(m_stats.uploadedPageCount == 0)
+			{
+				TransitionResource(cmdList, m_physicalTexture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+			}
+			break;
+		}
+
+		m_pageTable.Map(pageId, slot);
+		++m_stats.uploadedPageCount;
+	}
+
+	if(m_stats.uploadedPageCount > 0)
+	{
+		TransitionResource(cmdList, m_physicalTexture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	if(m_pageTable.IsDirty())
+	{
+		TransitionResource(cmdList, m_indirectionBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+
+		// When the upload fails, the table stays dirty and the whole buffer is tried again next frame.
+		_uploadIndirection(cmdList);
+
+		TransitionResource(cmdList, m_indirectionBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::D3D12::VirtualTexture::GetConstants(VirtualTextureConstants& outConstants) const
+{
+	const Utility::VirtualTextureFile::Desc& fileDesc = m_file->GetDesc();
+	const uint32_t tileSize = m_file->GetTileSize();
+
+	memset(&outConstants, 0, sizeof(outConstants));
+
+	outConstants.width = fileDesc.width;
+	outConstants.height = fileDesc.height;
+	outConstants.pageSize = fileDesc.pageSize;
+	outConstants.borderSize = fileDesc.borderSize;
+	outConstants.tileSize = tileSize;
+	outConstants.mipCount = fileDesc.mipCount;
+	outConstants.invPhysicalWidth = 1.0f / float32_t(m_slotCountX * tileSize);
+	outConstants.invPhysicalHeight = 1.0f / float32_t(m_slotCountY * tileSize);
+
+	uint32_t* const pMipOffsets = &outConstants.mipOffsets[0].x;
+
+	for(uint32_t mipIndex = 0; mipIndex < fileDesc.mipCount; ++mipIndex)
+	{
+		pMipOffsets[mipIndex] = uint32_t(m_pageTable.GetIndirectionOffset(mipIndex));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::VirtualTexture::_uploadPage(
+	const GraphicsCommandList::Ptr& cmdList,
+	const Utility::VirtualPageTable::PageId pageId,
+	const Utility::VirtualPageTable::SlotIndex slot)
+{
+	using namespace DemoFramework::Utility;
+
+	const uint8_t* const pTile = m_file->GetPageData(pageId);
+	if(!pTile)
+	{
+		LOG_ERROR("Invalid virtual texture page: pageId=0x%08" PRIX32, pageId);
+		return false;
+	}
+
+	const uint32_t tileSize = m_file->GetTileSize();
+	const uint64_t tileRowSize = uint64_t(tileSize) * m_file->GetDesc().texelSize;
+	const uint64_t rowPitch = Math::GetAlignedSize(tileRowSize, uint64_t(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT));
+
+	UploadRing::Allocation staging;
+	if(!m_uploadRing->Allocate(rowPitch * tileSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging))
+	{
+		LOG_ERROR("Failed to allocate upload memory for virtual texture page: pageId=0x%08" PRIX32, pageId);
+		return false;
+	}
+
+	// Tiles are stored without padding, so each row needs to be copied out to the pitch the GPU expects.
+	for(uint32_t row = 0; row < tileSize; ++row)
+	{
+		memcpy(staging.pData + (rowPitch * row), pTile + (tileRowSize * row), size_t(tileRowSize));
+	}
+
+	D3D12_TEXTURE_COPY_LOCATION srcLoc;
+	srcLoc.pResource = staging.pResource;
+	srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	srcLoc.PlacedFootprint.Offset = staging.offset;
+	srcLoc.PlacedFootprint.Footprint.Format = m_format;
+	srcLoc.PlacedFootprint.Footprint.Width = tileSize;
+	srcLoc.PlacedFootprint.Footprint.Height = tileSize;
+	srcLoc.PlacedFootprint.Footprint.Depth = 1;
+	srcLoc.PlacedFootprint.Footprint.RowPitch = UINT(rowPitch);
+
+	D3D12_TEXTURE_COPY_LOCATION destLoc;
+	destLoc.pResource = m_physicalTexture.Get();
+	destLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	destLoc.SubresourceIndex = 0;
+
+	const uint32_t slotX = slot % m_slotCountX;
+	const uint32_t slotY = slot / m_slotCountX;
+
+	cmdList->CopyTextureRegion(&destLoc, slotX * tileSize, slotY * tileSize, 0, &srcLoc, nullptr);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::VirtualTexture::_uploadIndirection(const GraphicsCommandList::Ptr& cmdList)
+{
+	const uint64_t size = uint64_t(m_pageTable.GetIndirectionSize()) * sizeof(uint32_t);
+
+	UploadRing::Allocation staging;
+	if(!m_uploadRing->Allocate(size, sizeof(uint32_t), staging))
+	{
+		LOG_ERROR("Failed to allocate upload memory for virtual texture indirection: size=%" PRIu64, size);
+		return false;
+	}
+
+	// Entries are built straight into the upload memory.
+	m_pageTable.BuildIndirection(m_slotCountX, reinterpret_cast<uint32_t*>(staging.pData));
+
+	cmdList->CopyBufferRegion(m_indirectionBuffer.Get(), 0, staging.pResource, staging.offset, size);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,228 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "CommandContext.hpp"
+#include "DescriptorAllocator.hpp"
+#include "UploadRing.hpp"
+
+#include "../Utility/PageCache.hpp"
+#include "../Utility/VirtualPageTable.hpp"
+#include "../Utility/VirtualTextureFeedback.hpp"
+#include "../Utility/VirtualTextureFile.hpp"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_VIRTUAL_TEXTURE_DEFAULT_SLOT_COUNT 32
+#define DF_VIRTUAL_TEXTURE_DEFAULT_MAX_UPLOAD_COUNT 16
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defined in Shaders/virtual-texture/common.hlsli.
+struct VirtualTextureConstants;
+
+namespace DemoFramework { namespace D3D12 {
+	class VirtualTexture;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Texture streamed in pages from a virtual texture file. Only the pages that were actually sampled are kept on the
+// GPU, in a fixed-size physical texture holding a grid of page slots, and shaders find them through an indirection
+// buffer with one entry per page of every mip (see Shaders/virtual-texture/common.hlsli). Every page of the least
+// detailed mip is loaded up front and never evicted, so there is always something to fall back on.
+//
+// Each frame, the renderer writes the ID of the page it wanted at every pixel into a feedback buffer, reads it back,
+// and hands it to Update(). Pages that were requested but aren't resident are then loaded into the least recently used
+// slots, up to a fixed number per frame, and the indirection buffer is refreshed when anything moved. Reading the
+// feedback buffer back from the GPU is left to the caller, since how many frames late it's allowed to be is up to the
+// renderer.
+//
+// Pages are copied through the upload ring, so the ring should be signaled after every frame as usual. Not
+// thread-safe.
+class DF_API DemoFramework::D3D12::VirtualTexture
+{
+public:
+
+	typedef std::shared_ptr<VirtualTexture> Ptr;
+
+	struct Stats
+	{
+		uint32_t usedPageCount;      // Resident pages sampled by the last feedback buffer
+		uint32_t requestedPageCount; // Missing pages requested by the last feedback buffer
+		uint32_t uploadedPageCount;  // Pages loaded on the last update
+		uint32_t evictedPageCount;   // Pages dropped from the cache to make room on the last update
+	};
+
+	VirtualTexture();
+	VirtualTexture(const VirtualTexture&) = delete;
+	VirtualTexture(VirtualTexture&&) = delete;
+	~VirtualTexture();
+
+	VirtualTexture& operator =(const VirtualTexture&) = delete;
+	VirtualTexture& operator =(VirtualTexture&&) = delete;
+
+	// Open a virtual texture file and record the upload of its least detailed mip. The physical texture holds
+	// 'slotCountX' by 'slotCountY' pages.
+	static Ptr Create(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
+		const DescriptorAllocator::Ptr& srvAlloc,
+		const char* filePath,
+		uint32_t slotCountX = DF_VIRTUAL_TEXTURE_DEFAULT_SLOT_COUNT,
+		uint32_t slotCountY = DF_VIRTUAL_TEXTURE_DEFAULT_SLOT_COUNT
+	);
+
+	// Advance to the next frame and record the page loads requested by a feedback buffer holding one page ID per
+	// texel, with rows 'rowPitch' bytes apart. A null feedback buffer only advances the frame.
+	void Update(
+		const GraphicsCommandList::Ptr& cmdList,
+		const uint32_t* pFeedback,
+		uint32_t feedbackWidth,
+		uint32_t feedbackHeight,
+		size_t feedbackRowPitch,
+		uint32_t maxUploadCount = DF_VIRTUAL_TEXTURE_DEFAULT_MAX_UPLOAD_COUNT);
+
+	// Fill in the constants shaders need to sample the texture.
+	void GetConstants(VirtualTextureConstants& outConstants) const;
+
+	const Resource::Ptr& GetPhysicalTexture() const;
+	const Resource::Ptr& GetIndirectionBuffer() const;
+
+	const Descriptor& GetPhysicalDescriptor() const;
+	const Descriptor& GetIndirectionDescriptor() const;
+
+	const Utility::VirtualPageTable& GetPageTable() const;
+	const Utility::PageCache& GetPageCache() const;
+
+	const Stats& GetStats() const;
+
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint32_t GetMipCount() const;
+
+
+private:
+
+	bool _uploadPage(const GraphicsCommandList::Ptr&, Utility::VirtualPageTable::PageId, Utility::VirtualPageTable::SlotIndex);
+	bool _uploadIndirection(const GraphicsCommandList::Ptr&);
+
+	UploadRing::Ptr m_uploadRing;
+	DescriptorAllocator::Ptr m_srvAlloc;
+
+	Utility::VirtualTextureFile::Ptr m_file;
+
+	Resource::Ptr m_physicalTexture;
+	Resource::Ptr m_indirectionBuffer;
+
+	Descriptor m_physicalDescriptor;
+	Descriptor m_indirectionDescriptor;
+
+	Utility::VirtualPageTable m_pageTable;
+	Utility::PageCache m_pageCache;
+	Utility::VirtualTextureFeedback m_feedback;
+
+	Stats m_stats;
+
+	uint64_t m_frameIndex;
+
+	DXGI_FORMAT m_format;
+
+	uint32_t m_slotCountX;
+	uint32_t m_slotCountY;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::D3D12::VirtualTexture>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Resource::Ptr& DemoFramework::D3D12::VirtualTexture::GetPhysicalTexture() const
+{
+	return m_physicalTexture;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Resource::Ptr& DemoFramework::D3D12::VirtualTexture::GetIndirectionBuffer() const
+{
+	return m_indirectionBuffer;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::VirtualTexture::GetPhysicalDescriptor() const
+{
+	return m_physicalDescriptor;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::Descriptor& DemoFramework::D3D12::VirtualTexture::GetIndirectionDescriptor() const
+{
+	return m_indirectionDescriptor;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::Utility::VirtualPageTable& DemoFramework::D3D12::VirtualTexture::GetPageTable() const
+{
+	return m_pageTable;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::Utility::PageCache& DemoFramework::D3D12::VirtualTexture::GetPageCache() const
+{
+	return m_pageCache;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::VirtualTexture::Stats& DemoFramework::D3D12::VirtualTexture::GetStats() const
+{
+	return m_stats;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::D3D12::VirtualTexture::GetWidth() const
+{
+	return m_file->GetDesc().width;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::D3D12::VirtualTexture::GetHeight() const
+{
+	return m_file->GetDesc().height;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::D3D12::VirtualTexture::GetMipCount() const
+{
+	return m_file->GetDesc().mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -17,8 +17,10 @@
 //
 
 #include "WavefrontObj.hpp"
+#include "WavefrontObjIndex.hpp"
 
 #include "../Application/Log.hpp"
+#include "../Utility/Stopwatch.hpp"
 
 #include <DirectXMath.h>
 #include <tiny_obj_loader.h>
@@ -75,16 +77,20 @@ struct DemoFramework::D3D12::WavefrontObj::InternalData
 DemoFramework::D3D12::WavefrontObj::Ptr DemoFramework::D3D12::WavefrontObj::Load(
 	const Device::Ptr& device,
 	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
 	const char* const name,
-	const char* const filePath)
+	const char* const filePath,
+	const uint32_t lodCount)
 {
 	// Check for errors with the input arguments.
-	if(!device || !cmdList || !name || name[0] == '\0' || !filePath || filePath[0] == '\0')
+	if(!device || !cmdList || !uploadRing || !name || name[0] == '\0' || !filePath || filePath[0] == '\0' || lodCount == 0)
 	{
 		LOG_ERROR("Invalid parameter");
 		return Ptr();
 	}
 
+	Utility::Stopwatch stopwatch;
+
 	std::string warnings;
 	std::string errors;
 
@@ -110,17 +116,164 @@ DemoFramework::D3D12::WavefrontObj::Ptr DemoFramework::D3D12::WavefrontObj::Load
 		return Ptr();
 	}
 
-	if(!output->_build(data, device, cmdList))
+	if(!output->_build(data, device, cmdList, uploadRing, lodCount))
+	{
+		LOG_ERROR("Failed to construct meshes from OBJ file: name=\"%s\"", name);
+		return Ptr();
+	}
+
+	LOG_WRITE("Loaded OBJ file: name=\"%s\", shapeCount=%zu, time=%.2fms", name, data.shapes.size(), stopwatch.GetElapsedMs());
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::WavefrontObj::Ptr DemoFramework::D3D12::WavefrontObj::Load(
+	const Device::Ptr& device,
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const char* const name,
+	const char* const filePath,
+	const char* const* const shapeNames,
+	const size_t shapeNameCount,
+	const uint32_t lodCount)
+{
+	// Check for errors with the input arguments.
+	if(!device
+		|| !cmdList
+		|| !uploadRing
+		|| !name
+		|| name[0] == '\0'
+		|| !filePath
+		|| filePath[0] == '\0'
+		|| !shapeNames
+		|| shapeNameCount == 0
+		|| lodCount == 0)
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Utility::Stopwatch stopwatch;
+
+	const WavefrontObjIndex::Ptr index = WavefrontObjIndex::LoadOrBuild(filePath);
+	if(!index)
+	{
+		LOG_ERROR("[OBJ_LOAD] (%s) Failed to load OBJ index", name);
+		return Ptr();
+	}
+
+	const float64_t indexTime = stopwatch.GetElapsedMs();
+
+	const std::vector<WavefrontObjIndex::Shape>& shapes = index->GetShapes();
+	std::vector<bool> shapeNameFound(shapeNameCount, false);
+
+	std::vector<const WavefrontObjIndex::Shape*> selectedShapes;
+	selectedShapes.reserve(shapeNameCount);
+
+	// Select shapes in file order so the output matches the order of a full load. Several shapes can share a name,
+	// and every one of them is selected by that name.
+	for(const WavefrontObjIndex::Shape& shape : shapes)
+	{
+		bool selected = false;
+
+		for(size_t i = 0; i < shapeNameCount; ++i)
+		{
+			if(shapeNames[i] && shape.name == shapeNames[i])
+			{
+				shapeNameFound[i] = true;
+				selected = true;
+			}
+		}
+
+		if(selected)
+		{
+			selectedShapes.push_back(&shape);
+		}
+	}
+
+	for(size_t i = 0; i < shapeNameCount; ++i)
+	{
+		if(!shapeNameFound[i])
+		{
+			LOG_WRITE("(warning) [OBJ_LOAD] (%s) Shape not found: \"%s\"", name, shapeNames[i] ? shapeNames[i] : "");
+		}
+	}
+
+	if(selectedShapes.empty())
+	{
+		LOG_ERROR("[OBJ_LOAD] (%s) None of the requested shapes exist in the OBJ file", name);
+		return Ptr();
+	}
+
+	FILE* const pFile = fopen(filePath, "rb");
+	if(!pFile)
+	{
+		LOG_ERROR("[OBJ_LOAD] (%s) Failed to open OBJ file: path=\"%s\"", name, filePath);
+		return Ptr();
+	}
+
+	InternalData data;
+	data.name = name;
+
+	const bool parseResult = index->ParseShapes(pFile, selectedShapes, data.attrib, data.shapes);
+	fclose(pFile);
+
+	if(!parseResult)
+	{
+		LOG_ERROR("[OBJ_LOAD] (%s) Failed to parse OBJ file: path=\"%s\"", name, filePath);
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<WavefrontObj>();
+
+	if(!output->_build(data, device, cmdList, uploadRing, lodCount))
 	{
 		LOG_ERROR("Failed to construct meshes from OBJ file: name=\"%s\"", name);
 		return Ptr();
 	}
 
+	LOG_WRITE(
+		"Loaded OBJ shapes: name=\"%s\", shapeCount=%zu/%zu, indexTime=%.2fms, time=%.2fms",
+		name,
+		selectedShapes.size(),
+		shapes.size(),
+		indexTime,
+		stopwatch.GetElapsedMs());
+
 	return output;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 
+bool DemoFramework::D3D12::WavefrontObj::BuildIndex(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const WavefrontObjIndex::Ptr index = WavefrontObjIndex::Build(filePath);
+	if(!index)
+	{
+		return false;
+	}
+
+	const std::string indexFilePath = std::string(filePath) + DF_OBJ_INDEX_FILE_EXTENSION;
+
+	if(!index->Save(indexFilePath.c_str()))
+	{
+		LOG_ERROR("Failed to save OBJ index: path=\"%s\"", indexFilePath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 void DemoFramework::D3D12::WavefrontObj::Draw(const GraphicsCommandList::Ptr& cmdList) const
 {
 	const StaticMesh::Ptr* const pMeshes = m_meshes.GetData();
@@ -131,6 +284,52 @@ void DemoFramework::D3D12::WavefrontObj::Draw(const GraphicsCommandList::Ptr& cm
 	{
 		pMeshes[i]->Draw(cmdList, 1, 0);
 	}
+
+	const ProgressiveMesh::Ptr* const pProgressiveMeshes = m_progressiveMeshes.GetData();
+	const size_t progressiveMeshCount = m_progressiveMeshes.GetCount();
+
+	// Progressive meshes draw whichever LOD is currently resident.
+	for(size_t i = 0; i < progressiveMeshCount; ++i)
+	{
+		pProgressiveMeshes[i]->Draw(cmdList, 1, 0);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::D3D12::WavefrontObj::Stream(const GraphicsCommandList::Ptr& cmdList, const uint64_t byteBudget)
+{
+	const ProgressiveMesh::Ptr* const pProgressiveMeshes = m_progressiveMeshes.GetData();
+	const size_t progressiveMeshCount = m_progressiveMeshes.GetCount();
+
+	uint64_t bytesWritten = 0;
+
+	// Give each mesh whatever is left of the budget. Meshes earlier in the object finish first,
+	// but any unused budget always carries over to the meshes after them.
+	for(size_t i = 0; i < progressiveMeshCount && bytesWritten < byteBudget; ++i)
+	{
+		bytesWritten += pProgressiveMeshes[i]->Stream(cmdList, byteBudget - bytesWritten);
+	}
+
+	return bytesWritten;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::WavefrontObj::IsFullyResident() const
+{
+	const ProgressiveMesh::Ptr* const pProgressiveMeshes = m_progressiveMeshes.GetData();
+	const size_t progressiveMeshCount = m_progressiveMeshes.GetCount();
+
+	for(size_t i = 0; i < progressiveMeshCount; ++i)
+	{
+		if(!pProgressiveMeshes[i]->IsFullyResident())
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -138,7 +337,9 @@ void DemoFramework::D3D12::WavefrontObj::Draw(const GraphicsCommandList::Ptr& cm
 bool DemoFramework::D3D12::WavefrontObj::_build(
 	const InternalData& data,
 	const Device::Ptr& device,
-	const GraphicsCommandList::Ptr& cmdList)
+	const GraphicsCommandList::Ptr& cmdList,
+	const UploadRing::Ptr& uploadRing,
+	const uint32_t lodCount)
 {
 	using namespace DirectX;
 
@@ -148,7 +349,7 @@ bool DemoFramework::D3D12::WavefrontObj::_build(
 		return true;
 	}
 
-	auto createMesh = [this, &data, &device, &cmdList](const tinyobj::shape_t& shape) -> StaticMesh::Ptr
+	auto createGeometry = [this, &data, &device, &cmdList](const tinyobj::shape_t& shape) -> StaticMesh::Geometry
 	{
 		std::unordered_map<
 			tinyobj::index_t,
@@ -260,30 +461,65 @@ bool DemoFramework::D3D12::WavefrontObj::_build(
 			pIndexBuffer[i] = indexBuffer[i];
 		}
 
-		const std::string meshName = data.name + " [" + shape.name + "]";
-
-		return StaticMesh::Create(device, cmdList, meshName.c_str(), geometry);
+		return geometry;
 	};
 
 	std::vector<StaticMesh::Ptr> meshes;
-	meshes.reserve(data.shapes.size());
+	std::vector<ProgressiveMesh::Ptr> progressiveMeshes;
+
+	if(lodCount > 1)
+	{
+		progressiveMeshes.reserve(data.shapes.size());
+	}
+	else
+	{
+		meshes.reserve(data.shapes.size());
+	}
 
 	for(const tinyobj::shape_t& shape : data.shapes)
 	{
+		StaticMesh::Geometry geometry = createGeometry(shape);
+		const std::string meshName = data.name + " [" + shape.name + "]";
+
 		// Attempt to create a mesh from the current shape.
-		StaticMesh::Ptr mesh = createMesh(shape);
-		if(mesh)
+		if(lodCount > 1)
 		{
-			meshes.push_back(mesh);
+			ProgressiveMesh::Ptr mesh = ProgressiveMesh::Create(device, cmdList, uploadRing, meshName.c_str(), std::move(geometry), lodCount);
+			if(mesh)
+			{
+				progressiveMeshes.push_back(mesh);
+			}
+		}
+		else
+		{
+			StaticMesh::Ptr mesh = StaticMesh::Create(device, cmdList, uploadRing, meshName.c_str(), geometry);
+			if(mesh)
+			{
+				meshes.push_back(mesh);
+			}
 		}
 	}
 
 	// Verify that some meshes were actually created.
-	if(meshes.empty())
+	if(meshes.empty() && progressiveMeshes.empty())
 	{
 		return false;
 	}
 
+	if(!progressiveMeshes.empty())
+	{
+		m_progressiveMeshes = ProgressiveMesh::PtrArray::Create(progressiveMeshes.size());
+		ProgressiveMesh::Ptr* const pProgressiveMeshes = m_progressiveMeshes.GetData();
+
+		// Copy the progressive meshes to the output array.
+		for(size_t i = 0; i < progressiveMeshes.size(); ++i)
+		{
+			pProgressiveMeshes[i] = progressiveMeshes[i];
+		}
+
+		return true;
+	}
+
 	// Create the array of meshes.
 	m_meshes = StaticMesh::PtrArray::Create(uint32_t(meshes.size()));
 	StaticMesh::Ptr* const pMeshes = m_meshes.GetData();
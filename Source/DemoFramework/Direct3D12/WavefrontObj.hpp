@@ -19,6 +19,7 @@
 
 //---------------------------------------------------------------------------------------------------------------------
 
+#include "Mesh/ProgressiveMesh.hpp"
 #include "Mesh/StaticMesh.hpp"
 
 #include <memory>
@@ -45,21 +46,49 @@ public:
 	static Ptr Load(
 		const Device::Ptr& device,
 		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
 		const char* name,
-		const char* filePath);
+		const char* filePath,
+		uint32_t lodCount = 1);
+
+	// Load only the named shapes from an OBJ file. This uses the file's sidecar index to parse just the face
+	// statements of the requested shapes and the attribute statements they reference, building (and saving)
+	// the index first when it is missing or older than the OBJ file. Shapes are split the same way as a full load,
+	// so a name used by several 'o' or 'g' statements selects every shape with that name, in file order.
+	static Ptr Load(
+		const Device::Ptr& device,
+		const GraphicsCommandList::Ptr& cmdList,
+		const UploadRing::Ptr& uploadRing,
+		const char* name,
+		const char* filePath,
+		const char* const* shapeNames,
+		size_t shapeNameCount,
+		uint32_t lodCount = 1);
+
+	// Build the sidecar index for an OBJ file ahead of time, replacing any existing index.
+	static bool BuildIndex(const char* filePath);
 
 	void Draw(const GraphicsCommandList::Ptr& cmdList) const;
 
+	// Stream pending LOD data for all progressive meshes in the object, splitting the byte budget between them in order.
+	// Returns the number of bytes recorded. This should be called on the command list for the frame before drawing the
+	// object, and does nothing for objects loaded with a single LOD.
+	uint64_t Stream(const GraphicsCommandList::Ptr& cmdList, uint64_t byteBudget);
+
+	bool IsFullyResident() const;
+
 	const StaticMesh::PtrArray& GetMeshes() const;
+	const ProgressiveMesh::PtrArray& GetProgressiveMeshes() const;
 
 
 private:
 
 	struct InternalData;
 
-	bool _build(const InternalData&, const Device::Ptr&, const GraphicsCommandList::Ptr&);
+	bool _build(const InternalData&, const Device::Ptr&, const GraphicsCommandList::Ptr&, const UploadRing::Ptr&, uint32_t);
 
 	StaticMesh::PtrArray m_meshes;
+	ProgressiveMesh::PtrArray m_progressiveMeshes;
 };
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -70,6 +99,7 @@ template class DF_API DemoFramework::D3D12::WavefrontObj::Ptr;
 
 inline DemoFramework::D3D12::WavefrontObj::WavefrontObj()
 	: m_meshes()
+	, m_progressiveMeshes()
 {
 }
 
@@ -81,3 +111,10 @@ inline const DemoFramework::D3D12::StaticMesh::PtrArray& DemoFramework::D3D12::W
 }
 
 //---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::D3D12::ProgressiveMesh::PtrArray& DemoFramework::D3D12::WavefrontObj::GetProgressiveMeshes() const
+{
+	return m_progressiveMeshes;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,587 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "WavefrontObjIndex.hpp"
+
+#include "../Application/Log.hpp"
+
+#include <tiny_obj_loader.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_OBJ_INDEX_MAGIC   0x58494F44ul // "DOIX"
+#define DF_OBJ_INDEX_VERSION 2
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct ObjIndexFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	uint64_t sourceFileSize;
+	uint64_t sourceWriteTime;
+
+	uint32_t attributeRangeCount[DemoFramework::D3D12::WavefrontObjIndex::AttributeCount];
+	uint32_t shapeCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::WavefrontObjIndex::Ptr DemoFramework::D3D12::WavefrontObjIndex::Build(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<WavefrontObjIndex>();
+
+	if(!_getSourceFileInfo(filePath, output->m_sourceFileSize, output->m_sourceWriteTime))
+	{
+		LOG_ERROR("Failed to query OBJ file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	FILE* const pFile = fopen(filePath, "rb");
+	if(!pFile)
+	{
+		LOG_ERROR("Failed to open OBJ file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	uint32_t attributeCount[AttributeCount] = {};
+
+	// Name of the shape the next face statement will start. Faces declared before any 'o' or 'g' statement belong to
+	// an unnamed shape.
+	std::string pendingShapeName;
+
+	Shape* pCurrentShape = nullptr;
+	FaceRange* pCurrentFaceRange = nullptr;
+	AttributeRange* pCurrentAttributeRange = nullptr;
+	Attribute currentAttribute = AttributeCount;
+
+	auto onLine = [&](const uint64_t lineOffset, const char* const pLine, const size_t lineLength)
+	{
+		const char* pCursor = pLine;
+		const ObjStatement statement = ClassifyObjStatement(pCursor);
+
+		const uint64_t lineEnd = lineOffset + lineLength;
+
+		switch(statement)
+		{
+			case ObjStatement::Position:
+			case ObjStatement::TexCoord:
+			case ObjStatement::Normal:
+			{
+				const Attribute attribute = (statement == ObjStatement::Position)
+					? Position
+					: (statement == ObjStatement::TexCoord)
+						? TexCoord
+						: Normal;
+
+				if(attribute == currentAttribute)
+				{
+					// Extend the current attribute range.
+					pCurrentAttributeRange->size = lineEnd - pCurrentAttributeRange->offset;
+					++pCurrentAttributeRange->count;
+				}
+				else
+				{
+					const AttributeRange range =
+					{
+						lineOffset,                // uint64_t offset
+						lineLength,                // uint64_t size
+						attributeCount[attribute], // uint32_t firstIndex
+						1,                         // uint32_t count
+					};
+
+					output->m_attributeRanges[attribute].push_back(range);
+
+					pCurrentAttributeRange = &output->m_attributeRanges[attribute].back();
+					currentAttribute = attribute;
+				}
+
+				++attributeCount[attribute];
+
+				// Attribute statements end the current face range since they change how relative indices resolve.
+				pCurrentFaceRange = nullptr;
+				break;
+			}
+
+			case ObjStatement::Shape:
+			{
+				// Mirror how tinyobjloader names shapes. An 'o' statement uses the rest of the line verbatim (starting
+				// one character after the keyword), while a 'g' statement only uses its first group name.
+				const char* const pKeyword = pLine + strspn(pLine, " \t");
+
+				if(pKeyword[0] == 'o')
+				{
+					pendingShapeName.assign(pKeyword + 2, lineLength - size_t(pKeyword + 2 - pLine));
+				}
+				else
+				{
+					pendingShapeName.assign(pCursor, strcspn(pCursor, " \t"));
+				}
+
+				// The statement ends the current shape, even if the next one reuses its name. The next shape isn't
+				// created until its first face so shapes without faces are dropped.
+				pCurrentShape = nullptr;
+				pCurrentFaceRange = nullptr;
+				currentAttribute = AttributeCount;
+				break;
+			}
+
+			case ObjStatement::Face:
+			{
+				if(!pCurrentShape)
+				{
+					Shape shape;
+					shape.name = pendingShapeName;
+
+					for(size_t i = 0; i < AttributeCount; ++i)
+					{
+						shape.minIndex[i] = UINT32_MAX;
+						shape.maxIndex[i] = 0;
+					}
+
+					output->m_shapes.push_back(std::move(shape));
+					pCurrentShape = &output->m_shapes.back();
+				}
+
+				if(!pCurrentFaceRange)
+				{
+					FaceRange range;
+					range.offset = lineOffset;
+					range.size = lineLength;
+
+					for(size_t i = 0; i < AttributeCount; ++i)
+					{
+						range.attributeBase[i] = attributeCount[i];
+					}
+
+					pCurrentShape->faceRanges.push_back(range);
+					pCurrentFaceRange = &pCurrentShape->faceRanges.back();
+				}
+				else
+				{
+					pCurrentFaceRange->size = lineEnd - pCurrentFaceRange->offset;
+				}
+
+				int64_t indices[AttributeCount];
+
+				// Track the range of attributes referenced by the shape.
+				while(ParseObjFaceVertex(pCursor, indices))
+				{
+					for(size_t i = 0; i < AttributeCount; ++i)
+					{
+						const int64_t resolvedIndex = ResolveObjIndex(indices[i], attributeCount[i]);
+						if(resolvedIndex >= 0)
+						{
+							pCurrentShape->minIndex[i] = std::min(pCurrentShape->minIndex[i], uint32_t(resolvedIndex));
+							pCurrentShape->maxIndex[i] = std::max(pCurrentShape->maxIndex[i], uint32_t(resolvedIndex));
+						}
+					}
+				}
+
+				currentAttribute = AttributeCount;
+				break;
+			}
+
+			default:
+				// Comments, materials, smoothing groups, etc. don't affect the index.
+				break;
+		}
+	};
+
+	const bool readResult = ReadObjLines(pFile, 0, output->m_sourceFileSize, onLine);
+	fclose(pFile);
+
+	if(!readResult)
+	{
+		LOG_ERROR("Failed to read OBJ file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::WavefrontObjIndex::Ptr DemoFramework::D3D12::WavefrontObjIndex::LoadOrBuild(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	const std::string indexFilePath = std::string(filePath) + DF_OBJ_INDEX_FILE_EXTENSION;
+
+	uint64_t sourceFileSize = 0;
+	uint64_t sourceWriteTime = 0;
+
+	if(!_getSourceFileInfo(filePath, sourceFileSize, sourceWriteTime))
+	{
+		LOG_ERROR("Failed to query OBJ file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	Ptr output = _load(indexFilePath.c_str(), sourceFileSize, sourceWriteTime);
+	if(output)
+	{
+		return output;
+	}
+
+	// The index is missing or out of date, so it needs to be rebuilt.
+	output = Build(filePath);
+	if(!output)
+	{
+		return Ptr();
+	}
+
+	if(!output->Save(indexFilePath.c_str()))
+	{
+		// Not fatal; the index will just be rebuilt next time.
+		LOG_WRITE("(warning) Failed to save OBJ index: path=\"%s\"", indexFilePath.c_str());
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::WavefrontObjIndex::Save(const char* const indexFilePath) const
+{
+	if(!indexFilePath || indexFilePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	FILE* const pFile = fopen(indexFilePath, "wb");
+	if(!pFile)
+	{
+		return false;
+	}
+
+	ObjIndexFileHeader header = {};
+	header.magic = DF_OBJ_INDEX_MAGIC;
+	header.version = DF_OBJ_INDEX_VERSION;
+	header.sourceFileSize = m_sourceFileSize;
+	header.sourceWriteTime = m_sourceWriteTime;
+	header.shapeCount = uint32_t(m_shapes.size());
+
+	for(size_t i = 0; i < AttributeCount; ++i)
+	{
+		header.attributeRangeCount[i] = uint32_t(m_attributeRanges[i].size());
+	}
+
+	bool result = (fwrite(&header, sizeof(header), 1, pFile) == 1);
+
+	for(size_t i = 0; result && i < AttributeCount; ++i)
+	{
+		if(!m_attributeRanges[i].empty())
+		{
+			result = (fwrite(m_attributeRanges[i].data(), sizeof(AttributeRange), m_attributeRanges[i].size(), pFile) == m_attributeRanges[i].size());
+		}
+	}
+
+	for(size_t i = 0; result && i < m_shapes.size(); ++i)
+	{
+		const Shape& shape = m_shapes[i];
+
+		const uint32_t nameLength = uint32_t(shape.name.size());
+		const uint32_t faceRangeCount = uint32_t(shape.faceRanges.size());
+
+		result = (fwrite(&nameLength, sizeof(nameLength), 1, pFile) == 1)
+			&& (nameLength == 0 || fwrite(shape.name.data(), nameLength, 1, pFile) == 1)
+			&& (fwrite(shape.minIndex, sizeof(shape.minIndex), 1, pFile) == 1)
+			&& (fwrite(shape.maxIndex, sizeof(shape.maxIndex), 1, pFile) == 1)
+			&& (fwrite(&faceRangeCount, sizeof(faceRangeCount), 1, pFile) == 1)
+			&& (faceRangeCount == 0 || fwrite(shape.faceRanges.data(), sizeof(FaceRange), faceRangeCount, pFile) == faceRangeCount);
+	}
+
+	fclose(pFile);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::WavefrontObjIndex::ParseShapes(
+	FILE* const pFile,
+	const std::vector<const Shape*>& selectedShapes,
+	tinyobj::attrib_t& outAttrib,
+	std::vector<tinyobj::shape_t>& outShapes) const
+{
+	if(!pFile)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	constexpr size_t attributeCount = AttributeCount;
+	constexpr size_t componentCount[attributeCount] = { 3, 2, 3 };
+
+	constexpr ObjStatement statements[attributeCount] =
+	{
+		ObjStatement::Position,
+		ObjStatement::TexCoord,
+		ObjStatement::Normal,
+	};
+
+	std::vector<tinyobj::real_t>* const pAttributeData[attributeCount] =
+	{
+		&outAttrib.vertices,
+		&outAttrib.texcoords,
+		&outAttrib.normals,
+	};
+
+	uint32_t minIndex[attributeCount];
+	uint32_t maxIndex[attributeCount];
+
+	// Find the full range of each attribute type referenced by the selected shapes.
+	for(size_t i = 0; i < attributeCount; ++i)
+	{
+		minIndex[i] = UINT32_MAX;
+		maxIndex[i] = 0;
+
+		for(const Shape* const pShape : selectedShapes)
+		{
+			minIndex[i] = std::min(minIndex[i], pShape->minIndex[i]);
+			maxIndex[i] = std::max(maxIndex[i], pShape->maxIndex[i]);
+		}
+	}
+
+	// Read the referenced attributes, skipping every attribute range that falls entirely outside of what we need.
+	for(size_t i = 0; i < attributeCount; ++i)
+	{
+		if(minIndex[i] > maxIndex[i])
+		{
+			continue;
+		}
+
+		std::vector<tinyobj::real_t>& attributeData = *pAttributeData[i];
+		attributeData.assign(size_t(maxIndex[i] - minIndex[i] + 1) * componentCount[i], tinyobj::real_t(0));
+
+		for(const AttributeRange& range : m_attributeRanges[i])
+		{
+			if(range.firstIndex > maxIndex[i] || range.firstIndex + range.count <= minIndex[i])
+			{
+				continue;
+			}
+
+			uint32_t attributeIndex = range.firstIndex;
+
+			auto onLine = [&](uint64_t, const char* const pLine, size_t)
+			{
+				const char* pCursor = pLine;
+
+				if(ClassifyObjStatement(pCursor) != statements[i])
+				{
+					// Skip comments and blank lines between attribute statements.
+					return;
+				}
+
+				if(attributeIndex >= minIndex[i] && attributeIndex <= maxIndex[i])
+				{
+					tinyobj::real_t* const pOutput = attributeData.data() + (size_t(attributeIndex - minIndex[i]) * componentCount[i]);
+
+					for(size_t component = 0; component < componentCount[i]; ++component)
+					{
+						char* pEnd = nullptr;
+						pOutput[component] = tinyobj::real_t(strtod(pCursor, &pEnd));
+						pCursor = pEnd;
+					}
+				}
+
+				++attributeIndex;
+			};
+
+			if(!ReadObjLines(pFile, range.offset, range.size, onLine))
+			{
+				return false;
+			}
+		}
+	}
+
+	outShapes.reserve(selectedShapes.size());
+
+	// Parse the faces of each selected shape, rebasing the attribute indices to the compacted attribute arrays.
+	for(const Shape* const pShape : selectedShapes)
+	{
+		tinyobj::shape_t shape;
+		shape.name = pShape->name;
+
+		for(const FaceRange& range : pShape->faceRanges)
+		{
+			auto rebaseIndex = [&range, &minIndex](const int64_t index, const size_t attribute) -> int
+			{
+				const int64_t resolvedIndex = ResolveObjIndex(index, range.attributeBase[attribute]);
+
+				return (resolvedIndex >= 0)
+					? int(resolvedIndex - minIndex[attribute])
+					: -1;
+			};
+
+			auto onLine = [&shape, &rebaseIndex](uint64_t, const char* const pLine, size_t)
+			{
+				const char* pCursor = pLine;
+
+				if(ClassifyObjStatement(pCursor) != ObjStatement::Face)
+				{
+					return;
+				}
+
+				int64_t indices[attributeCount];
+				uint32_t faceVertexCount = 0;
+
+				while(ParseObjFaceVertex(pCursor, indices))
+				{
+					tinyobj::index_t index;
+					index.vertex_index = rebaseIndex(indices[Position], Position);
+					index.texcoord_index = rebaseIndex(indices[TexCoord], TexCoord);
+					index.normal_index = rebaseIndex(indices[Normal], Normal);
+
+					shape.mesh.indices.push_back(index);
+					++faceVertexCount;
+				}
+
+				if(faceVertexCount > UINT8_MAX)
+				{
+					// Faces this large can't be described by the face vertex count type, so drop them.
+					shape.mesh.indices.resize(shape.mesh.indices.size() - faceVertexCount);
+				}
+				else if(faceVertexCount > 0)
+				{
+					shape.mesh.num_face_vertices.push_back(uint8_t(faceVertexCount));
+				}
+			};
+
+			if(!ReadObjLines(pFile, range.offset, range.size, onLine))
+			{
+				return false;
+			}
+		}
+
+		outShapes.push_back(std::move(shape));
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::D3D12::WavefrontObjIndex::Ptr DemoFramework::D3D12::WavefrontObjIndex::_load(
+	const char* const indexFilePath,
+	const uint64_t sourceFileSize,
+	const uint64_t sourceWriteTime)
+{
+	FILE* const pFile = fopen(indexFilePath, "rb");
+	if(!pFile)
+	{
+		return Ptr();
+	}
+
+	ObjIndexFileHeader header = {};
+
+	// Only accept the index when it was built from the exact version of the OBJ file that's on disk.
+	if(fread(&header, sizeof(header), 1, pFile) != 1
+		|| header.magic != DF_OBJ_INDEX_MAGIC
+		|| header.version != DF_OBJ_INDEX_VERSION
+		|| header.sourceFileSize != sourceFileSize
+		|| header.sourceWriteTime != sourceWriteTime)
+	{
+		fclose(pFile);
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<WavefrontObjIndex>();
+	output->m_sourceFileSize = sourceFileSize;
+	output->m_sourceWriteTime = sourceWriteTime;
+	output->m_shapes.resize(header.shapeCount);
+
+	bool result = true;
+
+	for(size_t i = 0; result && i < AttributeCount; ++i)
+	{
+		output->m_attributeRanges[i].resize(header.attributeRangeCount[i]);
+
+		if(header.attributeRangeCount[i] > 0)
+		{
+			result = (fread(output->m_attributeRanges[i].data(), sizeof(AttributeRange), header.attributeRangeCount[i], pFile) == header.attributeRangeCount[i]);
+		}
+	}
+
+	for(size_t i = 0; result && i < header.shapeCount; ++i)
+	{
+		Shape& shape = output->m_shapes[i];
+
+		uint32_t nameLength = 0;
+		uint32_t faceRangeCount = 0;
+
+		result = (fread(&nameLength, sizeof(nameLength), 1, pFile) == 1);
+		if(result)
+		{
+			shape.name.resize(nameLength);
+			result = (nameLength == 0 || fread(&shape.name[0], nameLength, 1, pFile) == 1)
+				&& (fread(shape.minIndex, sizeof(shape.minIndex), 1, pFile) == 1)
+				&& (fread(shape.maxIndex, sizeof(shape.maxIndex), 1, pFile) == 1)
+				&& (fread(&faceRangeCount, sizeof(faceRangeCount), 1, pFile) == 1);
+		}
+
+		if(result)
+		{
+			shape.faceRanges.resize(faceRangeCount);
+			result = (faceRangeCount == 0 || fread(shape.faceRanges.data(), sizeof(FaceRange), faceRangeCount, pFile) == faceRangeCount);
+		}
+	}
+
+	fclose(pFile);
+
+	if(!result)
+	{
+		LOG_WRITE("(warning) OBJ index file is truncated: path=\"%s\"", indexFilePath);
+		return Ptr();
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::D3D12::WavefrontObjIndex::_getSourceFileInfo(
+	const char* const filePath,
+	uint64_t& outFileSize,
+	uint64_t& outWriteTime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+
+	if(!GetFileAttributesExA(filePath, GetFileExInfoStandard, &fileAttributes))
+	{
+		return false;
+	}
+
+	outFileSize = (uint64_t(fileAttributes.nFileSizeHigh) << 32) | uint64_t(fileAttributes.nFileSizeLow);
+	outWriteTime = (uint64_t(fileAttributes.ftLastWriteTime.dwHighDateTime) << 32) | uint64_t(fileAttributes.ftLastWriteTime.dwLowDateTime);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,408 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_OBJ_INDEX_FILE_EXTENSION ".dfidx"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	class WavefrontObjIndex;
+}}
+
+namespace tinyobj {
+	struct attrib_t;
+	struct shape_t;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Byte offset index of a Wavefront OBJ file, used by WavefrontObj to parse only the parts of a file needed by a
+// specific set of shapes. This is an implementation detail of WavefrontObj and is intentionally not exported.
+//
+// Shapes are split the same way tinyobjloader splits them for a full load, so both paths produce the same meshes:
+// every 'o' or 'g' statement ends the current shape, and the next face statement starts a new one, even when an
+// earlier shape used the same name. Shapes without any faces are dropped. Faces declared before the first 'o' or 'g'
+// statement belong to a shape with an empty name. An 'o' statement names its shape with the rest of its line, while
+// a 'g' statement only uses its first name. For each shape, the index records the byte ranges of its face statements
+// along with the number of attributes of each type declared before each range, which is what negative (relative)
+// face indices are resolved against. Contiguous runs of 'v', 'vt' and 'vn' statements are recorded separately so
+// attribute data can be read without scanning the faces.
+class DemoFramework::D3D12::WavefrontObjIndex
+{
+public:
+
+	typedef std::shared_ptr<WavefrontObjIndex> Ptr;
+
+	enum Attribute
+	{
+		Position,
+		TexCoord,
+		Normal,
+
+		AttributeCount,
+	};
+
+	struct FaceRange
+	{
+		uint64_t offset;
+		uint64_t size;
+
+		uint32_t attributeBase[AttributeCount];
+	};
+
+	struct AttributeRange
+	{
+		uint64_t offset;
+		uint64_t size;
+
+		uint32_t firstIndex;
+		uint32_t count;
+	};
+
+	struct Shape
+	{
+		std::string name;
+		std::vector<FaceRange> faceRanges;
+
+		// Inclusive range of zero-based attribute indices referenced by the shape's faces.
+		// When a shape references no attributes of a type, the minimum is greater than the maximum.
+		uint32_t minIndex[AttributeCount];
+		uint32_t maxIndex[AttributeCount];
+	};
+
+	WavefrontObjIndex();
+	WavefrontObjIndex(const WavefrontObjIndex&) = delete;
+	WavefrontObjIndex(WavefrontObjIndex&&) = delete;
+
+	// Scan the entire OBJ file and build its index.
+	static Ptr Build(const char* filePath);
+
+	// Load the sidecar index for an OBJ file if one exists and is still up to date,
+	// otherwise build the index from scratch and save it alongside the OBJ file.
+	static Ptr LoadOrBuild(const char* filePath);
+
+	bool Save(const char* indexFilePath) const;
+
+	// Parse the attributes and faces of the given shapes into the same structures a full tinyobjloader load produces.
+	// Attributes are compacted to the range referenced by the selected shapes, and face indices are rebased to match.
+	bool ParseShapes(
+		FILE* pFile,
+		const std::vector<const Shape*>& selectedShapes,
+		tinyobj::attrib_t& outAttrib,
+		std::vector<tinyobj::shape_t>& outShapes) const;
+
+	const std::vector<Shape>& GetShapes() const;
+	const std::vector<AttributeRange>& GetAttributeRanges(Attribute attribute) const;
+
+
+private:
+
+	static Ptr _load(const char* indexFilePath, uint64_t sourceFileSize, uint64_t sourceWriteTime);
+	static bool _getSourceFileInfo(const char* filePath, uint64_t& outFileSize, uint64_t& outWriteTime);
+
+	std::vector<Shape> m_shapes;
+	std::vector<AttributeRange> m_attributeRanges[AttributeCount];
+
+	uint64_t m_sourceFileSize;
+	uint64_t m_sourceWriteTime;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::WavefrontObjIndex::WavefrontObjIndex()
+	: m_shapes()
+	, m_attributeRanges()
+	, m_sourceFileSize(0)
+	, m_sourceWriteTime(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<DemoFramework::D3D12::WavefrontObjIndex::Shape>& DemoFramework::D3D12::WavefrontObjIndex::GetShapes() const
+{
+	return m_shapes;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<DemoFramework::D3D12::WavefrontObjIndex::AttributeRange>& DemoFramework::D3D12::WavefrontObjIndex::GetAttributeRanges(
+	const Attribute attribute) const
+{
+	return m_attributeRanges[attribute];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace D3D12 {
+	// Read a byte range of an OBJ file block by block, invoking the callback once per line with the byte offset of
+	// the line in the file, the null-terminated line (without any line ending characters) and its length.
+	template <typename Callback>
+	bool ReadObjLines(FILE* pFile, uint64_t offset, uint64_t size, Callback&& callback);
+
+	enum class ObjStatement
+	{
+		Other,
+		Position,
+		TexCoord,
+		Normal,
+		Face,
+		Shape,
+	};
+
+	// Determine the type of statement on a line and advance the cursor past its keyword.
+	ObjStatement ClassifyObjStatement(const char*& pCursor);
+
+	// Parse the next "v", "v/t", "v//n" or "v/t/n" reference of a face statement.
+	// Indices that are absent from the reference are set to zero.
+	bool ParseObjFaceVertex(const char*& pCursor, int64_t (&outIndices)[3]);
+
+	// Resolve a one-based (or negative, relative) OBJ index to a zero-based index. Returns -1 for invalid indices.
+	int64_t ResolveObjIndex(int64_t index, uint32_t attributeCount);
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Callback>
+bool DemoFramework::D3D12::ReadObjLines(FILE* const pFile, const uint64_t offset, const uint64_t size, Callback&& callback)
+{
+	constexpr size_t blockSize = 4 * 1024 * 1024;
+
+	if(_fseeki64(pFile, int64_t(offset), SEEK_SET) != 0)
+	{
+		return false;
+	}
+
+	// Leave room for a null terminator after the last byte read.
+	std::vector<char> buffer(size_t(std::min<uint64_t>(blockSize, size)) + 1);
+
+	uint64_t bufferOffset = offset;
+	uint64_t remaining = size;
+	size_t carry = 0;
+
+	while(remaining > 0)
+	{
+		if(carry + 1 == buffer.size())
+		{
+			// A single line is longer than the buffer, so grow it until the entire line fits.
+			buffer.resize((buffer.size() * 2) - 1);
+		}
+
+		const size_t readSize = size_t(std::min<uint64_t>(buffer.size() - carry - 1, remaining));
+		if(fread(buffer.data() + carry, 1, readSize, pFile) != readSize)
+		{
+			return false;
+		}
+
+		remaining -= readSize;
+
+		const size_t validSize = carry + readSize;
+		buffer[validSize] = '\0';
+
+		char* const pBuffer = buffer.data();
+		size_t lineStart = 0;
+
+		for(;;)
+		{
+			char* const pNewLine = reinterpret_cast<char*>(memchr(pBuffer + lineStart, '\n', validSize - lineStart));
+
+			if(!pNewLine && remaining > 0)
+			{
+				// The current line continues in the next block.
+				break;
+			}
+
+			const size_t lineEnd = pNewLine ? size_t(pNewLine - pBuffer) : validSize;
+			size_t lineLength = lineEnd - lineStart;
+
+			// Strip the line ending so the callback receives a clean, null-terminated line.
+			pBuffer[lineEnd] = '\0';
+			if(lineLength > 0 && pBuffer[lineStart + lineLength - 1] == '\r')
+			{
+				--lineLength;
+				pBuffer[lineStart + lineLength] = '\0';
+			}
+
+			callback(bufferOffset + lineStart, pBuffer + lineStart, lineLength);
+
+			lineStart = lineEnd + 1;
+
+			if(lineStart >= validSize)
+			{
+				break;
+			}
+		}
+
+		// Move the partial line at the end of the block to the start of the buffer.
+		carry = (lineStart < validSize) ? validSize - lineStart : 0;
+		if(carry > 0)
+		{
+			memmove(pBuffer, pBuffer + lineStart, carry);
+		}
+
+		bufferOffset += validSize - carry;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::D3D12::ObjStatement DemoFramework::D3D12::ClassifyObjStatement(const char*& pCursor)
+{
+	auto isSpace = [](const char c) { return c == ' ' || c == '\t'; };
+	auto isEnd = [&isSpace](const char c) { return c == '\0' || isSpace(c); };
+
+	while(isSpace(*pCursor))
+	{
+		++pCursor;
+	}
+
+	ObjStatement output = ObjStatement::Other;
+	size_t keywordLength = 1;
+
+	switch(pCursor[0])
+	{
+		case 'v':
+			if(isEnd(pCursor[1]))
+			{
+				output = ObjStatement::Position;
+			}
+			else if(pCursor[1] == 't' && isEnd(pCursor[2]))
+			{
+				output = ObjStatement::TexCoord;
+				keywordLength = 2;
+			}
+			else if(pCursor[1] == 'n' && isEnd(pCursor[2]))
+			{
+				output = ObjStatement::Normal;
+				keywordLength = 2;
+			}
+			break;
+
+		case 'f':
+			if(isEnd(pCursor[1]))
+			{
+				output = ObjStatement::Face;
+			}
+			break;
+
+		case 'o':
+		case 'g':
+			// Like tinyobjloader, a bare keyword without anything following it isn't treated as a statement.
+			if(isSpace(pCursor[1]))
+			{
+				output = ObjStatement::Shape;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	if(output != ObjStatement::Other)
+	{
+		pCursor += keywordLength;
+
+		while(isSpace(*pCursor))
+		{
+			++pCursor;
+		}
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::D3D12::ParseObjFaceVertex(const char*& pCursor, int64_t (&outIndices)[3])
+{
+	while(*pCursor == ' ' || *pCursor == '\t')
+	{
+		++pCursor;
+	}
+
+	char* pEnd = nullptr;
+
+	outIndices[0] = strtoll(pCursor, &pEnd, 10);
+	outIndices[1] = 0;
+	outIndices[2] = 0;
+
+	if(pEnd == pCursor)
+	{
+		return false;
+	}
+
+	pCursor = pEnd;
+
+	if(*pCursor == '/')
+	{
+		++pCursor;
+
+		// The texture coordinate index is optional ("v//n").
+		if(*pCursor != '/')
+		{
+			outIndices[1] = strtoll(pCursor, &pEnd, 10);
+			pCursor = pEnd;
+		}
+
+		if(*pCursor == '/')
+		{
+			++pCursor;
+
+			outIndices[2] = strtoll(pCursor, &pEnd, 10);
+			pCursor = pEnd;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline int64_t DemoFramework::D3D12::ResolveObjIndex(const int64_t index, const uint32_t attributeCount)
+{
+	if(index > 0)
+	{
+		return index - 1;
+	}
+
+	if(index < 0 && -index <= int64_t(attributeCount))
+	{
+		return int64_t(attributeCount) + index;
+	}
+
+	return -1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,1277 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "BlockCompressor.hpp"
+#include "CpuFeatures.hpp"
+
+#include <algorithm>
+#include <float.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_BLOCK_COMPRESSOR_POWER_ITERATIONS  8
+#define DF_BLOCK_COMPRESSOR_REFINE_ITERATIONS 2
+
+// Largest finite value representable as an unsigned half float.
+#define DF_BLOCK_COMPRESSOR_MAX_HALF 0x7BFF
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	// Texels of a 4x4 block stored one channel at a time so the kernels can process 8 texels per register.
+	struct Block
+	{
+		float channels[4][16];
+
+		// Bit set for each texel inside the image; edge blocks repeat texels to fill the rest.
+		uint32_t validMask;
+	};
+
+	// Little endian bit stream for the 128-bit BC6H and BC7 blocks.
+	struct BlockBits
+	{
+		uint64_t words[2];
+		uint32_t position;
+
+		void Write(const uint64_t value, const uint32_t bitCount)
+		{
+			for(uint32_t bit = 0; bit < bitCount; ++bit, ++position)
+			{
+				words[position / 64] |= ((value >> bit) & 1) << (position % 64);
+			}
+		}
+	};
+
+	typedef void (*ProjectFunc)(const Block&, uint32_t, const float*, const float*, uint32_t, uint8_t*);
+	typedef void (*FindNearestFunc)(const Block&, uint32_t, const float (*)[4], uint32_t, uint8_t*);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Interpolation weights (out of 64) shared by the 4-bit index modes of BC6H and BC7.
+static const int32_t Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+//---------------------------------------------------------------------------------------------------------------------
+// Endpoint fitting
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FitPrincipalAxis(
+	const Block& block,
+	const uint32_t channelCount,
+	float* const pOutStart,
+	float* const pOutEnd)
+{
+	float mean[4] = {};
+	float minValue[4];
+	float maxValue[4];
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		minValue[channel] = block.channels[channel][0];
+		maxValue[channel] = block.channels[channel][0];
+
+		for(uint32_t texel = 0; texel < 16; ++texel)
+		{
+			const float value = block.channels[channel][texel];
+
+			mean[channel] += value;
+			minValue[channel] = std::min(minValue[channel], value);
+			maxValue[channel] = std::max(maxValue[channel], value);
+		}
+
+		mean[channel] *= (1.0f / 16.0f);
+	}
+
+	float covariance[4][4] = {};
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		float delta[4];
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			delta[channel] = block.channels[channel][texel] - mean[channel];
+		}
+
+		for(uint32_t row = 0; row < channelCount; ++row)
+		{
+			for(uint32_t column = row; column < channelCount; ++column)
+			{
+				covariance[row][column] += delta[row] * delta[column];
+			}
+		}
+	}
+
+	for(uint32_t row = 0; row < channelCount; ++row)
+	{
+		for(uint32_t column = 0; column < row; ++column)
+		{
+			covariance[row][column] = covariance[column][row];
+		}
+	}
+
+	// Power iteration, seeded with the diagonal of the bounding box, to find the direction of greatest variance.
+	float axis[4] = {};
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		axis[channel] = maxValue[channel] - minValue[channel];
+	}
+
+	for(uint32_t iteration = 0; iteration < DF_BLOCK_COMPRESSOR_POWER_ITERATIONS; ++iteration)
+	{
+		float next[4] = {};
+		float lengthSq = 0.0f;
+
+		for(uint32_t row = 0; row < channelCount; ++row)
+		{
+			for(uint32_t column = 0; column < channelCount; ++column)
+			{
+				next[row] += covariance[row][column] * axis[column];
+			}
+
+			lengthSq += next[row] * next[row];
+		}
+
+		if(lengthSq < 1.0e-12f)
+		{
+			break;
+		}
+
+		const float invLength = 1.0f / sqrtf(lengthSq);
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			axis[channel] = next[channel] * invLength;
+		}
+	}
+
+	// Extend the axis through the mean out to the furthest projected texels on either side.
+	float minT = 0.0f;
+	float maxT = 0.0f;
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		float t = 0.0f;
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			t += (block.channels[channel][texel] - mean[channel]) * axis[channel];
+		}
+
+		minT = std::min(minT, t);
+		maxT = std::max(maxT, t);
+	}
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		pOutStart[channel] = mean[channel] + (axis[channel] * minT);
+		pOutEnd[channel] = mean[channel] + (axis[channel] * maxT);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void RefineEndpoints(
+	const Block& block,
+	const uint32_t channelCount,
+	const float* const pTexelWeights,
+	float* const pStart,
+	float* const pEnd)
+{
+	// Least squares solution for the two endpoints given the interpolation weight of every texel.
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+
+	float ap[4] = {};
+	float bp[4] = {};
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		const float b = pTexelWeights[texel];
+		const float a = 1.0f - b;
+
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			ap[channel] += a * block.channels[channel][texel];
+			bp[channel] += b * block.channels[channel][texel];
+		}
+	}
+
+	const float determinant = (aa * bb) - (ab * ab);
+
+	if(fabsf(determinant) < 1.0e-6f)
+	{
+		// Every texel uses the same weight, so there's nothing to solve for.
+		return;
+	}
+
+	const float invDeterminant = 1.0f / determinant;
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		pStart[channel] = ((bb * ap[channel]) - (ab * bp[channel])) * invDeterminant;
+		pEnd[channel] = ((aa * bp[channel]) - (ab * ap[channel])) * invDeterminant;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Index selection kernels
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ProjectScalar(
+	const Block& block,
+	const uint32_t channelCount,
+	const float* const pStart,
+	const float* const pEnd,
+	const uint32_t levelCount,
+	uint8_t* const pOutLevels)
+{
+	float direction[4];
+	float lengthSq = 0.0f;
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		direction[channel] = pEnd[channel] - pStart[channel];
+		lengthSq += direction[channel] * direction[channel];
+	}
+
+	const float scale = (lengthSq > 0.0f) ? (float(levelCount - 1) / lengthSq) : 0.0f;
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		float t = 0.0f;
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			t += (block.channels[channel][texel] - pStart[channel]) * direction[channel];
+		}
+
+		const float level = std::min(std::max((t * scale) + 0.5f, 0.0f), float(levelCount - 1));
+
+		pOutLevels[texel] = uint8_t(level);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FindNearestScalar(
+	const Block& block,
+	const uint32_t channelCount,
+	const float (* const pPalette)[4],
+	const uint32_t paletteSize,
+	uint8_t* const pOutIndices)
+{
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		float bestError = FLT_MAX;
+		uint8_t bestIndex = 0;
+
+		for(uint32_t entry = 0; entry < paletteSize; ++entry)
+		{
+			float error = 0.0f;
+
+			for(uint32_t channel = 0; channel < channelCount; ++channel)
+			{
+				const float delta = block.channels[channel][texel] - pPalette[entry][channel];
+				error += delta * delta;
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+				bestIndex = uint8_t(entry);
+			}
+		}
+
+		pOutIndices[texel] = bestIndex;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// AVX2 versions of the kernels above. These are only ever called after checking CpuFeatures::HasAvx2().
+
+static void ProjectAvx2(
+	const Block& block,
+	const uint32_t channelCount,
+	const float* const pStart,
+	const float* const pEnd,
+	const uint32_t levelCount,
+	uint8_t* const pOutLevels)
+{
+	float direction[4];
+	float lengthSq = 0.0f;
+
+	for(uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		direction[channel] = pEnd[channel] - pStart[channel];
+		lengthSq += direction[channel] * direction[channel];
+	}
+
+	const __m256 scale = _mm256_set1_ps((lengthSq > 0.0f) ? (float(levelCount - 1) / lengthSq) : 0.0f);
+	const __m256 maxLevel = _mm256_set1_ps(float(levelCount - 1));
+	const __m256 zero = _mm256_setzero_ps();
+
+	for(uint32_t half = 0; half < 2; ++half)
+	{
+		__m256 t = _mm256_setzero_ps();
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			const __m256 values = _mm256_loadu_ps(block.channels[channel] + (half * 8));
+			const __m256 delta = _mm256_sub_ps(values, _mm256_set1_ps(pStart[channel]));
+
+			t = _mm256_fmadd_ps(delta, _mm256_set1_ps(direction[channel]), t);
+		}
+
+		const __m256 level = _mm256_min_ps(_mm256_max_ps(_mm256_round_ps(_mm256_mul_ps(t, scale), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), zero), maxLevel);
+		const __m256i levelInts = _mm256_cvttps_epi32(level);
+
+		alignas(32) int32_t levels[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(levels), levelInts);
+
+		for(uint32_t i = 0; i < 8; ++i)
+		{
+			pOutLevels[(half * 8) + i] = uint8_t(levels[i]);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FindNearestAvx2(
+	const Block& block,
+	const uint32_t channelCount,
+	const float (* const pPalette)[4],
+	const uint32_t paletteSize,
+	uint8_t* const pOutIndices)
+{
+	for(uint32_t half = 0; half < 2; ++half)
+	{
+		__m256 values[4];
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			values[channel] = _mm256_loadu_ps(block.channels[channel] + (half * 8));
+		}
+
+		__m256 bestError = _mm256_set1_ps(FLT_MAX);
+		__m256 bestIndex = _mm256_setzero_ps();
+
+		for(uint32_t entry = 0; entry < paletteSize; ++entry)
+		{
+			__m256 error = _mm256_setzero_ps();
+
+			for(uint32_t channel = 0; channel < channelCount; ++channel)
+			{
+				const __m256 delta = _mm256_sub_ps(values[channel], _mm256_set1_ps(pPalette[entry][channel]));
+				error = _mm256_fmadd_ps(delta, delta, error);
+			}
+
+			const __m256 closer = _mm256_cmp_ps(error, bestError, _CMP_LT_OQ);
+
+			bestError = _mm256_blendv_ps(bestError, error, closer);
+			bestIndex = _mm256_blendv_ps(bestIndex, _mm256_set1_ps(float(entry)), closer);
+		}
+
+		alignas(32) int32_t indices[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(indices), _mm256_cvttps_epi32(bestIndex));
+
+		for(uint32_t i = 0; i < 8; ++i)
+		{
+			pOutIndices[(half * 8) + i] = uint8_t(indices[i]);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static ProjectFunc GetProjectFunc()
+{
+	return DemoFramework::Utility::CpuFeatures::HasAvx2() ? ProjectAvx2 : ProjectScalar;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static FindNearestFunc GetFindNearestFunc()
+{
+	return DemoFramework::Utility::CpuFeatures::HasAvx2() ? FindNearestAvx2 : FindNearestScalar;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float MeasureError(
+	const Block& block,
+	const uint32_t channelCount,
+	const float (* const pPalette)[4],
+	const uint8_t* const pIndices)
+{
+	float error = 0.0f;
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		if((block.validMask & (1u << texel)) == 0)
+		{
+			continue;
+		}
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			const float delta = block.channels[channel][texel] - pPalette[pIndices[texel]][channel];
+			error += delta * delta;
+		}
+	}
+
+	return error;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Pick indices either by projecting onto the endpoint line or by searching the whole palette. 'pLevelToIndex' maps
+// evenly spaced levels along the line from start to end onto the format's index values.
+static void SelectIndices(
+	const Block& block,
+	const uint32_t channelCount,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	const float* const pStart,
+	const float* const pEnd,
+	const float (* const pPalette)[4],
+	const uint32_t paletteSize,
+	const uint8_t* const pLevelToIndex,
+	uint8_t* const pOutIndices)
+{
+	if(quality == DemoFramework::Utility::BlockCompressor::Quality::Quality)
+	{
+		GetFindNearestFunc()(block, channelCount, pPalette, paletteSize, pOutIndices);
+	}
+	else
+	{
+		uint8_t levels[16];
+		GetProjectFunc()(block, channelCount, pStart, pEnd, paletteSize, levels);
+
+		for(uint32_t texel = 0; texel < 16; ++texel)
+		{
+			pOutIndices[texel] = pLevelToIndex ? pLevelToIndex[levels[texel]] : levels[texel];
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BC1 / BC3 color
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint16_t QuantizeRgb565(const float* const pColor)
+{
+	const uint32_t r = uint32_t(std::min(std::max((pColor[0] * (31.0f / 255.0f)) + 0.5f, 0.0f), 31.0f));
+	const uint32_t g = uint32_t(std::min(std::max((pColor[1] * (63.0f / 255.0f)) + 0.5f, 0.0f), 63.0f));
+	const uint32_t b = uint32_t(std::min(std::max((pColor[2] * (31.0f / 255.0f)) + 0.5f, 0.0f), 31.0f));
+
+	return uint16_t((r << 11) | (g << 5) | b);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ExpandRgb565(const uint16_t color, float* const pOutColor)
+{
+	const uint32_t r = (color >> 11) & 0x1F;
+	const uint32_t g = (color >> 5) & 0x3F;
+	const uint32_t b = color & 0x1F;
+
+	pOutColor[0] = float((r << 3) | (r >> 2));
+	pOutColor[1] = float((g << 2) | (g >> 4));
+	pOutColor[2] = float((b << 3) | (b >> 2));
+	pOutColor[3] = 0.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float EncodeColorBlock(
+	const Block& block,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	uint8_t* const pOutput)
+{
+	using Quality = DemoFramework::Utility::BlockCompressor::Quality;
+
+	// Palette order along the line from color 0 to color 1 for the 4-color mode.
+	static const uint8_t levelToIndex[4] = { 0, 2, 3, 1 };
+	static const float indexWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	float start[4];
+	float end[4];
+
+	FitPrincipalAxis(block, 3, end, start);
+
+	uint16_t color0 = 0;
+	uint16_t color1 = 0;
+	float palette[4][4];
+	uint8_t indices[16] = {};
+
+	const uint32_t passCount = (quality == Quality::Quality) ? (1 + DF_BLOCK_COMPRESSOR_REFINE_ITERATIONS) : 1;
+
+	float bestError = FLT_MAX;
+	uint8_t bestOutput[8] = {};
+
+	for(uint32_t pass = 0; pass < passCount; ++pass)
+	{
+		color0 = QuantizeRgb565(start);
+		color1 = QuantizeRgb565(end);
+
+		// The 4-color mode requires color 0 to be the larger value.
+		if(color0 < color1)
+		{
+			std::swap(color0, color1);
+			std::swap(start, end);
+		}
+
+		ExpandRgb565(color0, palette[0]);
+		ExpandRgb565(color1, palette[1]);
+
+		for(uint32_t channel = 0; channel < 3; ++channel)
+		{
+			palette[2][channel] = ((2.0f * palette[0][channel]) + palette[1][channel]) * (1.0f / 3.0f);
+			palette[3][channel] = (palette[0][channel] + (2.0f * palette[1][channel])) * (1.0f / 3.0f);
+		}
+
+		if(color0 == color1)
+		{
+			// Solid color; this decodes the same in either mode.
+			memset(indices, 0, sizeof(indices));
+		}
+		else
+		{
+			SelectIndices(block, 3, quality, start, end, palette, 4, levelToIndex, indices);
+		}
+
+		const float error = MeasureError(block, 3, palette, indices);
+
+		if(error < bestError)
+		{
+			bestError = error;
+
+			uint32_t indexBits = 0;
+
+			for(uint32_t texel = 0; texel < 16; ++texel)
+			{
+				indexBits |= uint32_t(indices[texel]) << (texel * 2);
+			}
+
+			memcpy(bestOutput, &color0, 2);
+			memcpy(bestOutput + 2, &color1, 2);
+			memcpy(bestOutput + 4, &indexBits, 4);
+		}
+
+		if(pass + 1 < passCount && color0 != color1)
+		{
+			float texelWeights[16];
+
+			for(uint32_t texel = 0; texel < 16; ++texel)
+			{
+				texelWeights[texel] = indexWeights[indices[texel]];
+			}
+
+			RefineEndpoints(block, 3, texelWeights, start, end);
+		}
+	}
+
+	memcpy(pOutput, bestOutput, sizeof(bestOutput));
+
+	return bestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BC4 / BC5 / BC3 alpha
+//---------------------------------------------------------------------------------------------------------------------
+
+static float EncodeSingleChannelBlock(
+	const Block& block,
+	const uint32_t channel,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	uint8_t* const pOutput)
+{
+	using Quality = DemoFramework::Utility::BlockCompressor::Quality;
+
+	const float* const pValues = block.channels[channel];
+
+	float minValue = pValues[0];
+	float maxValue = pValues[0];
+
+	for(uint32_t texel = 1; texel < 16; ++texel)
+	{
+		minValue = std::min(minValue, pValues[texel]);
+		maxValue = std::max(maxValue, pValues[texel]);
+	}
+
+	const int32_t baseMax = int32_t(std::min(maxValue + 0.5f, 255.0f));
+	const int32_t baseMin = int32_t(std::max(minValue + 0.5f, 0.0f));
+
+	// Pulling the endpoints in slightly often lowers the error of the texels in between more
+	// than it raises the error of the extremes, so the quality preset tries a few options.
+	const int32_t searchRange = (quality == Quality::Quality) ? 2 : 0;
+
+	float bestError = FLT_MAX;
+	uint64_t bestBits = 0;
+
+	for(int32_t maxOffset = 0; maxOffset <= searchRange; ++maxOffset)
+	{
+		for(int32_t minOffset = 0; minOffset <= searchRange; ++minOffset)
+		{
+			const int32_t endpoint0 = baseMax - maxOffset;
+			const int32_t endpoint1 = baseMin + minOffset;
+
+			if(endpoint0 < endpoint1 || (endpoint0 == endpoint1 && (maxOffset + minOffset) > 0))
+			{
+				continue;
+			}
+
+			// With endpoint 0 above endpoint 1, the block uses 6 interpolated values between them. Index 0 is
+			// endpoint 0, index 1 is endpoint 1, and indices 2-7 step from endpoint 0 toward endpoint 1.
+			float palette[8];
+			palette[0] = float(endpoint0);
+			palette[1] = float(endpoint1);
+
+			for(uint32_t index = 2; index < 8; ++index)
+			{
+				palette[index] = float((((8 - index) * endpoint0) + ((index - 1) * endpoint1)) / 7);
+			}
+
+			const float range = float(endpoint0 - endpoint1);
+			const float scale = (range > 0.0f) ? (7.0f / range) : 0.0f;
+
+			float error = 0.0f;
+			uint64_t indexBits = 0;
+
+			for(uint32_t texel = 0; texel < 16; ++texel)
+			{
+				// The palette is one dimensional, so the nearest entry is always one of the two around the projection.
+				const float level = std::min(std::max((float(endpoint0) - pValues[texel]) * scale, 0.0f), 7.0f);
+				const uint32_t lowerLevel = uint32_t(level);
+				const uint32_t upperLevel = std::min(lowerLevel + 1, 7u);
+
+				const uint32_t lowerIndex = (lowerLevel == 0) ? 0 : ((lowerLevel == 7) ? 1 : lowerLevel + 1);
+				const uint32_t upperIndex = (upperLevel == 0) ? 0 : ((upperLevel == 7) ? 1 : upperLevel + 1);
+
+				const float lowerError = fabsf(pValues[texel] - palette[lowerIndex]);
+				const float upperError = fabsf(pValues[texel] - palette[upperIndex]);
+
+				const uint32_t index = (upperError < lowerError) ? upperIndex : lowerIndex;
+				const float delta = std::min(lowerError, upperError);
+
+				if(block.validMask & (1u << texel))
+				{
+					error += delta * delta;
+				}
+
+				indexBits |= uint64_t(index) << (texel * 3);
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+				bestBits = uint64_t(endpoint0) | (uint64_t(endpoint1) << 8) | (indexBits << 16);
+			}
+		}
+	}
+
+	memcpy(pOutput, &bestBits, 8);
+
+	return bestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BC7 (mode 6)
+//---------------------------------------------------------------------------------------------------------------------
+
+static void BuildBc7Palette(const int32_t* const pEndpoint0, const int32_t* const pEndpoint1, float (* const pOutPalette)[4])
+{
+	for(uint32_t index = 0; index < 16; ++index)
+	{
+		for(uint32_t channel = 0; channel < 4; ++channel)
+		{
+			pOutPalette[index][channel] = float(((pEndpoint0[channel] * (64 - Weights4[index])) + (pEndpoint1[channel] * Weights4[index]) + 32) >> 6);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void QuantizeBc7Endpoint(const float* const pEndpoint, const uint32_t pBit, int32_t* const pOutValues, int32_t* const pOutBits)
+{
+	// Mode 6 stores 7 bits per channel, with a shared p-bit appended as the lowest bit.
+	for(uint32_t channel = 0; channel < 4; ++channel)
+	{
+		const int32_t bits = int32_t(std::min(std::max(((pEndpoint[channel] - float(pBit)) * 0.5f) + 0.5f, 0.0f), 127.0f));
+
+		pOutBits[channel] = bits;
+		pOutValues[channel] = (bits << 1) | int32_t(pBit);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float EncodeBc7Block(
+	const Block& block,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	uint8_t* const pOutput)
+{
+	using Quality = DemoFramework::Utility::BlockCompressor::Quality;
+
+	float start[4];
+	float end[4];
+
+	FitPrincipalAxis(block, 4, start, end);
+
+	const bool highQuality = (quality == Quality::Quality);
+	const uint32_t passCount = highQuality ? (1 + DF_BLOCK_COMPRESSOR_REFINE_ITERATIONS) : 1;
+
+	float bestError = FLT_MAX;
+
+	int32_t bestBits0[4] = {};
+	int32_t bestBits1[4] = {};
+	uint32_t bestPBits[2] = {};
+	uint8_t bestIndices[16] = {};
+
+	for(uint32_t pass = 0; pass < passCount; ++pass)
+	{
+		uint8_t passIndices[16] = {};
+		float passError = FLT_MAX;
+
+		// The quality preset tries every p-bit combination. The fast preset picks the p-bit matching the parity
+		// that each endpoint's channels round to most often.
+		uint32_t fastPBits = 0;
+
+		if(!highQuality)
+		{
+			float parity0 = 0.0f;
+			float parity1 = 0.0f;
+
+			for(uint32_t channel = 0; channel < 4; ++channel)
+			{
+				parity0 += float(int32_t(start[channel] + 0.5f) & 1);
+				parity1 += float(int32_t(end[channel] + 0.5f) & 1);
+			}
+
+			fastPBits = ((parity0 > 2.0f) ? 1 : 0) | ((parity1 > 2.0f) ? 2 : 0);
+		}
+
+		const uint32_t pBitComboCount = highQuality ? 4 : 1;
+
+		for(uint32_t pBitCombo = 0; pBitCombo < pBitComboCount; ++pBitCombo)
+		{
+			const uint32_t pBits = highQuality ? pBitCombo : fastPBits;
+			const uint32_t pBit0 = pBits & 1;
+			const uint32_t pBit1 = pBits >> 1;
+
+			int32_t endpoint0[4];
+			int32_t endpoint1[4];
+			int32_t bits0[4];
+			int32_t bits1[4];
+
+			QuantizeBc7Endpoint(start, pBit0, endpoint0, bits0);
+			QuantizeBc7Endpoint(end, pBit1, endpoint1, bits1);
+
+			float palette[16][4];
+			BuildBc7Palette(endpoint0, endpoint1, palette);
+
+			uint8_t indices[16];
+			SelectIndices(block, 4, quality, start, end, palette, 16, nullptr, indices);
+
+			const float error = MeasureError(block, 4, palette, indices);
+
+			if(error < passError)
+			{
+				passError = error;
+				memcpy(passIndices, indices, sizeof(indices));
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+
+				memcpy(bestBits0, bits0, sizeof(bits0));
+				memcpy(bestBits1, bits1, sizeof(bits1));
+				memcpy(bestIndices, indices, sizeof(indices));
+
+				bestPBits[0] = pBit0;
+				bestPBits[1] = pBit1;
+			}
+		}
+
+		if(pass + 1 < passCount)
+		{
+			float texelWeights[16];
+
+			for(uint32_t texel = 0; texel < 16; ++texel)
+			{
+				texelWeights[texel] = float(Weights4[passIndices[texel]]) * (1.0f / 64.0f);
+			}
+
+			RefineEndpoints(block, 4, texelWeights, start, end);
+		}
+	}
+
+	// The first texel's index is stored with its top bit implied to be zero, so flip the endpoints if necessary.
+	if(bestIndices[0] & 0x8)
+	{
+		std::swap(bestBits0, bestBits1);
+		std::swap(bestPBits[0], bestPBits[1]);
+
+		for(uint32_t texel = 0; texel < 16; ++texel)
+		{
+			bestIndices[texel] = uint8_t(15 - bestIndices[texel]);
+		}
+	}
+
+	BlockBits bits = {};
+
+	bits.Write(1 << 6, 7);
+
+	for(uint32_t channel = 0; channel < 4; ++channel)
+	{
+		bits.Write(uint64_t(bestBits0[channel]), 7);
+		bits.Write(uint64_t(bestBits1[channel]), 7);
+	}
+
+	bits.Write(bestPBits[0], 1);
+	bits.Write(bestPBits[1], 1);
+
+	bits.Write(bestIndices[0], 3);
+
+	for(uint32_t texel = 1; texel < 16; ++texel)
+	{
+		bits.Write(bestIndices[texel], 4);
+	}
+
+	memcpy(pOutput, bits.words, 16);
+
+	return bestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// BC6H (mode 11, unsigned)
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t FloatToUnsignedHalf(const float value)
+{
+	// BC6H UF16 can't represent negative values, infinities or NaNs, so those all get clamped into range.
+	if(!(value > 0.0f))
+	{
+		return 0;
+	}
+
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	const int32_t exponent = int32_t((bits >> 23) & 0xFF) - 127 + 15;
+
+	if(exponent >= 31)
+	{
+		return DF_BLOCK_COMPRESSOR_MAX_HALF;
+	}
+
+	if(exponent <= 0)
+	{
+		// Denormal half; shift the implicit leading one into the mantissa.
+		if(exponent < -10)
+		{
+			return 0;
+		}
+
+		const uint32_t mantissa = (bits & 0x7FFFFF) | 0x800000;
+		const uint32_t shift = uint32_t(14 - exponent);
+
+		return (mantissa + (1u << (shift - 1))) >> shift;
+	}
+
+	// Round to nearest; a carry out of the mantissa correctly bumps the exponent.
+	const uint32_t half = (uint32_t(exponent) << 10) | ((bits >> 13) & 0x3FF);
+	const uint32_t rounded = half + ((bits >> 12) & 1);
+
+	return std::min(rounded, uint32_t(DF_BLOCK_COMPRESSOR_MAX_HALF));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float UnsignedHalfToFloat(const uint32_t half)
+{
+	const uint32_t exponent = (half >> 10) & 0x1F;
+	const uint32_t mantissa = half & 0x3FF;
+
+	if(exponent == 0)
+	{
+		return float(mantissa) * (1.0f / 16777216.0f);
+	}
+
+	const uint32_t bits = ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+	float output;
+	memcpy(&output, &bits, sizeof(output));
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static int32_t UnquantizeBc6hEndpoint(const int32_t value)
+{
+	// Expansion of a 10-bit unsigned endpoint to 16 bits, as done by the decoder.
+	if(value == 0)
+	{
+		return 0;
+	}
+
+	if(value == 1023)
+	{
+		return 0xFFFF;
+	}
+
+	return ((value << 16) + 0x8000) >> 10;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float EncodeBc6hBlock(
+	const Block& block,
+	const DemoFramework::Utility::BlockCompressor::Quality quality,
+	uint8_t* const pOutput)
+{
+	using Quality = DemoFramework::Utility::BlockCompressor::Quality;
+
+	// BC6H interpolates the bit patterns of the half floats rather than their values, so fitting happens on the
+	// 16-bit scale the decoder interpolates on (the decoder multiplies by 31/64 afterward to get the half).
+	Block scaled;
+	scaled.validMask = block.validMask;
+
+	for(uint32_t channel = 0; channel < 3; ++channel)
+	{
+		for(uint32_t texel = 0; texel < 16; ++texel)
+		{
+			scaled.channels[channel][texel] = float(FloatToUnsignedHalf(block.channels[channel][texel])) * (64.0f / 31.0f);
+		}
+	}
+
+	float start[4];
+	float end[4];
+
+	FitPrincipalAxis(scaled, 3, start, end);
+
+	const uint32_t passCount = (quality == Quality::Quality) ? (1 + DF_BLOCK_COMPRESSOR_REFINE_ITERATIONS) : 1;
+
+	float bestScaledError = FLT_MAX;
+
+	int32_t bestEndpoint0[3] = {};
+	int32_t bestEndpoint1[3] = {};
+	uint8_t bestIndices[16] = {};
+
+	for(uint32_t pass = 0; pass < passCount; ++pass)
+	{
+		int32_t endpoint0[3];
+		int32_t endpoint1[3];
+		int32_t unquantized0[3];
+		int32_t unquantized1[3];
+
+		for(uint32_t channel = 0; channel < 3; ++channel)
+		{
+			endpoint0[channel] = int32_t(std::min(std::max(((start[channel] - 32.0f) / 64.0f) + 0.5f, 0.0f), 1023.0f));
+			endpoint1[channel] = int32_t(std::min(std::max(((end[channel] - 32.0f) / 64.0f) + 0.5f, 0.0f), 1023.0f));
+
+			unquantized0[channel] = UnquantizeBc6hEndpoint(endpoint0[channel]);
+			unquantized1[channel] = UnquantizeBc6hEndpoint(endpoint1[channel]);
+		}
+
+		float palette[16][4] = {};
+
+		for(uint32_t index = 0; index < 16; ++index)
+		{
+			for(uint32_t channel = 0; channel < 3; ++channel)
+			{
+				palette[index][channel] = float(((unquantized0[channel] * (64 - Weights4[index])) + (unquantized1[channel] * Weights4[index]) + 32) >> 6);
+			}
+		}
+
+		uint8_t indices[16];
+		SelectIndices(scaled, 3, quality, start, end, palette, 16, nullptr, indices);
+
+		const float error = MeasureError(scaled, 3, palette, indices);
+
+		if(error < bestScaledError)
+		{
+			bestScaledError = error;
+
+			memcpy(bestEndpoint0, endpoint0, sizeof(endpoint0));
+			memcpy(bestEndpoint1, endpoint1, sizeof(endpoint1));
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		if(pass + 1 < passCount)
+		{
+			float texelWeights[16];
+
+			for(uint32_t texel = 0; texel < 16; ++texel)
+			{
+				texelWeights[texel] = float(Weights4[indices[texel]]) * (1.0f / 64.0f);
+			}
+
+			RefineEndpoints(scaled, 3, texelWeights, start, end);
+		}
+	}
+
+	// Measure the final error on the linear values the shaders will actually see.
+	float error = 0.0f;
+
+	for(uint32_t texel = 0; texel < 16; ++texel)
+	{
+		if((block.validMask & (1u << texel)) == 0)
+		{
+			continue;
+		}
+
+		const int32_t weight = Weights4[bestIndices[texel]];
+
+		for(uint32_t channel = 0; channel < 3; ++channel)
+		{
+			const int32_t unquantized0 = UnquantizeBc6hEndpoint(bestEndpoint0[channel]);
+			const int32_t unquantized1 = UnquantizeBc6hEndpoint(bestEndpoint1[channel]);
+			const int32_t interpolated = ((unquantized0 * (64 - weight)) + (unquantized1 * weight) + 32) >> 6;
+
+			const float decoded = UnsignedHalfToFloat(uint32_t((interpolated * 31) >> 6));
+			const float delta = decoded - std::max(block.channels[channel][texel], 0.0f);
+
+			error += delta * delta;
+		}
+	}
+
+	// The first texel's index is stored with its top bit implied to be zero, so flip the endpoints if necessary.
+	if(bestIndices[0] & 0x8)
+	{
+		std::swap(bestEndpoint0, bestEndpoint1);
+
+		for(uint32_t texel = 0; texel < 16; ++texel)
+		{
+			bestIndices[texel] = uint8_t(15 - bestIndices[texel]);
+		}
+	}
+
+	BlockBits bits = {};
+
+	bits.Write(0x03, 5);
+
+	for(uint32_t channel = 0; channel < 3; ++channel)
+	{
+		bits.Write(uint64_t(bestEndpoint0[channel]), 10);
+	}
+
+	for(uint32_t channel = 0; channel < 3; ++channel)
+	{
+		bits.Write(uint64_t(bestEndpoint1[channel]), 10);
+	}
+
+	bits.Write(bestIndices[0], 3);
+
+	for(uint32_t texel = 1; texel < 16; ++texel)
+	{
+		bits.Write(bestIndices[texel], 4);
+	}
+
+	memcpy(pOutput, bits.words, 16);
+
+	return error;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void LoadBlock(
+	const DemoFramework::Utility::ImageResampler::ConstImage& src,
+	const DemoFramework::Utility::ImageResampler::Format sourceFormat,
+	const uint32_t blockX,
+	const uint32_t blockY,
+	Block& outBlock)
+{
+	using Format = DemoFramework::Utility::ImageResampler::Format;
+
+	const uint32_t channelCount = DemoFramework::Utility::ImageResampler::GetChannelCount(sourceFormat);
+	const bool isFloat = (sourceFormat == Format::RGBA32Float);
+
+	outBlock.validMask = 0;
+
+	for(uint32_t y = 0; y < 4; ++y)
+	{
+		const uint32_t srcY = (blockY * 4) + y;
+		const uint8_t* const pRow = src.pData + (size_t(std::min(srcY, src.height - 1)) * src.rowPitch);
+
+		for(uint32_t x = 0; x < 4; ++x)
+		{
+			const uint32_t srcX = (blockX * 4) + x;
+			const uint32_t texel = (y * 4) + x;
+
+			if(srcX < src.width && srcY < src.height)
+			{
+				outBlock.validMask |= 1u << texel;
+			}
+
+			// Texels outside of the image repeat the last column and row.
+			const size_t column = size_t(std::min(srcX, src.width - 1));
+
+			for(uint32_t channel = 0; channel < 4; ++channel)
+			{
+				if(channel >= channelCount)
+				{
+					outBlock.channels[channel][texel] = 0.0f;
+				}
+				else if(isFloat)
+				{
+					outBlock.channels[channel][texel] = reinterpret_cast<const float*>(pRow)[(column * channelCount) + channel];
+				}
+				else
+				{
+					outBlock.channels[channel][texel] = float(pRow[(column * channelCount) + channel]);
+				}
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::BlockCompressor::Compress(
+	const ImageResampler::ConstImage& src,
+	const Format format,
+	const Quality quality,
+	uint8_t* const pDst,
+	const size_t dstRowPitch,
+	ThreadPool* const pThreadPool,
+	Stats* const pOutStats)
+{
+	if(!src.pData || !pDst || src.width == 0 || src.height == 0)
+	{
+		return false;
+	}
+
+	const ImageResampler::Format sourceFormat = GetSourceFormat(format);
+	const uint32_t blockSize = GetBlockSize(format);
+
+	const uint32_t blockCountX = (src.width + 3) / 4;
+	const uint32_t blockCountY = (src.height + 3) / 4;
+
+	if(dstRowPitch < size_t(blockCountX) * blockSize)
+	{
+		return false;
+	}
+
+	std::vector<double> rowErrors(blockCountY, 0.0);
+
+	auto encodeBlockRow = [&](const size_t blockY)
+	{
+		uint8_t* const pDstRow = pDst + (blockY * dstRowPitch);
+
+		double rowError = 0.0;
+
+		for(uint32_t blockX = 0; blockX < blockCountX; ++blockX)
+		{
+			Block block;
+			LoadBlock(src, sourceFormat, blockX, uint32_t(blockY), block);
+
+			uint8_t* const pOutput = pDstRow + (size_t(blockX) * blockSize);
+
+			switch(format)
+			{
+				case Format::BC1:
+					rowError += EncodeColorBlock(block, quality, pOutput);
+					break;
+
+				case Format::BC3:
+					rowError += EncodeSingleChannelBlock(block, 3, quality, pOutput);
+					rowError += EncodeColorBlock(block, quality, pOutput + 8);
+					break;
+
+				case Format::BC4:
+					rowError += EncodeSingleChannelBlock(block, 0, quality, pOutput);
+					break;
+
+				case Format::BC5:
+					rowError += EncodeSingleChannelBlock(block, 0, quality, pOutput);
+					rowError += EncodeSingleChannelBlock(block, 1, quality, pOutput + 8);
+					break;
+
+				case Format::BC6H:
+					rowError += EncodeBc6hBlock(block, quality, pOutput);
+					break;
+
+				case Format::BC7:
+					rowError += EncodeBc7Block(block, quality, pOutput);
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		rowErrors[blockY] = rowError;
+	};
+
+	if(pThreadPool)
+	{
+		pThreadPool->ParallelFor(blockCountY, encodeBlockRow);
+	}
+	else
+	{
+		for(uint32_t blockY = 0; blockY < blockCountY; ++blockY)
+		{
+			encodeBlockRow(blockY);
+		}
+	}
+
+	if(pOutStats)
+	{
+		uint32_t measuredChannelCount = 0;
+
+		switch(format)
+		{
+			case Format::BC1:  measuredChannelCount = 3; break;
+			case Format::BC3:  measuredChannelCount = 4; break;
+			case Format::BC4:  measuredChannelCount = 1; break;
+			case Format::BC5:  measuredChannelCount = 2; break;
+			case Format::BC6H: measuredChannelCount = 3; break;
+			case Format::BC7:  measuredChannelCount = 4; break;
+
+			default:
+				break;
+		}
+
+		pOutStats->squaredError = 0.0;
+		pOutStats->sampleCount = uint64_t(src.width) * uint64_t(src.height) * measuredChannelCount;
+
+		for(const double rowError : rowErrors)
+		{
+			pOutStats->squaredError += rowError;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
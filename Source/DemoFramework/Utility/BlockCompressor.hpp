@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ImageResampler.hpp"
+
+#include <math.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class BlockCompressor;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// CPU block-compression encoder. Each 4x4 block gets a single line segment fit through its texels, and every texel
+// is assigned the closest point on that segment that the format can represent. Rows of blocks are encoded in
+// parallel on a thread pool, and the index search uses AVX2 kernels when the CPU supports them.
+//
+// Only the single-subset modes of BC6H (mode 11) and BC7 (mode 6) are used. They are the modes best suited to smooth
+// image content and keep encoding fast enough to do at load time, at the cost of some quality on blocks with sharp
+// edges between different colors.
+class DF_API DemoFramework::Utility::BlockCompressor
+{
+public:
+
+	enum class Format
+	{
+		BC1,  // RGB, 4 bits per texel
+		BC3,  // RGBA, 8 bits per texel
+		BC4,  // R, 4 bits per texel
+		BC5,  // RG, 8 bits per texel
+		BC6H, // Unsigned half float RGB, 8 bits per texel
+		BC7,  // RGBA, 8 bits per texel
+	};
+
+	enum class Quality
+	{
+		Fast,    // Principal axis fit; texels are projected onto the axis to pick their indices
+		Quality, // Adds exhaustive index search, least squares endpoint refinement and endpoint rounding search
+	};
+
+	struct Stats
+	{
+		double squaredError;  // Sum of squared errors over every channel of every texel
+		uint64_t sampleCount; // Number of channel values the error was measured over
+
+		double GetMeanSquaredError() const;
+
+		// Peak signal-to-noise ratio in decibels. The peak value is 255 for unorm formats and 1.0 for BC6H.
+		double GetPsnr(Format format) const;
+	};
+
+	BlockCompressor() = delete;
+	BlockCompressor(const BlockCompressor&) = delete;
+	BlockCompressor(BlockCompressor&&) = delete;
+
+	// Bytes per 4x4 block.
+	static uint32_t GetBlockSize(Format format);
+
+	// Format of the uncompressed source data expected by Compress(): RGBA8 for BC1, BC3 and BC7, R8 for BC4,
+	// RG8 for BC5 and RGBA32 float for BC6H.
+	static ImageResampler::Format GetSourceFormat(Format format);
+
+	// Compress the source image into rows of blocks starting at 'pDst'. Blocks along the right and bottom edges of
+	// images that aren't a multiple of 4 in size are padded by repeating the last column and row. A null thread pool
+	// runs everything on the calling thread.
+	static bool Compress(
+		const ImageResampler::ConstImage& src,
+		Format format,
+		Quality quality,
+		uint8_t* pDst,
+		size_t dstRowPitch,
+		ThreadPool* pThreadPool,
+		Stats* pOutStats = nullptr);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::BlockCompressor::GetBlockSize(const Format format)
+{
+	return (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::ImageResampler::Format DemoFramework::Utility::BlockCompressor::GetSourceFormat(const Format format)
+{
+	switch(format)
+	{
+		case Format::BC4:  return ImageResampler::Format::R8Unorm;
+		case Format::BC5:  return ImageResampler::Format::RG8Unorm;
+		case Format::BC6H: return ImageResampler::Format::RGBA32Float;
+
+		default:
+			break;
+	}
+
+	return ImageResampler::Format::RGBA8Unorm;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline double DemoFramework::Utility::BlockCompressor::Stats::GetMeanSquaredError() const
+{
+	return (sampleCount > 0) ? (squaredError / double(sampleCount)) : 0.0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline double DemoFramework::Utility::BlockCompressor::Stats::GetPsnr(const Format format) const
+{
+	const double meanSquaredError = GetMeanSquaredError();
+	const double peak = (format == Format::BC6H) ? 1.0 : 255.0;
+
+	if(meanSquaredError <= 0.0)
+	{
+		// Lossless, which is as good as infinite, but something finite is easier to log.
+		return 99.0;
+	}
+
+	return 10.0 * log10((peak * peak) / meanSquaredError);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "CpuFeatures.hpp"
+
+#include <intrin.h>
+
+#include <atomic>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static std::atomic<bool> s_baselineOnly(false);
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::CpuFeatures::HasAvx2()
+{
+	return _getFlags().avx2 && !s_baselineOnly.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::CpuFeatures::HasF16c()
+{
+	return _getFlags().f16c && !s_baselineOnly.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::CpuFeatures::SetBaselineOnly(const bool baselineOnly)
+{
+	s_baselineOnly.store(baselineOnly, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::CpuFeatures::IsBaselineOnly()
+{
+	return s_baselineOnly.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::Utility::CpuFeatures::Flags& DemoFramework::Utility::CpuFeatures::_getFlags()
+{
+	static const Flags flags = []() -> Flags
+	{
+		Flags output = { false, false };
+
+		int32_t cpuInfo[4] = {};
+
+		__cpuid(cpuInfo, 0);
+		const int32_t maxLeaf = cpuInfo[0];
+
+		if(maxLeaf < 1)
+		{
+			return output;
+		}
+
+		__cpuid(cpuInfo, 1);
+
+		const bool hasFma = (cpuInfo[2] & (1 << 12)) != 0;
+		const bool hasOsXsave = (cpuInfo[2] & (1 << 27)) != 0;
+		const bool hasAvx = (cpuInfo[2] & (1 << 28)) != 0;
+		const bool hasF16c = (cpuInfo[2] & (1 << 29)) != 0;
+
+		// The OS must also be saving the AVX register state on context switches.
+		const bool osSupportsAvx = hasOsXsave && ((_xgetbv(0) & 0x6) == 0x6);
+
+		if(!hasAvx || !osSupportsAvx)
+		{
+			return output;
+		}
+
+		output.f16c = hasF16c;
+
+		if(maxLeaf >= 7)
+		{
+			__cpuidex(cpuInfo, 7, 0);
+
+			const bool hasAvx2 = (cpuInfo[1] & (1 << 5)) != 0;
+
+			output.avx2 = hasAvx2 && hasFma;
+		}
+
+		return output;
+	}();
+
+	return flags;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class CpuFeatures;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Runtime detection of optional instruction set extensions. Code paths using any of these extensions must be selected
+// by checking the matching query first since the framework itself is built for the baseline x64 instruction set.
+class DF_API DemoFramework::Utility::CpuFeatures
+{
+public:
+
+	CpuFeatures() = delete;
+	CpuFeatures(const CpuFeatures&) = delete;
+	CpuFeatures(CpuFeatures&&) = delete;
+
+	// AVX2 along with the FMA3 instructions that ship on every CPU supporting it.
+	static bool HasAvx2();
+
+	// F16C half-precision conversion instructions.
+	static bool HasF16c();
+
+	// Make every query report its extension as missing so callers take their baseline code paths. This is meant for
+	// tests and benchmarks comparing the two paths; code that caches the result of a query won't see the change.
+	static void SetBaselineOnly(bool baselineOnly);
+	static bool IsBaselineOnly();
+
+
+private:
+
+	struct Flags
+	{
+		bool avx2;
+		bool f16c;
+	};
+
+	static const Flags& _getFlags();
+};
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,642 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "CubeMapConverter.hpp"
+#include "CpuFeatures.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fusing a multiply and an add changes the rounding, and the direction math, equirect fetch and downsampling would
+// then give different bits depending on which of them the compiler chose to fuse in each path. GCC and clang do this
+// by default whenever FMA is enabled, so turn it off for this file. MSVC doesn't under /fp:precise.
+#if defined(__clang__)
+	#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cube texels are converted a block at a time, one texel per AVX2 lane.
+#define DF_CUBE_MAP_CONVERTER_BLOCK_SIZE 8
+
+// Source texels touched along one axis by a texel of the next mip down. Levels are at most 3 times smaller than the
+// level above (3 -> 1), and a span of 3 texels can straddle 4 of them when it does not start on a texel boundary.
+#define DF_CUBE_MAP_CONVERTER_MAX_TAP_COUNT 4
+
+// Minimum number of texels handed to each thread pool task.
+#define DF_CUBE_MAP_CONVERTER_TASK_TEXEL_COUNT 16384
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr float32_t Pi = 3.1415926535897932384626433832795f;
+static constexpr float32_t HalfPi = 1.5707963267948966192313216916398f;
+static constexpr float32_t TwoPi = 6.283185307179586476925286766559f;
+static constexpr float32_t InvPi = 0.31830988618379067153776752674503f;
+static constexpr float32_t InvTwoPi = 0.15915494309189533576888376337251f;
+
+// Coefficients of the odd polynomial approximating atan(t) on [0, 1] from Abramowitz and Stegun 4.4.49, which is
+// accurate to 2e-8 radians. Larger arguments are folded into this range through atan(t) = pi/2 - atan(1/t).
+static constexpr float32_t AtanCoeffs[] =
+{
+	0.0028662257f,
+	-0.0161657367f,
+	0.0429096138f,
+	-0.0752896400f,
+	0.1065626393f,
+	-0.1420889944f,
+	0.1999355085f,
+	-0.3333314528f,
+	1.0f,
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Direction of the texels of a row of a cube face, as 'direction = (axisU * u) + rowOffset' before normalization,
+// where u is the horizontal face coordinate in [-1, 1]. This is the vector CalculateNormalFromPixelCoord() in the
+// reflection probe shaders builds before normalizing it, and since atan2() does not care about the length of its
+// arguments, it never needs to be normalized.
+struct FaceRow
+{
+	float32_t axisU[3];
+	float32_t rowOffset[3];
+};
+
+// Texels of a level that a texel of the next mip down covers along one axis, along with how much of each is covered.
+struct AxisTaps
+{
+	uint32_t first;
+	uint32_t count;
+	float32_t weight[DF_CUBE_MAP_CONVERTER_MAX_TAP_COUNT];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline float32_t GetFaceCoord(const uint32_t coord, const float32_t invEdgeLength)
+{
+	return (((float32_t(coord) + 0.5f) * invEdgeLength) * 2.0f) - 1.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static FaceRow GetFaceRow(const uint32_t y, const uint32_t faceIndex, const float32_t invEdgeLength)
+{
+	// Face direction, then the directions u and v move along. The texture coordinates increase downward while the Y axis
+	// increases upward, so v is flipped along the vertical axis of the side faces.
+	static constexpr float32_t faceAxes[DF_CUBE_MAP_FACE_COUNT][3][3] =
+	{
+		{ {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, -1.0f,  0.0f } }, // +X
+		{ { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, -1.0f,  0.0f } }, // -X
+		{ {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f,  0.0f,  1.0f } }, // +Y
+		{ {  0.0f, -1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f,  0.0f, -1.0f } }, // -Y
+		{ {  0.0f,  0.0f,  1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f } }, // +Z
+		{ {  0.0f,  0.0f, -1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f } }, // -Z
+	};
+
+	const float32_t v = GetFaceCoord(y, invEdgeLength);
+
+	FaceRow output;
+
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		output.axisU[i] = faceAxes[faceIndex][1][i];
+		output.rowOffset[i] = faceAxes[faceIndex][0][i] + (faceAxes[faceIndex][2][i] * v);
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline float32_t AtanScalar(const float32_t y, const float32_t x)
+{
+	const float32_t absX = fabsf(x);
+	const float32_t absY = fabsf(y);
+	const float32_t maxValue = (absX > absY) ? absX : absY;
+	const float32_t minValue = (absX > absY) ? absY : absX;
+	const float32_t t = (maxValue > 0.0f) ? (minValue / maxValue) : 0.0f;
+	const float32_t tSquared = t * t;
+
+	float32_t poly = AtanCoeffs[0];
+
+	for(size_t i = 1; i < sizeof(AtanCoeffs) / sizeof(AtanCoeffs[0]); ++i)
+	{
+		poly = (poly * tSquared) + AtanCoeffs[i];
+	}
+
+	float32_t output = poly * t;
+
+	if(absY > absX)
+	{
+		output = HalfPi - output;
+	}
+
+	if(x < 0.0f)
+	{
+		output = Pi - output;
+	}
+
+	return copysignf(output, y);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline __m256 AtanAvx2(const __m256 y, const __m256 x)
+{
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	const __m256 zero = _mm256_setzero_ps();
+
+	const __m256 absX = _mm256_andnot_ps(signMask, x);
+	const __m256 absY = _mm256_andnot_ps(signMask, y);
+	const __m256 yIsLarger = _mm256_cmp_ps(absY, absX, _CMP_GT_OQ);
+	const __m256 maxValue = _mm256_blendv_ps(absX, absY, yIsLarger);
+	const __m256 minValue = _mm256_blendv_ps(absY, absX, yIsLarger);
+	const __m256 t = _mm256_and_ps(_mm256_div_ps(minValue, maxValue), _mm256_cmp_ps(maxValue, zero, _CMP_GT_OQ));
+	const __m256 tSquared = _mm256_mul_ps(t, t);
+
+	__m256 poly = _mm256_set1_ps(AtanCoeffs[0]);
+
+	for(size_t i = 1; i < sizeof(AtanCoeffs) / sizeof(AtanCoeffs[0]); ++i)
+	{
+		poly = _mm256_add_ps(_mm256_mul_ps(poly, tSquared), _mm256_set1_ps(AtanCoeffs[i]));
+	}
+
+	__m256 output = _mm256_mul_ps(poly, t);
+
+	output = _mm256_blendv_ps(output, _mm256_sub_ps(_mm256_set1_ps(HalfPi), output), yIsLarger);
+	output = _mm256_blendv_ps(output, _mm256_sub_ps(_mm256_set1_ps(Pi), output), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+
+	return _mm256_or_ps(output, _mm256_and_ps(y, signMask));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Bilinear fetch of an RGBA32Float equirect at texel coordinate (x0 + fracX, y0 + fracY). The equirect wraps around
+// horizontally and is clamped vertically, so texels at the poles are not blended with the opposite pole.
+static inline void FetchBilinear(
+	const DemoFramework::Utility::ImageResampler::ConstImage& equirect,
+	const int32_t x0,
+	const int32_t y0,
+	const float32_t fracX,
+	const float32_t fracY,
+	float32_t* const pOutTexel)
+{
+	const int32_t width = int32_t(equirect.width);
+	const int32_t lastRow = int32_t(equirect.height) - 1;
+
+	const int32_t left = (x0 < 0) ? (x0 + width) : ((x0 >= width) ? (x0 - width) : x0);
+	const int32_t right = (left + 1 < width) ? (left + 1) : 0;
+	const int32_t top = (y0 < 0) ? 0 : ((y0 > lastRow) ? lastRow : y0);
+	const int32_t bottom = (y0 + 1 < 0) ? 0 : ((y0 + 1 > lastRow) ? lastRow : (y0 + 1));
+
+	const float32_t* const pTopRow = reinterpret_cast<const float32_t*>(equirect.pData + (equirect.rowPitch * size_t(top)));
+	const float32_t* const pBottomRow = reinterpret_cast<const float32_t*>(equirect.pData + (equirect.rowPitch * size_t(bottom)));
+
+	const float32_t invFracX = 1.0f - fracX;
+	const float32_t invFracY = 1.0f - fracY;
+
+	const __m128 topLeft = _mm_mul_ps(_mm_loadu_ps(pTopRow + (size_t(left) * 4)), _mm_set1_ps(invFracX * invFracY));
+	const __m128 topRight = _mm_mul_ps(_mm_loadu_ps(pTopRow + (size_t(right) * 4)), _mm_set1_ps(fracX * invFracY));
+	const __m128 bottomLeft = _mm_mul_ps(_mm_loadu_ps(pBottomRow + (size_t(left) * 4)), _mm_set1_ps(invFracX * fracY));
+	const __m128 bottomRight = _mm_mul_ps(_mm_loadu_ps(pBottomRow + (size_t(right) * 4)), _mm_set1_ps(fracX * fracY));
+
+	_mm_storeu_ps(pOutTexel, _mm_add_ps(_mm_add_ps(_mm_add_ps(topLeft, topRight), bottomLeft), bottomRight));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertRowScalar(
+	const DemoFramework::Utility::ImageResampler::ConstImage& equirect,
+	const FaceRow& row,
+	const uint32_t edgeLength,
+	const float32_t invEdgeLength,
+	float32_t* const pOutRow)
+{
+	const float32_t width = float32_t(equirect.width);
+	const float32_t height = float32_t(equirect.height);
+
+	for(uint32_t x = 0; x < edgeLength; ++x)
+	{
+		const float32_t u = GetFaceCoord(x, invEdgeLength);
+
+		float32_t direction[3];
+
+		for(uint32_t i = 0; i < 3; ++i)
+		{
+			direction[i] = (row.axisU[i] * u) + row.rowOffset[i];
+		}
+
+		// Latitude is asin() of the normalized vertical component, taken here as the angle above the horizontal plane.
+		const float32_t horizontal = sqrtf((direction[0] * direction[0]) + (direction[2] * direction[2]));
+		const float32_t longitude = AtanScalar(direction[0], direction[2]);
+		const float32_t latitude = AtanScalar(direction[1], horizontal);
+
+		const float32_t texU = (longitude * InvTwoPi) + 0.5f;
+		const float32_t texV = 1.0f - ((latitude * InvPi) + 0.5f);
+
+		const float32_t sampleX = (texU * width) - 0.5f;
+		const float32_t sampleY = (texV * height) - 0.5f;
+		const float32_t floorX = floorf(sampleX);
+		const float32_t floorY = floorf(sampleY);
+
+		FetchBilinear(equirect, int32_t(floorX), int32_t(floorY), sampleX - floorX, sampleY - floorY, pOutRow + (size_t(x) * 4));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertRowAvx2(
+	const DemoFramework::Utility::ImageResampler::ConstImage& equirect,
+	const FaceRow& row,
+	const uint32_t edgeLength,
+	const float32_t invEdgeLength,
+	float32_t* const pOutRow)
+{
+	const __m256 width = _mm256_set1_ps(float32_t(equirect.width));
+	const __m256 height = _mm256_set1_ps(float32_t(equirect.height));
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 invEdge = _mm256_set1_ps(invEdgeLength);
+	const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	alignas(32) int32_t x0[DF_CUBE_MAP_CONVERTER_BLOCK_SIZE];
+	alignas(32) int32_t y0[DF_CUBE_MAP_CONVERTER_BLOCK_SIZE];
+	alignas(32) float32_t fracX[DF_CUBE_MAP_CONVERTER_BLOCK_SIZE];
+	alignas(32) float32_t fracY[DF_CUBE_MAP_CONVERTER_BLOCK_SIZE];
+
+	for(uint32_t blockStart = 0; blockStart < edgeLength; blockStart += DF_CUBE_MAP_CONVERTER_BLOCK_SIZE)
+	{
+		const __m256 coord = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(int32_t(blockStart)), laneOffsets));
+		const __m256 u = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(coord, half), invEdge), two), one);
+
+		const __m256 dirX = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(row.axisU[0]), u), _mm256_set1_ps(row.rowOffset[0]));
+		const __m256 dirY = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(row.axisU[1]), u), _mm256_set1_ps(row.rowOffset[1]));
+		const __m256 dirZ = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(row.axisU[2]), u), _mm256_set1_ps(row.rowOffset[2]));
+
+		const __m256 horizontal = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dirX, dirX), _mm256_mul_ps(dirZ, dirZ)));
+		const __m256 longitude = AtanAvx2(dirX, dirZ);
+		const __m256 latitude = AtanAvx2(dirY, horizontal);
+
+		const __m256 texU = _mm256_add_ps(_mm256_mul_ps(longitude, _mm256_set1_ps(InvTwoPi)), half);
+		const __m256 texV = _mm256_sub_ps(one, _mm256_add_ps(_mm256_mul_ps(latitude, _mm256_set1_ps(InvPi)), half));
+
+		const __m256 sampleX = _mm256_sub_ps(_mm256_mul_ps(texU, width), half);
+		const __m256 sampleY = _mm256_sub_ps(_mm256_mul_ps(texV, height), half);
+		const __m256 floorX = _mm256_floor_ps(sampleX);
+		const __m256 floorY = _mm256_floor_ps(sampleY);
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(x0), _mm256_cvttps_epi32(floorX));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(y0), _mm256_cvttps_epi32(floorY));
+		_mm256_store_ps(fracX, _mm256_sub_ps(sampleX, floorX));
+		_mm256_store_ps(fracY, _mm256_sub_ps(sampleY, floorY));
+
+		const uint32_t laneCount = (edgeLength - blockStart < DF_CUBE_MAP_CONVERTER_BLOCK_SIZE)
+			? (edgeLength - blockStart)
+			: DF_CUBE_MAP_CONVERTER_BLOCK_SIZE;
+
+		for(uint32_t lane = 0; lane < laneCount; ++lane)
+		{
+			FetchBilinear(equirect, x0[lane], y0[lane], fracX[lane], fracY[lane], pOutRow + (size_t(blockStart + lane) * 4));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void BuildAxisTaps(const uint32_t srcEdgeLength, const uint32_t dstEdgeLength, std::vector<AxisTaps>& outTaps)
+{
+	const float64_t ratio = float64_t(srcEdgeLength) / float64_t(dstEdgeLength);
+
+	outTaps.resize(dstEdgeLength);
+
+	for(uint32_t dst = 0; dst < dstEdgeLength; ++dst)
+	{
+		const float64_t spanStart = float64_t(dst) * ratio;
+		const float64_t spanEnd = float64_t(dst + 1) * ratio;
+
+		const uint32_t first = uint32_t(floor(spanStart));
+		uint32_t end = uint32_t(ceil(spanEnd));
+
+		if(end > srcEdgeLength)
+		{
+			end = srcEdgeLength;
+		}
+
+		AxisTaps& taps = outTaps[dst];
+
+		taps.first = first;
+		taps.count = end - first;
+
+		for(uint32_t tap = 0; tap < taps.count; ++tap)
+		{
+			const float64_t texelStart = float64_t(first + tap);
+			const float64_t overlapStart = (texelStart > spanStart) ? texelStart : spanStart;
+			const float64_t overlapEnd = (texelStart + 1.0 < spanEnd) ? (texelStart + 1.0) : spanEnd;
+
+			taps.weight[tap] = float32_t(overlapEnd - overlapStart);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Downsample a row of RGBA32Float texels. Each source texel is weighted by how much of it the destination texel covers
+// and by 'getArea(x, y)', the relative area it spans on the sphere, so the result is the average radiance over the
+// solid angle of the destination texel.
+template <typename AreaFunc>
+static void DownsampleRow(
+	const DemoFramework::Utility::ImageResampler::ConstImage& src,
+	const AxisTaps& rowTaps,
+	const AxisTaps* const pColumnTaps,
+	const uint32_t dstWidth,
+	const AreaFunc& getArea,
+	float32_t* const pOutRow)
+{
+	for(uint32_t x = 0; x < dstWidth; ++x)
+	{
+		const AxisTaps& columnTaps = pColumnTaps[x];
+
+		__m128 sum = _mm_setzero_ps();
+		float32_t weightSum = 0.0f;
+
+		for(uint32_t rowTap = 0; rowTap < rowTaps.count; ++rowTap)
+		{
+			const uint32_t srcY = rowTaps.first + rowTap;
+			const float32_t* const pSrcRow = reinterpret_cast<const float32_t*>(src.pData + (src.rowPitch * size_t(srcY)));
+
+			for(uint32_t columnTap = 0; columnTap < columnTaps.count; ++columnTap)
+			{
+				const uint32_t srcX = columnTaps.first + columnTap;
+				const float32_t weight = (rowTaps.weight[rowTap] * columnTaps.weight[columnTap]) * getArea(srcX, srcY);
+
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pSrcRow + (size_t(srcX) * 4)), _mm_set1_ps(weight)));
+				weightSum += weight;
+			}
+		}
+
+		_mm_storeu_ps(pOutRow + (size_t(x) * 4), _mm_div_ps(sum, _mm_set1_ps(weightSum)));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Run 'rowFunc(rowIndex)' over 'rowCount' rows of 'rowLength' texels.
+template <typename RowFunc>
+static void RunRows(
+	const size_t rowCount,
+	const uint32_t rowLength,
+	DemoFramework::Utility::ThreadPool* const pThreadPool,
+	const RowFunc& rowFunc)
+{
+	const size_t rowsPerTask = (rowLength < DF_CUBE_MAP_CONVERTER_TASK_TEXEL_COUNT) ? (DF_CUBE_MAP_CONVERTER_TASK_TEXEL_COUNT / rowLength) : 1;
+	const size_t taskCount = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+	auto runTask = [&](const size_t taskIndex)
+	{
+		const size_t rowBegin = taskIndex * rowsPerTask;
+		const size_t rowEnd = (rowBegin + rowsPerTask < rowCount) ? (rowBegin + rowsPerTask) : rowCount;
+
+		for(size_t rowIndex = rowBegin; rowIndex < rowEnd; ++rowIndex)
+		{
+			rowFunc(rowIndex);
+		}
+	};
+
+	if(pThreadPool && taskCount > 1)
+	{
+		pThreadPool->ParallelFor(taskCount, runTask);
+	}
+	else
+	{
+		for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+		{
+			runTask(taskIndex);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool ValidateFaces(
+	const DemoFramework::Utility::ImageResampler::Image* const pFaces,
+	const uint32_t edgeLength,
+	const uint32_t mipCount)
+{
+	if(!pFaces || edgeLength == 0 || mipCount == 0)
+	{
+		return false;
+	}
+
+	// Every level has to be at least 1 texel in size.
+	if(mipCount > 32 || (edgeLength >> (mipCount - 1)) == 0)
+	{
+		return false;
+	}
+
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+		{
+			const DemoFramework::Utility::ImageResampler::Image& face = pFaces[(faceIndex * mipCount) + mipIndex];
+			const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+			if(!face.pData
+				|| face.width != mipEdgeLength
+				|| face.height != mipEdgeLength
+				|| face.rowPitch < size_t(mipEdgeLength) * sizeof(float32_t) * 4)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::CubeMapConverter::CalculateEquirectUvFromNormal(const float32_t* const pNormal, float32_t* const pOutUv)
+{
+	const float32_t horizontal = sqrtf((pNormal[0] * pNormal[0]) + (pNormal[2] * pNormal[2]));
+
+	pOutUv[0] = (AtanScalar(pNormal[0], pNormal[2]) * InvTwoPi) + 0.5f;
+	pOutUv[1] = 1.0f - ((AtanScalar(pNormal[1], horizontal) * InvPi) + 0.5f);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::CubeMapConverter::Convert(
+	const ImageResampler::ConstImage& equirect,
+	const ImageResampler::Image* const pFaces,
+	const uint32_t edgeLength,
+	const uint32_t mipCount,
+	ThreadPool* const pThreadPool)
+{
+	if(!equirect.pData
+		|| equirect.width == 0
+		|| equirect.height == 0
+		|| equirect.width > INT32_MAX / 2
+		|| equirect.height > INT32_MAX / 2
+		|| equirect.rowPitch < size_t(equirect.width) * sizeof(float32_t) * 4
+		|| !ValidateFaces(pFaces, edgeLength, mipCount))
+	{
+		return false;
+	}
+
+	// A texel at the center of a face spans 2 / edgeLength radians. When that covers 2 or more equirect texels, sample
+	// a downsampled copy of the equirect instead, halved until its texels are about the size of the cube texels.
+	const float32_t texelsPerRadian = (float32_t(equirect.width) / TwoPi < float32_t(equirect.height) / Pi)
+		? (float32_t(equirect.width) / TwoPi)
+		: (float32_t(equirect.height) / Pi);
+	const float32_t footprint = texelsPerRadian * (2.0f / float32_t(edgeLength));
+
+	ImageResampler::ConstImage source = equirect;
+	std::vector<float32_t> reducedTexels[2];
+	std::vector<AxisTaps> columnTaps;
+	std::vector<AxisTaps> rowTaps;
+	std::vector<float32_t> cosLatitudes;
+
+	for(uint32_t reduction = 0; footprint >= float32_t(2u << reduction) && reduction < 31; ++reduction)
+	{
+		const uint32_t reducedWidth = (source.width > 1) ? (source.width >> 1) : 1;
+		const uint32_t reducedHeight = (source.height > 1) ? (source.height >> 1) : 1;
+
+		std::vector<float32_t>& texels = reducedTexels[reduction & 1];
+		texels.resize(size_t(reducedWidth) * size_t(reducedHeight) * 4);
+
+		BuildAxisTaps(source.width, reducedWidth, columnTaps);
+		BuildAxisTaps(source.height, reducedHeight, rowTaps);
+
+		// Equirect texels shrink toward the poles with the cosine of their latitude.
+		cosLatitudes.resize(source.height);
+
+		for(uint32_t y = 0; y < source.height; ++y)
+		{
+			cosLatitudes[y] = cosf(Pi * (((float32_t(y) + 0.5f) / float32_t(source.height)) - 0.5f));
+		}
+
+		RunRows(reducedHeight, reducedWidth, pThreadPool, [&](const size_t y)
+		{
+			DownsampleRow(
+				source,
+				rowTaps[y],
+				columnTaps.data(),
+				reducedWidth,
+				[&cosLatitudes](const uint32_t, const uint32_t srcY) { return cosLatitudes[srcY]; },
+				texels.data() + (y * size_t(reducedWidth) * 4));
+		});
+
+		source.pData = reinterpret_cast<const uint8_t*>(texels.data());
+		source.rowPitch = size_t(reducedWidth) * sizeof(float32_t) * 4;
+		source.width = reducedWidth;
+		source.height = reducedHeight;
+	}
+
+	const float32_t invEdgeLength = 1.0f / float32_t(edgeLength);
+	const auto convertRow = CpuFeatures::HasAvx2() ? ConvertRowAvx2 : ConvertRowScalar;
+
+	RunRows(size_t(edgeLength) * DF_CUBE_MAP_FACE_COUNT, edgeLength, pThreadPool, [&](const size_t rowIndex)
+	{
+		const uint32_t faceIndex = uint32_t(rowIndex / edgeLength);
+		const uint32_t y = uint32_t(rowIndex % edgeLength);
+
+		const ImageResampler::Image& face = pFaces[faceIndex * mipCount];
+
+		convertRow(
+			source,
+			GetFaceRow(y, faceIndex, invEdgeLength),
+			edgeLength,
+			invEdgeLength,
+			reinterpret_cast<float32_t*>(face.pData + (face.rowPitch * y)));
+	});
+
+	return GenerateMips(pFaces, edgeLength, mipCount, pThreadPool);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::CubeMapConverter::GenerateMips(
+	const ImageResampler::Image* const pFaces,
+	const uint32_t edgeLength,
+	const uint32_t mipCount,
+	ThreadPool* const pThreadPool)
+{
+	if(!ValidateFaces(pFaces, edgeLength, mipCount))
+	{
+		return false;
+	}
+
+	std::vector<AxisTaps> taps;
+	std::vector<float32_t> srcCoordsSquared;
+
+	for(uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t srcEdgeLength = edgeLength >> (mipIndex - 1);
+		const uint32_t dstEdgeLength = edgeLength >> mipIndex;
+		const float32_t invSrcEdgeLength = 1.0f / float32_t(srcEdgeLength);
+
+		// Faces are square, so the same taps work for both axes.
+		BuildAxisTaps(srcEdgeLength, dstEdgeLength, taps);
+
+		srcCoordsSquared.resize(srcEdgeLength);
+
+		for(uint32_t i = 0; i < srcEdgeLength; ++i)
+		{
+			const float32_t coord = GetFaceCoord(i, invSrcEdgeLength);
+
+			srcCoordsSquared[i] = coord * coord;
+		}
+
+		RunRows(size_t(dstEdgeLength) * DF_CUBE_MAP_FACE_COUNT, dstEdgeLength, pThreadPool, [&](const size_t rowIndex)
+		{
+			const uint32_t faceIndex = uint32_t(rowIndex / dstEdgeLength);
+			const uint32_t y = uint32_t(rowIndex % dstEdgeLength);
+
+			const ImageResampler::Image& src = pFaces[(faceIndex * mipCount) + mipIndex - 1];
+			const ImageResampler::Image& dst = pFaces[(faceIndex * mipCount) + mipIndex];
+
+			const ImageResampler::ConstImage srcImage = { src.pData, src.rowPitch, src.width, src.height };
+
+			// Differential solid angle of a source texel, as ShProjection computes it, without the constant factor.
+			auto getSolidAngle = [&srcCoordsSquared](const uint32_t srcX, const uint32_t srcY)
+			{
+				const float32_t tmp = (1.0f + srcCoordsSquared[srcX]) + srcCoordsSquared[srcY];
+
+				return 1.0f / (sqrtf(tmp) * tmp);
+			};
+
+			DownsampleRow(
+				srcImage,
+				taps[y],
+				taps.data(),
+				dstEdgeLength,
+				getSolidAngle,
+				reinterpret_cast<float32_t*>(dst.pData + (dst.rowPitch * y)));
+		});
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ImageResampler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_CUBE_MAP_FACE_COUNT 6
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class CubeMapConverter;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// CPU conversion of an equirectangular environment map into a mipped cube map, as an alternative to the reflection
+// probe's equi-to-cube compute shader. Each cube texel looks up the equirect along the same direction the shader
+// computes for it, with a bilinear fetch from a copy of the equirect halved until its texels are about the size of a
+// cube texel, so large source images do not alias. The lower cube mips are then built from the level above them. All
+// of the downsampling weights each source texel by the area it covers on the sphere.
+//
+// Rows of the cube faces are spread across a thread pool and the direction math runs 8 texels at a time with AVX2 when
+// the CPU supports it. Every texel is computed by a single task in a fixed order, and the scalar and AVX2 paths do the
+// same arithmetic, so the output is bit-for-bit the same regardless of thread count or instruction set. That holds only
+// while the compiler keeps multiplies and adds unfused: the source file disables contraction for GCC and clang, and
+// MSVC builds must not use /fp:fast.
+//
+// Cube faces are indexed in D3D12 order (+X, -X, +Y, -Y, +Z, -Z). Arrays of face images hold all of the mips of face 0,
+// followed by all of the mips of face 1 and so on, matching the D3D12 subresource order of a cube texture.
+class DF_API DemoFramework::Utility::CubeMapConverter
+{
+public:
+
+	CubeMapConverter() = delete;
+	CubeMapConverter(const CubeMapConverter&) = delete;
+	CubeMapConverter(CubeMapConverter&&) = delete;
+
+	// Equirect texture coordinate for a direction, using the polynomial atan2() approximation the converter is built
+	// on. The direction does not need to be normalized.
+	static void CalculateEquirectUvFromNormal(const float32_t* pNormal, float32_t* pOutUv);
+
+	// Convert an RGBA32Float equirect into a cube map with 'mipCount' levels of RGBA32Float faces, the first of which
+	// is 'edgeLength' texels square. 'pFaces' holds DF_CUBE_MAP_FACE_COUNT * mipCount images. A null thread pool runs
+	// everything on the calling thread.
+	static bool Convert(
+		const ImageResampler::ConstImage& equirect,
+		const ImageResampler::Image* pFaces,
+		uint32_t edgeLength,
+		uint32_t mipCount,
+		ThreadPool* pThreadPool);
+
+	// Fill levels [1, mipCount) of the faces of a cube map by downsampling each level from the one above it. Level 0
+	// must already contain the source image.
+	static bool GenerateMips(
+		const ImageResampler::Image* pFaces,
+		uint32_t edgeLength,
+		uint32_t mipCount,
+		ThreadPool* pThreadPool);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <string.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class Hash;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Non-cryptographic 64-bit hashing used for cache keys and content identification.
+class DF_API DemoFramework::Utility::Hash
+{
+public:
+
+	Hash() = delete;
+	Hash(const Hash&) = delete;
+	Hash(Hash&&) = delete;
+
+	static constexpr uint64_t DefaultSeed = 0xCBF29CE484222325ull;
+
+	// Hash an arbitrary block of memory. Input is consumed 32 bytes at a time through four independent lanes,
+	// so this is fast enough to run over entire source files.
+	static uint64_t Compute(const void* pData, size_t size, uint64_t seed = DefaultSeed);
+
+	// Fold another value into an existing hash.
+	static uint64_t Combine(uint64_t hash, uint64_t value);
+
+
+private:
+
+	static uint64_t _mix(uint64_t);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::Hash::Compute(const void* const pData, const size_t size, const uint64_t seed)
+{
+	constexpr uint64_t prime0 = 0x9E3779B185EBCA87ull;
+	constexpr uint64_t prime1 = 0xC2B2AE3D27D4EB4Full;
+
+	const uint8_t* pStream = reinterpret_cast<const uint8_t*>(pData);
+	const uint8_t* const pStreamEnd = pStream + size;
+
+	uint64_t lanes[4] =
+	{
+		seed + prime0,
+		seed + prime1,
+		seed,
+		seed - prime0,
+	};
+
+	// Process the bulk of the input in 32-byte blocks.
+	while(pStreamEnd - pStream >= 32)
+	{
+		for(size_t i = 0; i < 4; ++i)
+		{
+			uint64_t value;
+			memcpy(&value, pStream + (i * sizeof(uint64_t)), sizeof(uint64_t));
+
+			lanes[i] += value * prime1;
+			lanes[i] = (lanes[i] << 31) | (lanes[i] >> 33);
+			lanes[i] *= prime0;
+		}
+
+		pStream += 32;
+	}
+
+	uint64_t output = Combine(Combine(Combine(lanes[0], lanes[1]), lanes[2]), lanes[3]) + uint64_t(size);
+
+	// Process any remaining bytes one at a time.
+	while(pStream < pStreamEnd)
+	{
+		output ^= uint64_t(*pStream) * prime0;
+		output = ((output << 11) | (output >> 53)) * prime1;
+
+		++pStream;
+	}
+
+	return _mix(output);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::Hash::Combine(const uint64_t hash, const uint64_t value)
+{
+	return _mix(hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::Hash::_mix(uint64_t value)
+{
+	// 64-bit finalizer from MurmurHash3.
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDull;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ull;
+	value ^= value >> 33;
+
+	return value;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,607 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "HdrDecoder.hpp"
+#include "CpuFeatures.hpp"
+#include "PixelConvert.hpp"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_HDR_DECODER_BAND_HEIGHT 32
+
+// Widths outside this range can't be stored with the per-channel run length encoding.
+#define DF_HDR_DECODER_RLE_MIN_WIDTH 8
+#define DF_HDR_DECODER_RLE_MAX_WIDTH 0x7FFF
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Decoded scanlines are stored as 4 planes of bytes (red, green, blue, exponent), each one as wide as the image.
+typedef void (*ConvertFunc)(const uint8_t*, uint32_t, uint8_t*);
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool ReadLine(
+	const uint8_t* const pFileData,
+	const size_t fileSize,
+	size_t& offset,
+	char* const pOutLine,
+	const size_t maxLineLength)
+{
+	size_t lineLength = 0;
+
+	while(offset < fileSize && pFileData[offset] != '\n')
+	{
+		// Anything past the end of the buffer is dropped; none of the lines we care about are that long.
+		if(lineLength + 1 < maxLineLength)
+		{
+			pOutLine[lineLength] = char(pFileData[offset]);
+			++lineLength;
+		}
+
+		++offset;
+	}
+
+	if(offset >= fileSize)
+	{
+		return false;
+	}
+
+	// Skip the newline.
+	++offset;
+
+	// Tolerate files that were saved with Windows line endings.
+	if(lineLength > 0 && pOutLine[lineLength - 1] == '\r')
+	{
+		--lineLength;
+	}
+
+	pOutLine[lineLength] = '\0';
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Decode a single scanline starting at 'offset' into 4 planes of bytes. When 'pPlanes' is null, the scanline is only
+// walked to find where it ends.
+static bool DecodeScanline(
+	const uint8_t* const pFileData,
+	const size_t fileSize,
+	size_t offset,
+	const uint32_t width,
+	uint8_t* const pPlanes,
+	size_t& outNextOffset)
+{
+	if(width >= DF_HDR_DECODER_RLE_MIN_WIDTH
+		&& width <= DF_HDR_DECODER_RLE_MAX_WIDTH
+		&& fileSize - offset >= 4
+		&& pFileData[offset] == 2
+		&& pFileData[offset + 1] == 2
+		&& (pFileData[offset + 2] & 0x80) == 0)
+	{
+		const uint32_t encodedWidth = (uint32_t(pFileData[offset + 2]) << 8) | uint32_t(pFileData[offset + 3]);
+		if(encodedWidth != width)
+		{
+			return false;
+		}
+
+		offset += 4;
+
+		// Each channel is run length encoded separately, one after the other.
+		for(uint32_t channel = 0; channel < 4; ++channel)
+		{
+			uint8_t* const pPlane = pPlanes ? (pPlanes + (size_t(channel) * width)) : nullptr;
+
+			uint32_t x = 0;
+
+			while(x < width)
+			{
+				if(offset >= fileSize)
+				{
+					return false;
+				}
+
+				uint32_t count = pFileData[offset];
+				++offset;
+
+				if(count > 128)
+				{
+					// A run of the same value.
+					count -= 128;
+
+					if(count > width - x || offset >= fileSize)
+					{
+						return false;
+					}
+
+					if(pPlane)
+					{
+						memset(pPlane + x, pFileData[offset], count);
+					}
+
+					++offset;
+				}
+				else
+				{
+					// A literal sequence of values.
+					if(count == 0 || count > width - x || count > fileSize - offset)
+					{
+						return false;
+					}
+
+					if(pPlane)
+					{
+						memcpy(pPlane + x, pFileData + offset, count);
+					}
+
+					offset += count;
+				}
+
+				x += count;
+			}
+		}
+
+		outNextOffset = offset;
+		return true;
+	}
+
+	// Flat scanline, which may use the original run length encoding where a (1, 1, 1, n) pixel repeats the pixel
+	// before it n times. Consecutive repeat pixels shift their counts up by another 8 bits each.
+	uint32_t shift = 0;
+	uint32_t x = 0;
+
+	while(x < width)
+	{
+		if(fileSize - offset < 4)
+		{
+			return false;
+		}
+
+		const uint8_t* const pPixel = pFileData + offset;
+		offset += 4;
+
+		if(pPixel[0] == 1 && pPixel[1] == 1 && pPixel[2] == 1)
+		{
+			if(x == 0 || shift > 24)
+			{
+				return false;
+			}
+
+			const uint32_t count = uint32_t(pPixel[3]) << shift;
+			if(count > width - x)
+			{
+				return false;
+			}
+
+			if(pPlanes)
+			{
+				for(uint32_t channel = 0; channel < 4; ++channel)
+				{
+					uint8_t* const pPlane = pPlanes + (size_t(channel) * width);
+
+					memset(pPlane + x, pPlane[x - 1], count);
+				}
+			}
+
+			x += count;
+			shift += 8;
+		}
+		else
+		{
+			if(pPlanes)
+			{
+				for(uint32_t channel = 0; channel < 4; ++channel)
+				{
+					pPlanes[(size_t(channel) * width) + x] = pPixel[channel];
+				}
+			}
+
+			++x;
+			shift = 0;
+		}
+	}
+
+	outNextOffset = offset;
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Scalar kernels
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertToHalfScalar(const uint8_t* const pPlanes, const uint32_t width, uint8_t* const pDst)
+{
+	const uint8_t* const pRed = pPlanes;
+	const uint8_t* const pGreen = pPlanes + width;
+	const uint8_t* const pBlue = pPlanes + (size_t(width) * 2);
+	const uint8_t* const pExponent = pPlanes + (size_t(width) * 3);
+
+	using PixelConvert = DemoFramework::Utility::PixelConvert;
+
+	for(uint32_t x = 0; x < width; ++x)
+	{
+		// PixelConvert::FloatToHalf() clamps to the largest finite half, since RGBE can represent much larger values.
+		const float scale = PixelConvert::GetRgbeScale(pExponent[x]);
+
+		const uint16_t texel[4] =
+		{
+			PixelConvert::FloatToHalf(float(pRed[x]) * scale),
+			PixelConvert::FloatToHalf(float(pGreen[x]) * scale),
+			PixelConvert::FloatToHalf(float(pBlue[x]) * scale),
+			0x3C00, // 1.0
+		};
+
+		memcpy(pDst + (size_t(x) * sizeof(texel)), texel, sizeof(texel));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// RGBE and RGB9E5 both store mantissas with a shared exponent, so the conversion is exact integer math: a channel
+// worth mantissa * 2^(exponent - 136) is (mantissa * 2) * 2^((exponent - 113) - 24) in RGB9E5. Exponents outside the
+// range RGB9E5 can hold shift the mantissas instead, saturating at the largest representable value.
+static uint32_t RgbeToSharedExponent(const uint32_t red, const uint32_t green, const uint32_t blue, const uint32_t exponent)
+{
+	const uint32_t shiftRight = (exponent < 113) ? (113 - exponent) : 0;
+	const uint32_t shiftLeft = (exponent > 144) ? std::min(exponent - 144, 9u) : 0;
+	const uint32_t sharedExponent = std::min(std::max(int32_t(exponent) - 113, 0), 31);
+
+	auto convertMantissa = [shiftRight, shiftLeft](const uint32_t mantissa) -> uint32_t
+	{
+		return (shiftRight >= 32) ? 0 : std::min(((mantissa << 1) << shiftLeft) >> shiftRight, 511u);
+	};
+
+	return convertMantissa(red)
+		| (convertMantissa(green) << 9)
+		| (convertMantissa(blue) << 18)
+		| (uint32_t(sharedExponent) << 27);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertToSharedExponentScalar(const uint8_t* const pPlanes, const uint32_t width, uint8_t* const pDst)
+{
+	const uint8_t* const pRed = pPlanes;
+	const uint8_t* const pGreen = pPlanes + width;
+	const uint8_t* const pBlue = pPlanes + (size_t(width) * 2);
+	const uint8_t* const pExponent = pPlanes + (size_t(width) * 3);
+
+	for(uint32_t x = 0; x < width; ++x)
+	{
+		const uint32_t texel = RgbeToSharedExponent(pRed[x], pGreen[x], pBlue[x], pExponent[x]);
+
+		memcpy(pDst + (size_t(x) * sizeof(texel)), &texel, sizeof(texel));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// AVX2 kernels
+//
+// These are only ever called after checking CpuFeatures::HasAvx2() (and CpuFeatures::HasF16c() for the half float
+// conversion).
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256i LoadBytesAvx2(const uint8_t* const pSrc)
+{
+	return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertToHalfAvx2(const uint8_t* const pPlanes, const uint32_t width, uint8_t* const pDst)
+{
+	const uint8_t* const pRed = pPlanes;
+	const uint8_t* const pGreen = pPlanes + width;
+	const uint8_t* const pBlue = pPlanes + (size_t(width) * 2);
+	const uint8_t* const pExponent = pPlanes + (size_t(width) * 3);
+
+	const __m256i exponentBias = _mm256_set1_epi32(9);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256 halfMax = _mm256_set1_ps(DemoFramework::Utility::PixelConvert::HalfMax);
+	const __m128i alpha = _mm_set1_epi16(0x3C00);
+
+	uint32_t x = 0;
+
+	for(; x + 8 <= width; x += 8)
+	{
+		const __m256i exponentBits = _mm256_slli_epi32(_mm256_max_epi32(_mm256_sub_epi32(LoadBytesAvx2(pExponent + x), exponentBias), zero), 23);
+		const __m256 scale = _mm256_castsi256_ps(exponentBits);
+
+		const __m256 red = _mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(LoadBytesAvx2(pRed + x)), scale), halfMax);
+		const __m256 green = _mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(LoadBytesAvx2(pGreen + x)), scale), halfMax);
+		const __m256 blue = _mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(LoadBytesAvx2(pBlue + x)), scale), halfMax);
+
+		const __m128i redHalf = _mm256_cvtps_ph(red, _MM_FROUND_TO_NEAREST_INT);
+		const __m128i greenHalf = _mm256_cvtps_ph(green, _MM_FROUND_TO_NEAREST_INT);
+		const __m128i blueHalf = _mm256_cvtps_ph(blue, _MM_FROUND_TO_NEAREST_INT);
+
+		// Interleave the channels into RGBA texels.
+		const __m128i redGreenLow = _mm_unpacklo_epi16(redHalf, greenHalf);
+		const __m128i redGreenHigh = _mm_unpackhi_epi16(redHalf, greenHalf);
+		const __m128i blueAlphaLow = _mm_unpacklo_epi16(blueHalf, alpha);
+		const __m128i blueAlphaHigh = _mm_unpackhi_epi16(blueHalf, alpha);
+
+		__m128i* const pOut = reinterpret_cast<__m128i*>(pDst + (size_t(x) * 8));
+
+		_mm_storeu_si128(pOut + 0, _mm_unpacklo_epi32(redGreenLow, blueAlphaLow));
+		_mm_storeu_si128(pOut + 1, _mm_unpackhi_epi32(redGreenLow, blueAlphaLow));
+		_mm_storeu_si128(pOut + 2, _mm_unpacklo_epi32(redGreenHigh, blueAlphaHigh));
+		_mm_storeu_si128(pOut + 3, _mm_unpackhi_epi32(redGreenHigh, blueAlphaHigh));
+	}
+
+	if(x < width)
+	{
+		// Each plane is 'width' bytes long, so the remainder is converted on its own set of planes.
+		uint8_t tail[4 * 8];
+
+		const uint32_t tailWidth = width - x;
+
+		for(uint32_t channel = 0; channel < 4; ++channel)
+		{
+			memcpy(tail + (channel * tailWidth), pPlanes + (size_t(channel) * width) + x, tailWidth);
+		}
+
+		ConvertToHalfScalar(tail, tailWidth, pDst + (size_t(x) * 8));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertToSharedExponentAvx2(const uint8_t* const pPlanes, const uint32_t width, uint8_t* const pDst)
+{
+	const uint8_t* const pRed = pPlanes;
+	const uint8_t* const pGreen = pPlanes + width;
+	const uint8_t* const pBlue = pPlanes + (size_t(width) * 2);
+	const uint8_t* const pExponent = pPlanes + (size_t(width) * 3);
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i minExponent = _mm256_set1_epi32(113);
+	const __m256i maxExponent = _mm256_set1_epi32(144);
+	const __m256i maxShift = _mm256_set1_epi32(9);
+	const __m256i maxSharedExponent = _mm256_set1_epi32(31);
+	const __m256i maxMantissa = _mm256_set1_epi32(511);
+
+	uint32_t x = 0;
+
+	for(; x + 8 <= width; x += 8)
+	{
+		const __m256i exponent = LoadBytesAvx2(pExponent + x);
+
+		// Variable shifts of 32 bits or more produce zero, which is what very small exponents should become.
+		const __m256i shiftRight = _mm256_max_epi32(_mm256_sub_epi32(minExponent, exponent), zero);
+		const __m256i shiftLeft = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(exponent, maxExponent), zero), maxShift);
+		const __m256i sharedExponent = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(exponent, minExponent), zero), maxSharedExponent);
+
+		auto convertMantissa = [&](const uint8_t* const pSrc)
+		{
+			const __m256i mantissa = _mm256_slli_epi32(LoadBytesAvx2(pSrc), 1);
+
+			return _mm256_min_epu32(_mm256_srlv_epi32(_mm256_sllv_epi32(mantissa, shiftLeft), shiftRight), maxMantissa);
+		};
+
+		const __m256i texels = _mm256_or_si256(
+			_mm256_or_si256(convertMantissa(pRed + x), _mm256_slli_epi32(convertMantissa(pGreen + x), 9)),
+			_mm256_or_si256(_mm256_slli_epi32(convertMantissa(pBlue + x), 18), _mm256_slli_epi32(sharedExponent, 27)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + (size_t(x) * 4)), texels);
+	}
+
+	for(; x < width; ++x)
+	{
+		const uint32_t texel = RgbeToSharedExponent(pRed[x], pGreen[x], pBlue[x], pExponent[x]);
+
+		memcpy(pDst + (size_t(x) * sizeof(texel)), &texel, sizeof(texel));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static ConvertFunc GetConvertFunc(const DemoFramework::Utility::HdrDecoder::Format format)
+{
+	using namespace DemoFramework::Utility;
+
+	const bool useAvx2 = CpuFeatures::HasAvx2();
+
+	if(format == HdrDecoder::Format::RGB9E5)
+	{
+		return useAvx2 ? ConvertToSharedExponentAvx2 : ConvertToSharedExponentScalar;
+	}
+
+	return (useAvx2 && CpuFeatures::HasF16c()) ? ConvertToHalfAvx2 : ConvertToHalfScalar;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::HdrDecoder::IsHdrFile(const uint8_t* const pFileData, const size_t fileSize)
+{
+	if(!pFileData)
+	{
+		return false;
+	}
+
+	const char radianceSignature[] = "#?RADIANCE";
+	const char rgbeSignature[] = "#?RGBE";
+
+	return (fileSize >= sizeof(radianceSignature) - 1 && memcmp(pFileData, radianceSignature, sizeof(radianceSignature) - 1) == 0)
+		|| (fileSize >= sizeof(rgbeSignature) - 1 && memcmp(pFileData, rgbeSignature, sizeof(rgbeSignature) - 1) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::HdrDecoder::ReadHeader(const uint8_t* const pFileData, const size_t fileSize, Header& outHeader)
+{
+	if(!IsHdrFile(pFileData, fileSize))
+	{
+		return false;
+	}
+
+	char line[256];
+	size_t offset = 0;
+
+	// Skip the signature line.
+	if(!ReadLine(pFileData, fileSize, offset, line, sizeof(line)))
+	{
+		return false;
+	}
+
+	// Header variables run until the first empty line.
+	for(;;)
+	{
+		if(!ReadLine(pFileData, fileSize, offset, line, sizeof(line)))
+		{
+			return false;
+		}
+
+		if(line[0] == '\0')
+		{
+			break;
+		}
+
+		const char formatVariable[] = "FORMAT=";
+
+		// The only other pixel format is XYZE, which would need a color space conversion.
+		if(strncmp(line, formatVariable, sizeof(formatVariable) - 1) == 0
+			&& strcmp(line + sizeof(formatVariable) - 1, "32-bit_rle_rgbe") != 0)
+		{
+			return false;
+		}
+	}
+
+	if(!ReadLine(pFileData, fileSize, offset, line, sizeof(line)))
+	{
+		return false;
+	}
+
+	// Resolution string; the first axis is the one scanlines are stacked along, and the second is the one running
+	// along each scanline.
+	const char* pCursor = line;
+
+	const char heightSign = pCursor[0];
+	const char heightAxis = (heightSign != '\0') ? pCursor[1] : '\0';
+
+	if((heightSign != '-' && heightSign != '+') || heightAxis != 'Y')
+	{
+		return false;
+	}
+
+	char* pEnd = nullptr;
+
+	const unsigned long height = strtoul(pCursor + 2, &pEnd, 10);
+	if(pEnd == pCursor + 2 || pEnd[0] != ' ' || pEnd[1] != '+' || pEnd[2] != 'X')
+	{
+		return false;
+	}
+
+	pCursor = pEnd + 3;
+
+	const unsigned long width = strtoul(pCursor, &pEnd, 10);
+	if(pEnd == pCursor || width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX)
+	{
+		return false;
+	}
+
+	outHeader.width = uint32_t(width);
+	outHeader.height = uint32_t(height);
+	outHeader.dataOffset = offset;
+	outHeader.bottomUp = (heightSign == '+');
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::HdrDecoder::Decode(
+	const uint8_t* const pFileData,
+	const size_t fileSize,
+	const Header& header,
+	const Format format,
+	uint8_t* const pDst,
+	const size_t dstRowPitch,
+	ThreadPool* const pThreadPool)
+{
+	if(!pFileData
+		|| !pDst
+		|| header.width == 0
+		|| header.height == 0
+		|| header.dataOffset > fileSize
+		|| dstRowPitch < size_t(header.width) * GetTexelSize(format))
+	{
+		return false;
+	}
+
+	const uint32_t width = header.width;
+	const uint32_t height = header.height;
+
+	std::vector<size_t> scanlineOffsets(size_t(height) + 1);
+
+	scanlineOffsets[0] = header.dataOffset;
+
+	// Find where every scanline starts. This only has to look at the run lengths, so it's cheap next to decoding.
+	for(uint32_t scanline = 0; scanline < height; ++scanline)
+	{
+		if(!DecodeScanline(pFileData, fileSize, scanlineOffsets[scanline], width, nullptr, scanlineOffsets[scanline + 1]))
+		{
+			return false;
+		}
+	}
+
+	const ConvertFunc convert = GetConvertFunc(format);
+	const uint32_t bandCount = (height + DF_HDR_DECODER_BAND_HEIGHT - 1) / DF_HDR_DECODER_BAND_HEIGHT;
+
+	auto decodeBand = [&](const size_t bandIndex)
+	{
+		const uint32_t firstScanline = uint32_t(bandIndex) * DF_HDR_DECODER_BAND_HEIGHT;
+		const uint32_t endScanline = std::min(firstScanline + DF_HDR_DECODER_BAND_HEIGHT, height);
+
+		std::vector<uint8_t> planes(size_t(width) * 4);
+
+		for(uint32_t scanline = firstScanline; scanline < endScanline; ++scanline)
+		{
+			size_t nextOffset = 0;
+
+			// Every scanline was already validated while finding the offsets, so this can't fail.
+			DecodeScanline(pFileData, fileSize, scanlineOffsets[scanline], width, planes.data(), nextOffset);
+
+			const uint32_t row = header.bottomUp ? (height - 1 - scanline) : scanline;
+
+			convert(planes.data(), width, pDst + (size_t(row) * dstRowPitch));
+		}
+	};
+
+	if(pThreadPool)
+	{
+		pThreadPool->ParallelFor(bandCount, decodeBand);
+	}
+	else
+	{
+		for(uint32_t bandIndex = 0; bandIndex < bandCount; ++bandIndex)
+		{
+			decodeBand(bandIndex);
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ThreadPool.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class HdrDecoder;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Decoder for Radiance RGBE (.hdr) images that converts texels straight to a GPU-ready HDR format instead of expanding
+// them to 32-bit floats first. Scanlines may be flat, use the old repeat-pixel run length encoding, or the newer
+// per-channel run length encoding. Only the standard top-to-bottom, left-to-right orientation ("-Y height +X width")
+// and its vertically flipped counterpart ("+Y height +X width") are supported.
+//
+// The conversion from RGBE uses AVX2 and F16C kernels when the CPU supports them.
+class DF_API DemoFramework::Utility::HdrDecoder
+{
+public:
+
+	enum class Format
+	{
+		RGBA16Float, // 8 bytes per texel; alpha is always 1
+		RGB9E5,      // 4 bytes per texel; 9-bit mantissas with a shared 5-bit exponent
+	};
+
+	struct Header
+	{
+		uint32_t width;
+		uint32_t height;
+
+		// Offset from the start of the file to the first scanline.
+		size_t dataOffset;
+
+		// True when the first scanline in the file is the bottom row of the image.
+		bool bottomUp;
+	};
+
+	HdrDecoder() = delete;
+	HdrDecoder(const HdrDecoder&) = delete;
+	HdrDecoder(HdrDecoder&&) = delete;
+
+	static size_t GetTexelSize(Format format);
+
+	// Check the file's signature without parsing the rest of the header.
+	static bool IsHdrFile(const uint8_t* pFileData, size_t fileSize);
+
+	static bool ReadHeader(const uint8_t* pFileData, size_t fileSize, Header& outHeader);
+
+	// Decode every scanline of the image to 'pDst', which must hold 'header.height' rows of 'dstRowPitch' bytes, with
+	// the top row of the image first. The scanlines are located with a quick serial pass over the run lengths, then
+	// decoded and converted in parallel bands of rows. A null thread pool runs everything on the calling thread.
+	static bool Decode(
+		const uint8_t* pFileData,
+		size_t fileSize,
+		const Header& header,
+		Format format,
+		uint8_t* pDst,
+		size_t dstRowPitch,
+		ThreadPool* pThreadPool);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::HdrDecoder::GetTexelSize(const Format format)
+{
+	return (format == Format::RGB9E5) ? 4 : 8;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,641 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ImageResampler.hpp"
+#include "CpuFeatures.hpp"
+#include "PixelConvert.hpp"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Number of destination rows processed by each parallel task.
+#define DF_IMAGE_RESAMPLER_BAND_HEIGHT 32
+
+#define DF_IMAGE_RESAMPLER_WINDOWED_SINC_RADIUS 3.0f
+#define DF_IMAGE_RESAMPLER_KAISER_ALPHA         4.0f
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	// Filter weights for one axis. Every destination texel reads 'tapCount' consecutive source texels starting at
+	// 'firstTap'. The weight table is padded to 'tapStride' entries per texel with zeros so the vectorized
+	// horizontal kernel can always process taps in pairs.
+	struct AxisWeights
+	{
+		std::vector<int32_t> firstTap;
+		std::vector<int32_t> tapCount;
+		std::vector<float> weights;
+
+		int32_t tapStride;
+	};
+
+	typedef void (*ConvertToFloatFunc)(const uint8_t*, float*, size_t);
+	typedef void (*ConvertFromFloatFunc)(const float*, uint8_t*, size_t);
+	typedef void (*HorizontalFunc)(const AxisWeights&, const float*, float*, uint32_t, uint32_t);
+	typedef void (*VerticalFunc)(const float* const*, const float*, int32_t, float*, size_t);
+
+	struct Kernels
+	{
+		ConvertToFloatFunc toFloat;
+		ConvertFromFloatFunc fromFloat;
+		HorizontalFunc horizontal;
+		VerticalFunc vertical;
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float Sinc(const float x)
+{
+	if(fabsf(x) < 1.0e-6f)
+	{
+		return 1.0f;
+	}
+
+	const float px = float(M_PI) * x;
+	return sinf(px) / px;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float BesselI0(const float x)
+{
+	// Power series of the zeroth order modified Bessel function of the first kind. The terms fall off
+	// fast enough for the small arguments used by the Kaiser window that a fixed number of them is plenty.
+	const float halfXSq = 0.25f * x * x;
+
+	float sum = 1.0f;
+	float term = 1.0f;
+
+	for(int k = 1; k < 20; ++k)
+	{
+		term *= halfXSq / float(k * k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float GetFilterRadius(const DemoFramework::Utility::ImageResampler::Filter filter)
+{
+	using Filter = DemoFramework::Utility::ImageResampler::Filter;
+
+	switch(filter)
+	{
+		case Filter::Box:
+			return 0.5f;
+
+		case Filter::Kaiser:
+		case Filter::Lanczos:
+			return DF_IMAGE_RESAMPLER_WINDOWED_SINC_RADIUS;
+
+		default:
+			break;
+	}
+
+	return 0.5f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float EvaluateFilter(const DemoFramework::Utility::ImageResampler::Filter filter, const float x)
+{
+	using Filter = DemoFramework::Utility::ImageResampler::Filter;
+
+	const float radius = DF_IMAGE_RESAMPLER_WINDOWED_SINC_RADIUS;
+
+	switch(filter)
+	{
+		case Filter::Box:
+			// Half-open so a texel sitting exactly on the boundary between two others is only counted once.
+			return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+
+		case Filter::Kaiser:
+		{
+			if(fabsf(x) >= radius)
+			{
+				return 0.0f;
+			}
+
+			const float t = x / radius;
+			const float window = BesselI0(DF_IMAGE_RESAMPLER_KAISER_ALPHA * sqrtf(1.0f - (t * t)))
+				/ BesselI0(DF_IMAGE_RESAMPLER_KAISER_ALPHA);
+
+			return Sinc(x) * window;
+		}
+
+		case Filter::Lanczos:
+			return (fabsf(x) < radius) ? Sinc(x) * Sinc(x / radius) : 0.0f;
+
+		default:
+			break;
+	}
+
+	return 0.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void BuildAxisWeights(
+	AxisWeights& output,
+	const DemoFramework::Utility::ImageResampler::Filter filter,
+	const uint32_t srcSize,
+	const uint32_t dstSize)
+{
+	const float scale = float(srcSize) / float(dstSize);
+
+	// When downsampling, the filter is stretched over the source texels so it acts as a low-pass filter at the
+	// destination frequency rather than just point sampling the source.
+	const float filterScale = std::max(scale, 1.0f);
+	const float support = GetFilterRadius(filter) * filterScale;
+
+	const int32_t maxTaps = int32_t(ceilf(support * 2.0f)) + 2;
+
+	output.tapStride = (std::min(maxTaps, int32_t(srcSize)) + 1) & ~1;
+	output.firstTap.assign(dstSize, 0);
+	output.tapCount.assign(dstSize, 0);
+	output.weights.assign(size_t(dstSize) * size_t(output.tapStride), 0.0f);
+
+	const int32_t lastSrcIndex = int32_t(srcSize) - 1;
+
+	for(uint32_t dstIndex = 0; dstIndex < dstSize; ++dstIndex)
+	{
+		// Texel centers sit at half-integer coordinates on both axes.
+		const float center = (float(dstIndex) + 0.5f) * scale;
+
+		const int32_t rawFirst = int32_t(floorf(center - support));
+		const int32_t rawLast = int32_t(ceilf(center + support));
+
+		const int32_t first = std::max(rawFirst, 0);
+		const int32_t last = std::min(rawLast, lastSrcIndex);
+
+		float* const pWeights = output.weights.data() + (size_t(dstIndex) * size_t(output.tapStride));
+
+		float weightSum = 0.0f;
+
+		for(int32_t srcIndex = rawFirst; srcIndex <= rawLast; ++srcIndex)
+		{
+			const float weight = EvaluateFilter(filter, ((float(srcIndex) + 0.5f) - center) / filterScale);
+			if(weight == 0.0f)
+			{
+				continue;
+			}
+
+			// Fold taps outside the image back onto the edge texels (clamp addressing).
+			const int32_t clampedIndex = std::min(std::max(srcIndex, first), last);
+
+			pWeights[clampedIndex - first] += weight;
+			weightSum += weight;
+		}
+
+		int32_t tapCount = last - first + 1;
+
+		if(weightSum == 0.0f)
+		{
+			// Degenerate case that can only happen with the box filter on extreme magnification
+			// where the destination texel center falls between two source texels.
+			const int32_t nearest = std::min(std::max(int32_t(center), 0), lastSrcIndex);
+
+			memset(pWeights, 0, sizeof(float) * size_t(output.tapStride));
+
+			pWeights[0] = 1.0f;
+			output.firstTap[dstIndex] = nearest;
+			output.tapCount[dstIndex] = 1;
+			continue;
+		}
+
+		const float invWeightSum = 1.0f / weightSum;
+
+		for(int32_t tap = 0; tap < tapCount; ++tap)
+		{
+			pWeights[tap] *= invWeightSum;
+		}
+
+		// Trim zero weights off both ends so the kernels don't waste time on them.
+		int32_t leading = 0;
+		while(leading < (tapCount - 1) && pWeights[leading] == 0.0f)
+		{
+			++leading;
+		}
+
+		if(leading > 0)
+		{
+			memmove(pWeights, pWeights + leading, sizeof(float) * size_t(tapCount - leading));
+			memset(pWeights + (tapCount - leading), 0, sizeof(float) * size_t(leading));
+			tapCount -= leading;
+		}
+
+		while(tapCount > 1 && pWeights[tapCount - 1] == 0.0f)
+		{
+			--tapCount;
+		}
+
+		output.firstTap[dstIndex] = first + leading;
+		output.tapCount[dstIndex] = tapCount;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Format conversions
+//
+// These adapt the row buffers to PixelConvert, which picks its own SIMD kernels. The counts are in channels, and
+// there are 3 channels per RGB9E5 texel.
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertUnormToFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::UnormToFloat(pSrc, pDst, count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertFloatToUnorm(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::FloatToUnorm(pSrc, pDst, count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertHalfToFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::HalfToFloat(reinterpret_cast<const uint16_t*>(pSrc), pDst, count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertFloatToHalf(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::FloatToHalf(pSrc, reinterpret_cast<uint16_t*>(pDst), count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertSharedExponentToFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::SharedExponentToFloat(reinterpret_cast<const uint32_t*>(pSrc), pDst, count / 3);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void ConvertFloatToSharedExponent(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	DemoFramework::Utility::PixelConvert::FloatToSharedExponent(pSrc, reinterpret_cast<uint32_t*>(pDst), count / 3);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void CopyFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	memcpy(pDst, pSrc, sizeof(float) * count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void CopyFloat(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	memcpy(pDst, pSrc, sizeof(float) * count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Scalar kernels
+//---------------------------------------------------------------------------------------------------------------------
+
+static void HorizontalScalar(
+	const AxisWeights& axis,
+	const float* const pSrc,
+	float* const pDst,
+	const uint32_t dstWidth,
+	const uint32_t channelCount)
+{
+	for(uint32_t x = 0; x < dstWidth; ++x)
+	{
+		const float* const pWeights = axis.weights.data() + (size_t(x) * size_t(axis.tapStride));
+		const float* const pTaps = pSrc + (size_t(axis.firstTap[x]) * channelCount);
+		const int32_t tapCount = axis.tapCount[x];
+
+		float* const pOut = pDst + (size_t(x) * channelCount);
+
+		for(uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			float sum = 0.0f;
+
+			for(int32_t tap = 0; tap < tapCount; ++tap)
+			{
+				sum += pTaps[(size_t(tap) * channelCount) + channel] * pWeights[tap];
+			}
+
+			pOut[channel] = sum;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void VerticalScalar(
+	const float* const* const ppRows,
+	const float* const pWeights,
+	const int32_t tapCount,
+	float* const pDst,
+	const size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+	{
+		float sum = 0.0f;
+
+		for(int32_t tap = 0; tap < tapCount; ++tap)
+		{
+			sum += ppRows[tap][i] * pWeights[tap];
+		}
+
+		pDst[i] = sum;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// AVX2 kernels
+//
+// These are only ever called after checking CpuFeatures::HasAvx2().
+//---------------------------------------------------------------------------------------------------------------------
+
+static void HorizontalAvx2(
+	const AxisWeights& axis,
+	const float* const pSrc,
+	float* const pDst,
+	const uint32_t dstWidth,
+	const uint32_t channelCount)
+{
+	if(channelCount != 4)
+	{
+		// One and two channel rows don't map well onto 8-wide registers when every destination texel has its own
+		// set of weights, so those are left to the scalar loop which the compiler already vectorizes reasonably.
+		HorizontalScalar(axis, pSrc, pDst, dstWidth, channelCount);
+		return;
+	}
+
+	for(uint32_t x = 0; x < dstWidth; ++x)
+	{
+		const float* const pWeights = axis.weights.data() + (size_t(x) * size_t(axis.tapStride));
+		const float* const pTaps = pSrc + (size_t(axis.firstTap[x]) * 4);
+		const int32_t tapCount = axis.tapCount[x];
+
+		__m256 sum = _mm256_setzero_ps();
+
+		// Two RGBA texels per iteration. Odd tap counts read one texel past the last tap, but its weight is always
+		// zero and the row buffer is padded so the read stays in bounds.
+		for(int32_t tap = 0; tap < tapCount; tap += 2)
+		{
+			const __m256 weights = _mm256_set_m128(_mm_set1_ps(pWeights[tap + 1]), _mm_set1_ps(pWeights[tap]));
+			const __m256 texels = _mm256_loadu_ps(pTaps + (size_t(tap) * 4));
+
+			sum = _mm256_fmadd_ps(texels, weights, sum);
+		}
+
+		const __m128 result = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+
+		_mm_storeu_ps(pDst + (size_t(x) * 4), result);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void VerticalAvx2(
+	const float* const* const ppRows,
+	const float* const pWeights,
+	const int32_t tapCount,
+	float* const pDst,
+	const size_t count)
+{
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256 sum = _mm256_setzero_ps();
+
+		for(int32_t tap = 0; tap < tapCount; ++tap)
+		{
+			sum = _mm256_fmadd_ps(_mm256_loadu_ps(ppRows[tap] + i), _mm256_set1_ps(pWeights[tap]), sum);
+		}
+
+		_mm256_storeu_ps(pDst + i, sum);
+	}
+
+	for(; i < count; ++i)
+	{
+		float sum = 0.0f;
+
+		for(int32_t tap = 0; tap < tapCount; ++tap)
+		{
+			sum += ppRows[tap][i] * pWeights[tap];
+		}
+
+		pDst[i] = sum;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static Kernels GetKernels(const DemoFramework::Utility::ImageResampler::Format format)
+{
+	using Format = DemoFramework::Utility::ImageResampler::Format;
+
+	const bool useAvx2 = DemoFramework::Utility::CpuFeatures::HasAvx2();
+
+	Kernels output;
+
+	switch(format)
+	{
+		case Format::R8Unorm:
+		case Format::RG8Unorm:
+		case Format::RGBA8Unorm:
+			output.toFloat = ConvertUnormToFloat;
+			output.fromFloat = ConvertFloatToUnorm;
+			break;
+
+		case Format::RGBA16Float:
+			output.toFloat = ConvertHalfToFloat;
+			output.fromFloat = ConvertFloatToHalf;
+			break;
+
+		case Format::RGB9E5:
+			output.toFloat = ConvertSharedExponentToFloat;
+			output.fromFloat = ConvertFloatToSharedExponent;
+			break;
+
+		default:
+			output.toFloat = static_cast<ConvertToFloatFunc>(CopyFloat);
+			output.fromFloat = static_cast<ConvertFromFloatFunc>(CopyFloat);
+			break;
+	}
+
+	output.horizontal = useAvx2 ? HorizontalAvx2 : HorizontalScalar;
+	output.vertical = useAvx2 ? VerticalAvx2 : VerticalScalar;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ImageResampler::Resample(
+	const ConstImage& src,
+	const Image& dst,
+	const Format format,
+	const Filter filter,
+	ThreadPool* const pThreadPool)
+{
+	const uint32_t channelCount = GetChannelCount(format);
+
+	if(channelCount == 0
+		|| !src.pData
+		|| !dst.pData
+		|| src.width == 0
+		|| src.height == 0
+		|| dst.width == 0
+		|| dst.height == 0)
+	{
+		return false;
+	}
+
+	const Kernels kernels = GetKernels(format);
+	const bool resizeHorizontal = (src.width != dst.width);
+
+	AxisWeights horizontalAxis;
+	AxisWeights verticalAxis;
+
+	if(resizeHorizontal)
+	{
+		BuildAxisWeights(horizontalAxis, filter, src.width, dst.width);
+	}
+
+	BuildAxisWeights(verticalAxis, filter, src.height, dst.height);
+
+	const size_t srcRowLength = size_t(src.width) * channelCount;
+	const size_t dstRowLength = size_t(dst.width) * channelCount;
+
+	// Padding the source row lets the horizontal kernel read whole tap pairs without bounds checks.
+	const size_t srcRowPadding = resizeHorizontal ? (size_t(horizontalAxis.tapStride) * channelCount) : 0;
+
+	const uint32_t bandCount = (dst.height + DF_IMAGE_RESAMPLER_BAND_HEIGHT - 1) / DF_IMAGE_RESAMPLER_BAND_HEIGHT;
+
+	auto processBand = [&](const size_t bandIndex)
+	{
+		const uint32_t firstRow = uint32_t(bandIndex) * DF_IMAGE_RESAMPLER_BAND_HEIGHT;
+		const uint32_t lastRow = std::min(firstRow + DF_IMAGE_RESAMPLER_BAND_HEIGHT, dst.height) - 1;
+
+		// Source rows touched by this band. Neighbouring bands overlap by the filter support,
+		// so the rows in the overlap are filtered horizontally once per band.
+		const int32_t firstSrcRow = verticalAxis.firstTap[firstRow];
+		int32_t lastSrcRow = firstSrcRow;
+
+		for(uint32_t row = firstRow; row <= lastRow; ++row)
+		{
+			lastSrcRow = std::max(lastSrcRow, verticalAxis.firstTap[row] + verticalAxis.tapCount[row] - 1);
+		}
+
+		const size_t bandSrcRowCount = size_t(lastSrcRow - firstSrcRow + 1);
+
+		std::vector<float> srcRow(srcRowLength + srcRowPadding, 0.0f);
+		std::vector<float> filteredRows(bandSrcRowCount * dstRowLength);
+		std::vector<float> dstRow(dstRowLength);
+		std::vector<const float*> rowPointers(size_t(verticalAxis.tapStride));
+
+		// Horizontal pass over every source row feeding the band.
+		for(size_t bandRow = 0; bandRow < bandSrcRowCount; ++bandRow)
+		{
+			const uint8_t* const pSrcRow = src.pData + ((size_t(firstSrcRow) + bandRow) * src.rowPitch);
+			float* const pFiltered = filteredRows.data() + (bandRow * dstRowLength);
+
+			if(resizeHorizontal)
+			{
+				kernels.toFloat(pSrcRow, srcRow.data(), srcRowLength);
+				kernels.horizontal(horizontalAxis, srcRow.data(), pFiltered, dst.width, channelCount);
+			}
+			else
+			{
+				kernels.toFloat(pSrcRow, pFiltered, srcRowLength);
+			}
+		}
+
+		// Vertical pass writing the final rows.
+		for(uint32_t row = firstRow; row <= lastRow; ++row)
+		{
+			const int32_t tapCount = verticalAxis.tapCount[row];
+			const size_t firstTap = size_t(verticalAxis.firstTap[row] - firstSrcRow);
+			const float* const pWeights = verticalAxis.weights.data() + (size_t(row) * size_t(verticalAxis.tapStride));
+
+			for(int32_t tap = 0; tap < tapCount; ++tap)
+			{
+				rowPointers[size_t(tap)] = filteredRows.data() + ((firstTap + size_t(tap)) * dstRowLength);
+			}
+
+			kernels.vertical(rowPointers.data(), pWeights, tapCount, dstRow.data(), dstRowLength);
+			kernels.fromFloat(dstRow.data(), dst.pData + (size_t(row) * dst.rowPitch), dstRowLength);
+		}
+	};
+
+	if(pThreadPool)
+	{
+		pThreadPool->ParallelFor(bandCount, processBand);
+	}
+	else
+	{
+		for(uint32_t bandIndex = 0; bandIndex < bandCount; ++bandIndex)
+		{
+			processBand(bandIndex);
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ImageResampler::GenerateMips(
+	const Image* const pMips,
+	const uint32_t mipCount,
+	const Format format,
+	const Filter filter,
+	ThreadPool* const pThreadPool)
+{
+	if(!pMips || mipCount == 0)
+	{
+		return false;
+	}
+
+	for(uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+	{
+		const Image& parent = pMips[mipIndex - 1];
+		const ConstImage src = { parent.pData, parent.rowPitch, parent.width, parent.height };
+
+		if(!Resample(src, pMips[mipIndex], format, filter, pThreadPool))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
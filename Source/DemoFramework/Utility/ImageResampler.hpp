@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ThreadPool.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ImageResampler;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Separable image resampling and mip chain generation. Each pass converts the source rows to floating point, filters
+// them horizontally, then vertically, and converts the result back to the destination format. The output image is
+// split into bands of rows that are processed in parallel on a thread pool, and AVX2 kernels are selected at runtime
+// when the CPU supports them.
+class DF_API DemoFramework::Utility::ImageResampler
+{
+public:
+
+	enum class Filter
+	{
+		Box,     // Averages the source texels covered by each destination texel
+		Kaiser,  // Kaiser-windowed sinc (radius 3, alpha 4)
+		Lanczos, // Lanczos-windowed sinc (radius 3)
+	};
+
+	enum class Format
+	{
+		R8Unorm,
+		RG8Unorm,
+		RGBA8Unorm,
+		R32Float,
+		RG32Float,
+		RGBA32Float,
+		RGBA16Float,
+		RGB9E5,      // Unsigned RGB with 9-bit mantissas sharing a 5-bit exponent
+	};
+
+	struct Image
+	{
+		uint8_t* pData;
+		size_t rowPitch;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	struct ConstImage
+	{
+		const uint8_t* pData;
+		size_t rowPitch;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	ImageResampler() = delete;
+	ImageResampler(const ImageResampler&) = delete;
+	ImageResampler(ImageResampler&&) = delete;
+
+	static size_t GetTexelSize(Format format);
+	static uint32_t GetChannelCount(Format format);
+
+	// Resample the source image to the size of the destination image. A null thread pool runs everything on
+	// the calling thread.
+	static bool Resample(
+		const ConstImage& src,
+		const Image& dst,
+		Format format,
+		Filter filter,
+		ThreadPool* pThreadPool);
+
+	// Fill levels [1, mipCount) of a mip chain by downsampling each level from the one above it.
+	// Level 0 must already contain the source image.
+	static bool GenerateMips(
+		const Image* pMips,
+		uint32_t mipCount,
+		Format format,
+		Filter filter,
+		ThreadPool* pThreadPool);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::ImageResampler::GetTexelSize(const Format format)
+{
+	switch(format)
+	{
+		case Format::R8Unorm:     return 1;
+		case Format::RG8Unorm:    return 2;
+		case Format::RGBA8Unorm:  return 4;
+		case Format::R32Float:    return 4;
+		case Format::RG32Float:   return 8;
+		case Format::RGBA32Float: return 16;
+		case Format::RGBA16Float: return 8;
+		case Format::RGB9E5:      return 4;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::ImageResampler::GetChannelCount(const Format format)
+{
+	switch(format)
+	{
+		case Format::R8Unorm:
+		case Format::R32Float:
+			return 1;
+
+		case Format::RG8Unorm:
+		case Format::RG32Float:
+			return 2;
+
+		case Format::RGB9E5:
+			return 3;
+
+		case Format::RGBA8Unorm:
+		case Format::RGBA32Float:
+		case Format::RGBA16Float:
+			return 4;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,717 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "IrradianceVolume.hpp"
+#include "CpuFeatures.hpp"
+#include "PixelConvert.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Coefficient values per probe and the size of the padded record each probe is stored in, which is 4 AVX2 registers.
+#define DF_IRRADIANCE_VOLUME_VALUE_COUNT (DF_SH_PROJECTION_COEFF_COUNT * 3)
+#define DF_IRRADIANCE_VOLUME_RECORD_SIZE 32
+#define DF_IRRADIANCE_VOLUME_REGISTER_COUNT (DF_IRRADIANCE_VOLUME_RECORD_SIZE / 8)
+
+// Sample points are located in the grid a block at a time, one point per AVX2 lane.
+#define DF_IRRADIANCE_VOLUME_BLOCK_SIZE 8
+
+// Minimum number of sample points handed to each thread pool task.
+#define DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT 4096
+
+#define DF_IRRADIANCE_VOLUME_MAX_CORNER_COUNT 8
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the probe records using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface. Only the
+// vector matching the storage of the volume is used.
+struct DemoFramework::Utility::IrradianceVolume::ProbeData
+{
+	std::vector<float32_t> floatRecords;
+	std::vector<uint16_t> halfRecords;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Everything needed to find the cell of the grid a point is in.
+struct GridAxes
+{
+	float32_t origin[3];
+	float32_t invSpacing[3];
+	float32_t maxCoord[3]; // Grid coordinate of the last probe along each axis
+	float32_t maxCell[3];  // Grid coordinate of the first corner of the last cell along each axis
+
+	uint32_t stride[3]; // Distance between neighboring probes in the records, zero for axes with a single probe
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cells and fractional positions of a block of sample points. The base index is the record of the cell corner with the
+// lowest coordinates.
+struct CellBlock
+{
+	uint32_t baseIndex[DF_IRRADIANCE_VOLUME_BLOCK_SIZE];
+	float32_t fraction[3][DF_IRRADIANCE_VOLUME_BLOCK_SIZE];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Probes around a single sample point and their weights.
+struct CornerSet
+{
+	uint32_t index[DF_IRRADIANCE_VOLUME_MAX_CORNER_COUNT];
+	float32_t weight[DF_IRRADIANCE_VOLUME_MAX_CORNER_COUNT];
+	uint32_t count;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void GetGridAxes(const DemoFramework::Utility::IrradianceVolume::Desc& desc, GridAxes& outAxes)
+{
+	uint32_t stride = 1;
+
+	for(uint32_t axis = 0; axis < 3; ++axis)
+	{
+		const uint32_t probeCount = desc.probeCount[axis];
+
+		outAxes.origin[axis] = desc.origin[axis];
+		outAxes.invSpacing[axis] = 1.0f / desc.spacing[axis];
+		outAxes.maxCoord[axis] = float32_t(probeCount - 1);
+		outAxes.maxCell[axis] = (probeCount > 1) ? float32_t(probeCount - 2) : 0.0f;
+
+		// With a single probe along an axis, the fraction is always zero, but the corners past it still need to land on
+		// a valid record.
+		outAxes.stride[axis] = (probeCount > 1) ? stride : 0;
+
+		stride *= probeCount;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void LocateBlockScalar(
+	const GridAxes& axes,
+	const float32_t (&position)[3][DF_IRRADIANCE_VOLUME_BLOCK_SIZE],
+	CellBlock& outBlock)
+{
+	for(uint32_t lane = 0; lane < DF_IRRADIANCE_VOLUME_BLOCK_SIZE; ++lane)
+	{
+		uint32_t baseIndex = 0;
+
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			// Written to match what _mm256_max_ps() and _mm256_min_ps() do with NaN and signed zero, which is to return
+			// the second operand whenever the comparison is false.
+			float32_t coord = (position[axis][lane] - axes.origin[axis]) * axes.invSpacing[axis];
+			coord = (coord > 0.0f) ? coord : 0.0f;
+			coord = (coord < axes.maxCoord[axis]) ? coord : axes.maxCoord[axis];
+
+			float32_t cell = floorf(coord);
+			cell = (cell < axes.maxCell[axis]) ? cell : axes.maxCell[axis];
+
+			outBlock.fraction[axis][lane] = coord - cell;
+
+			baseIndex += uint32_t(cell) * axes.stride[axis];
+		}
+
+		outBlock.baseIndex[lane] = baseIndex;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// These are only ever called after checking CpuFeatures::HasAvx2() (and CpuFeatures::HasF16c() for half records).
+static void LocateBlockAvx2(
+	const GridAxes& axes,
+	const float32_t (&position)[3][DF_IRRADIANCE_VOLUME_BLOCK_SIZE],
+	CellBlock& outBlock)
+{
+	const __m256 zero = _mm256_setzero_ps();
+
+	__m256i baseIndex = _mm256_setzero_si256();
+
+	for(uint32_t axis = 0; axis < 3; ++axis)
+	{
+		__m256 coord = _mm256_mul_ps(
+			_mm256_sub_ps(_mm256_loadu_ps(position[axis]), _mm256_set1_ps(axes.origin[axis])),
+			_mm256_set1_ps(axes.invSpacing[axis]));
+		coord = _mm256_max_ps(coord, zero);
+		coord = _mm256_min_ps(coord, _mm256_set1_ps(axes.maxCoord[axis]));
+
+		__m256 cell = _mm256_floor_ps(coord);
+		cell = _mm256_min_ps(cell, _mm256_set1_ps(axes.maxCell[axis]));
+
+		_mm256_storeu_ps(outBlock.fraction[axis], _mm256_sub_ps(coord, cell));
+
+		baseIndex = _mm256_add_epi32(
+			baseIndex,
+			_mm256_mullo_epi32(_mm256_cvttps_epi32(cell), _mm256_set1_epi32(int32_t(axes.stride[axis]))));
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(outBlock.baseIndex), baseIndex);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void GetTrilinearCorners(const GridAxes& axes, const CellBlock& block, const uint32_t lane, CornerSet& outCorners)
+{
+	const float32_t fx = block.fraction[0][lane];
+	const float32_t fy = block.fraction[1][lane];
+	const float32_t fz = block.fraction[2][lane];
+
+	const float32_t gx = 1.0f - fx;
+	const float32_t gy = 1.0f - fy;
+	const float32_t gz = 1.0f - fz;
+
+	const float32_t weightXY[4] =
+	{
+		gx * gy,
+		fx * gy,
+		gx * fy,
+		fx * fy,
+	};
+
+	const uint32_t offsetXY[4] =
+	{
+		0,
+		axes.stride[0],
+		axes.stride[1],
+		axes.stride[0] + axes.stride[1],
+	};
+
+	const uint32_t baseIndex = block.baseIndex[lane];
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		outCorners.index[i] = baseIndex + offsetXY[i];
+		outCorners.weight[i] = weightXY[i] * gz;
+
+		outCorners.index[i + 4] = baseIndex + offsetXY[i] + axes.stride[2];
+		outCorners.weight[i + 4] = weightXY[i] * fz;
+	}
+
+	outCorners.count = 8;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Splits each cell into 6 tetrahedra around the diagonal from its lowest to its highest corner. The tetrahedron holding
+// a point is picked by the order of its fractions, and the point is blended from its 4 corners by walking along the
+// cell edges from the lowest corner in that order.
+static void GetTetrahedralCorners(const GridAxes& axes, const CellBlock& block, const uint32_t lane, CornerSet& outCorners)
+{
+	const float32_t fraction[3] =
+	{
+		block.fraction[0][lane],
+		block.fraction[1][lane],
+		block.fraction[2][lane],
+	};
+
+	// Axes ordered from the largest fraction to the smallest.
+	uint32_t order[3];
+
+	if(fraction[0] >= fraction[1])
+	{
+		if(fraction[1] >= fraction[2])
+		{
+			order[0] = 0; order[1] = 1; order[2] = 2;
+		}
+		else if(fraction[0] >= fraction[2])
+		{
+			order[0] = 0; order[1] = 2; order[2] = 1;
+		}
+		else
+		{
+			order[0] = 2; order[1] = 0; order[2] = 1;
+		}
+	}
+	else
+	{
+		if(fraction[2] >= fraction[1])
+		{
+			order[0] = 2; order[1] = 1; order[2] = 0;
+		}
+		else if(fraction[2] >= fraction[0])
+		{
+			order[0] = 1; order[1] = 2; order[2] = 0;
+		}
+		else
+		{
+			order[0] = 1; order[1] = 0; order[2] = 2;
+		}
+	}
+
+	const uint32_t baseIndex = block.baseIndex[lane];
+
+	outCorners.index[0] = baseIndex;
+	outCorners.index[1] = outCorners.index[0] + axes.stride[order[0]];
+	outCorners.index[2] = outCorners.index[1] + axes.stride[order[1]];
+	outCorners.index[3] = outCorners.index[2] + axes.stride[order[2]];
+
+	outCorners.weight[0] = 1.0f - fraction[order[0]];
+	outCorners.weight[1] = fraction[order[0]] - fraction[order[1]];
+	outCorners.weight[2] = fraction[order[1]] - fraction[order[2]];
+	outCorners.weight[3] = fraction[order[2]];
+
+	outCorners.count = 4;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float32_t LoadValue(const float32_t* const pRecord, const uint32_t valueIndex)
+{
+	return pRecord[valueIndex];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float32_t LoadValue(const uint16_t* const pRecord, const uint32_t valueIndex)
+{
+	return DemoFramework::Utility::PixelConvert::HalfToFloat(pRecord[valueIndex]);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void BlendScalar(const T* const pRecords, const CornerSet& corners, float32_t* const pOutValues)
+{
+	const T* const pFirstRecord = pRecords + (size_t(corners.index[0]) * DF_IRRADIANCE_VOLUME_RECORD_SIZE);
+
+	for(uint32_t valueIndex = 0; valueIndex < DF_IRRADIANCE_VOLUME_VALUE_COUNT; ++valueIndex)
+	{
+		pOutValues[valueIndex] = LoadValue(pFirstRecord, valueIndex) * corners.weight[0];
+	}
+
+	// Each product is rounded before it's added, the same as the separate multiply and add of the AVX2 path.
+	for(uint32_t cornerIndex = 1; cornerIndex < corners.count; ++cornerIndex)
+	{
+		const T* const pRecord = pRecords + (size_t(corners.index[cornerIndex]) * DF_IRRADIANCE_VOLUME_RECORD_SIZE);
+		const float32_t weight = corners.weight[cornerIndex];
+
+		for(uint32_t valueIndex = 0; valueIndex < DF_IRRADIANCE_VOLUME_VALUE_COUNT; ++valueIndex)
+		{
+			pOutValues[valueIndex] += LoadValue(pRecord, valueIndex) * weight;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256 LoadRegisterAvx2(const float32_t* const pRecord, const uint32_t registerIndex)
+{
+	return _mm256_loadu_ps(pRecord + (registerIndex * 8));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256 LoadRegisterAvx2(const uint16_t* const pRecord, const uint32_t registerIndex)
+{
+	return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pRecord + (registerIndex * 8))));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void BlendAvx2(const T* const pRecords, const CornerSet& corners, float32_t* const pOutValues)
+{
+	const T* const pFirstRecord = pRecords + (size_t(corners.index[0]) * DF_IRRADIANCE_VOLUME_RECORD_SIZE);
+	const __m256 firstWeight = _mm256_set1_ps(corners.weight[0]);
+
+	__m256 sums[DF_IRRADIANCE_VOLUME_REGISTER_COUNT];
+
+	for(uint32_t registerIndex = 0; registerIndex < DF_IRRADIANCE_VOLUME_REGISTER_COUNT; ++registerIndex)
+	{
+		sums[registerIndex] = _mm256_mul_ps(LoadRegisterAvx2(pFirstRecord, registerIndex), firstWeight);
+	}
+
+	for(uint32_t cornerIndex = 1; cornerIndex < corners.count; ++cornerIndex)
+	{
+		const T* const pRecord = pRecords + (size_t(corners.index[cornerIndex]) * DF_IRRADIANCE_VOLUME_RECORD_SIZE);
+		const __m256 weight = _mm256_set1_ps(corners.weight[cornerIndex]);
+
+		for(uint32_t registerIndex = 0; registerIndex < DF_IRRADIANCE_VOLUME_REGISTER_COUNT; ++registerIndex)
+		{
+			sums[registerIndex] = _mm256_add_ps(sums[registerIndex], _mm256_mul_ps(LoadRegisterAvx2(pRecord, registerIndex), weight));
+		}
+	}
+
+	_mm256_storeu_ps(pOutValues, sums[0]);
+	_mm256_storeu_ps(pOutValues + 8, sums[1]);
+	_mm256_storeu_ps(pOutValues + 16, sums[2]);
+
+	// Only the first 3 values of the last register are coefficients; the rest is padding.
+	const __m256i tailMask = _mm256_setr_epi32(-1, -1, -1, 0, 0, 0, 0, 0);
+	_mm256_maskstore_ps(pOutValues + 24, tailMask, sums[3]);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Blend the probes for a range of sample points, calling 'onBlock' with the coefficients of every block of points.
+template <typename T, typename BlockFunc>
+static void SampleRange(
+	const T* const pRecords,
+	const GridAxes& axes,
+	const float32_t* const pPositions,
+	const size_t pointBegin,
+	const size_t pointEnd,
+	const DemoFramework::Utility::IrradianceVolume::Interpolation interpolation,
+	const bool useAvx2,
+	const BlockFunc& onBlock)
+{
+	using namespace DemoFramework::Utility;
+
+	const auto locateBlock = useAvx2 ? LocateBlockAvx2 : LocateBlockScalar;
+	const auto blend = useAvx2 ? BlendAvx2<T> : BlendScalar<T>;
+	const auto getCorners = (interpolation == IrradianceVolume::Interpolation::Tetrahedral) ? GetTetrahedralCorners : GetTrilinearCorners;
+
+	ShProjection::Coefficients coefficients[DF_IRRADIANCE_VOLUME_BLOCK_SIZE];
+
+	for(size_t blockBegin = pointBegin; blockBegin < pointEnd; blockBegin += DF_IRRADIANCE_VOLUME_BLOCK_SIZE)
+	{
+		const size_t remaining = pointEnd - blockBegin;
+		const uint32_t blockPointCount = (remaining < DF_IRRADIANCE_VOLUME_BLOCK_SIZE) ? uint32_t(remaining) : DF_IRRADIANCE_VOLUME_BLOCK_SIZE;
+
+		// Unused lanes of a partial block are left at zero and their results are ignored.
+		float32_t position[3][DF_IRRADIANCE_VOLUME_BLOCK_SIZE] = {};
+
+		for(uint32_t lane = 0; lane < blockPointCount; ++lane)
+		{
+			const float32_t* const pPosition = pPositions + ((blockBegin + lane) * 3);
+
+			position[0][lane] = pPosition[0];
+			position[1][lane] = pPosition[1];
+			position[2][lane] = pPosition[2];
+		}
+
+		CellBlock block;
+		locateBlock(axes, position, block);
+
+		for(uint32_t lane = 0; lane < blockPointCount; ++lane)
+		{
+			CornerSet corners;
+			getCorners(axes, block, lane, corners);
+
+			blend(pRecords, corners, &coefficients[lane].value[0][0]);
+		}
+
+		onBlock(blockBegin, blockPointCount, coefficients);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Split the sample points across the thread pool in tasks of whole blocks.
+template <typename RangeFunc>
+static void RunTasks(const size_t pointCount, DemoFramework::Utility::ThreadPool* const pThreadPool, const RangeFunc& sampleRange)
+{
+	const size_t taskCount = (pointCount + DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT - 1) / DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT;
+
+	auto runTask = [&](const size_t taskIndex)
+	{
+		const size_t pointBegin = taskIndex * DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT;
+		const size_t pointEnd = (pointBegin + DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT < pointCount)
+			? (pointBegin + DF_IRRADIANCE_VOLUME_TASK_POINT_COUNT)
+			: pointCount;
+
+		sampleRange(pointBegin, pointEnd);
+	};
+
+	if(pThreadPool && taskCount > 1)
+	{
+		pThreadPool->ParallelFor(taskCount, runTask);
+	}
+	else
+	{
+		for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+		{
+			runTask(taskIndex);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::IrradianceVolume::IrradianceVolume()
+	: m_pData(new ProbeData())
+	, m_desc()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::IrradianceVolume::~IrradianceVolume()
+{
+	if(m_pData)
+	{
+		delete m_pData;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::IrradianceVolume::Reset(const Desc& desc)
+{
+	uint64_t probeCount = 1;
+
+	for(uint32_t axis = 0; axis < 3; ++axis)
+	{
+		// The negated comparison also turns away NaN spacings.
+		if(desc.probeCount[axis] == 0 || !(desc.spacing[axis] > 0.0f) || isinf(desc.spacing[axis]))
+		{
+			return false;
+		}
+
+		probeCount *= desc.probeCount[axis];
+	}
+
+	// Probe indices are computed in 32-bit lanes.
+	if(probeCount > uint64_t(INT32_MAX)
+		|| (desc.storage != Storage::Float32 && desc.storage != Storage::Float16))
+	{
+		return false;
+	}
+
+	m_desc = desc;
+
+	m_pData->floatRecords.clear();
+	m_pData->halfRecords.clear();
+
+	if(desc.storage == Storage::Float16)
+	{
+		m_pData->floatRecords.shrink_to_fit();
+		m_pData->halfRecords.resize(size_t(probeCount) * DF_IRRADIANCE_VOLUME_RECORD_SIZE, 0);
+	}
+	else
+	{
+		m_pData->halfRecords.shrink_to_fit();
+		m_pData->floatRecords.resize(size_t(probeCount) * DF_IRRADIANCE_VOLUME_RECORD_SIZE, 0.0f);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::IrradianceVolume::SetProbe(
+	const uint32_t x,
+	const uint32_t y,
+	const uint32_t z,
+	const ShProjection::Coefficients& coefficients)
+{
+	if(x >= m_desc.probeCount[0] || y >= m_desc.probeCount[1] || z >= m_desc.probeCount[2])
+	{
+		return;
+	}
+
+	const size_t recordOffset = _getProbeIndex(x, y, z) * DF_IRRADIANCE_VOLUME_RECORD_SIZE;
+
+	// The padding at the end of each record is left at zero.
+	if(m_desc.storage == Storage::Float16)
+	{
+		PixelConvert::FloatToHalf(&coefficients.value[0][0], m_pData->halfRecords.data() + recordOffset, DF_IRRADIANCE_VOLUME_VALUE_COUNT);
+	}
+	else
+	{
+		memcpy(m_pData->floatRecords.data() + recordOffset, coefficients.value, sizeof(coefficients.value));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::IrradianceVolume::GetProbe(
+	const uint32_t x,
+	const uint32_t y,
+	const uint32_t z,
+	ShProjection::Coefficients& outCoefficients) const
+{
+	if(x >= m_desc.probeCount[0] || y >= m_desc.probeCount[1] || z >= m_desc.probeCount[2])
+	{
+		memset(&outCoefficients, 0, sizeof(outCoefficients));
+		return;
+	}
+
+	const size_t recordOffset = _getProbeIndex(x, y, z) * DF_IRRADIANCE_VOLUME_RECORD_SIZE;
+
+	if(m_desc.storage == Storage::Float16)
+	{
+		PixelConvert::HalfToFloat(m_pData->halfRecords.data() + recordOffset, &outCoefficients.value[0][0], DF_IRRADIANCE_VOLUME_VALUE_COUNT);
+	}
+	else
+	{
+		memcpy(outCoefficients.value, m_pData->floatRecords.data() + recordOffset, sizeof(outCoefficients.value));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::IrradianceVolume::Sample(
+	const float32_t* const pPositions,
+	const size_t pointCount,
+	const Interpolation interpolation,
+	ThreadPool* const pThreadPool,
+	ShProjection::Coefficients* const pOutCoefficients) const
+{
+	if(!pPositions || !pOutCoefficients || pointCount == 0 || GetProbeCount() == 0)
+	{
+		return;
+	}
+
+	auto copyBlock = [pOutCoefficients](const size_t blockBegin, const uint32_t blockPointCount, const ShProjection::Coefficients* const pBlock)
+	{
+		memcpy(pOutCoefficients + blockBegin, pBlock, sizeof(ShProjection::Coefficients) * blockPointCount);
+	};
+
+	GridAxes axes;
+	GetGridAxes(m_desc, axes);
+
+	if(m_desc.storage == Storage::Float16)
+	{
+		const bool useAvx2 = CpuFeatures::HasAvx2() && CpuFeatures::HasF16c();
+		const uint16_t* const pRecords = m_pData->halfRecords.data();
+
+		RunTasks(pointCount, pThreadPool, [&](const size_t pointBegin, const size_t pointEnd)
+		{
+			SampleRange(pRecords, axes, pPositions, pointBegin, pointEnd, interpolation, useAvx2, copyBlock);
+		});
+	}
+	else
+	{
+		const bool useAvx2 = CpuFeatures::HasAvx2();
+		const float32_t* const pRecords = m_pData->floatRecords.data();
+
+		RunTasks(pointCount, pThreadPool, [&](const size_t pointBegin, const size_t pointEnd)
+		{
+			SampleRange(pRecords, axes, pPositions, pointBegin, pointEnd, interpolation, useAvx2, copyBlock);
+		});
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::IrradianceVolume::SampleIrradiance(
+	const float32_t* const pPositions,
+	const float32_t* const pNormals,
+	const size_t pointCount,
+	const Interpolation interpolation,
+	ThreadPool* const pThreadPool,
+	float32_t* const pOutColors) const
+{
+	if(!pPositions || !pNormals || !pOutColors || pointCount == 0 || GetProbeCount() == 0)
+	{
+		return;
+	}
+
+	auto reconstructBlock = [pNormals, pOutColors](const size_t blockBegin, const uint32_t blockPointCount, const ShProjection::Coefficients* const pBlock)
+	{
+		for(uint32_t lane = 0; lane < blockPointCount; ++lane)
+		{
+			const size_t pointIndex = blockBegin + lane;
+
+			ShProjection::ReconstructColor(pBlock[lane], pNormals + (pointIndex * 3), pOutColors + (pointIndex * 3));
+		}
+	};
+
+	GridAxes axes;
+	GetGridAxes(m_desc, axes);
+
+	if(m_desc.storage == Storage::Float16)
+	{
+		const bool useAvx2 = CpuFeatures::HasAvx2() && CpuFeatures::HasF16c();
+		const uint16_t* const pRecords = m_pData->halfRecords.data();
+
+		RunTasks(pointCount, pThreadPool, [&](const size_t pointBegin, const size_t pointEnd)
+		{
+			SampleRange(pRecords, axes, pPositions, pointBegin, pointEnd, interpolation, useAvx2, reconstructBlock);
+		});
+	}
+	else
+	{
+		const bool useAvx2 = CpuFeatures::HasAvx2();
+		const float32_t* const pRecords = m_pData->floatRecords.data();
+
+		RunTasks(pointCount, pThreadPool, [&](const size_t pointBegin, const size_t pointEnd)
+		{
+			SampleRange(pRecords, axes, pPositions, pointBegin, pointEnd, interpolation, useAvx2, reconstructBlock);
+		});
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::IrradianceVolume::GetTextureData(
+	const uint32_t textureIndex,
+	void* const pOutData,
+	const size_t rowPitch,
+	const size_t slicePitch) const
+{
+	const size_t texelSize = GetTexelSize();
+
+	if(textureIndex >= DF_IRRADIANCE_VOLUME_TEXTURE_COUNT
+		|| !pOutData
+		|| GetProbeCount() == 0
+		|| rowPitch < texelSize * m_desc.probeCount[0]
+		|| slicePitch < rowPitch * m_desc.probeCount[1])
+	{
+		return false;
+	}
+
+	// Each texel is 4 consecutive values of a record, so it's copied straight out of the record without conversion.
+	const size_t valueOffset = size_t(textureIndex) * 4;
+
+	uint8_t* const pOutBytes = reinterpret_cast<uint8_t*>(pOutData);
+
+	for(uint32_t z = 0; z < m_desc.probeCount[2]; ++z)
+	{
+		for(uint32_t y = 0; y < m_desc.probeCount[1]; ++y)
+		{
+			uint8_t* const pRow = pOutBytes + (slicePitch * z) + (rowPitch * y);
+			const size_t rowRecordOffset = _getProbeIndex(0, y, z) * DF_IRRADIANCE_VOLUME_RECORD_SIZE;
+
+			for(uint32_t x = 0; x < m_desc.probeCount[0]; ++x)
+			{
+				const size_t recordOffset = rowRecordOffset + (size_t(x) * DF_IRRADIANCE_VOLUME_RECORD_SIZE) + valueOffset;
+
+				if(m_desc.storage == Storage::Float16)
+				{
+					memcpy(pRow + (texelSize * x), m_pData->halfRecords.data() + recordOffset, texelSize);
+				}
+				else
+				{
+					memcpy(pRow + (texelSize * x), m_pData->floatRecords.data() + recordOffset, texelSize);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::IrradianceVolume::GetProbeSize() const
+{
+	return (m_desc.storage == Storage::Float16)
+		? (sizeof(uint16_t) * DF_IRRADIANCE_VOLUME_RECORD_SIZE)
+		: (sizeof(float32_t) * DF_IRRADIANCE_VOLUME_RECORD_SIZE);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
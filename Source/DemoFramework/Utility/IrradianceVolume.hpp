@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ShProjection.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Number of RGBA textures the coefficients of a volume are spread across on the GPU (27 values in 28 channels).
+#define DF_IRRADIANCE_VOLUME_TEXTURE_COUNT 7
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class IrradianceVolume;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Regular 3D grid of L2 spherical harmonic probes, each holding the same coefficients ShProjection produces for a
+// single reflection probe, so diffuse lighting can vary across a scene instead of coming from one global probe.
+//
+// Probes can be stored as 32-bit or 16-bit floats. Half storage is converted with PixelConvert, so a probe reads back
+// exactly as a half texture holding it would on the GPU. On the CPU, each probe is one record of 32 values (the 27
+// coefficients followed by zero padding), which is 2 cache lines in float storage and a single one in half storage.
+//
+// Lookups blend the probes around each sample point, either trilinearly from all 8 corners of the grid cell or
+// tetrahedrally from the 4 corners of the tetrahedron containing the point. Sample points are run through in blocks of
+// 8, with the cell and fractions of a whole block found at once, and each probe record is blended in 4 registers
+// using AVX2 (plus F16C for half storage) when the CPU supports it. Both paths do the same float operations in the
+// same order, so they give the same results. Points outside of the grid are clamped to its edge.
+//
+// For the GPU, GetTextureData() lays the coefficients out as DF_IRRADIANCE_VOLUME_TEXTURE_COUNT RGBA 3D textures the
+// size of the grid, which keeps each coefficient in the same texel of every texture so hardware trilinear filtering
+// gives the same blend as the CPU. Texture 'n' holds values [4n, 4n + 4) of the coefficients in red, green, blue,
+// coefficient order, as R32G32B32A32_FLOAT or R16G16B16A16_FLOAT texels depending on the storage.
+class DF_API DemoFramework::Utility::IrradianceVolume
+{
+public:
+
+	enum class Storage
+	{
+		Float32,
+		Float16,
+	};
+
+	enum class Interpolation
+	{
+		Trilinear,
+		Tetrahedral,
+	};
+
+	struct Desc
+	{
+		uint32_t probeCount[3];
+		float32_t origin[3];  // Position of the probe at index (0, 0, 0)
+		float32_t spacing[3]; // Distance between neighboring probes along each axis
+		Storage storage;
+	};
+
+	IrradianceVolume();
+	IrradianceVolume(const IrradianceVolume&) = delete;
+	IrradianceVolume(IrradianceVolume&&) = delete;
+	~IrradianceVolume();
+
+	IrradianceVolume& operator =(const IrradianceVolume&) = delete;
+	IrradianceVolume& operator =(IrradianceVolume&&) = delete;
+
+	// Resize the grid, setting every probe to zero.
+	bool Reset(const Desc& desc);
+
+	void SetProbe(uint32_t x, uint32_t y, uint32_t z, const ShProjection::Coefficients& coefficients);
+
+	// The coefficients of a probe as stored, which are rounded to half precision in half storage.
+	void GetProbe(uint32_t x, uint32_t y, uint32_t z, ShProjection::Coefficients& outCoefficients) const;
+
+	// Blend the probes around each point, with the points given as XYZ triplets. A null thread pool runs everything
+	// on the calling thread.
+	void Sample(
+		const float32_t* pPositions,
+		size_t pointCount,
+		Interpolation interpolation,
+		ThreadPool* pThreadPool,
+		ShProjection::Coefficients* pOutCoefficients) const;
+
+	// Irradiance at each point for the given normals, as sh-reconstruct would compute it from the blended probes.
+	// Positions, normals and colors are all XYZ or RGB triplets.
+	void SampleIrradiance(
+		const float32_t* pPositions,
+		const float32_t* pNormals,
+		size_t pointCount,
+		Interpolation interpolation,
+		ThreadPool* pThreadPool,
+		float32_t* pOutColors) const;
+
+	// Write one of the GPU textures to memory laid out with the given row and depth slice pitches in bytes.
+	bool GetTextureData(uint32_t textureIndex, void* pOutData, size_t rowPitch, size_t slicePitch) const;
+
+	// Size of a texel of the GPU textures in bytes.
+	uint32_t GetTexelSize() const;
+
+	// Size of a single probe in bytes, on the CPU and across all of the GPU textures.
+	size_t GetProbeSize() const;
+	size_t GetGpuProbeSize() const;
+
+	size_t GetProbeCount() const;
+	const Desc& GetDesc() const;
+
+
+private:
+
+	struct ProbeData;
+
+	size_t _getProbeIndex(uint32_t, uint32_t, uint32_t) const;
+
+	ProbeData* m_pData;
+
+	Desc m_desc;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::IrradianceVolume::GetTexelSize() const
+{
+	return (m_desc.storage == Storage::Float16) ? uint32_t(sizeof(uint16_t) * 4) : uint32_t(sizeof(float32_t) * 4);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::IrradianceVolume::GetGpuProbeSize() const
+{
+	return size_t(GetTexelSize()) * DF_IRRADIANCE_VOLUME_TEXTURE_COUNT;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::IrradianceVolume::GetProbeCount() const
+{
+	return size_t(m_desc.probeCount[0]) * size_t(m_desc.probeCount[1]) * size_t(m_desc.probeCount[2]);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::Utility::IrradianceVolume::Desc& DemoFramework::Utility::IrradianceVolume::GetDesc() const
+{
+	return m_desc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::IrradianceVolume::_getProbeIndex(const uint32_t x, const uint32_t y, const uint32_t z) const
+{
+	return size_t(x) + (size_t(m_desc.probeCount[0]) * (size_t(y) + (size_t(m_desc.probeCount[1]) * size_t(z))));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
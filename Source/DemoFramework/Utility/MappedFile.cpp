@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "MappedFile.hpp"
+
+#include "../Application/Log.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::MappedFile::~MappedFile()
+{
+	if(m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+
+	if(m_mapping)
+	{
+		CloseHandle(m_mapping);
+	}
+
+	if(m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::MappedFile::Ptr DemoFramework::Utility::MappedFile::Open(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<MappedFile>();
+
+	output->m_file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(output->m_file == INVALID_HANDLE_VALUE)
+	{
+		// Missing files are an expected case for callers probing caches, so don't log anything here.
+		return Ptr();
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(output->m_file, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		// Empty files cannot be mapped.
+		return Ptr();
+	}
+
+	output->m_size = uint64_t(fileSize.QuadPart);
+
+	output->m_mapping = CreateFileMappingA(output->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(!output->m_mapping)
+	{
+		LOG_ERROR("Failed to create file mapping: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	output->m_pData = reinterpret_cast<const uint8_t*>(MapViewOfFile(output->m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if(!output->m_pData)
+	{
+		LOG_ERROR("Failed to map view of file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
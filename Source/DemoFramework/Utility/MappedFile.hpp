@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class MappedFile;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Read-only view of an entire file mapped into the address space of the process.
+class DF_API DemoFramework::Utility::MappedFile
+{
+public:
+
+	typedef std::shared_ptr<MappedFile> Ptr;
+
+	MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	~MappedFile();
+
+	MappedFile& operator =(const MappedFile&) = delete;
+	MappedFile& operator =(MappedFile&&) = delete;
+
+	static Ptr Open(const char* filePath);
+
+	const uint8_t* GetData() const;
+	uint64_t GetSize() const;
+
+
+private:
+
+	HANDLE m_file;
+	HANDLE m_mapping;
+
+	const uint8_t* m_pData;
+	uint64_t m_size;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::Utility::MappedFile>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::MappedFile::MappedFile()
+	: m_file(INVALID_HANDLE_VALUE)
+	, m_mapping(nullptr)
+	, m_pData(nullptr)
+	, m_size(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const uint8_t* DemoFramework::Utility::MappedFile::GetData() const
+{
+	return m_pData;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::MappedFile::GetSize() const
+{
+	return m_size;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "MipStreamScheduler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::MipStreamScheduler::MipStreamScheduler()
+	: m_scheduler()
+	, m_mips()
+	, m_frameIndex(0)
+	, m_mipCount(0)
+	, m_residentMip(0)
+	, m_visibilityDelay(1)
+{
+	// Copies are always split on whole rows, so there's no reason to hold back a partial chunk of rows.
+	m_scheduler.SetMinChunkSize(1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::MipStreamScheduler::Reset(
+	const uint32_t mipCount,
+	const uint32_t residentMip,
+	const uint32_t visibilityDelay)
+{
+	if(mipCount == 0 || mipCount > DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT || residentMip >= mipCount)
+	{
+		return false;
+	}
+
+	m_scheduler.Clear();
+
+	for(uint32_t mipIndex = 0; mipIndex < DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT; ++mipIndex)
+	{
+		Mip& mip = m_mips[mipIndex];
+
+		mip.requestId = StreamScheduler::InvalidRequestId;
+		mip.rowPitch = 0;
+		mip.copiedFrame = 0;
+		mip.rowCount = 0;
+		mip.state = (mipIndex >= residentMip) ? MipState::Copied : MipState::Pending;
+	}
+
+	m_frameIndex = 0;
+	m_mipCount = mipCount;
+	m_residentMip = residentMip;
+	m_visibilityDelay = (visibilityDelay > 0) ? visibilityDelay : 1;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::MipStreamScheduler::SetMipLayout(
+	const uint32_t mipIndex,
+	const uint64_t rowPitch,
+	const uint32_t rowCount)
+{
+	if(mipIndex >= m_mipCount || rowPitch == 0 || rowCount == 0 || m_mips[mipIndex].state != MipState::Pending)
+	{
+		return false;
+	}
+
+	m_mips[mipIndex].rowPitch = rowPitch;
+	m_mips[mipIndex].rowCount = rowCount;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::MipStreamScheduler::MarkMipReady(const uint32_t mipIndex)
+{
+	if(mipIndex >= m_mipCount)
+	{
+		return false;
+	}
+
+	Mip& mip = m_mips[mipIndex];
+
+	if(mip.state != MipState::Pending || mip.rowCount == 0)
+	{
+		return false;
+	}
+
+	// Smaller mips (higher indices) get the lower priority values so they are uploaded first. Without
+	// that, a large mip marked ready early could hold up the clamp from dropping over the mips below it.
+	mip.requestId = m_scheduler.Enqueue(mip.rowPitch * mip.rowCount, -int32_t(mipIndex), mip.rowPitch);
+	mip.state = MipState::Ready;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::MipStreamScheduler::Update(
+	const uint64_t byteBudget,
+	RowCopy* const pOutCopies,
+	const size_t maxCopyCount)
+{
+	++m_frameIndex;
+
+	// Lower the clamp over every mip whose copies have had enough time to finish. The clamp only ever
+	// covers a contiguous range of mips, so this stops at the first mip that isn't there yet.
+	while(m_residentMip > 0)
+	{
+		const Mip& mip = m_mips[m_residentMip - 1];
+
+		if(mip.state != MipState::Copied || m_frameIndex < mip.copiedFrame + m_visibilityDelay)
+		{
+			break;
+		}
+
+		--m_residentMip;
+	}
+
+	if(!pOutCopies || maxCopyCount == 0)
+	{
+		return 0;
+	}
+
+	StreamScheduler::Chunk chunks[DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT];
+
+	const size_t chunkCount = m_scheduler.Schedule(
+		byteBudget,
+		chunks,
+		(maxCopyCount < DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT) ? maxCopyCount : DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT);
+
+	size_t copyCount = 0;
+
+	for(size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		const StreamScheduler::Chunk& chunk = chunks[chunkIndex];
+
+		for(uint32_t mipIndex = 0; mipIndex < m_mipCount; ++mipIndex)
+		{
+			Mip& mip = m_mips[mipIndex];
+
+			if(mip.state != MipState::Ready || mip.requestId != chunk.requestId)
+			{
+				continue;
+			}
+
+			// Chunks are aligned to the row pitch, so they always cover whole rows.
+			RowCopy& copy = pOutCopies[copyCount];
+
+			copy.mipIndex = mipIndex;
+			copy.firstRow = uint32_t(chunk.offset / mip.rowPitch);
+			copy.rowCount = uint32_t(chunk.size / mip.rowPitch);
+			copy.lastCopy = chunk.lastChunk;
+
+			++copyCount;
+
+			if(chunk.lastChunk)
+			{
+				mip.requestId = StreamScheduler::InvalidRequestId;
+				mip.copiedFrame = m_frameIndex;
+				mip.state = MipState::Copied;
+			}
+			break;
+		}
+	}
+
+	return copyCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "StreamScheduler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT 16
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class MipStreamScheduler;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Upload policy for textures streamed in from the mip tail upward. Mips are marked ready as their data becomes
+// available, then split into row ranges that fit a per-frame byte budget, smallest mip first. The most detailed
+// resident mip (i.e. the minimum LOD clamp) is only lowered over a mip once all of its rows have been copied and a
+// number of frames have passed for the copies to finish on the GPU. Like StreamScheduler, this never touches any GPU
+// objects; the caller records the copies it returns.
+class DF_API DemoFramework::Utility::MipStreamScheduler
+{
+public:
+
+	struct RowCopy
+	{
+		uint32_t mipIndex;
+		uint32_t firstRow;
+		uint32_t rowCount;
+		bool lastCopy; // True for the copy that completes the mip
+	};
+
+	MipStreamScheduler();
+	MipStreamScheduler(const MipStreamScheduler&) = delete;
+	MipStreamScheduler(MipStreamScheduler&&) = delete;
+
+	MipStreamScheduler& operator =(const MipStreamScheduler&) = delete;
+	MipStreamScheduler& operator =(MipStreamScheduler&&) = delete;
+
+	// Start over with a texture of 'mipCount' mips where every mip from 'residentMip' down is already resident. The
+	// visibility delay is the number of Update() calls to wait after a mip's last copy before the clamp is lowered
+	// over it; this should be at least the number of frames the GPU can run behind the CPU.
+	bool Reset(uint32_t mipCount, uint32_t residentMip, uint32_t visibilityDelay);
+
+	// Set the layout of a streamed mip in the source data. For block-compressed formats, each row is a row of blocks.
+	bool SetMipLayout(uint32_t mipIndex, uint64_t rowPitch, uint32_t rowCount);
+
+	// Queue a mip for upload. Only mips above the resident mip with a layout can be marked ready.
+	bool MarkMipReady(uint32_t mipIndex);
+
+	// Advance one frame and fill the output array with the row copies to record this frame. Returns the number of
+	// copies written. The array should have room for at least one copy per mip.
+	size_t Update(uint64_t byteBudget, RowCopy* pOutCopies, size_t maxCopyCount);
+
+	uint32_t GetResidentMip() const;
+	uint64_t GetPendingBytes() const;
+
+	bool IsFullyResident() const;
+
+
+private:
+
+	enum class MipState
+	{
+		Pending,
+		Ready,
+		Copied,
+	};
+
+	struct Mip
+	{
+		StreamScheduler::RequestId requestId;
+		uint64_t rowPitch;
+		uint64_t copiedFrame;
+		uint32_t rowCount;
+		MipState state;
+	};
+
+	StreamScheduler m_scheduler;
+
+	Mip m_mips[DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT];
+
+	uint64_t m_frameIndex;
+
+	uint32_t m_mipCount;
+	uint32_t m_residentMip;
+	uint32_t m_visibilityDelay;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::MipStreamScheduler::GetResidentMip() const
+{
+	return m_residentMip;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::MipStreamScheduler::GetPendingBytes() const
+{
+	return m_scheduler.GetPendingBytes();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::Utility::MipStreamScheduler::IsFullyResident() const
+{
+	return m_residentMip == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
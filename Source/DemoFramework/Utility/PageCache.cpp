@@ -0,0 +1,334 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "PageCache.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the slot list using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::Utility::PageCache::SlotList
+{
+	struct Slot
+	{
+		PageId pageId;
+		uint64_t lastUsedFrame;
+
+		// Links of the least recently used list. Free and pinned slots aren't in the list.
+		SlotIndex prev;
+		SlotIndex next;
+
+		bool pinned;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<SlotIndex> freeSlots;
+
+	std::unordered_map<PageId, SlotIndex> pageSlots;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::PageCache::PageCache()
+	: m_pSlots(new SlotList())
+	, m_head(VirtualPageTable::InvalidSlot)
+	, m_tail(VirtualPageTable::InvalidSlot)
+	, m_usedCount(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::PageCache::~PageCache()
+{
+	if(m_pSlots)
+	{
+		delete m_pSlots;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::PageCache::Reset(const uint32_t slotCount)
+{
+	const SlotList::Slot emptySlot =
+	{
+		VirtualPageTable::InvalidPageId, // PageId pageId
+		0,                               // uint64_t lastUsedFrame
+		VirtualPageTable::InvalidSlot,   // SlotIndex prev
+		VirtualPageTable::InvalidSlot,   // SlotIndex next
+		false,                           // bool pinned
+	};
+
+	m_pSlots->slots.assign(slotCount, emptySlot);
+	m_pSlots->freeSlots.resize(slotCount);
+	m_pSlots->pageSlots.clear();
+	m_pSlots->pageSlots.reserve(slotCount);
+
+	// Free slots are taken from the back, so the list is reversed to hand out the lowest slots first.
+	for(uint32_t index = 0; index < slotCount; ++index)
+	{
+		m_pSlots->freeSlots[index] = slotCount - index - 1;
+	}
+
+	m_head = VirtualPageTable::InvalidSlot;
+	m_tail = VirtualPageTable::InvalidSlot;
+	m_usedCount = 0;
+
+	return slotCount > 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::PageCache::SlotIndex DemoFramework::Utility::PageCache::Find(const PageId pageId) const
+{
+	const auto it = m_pSlots->pageSlots.find(pageId);
+
+	return (it != m_pSlots->pageSlots.end()) ? it->second : VirtualPageTable::InvalidSlot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::Touch(const SlotIndex slot, const uint64_t frameIndex)
+{
+	if(slot >= m_pSlots->slots.size() || m_pSlots->slots[slot].pageId == VirtualPageTable::InvalidPageId)
+	{
+		return;
+	}
+
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	entry.lastUsedFrame = frameIndex;
+
+	if(!entry.pinned && m_head != slot)
+	{
+		_unlink(slot);
+		_pushFront(slot);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::PageCache::SlotIndex DemoFramework::Utility::PageCache::Allocate(
+	const PageId pageId,
+	const uint64_t frameIndex,
+	PageId& outEvictedPageId)
+{
+	outEvictedPageId = VirtualPageTable::InvalidPageId;
+
+	if(pageId == VirtualPageTable::InvalidPageId || m_pSlots->pageSlots.count(pageId) > 0)
+	{
+		return VirtualPageTable::InvalidSlot;
+	}
+
+	SlotIndex slot = VirtualPageTable::InvalidSlot;
+
+	if(!m_pSlots->freeSlots.empty())
+	{
+		slot = m_pSlots->freeSlots.back();
+		m_pSlots->freeSlots.pop_back();
+
+		++m_usedCount;
+	}
+	else
+	{
+		// The list is ordered by when each page was last used, so when the least recently used page was used on this
+		// frame, so was every other page in the list.
+		if(m_tail == VirtualPageTable::InvalidSlot || m_pSlots->slots[m_tail].lastUsedFrame >= frameIndex)
+		{
+			return VirtualPageTable::InvalidSlot;
+		}
+
+		slot = m_tail;
+		outEvictedPageId = m_pSlots->slots[slot].pageId;
+
+		_unlink(slot);
+		m_pSlots->pageSlots.erase(outEvictedPageId);
+	}
+
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	entry.pageId = pageId;
+	entry.lastUsedFrame = frameIndex;
+	entry.pinned = false;
+
+	_pushFront(slot);
+	m_pSlots->pageSlots[pageId] = slot;
+
+	return slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::Free(const SlotIndex slot)
+{
+	if(slot >= m_pSlots->slots.size() || m_pSlots->slots[slot].pageId == VirtualPageTable::InvalidPageId)
+	{
+		return;
+	}
+
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	if(!entry.pinned)
+	{
+		_unlink(slot);
+	}
+
+	m_pSlots->pageSlots.erase(entry.pageId);
+	m_pSlots->freeSlots.push_back(slot);
+
+	entry.pageId = VirtualPageTable::InvalidPageId;
+	entry.pinned = false;
+
+	--m_usedCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::SetPinned(const SlotIndex slot, const bool pinned)
+{
+	if(slot >= m_pSlots->slots.size() || m_pSlots->slots[slot].pageId == VirtualPageTable::InvalidPageId)
+	{
+		return;
+	}
+
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	if(entry.pinned == pinned)
+	{
+		return;
+	}
+
+	entry.pinned = pinned;
+
+	if(pinned)
+	{
+		_unlink(slot);
+	}
+	else
+	{
+		// Allocate() relies on the list being ordered by when each page was last used, and the page may not have been
+		// used for a while, so it can't just go to the front.
+		_insertByLastUsedFrame(slot);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::PageCache::PageId DemoFramework::Utility::PageCache::GetPage(const SlotIndex slot) const
+{
+	return (slot < m_pSlots->slots.size()) ? m_pSlots->slots[slot].pageId : VirtualPageTable::InvalidPageId;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::PageCache::GetSlotCount() const
+{
+	return uint32_t(m_pSlots->slots.size());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::_unlink(const SlotIndex slot)
+{
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	if(entry.prev != VirtualPageTable::InvalidSlot)
+	{
+		m_pSlots->slots[entry.prev].next = entry.next;
+	}
+	else if(m_head == slot)
+	{
+		m_head = entry.next;
+	}
+
+	if(entry.next != VirtualPageTable::InvalidSlot)
+	{
+		m_pSlots->slots[entry.next].prev = entry.prev;
+	}
+	else if(m_tail == slot)
+	{
+		m_tail = entry.prev;
+	}
+
+	entry.prev = VirtualPageTable::InvalidSlot;
+	entry.next = VirtualPageTable::InvalidSlot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::_pushFront(const SlotIndex slot)
+{
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	entry.prev = VirtualPageTable::InvalidSlot;
+	entry.next = m_head;
+
+	if(m_head != VirtualPageTable::InvalidSlot)
+	{
+		m_pSlots->slots[m_head].prev = slot;
+	}
+
+	m_head = slot;
+
+	if(m_tail == VirtualPageTable::InvalidSlot)
+	{
+		m_tail = slot;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PageCache::_insertByLastUsedFrame(const SlotIndex slot)
+{
+	SlotList::Slot& entry = m_pSlots->slots[slot];
+
+	// Find the least recently used slot that was used after this one. Slots used on the same frame count as older,
+	// the same as when a page is touched.
+	SlotIndex prev = m_tail;
+
+	while(prev != VirtualPageTable::InvalidSlot && m_pSlots->slots[prev].lastUsedFrame <= entry.lastUsedFrame)
+	{
+		prev = m_pSlots->slots[prev].prev;
+	}
+
+	if(prev == VirtualPageTable::InvalidSlot)
+	{
+		_pushFront(slot);
+		return;
+	}
+
+	SlotList::Slot& prevEntry = m_pSlots->slots[prev];
+
+	entry.prev = prev;
+	entry.next = prevEntry.next;
+
+	if(prevEntry.next != VirtualPageTable::InvalidSlot)
+	{
+		m_pSlots->slots[prevEntry.next].prev = slot;
+	}
+	else
+	{
+		m_tail = slot;
+	}
+
+	prevEntry.next = slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
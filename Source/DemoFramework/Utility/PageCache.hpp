@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "VirtualPageTable.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class PageCache;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Tracks which virtual page lives in each slot of a fixed-size physical page cache, and which slot to reuse next. Slots
+// are kept in least recently used order, so every operation other than unpinning is constant time. Pages used on the
+// current frame are never evicted to make room for another page, since that would only trade one missing page for
+// another, and pinned slots are never evicted at all. Like the page table, this only does the bookkeeping.
+class DF_API DemoFramework::Utility::PageCache
+{
+public:
+
+	typedef VirtualPageTable::PageId PageId;
+	typedef VirtualPageTable::SlotIndex SlotIndex;
+
+	PageCache();
+	PageCache(const PageCache&) = delete;
+	PageCache(PageCache&&) = delete;
+	~PageCache();
+
+	PageCache& operator =(const PageCache&) = delete;
+	PageCache& operator =(PageCache&&) = delete;
+
+	// Empty the cache and resize it to the given number of slots.
+	bool Reset(uint32_t slotCount);
+
+	// Get the slot holding a page, or an invalid slot when the page isn't cached.
+	SlotIndex Find(PageId pageId) const;
+
+	// Mark the page in a slot as used on the given frame, making it the most recently used.
+	void Touch(SlotIndex slot, uint64_t frameIndex);
+
+	// Get a slot for a new page, either a free one or the least recently used page that wasn't used on 'frameIndex'.
+	// The page previously held by the slot is written to 'outEvictedPageId' (or an invalid page ID when the slot was
+	// free), and should be removed from the page table. Returns an invalid slot when no slot can be reused this frame.
+	SlotIndex Allocate(PageId pageId, uint64_t frameIndex, PageId& outEvictedPageId);
+
+	// Release the page in a slot, making the slot free.
+	void Free(SlotIndex slot);
+
+	// Pinned slots are never evicted. Unpinning a slot puts it back in the order of when its page was last used, which
+	// means walking the list from the least recently used end.
+	void SetPinned(SlotIndex slot, bool pinned);
+
+	PageId GetPage(SlotIndex slot) const;
+
+	uint32_t GetSlotCount() const;
+	uint32_t GetUsedCount() const;
+
+
+private:
+
+	struct SlotList;
+
+	void _unlink(SlotIndex);
+	void _pushFront(SlotIndex);
+	void _insertByLastUsedFrame(SlotIndex);
+
+	SlotList* m_pSlots;
+
+	SlotIndex m_head; // Most recently used
+	SlotIndex m_tail; // Least recently used
+
+	uint32_t m_usedCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::PageCache::GetUsedCount() const
+{
+	return m_usedCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
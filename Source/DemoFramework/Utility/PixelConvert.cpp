@@ -0,0 +1,1212 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "PixelConvert.hpp"
+#include "CpuFeatures.hpp"
+
+#include <math.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The sRGB encode table covers [2^-13, 1] with one bucket per 8 mantissa bits of each float exponent. Anything below
+// 2^-13 encodes to zero, since the first rounding threshold is at roughly 1.5 * 2^-13.
+#define DF_PIXEL_CONVERT_SRGB_MIN_EXPONENT -13
+#define DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT 15
+#define DF_PIXEL_CONVERT_SRGB_FIRST_BUCKET (uint32_t(127 + DF_PIXEL_CONVERT_SRGB_MIN_EXPONENT) << (23 - DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT))
+#define DF_PIXEL_CONVERT_SRGB_BUCKET_COUNT ((uint32_t(-DF_PIXEL_CONVERT_SRGB_MIN_EXPONENT) << (23 - DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT)) + 1)
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	struct SrgbTables
+	{
+		float decode[256];
+
+		// Each encode bucket holds at most one rounding threshold, so the code for a value in the bucket is the base
+		// code plus one if the value is at or above the threshold.
+		int32_t encodeBase[DF_PIXEL_CONVERT_SRGB_BUCKET_COUNT];
+		float encodeThreshold[DF_PIXEL_CONVERT_SRGB_BUCKET_COUNT];
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t FloatToBits(const float value)
+{
+	uint32_t output;
+	memcpy(&output, &value, sizeof(output));
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float BitsToFloat(const uint32_t bits)
+{
+	float output;
+	memcpy(&output, &bits, sizeof(output));
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Clamp to [minValue, maxValue], written so NaN fails the comparison and ends up at the minimum. This is the same
+// result as max() followed by min() with the SIMD instructions, which return the second operand when either is NaN.
+static float ClampValue(const float value, const float minValue, const float maxValue)
+{
+	return (value > minValue) ? ((value < maxValue) ? value : maxValue) : minValue;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static double LinearToSrgb(const double value)
+{
+	return (value <= 0.0031308)
+		? value * 12.92
+		: (1.055 * pow(value, 1.0 / 2.4)) - 0.055;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static double SrgbToLinear(const double value)
+{
+	return (value <= 0.04045)
+		? value / 12.92
+		: pow((value + 0.055) / 1.055, 2.4);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static SrgbTables BuildSrgbTables()
+{
+	SrgbTables output;
+
+	for(uint32_t i = 0; i < 256; ++i)
+	{
+		output.decode[i] = float(SrgbToLinear(double(i) / 255.0));
+	}
+
+	// Find the smallest float that rounds up to each code, by binary search over the bit patterns in [0, 1]. This
+	// makes the encoder exactly round(LinearToSrgb(x) * 255) evaluated in double precision.
+	float thresholds[255];
+
+	for(uint32_t code = 0; code < 255; ++code)
+	{
+		const double target = double(code) + 0.5;
+
+		uint32_t low = 0;
+		uint32_t high = FloatToBits(1.0f);
+
+		while(low < high)
+		{
+			const uint32_t middle = low + ((high - low) / 2);
+
+			if((LinearToSrgb(double(BitsToFloat(middle))) * 255.0) >= target)
+			{
+				high = middle;
+			}
+			else
+			{
+				low = middle + 1;
+			}
+		}
+
+		thresholds[code] = BitsToFloat(low);
+	}
+
+	uint32_t baseCode = 0;
+
+	for(uint32_t bucket = 0; bucket < DF_PIXEL_CONVERT_SRGB_BUCKET_COUNT; ++bucket)
+	{
+		const float bucketStart = BitsToFloat((bucket + DF_PIXEL_CONVERT_SRGB_FIRST_BUCKET) << DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT);
+
+		while(baseCode < 255 && thresholds[baseCode] <= bucketStart)
+		{
+			++baseCode;
+		}
+
+		output.encodeBase[bucket] = int32_t(baseCode);
+		output.encodeThreshold[bucket] = (baseCode < 255) ? thresholds[baseCode] : 2.0f;
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const SrgbTables& GetSrgbTables()
+{
+	static const SrgbTables tables = BuildSrgbTables();
+
+	return tables;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Shared by the 11-bit and 10-bit channels of R11G11B10, which have a 5-bit exponent with the same bias as a half
+// float and no sign bit.
+static float SmallFloatToFloat(const uint32_t value, const uint32_t mantissaBits)
+{
+	const uint32_t exponent = value >> mantissaBits;
+	const uint32_t mantissa = value & ((1u << mantissaBits) - 1);
+
+	if(exponent == 0)
+	{
+		return float(mantissa) * BitsToFloat((127 - 14 - mantissaBits) << 23);
+	}
+
+	const uint32_t exponentBits = (exponent == 31) ? 0xFF : (exponent + 112);
+
+	return BitsToFloat((exponentBits << 23) | (mantissa << (23 - mantissaBits)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Round to nearest even. Values below 2^-14 are denormal in the small format; adding a power of two whose ULP is the
+// denormal step size makes the float adder do the rounding and leaves the mantissa in the low bits.
+static uint32_t FloatToSmallFloat(const float value, const float maxValue, const uint32_t mantissaBits)
+{
+	const uint32_t shift = 23 - mantissaBits;
+	const uint32_t bits = FloatToBits(ClampValue(value, 0.0f, maxValue));
+
+	if(bits < (113u << 23))
+	{
+		const float bias = BitsToFloat((127 + 9 - mantissaBits) << 23);
+
+		return FloatToBits(BitsToFloat(bits) + bias) - FloatToBits(bias);
+	}
+
+	return (bits - (112u << 23) + ((1u << (shift - 1)) - 1) + ((bits >> shift) & 1)) >> shift;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float UnormToFloatScalar(const uint8_t value)
+{
+	return float(value) * (1.0f / 255.0f);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Converting through the SSE instruction rounds to nearest even, like the AVX2 kernel, and keeps the compiler from
+// fusing the multiply into anything that would round differently.
+static uint8_t FloatToUnormScalar(const float value)
+{
+	return uint8_t(_mm_cvtss_si32(_mm_set_ss(ClampValue(value, 0.0f, 1.0f) * 255.0f)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint8_t FloatToSrgbScalar(const SrgbTables& tables, const float value)
+{
+	const float clamped = ClampValue(value, BitsToFloat(uint32_t(127 + DF_PIXEL_CONVERT_SRGB_MIN_EXPONENT) << 23), 1.0f);
+	const uint32_t bucket = (FloatToBits(clamped) >> DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT) - DF_PIXEL_CONVERT_SRGB_FIRST_BUCKET;
+
+	return uint8_t(tables.encodeBase[bucket] + ((clamped >= tables.encodeThreshold[bucket]) ? 1 : 0));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float DemoFramework::Utility::PixelConvert::HalfToFloat(const uint16_t value)
+{
+	const uint32_t sign = uint32_t(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	const uint32_t mantissa = value & 0x3FF;
+
+	if(exponent == 0)
+	{
+		// Zero or denormal; let the float multiply normalize it.
+		return BitsToFloat(FloatToBits(float(mantissa) * (1.0f / 16777216.0f)) | sign);
+	}
+
+	if(exponent == 31)
+	{
+		// F16C quiets signaling NaNs, so do the same here.
+		return BitsToFloat(sign | 0x7F800000 | ((mantissa != 0) ? 0x400000 : 0) | (mantissa << 13));
+	}
+
+	return BitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint16_t DemoFramework::Utility::PixelConvert::FloatToHalf(const float value)
+{
+	const uint32_t inputBits = FloatToBits(value);
+
+	if((inputBits & 0x7FFFFFFF) > 0x7F800000)
+	{
+		return 0;
+	}
+
+	const uint32_t sign = (inputBits >> 16) & 0x8000;
+	const uint32_t bits = FloatToBits(fminf(BitsToFloat(inputBits & 0x7FFFFFFF), HalfMax));
+
+	const int32_t exponent = int32_t(bits >> 23) - 127 + 15;
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	if(exponent <= 0)
+	{
+		if(exponent < -10)
+		{
+			return uint16_t(sign);
+		}
+
+		// Denormal half; shift the implicit leading one into the mantissa.
+		mantissa |= 0x800000;
+
+		const uint32_t shift = uint32_t(14 - exponent);
+		const uint32_t halfBit = 1u << (shift - 1);
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+
+		uint32_t output = mantissa >> shift;
+
+		if(remainder > halfBit || (remainder == halfBit && (output & 1) != 0))
+		{
+			++output;
+		}
+
+		return uint16_t(sign | output);
+	}
+
+	uint32_t output = (uint32_t(exponent) << 10) | (mantissa >> 13);
+
+	const uint32_t remainder = mantissa & 0x1FFF;
+
+	if(remainder > 0x1000 || (remainder == 0x1000 && (output & 1) != 0))
+	{
+		++output;
+	}
+
+	return uint16_t(sign | output);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float DemoFramework::Utility::PixelConvert::UnormToFloat(const uint8_t value)
+{
+	return UnormToFloatScalar(value);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint8_t DemoFramework::Utility::PixelConvert::FloatToUnorm(const float value)
+{
+	return FloatToUnormScalar(value);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float DemoFramework::Utility::PixelConvert::SrgbToFloat(const uint8_t value)
+{
+	return GetSrgbTables().decode[value];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint8_t DemoFramework::Utility::PixelConvert::FloatToSrgb(const float value)
+{
+	return FloatToSrgbScalar(GetSrgbTables(), value);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::SharedExponentToFloat(const uint32_t texel, float* const pOutRgb)
+{
+	// 2^(exponent - 24) never leaves the range of normal floats.
+	const float scale = BitsToFloat(((texel >> 27) + 103) << 23);
+
+	pOutRgb[0] = float(texel & 0x1FF) * scale;
+	pOutRgb[1] = float((texel >> 9) & 0x1FF) * scale;
+	pOutRgb[2] = float((texel >> 18) & 0x1FF) * scale;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Follows the RGB9E5 conversion rules from the D3D functional spec: the shared exponent is picked from the largest
+// channel, and bumped up by one if rounding that channel's mantissa would overflow 9 bits. Every scale is a power of
+// two, so the multiplies are exact and only the floor(x + 0.5) rounds.
+uint32_t DemoFramework::Utility::PixelConvert::FloatToSharedExponent(const float* const pRgb)
+{
+	const float red = ClampValue(pRgb[0], 0.0f, SharedExponentMax);
+	const float green = ClampValue(pRgb[1], 0.0f, SharedExponentMax);
+	const float blue = ClampValue(pRgb[2], 0.0f, SharedExponentMax);
+
+	const float maxChannel = fmaxf(red, fmaxf(green, blue));
+
+	// The biased float exponent of the largest channel gives floor(log2(maxChannel)) + 127, and the shared exponent
+	// is max(floor(log2(maxChannel)), -16) + 16.
+	const int32_t biasedExponent = int32_t(FloatToBits(maxChannel) >> 23);
+
+	uint32_t sharedExponent = uint32_t((biasedExponent > 111) ? (biasedExponent - 111) : 0);
+	float scale = BitsToFloat((151 - sharedExponent) << 23);
+
+	if(uint32_t(floorf((maxChannel * scale) + 0.5f)) == 512)
+	{
+		++sharedExponent;
+		scale = BitsToFloat((151 - sharedExponent) << 23);
+	}
+
+	return (sharedExponent << 27)
+		| (uint32_t(floorf((blue * scale) + 0.5f)) << 18)
+		| (uint32_t(floorf((green * scale) + 0.5f)) << 9)
+		| uint32_t(floorf((red * scale) + 0.5f));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::R11G11B10ToFloat(const uint32_t texel, float* const pOutRgb)
+{
+	pOutRgb[0] = SmallFloatToFloat(texel & 0x7FF, 6);
+	pOutRgb[1] = SmallFloatToFloat((texel >> 11) & 0x7FF, 6);
+	pOutRgb[2] = SmallFloatToFloat(texel >> 22, 5);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::PixelConvert::FloatToR11G11B10(const float* const pRgb)
+{
+	return FloatToSmallFloat(pRgb[0], Float11Max, 6)
+		| (FloatToSmallFloat(pRgb[1], Float11Max, 6) << 11)
+		| (FloatToSmallFloat(pRgb[2], Float10Max, 5) << 22);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::RgbeToFloat(const uint8_t* const pRgbe, float* const pOutRgb)
+{
+	const float scale = GetRgbeScale(pRgbe[3]);
+
+	pOutRgb[0] = float(pRgbe[0]) * scale;
+	pOutRgb[1] = float(pRgbe[1]) * scale;
+	pOutRgb[2] = float(pRgbe[2]) * scale;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Matches the Radiance encoder: the exponent is frexp() of the largest channel and the mantissas are truncated. That
+// exponent is the biased float exponent minus 126, which makes the stored exponent the biased float exponent plus 2.
+// Texels that would need an exponent the decoder flushes to zero are written as black.
+void DemoFramework::Utility::PixelConvert::FloatToRgbe(const float* const pRgb, uint8_t* const pOutRgbe)
+{
+	const float red = ClampValue(pRgb[0], 0.0f, RgbeMax);
+	const float green = ClampValue(pRgb[1], 0.0f, RgbeMax);
+	const float blue = ClampValue(pRgb[2], 0.0f, RgbeMax);
+
+	const uint32_t biasedExponent = FloatToBits(fmaxf(red, fmaxf(green, blue))) >> 23;
+
+	if(biasedExponent < 8)
+	{
+		memset(pOutRgbe, 0, 4);
+		return;
+	}
+
+	const float scale = BitsToFloat((261 - biasedExponent) << 23);
+
+	pOutRgbe[0] = uint8_t(red * scale);
+	pOutRgbe[1] = uint8_t(green * scale);
+	pOutRgbe[2] = uint8_t(blue * scale);
+	pOutRgbe[3] = uint8_t(biasedExponent + 2);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float DemoFramework::Utility::PixelConvert::GetRgbeScale(const uint32_t exponent)
+{
+	// The value of each channel is mantissa * 2^(exponent - 136), so the biased float exponent is (exponent - 9).
+	return BitsToFloat((exponent > 9) ? ((exponent - 9) << 23) : 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Scalar kernels
+//---------------------------------------------------------------------------------------------------------------------
+
+static void HalfToFloatScalar(const uint16_t* const pSrc, float* const pDst, const size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = DemoFramework::Utility::PixelConvert::HalfToFloat(pSrc[i]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToHalfScalar(const float* const pSrc, uint16_t* const pDst, const size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = DemoFramework::Utility::PixelConvert::FloatToHalf(pSrc[i]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void UnormToFloatScalar(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = UnormToFloatScalar(pSrc[i]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToUnormScalar(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = FloatToUnormScalar(pSrc[i]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SrgbToFloatScalar(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = tables.decode[pSrc[i]];
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToSrgbScalar(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		pDst[i] = FloatToSrgbScalar(tables, pSrc[i]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SharedExponentToFloatScalar(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		DemoFramework::Utility::PixelConvert::SharedExponentToFloat(pSrc[i], pDst + (i * 3));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToSharedExponentScalar(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		pDst[i] = DemoFramework::Utility::PixelConvert::FloatToSharedExponent(pSrc + (i * 3));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void R11G11B10ToFloatScalar(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		DemoFramework::Utility::PixelConvert::R11G11B10ToFloat(pSrc[i], pDst + (i * 3));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToR11G11B10Scalar(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		pDst[i] = DemoFramework::Utility::PixelConvert::FloatToR11G11B10(pSrc + (i * 3));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void RgbeToFloatScalar(const uint8_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		DemoFramework::Utility::PixelConvert::RgbeToFloat(pSrc + (i * 4), pDst + (i * 3));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToRgbeScalar(const float* const pSrc, uint8_t* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		DemoFramework::Utility::PixelConvert::FloatToRgbe(pSrc + (i * 3), pDst + (i * 4));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatRgbToUnormRgbaScalar(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		const float* const pRgb = pSrc + (i * 3);
+
+		pDst[i] = 0xFF000000
+			| (uint32_t(FloatToUnormScalar(pRgb[2])) << 16)
+			| (uint32_t(FloatToUnormScalar(pRgb[1])) << 8)
+			| uint32_t(FloatToUnormScalar(pRgb[0]));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// AVX2 kernels
+//
+// These are only ever called after checking CpuFeatures::HasAvx2(). Each one converts 8 values or texels at a time
+// and hands the remainder to the scalar kernel.
+//---------------------------------------------------------------------------------------------------------------------
+
+// Split 8 interleaved RGB texels into one register per channel.
+static void LoadRgbAvx2(const float* const pSrc, __m256& outRed, __m256& outGreen, __m256& outBlue)
+{
+	const __m256 first = _mm256_loadu_ps(pSrc);
+	const __m256 second = _mm256_loadu_ps(pSrc + 8);
+	const __m256 third = _mm256_loadu_ps(pSrc + 16);
+
+	// Blending puts each channel's values in every third slot, and the permutes sort them back into texel order.
+	const __m256 red = _mm256_blend_ps(_mm256_blend_ps(first, second, 0x92), third, 0x24);
+	const __m256 green = _mm256_blend_ps(_mm256_blend_ps(first, second, 0x24), third, 0x49);
+	const __m256 blue = _mm256_blend_ps(_mm256_blend_ps(first, second, 0x49), third, 0x92);
+
+	outRed = _mm256_permutevar8x32_ps(red, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+	outGreen = _mm256_permutevar8x32_ps(green, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+	outBlue = _mm256_permutevar8x32_ps(blue, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The reverse of LoadRgbAvx2().
+static void StoreRgbAvx2(float* const pDst, const __m256 red, const __m256 green, const __m256 blue)
+{
+	const __m256 redSlots = _mm256_permutevar8x32_ps(red, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+	const __m256 greenSlots = _mm256_permutevar8x32_ps(green, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+	const __m256 blueSlots = _mm256_permutevar8x32_ps(blue, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+
+	_mm256_storeu_ps(pDst, _mm256_blend_ps(_mm256_blend_ps(redSlots, greenSlots, 0x92), blueSlots, 0x24));
+	_mm256_storeu_ps(pDst + 8, _mm256_blend_ps(_mm256_blend_ps(blueSlots, redSlots, 0x92), greenSlots, 0x24));
+	_mm256_storeu_ps(pDst + 16, _mm256_blend_ps(_mm256_blend_ps(greenSlots, blueSlots, 0x92), redSlots, 0x24));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Same as ClampValue(); max() returns the second operand for NaN, so it has to come first.
+static __m256 ClampAvx2(const __m256 values, const __m256 minValue, const __m256 maxValue)
+{
+	return _mm256_min_ps(_mm256_max_ps(values, minValue), maxValue);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256i FloatToUnormAvx2(const __m256 values)
+{
+	const __m256 clamped = ClampAvx2(values, _mm256_setzero_ps(), _mm256_set1_ps(1.0f));
+
+	return _mm256_cvtps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(255.0f)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void StoreBytesAvx2(uint8_t* const pDst, const __m256i values)
+{
+	const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+	const __m128i bytes = _mm_packus_epi16(words, words);
+
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(pDst), bytes);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256 SmallFloatToFloatAvx2(const __m256i values, const uint32_t mantissaBits)
+{
+	const __m256i exponentMask = _mm256_set1_epi32(0x1F << mantissaBits);
+	const __m256i exponent = _mm256_and_si256(values, exponentMask);
+
+	const __m256i isDenormal = _mm256_cmpeq_epi32(exponent, _mm256_setzero_si256());
+	const __m256i isSpecial = _mm256_cmpeq_epi32(exponent, exponentMask);
+
+	// Rebasing the exponent is a single add, except for infinity and NaN which need to land on 0xFF instead.
+	const __m256i rebase = _mm256_blendv_epi8(_mm256_set1_epi32(112 << 23), _mm256_set1_epi32(224 << 23), isSpecial);
+	const __m256i normal = _mm256_add_epi32(_mm256_slli_epi32(values, int(23 - mantissaBits)), rebase);
+
+	const __m256 denormal = _mm256_mul_ps(
+		_mm256_cvtepi32_ps(values),
+		_mm256_castsi256_ps(_mm256_set1_epi32(int((127 - 14 - mantissaBits) << 23))));
+
+	return _mm256_blendv_ps(_mm256_castsi256_ps(normal), denormal, _mm256_castsi256_ps(isDenormal));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static __m256i FloatToSmallFloatAvx2(const __m256 values, const float maxValue, const uint32_t mantissaBits)
+{
+	const int shift = int(23 - mantissaBits);
+
+	const __m256 clamped = ClampAvx2(values, _mm256_setzero_ps(), _mm256_set1_ps(maxValue));
+	const __m256i bits = _mm256_castps_si256(clamped);
+
+	const __m256 bias = _mm256_castsi256_ps(_mm256_set1_epi32(int((127 + 9 - mantissaBits) << 23)));
+	const __m256i denormal = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(clamped, bias)), _mm256_castps_si256(bias));
+
+	const __m256i roundBits = _mm256_add_epi32(
+		_mm256_set1_epi32(((1 << (shift - 1)) - 1) - (112 << 23)),
+		_mm256_and_si256(_mm256_srli_epi32(bits, shift), _mm256_set1_epi32(1)));
+
+	const __m256i normal = _mm256_srli_epi32(_mm256_add_epi32(bits, roundBits), shift);
+	const __m256i isDenormal = _mm256_cmpgt_epi32(_mm256_set1_epi32(113 << 23), bits);
+
+	return _mm256_blendv_epi8(normal, denormal, isDenormal);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Half float conversions; these also need CpuFeatures::HasF16c().
+static void HalfToFloatF16c(const uint16_t* const pSrc, float* const pDst, const size_t count)
+{
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+
+		_mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(halves));
+	}
+
+	HalfToFloatScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToHalfF16c(const float* const pSrc, uint16_t* const pDst, const size_t count)
+{
+	const __m256 minValue = _mm256_set1_ps(-DemoFramework::Utility::PixelConvert::HalfMax);
+	const __m256 maxValue = _mm256_set1_ps(DemoFramework::Utility::PixelConvert::HalfMax);
+
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256 values = _mm256_loadu_ps(pSrc + i);
+
+		// Zero out NaN before clamping, since the clamp would turn it into -HalfMax.
+		const __m256 ordered = _mm256_and_ps(values, _mm256_cmp_ps(values, values, _CMP_ORD_Q));
+		const __m256 clamped = _mm256_min_ps(_mm256_max_ps(ordered, minValue), maxValue);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm256_cvtps_ph(clamped, _MM_FROUND_TO_NEAREST_INT));
+	}
+
+	FloatToHalfScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void UnormToFloatAvx2(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i));
+		const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+
+		_mm256_storeu_ps(pDst + i, _mm256_mul_ps(values, scale));
+	}
+
+	UnormToFloatScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToUnormAvx2(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		StoreBytesAvx2(pDst + i, FloatToUnormAvx2(_mm256_loadu_ps(pSrc + i)));
+	}
+
+	FloatToUnormScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SrgbToFloatAvx2(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i)));
+
+		_mm256_storeu_ps(pDst + i, _mm256_i32gather_ps(tables.decode, indices, 4));
+	}
+
+	SrgbToFloatScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToSrgbAvx2(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	const SrgbTables& tables = GetSrgbTables();
+
+	const __m256 minValue = _mm256_castsi256_ps(_mm256_set1_epi32((127 + DF_PIXEL_CONVERT_SRGB_MIN_EXPONENT) << 23));
+	const __m256 maxValue = _mm256_set1_ps(1.0f);
+	const __m256i firstBucket = _mm256_set1_epi32(DF_PIXEL_CONVERT_SRGB_FIRST_BUCKET);
+
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256 clamped = ClampAvx2(_mm256_loadu_ps(pSrc + i), minValue, maxValue);
+		const __m256i bucket = _mm256_sub_epi32(
+			_mm256_srli_epi32(_mm256_castps_si256(clamped), DF_PIXEL_CONVERT_SRGB_BUCKET_SHIFT),
+			firstBucket);
+
+		const __m256i base = _mm256_i32gather_epi32(tables.encodeBase, bucket, 4);
+		const __m256 threshold = _mm256_i32gather_ps(tables.encodeThreshold, bucket, 4);
+
+		// The comparison mask is -1 where the value reached the threshold.
+		const __m256i roundUp = _mm256_castps_si256(_mm256_cmp_ps(clamped, threshold, _CMP_GE_OQ));
+
+		StoreBytesAvx2(pDst + i, _mm256_sub_epi32(base, roundUp));
+	}
+
+	FloatToSrgbScalar(pSrc + i, pDst + i, count - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SharedExponentToFloatAvx2(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	const __m256i mantissaMask = _mm256_set1_epi32(0x1FF);
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		const __m256i texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+		const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_srli_epi32(texels, 27), _mm256_set1_epi32(103)), 23));
+
+		const __m256 red = _mm256_cvtepi32_ps(_mm256_and_si256(texels, mantissaMask));
+		const __m256 green = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 9), mantissaMask));
+		const __m256 blue = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 18), mantissaMask));
+
+		StoreRgbAvx2(pDst + (i * 3), _mm256_mul_ps(red, scale), _mm256_mul_ps(green, scale), _mm256_mul_ps(blue, scale));
+	}
+
+	SharedExponentToFloatScalar(pSrc + i, pDst + (i * 3), texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToSharedExponentAvx2(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 maxValue = _mm256_set1_ps(DemoFramework::Utility::PixelConvert::SharedExponentMax);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256i scaleBase = _mm256_set1_epi32(151);
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		__m256 red;
+		__m256 green;
+		__m256 blue;
+
+		LoadRgbAvx2(pSrc + (i * 3), red, green, blue);
+
+		red = ClampAvx2(red, zero, maxValue);
+		green = ClampAvx2(green, zero, maxValue);
+		blue = ClampAvx2(blue, zero, maxValue);
+
+		const __m256 maxChannel = _mm256_max_ps(red, _mm256_max_ps(green, blue));
+		const __m256i biasedExponent = _mm256_srli_epi32(_mm256_castps_si256(maxChannel), 23);
+
+		__m256i sharedExponent = _mm256_max_epi32(_mm256_sub_epi32(biasedExponent, _mm256_set1_epi32(111)), _mm256_setzero_si256());
+		__m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_sub_epi32(scaleBase, sharedExponent), 23));
+
+		const __m256i maxMantissa = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(maxChannel, scale), half)));
+
+		// The comparison mask is -1 where the mantissa overflowed, so subtracting it bumps the exponent.
+		sharedExponent = _mm256_sub_epi32(sharedExponent, _mm256_cmpeq_epi32(maxMantissa, _mm256_set1_epi32(512)));
+		scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_sub_epi32(scaleBase, sharedExponent), 23));
+
+		const __m256i redMantissa = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(red, scale), half)));
+		const __m256i greenMantissa = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(green, scale), half)));
+		const __m256i blueMantissa = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(blue, scale), half)));
+
+		const __m256i texels = _mm256_or_si256(
+			_mm256_or_si256(_mm256_slli_epi32(sharedExponent, 27), _mm256_slli_epi32(blueMantissa, 18)),
+			_mm256_or_si256(_mm256_slli_epi32(greenMantissa, 9), redMantissa));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), texels);
+	}
+
+	FloatToSharedExponentScalar(pSrc + (i * 3), pDst + i, texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void R11G11B10ToFloatAvx2(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	const __m256i mask11 = _mm256_set1_epi32(0x7FF);
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		const __m256i texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+
+		const __m256 red = SmallFloatToFloatAvx2(_mm256_and_si256(texels, mask11), 6);
+		const __m256 green = SmallFloatToFloatAvx2(_mm256_and_si256(_mm256_srli_epi32(texels, 11), mask11), 6);
+		const __m256 blue = SmallFloatToFloatAvx2(_mm256_srli_epi32(texels, 22), 5);
+
+		StoreRgbAvx2(pDst + (i * 3), red, green, blue);
+	}
+
+	R11G11B10ToFloatScalar(pSrc + i, pDst + (i * 3), texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToR11G11B10Avx2(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	using PixelConvert = DemoFramework::Utility::PixelConvert;
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		__m256 red;
+		__m256 green;
+		__m256 blue;
+
+		LoadRgbAvx2(pSrc + (i * 3), red, green, blue);
+
+		const __m256i texels = _mm256_or_si256(
+			_mm256_or_si256(
+				FloatToSmallFloatAvx2(red, PixelConvert::Float11Max, 6),
+				_mm256_slli_epi32(FloatToSmallFloatAvx2(green, PixelConvert::Float11Max, 6), 11)),
+			_mm256_slli_epi32(FloatToSmallFloatAvx2(blue, PixelConvert::Float10Max, 5), 22));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), texels);
+	}
+
+	FloatToR11G11B10Scalar(pSrc + (i * 3), pDst + i, texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void RgbeToFloatAvx2(const uint8_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i minExponent = _mm256_set1_epi32(9);
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		const __m256i texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + (i * 4)));
+		const __m256i exponent = _mm256_srli_epi32(texels, 24);
+
+		// Same as PixelConvert::GetRgbeScale(), with the flushed exponents masked to zero.
+		const __m256i scaleBits = _mm256_and_si256(
+			_mm256_slli_epi32(_mm256_sub_epi32(exponent, minExponent), 23),
+			_mm256_cmpgt_epi32(exponent, minExponent));
+
+		const __m256 scale = _mm256_castsi256_ps(scaleBits);
+
+		const __m256 red = _mm256_cvtepi32_ps(_mm256_and_si256(texels, byteMask));
+		const __m256 green = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 8), byteMask));
+		const __m256 blue = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 16), byteMask));
+
+		StoreRgbAvx2(pDst + (i * 3), _mm256_mul_ps(red, scale), _mm256_mul_ps(green, scale), _mm256_mul_ps(blue, scale));
+	}
+
+	RgbeToFloatScalar(pSrc + (i * 4), pDst + (i * 3), texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatToRgbeAvx2(const float* const pSrc, uint8_t* const pDst, const size_t texelCount)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 maxValue = _mm256_set1_ps(DemoFramework::Utility::PixelConvert::RgbeMax);
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		__m256 red;
+		__m256 green;
+		__m256 blue;
+
+		LoadRgbAvx2(pSrc + (i * 3), red, green, blue);
+
+		red = ClampAvx2(red, zero, maxValue);
+		green = ClampAvx2(green, zero, maxValue);
+		blue = ClampAvx2(blue, zero, maxValue);
+
+		const __m256i biasedExponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_max_ps(red, _mm256_max_ps(green, blue))), 23);
+		const __m256i isValid = _mm256_cmpgt_epi32(biasedExponent, _mm256_set1_epi32(7));
+
+		// The scale is garbage for the texels that get masked out below.
+		const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_sub_epi32(_mm256_set1_epi32(261), biasedExponent), 23));
+
+		const __m256i texels = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_cvttps_epi32(_mm256_mul_ps(red, scale)),
+				_mm256_slli_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(green, scale)), 8)),
+			_mm256_or_si256(
+				_mm256_slli_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(blue, scale)), 16),
+				_mm256_slli_epi32(_mm256_add_epi32(biasedExponent, _mm256_set1_epi32(2)), 24)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + (i * 4)), _mm256_and_si256(texels, isValid));
+	}
+
+	FloatToRgbeScalar(pSrc + (i * 3), pDst + (i * 4), texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FloatRgbToUnormRgbaAvx2(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	const __m256i alpha = _mm256_set1_epi32(int(0xFF000000));
+
+	size_t i = 0;
+
+	for(; i + 8 <= texelCount; i += 8)
+	{
+		__m256 red;
+		__m256 green;
+		__m256 blue;
+
+		LoadRgbAvx2(pSrc + (i * 3), red, green, blue);
+
+		const __m256i texels = _mm256_or_si256(
+			_mm256_or_si256(alpha, _mm256_slli_epi32(FloatToUnormAvx2(blue), 16)),
+			_mm256_or_si256(_mm256_slli_epi32(FloatToUnormAvx2(green), 8), FloatToUnormAvx2(red)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), texels);
+	}
+
+	FloatRgbToUnormRgbaScalar(pSrc + (i * 3), pDst + i, texelCount - i);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::HalfToFloat(const uint16_t* const pSrc, float* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2() && CpuFeatures::HasF16c())
+	{
+		HalfToFloatF16c(pSrc, pDst, count);
+	}
+	else
+	{
+		HalfToFloatScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToHalf(const float* const pSrc, uint16_t* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2() && CpuFeatures::HasF16c())
+	{
+		FloatToHalfF16c(pSrc, pDst, count);
+	}
+	else
+	{
+		FloatToHalfScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::UnormToFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		UnormToFloatAvx2(pSrc, pDst, count);
+	}
+	else
+	{
+		UnormToFloatScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToUnorm(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatToUnormAvx2(pSrc, pDst, count);
+	}
+	else
+	{
+		FloatToUnormScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::SrgbToFloat(const uint8_t* const pSrc, float* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		SrgbToFloatAvx2(pSrc, pDst, count);
+	}
+	else
+	{
+		SrgbToFloatScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToSrgb(const float* const pSrc, uint8_t* const pDst, const size_t count)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatToSrgbAvx2(pSrc, pDst, count);
+	}
+	else
+	{
+		FloatToSrgbScalar(pSrc, pDst, count);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::SharedExponentToFloat(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		SharedExponentToFloatAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		SharedExponentToFloatScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToSharedExponent(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatToSharedExponentAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		FloatToSharedExponentScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::R11G11B10ToFloat(const uint32_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		R11G11B10ToFloatAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		R11G11B10ToFloatScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToR11G11B10(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatToR11G11B10Avx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		FloatToR11G11B10Scalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::RgbeToFloat(const uint8_t* const pSrc, float* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		RgbeToFloatAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		RgbeToFloatScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatToRgbe(const float* const pSrc, uint8_t* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatToRgbeAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		FloatToRgbeScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::PixelConvert::FloatRgbToUnormRgba(const float* const pSrc, uint32_t* const pDst, const size_t texelCount)
+{
+	if(CpuFeatures::HasAvx2())
+	{
+		FloatRgbToUnormRgbaAvx2(pSrc, pDst, texelCount);
+	}
+	else
+	{
+		FloatRgbToUnormRgbaScalar(pSrc, pDst, texelCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
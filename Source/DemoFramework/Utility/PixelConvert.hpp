@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class PixelConvert;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Conversions between 32-bit float and the other pixel formats the texture loaders deal with. Every conversion exists
+// as a scalar function for a single value or texel, plus a bulk version over an array that uses AVX2 (and F16C for
+// half floats) when the CPU supports it. The bulk kernels produce exactly the same bits as the scalar functions, so
+// nothing depends on which CPU the data was converted on.
+//
+// Conversions to the smaller formats round to nearest (ties to even where the format has a mantissa, except for RGBE
+// which truncates like the Radiance reference code), clamp to the range of the format, and turn NaN into zero.
+// Counts are in values for the per-channel formats (half, unorm8, sRGB8) and in texels for the packed formats
+// (RGB9E5, R11G11B10, RGBE), which always convert to and from three floats per texel.
+class DF_API DemoFramework::Utility::PixelConvert
+{
+public:
+
+	PixelConvert() = delete;
+	PixelConvert(const PixelConvert&) = delete;
+	PixelConvert(PixelConvert&&) = delete;
+
+	static constexpr float HalfMax = 65504.0f;           // Largest finite half float
+	static constexpr float SharedExponentMax = 65408.0f; // Largest RGB9E5 channel (511/512 * 2^16)
+	static constexpr float Float11Max = 65024.0f;        // Largest R11G11B10 red or green channel (1.984375 * 2^15)
+	static constexpr float Float10Max = 64512.0f;        // Largest R11G11B10 blue channel (1.96875 * 2^15)
+	static constexpr float RgbeMax = 255.0f * 6.6461399789245794e+35f; // Largest RGBE channel (255 * 2^119)
+
+	static float HalfToFloat(uint16_t value);
+	static uint16_t FloatToHalf(float value);
+
+	static float UnormToFloat(uint8_t value);
+	static uint8_t FloatToUnorm(float value);
+
+	// sRGB values are decoded to linear floats and linear floats are encoded to sRGB.
+	static float SrgbToFloat(uint8_t value);
+	static uint8_t FloatToSrgb(float value);
+
+	static void SharedExponentToFloat(uint32_t texel, float* pOutRgb);
+	static uint32_t FloatToSharedExponent(const float* pRgb);
+
+	static void R11G11B10ToFloat(uint32_t texel, float* pOutRgb);
+	static uint32_t FloatToR11G11B10(const float* pRgb);
+
+	// RGBE texels are 4 bytes in red, green, blue, exponent order, as stored in Radiance (.hdr) files.
+	static void RgbeToFloat(const uint8_t* pRgbe, float* pOutRgb);
+	static void FloatToRgbe(const float* pRgb, uint8_t* pOutRgbe);
+
+	// Scale applied to the mantissas of an RGBE texel. Exponents that would give a denormal float are flushed to zero,
+	// which also covers the zero exponent of black texels.
+	static float GetRgbeScale(uint32_t exponent);
+
+	static void HalfToFloat(const uint16_t* pSrc, float* pDst, size_t count);
+	static void FloatToHalf(const float* pSrc, uint16_t* pDst, size_t count);
+
+	static void UnormToFloat(const uint8_t* pSrc, float* pDst, size_t count);
+	static void FloatToUnorm(const float* pSrc, uint8_t* pDst, size_t count);
+
+	static void SrgbToFloat(const uint8_t* pSrc, float* pDst, size_t count);
+	static void FloatToSrgb(const float* pSrc, uint8_t* pDst, size_t count);
+
+	static void SharedExponentToFloat(const uint32_t* pSrc, float* pDst, size_t texelCount);
+	static void FloatToSharedExponent(const float* pSrc, uint32_t* pDst, size_t texelCount);
+
+	static void R11G11B10ToFloat(const uint32_t* pSrc, float* pDst, size_t texelCount);
+	static void FloatToR11G11B10(const float* pSrc, uint32_t* pDst, size_t texelCount);
+
+	static void RgbeToFloat(const uint8_t* pSrc, float* pDst, size_t texelCount);
+	static void FloatToRgbe(const float* pSrc, uint8_t* pDst, size_t texelCount);
+
+	// Pack float RGB triplets into RGBA8 unorm texels with an opaque alpha, red in the lowest byte.
+	static void FloatRgbToUnormRgba(const float* pSrc, uint32_t* pDst, size_t texelCount);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,480 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ProbeUpdateScheduler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// How far each GPU time report moves the cost scale toward the ratio it measured. Reports are noisy from frame to
+// frame, so this keeps a single slow frame from starving the next few.
+#define DF_PROBE_UPDATE_COST_SMOOTHING 0.25
+
+#define DF_PROBE_UPDATE_FACE_COUNT 6
+
+#define DF_PROBE_UPDATE_MIN_COST_SCALE (1.0 / 64.0)
+#define DF_PROBE_UPDATE_MAX_COST_SCALE 64.0
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ProbeUpdateScheduler::ProbeUpdateScheduler()
+	: m_desc()
+	, m_costModel(GetDefaultCostModel())
+	, m_history()
+	, m_frameIndex(0)
+	, m_writableFrame(0)
+	, m_costScale(1.0)
+	, m_pass(Pass::Done)
+	, m_mipIndex(0)
+	, m_faceIndex(0)
+	, m_row(0)
+	, m_reducePassCount(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ProbeUpdateScheduler::CostModel DemoFramework::Utility::ProbeUpdateScheduler::GetDefaultCostModel()
+{
+	// Rough figures for a mid-range desktop GPU, where every pass is mostly bound by writing out its results. These
+	// only need to be in the right ballpark until the first few GPU time reports come in.
+	CostModel output;
+	output.equiToCubeNsPerTexel = 0.1;
+	output.shProjectNsPerTexel = 0.06;
+	output.shReduceNsPerInput = 0.35;
+	output.shReconstructNsPerTexel = 0.05;
+	output.specPrefilterNsPerSample = 0.05;
+	output.dispatchNs = 5000.0;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ProbeUpdateScheduler::Reset(const Desc& desc)
+{
+	if(desc.envEdgeLength == 0
+		|| desc.envMipCount == 0
+		|| desc.envMipCount > DF_PROBE_UPDATE_SCHEDULER_MAX_MIP_COUNT
+		|| desc.irrEdgeLength == 0
+		|| desc.rowAlignment == 0
+		|| desc.reduceSegmentSize < 2
+		|| desc.reduceGroupSize == 0)
+	{
+		return false;
+	}
+
+	m_desc = desc;
+	m_reducePassCount = 0;
+
+	// Reduction passes keep going until there's a single output left, the same way the probe runs them.
+	for(uint32_t inputCount = desc.envEdgeLength * desc.envEdgeLength; inputCount > 1; inputCount /= desc.reduceSegmentSize)
+	{
+		++m_reducePassCount;
+	}
+
+	for(size_t i = 0; i < DF_PROBE_UPDATE_SCHEDULER_HISTORY_LENGTH; ++i)
+	{
+		m_history[i].frameIndex = 0;
+		m_history[i].estimateNs = 0.0;
+	}
+
+	m_frameIndex = 0;
+	m_writableFrame = 0;
+	m_costScale = 1.0;
+	m_pass = Pass::Done;
+	m_mipIndex = 0;
+	m_faceIndex = 0;
+	m_row = 0;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ProbeUpdateScheduler::SetCostModel(const CostModel& costModel)
+{
+	m_costModel = costModel;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ProbeUpdateScheduler::Begin()
+{
+	if(m_desc.envEdgeLength == 0)
+	{
+		// The scheduler hasn't been reset with a probe yet.
+		return;
+	}
+
+	m_pass = Pass::EquiToCube;
+	m_mipIndex = 0;
+	m_faceIndex = 0;
+	m_row = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ProbeUpdateScheduler::Cancel()
+{
+	m_pass = Pass::Done;
+	m_mipIndex = 0;
+	m_faceIndex = 0;
+	m_row = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::ProbeUpdateScheduler::Update(
+	const float64_t gpuBudgetMs,
+	Step* const pOutSteps,
+	const size_t maxStepCount)
+{
+	++m_frameIndex;
+
+	FrameEstimate& estimate = m_history[m_frameIndex % DF_PROBE_UPDATE_SCHEDULER_HISTORY_LENGTH];
+	estimate.frameIndex = m_frameIndex;
+	estimate.estimateNs = 0.0;
+
+	// Nothing can be written to the back buffers while the GPU might still be reading them from before the last swap.
+	if(m_pass == Pass::Done || m_frameIndex < m_writableFrame || !pOutSteps || maxStepCount == 0)
+	{
+		return 0;
+	}
+
+	// Scheduling happens in unscaled costs, so the budget is scaled down instead.
+	const float64_t budgetNs = (gpuBudgetMs > 0.0) ? (gpuBudgetMs * 1000000.0 / m_costScale) : 0.0;
+
+	float64_t spentNs = 0.0;
+	size_t stepCount = 0;
+
+	while(m_pass != Pass::Done && stepCount < maxStepCount)
+	{
+		Step& step = pOutSteps[stepCount];
+
+		step.pass = m_pass;
+		step.mipIndex = m_mipIndex;
+		step.faceIndex = m_faceIndex;
+		step.firstRow = m_row;
+		step.rowCount = 0;
+
+		if(m_pass == Pass::Swap)
+		{
+			++stepCount;
+
+			// Frames recorded before this one may still be reading the buffers that are about to become the back buffers.
+			m_writableFrame = m_frameIndex + m_desc.swapDelay;
+
+			_advance(m_pass, m_mipIndex, m_faceIndex);
+			break;
+		}
+
+		const uint32_t rowCount = _getRowCount(m_pass, m_mipIndex);
+		const uint32_t remainingRows = rowCount - m_row;
+		const float64_t remainingCostNs = _getItemCostNs(m_pass, m_mipIndex, remainingRows);
+
+		uint32_t scheduledRows = 0;
+
+		if(spentNs + remainingCostNs <= budgetNs)
+		{
+			scheduledRows = remainingRows;
+		}
+		else if(rowCount > 1)
+		{
+			const uint32_t rowAlignment = _getRowAlignment(m_pass);
+
+			// Take as many whole groups of rows as the rest of the budget allows.
+			const float64_t availableNs = budgetNs - spentNs - m_costModel.dispatchNs;
+			const float64_t fitRows = (availableNs > 0.0) ? (availableNs / _getRowCostNs(m_pass, m_mipIndex)) : 0.0;
+
+			scheduledRows = (fitRows < float64_t(remainingRows)) ? uint32_t(fitRows) : remainingRows;
+
+			if(scheduledRows < remainingRows)
+			{
+				scheduledRows -= scheduledRows % rowAlignment;
+			}
+
+			if(scheduledRows == 0 && stepCount == 0)
+			{
+				// Always make some progress, even when the budget is too small for a single group of rows.
+				scheduledRows = (rowAlignment < remainingRows) ? rowAlignment : remainingRows;
+			}
+		}
+		else if(stepCount == 0)
+		{
+			scheduledRows = remainingRows;
+		}
+
+		if(scheduledRows == 0)
+		{
+			break;
+		}
+
+		step.rowCount = scheduledRows;
+
+		spentNs += _getItemCostNs(m_pass, m_mipIndex, scheduledRows);
+		++stepCount;
+
+		m_row += scheduledRows;
+
+		if(m_row >= rowCount)
+		{
+			m_row = 0;
+			_advance(m_pass, m_mipIndex, m_faceIndex);
+		}
+	}
+
+	estimate.estimateNs = spentNs;
+
+	return stepCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ProbeUpdateScheduler::ReportGpuTime(const uint64_t frameIndex, const float64_t gpuTimeMs)
+{
+	const FrameEstimate& estimate = m_history[frameIndex % DF_PROBE_UPDATE_SCHEDULER_HISTORY_LENGTH];
+
+	// Frames without any scheduled work have nothing to calibrate against.
+	if(estimate.frameIndex != frameIndex || estimate.estimateNs <= 0.0 || gpuTimeMs <= 0.0)
+	{
+		return;
+	}
+
+	const float64_t ratio = gpuTimeMs * 1000000.0 / estimate.estimateNs;
+
+	m_costScale += (ratio - m_costScale) * DF_PROBE_UPDATE_COST_SMOOTHING;
+
+	if(m_costScale < DF_PROBE_UPDATE_MIN_COST_SCALE)
+	{
+		m_costScale = DF_PROBE_UPDATE_MIN_COST_SCALE;
+	}
+	else if(m_costScale > DF_PROBE_UPDATE_MAX_COST_SCALE)
+	{
+		m_costScale = DF_PROBE_UPDATE_MAX_COST_SCALE;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float64_t DemoFramework::Utility::ProbeUpdateScheduler::EstimateStepMs(const Step& step) const
+{
+	if(step.pass == Pass::Swap || step.pass == Pass::Done)
+	{
+		return 0.0;
+	}
+
+	return _getItemCostNs(step.pass, step.mipIndex, step.rowCount) * m_costScale / 1000000.0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float64_t DemoFramework::Utility::ProbeUpdateScheduler::EstimateRemainingMs() const
+{
+	Pass pass = m_pass;
+
+	uint32_t mipIndex = m_mipIndex;
+	uint32_t faceIndex = m_faceIndex;
+	uint32_t row = m_row;
+
+	float64_t totalNs = 0.0;
+
+	while(pass != Pass::Done)
+	{
+		if(pass != Pass::Swap)
+		{
+			totalNs += _getItemCostNs(pass, mipIndex, _getRowCount(pass, mipIndex) - row);
+		}
+
+		row = 0;
+		_advance(pass, mipIndex, faceIndex);
+	}
+
+	return totalNs * m_costScale / 1000000.0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float64_t DemoFramework::Utility::ProbeUpdateScheduler::_getRowCostNs(const Pass pass, const uint32_t mipIndex) const
+{
+	switch(pass)
+	{
+		case Pass::EquiToCube:
+		{
+			const uint32_t mipEdgeLength = m_desc.envEdgeLength >> mipIndex;
+			return float64_t((mipEdgeLength > 0) ? mipEdgeLength : 1) * m_costModel.equiToCubeNsPerTexel;
+		}
+
+		case Pass::ShProject:
+			return float64_t(m_desc.envEdgeLength) * float64_t(DF_PROBE_UPDATE_FACE_COUNT) * m_costModel.shProjectNsPerTexel;
+
+		case Pass::ShReduce:
+			return float64_t(m_desc.reduceSegmentSize) * m_costModel.shReduceNsPerInput;
+
+		case Pass::ShReconstruct:
+			return float64_t(m_desc.irrEdgeLength) * float64_t(m_desc.irrEdgeLength) * m_costModel.shReconstructNsPerTexel;
+
+		case Pass::SpecPrefilter:
+		{
+			const uint32_t mipEdgeLength = m_desc.envEdgeLength >> mipIndex;
+			const uint32_t sampleCount = (mipIndex > 0) ? m_desc.specSampleCount : 1;
+			return float64_t((mipEdgeLength > 0) ? mipEdgeLength : 1) * float64_t(sampleCount) * m_costModel.specPrefilterNsPerSample;
+		}
+
+		default:
+			break;
+	}
+
+	return 0.0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float64_t DemoFramework::Utility::ProbeUpdateScheduler::_getItemCostNs(
+	const Pass pass,
+	const uint32_t mipIndex,
+	const uint32_t rowCount) const
+{
+	return m_costModel.dispatchNs + (_getRowCostNs(pass, mipIndex) * float64_t(rowCount));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::ProbeUpdateScheduler::_getRowCount(const Pass pass, const uint32_t mipIndex) const
+{
+	switch(pass)
+	{
+		case Pass::EquiToCube:
+		case Pass::SpecPrefilter:
+		{
+			const uint32_t mipEdgeLength = m_desc.envEdgeLength >> mipIndex;
+			return (mipEdgeLength > 0) ? mipEdgeLength : 1;
+		}
+
+		case Pass::ShProject:
+			return m_desc.envEdgeLength;
+
+		case Pass::ShReduce:
+		{
+			const uint32_t outputCount = _getReduceInputCount(mipIndex) / m_desc.reduceSegmentSize;
+			return (outputCount > 0) ? outputCount : 1;
+		}
+
+		default:
+			break;
+	}
+
+	// Passes that aren't split are scheduled as a single row covering all of their work.
+	return 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::ProbeUpdateScheduler::_getRowAlignment(const Pass pass) const
+{
+	return (pass == Pass::ShReduce) ? m_desc.reduceGroupSize : m_desc.rowAlignment;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::ProbeUpdateScheduler::_getReduceInputCount(const uint32_t passIndex) const
+{
+	uint32_t inputCount = m_desc.envEdgeLength * m_desc.envEdgeLength;
+
+	for(uint32_t i = 0; i < passIndex; ++i)
+	{
+		inputCount /= m_desc.reduceSegmentSize;
+	}
+
+	return inputCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ProbeUpdateScheduler::_advance(Pass& pass, uint32_t& mipIndex, uint32_t& faceIndex) const
+{
+	switch(pass)
+	{
+		case Pass::EquiToCube:
+			++faceIndex;
+
+			if(faceIndex == DF_PROBE_UPDATE_FACE_COUNT)
+			{
+				faceIndex = 0;
+				++mipIndex;
+
+				if(mipIndex == m_desc.envMipCount)
+				{
+					mipIndex = 0;
+					pass = Pass::ShProject;
+				}
+			}
+			break;
+
+		case Pass::ShProject:
+			pass = (m_reducePassCount > 0) ? Pass::ShReduce : Pass::ShNormalize;
+			mipIndex = 0;
+			break;
+
+		case Pass::ShReduce:
+			++mipIndex;
+
+			if(mipIndex == m_reducePassCount)
+			{
+				mipIndex = 0;
+				pass = Pass::ShNormalize;
+			}
+			break;
+
+		case Pass::ShNormalize:
+			pass = Pass::ShReconstruct;
+			faceIndex = 0;
+			break;
+
+		case Pass::ShReconstruct:
+			++faceIndex;
+
+			if(faceIndex == DF_PROBE_UPDATE_FACE_COUNT)
+			{
+				faceIndex = 0;
+				mipIndex = 0;
+				pass = (m_desc.specSampleCount > 0) ? Pass::SpecPrefilter : Pass::Swap;
+			}
+			break;
+
+		case Pass::SpecPrefilter:
+			++faceIndex;
+
+			if(faceIndex == DF_PROBE_UPDATE_FACE_COUNT)
+			{
+				faceIndex = 0;
+				++mipIndex;
+
+				if(mipIndex == m_desc.envMipCount)
+				{
+					mipIndex = 0;
+					pass = Pass::Swap;
+				}
+			}
+			break;
+
+		default:
+			pass = Pass::Done;
+			break;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_PROBE_UPDATE_SCHEDULER_MAX_MIP_COUNT 16
+#define DF_PROBE_UPDATE_SCHEDULER_HISTORY_LENGTH 16
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ProbeUpdateScheduler;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Budget policy for updating a reflection probe a slice at a time instead of all at once. An update is broken into the
+// same passes the probe runs when loading an environment map, and each frame gets as many of them as fit in a GPU
+// time budget, with the larger passes split on rows. Each pass is costed with a simple per-texel model, which is
+// scaled by the ratio between measured and estimated GPU time whenever the caller reports the time a frame's slice
+// actually took. Like MipStreamScheduler, this never touches any GPU objects; the caller records the steps it returns.
+//
+// The steps write to a set of back buffers which only become visible to readers through the Swap step at the end of
+// the update. Once swapped, the old front buffers are not written to again until enough frames have passed for the
+// GPU to finish every frame that could still be reading them.
+class DF_API DemoFramework::Utility::ProbeUpdateScheduler
+{
+public:
+
+	enum class Pass
+	{
+		EquiToCube,    // Rows of one face of one environment map mip
+		ShProject,     // Rows of the SH projection of the environment map
+		ShReduce,      // Outputs of one SH reduction pass
+		ShNormalize,
+		ShReconstruct, // One face of the irradiance map
+		SpecPrefilter, // Rows of one face of one specular map mip
+		Swap,          // Make the back buffers visible to readers
+
+		Done,
+	};
+
+	// For ShReduce steps, the mip index is the reduction pass and the rows are the range of that pass's outputs.
+	struct Step
+	{
+		Pass pass;
+		uint32_t mipIndex;
+		uint32_t faceIndex;
+		uint32_t firstRow;
+		uint32_t rowCount;
+	};
+
+	struct Desc
+	{
+		uint32_t envEdgeLength;
+		uint32_t envMipCount;
+		uint32_t irrEdgeLength;
+		uint32_t rowAlignment;      // Texture rows per thread group; split texture passes start on a multiple of this
+		uint32_t reduceSegmentSize; // Number of inputs summed into each output of a reduction pass
+		uint32_t reduceGroupSize;   // Reduction outputs per thread group; split reduction passes start on a multiple of this
+		uint32_t swapDelay;         // Number of frames the GPU can run behind the CPU
+		uint32_t specSampleCount;   // GGX samples per specular map texel; zero for probes without a specular map
+	};
+
+	// Estimated GPU time of each pass in nanoseconds per unit of work, plus a fixed cost for every dispatch.
+	struct CostModel
+	{
+		float64_t equiToCubeNsPerTexel;
+		float64_t shProjectNsPerTexel;     // Per texel of a single face; each thread of the pass covers all six
+		float64_t shReduceNsPerInput;
+		float64_t shReconstructNsPerTexel;
+		float64_t specPrefilterNsPerSample; // Per sample of a texel; the mirror mip takes a single sample per texel
+		float64_t dispatchNs;
+	};
+
+	ProbeUpdateScheduler();
+	ProbeUpdateScheduler(const ProbeUpdateScheduler&) = delete;
+	ProbeUpdateScheduler(ProbeUpdateScheduler&&) = delete;
+
+	ProbeUpdateScheduler& operator =(const ProbeUpdateScheduler&) = delete;
+	ProbeUpdateScheduler& operator =(ProbeUpdateScheduler&&) = delete;
+
+	static CostModel GetDefaultCostModel();
+
+	// Set up the scheduler for a probe with the given dimensions, dropping any update in progress.
+	bool Reset(const Desc& desc);
+
+	void SetCostModel(const CostModel& costModel);
+
+	// Start an update. Starting one while another is in progress starts the back buffers over from the beginning.
+	void Begin();
+	void Cancel();
+
+	// Advance one frame and fill the output array with the steps to record this frame. Returns the number of steps
+	// written. At least one step is scheduled whenever the update can make progress, even if it goes over the budget,
+	// so an update always finishes.
+	size_t Update(float64_t gpuBudgetMs, Step* pOutSteps, size_t maxStepCount);
+
+	// Report the GPU time measured for the steps scheduled in a given frame. Reports for frames that are too old to
+	// still be in the history are ignored.
+	void ReportGpuTime(uint64_t frameIndex, float64_t gpuTimeMs);
+
+	// Estimated GPU time of the given step, including the current cost scale.
+	float64_t EstimateStepMs(const Step& step) const;
+
+	// Estimated GPU time of the rest of the update in progress, including the current cost scale.
+	float64_t EstimateRemainingMs() const;
+
+	uint64_t GetFrameIndex() const;
+	float64_t GetCostScale() const;
+
+	bool IsUpdating() const;
+
+
+private:
+
+	struct FrameEstimate
+	{
+		uint64_t frameIndex;
+		float64_t estimateNs; // Unscaled
+	};
+
+	float64_t _getRowCostNs(Pass, uint32_t) const;
+	float64_t _getItemCostNs(Pass, uint32_t, uint32_t) const;
+	uint32_t _getRowCount(Pass, uint32_t) const;
+	uint32_t _getRowAlignment(Pass) const;
+	uint32_t _getReduceInputCount(uint32_t) const;
+
+	void _advance(Pass&, uint32_t&, uint32_t&) const;
+
+	Desc m_desc;
+	CostModel m_costModel;
+
+	FrameEstimate m_history[DF_PROBE_UPDATE_SCHEDULER_HISTORY_LENGTH];
+
+	uint64_t m_frameIndex;
+	uint64_t m_writableFrame;
+
+	float64_t m_costScale;
+
+	Pass m_pass;
+
+	uint32_t m_mipIndex;
+	uint32_t m_faceIndex;
+	uint32_t m_row;
+	uint32_t m_reducePassCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::ProbeUpdateScheduler::GetFrameIndex() const
+{
+	return m_frameIndex;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline float64_t DemoFramework::Utility::ProbeUpdateScheduler::GetCostScale() const
+{
+	return m_costScale;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::Utility::ProbeUpdateScheduler::IsUpdating() const
+{
+	return m_pass != Pass::Done;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,482 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ResidencyPolicy.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the entry map using PIMPL to make MSVC shut up about std::map<> needing a DLL interface.
+struct DemoFramework::Utility::ResidencyPolicy::EntryMap
+{
+	struct Entry
+	{
+		// Size of the entry for each resident mip; the extra element is the size of the evicted entry.
+		uint64_t sizes[DF_RESIDENCY_POLICY_MAX_MIP_COUNT + 1];
+
+		// Bytes still held on top of the resident mips, as reported by the caller.
+		uint64_t pendingSize;
+
+		uint64_t lastUsedFrame;
+
+		// Update() call that last produced an action for this entry.
+		uint64_t actionUpdate;
+
+		uint32_t mipCount;
+		uint32_t tailMip;
+		uint32_t residentMip;
+
+		bool pinned;
+	};
+
+	// Ordered by ID so walking the map is deterministic.
+	std::map<EntryId, Entry> map;
+
+	// Scratch list of entries that can give up memory, reused between updates.
+	std::vector<std::pair<EntryId, Entry*>> candidates;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResidencyPolicy::ResidencyPolicy()
+	: m_pEntries(new EntryMap())
+	, m_budget(0)
+	, m_residentSize(0)
+	, m_pendingSize(0)
+	, m_frameIndex(0)
+	, m_updateIndex(0)
+	, m_nextId(InvalidEntryId + 1)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResidencyPolicy::~ResidencyPolicy()
+{
+	if(m_pEntries)
+	{
+		delete m_pEntries;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResidencyPolicy::EntryId DemoFramework::Utility::ResidencyPolicy::Register(
+	const uint32_t mipCount,
+	const uint64_t* const pResidentSizes,
+	const uint32_t tailMip,
+	const uint32_t residentMip)
+{
+	if(mipCount == 0
+		|| mipCount > DF_RESIDENCY_POLICY_MAX_MIP_COUNT
+		|| !pResidentSizes
+		|| tailMip >= mipCount
+		|| residentMip > mipCount)
+	{
+		return InvalidEntryId;
+	}
+
+	EntryMap::Entry entry;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		// Dropping a mip should never make the entry bigger.
+		if(mipIndex > 0 && pResidentSizes[mipIndex] > pResidentSizes[mipIndex - 1])
+		{
+			return InvalidEntryId;
+		}
+
+		entry.sizes[mipIndex] = pResidentSizes[mipIndex];
+	}
+
+	entry.sizes[mipCount] = 0;
+	entry.pendingSize = 0;
+	entry.lastUsedFrame = m_frameIndex;
+	entry.actionUpdate = 0;
+	entry.mipCount = mipCount;
+	entry.tailMip = tailMip;
+	entry.residentMip = residentMip;
+	entry.pinned = false;
+
+	const EntryId id = m_nextId;
+
+	// Skip the invalid ID when the counter wraps around.
+	++m_nextId;
+	if(m_nextId == InvalidEntryId)
+	{
+		++m_nextId;
+	}
+
+	m_pEntries->map[id] = entry;
+	m_residentSize += entry.sizes[residentMip];
+
+	return id;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ResidencyPolicy::Unregister(const EntryId id)
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end())
+	{
+		return false;
+	}
+
+	m_residentSize -= it->second.sizes[it->second.residentMip];
+	m_pendingSize -= it->second.pendingSize;
+	m_pEntries->map.erase(it);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ResidencyPolicy::Touch(const EntryId id, const uint64_t frameIndex)
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end())
+	{
+		return false;
+	}
+
+	if(frameIndex > it->second.lastUsedFrame)
+	{
+		it->second.lastUsedFrame = frameIndex;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ResidencyPolicy::SetPinned(const EntryId id, const bool pinned)
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end())
+	{
+		return false;
+	}
+
+	it->second.pinned = pinned;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ResidencyPolicy::SetResidentMip(const EntryId id, const uint32_t residentMip)
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end() || residentMip > it->second.mipCount)
+	{
+		return false;
+	}
+
+	EntryMap::Entry& entry = it->second;
+
+	m_residentSize -= entry.sizes[entry.residentMip];
+	m_residentSize += entry.sizes[residentMip];
+
+	entry.residentMip = residentMip;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ResidencyPolicy::SetPendingSize(const EntryId id, const uint64_t pendingSize)
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end())
+	{
+		return false;
+	}
+
+	EntryMap::Entry& entry = it->second;
+
+	m_pendingSize -= entry.pendingSize;
+	m_pendingSize += pendingSize;
+
+	entry.pendingSize = pendingSize;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::ResidencyPolicy::Update(
+	const uint64_t frameIndex,
+	Action* const pOutActions,
+	const size_t maxActionCount)
+{
+	if(frameIndex > m_frameIndex)
+	{
+		m_frameIndex = frameIndex;
+	}
+
+	++m_updateIndex;
+
+	if(!pOutActions || maxActionCount == 0)
+	{
+		return 0;
+	}
+
+	size_t actionCount = 0;
+
+	// Restore everything used this frame first, since those are the entries actually on screen.
+	for(auto& pair : m_pEntries->map)
+	{
+		EntryMap::Entry& entry = pair.second;
+
+		if(entry.pinned || entry.lastUsedFrame < m_frameIndex || entry.residentMip == 0)
+		{
+			continue;
+		}
+
+		const uint32_t currentMip = entry.residentMip;
+		const uint64_t currentSize = entry.sizes[currentMip];
+		const uint64_t fullSize = entry.sizes[0];
+
+		const uint64_t usedSize = m_residentSize + m_pendingSize;
+
+		uint64_t freeSize = (m_budget > usedSize) ? (m_budget - usedSize) : 0;
+
+		if(fullSize - currentSize > freeSize)
+		{
+			freeSize += _reclaim(fullSize - currentSize - freeSize, m_frameIndex, pOutActions, maxActionCount, actionCount);
+		}
+
+		if(actionCount == maxActionCount)
+		{
+			break;
+		}
+
+		// Bring back as many mips as fit.
+		uint32_t targetMip = currentMip;
+
+		for(uint32_t mipIndex = 0; mipIndex < currentMip; ++mipIndex)
+		{
+			if(entry.sizes[mipIndex] - currentSize <= freeSize)
+			{
+				targetMip = mipIndex;
+				break;
+			}
+		}
+
+		// An entry in use always gets at least its tail back, even over budget; the idle entries
+		// will be trimmed to make up for it on the following updates.
+		if(targetMip > entry.tailMip)
+		{
+			targetMip = entry.tailMip;
+		}
+
+		if(targetMip == currentMip)
+		{
+			continue;
+		}
+
+		Action& action = pOutActions[actionCount];
+
+		action.id = pair.first;
+		action.type = ActionType::Restore;
+		action.targetMip = targetMip;
+
+		++actionCount;
+
+		m_residentSize += entry.sizes[targetMip] - currentSize;
+
+		entry.residentMip = targetMip;
+		entry.actionUpdate = m_updateIndex;
+	}
+
+	// Memory that is still pending release counts too, since it's just as allocated until the caller clears it.
+	if(m_residentSize + m_pendingSize > m_budget && actionCount < maxActionCount)
+	{
+		_reclaim(m_residentSize + m_pendingSize - m_budget, m_frameIndex, pOutActions, maxActionCount, actionCount);
+	}
+
+	return actionCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::ResidencyPolicy::GetResidentMip(const EntryId id) const
+{
+	auto it = m_pEntries->map.find(id);
+	if(it == m_pEntries->map.end())
+	{
+		return 0;
+	}
+
+	return it->second.residentMip;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::ResidencyPolicy::GetEntryCount() const
+{
+	return m_pEntries->map.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::Utility::ResidencyPolicy::_reclaim(
+	const uint64_t byteCount,
+	const uint64_t frameIndex,
+	Action* const pOutActions,
+	const size_t maxActionCount,
+	size_t& actionCount)
+{
+	std::vector<std::pair<EntryId, EntryMap::Entry*>>& candidates = m_pEntries->candidates;
+
+	candidates.clear();
+
+	for(auto& pair : m_pEntries->map)
+	{
+		EntryMap::Entry& entry = pair.second;
+
+		// Only idle entries that still have something resident can give up memory. Entries restored by this
+		// update were used on this frame, so they're skipped along with the rest of the entries in use.
+		if(!entry.pinned && entry.lastUsedFrame < frameIndex && entry.residentMip < entry.mipCount)
+		{
+			candidates.push_back(std::make_pair(pair.first, &entry));
+		}
+	}
+
+	// Least recently used first, breaking ties by ID.
+	std::sort(
+		candidates.begin(),
+		candidates.end(),
+		[](const std::pair<EntryId, EntryMap::Entry*>& left, const std::pair<EntryId, EntryMap::Entry*>& right)
+		{
+			if(left.second->lastUsedFrame != right.second->lastUsedFrame)
+			{
+				return left.second->lastUsedFrame < right.second->lastUsedFrame;
+			}
+
+			return left.first < right.first;
+		});
+
+	uint64_t freedSize = 0;
+
+	// Trim before evicting anything so entries keep at least their tail for as long as possible.
+	for(const std::pair<EntryId, EntryMap::Entry*>& candidate : candidates)
+	{
+		EntryMap::Entry& entry = *candidate.second;
+
+		if(freedSize >= byteCount || actionCount == maxActionCount)
+		{
+			break;
+		}
+
+		if(entry.actionUpdate == m_updateIndex || entry.residentMip >= entry.tailMip)
+		{
+			continue;
+		}
+
+		const uint32_t currentMip = entry.residentMip;
+		const uint64_t currentSize = entry.sizes[currentMip];
+		const uint64_t remainingSize = byteCount - freedSize;
+
+		// Drop as few mips as needed, up to the tail.
+		uint32_t targetMip = entry.tailMip;
+
+		for(uint32_t mipIndex = currentMip + 1; mipIndex < entry.tailMip; ++mipIndex)
+		{
+			if(currentSize - entry.sizes[mipIndex] >= remainingSize)
+			{
+				targetMip = mipIndex;
+				break;
+			}
+		}
+
+		Action& action = pOutActions[actionCount];
+
+		action.id = candidate.first;
+		action.type = ActionType::Trim;
+		action.targetMip = targetMip;
+
+		++actionCount;
+
+		freedSize += currentSize - entry.sizes[targetMip];
+		m_residentSize -= currentSize - entry.sizes[targetMip];
+
+		entry.residentMip = targetMip;
+		entry.actionUpdate = m_updateIndex;
+	}
+
+	// Evict whole entries, least recently used first, until enough has been freed. An entry trimmed above has its
+	// action turned into an eviction instead of getting a second action.
+	for(const std::pair<EntryId, EntryMap::Entry*>& candidate : candidates)
+	{
+		EntryMap::Entry& entry = *candidate.second;
+
+		if(freedSize >= byteCount)
+		{
+			break;
+		}
+
+		Action* pAction = nullptr;
+
+		if(entry.actionUpdate == m_updateIndex)
+		{
+			for(size_t actionIndex = 0; actionIndex < actionCount; ++actionIndex)
+			{
+				if(pOutActions[actionIndex].id == candidate.first)
+				{
+					pAction = &pOutActions[actionIndex];
+					break;
+				}
+			}
+
+			if(!pAction || pAction->type != ActionType::Trim)
+			{
+				continue;
+			}
+		}
+		else if(actionCount < maxActionCount)
+		{
+			pAction = &pOutActions[actionCount];
+
+			++actionCount;
+		}
+		else
+		{
+			continue;
+		}
+
+		const uint64_t currentSize = entry.sizes[entry.residentMip];
+
+		pAction->id = candidate.first;
+		pAction->type = ActionType::Evict;
+		pAction->targetMip = entry.mipCount;
+
+		freedSize += currentSize;
+		m_residentSize -= currentSize;
+
+		entry.residentMip = entry.mipCount;
+		entry.actionUpdate = m_updateIndex;
+	}
+
+	return freedSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
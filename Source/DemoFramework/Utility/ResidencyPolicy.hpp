@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_RESIDENCY_POLICY_MAX_MIP_COUNT 16
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ResidencyPolicy;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Memory budget policy for a set of mipmapped resources. Each entry is described by the number of bytes it occupies
+// for every mip it can be trimmed down to, and by the last frame it was used on. When the resident total goes over the
+// budget, the least recently used entries have their most detailed mips dropped, down to a minimum tail, and are then
+// evicted entirely if that still isn't enough. Entries used on the current frame that aren't fully resident are
+// restored, making room by trimming or evicting idle entries first.
+//
+// This never touches any GPU objects, and given the same sequence of calls, always produces the same actions. The
+// caller is expected to apply every action it is handed; the policy considers the new resident mip of an entry to be
+// in effect as soon as the action is returned. When applying an action leaves the old memory allocated for a while,
+// the caller reports it with SetPendingSize() so it keeps counting against the budget until it's actually released.
+class DF_API DemoFramework::Utility::ResidencyPolicy
+{
+public:
+
+	typedef uint32_t EntryId;
+
+	static constexpr EntryId InvalidEntryId = 0;
+
+	enum class ActionType
+	{
+		Trim,    // Drop the most detailed mips, keeping the entry resident from 'targetMip' down
+		Evict,   // Release the entry entirely; 'targetMip' is the mip count
+		Restore, // Bring the entry back from 'targetMip' down
+	};
+
+	struct Action
+	{
+		EntryId id;
+		ActionType type;
+		uint32_t targetMip;
+	};
+
+	ResidencyPolicy();
+	ResidencyPolicy(const ResidencyPolicy&) = delete;
+	ResidencyPolicy(ResidencyPolicy&&) = delete;
+	~ResidencyPolicy();
+
+	ResidencyPolicy& operator =(const ResidencyPolicy&) = delete;
+	ResidencyPolicy& operator =(ResidencyPolicy&&) = delete;
+
+	// Add an entry with 'mipCount' mips. Element 'i' of the size array is the number of bytes the entry occupies when
+	// mips [i, mipCount) are resident; the sizes must not increase with the mip index. The entry is never trimmed past
+	// 'tailMip', and starts out resident from 'residentMip' down, where a resident mip equal to the mip count means
+	// the entry is evicted. New entries count as used on the last frame passed to Update().
+	EntryId Register(uint32_t mipCount, const uint64_t* pResidentSizes, uint32_t tailMip, uint32_t residentMip);
+
+	bool Unregister(EntryId id);
+
+	// Mark an entry as used on the given frame.
+	bool Touch(EntryId id, uint64_t frameIndex);
+
+	// Pinned entries still count against the budget, but are never trimmed, evicted or restored.
+	bool SetPinned(EntryId id, bool pinned);
+
+	// Override the resident mip of an entry, for when the caller could not apply an action.
+	bool SetResidentMip(EntryId id, uint32_t residentMip);
+
+	// Set the number of bytes an entry holds on top of its resident mips, such as a resource that is being replaced
+	// but can't be released yet. Pending bytes count against the budget but can't be reclaimed, so they only make the
+	// policy free up more memory from other entries.
+	bool SetPendingSize(EntryId id, uint64_t pendingSize);
+
+	// Advance to the given frame and fill the output array with the actions to apply. Each entry gets at most one
+	// action per call, and entries used on this frame are never trimmed or evicted. Returns the number of actions.
+	size_t Update(uint64_t frameIndex, Action* pOutActions, size_t maxActionCount);
+
+	void SetBudget(uint64_t byteBudget);
+
+	uint64_t GetBudget() const;
+	uint64_t GetResidentSize() const;
+	uint64_t GetPendingSize() const;
+	uint32_t GetResidentMip(EntryId id) const;
+	size_t GetEntryCount() const;
+
+
+private:
+
+	struct EntryMap;
+
+	uint64_t _reclaim(uint64_t, uint64_t, Action*, size_t, size_t&);
+
+	EntryMap* m_pEntries;
+
+	uint64_t m_budget;
+	uint64_t m_residentSize;
+	uint64_t m_pendingSize;
+	uint64_t m_frameIndex;
+	uint64_t m_updateIndex;
+
+	EntryId m_nextId;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::Utility::ResidencyPolicy::SetBudget(const uint64_t byteBudget)
+{
+	m_budget = byteBudget;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::ResidencyPolicy::GetBudget() const
+{
+	return m_budget;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::ResidencyPolicy::GetResidentSize() const
+{
+	return m_residentSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::ResidencyPolicy::GetPendingSize() const
+{
+	return m_pendingSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
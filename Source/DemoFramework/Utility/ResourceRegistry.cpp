@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ResourceRegistry.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_RESOURCE_REGISTRY_MIN_PRUNE_THRESHOLD 64
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the entry map using PIMPL to make MSVC shut up about std::unordered_map<> needing a DLL interface.
+struct DemoFramework::Utility::ResourceRegistry::EntryMap
+{
+	// Result of a load that's still in flight, shared with every caller waiting on it.
+	struct PendingLoad
+	{
+		ObjectPtr object;
+		bool done;
+	};
+
+	struct Entry
+	{
+		std::weak_ptr<void> object;
+		std::shared_ptr<PendingLoad> pending;
+	};
+
+	// Completes a load when it goes out of scope, so the callers waiting on it are let go even when the load function
+	// throws. The load counts as failed unless it set 'object'.
+	struct LoadScope
+	{
+		LoadScope(EntryMap& entries, uint64_t key, const std::shared_ptr<PendingLoad>& pending);
+		LoadScope(const LoadScope&) = delete;
+		~LoadScope();
+
+		LoadScope& operator =(const LoadScope&) = delete;
+
+		EntryMap& entries;
+		uint64_t key;
+		std::shared_ptr<PendingLoad> pending;
+
+		ObjectPtr object;
+	};
+
+	void PruneLocked();
+
+	std::unordered_map<uint64_t, Entry> map;
+
+	mutable std::mutex mutex;
+	std::condition_variable loadDone;
+
+	Stats stats;
+
+	// Expired entries are pruned when the map grows to this size.
+	size_t pruneThreshold;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ResourceRegistry::EntryMap::PruneLocked()
+{
+	for(auto it = map.begin(); it != map.end();)
+	{
+		if(!it->second.pending && it->second.object.expired())
+		{
+			it = map.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// Doubling the threshold from the live entry count keeps the pruning cost constant per insertion.
+	pruneThreshold = map.size() * 2;
+	if(pruneThreshold < DF_RESOURCE_REGISTRY_MIN_PRUNE_THRESHOLD)
+	{
+		pruneThreshold = DF_RESOURCE_REGISTRY_MIN_PRUNE_THRESHOLD;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::EntryMap::LoadScope::LoadScope(
+	EntryMap& entries,
+	const uint64_t key,
+	const std::shared_ptr<PendingLoad>& pending)
+	: entries(entries)
+	, key(key)
+	, pending(pending)
+	, object()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::EntryMap::LoadScope::~LoadScope()
+{
+	{
+		std::lock_guard<std::mutex> lock(entries.mutex);
+
+		// Other threads may have rehashed the map in the meantime, so the entry needs to be looked up again. It can't
+		// have been removed, since pruning skips entries with a load in flight.
+		Entry& entry = entries.map[key];
+
+		entry.pending.reset();
+		entry.object = object;
+
+		if(!object)
+		{
+			++entries.stats.failedCount;
+			entries.map.erase(key);
+		}
+
+		pending->object = object;
+		pending->done = true;
+	}
+
+	entries.loadDone.notify_all();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::ResourceRegistry()
+	: m_pEntries(new EntryMap())
+{
+	m_pEntries->stats = Stats();
+	m_pEntries->pruneThreshold = DF_RESOURCE_REGISTRY_MIN_PRUNE_THRESHOLD;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::~ResourceRegistry()
+{
+	if(m_pEntries)
+	{
+		delete m_pEntries;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::ObjectPtr DemoFramework::Utility::ResourceRegistry::FindOrLoad(
+	const uint64_t key,
+	const LoadFunc& load)
+{
+	std::unique_lock<std::mutex> lock(m_pEntries->mutex);
+
+	auto it = m_pEntries->map.find(key);
+	if(it != m_pEntries->map.end())
+	{
+		ObjectPtr object = it->second.object.lock();
+		if(object)
+		{
+			++m_pEntries->stats.hitCount;
+			return object;
+		}
+
+		if(it->second.pending)
+		{
+			++m_pEntries->stats.coalescedCount;
+
+			// Keep the load result alive ourselves, since the entry is updated (or removed) once the load finishes.
+			const std::shared_ptr<EntryMap::PendingLoad> pending = it->second.pending;
+
+			m_pEntries->loadDone.wait(lock, [&pending]() { return pending->done; });
+
+			return pending->object;
+		}
+	}
+	else
+	{
+		if(m_pEntries->map.size() >= m_pEntries->pruneThreshold)
+		{
+			m_pEntries->PruneLocked();
+		}
+
+		it = m_pEntries->map.emplace(key, EntryMap::Entry()).first;
+	}
+
+	++m_pEntries->stats.loadCount;
+
+	const std::shared_ptr<EntryMap::PendingLoad> pending = std::make_shared<EntryMap::PendingLoad>();
+	pending->done = false;
+
+	it->second.pending = pending;
+
+	lock.unlock();
+
+	EntryMap::LoadScope loadScope(*m_pEntries, key, pending);
+
+	if(load)
+	{
+		loadScope.object = load();
+	}
+
+	return loadScope.object;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::ObjectPtr DemoFramework::Utility::ResourceRegistry::Find(const uint64_t key) const
+{
+	std::lock_guard<std::mutex> lock(m_pEntries->mutex);
+
+	auto it = m_pEntries->map.find(key);
+	if(it == m_pEntries->map.end())
+	{
+		return ObjectPtr();
+	}
+
+	return it->second.object.lock();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ResourceRegistry::Prune()
+{
+	std::lock_guard<std::mutex> lock(m_pEntries->mutex);
+
+	m_pEntries->PruneLocked();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::ResourceRegistry::GetEntryCount() const
+{
+	std::lock_guard<std::mutex> lock(m_pEntries->mutex);
+
+	return m_pEntries->map.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ResourceRegistry::Stats DemoFramework::Utility::ResourceRegistry::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_pEntries->mutex);
+
+	return m_pEntries->stats;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
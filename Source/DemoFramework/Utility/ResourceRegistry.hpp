@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <functional>
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ResourceRegistry;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Thread-safe map from a 64-bit key to a shared object, so that everything asking for the same key ends up sharing
+// one instance. Objects are only held weakly and drop out of the registry once the last outside reference goes away.
+// When a key isn't loaded yet, the first caller runs the load function while every other caller asking for the same
+// key waits for it and receives the same result, so one object is never loaded twice at the same time. Loads of
+// different keys run concurrently; the registry lock is never held while loading.
+//
+// Objects are stored type-erased. Wrappers like TextureRegistry cast them back to their real type.
+class DF_API DemoFramework::Utility::ResourceRegistry
+{
+public:
+
+	typedef std::shared_ptr<void> ObjectPtr;
+	typedef std::function<ObjectPtr()> LoadFunc;
+
+	struct Stats
+	{
+		uint64_t hitCount;       // Requests answered by an object that was already loaded
+		uint64_t loadCount;      // Requests that ran the load function
+		uint64_t coalescedCount; // Requests that waited on a load already in flight
+		uint64_t failedCount;    // Loads that returned nothing
+	};
+
+	ResourceRegistry();
+	ResourceRegistry(const ResourceRegistry&) = delete;
+	ResourceRegistry(ResourceRegistry&&) = delete;
+	~ResourceRegistry();
+
+	ResourceRegistry& operator =(const ResourceRegistry&) = delete;
+	ResourceRegistry& operator =(ResourceRegistry&&) = delete;
+
+	// Get the object registered under a key, loading it when there isn't one. Failed loads aren't remembered, so the
+	// next request for the same key tries again, but callers that were waiting on the failed load get nothing. A load
+	// function that throws counts as a failed load, and the exception is passed on to the caller that ran it. The load
+	// function must not request the same key again, and shouldn't be run from a thread pool task that the load itself
+	// needs the pool to finish.
+	ObjectPtr FindOrLoad(uint64_t key, const LoadFunc& load);
+
+	// Get the object registered under a key without loading it. Loads that are in flight aren't waited on.
+	ObjectPtr Find(uint64_t key) const;
+
+	// Remove the entries of objects that no longer exist. This also happens on its own as entries pile up.
+	void Prune();
+
+	// Number of entries, including those of objects destroyed since the last prune.
+	size_t GetEntryCount() const;
+
+	Stats GetStats() const;
+
+
+private:
+
+	struct EntryMap;
+
+	EntryMap* m_pEntries;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
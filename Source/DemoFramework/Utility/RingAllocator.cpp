@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "RingAllocator.hpp"
+
+#include <deque>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the batch queue using PIMPL to make MSVC shut up about std::deque<> needing a DLL interface.
+struct DemoFramework::Utility::RingAllocator::BatchQueue
+{
+	struct Batch
+	{
+		uint64_t fenceValue;
+		uint64_t size;
+	};
+
+	// Batches are closed in fence order, so the front of the queue is always the next to be retired.
+	std::deque<Batch> list;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::RingAllocator::RingAllocator()
+	: m_pBatches(new BatchQueue())
+	, m_capacity(0)
+	, m_head(0)
+	, m_usedSize(0)
+	, m_openSize(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::RingAllocator::~RingAllocator()
+{
+	if(m_pBatches)
+	{
+		delete m_pBatches;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::RingAllocator::Reset(const uint64_t capacity)
+{
+	m_pBatches->list.clear();
+
+	m_capacity = capacity;
+	m_head = 0;
+	m_usedSize = 0;
+	m_openSize = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::Utility::RingAllocator::Allocate(const uint64_t size, const uint64_t alignment)
+{
+	if(size == 0 || size > m_capacity)
+	{
+		return InvalidOffset;
+	}
+
+	const uint64_t align = (alignment > 0) ? alignment : 1;
+
+	uint64_t offset = ((m_head + align - 1) / align) * align;
+
+	if(offset > m_capacity || size > (m_capacity - offset))
+	{
+		// Not enough room before the end of the ring, so skip what's left of it and start over from the beginning.
+		offset = 0;
+	}
+
+	// The used space always runs contiguously (with wrapping) from the oldest allocation to the head, so everything
+	// from the head up to the end of the new allocation, including any padding or skipped space, has to be free.
+	const uint64_t consumedSize = (offset >= m_head)
+		? (offset - m_head) + size
+		: (m_capacity - m_head) + size;
+
+	if(consumedSize > (m_capacity - m_usedSize))
+	{
+		return InvalidOffset;
+	}
+
+	m_head = offset + size;
+	m_usedSize += consumedSize;
+	m_openSize += consumedSize;
+
+	return offset;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::RingAllocator::Close(const uint64_t fenceValue)
+{
+	if(m_openSize == 0)
+	{
+		return;
+	}
+
+	const BatchQueue::Batch batch =
+	{
+		fenceValue, // uint64_t fenceValue
+		m_openSize, // uint64_t size
+	};
+
+	m_pBatches->list.push_back(batch);
+	m_openSize = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::RingAllocator::Retire(const uint64_t completedFenceValue)
+{
+	std::deque<BatchQueue::Batch>& list = m_pBatches->list;
+
+	while(!list.empty() && list.front().fenceValue <= completedFenceValue)
+	{
+		m_usedSize -= list.front().size;
+		list.pop_front();
+	}
+
+	if(m_usedSize == 0)
+	{
+		// Start over from the beginning of the ring when it's empty so the next allocations don't have to wrap.
+		m_head = 0;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::RingAllocator::GetOldestFenceValue(uint64_t& outFenceValue) const
+{
+	if(m_pBatches->list.empty())
+	{
+		return false;
+	}
+
+	outFenceValue = m_pBatches->list.front().fenceValue;
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class RingAllocator;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Bookkeeping for a ring buffer whose allocations are released in batches once a fence value has been reached. New
+// allocations are "open" until Close() tags them with a fence value, and Retire() frees every closed batch whose fence
+// value has completed. Like StreamScheduler, this never touches any GPU objects, so the same logic can be exercised
+// without a device.
+class DF_API DemoFramework::Utility::RingAllocator
+{
+public:
+
+	static constexpr uint64_t InvalidOffset = UINT64_MAX;
+
+	RingAllocator();
+	RingAllocator(const RingAllocator&) = delete;
+	RingAllocator(RingAllocator&&) = delete;
+	~RingAllocator();
+
+	RingAllocator& operator =(const RingAllocator&) = delete;
+	RingAllocator& operator =(RingAllocator&&) = delete;
+
+	// Free everything and set the size of the ring.
+	void Reset(uint64_t capacity);
+
+	// Return the offset of a new allocation, or InvalidOffset when there isn't enough contiguous space left. The offset
+	// is a multiple of 'alignment', which doesn't need to be a power of 2. Allocations never wrap around the end of the
+	// ring; the space skipped at the end is freed along with the allocation.
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	// Tag all open allocations with a fence value. Fence values must increase with each call.
+	void Close(uint64_t fenceValue);
+
+	// Free every closed batch with a fence value less than or equal to the completed value.
+	void Retire(uint64_t completedFenceValue);
+
+	// Get the fence value of the oldest batch waiting to be retired. Returns false when nothing is waiting.
+	bool GetOldestFenceValue(uint64_t& outFenceValue) const;
+
+	uint64_t GetCapacity() const;
+	uint64_t GetUsedSize() const;
+	uint64_t GetOpenSize() const;
+
+
+private:
+
+	struct BatchQueue;
+
+	BatchQueue* m_pBatches;
+
+	uint64_t m_capacity;
+	uint64_t m_head;
+	uint64_t m_usedSize;
+	uint64_t m_openSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::RingAllocator::GetCapacity() const
+{
+	return m_capacity;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::RingAllocator::GetUsedSize() const
+{
+	return m_usedSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::RingAllocator::GetOpenSize() const
+{
+	return m_openSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
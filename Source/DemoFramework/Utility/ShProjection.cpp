@@ -0,0 +1,653 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ShProjection.hpp"
+#include "CpuFeatures.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The scalar and AVX2 kernels only give the same bits if every multiply and add is rounded on its own. MSVC keeps them
+// apart under /fp:precise, but GCC and clang fuse them into FMAs by default when targeting a CPU that has them, in the
+// scalar code and in the AVX2 intrinsics alike.
+#if defined(__clang__)
+	#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Values summed per texel: 3 color channels for each coefficient, followed by the solid angle weight.
+#define DF_SH_PROJECTION_SUM_COUNT ((DF_SH_PROJECTION_COEFF_COUNT * 3) + 1)
+#define DF_SH_PROJECTION_WEIGHT_INDEX (DF_SH_PROJECTION_COEFF_COUNT * 3)
+
+// Rows are summed in leaves of 4 groups of 8 texels. Each group of 8 is spread across the lanes of one AVX2 register,
+// and the scalar path keeps the same lanes so both paths add things up in the same order.
+#define DF_SH_PROJECTION_LANE_COUNT 8
+#define DF_SH_PROJECTION_LEAF_GROUP_COUNT 4
+#define DF_SH_PROJECTION_LEAF_TEXEL_COUNT (DF_SH_PROJECTION_LANE_COUNT * DF_SH_PROJECTION_LEAF_GROUP_COUNT)
+#define DF_SH_PROJECTION_LEAF_SIZE (DF_SH_PROJECTION_SUM_COUNT * DF_SH_PROJECTION_LANE_COUNT)
+
+// Enough levels of pairwise summation for rows of 2^32 texels.
+#define DF_SH_PROJECTION_MAX_LEVEL_COUNT 32
+
+// Minimum number of texels handed to each thread pool task.
+#define DF_SH_PROJECTION_TASK_TEXEL_COUNT 16384
+
+#define DF_SH_PROJECTION_FACE_COUNT 6
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The same constants as the reflection probe shaders.
+static constexpr float32_t ShConstY00 = 0.28209479177387814347403972578039f;  // sqrt(1 / 4pi)
+static constexpr float32_t ShConstY1 = 0.48860251190291992158638462283835f;   // sqrt(3 / 4pi)
+static constexpr float32_t ShConstY2_2 = 1.0925484305920790705433857058027f;  // sqrt(15 / 4pi)
+static constexpr float32_t ShConstY20 = 0.31539156525252000603089369029571f;  // sqrt(5 / 16pi)
+static constexpr float32_t ShConstY22 = 0.54627421529603953527169285290134f;  // sqrt(15 / 16pi)
+
+static constexpr float32_t CosineLobeA0 = 3.1415926535897932384626433832795f;  // pi
+static constexpr float32_t CosineLobeA1 = 2.0943951023931954923084289221863f;  // 2pi / 3
+static constexpr float32_t CosineLobeA2 = 0.78539816339744830961566084581988f; // pi / 4
+
+static constexpr float32_t FourPi = 12.566370614359172953850573533118f;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Direction of the texels of a row of a cube face, as 'normal = (axisU * u) + axisOffset' before normalization, where
+// u is the horizontal face coordinate in [-1, 1]. Multiplying by 0 or +/-1 and adding 0 is exact, so this gives the
+// same bits as building the vector per face the way the shaders do.
+struct RowFrame
+{
+	float32_t axisU[3];
+	float32_t axisOffset[3];
+	float32_t vSquared;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cascade of partial sums for pairwise summation of a stream of leaves. Leaf n is merged with earlier leaves following
+// the binary representation of n, which builds the same summation tree for a given number of leaves no matter which
+// thread produced them.
+struct PairwiseSums
+{
+	alignas(32) float32_t levels[DF_SH_PROJECTION_MAX_LEVEL_COUNT][DF_SH_PROJECTION_LEAF_SIZE];
+
+	uint32_t count;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline float32_t GetFaceCoord(const uint32_t coord, const float32_t invEdgeLength)
+{
+	return (((float32_t(coord) + 0.5f) * invEdgeLength) * 2.0f) - 1.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static RowFrame GetRowFrame(const uint32_t y, const uint32_t faceIndex, const float32_t invEdgeLength)
+{
+	const float32_t v = GetFaceCoord(y, invEdgeLength);
+
+	// The texture coordinates increase downward while the Y axis increases upward.
+	const float32_t flippedV = -v;
+
+	RowFrame output;
+	memset(&output, 0, sizeof(output));
+
+	output.vSquared = v * v;
+
+	switch(faceIndex)
+	{
+		case 0: // +X
+			output.axisOffset[0] = 1.0f;
+			output.axisOffset[1] = flippedV;
+			output.axisU[2] = -1.0f;
+			break;
+
+		case 1: // -X
+			output.axisOffset[0] = -1.0f;
+			output.axisOffset[1] = flippedV;
+			output.axisU[2] = 1.0f;
+			break;
+
+		case 2: // +Y
+			output.axisU[0] = 1.0f;
+			output.axisOffset[1] = 1.0f;
+			output.axisOffset[2] = -flippedV;
+			break;
+
+		case 3: // -Y
+			output.axisU[0] = 1.0f;
+			output.axisOffset[1] = -1.0f;
+			output.axisOffset[2] = flippedV;
+			break;
+
+		case 4: // +Z
+			output.axisU[0] = 1.0f;
+			output.axisOffset[1] = flippedV;
+			output.axisOffset[2] = 1.0f;
+			break;
+
+		default: // -Z
+			output.axisU[0] = -1.0f;
+			output.axisOffset[1] = flippedV;
+			output.axisOffset[2] = -1.0f;
+			break;
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void AddLeaf(PairwiseSums& sums, const float32_t* const pLeaf)
+{
+	alignas(32) float32_t carry[DF_SH_PROJECTION_LEAF_SIZE];
+	memcpy(carry, pLeaf, sizeof(carry));
+
+	uint32_t level = 0;
+
+	for(uint32_t count = sums.count; (count & 1) != 0; count >>= 1, ++level)
+	{
+		for(uint32_t i = 0; i < DF_SH_PROJECTION_LEAF_SIZE; ++i)
+		{
+			carry[i] = sums.levels[level][i] + carry[i];
+		}
+	}
+
+	memcpy(sums.levels[level], carry, sizeof(carry));
+
+	++sums.count;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Finish the pairwise sum of a row, then add up the lanes of the result.
+static void ResolveSums(const PairwiseSums& sums, float32_t* const pOutSums)
+{
+	alignas(32) float32_t total[DF_SH_PROJECTION_LEAF_SIZE] = {};
+
+	uint32_t level = 0;
+
+	for(uint32_t count = sums.count; count != 0; count >>= 1, ++level)
+	{
+		if((count & 1) != 0)
+		{
+			for(uint32_t i = 0; i < DF_SH_PROJECTION_LEAF_SIZE; ++i)
+			{
+				total[i] = sums.levels[level][i] + total[i];
+			}
+		}
+	}
+
+	for(uint32_t sumIndex = 0; sumIndex < DF_SH_PROJECTION_SUM_COUNT; ++sumIndex)
+	{
+		const float32_t* const pLanes = total + (sumIndex * DF_SH_PROJECTION_LANE_COUNT);
+
+		pOutSums[sumIndex] = ((pLanes[0] + pLanes[1]) + (pLanes[2] + pLanes[3])) + ((pLanes[4] + pLanes[5]) + (pLanes[6] + pLanes[7]));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Pairwise sum of the sums of a range of rows.
+static void SumRows(const float32_t* const pRowSums, const size_t rowCount, float32_t* const pOutSums)
+{
+	if(rowCount == 1)
+	{
+		memcpy(pOutSums, pRowSums, sizeof(float32_t) * DF_SH_PROJECTION_SUM_COUNT);
+		return;
+	}
+
+	const size_t half = rowCount / 2;
+
+	float32_t upper[DF_SH_PROJECTION_SUM_COUNT];
+
+	SumRows(pRowSums, half, pOutSums);
+	SumRows(pRowSums + (half * DF_SH_PROJECTION_SUM_COUNT), rowCount - half, upper);
+
+	for(uint32_t i = 0; i < DF_SH_PROJECTION_SUM_COUNT; ++i)
+	{
+		pOutSums[i] += upper[i];
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Scalar kernels
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SumRowScalar(
+	const float32_t* const pRow,
+	const RowFrame& frame,
+	const uint32_t edgeLength,
+	const float32_t invEdgeLength,
+	float32_t* const pOutSums)
+{
+	PairwiseSums sums;
+	sums.count = 0;
+
+	alignas(32) float32_t leaf[DF_SH_PROJECTION_LEAF_SIZE];
+
+	for(uint32_t leafX = 0; leafX < edgeLength; leafX += DF_SH_PROJECTION_LEAF_TEXEL_COUNT)
+	{
+		memset(leaf, 0, sizeof(leaf));
+
+		for(uint32_t group = 0; group < DF_SH_PROJECTION_LEAF_GROUP_COUNT; ++group)
+		{
+			for(uint32_t lane = 0; lane < DF_SH_PROJECTION_LANE_COUNT; ++lane)
+			{
+				const uint32_t x = leafX + (group * DF_SH_PROJECTION_LANE_COUNT) + lane;
+
+				if(x >= edgeLength)
+				{
+					continue;
+				}
+
+				const float32_t u = GetFaceCoord(x, invEdgeLength);
+
+				const float32_t tmp = (1.0f + (u * u)) + frame.vSquared;
+				const float32_t length = sqrtf(tmp);
+				const float32_t invLength = 1.0f / length;
+				const float32_t diffAngle = 4.0f / (length * tmp);
+
+				float32_t normal[3];
+
+				for(uint32_t i = 0; i < 3; ++i)
+				{
+					normal[i] = ((frame.axisU[i] * u) + frame.axisOffset[i]) * invLength;
+				}
+
+				const DemoFramework::Utility::ShProjection::Basis basis = DemoFramework::Utility::ShProjection::CalculateShProjectionBasis(normal);
+
+				const float32_t* const pColor = pRow + (size_t(x) * 4);
+
+				for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+				{
+					for(uint32_t channel = 0; channel < 3; ++channel)
+					{
+						float32_t& sum = leaf[(((coeffIndex * 3) + channel) * DF_SH_PROJECTION_LANE_COUNT) + lane];
+						sum += (pColor[channel] * diffAngle) * basis.value[coeffIndex];
+					}
+				}
+
+				leaf[(DF_SH_PROJECTION_WEIGHT_INDEX * DF_SH_PROJECTION_LANE_COUNT) + lane] += diffAngle;
+			}
+		}
+
+		AddLeaf(sums, leaf);
+	}
+
+	ResolveSums(sums, pOutSums);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// AVX2 kernels
+//
+// These are only ever called after checking CpuFeatures::HasAvx2().
+//---------------------------------------------------------------------------------------------------------------------
+
+// Split 8 RGBA texels into one register per color channel.
+static void LoadRgbAvx2(const float32_t* const pTexels, __m256& outRed, __m256& outGreen, __m256& outBlue)
+{
+	const __m256 texels01 = _mm256_loadu_ps(pTexels);
+	const __m256 texels23 = _mm256_loadu_ps(pTexels + 8);
+	const __m256 texels45 = _mm256_loadu_ps(pTexels + 16);
+	const __m256 texels67 = _mm256_loadu_ps(pTexels + 24);
+
+	// Texels 0-3 in the low half of each register and 4-7 in the high half.
+	const __m256 texels04 = _mm256_permute2f128_ps(texels01, texels45, 0x20);
+	const __m256 texels15 = _mm256_permute2f128_ps(texels01, texels45, 0x31);
+	const __m256 texels26 = _mm256_permute2f128_ps(texels23, texels67, 0x20);
+	const __m256 texels37 = _mm256_permute2f128_ps(texels23, texels67, 0x31);
+
+	const __m256 redGreen01 = _mm256_unpacklo_ps(texels04, texels15);
+	const __m256 blueAlpha01 = _mm256_unpackhi_ps(texels04, texels15);
+	const __m256 redGreen23 = _mm256_unpacklo_ps(texels26, texels37);
+	const __m256 blueAlpha23 = _mm256_unpackhi_ps(texels26, texels37);
+
+	outRed = _mm256_shuffle_ps(redGreen01, redGreen23, _MM_SHUFFLE(1, 0, 1, 0));
+	outGreen = _mm256_shuffle_ps(redGreen01, redGreen23, _MM_SHUFFLE(3, 2, 3, 2));
+	outBlue = _mm256_shuffle_ps(blueAlpha01, blueAlpha23, _MM_SHUFFLE(1, 0, 1, 0));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void SumRowAvx2(
+	const float32_t* const pRow,
+	const RowFrame& frame,
+	const uint32_t edgeLength,
+	const float32_t invEdgeLength,
+	float32_t* const pOutSums)
+{
+	PairwiseSums sums;
+	sums.count = 0;
+
+	alignas(32) float32_t leaf[DF_SH_PROJECTION_LEAF_SIZE];
+	alignas(32) float32_t edgeTexels[DF_SH_PROJECTION_LANE_COUNT * 4];
+
+	const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+	const __m256 laneIndices = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 invEdge = _mm256_set1_ps(invEdgeLength);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 three = _mm256_set1_ps(3.0f);
+	const __m256 four = _mm256_set1_ps(4.0f);
+	const __m256 vSquared = _mm256_set1_ps(frame.vSquared);
+
+	const __m256 axisU[3] =
+	{
+		_mm256_set1_ps(frame.axisU[0]),
+		_mm256_set1_ps(frame.axisU[1]),
+		_mm256_set1_ps(frame.axisU[2]),
+	};
+
+	const __m256 axisOffset[3] =
+	{
+		_mm256_set1_ps(frame.axisOffset[0]),
+		_mm256_set1_ps(frame.axisOffset[1]),
+		_mm256_set1_ps(frame.axisOffset[2]),
+	};
+
+	for(uint32_t leafX = 0; leafX < edgeLength; leafX += DF_SH_PROJECTION_LEAF_TEXEL_COUNT)
+	{
+		memset(leaf, 0, sizeof(leaf));
+
+		for(uint32_t group = 0; group < DF_SH_PROJECTION_LEAF_GROUP_COUNT; ++group)
+		{
+			const uint32_t groupX = leafX + (group * DF_SH_PROJECTION_LANE_COUNT);
+
+			if(groupX >= edgeLength)
+			{
+				break;
+			}
+
+			const uint32_t texelCount = (edgeLength - groupX < DF_SH_PROJECTION_LANE_COUNT) ? (edgeLength - groupX) : DF_SH_PROJECTION_LANE_COUNT;
+
+			// Texels past the edge of the face are loaded as black from a zeroed copy, and get a weight of zero below.
+			const float32_t* pTexels = pRow + (size_t(groupX) * 4);
+
+			if(texelCount < DF_SH_PROJECTION_LANE_COUNT)
+			{
+				memset(edgeTexels, 0, sizeof(edgeTexels));
+				memcpy(edgeTexels, pTexels, sizeof(float32_t) * 4 * texelCount);
+
+				pTexels = edgeTexels;
+			}
+
+			__m256 red;
+			__m256 green;
+			__m256 blue;
+
+			LoadRgbAvx2(pTexels, red, green, blue);
+
+			const __m256 x = _mm256_add_ps(_mm256_set1_ps(float32_t(groupX)), laneOffsets);
+			const __m256 u = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(x, invEdge), two), one);
+
+			const __m256 tmp = _mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(u, u)), vSquared);
+			const __m256 length = _mm256_sqrt_ps(tmp);
+			const __m256 invLength = _mm256_div_ps(one, length);
+			const __m256 inRange = _mm256_cmp_ps(laneIndices, _mm256_set1_ps(float32_t(texelCount)), _CMP_LT_OQ);
+			const __m256 diffAngle = _mm256_and_ps(_mm256_div_ps(four, _mm256_mul_ps(length, tmp)), inRange);
+
+			const __m256 nx = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(axisU[0], u), axisOffset[0]), invLength);
+			const __m256 ny = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(axisU[1], u), axisOffset[1]), invLength);
+			const __m256 nz = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(axisU[2], u), axisOffset[2]), invLength);
+
+			const __m256 basis[DF_SH_PROJECTION_COEFF_COUNT] =
+			{
+				_mm256_set1_ps(ShConstY00),
+				_mm256_mul_ps(_mm256_set1_ps(ShConstY1), ny),
+				_mm256_mul_ps(_mm256_set1_ps(ShConstY1), nz),
+				_mm256_mul_ps(_mm256_set1_ps(ShConstY1), nx),
+				_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(ShConstY2_2), ny), nx),
+				_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(ShConstY2_2), ny), nz),
+				_mm256_mul_ps(_mm256_set1_ps(ShConstY20), _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(three, nz), nz), one)),
+				_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(ShConstY2_2), nx), nz),
+				_mm256_mul_ps(_mm256_set1_ps(ShConstY22), _mm256_sub_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny))),
+			};
+
+			const __m256 weightedColor[3] =
+			{
+				_mm256_mul_ps(red, diffAngle),
+				_mm256_mul_ps(green, diffAngle),
+				_mm256_mul_ps(blue, diffAngle),
+			};
+
+			for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+			{
+				for(uint32_t channel = 0; channel < 3; ++channel)
+				{
+					float32_t* const pSum = leaf + (((coeffIndex * 3) + channel) * DF_SH_PROJECTION_LANE_COUNT);
+
+					_mm256_store_ps(pSum, _mm256_add_ps(_mm256_load_ps(pSum), _mm256_mul_ps(weightedColor[channel], basis[coeffIndex])));
+				}
+			}
+
+			float32_t* const pWeightSum = leaf + (DF_SH_PROJECTION_WEIGHT_INDEX * DF_SH_PROJECTION_LANE_COUNT);
+
+			_mm256_store_ps(pWeightSum, _mm256_add_ps(_mm256_load_ps(pWeightSum), diffAngle));
+		}
+
+		AddLeaf(sums, leaf);
+	}
+
+	ResolveSums(sums, pOutSums);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ShProjection::CalculateNormalFromPixelCoord(
+	const uint32_t x,
+	const uint32_t y,
+	const uint32_t faceIndex,
+	const float32_t invEdgeLength,
+	float32_t* const pOutNormal)
+{
+	const RowFrame frame = GetRowFrame(y, faceIndex, invEdgeLength);
+
+	const float32_t u = GetFaceCoord(x, invEdgeLength);
+	const float32_t invLength = 1.0f / sqrtf((1.0f + (u * u)) + frame.vSquared);
+
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		pOutNormal[i] = ((frame.axisU[i] * u) + frame.axisOffset[i]) * invLength;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ShProjection::Basis DemoFramework::Utility::ShProjection::CalculateShProjectionBasis(const float32_t* const pNormal)
+{
+	const float32_t x = pNormal[0];
+	const float32_t y = pNormal[1];
+	const float32_t z = pNormal[2];
+
+	Basis output;
+
+	// Band 0
+	output.value[0] = ShConstY00;
+
+	// Band 1
+	output.value[1] = ShConstY1 * y;
+	output.value[2] = ShConstY1 * z;
+	output.value[3] = ShConstY1 * x;
+
+	// Band 2
+	output.value[4] = (ShConstY2_2 * y) * x;
+	output.value[5] = (ShConstY2_2 * y) * z;
+	output.value[6] = ShConstY20 * (((3.0f * z) * z) - 1.0f);
+	output.value[7] = (ShConstY2_2 * x) * z;
+	output.value[8] = ShConstY22 * ((x * x) - (y * y));
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ShProjection::Basis DemoFramework::Utility::ShProjection::CalculateShReconstructionBasis(const float32_t* const pNormal)
+{
+	static constexpr float32_t lobes[DF_SH_PROJECTION_COEFF_COUNT] =
+	{
+		CosineLobeA0,
+		CosineLobeA1, CosineLobeA1, CosineLobeA1,
+		CosineLobeA2, CosineLobeA2, CosineLobeA2, CosineLobeA2, CosineLobeA2,
+	};
+
+	Basis output = CalculateShProjectionBasis(pNormal);
+
+	for(uint32_t i = 0; i < DF_SH_PROJECTION_COEFF_COUNT; ++i)
+	{
+		output.value[i] *= lobes[i];
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+float32_t DemoFramework::Utility::ShProjection::CalculateDifferentialSolidAngle(const uint32_t x, const uint32_t y, const float32_t invEdgeLength)
+{
+	const float32_t u = GetFaceCoord(x, invEdgeLength);
+	const float32_t v = GetFaceCoord(y, invEdgeLength);
+	const float32_t tmp = (1.0f + (u * u)) + (v * v);
+
+	return 4.0f / (sqrtf(tmp) * tmp);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ShProjection::Normalize(Coefficients& coefficients, const float32_t weightSum)
+{
+	// Divide first to keep the values in a good range; the sums of large cube maps get very big.
+	for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+	{
+		for(uint32_t channel = 0; channel < 3; ++channel)
+		{
+			coefficients.value[coeffIndex][channel] = (coefficients.value[coeffIndex][channel] / weightSum) * FourPi;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::ShProjection::Project(
+	const ImageResampler::ConstImage* const pFaces,
+	const uint32_t edgeLength,
+	ThreadPool* const pThreadPool,
+	Coefficients& outCoefficients)
+{
+	if(!pFaces || edgeLength == 0)
+	{
+		return false;
+	}
+
+	for(uint32_t faceIndex = 0; faceIndex < DF_SH_PROJECTION_FACE_COUNT; ++faceIndex)
+	{
+		const ImageResampler::ConstImage& face = pFaces[faceIndex];
+
+		if(!face.pData
+			|| face.width != edgeLength
+			|| face.height != edgeLength
+			|| face.rowPitch < size_t(edgeLength) * sizeof(float32_t) * 4)
+		{
+			return false;
+		}
+	}
+
+	const float32_t invEdgeLength = 1.0f / float32_t(edgeLength);
+	const size_t rowCount = size_t(edgeLength) * DF_SH_PROJECTION_FACE_COUNT;
+	const size_t rowsPerTask = (edgeLength < DF_SH_PROJECTION_TASK_TEXEL_COUNT) ? (DF_SH_PROJECTION_TASK_TEXEL_COUNT / edgeLength) : 1;
+	const size_t taskCount = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+	const auto sumRow = CpuFeatures::HasAvx2() ? SumRowAvx2 : SumRowScalar;
+
+	// Each row is summed into its own slot, so which thread handles it makes no difference to the result.
+	std::vector<float32_t> rowSums(rowCount * DF_SH_PROJECTION_SUM_COUNT);
+
+	auto sumRows = [&](const size_t taskIndex)
+	{
+		const size_t rowBegin = taskIndex * rowsPerTask;
+		const size_t rowEnd = (rowBegin + rowsPerTask < rowCount) ? (rowBegin + rowsPerTask) : rowCount;
+
+		for(size_t rowIndex = rowBegin; rowIndex < rowEnd; ++rowIndex)
+		{
+			const uint32_t faceIndex = uint32_t(rowIndex / edgeLength);
+			const uint32_t y = uint32_t(rowIndex % edgeLength);
+
+			const ImageResampler::ConstImage& face = pFaces[faceIndex];
+
+			sumRow(
+				reinterpret_cast<const float32_t*>(face.pData + (face.rowPitch * y)),
+				GetRowFrame(y, faceIndex, invEdgeLength),
+				edgeLength,
+				invEdgeLength,
+				rowSums.data() + (rowIndex * DF_SH_PROJECTION_SUM_COUNT));
+		}
+	};
+
+	if(pThreadPool)
+	{
+		pThreadPool->ParallelFor(taskCount, sumRows);
+	}
+	else
+	{
+		for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+		{
+			sumRows(taskIndex);
+		}
+	}
+
+	float32_t totals[DF_SH_PROJECTION_SUM_COUNT];
+
+	SumRows(rowSums.data(), rowCount, totals);
+
+	memcpy(outCoefficients.value, totals, sizeof(outCoefficients.value));
+
+	Normalize(outCoefficients, totals[DF_SH_PROJECTION_WEIGHT_INDEX]);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ShProjection::ReconstructColor(
+	const Coefficients& coefficients,
+	const float32_t* const pNormal,
+	float32_t* const pOutColor)
+{
+	const Basis basis = CalculateShReconstructionBasis(pNormal);
+
+	for(uint32_t channel = 0; channel < 3; ++channel)
+	{
+		float32_t color = 0.0f;
+
+		for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+		{
+			color += coefficients.value[coeffIndex][channel] * basis.value[coeffIndex];
+		}
+
+		pOutColor[channel] = color;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
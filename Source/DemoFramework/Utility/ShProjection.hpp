@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ImageResampler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_SH_PROJECTION_COEFF_COUNT 9
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ShProjection;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// CPU implementation of the L2 spherical harmonic projection the reflection probe runs on the GPU through its
+// sh-project, sh-reduce and sh-normalize compute shaders, using the same basis, texel directions and solid angle
+// weights, so probes can be baked or validated without a GPU.
+//
+// Texels are processed 8 at a time with AVX2 when the CPU supports it, and rows of the cube faces are spread across a
+// thread pool. Every row is summed on its own and the row sums are then added up in a fixed order, with pairwise
+// summation at every level, so the result is the same no matter how many threads did the work.
+//
+// The AVX2 and scalar paths give the same bits as well, which requires that multiplies and adds are never fused into
+// FMAs. The source file turns contraction off for GCC and clang; with MSVC it must be built with /fp:precise or
+// /fp:strict, never /fp:fast.
+//
+// Cube faces are indexed in D3D12 order (+X, -X, +Y, -Y, +Z, -Z), which is also the order of the DF_CUBE_FACE_*
+// values used by the shaders.
+class DF_API DemoFramework::Utility::ShProjection
+{
+public:
+
+	// Laid out like ShColorCoefficients in the shaders so the two can be compared directly.
+	struct Coefficients
+	{
+		float32_t value[DF_SH_PROJECTION_COEFF_COUNT][3];
+	};
+
+	struct Basis
+	{
+		float32_t value[DF_SH_PROJECTION_COEFF_COUNT];
+	};
+
+	ShProjection() = delete;
+	ShProjection(const ShProjection&) = delete;
+	ShProjection(ShProjection&&) = delete;
+
+	// Normalized direction through the center of a texel of a cube face.
+	static void CalculateNormalFromPixelCoord(uint32_t x, uint32_t y, uint32_t faceIndex, float32_t invEdgeLength, float32_t* pOutNormal);
+
+	static Basis CalculateShProjectionBasis(const float32_t* pNormal);
+
+	// Projection basis scaled by the cosine lobe, for reconstructing irradiance.
+	static Basis CalculateShReconstructionBasis(const float32_t* pNormal);
+
+	// Solid angle covered by a texel of a cube face, up to a constant factor that normalization divides back out.
+	static float32_t CalculateDifferentialSolidAngle(uint32_t x, uint32_t y, float32_t invEdgeLength);
+
+	// Turn coefficients summed over a sphere of texels into the projection of the sphere, given the sum of the solid
+	// angle weights of those texels.
+	static void Normalize(Coefficients& coefficients, float32_t weightSum);
+
+	// Project a cube map into normalized coefficients. Each face is an RGBA32Float image of 'edgeLength' texels square;
+	// alpha is ignored. A null thread pool runs everything on the calling thread.
+	static bool Project(
+		const ImageResampler::ConstImage* pFaces,
+		uint32_t edgeLength,
+		ThreadPool* pThreadPool,
+		Coefficients& outCoefficients);
+
+	// Irradiance for a normal from coefficients produced by Project(), as sh-reconstruct computes it.
+	static void ReconstructColor(const Coefficients& coefficients, const float32_t* pNormal, float32_t* pOutColor);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
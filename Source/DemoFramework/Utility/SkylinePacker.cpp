@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "SkylinePacker.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the skyline using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::Utility::SkylinePacker::Skyline
+{
+	struct Node
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+	// Sorted left to right, covering the full width of the area with no gaps.
+	std::vector<Node> nodes;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::SkylinePacker::SkylinePacker()
+	: m_pSkyline(new Skyline())
+	, m_usedArea(0)
+	, m_width(0)
+	, m_height(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::SkylinePacker::~SkylinePacker()
+{
+	if(m_pSkyline)
+	{
+		delete m_pSkyline;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DemoFramework::Utility::SkylinePacker::PackPages(
+	const uint32_t pageWidth,
+	const uint32_t pageHeight,
+	const Size* const pSizes,
+	const size_t count,
+	PagePlacement* const pOutPlacements)
+{
+	if(pageWidth == 0 || pageHeight == 0 || !pSizes || count == 0 || !pOutPlacements)
+	{
+		return 0;
+	}
+
+	std::vector<size_t> order(count);
+
+	for(size_t index = 0; index < count; ++index)
+	{
+		if(pSizes[index].width == 0
+			|| pSizes[index].height == 0
+			|| pSizes[index].width > pageWidth
+			|| pSizes[index].height > pageHeight)
+		{
+			return 0;
+		}
+
+		order[index] = index;
+	}
+
+	// Placing the biggest rectangles first leaves the small ones to fill in the gaps.
+	std::sort(
+		order.begin(),
+		order.end(),
+		[pSizes](const size_t left, const size_t right)
+		{
+			if(pSizes[left].height != pSizes[right].height)
+			{
+				return pSizes[left].height > pSizes[right].height;
+			}
+
+			if(pSizes[left].width != pSizes[right].width)
+			{
+				return pSizes[left].width > pSizes[right].width;
+			}
+
+			return left < right;
+		});
+
+	std::vector<std::unique_ptr<SkylinePacker>> pagePackers;
+
+	for(const size_t index : order)
+	{
+		const Size& size = pSizes[index];
+
+		PagePlacement& placement = pOutPlacements[index];
+
+		bool placed = false;
+
+		// Try every page opened so far before starting a new one.
+		for(size_t pageIndex = 0; pageIndex < pagePackers.size() && !placed; ++pageIndex)
+		{
+			if(pagePackers[pageIndex]->Insert(size.width, size.height, placement.rect))
+			{
+				placement.pageIndex = uint32_t(pageIndex);
+				placed = true;
+			}
+		}
+
+		if(!placed)
+		{
+			pagePackers.emplace_back(new SkylinePacker());
+			pagePackers.back()->Reset(pageWidth, pageHeight);
+
+			// The rectangle was already checked to fit on an empty page.
+			placed = pagePackers.back()->Insert(size.width, size.height, placement.rect);
+			assert(placed); (void) placed;
+
+			placement.pageIndex = uint32_t(pagePackers.size() - 1);
+		}
+	}
+
+	return uint32_t(pagePackers.size());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::SkylinePacker::Reset(const uint32_t width, const uint32_t height)
+{
+	const Skyline::Node rootNode =
+	{
+		0,     // uint32_t x
+		0,     // uint32_t y
+		width, // uint32_t width
+	};
+
+	m_pSkyline->nodes.clear();
+	m_pSkyline->nodes.push_back(rootNode);
+
+	m_usedArea = 0;
+	m_width = width;
+	m_height = height;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SkylinePacker::Insert(const uint32_t width, const uint32_t height, Rect& outRect)
+{
+	if(width == 0 || height == 0 || width > m_width || height > m_height)
+	{
+		return false;
+	}
+
+	std::vector<Skyline::Node>& nodes = m_pSkyline->nodes;
+
+	size_t bestIndex = nodes.size();
+	uint32_t bestTop = 0;
+	uint32_t bestWidth = 0;
+	uint32_t bestY = 0;
+
+	// Bottom-left: pick the position where the top of the rectangle is lowest,
+	// breaking ties with the narrowest node so wide gaps are kept for wide rectangles.
+	for(size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex)
+	{
+		uint32_t y = 0;
+
+		if(!_fitRect(nodeIndex, width, height, y))
+		{
+			continue;
+		}
+
+		const uint32_t top = y + height;
+
+		if(bestIndex == nodes.size()
+			|| top < bestTop
+			|| (top == bestTop && nodes[nodeIndex].width < bestWidth))
+		{
+			bestIndex = nodeIndex;
+			bestTop = top;
+			bestWidth = nodes[nodeIndex].width;
+			bestY = y;
+		}
+	}
+
+	if(bestIndex == nodes.size())
+	{
+		return false;
+	}
+
+	const Skyline::Node newNode =
+	{
+		nodes[bestIndex].x, // uint32_t x
+		bestTop,            // uint32_t y
+		width,              // uint32_t width
+	};
+
+	nodes.insert(nodes.begin() + bestIndex, newNode);
+
+	// Shrink or remove the nodes now covered by the new one.
+	for(size_t nodeIndex = bestIndex + 1; nodeIndex < nodes.size();)
+	{
+		Skyline::Node& node = nodes[nodeIndex];
+		const Skyline::Node& prevNode = nodes[nodeIndex - 1];
+
+		const uint32_t prevRight = prevNode.x + prevNode.width;
+
+		if(node.x >= prevRight)
+		{
+			break;
+		}
+
+		const uint32_t overlap = prevRight - node.x;
+
+		if(overlap < node.width)
+		{
+			node.x += overlap;
+			node.width -= overlap;
+			break;
+		}
+
+		nodes.erase(nodes.begin() + nodeIndex);
+	}
+
+	// Merge neighboring nodes at the same height.
+	for(size_t nodeIndex = 1; nodeIndex < nodes.size();)
+	{
+		if(nodes[nodeIndex - 1].y == nodes[nodeIndex].y)
+		{
+			nodes[nodeIndex - 1].width += nodes[nodeIndex].width;
+			nodes.erase(nodes.begin() + nodeIndex);
+		}
+		else
+		{
+			++nodeIndex;
+		}
+	}
+
+	outRect.x = newNode.x;
+	outRect.y = bestY;
+	outRect.width = width;
+	outRect.height = height;
+
+	m_usedArea += uint64_t(width) * uint64_t(height);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SkylinePacker::_fitRect(
+	const size_t nodeIndex,
+	const uint32_t width,
+	const uint32_t height,
+	uint32_t& outY) const
+{
+	const std::vector<Skyline::Node>& nodes = m_pSkyline->nodes;
+
+	const uint32_t x = nodes[nodeIndex].x;
+
+	if(width > m_width - x)
+	{
+		return false;
+	}
+
+	uint32_t y = 0;
+	uint32_t widthLeft = width;
+
+	// The rectangle has to sit on top of the highest node it spans.
+	for(size_t index = nodeIndex; widthLeft > 0; ++index)
+	{
+		const Skyline::Node& node = nodes[index];
+
+		y = std::max(y, node.y);
+
+		if(height > m_height - y)
+		{
+			return false;
+		}
+
+		widthLeft -= std::min(widthLeft, node.width);
+	}
+
+	outY = y;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
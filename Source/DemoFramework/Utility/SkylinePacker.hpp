@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class SkylinePacker;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Rectangle packer using the skyline bottom-left heuristic. The packer keeps track of the top edge of everything
+// placed so far as a list of horizontal segments, and places each rectangle where its top edge ends up lowest, picking
+// the narrowest segment on ties. This wastes a little more space than a full free-rectangle packer, but is much faster
+// and works well for the square-ish, power-of-2 rectangles textures tend to come in.
+class DF_API DemoFramework::Utility::SkylinePacker
+{
+public:
+
+	struct Rect
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	struct Size
+	{
+		uint32_t width;
+		uint32_t height;
+	};
+
+	struct PagePlacement
+	{
+		uint32_t pageIndex;
+		Rect rect;
+	};
+
+	SkylinePacker();
+	SkylinePacker(const SkylinePacker&) = delete;
+	SkylinePacker(SkylinePacker&&) = delete;
+	~SkylinePacker();
+
+	SkylinePacker& operator =(const SkylinePacker&) = delete;
+	SkylinePacker& operator =(SkylinePacker&&) = delete;
+
+	// Pack a list of rectangles onto as many pages of the given size as it takes, writing the placement of each
+	// rectangle to the matching entry of the output array. Rectangles are placed tallest first, then widest first,
+	// then in list order, so the result only depends on the input. Returns the number of pages used, or 0 when any of
+	// the rectangles is larger than a page.
+	static uint32_t PackPages(
+		uint32_t pageWidth,
+		uint32_t pageHeight,
+		const Size* pSizes,
+		size_t count,
+		PagePlacement* pOutPlacements);
+
+	// Start over with an empty area of the given size.
+	void Reset(uint32_t width, uint32_t height);
+
+	// Place a rectangle, returning false when there's no room left for it.
+	bool Insert(uint32_t width, uint32_t height, Rect& outRect);
+
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint64_t GetUsedArea() const;
+
+	// Fraction of the area covered by the rectangles placed so far.
+	float32_t GetOccupancy() const;
+
+
+private:
+
+	struct Skyline;
+
+	// Find the lowest position a rectangle can start at when its left edge is at the start of the given node. Returns
+	// false when the rectangle would run off the right or top edge of the area.
+	bool _fitRect(size_t, uint32_t, uint32_t, uint32_t&) const;
+
+	Skyline* m_pSkyline;
+
+	uint64_t m_usedArea;
+
+	uint32_t m_width;
+	uint32_t m_height;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::SkylinePacker::GetWidth() const
+{
+	return m_width;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::SkylinePacker::GetHeight() const
+{
+	return m_height;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::SkylinePacker::GetUsedArea() const
+{
+	return m_usedArea;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline float32_t DemoFramework::Utility::SkylinePacker::GetOccupancy() const
+{
+	const uint64_t totalArea = uint64_t(m_width) * uint64_t(m_height);
+
+	return (totalArea > 0) ? float32_t(float64_t(m_usedArea) / float64_t(totalArea)) : 0.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
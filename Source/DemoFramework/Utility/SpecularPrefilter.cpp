@@ -0,0 +1,418 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "SpecularPrefilter.hpp"
+#include "CubeMapConverter.hpp"
+#include "ShProjection.hpp"
+#include "ThreadPool.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Minimum number of texels handed to each thread pool task. Prefiltered texels cost a full set of samples each, so
+// this is much smaller than what the cube map converter uses.
+#define DF_SPECULAR_PREFILTER_TASK_TEXEL_COUNT 1024
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr float32_t Pi = 3.1415926535897932384626433832795f;
+static constexpr float32_t TwoPi = 6.283185307179586476925286766559f;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Light direction of a GGX sample in the tangent space of the texel being filtered, with the source mip it is
+// fetched from and how much it contributes. Samples only depend on the roughness of the mip being filtered, so they
+// are built once per mip and rotated into place for each texel.
+struct GgxSample
+{
+	float32_t direction[3];
+	float32_t weight;
+	uint32_t lowerMip;
+	float32_t mipBlend;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline float32_t RadicalInverse(uint32_t bits)
+{
+	bits = (bits << 16u) | (bits >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+	return float32_t(bits) * 2.3283064365386963e-10f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void BuildGgxSamples(
+	const float32_t roughness,
+	const uint32_t sampleCount,
+	const uint32_t srcEdgeLength,
+	const uint32_t srcMipCount,
+	std::vector<GgxSample>& outSamples)
+{
+	const float32_t alphaSq = (roughness * roughness) * (roughness * roughness);
+	const float32_t maxLod = float32_t(srcMipCount - 1);
+
+	// Solid angle of a texel of the top source mip, spreading the sphere evenly over the texels of all 6 faces.
+	const float32_t texelSolidAngle = (4.0f * Pi) / (6.0f * float32_t(srcEdgeLength) * float32_t(srcEdgeLength));
+
+	outSamples.clear();
+	outSamples.reserve(sampleCount);
+
+	for(uint32_t i = 0; i < sampleCount; ++i)
+	{
+		const float32_t xi0 = float32_t(i) / float32_t(sampleCount);
+		const float32_t xi1 = RadicalInverse(i);
+
+		// Half vector from the inverse CDF of the GGX distribution. The view direction is the normal, so the light
+		// direction is the normal reflected about the half vector.
+		const float32_t phi = TwoPi * xi0;
+		const float32_t cosThetaSq = (1.0f - xi1) / (1.0f + ((alphaSq - 1.0f) * xi1));
+		const float32_t cosTheta = sqrtf(cosThetaSq);
+		const float32_t sinTheta = sqrtf(1.0f - cosThetaSq);
+		const float32_t nDotL = (2.0f * cosThetaSq) - 1.0f;
+
+		if(nDotL <= 0.0f)
+		{
+			continue;
+		}
+
+		// With N = V, the pdf of the light direction, D * NdotH / (4 * VdotH), reduces to D / 4.
+		const float32_t denom = (cosThetaSq * (alphaSq - 1.0f)) + 1.0f;
+		const float32_t distribution = alphaSq / ((Pi * denom) * denom);
+		const float32_t pdf = distribution * 0.25f;
+
+		// Pick the mip whose texels cover the solid angle this sample stands for (GPU Gems 3, chapter 20). The extra mip
+		// of bias suggested there visibly flattens rough mips and barely reduces noise with a Hammersley sequence, so
+		// it is left out.
+		const float32_t sampleSolidAngle = 1.0f / (float32_t(sampleCount) * pdf);
+		float32_t lod = 0.5f * log2f(sampleSolidAngle / texelSolidAngle);
+		lod = (lod < 0.0f) ? 0.0f : ((lod > maxLod) ? maxLod : lod);
+
+		GgxSample sample;
+
+		sample.direction[0] = ((2.0f * cosTheta) * sinTheta) * cosf(phi);
+		sample.direction[1] = ((2.0f * cosTheta) * sinTheta) * sinf(phi);
+		sample.direction[2] = nDotL;
+		sample.weight = nDotL;
+		sample.lowerMip = uint32_t(lod);
+		sample.mipBlend = lod - float32_t(sample.lowerMip);
+
+		if(sample.lowerMip >= srcMipCount - 1)
+		{
+			sample.lowerMip = srcMipCount - 1;
+			sample.mipBlend = 0.0f;
+		}
+
+		outSamples.push_back(sample);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cube face a direction points into, along with its face coordinates in [-1, 1]. This inverts the face mapping of
+// ShProjection::CalculateNormalFromPixelCoord().
+static inline void SelectFace(const float32_t* const pDir, uint32_t& outFaceIndex, float32_t& outU, float32_t& outV)
+{
+	const float32_t absX = fabsf(pDir[0]);
+	const float32_t absY = fabsf(pDir[1]);
+	const float32_t absZ = fabsf(pDir[2]);
+
+	if(absX >= absY && absX >= absZ)
+	{
+		const float32_t invMajor = 1.0f / absX;
+
+		outFaceIndex = (pDir[0] >= 0.0f) ? 0 : 1;
+		outU = ((pDir[0] >= 0.0f) ? -pDir[2] : pDir[2]) * invMajor;
+		outV = -pDir[1] * invMajor;
+	}
+	else if(absY >= absZ)
+	{
+		const float32_t invMajor = 1.0f / absY;
+
+		outFaceIndex = (pDir[1] >= 0.0f) ? 2 : 3;
+		outU = pDir[0] * invMajor;
+		outV = ((pDir[1] >= 0.0f) ? pDir[2] : -pDir[2]) * invMajor;
+	}
+	else
+	{
+		const float32_t invMajor = 1.0f / absZ;
+
+		outFaceIndex = (pDir[2] >= 0.0f) ? 4 : 5;
+		outU = ((pDir[2] >= 0.0f) ? pDir[0] : -pDir[0]) * invMajor;
+		outV = -pDir[1] * invMajor;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Bilinear fetch from one face of one mip, clamping to the edges of the face, accumulated into 'pOutColor'.
+static inline void AccumulateBilinear(
+	const DemoFramework::Utility::ImageResampler::ConstImage& face,
+	const float32_t u,
+	const float32_t v,
+	const float32_t weight,
+	float32_t* const pOutColor)
+{
+	const float32_t maxCoord = float32_t(face.width - 1);
+
+	float32_t s = (((u + 1.0f) * 0.5f) * float32_t(face.width)) - 0.5f;
+	float32_t t = (((v + 1.0f) * 0.5f) * float32_t(face.height)) - 0.5f;
+
+	s = (s < 0.0f) ? 0.0f : ((s > maxCoord) ? maxCoord : s);
+	t = (t < 0.0f) ? 0.0f : ((t > maxCoord) ? maxCoord : t);
+
+	const uint32_t x0 = uint32_t(s);
+	const uint32_t y0 = uint32_t(t);
+	const uint32_t x1 = (x0 + 1 < face.width) ? (x0 + 1) : x0;
+	const uint32_t y1 = (y0 + 1 < face.height) ? (y0 + 1) : y0;
+
+	const float32_t fracX = s - float32_t(x0);
+	const float32_t fracY = t - float32_t(y0);
+
+	const float32_t* const pRow0 = reinterpret_cast<const float32_t*>(face.pData + (face.rowPitch * y0));
+	const float32_t* const pRow1 = reinterpret_cast<const float32_t*>(face.pData + (face.rowPitch * y1));
+
+	const float32_t w00 = ((1.0f - fracX) * (1.0f - fracY)) * weight;
+	const float32_t w10 = (fracX * (1.0f - fracY)) * weight;
+	const float32_t w01 = ((1.0f - fracX) * fracY) * weight;
+	const float32_t w11 = (fracX * fracY) * weight;
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		pOutColor[i] += (pRow0[(x0 * 4) + i] * w00)
+			+ (pRow0[(x1 * 4) + i] * w10)
+			+ (pRow1[(x0 * 4) + i] * w01)
+			+ (pRow1[(x1 * 4) + i] * w11);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void PrefilterRow(
+	const DemoFramework::Utility::ImageResampler::ConstImage* const pSrcFaces,
+	const uint32_t srcMipCount,
+	const std::vector<GgxSample>& samples,
+	const uint32_t y,
+	const uint32_t faceIndex,
+	const uint32_t edgeLength,
+	float32_t* const pOutRow)
+{
+	const float32_t invEdgeLength = 1.0f / float32_t(edgeLength);
+
+	for(uint32_t x = 0; x < edgeLength; ++x)
+	{
+		float32_t normal[3];
+		DemoFramework::Utility::ShProjection::CalculateNormalFromPixelCoord(x, y, faceIndex, invEdgeLength, normal);
+
+		// Tangent frame around the normal. The choice of frame only rotates the sample pattern about the normal.
+		const float32_t up[3] =
+		{
+			(fabsf(normal[2]) < 0.999f) ? 0.0f : 1.0f,
+			0.0f,
+			(fabsf(normal[2]) < 0.999f) ? 1.0f : 0.0f,
+		};
+
+		float32_t tangent[3] =
+		{
+			(up[1] * normal[2]) - (up[2] * normal[1]),
+			(up[2] * normal[0]) - (up[0] * normal[2]),
+			(up[0] * normal[1]) - (up[1] * normal[0]),
+		};
+
+		const float32_t invTangentLength = 1.0f / sqrtf((tangent[0] * tangent[0]) + (tangent[1] * tangent[1]) + (tangent[2] * tangent[2]));
+
+		for(uint32_t i = 0; i < 3; ++i)
+		{
+			tangent[i] *= invTangentLength;
+		}
+
+		const float32_t bitangent[3] =
+		{
+			(normal[1] * tangent[2]) - (normal[2] * tangent[1]),
+			(normal[2] * tangent[0]) - (normal[0] * tangent[2]),
+			(normal[0] * tangent[1]) - (normal[1] * tangent[0]),
+		};
+
+		float32_t color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float32_t weightSum = 0.0f;
+
+		for(const GgxSample& sample : samples)
+		{
+			float32_t direction[3];
+
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				direction[i] = (tangent[i] * sample.direction[0])
+					+ (bitangent[i] * sample.direction[1])
+					+ (normal[i] * sample.direction[2]);
+			}
+
+			uint32_t srcFaceIndex;
+			float32_t u;
+			float32_t v;
+			SelectFace(direction, srcFaceIndex, u, v);
+
+			const DemoFramework::Utility::ImageResampler::ConstImage* const pSrcMips = pSrcFaces + (srcFaceIndex * srcMipCount);
+
+			AccumulateBilinear(pSrcMips[sample.lowerMip], u, v, sample.weight * (1.0f - sample.mipBlend), color);
+
+			if(sample.mipBlend > 0.0f)
+			{
+				AccumulateBilinear(pSrcMips[sample.lowerMip + 1], u, v, sample.weight * sample.mipBlend, color);
+			}
+
+			weightSum += sample.weight;
+		}
+
+		const float32_t invWeightSum = 1.0f / weightSum;
+
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			pOutRow[(x * 4) + i] = color[i] * invWeightSum;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename ImageType>
+static bool ValidateFaces(const ImageType* const pFaces, const uint32_t edgeLength, const uint32_t mipCount)
+{
+	if(!pFaces)
+	{
+		return false;
+	}
+
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+		{
+			const ImageType& face = pFaces[(faceIndex * mipCount) + mipIndex];
+			const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+			if(!face.pData
+				|| face.width != mipEdgeLength
+				|| face.height != mipEdgeLength
+				|| face.rowPitch < size_t(mipEdgeLength) * sizeof(float32_t) * 4)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SpecularPrefilter::Prefilter(
+	const ImageResampler::ConstImage* const pSrcFaces,
+	const ImageResampler::Image* const pDstFaces,
+	const uint32_t edgeLength,
+	const uint32_t mipCount,
+	const uint32_t sampleCount,
+	ThreadPool* const pThreadPool)
+{
+	if(edgeLength == 0 || mipCount == 0 || sampleCount == 0)
+	{
+		return false;
+	}
+
+	// Every level has to be at least 1 texel in size.
+	if(mipCount > 32 || (edgeLength >> (mipCount - 1)) == 0)
+	{
+		return false;
+	}
+
+	if(!ValidateFaces(pSrcFaces, edgeLength, mipCount) || !ValidateFaces(pDstFaces, edgeLength, mipCount))
+	{
+		return false;
+	}
+
+	// A mirror reflects the source unfiltered.
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+	{
+		const ImageResampler::ConstImage& src = pSrcFaces[faceIndex * mipCount];
+		const ImageResampler::Image& dst = pDstFaces[faceIndex * mipCount];
+
+		for(uint32_t y = 0; y < edgeLength; ++y)
+		{
+			memcpy(dst.pData + (dst.rowPitch * y), src.pData + (src.rowPitch * y), size_t(edgeLength) * sizeof(float32_t) * 4);
+		}
+	}
+
+	std::vector<GgxSample> samples;
+
+	for(uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+		const size_t rowCount = size_t(mipEdgeLength) * DF_CUBE_MAP_FACE_COUNT;
+
+		BuildGgxSamples(GetMipRoughness(mipIndex, mipCount), sampleCount, edgeLength, mipCount, samples);
+
+		const size_t rowsPerTask = (mipEdgeLength < DF_SPECULAR_PREFILTER_TASK_TEXEL_COUNT)
+			? (DF_SPECULAR_PREFILTER_TASK_TEXEL_COUNT / mipEdgeLength)
+			: 1;
+		const size_t taskCount = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+		auto runTask = [&](const size_t taskIndex)
+		{
+			const size_t rowBegin = taskIndex * rowsPerTask;
+			const size_t rowEnd = (rowBegin + rowsPerTask < rowCount) ? (rowBegin + rowsPerTask) : rowCount;
+
+			for(size_t rowIndex = rowBegin; rowIndex < rowEnd; ++rowIndex)
+			{
+				const uint32_t faceIndex = uint32_t(rowIndex / mipEdgeLength);
+				const uint32_t y = uint32_t(rowIndex % mipEdgeLength);
+
+				const ImageResampler::Image& dst = pDstFaces[(faceIndex * mipCount) + mipIndex];
+
+				PrefilterRow(
+					pSrcFaces,
+					mipCount,
+					samples,
+					y,
+					faceIndex,
+					mipEdgeLength,
+					reinterpret_cast<float32_t*>(dst.pData + (dst.rowPitch * y)));
+			}
+		};
+
+		if(pThreadPool && taskCount > 1)
+		{
+			pThreadPool->ParallelFor(taskCount, runTask);
+		}
+		else
+		{
+			for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+			{
+				runTask(taskIndex);
+			}
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
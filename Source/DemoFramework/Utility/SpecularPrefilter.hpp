@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ImageResampler.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class SpecularPrefilter;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// CPU implementation of the GGX specular prefilter the reflection probe runs on the GPU through its spec-prefilter
+// compute shader, for baking probes without a GPU. Each mip of the output cube map is filtered for a single roughness
+// by importance sampling the GGX distribution with a Hammersley sequence, assuming the view direction is the normal.
+// Samples are fetched from the mip of the source cube map whose texels cover about the same solid angle as the
+// sample (filtered importance sampling), which keeps the sample count low without the result breaking up into noise.
+//
+// Rows of the cube faces are spread across a thread pool. Every texel is computed on its own by a single task, so the
+// output does not depend on the number of threads.
+//
+// Cube maps use the face order and image layout of CubeMapConverter, which can produce the source from an equirect.
+class DF_API DemoFramework::Utility::SpecularPrefilter
+{
+public:
+
+	SpecularPrefilter() = delete;
+	SpecularPrefilter(const SpecularPrefilter&) = delete;
+	SpecularPrefilter(SpecularPrefilter&&) = delete;
+
+	// Perceptual roughness a mip of the prefiltered cube map is filtered for. Mip 0 is a mirror and the last mip is
+	// fully rough, with the mips in between spaced evenly, so shading can pick the mip as roughness * (mipCount - 1).
+	static float32_t GetMipRoughness(uint32_t mipIndex, uint32_t mipCount);
+
+	// Filter a radiance cube map into a prefiltered specular cube map of the same size. Both hold
+	// DF_CUBE_MAP_FACE_COUNT * mipCount RGBA32Float images, the first mip of which is 'edgeLength' texels square, and
+	// every mip of the source must be filled in. Mip 0 is copied from the source as is. A null thread pool runs
+	// everything on the calling thread.
+	static bool Prefilter(
+		const ImageResampler::ConstImage* pSrcFaces,
+		const ImageResampler::Image* pDstFaces,
+		uint32_t edgeLength,
+		uint32_t mipCount,
+		uint32_t sampleCount,
+		ThreadPool* pThreadPool);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline float32_t DemoFramework::Utility::SpecularPrefilter::GetMipRoughness(const uint32_t mipIndex, const uint32_t mipCount)
+{
+	return (mipCount > 1) ? (float32_t(mipIndex) / float32_t(mipCount - 1)) : 0.0f;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
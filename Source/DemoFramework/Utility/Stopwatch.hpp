@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class Stopwatch;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Minimal high resolution timer for measuring how long loading operations take.
+class DF_API DemoFramework::Utility::Stopwatch
+{
+public:
+
+	Stopwatch();
+
+	void Restart();
+
+	float64_t GetElapsedMs() const;
+
+
+private:
+
+	LARGE_INTEGER m_frequency;
+	LARGE_INTEGER m_startTime;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::Stopwatch::Stopwatch()
+	: m_frequency()
+	, m_startTime()
+{
+	QueryPerformanceFrequency(&m_frequency);
+	QueryPerformanceCounter(&m_startTime);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::Utility::Stopwatch::Restart()
+{
+	QueryPerformanceCounter(&m_startTime);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline float64_t DemoFramework::Utility::Stopwatch::GetElapsedMs() const
+{
+	LARGE_INTEGER currentTime;
+	QueryPerformanceCounter(&currentTime);
+
+	return float64_t(currentTime.QuadPart - m_startTime.QuadPart) * 1000.0 / float64_t(m_frequency.QuadPart);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
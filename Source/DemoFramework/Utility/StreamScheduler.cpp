@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "StreamScheduler.hpp"
+
+#include <algorithm>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_STREAM_SCHEDULER_DEFAULT_MIN_CHUNK_SIZE (64 * 1024)
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the request queue using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::Utility::StreamScheduler::RequestQueue
+{
+	struct Request
+	{
+		RequestId id;
+		int32_t priority;
+		uint64_t size;
+		uint64_t offset;
+		uint64_t alignment;
+	};
+
+	// Kept sorted by priority, then by request ID, so the front of the list is always the next request to stream.
+	std::vector<Request> list;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::StreamScheduler::StreamScheduler()
+	: m_pQueue(new RequestQueue())
+	, m_chunkAlignment(1)
+	, m_minChunkSize(DF_STREAM_SCHEDULER_DEFAULT_MIN_CHUNK_SIZE)
+	, m_nextId(InvalidRequestId + 1)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::StreamScheduler::~StreamScheduler()
+{
+	if(m_pQueue)
+	{
+		delete m_pQueue;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::StreamScheduler::RequestId DemoFramework::Utility::StreamScheduler::Enqueue(
+	const uint64_t byteSize,
+	const int32_t priority,
+	const uint64_t chunkAlignment)
+{
+	if(byteSize == 0)
+	{
+		return InvalidRequestId;
+	}
+
+	const RequestId id = m_nextId;
+	const uint64_t alignment = (chunkAlignment > 0) ? chunkAlignment : m_chunkAlignment;
+
+	// Skip the invalid ID when the counter wraps around.
+	++m_nextId;
+	if(m_nextId == InvalidRequestId)
+	{
+		++m_nextId;
+	}
+
+	const RequestQueue::Request request =
+	{
+		id,        // RequestId id
+		priority,  // int32_t priority
+		byteSize,  // uint64_t size
+		0,         // uint64_t offset
+		alignment, // uint64_t alignment
+	};
+
+	// Insert the request after all other requests of equal or higher priority so requests
+	// sharing the same priority are streamed in the order they were enqueued.
+	auto insertPoint = std::upper_bound(
+		m_pQueue->list.begin(),
+		m_pQueue->list.end(),
+		priority,
+		[](const int32_t value, const RequestQueue::Request& other) { return value < other.priority; });
+
+	m_pQueue->list.insert(insertPoint, request);
+
+	return id;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::StreamScheduler::Cancel(const RequestId requestId)
+{
+	for(auto it = m_pQueue->list.begin(); it != m_pQueue->list.end(); ++it)
+	{
+		if(it->id == requestId)
+		{
+			m_pQueue->list.erase(it);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::StreamScheduler::Clear()
+{
+	m_pQueue->list.clear();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::StreamScheduler::Schedule(
+	const uint64_t byteBudget,
+	Chunk* const pOutChunks,
+	const size_t maxChunkCount)
+{
+	if(!pOutChunks || maxChunkCount == 0 || byteBudget == 0)
+	{
+		return 0;
+	}
+
+	std::vector<RequestQueue::Request>& list = m_pQueue->list;
+
+	uint64_t remainingBudget = byteBudget;
+	size_t chunkCount = 0;
+	size_t completedCount = 0;
+
+	while(chunkCount < maxChunkCount && completedCount < list.size())
+	{
+		RequestQueue::Request& request = list[completedCount];
+
+		const uint64_t bytesLeft = request.size - request.offset;
+
+		uint64_t chunkSize = bytesLeft;
+
+		if(bytesLeft > remainingBudget)
+		{
+			// The rest of the request does not fit in the budget, so only
+			// take as much as we can while respecting the chunk alignment.
+			chunkSize = remainingBudget - (remainingBudget % request.alignment);
+
+			if(chunkSize < m_minChunkSize)
+			{
+				if(chunkCount > 0)
+				{
+					// Something was already scheduled this frame; leave the rest for the next one.
+					break;
+				}
+
+				// Nothing fits in the budget at all, so force a single minimum-sized chunk through to guarantee that
+				// every request eventually completes. The alignment isn't necessarily a power of 2 (e.g. texture
+				// row pitches), so the minimum size has to be rounded up with a division rather than a mask.
+				const uint64_t forcedSize = std::max(m_minChunkSize, request.alignment);
+
+				chunkSize = std::min(
+					bytesLeft,
+					((forcedSize + request.alignment - 1) / request.alignment) * request.alignment);
+			}
+		}
+
+		Chunk& chunk = pOutChunks[chunkCount];
+
+		chunk.requestId = request.id;
+		chunk.offset = request.offset;
+		chunk.size = chunkSize;
+		chunk.lastChunk = (chunkSize == bytesLeft);
+
+		++chunkCount;
+
+		request.offset += chunkSize;
+		remainingBudget -= std::min(chunkSize, remainingBudget);
+
+		if(!chunk.lastChunk)
+		{
+			// The budget has been used up.
+			break;
+		}
+
+		++completedCount;
+
+		if(remainingBudget == 0)
+		{
+			break;
+		}
+	}
+
+	// Remove all requests that have been fully scheduled.
+	if(completedCount > 0)
+	{
+		list.erase(list.begin(), list.begin() + completedCount);
+	}
+
+	return chunkCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint64_t DemoFramework::Utility::StreamScheduler::GetPendingBytes() const
+{
+	uint64_t output = 0;
+
+	for(const RequestQueue::Request& request : m_pQueue->list)
+	{
+		output += request.size - request.offset;
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::StreamScheduler::GetPendingCount() const
+{
+	return m_pQueue->list.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
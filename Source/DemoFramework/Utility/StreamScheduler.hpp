@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class StreamScheduler;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Splits queued streaming requests into chunks that fit inside a per-frame byte budget. This class only does the
+// bookkeeping; it never touches any GPU objects, so the caller is responsible for actually copying the bytes
+// described by each chunk. That keeps the scheduling policy usable from any loader (and from a simulated upload
+// queue when tuning budgets without a device).
+class DF_API DemoFramework::Utility::StreamScheduler
+{
+public:
+
+	typedef uint32_t RequestId;
+
+	static constexpr RequestId InvalidRequestId = 0;
+
+	struct Chunk
+	{
+		RequestId requestId;
+		uint64_t offset;
+		uint64_t size;
+		bool lastChunk;
+	};
+
+	StreamScheduler();
+	StreamScheduler(const StreamScheduler&) = delete;
+	StreamScheduler(StreamScheduler&&) = delete;
+	~StreamScheduler();
+
+	StreamScheduler& operator =(const StreamScheduler&) = delete;
+	StreamScheduler& operator =(StreamScheduler&&) = delete;
+
+	// Queue a new request. Requests with a lower priority value are scheduled first; requests sharing the same
+	// priority are scheduled in the order they were enqueued. Chunks of the request are split on multiples of
+	// 'chunkAlignment', or on the scheduler's chunk alignment when it is zero. Alignments don't need to be a power of 2.
+	RequestId Enqueue(uint64_t byteSize, int32_t priority, uint64_t chunkAlignment = 0);
+
+	bool Cancel(RequestId requestId);
+	void Clear();
+
+	// Fill the output array with the chunks to process this frame and return the number of chunks written. The sum of
+	// the chunk sizes will not exceed the byte budget, with one exception: when the budget is non-zero, but too small
+	// to fit a single minimum-sized chunk, one minimum-sized chunk is still scheduled so streaming cannot stall.
+	size_t Schedule(uint64_t byteBudget, Chunk* pOutChunks, size_t maxChunkCount);
+
+	void SetChunkAlignment(uint64_t alignment);
+	void SetMinChunkSize(uint64_t size);
+
+	uint64_t GetPendingBytes() const;
+	size_t GetPendingCount() const;
+
+
+private:
+
+	struct RequestQueue;
+
+	RequestQueue* m_pQueue;
+
+	uint64_t m_chunkAlignment;
+	uint64_t m_minChunkSize;
+
+	RequestId m_nextId;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::Utility::StreamScheduler::SetChunkAlignment(const uint64_t alignment)
+{
+	m_chunkAlignment = (alignment > 0) ? alignment : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void DemoFramework::Utility::StreamScheduler::SetMinChunkSize(const uint64_t size)
+{
+	m_minChunkSize = (size > 0) ? size : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,1299 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "SupercompressedTexture.hpp"
+
+#include "Math.hpp"
+#include "TextureFootprint.hpp"
+
+#include "../Application/Log.hpp"
+
+#include <algorithm>
+#include <ctype.h>
+#include <float.h>
+#include <math.h>
+#include <queue>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_SUPERCOMPRESSED_TEXTURE_FILE_MAGIC   0x43534644ul // "DFSC"
+#define DF_SUPERCOMPRESSED_TEXTURE_FILE_VERSION 1
+
+#define DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT 16
+
+// Number of block planes handled by each encoder task.
+#define DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE 1024
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct SupercompressedTextureFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	DemoFramework::Utility::SupercompressedTexture::Desc desc;
+
+	uint64_t endpointOffset;
+	uint64_t selectorOffset;
+	uint64_t blockOffset;
+	uint64_t blockSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Blend weights of the 2-bit selectors of the color layout, out of 64. These are the weights BC7 uses for the 4-bit
+// indices 0, 5, 10 and 15, which are within a rounding step of the thirds BC1 interpolates at.
+static const uint32_t ColorSelectorWeights[4] = { 0, 21, 43, 64 };
+
+// Selector of the color layout to BC7 4-bit index.
+static const uint32_t Bc7SelectorIndices[4] = { 0, 5, 10, 15 };
+
+// Selector of the color layout to BC1 index, for endpoints stored in order and swapped.
+static const uint32_t Bc1SelectorIndices[2][4] =
+{
+	{ 0, 2, 3, 1 },
+	{ 1, 3, 2, 0 },
+};
+
+// Selector of the plane layouts to BC4 index when the endpoints select the 8-value mode.
+static const uint32_t Bc4SelectorIndices[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t GetChannelCount(const DemoFramework::Utility::SupercompressedTexture::Layout layout)
+{
+	return (layout == DemoFramework::Utility::SupercompressedTexture::Layout::Color) ? 4 : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t GetEndpointSize(const DemoFramework::Utility::SupercompressedTexture::Layout layout)
+{
+	return GetChannelCount(layout) * 2;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t GetMaxSelector(const DemoFramework::Utility::SupercompressedTexture::Layout layout)
+{
+	return (layout == DemoFramework::Utility::SupercompressedTexture::Layout::Color) ? 3 : 7;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t GetBlockCount(const uint32_t size, const uint32_t mipIndex)
+{
+	return (DemoFramework::Utility::TextureFootprint::GetMipDimension(size, mipIndex) + 3) / 4;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint8_t RoundToByte(const float value)
+{
+	return (value <= 0.0f) ? 0 : ((value >= 255.0f) ? 255 : uint8_t(value + 0.5f));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void RunTasks(DemoFramework::Utility::ThreadPool* const pThreadPool, const size_t taskCount, const DemoFramework::Utility::ThreadPool::TaskFunc& task)
+{
+	if(pThreadPool)
+	{
+		pThreadPool->ParallelFor(taskCount, task);
+	}
+	else
+	{
+		for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+		{
+			task(taskIndex);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Find the direction of greatest variance of a set of vectors given their covariance matrix, by power iteration
+// starting from the axis with the largest variance. Returns false when the vectors are all the same.
+static bool FindPrincipalAxis(const double* const pCovariance, const uint32_t dimension, double* const pOutAxis)
+{
+	uint32_t largestAxis = 0;
+
+	for(uint32_t i = 1; i < dimension; ++i)
+	{
+		if(pCovariance[(i * dimension) + i] > pCovariance[(largestAxis * dimension) + largestAxis])
+		{
+			largestAxis = i;
+		}
+	}
+
+	if(pCovariance[(largestAxis * dimension) + largestAxis] <= 0.0)
+	{
+		return false;
+	}
+
+	double nextAxis[16];
+
+	for(uint32_t i = 0; i < dimension; ++i)
+	{
+		pOutAxis[i] = (i == largestAxis) ? 1.0 : 0.0;
+	}
+
+	for(uint32_t iteration = 0; iteration < 8; ++iteration)
+	{
+		double lengthSq = 0.0;
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			double sum = 0.0;
+
+			for(uint32_t j = 0; j < dimension; ++j)
+			{
+				sum += pCovariance[(i * dimension) + j] * pOutAxis[j];
+			}
+
+			nextAxis[i] = sum;
+			lengthSq += sum * sum;
+		}
+
+		if(lengthSq <= 0.0)
+		{
+			return false;
+		}
+
+		const double scale = 1.0 / sqrt(lengthSq);
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			pOutAxis[i] = nextAxis[i] * scale;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Build a codebook of at most 'maxEntryCount' entries for a set of vectors by tree-structured vector quantization:
+// starting from a single cluster holding every vector, keep splitting the cluster with the largest squared error in
+// two, through its mean and across its principal axis, until there are enough clusters or none of them has any error
+// left. The mean of each cluster becomes an entry, and each vector is assigned the entry of the cluster it ends up in.
+static void BuildCodebook(
+	const float* const pVectors,
+	const size_t vectorCount,
+	const uint32_t dimension,
+	const uint32_t maxEntryCount,
+	std::vector<float>& outCentroids,
+	std::vector<uint32_t>& outAssignments)
+{
+	struct Cluster
+	{
+		size_t begin;
+		size_t end;
+		double mean[16];
+	};
+
+	std::vector<uint32_t> order(vectorCount);
+	std::vector<Cluster> clusters;
+
+	for(size_t vectorIndex = 0; vectorIndex < vectorCount; ++vectorIndex)
+	{
+		order[vectorIndex] = uint32_t(vectorIndex);
+	}
+
+	// Fill in the mean of a cluster and return its squared error.
+	auto measureCluster = [&](Cluster& cluster) -> double
+	{
+		const double scale = 1.0 / double(cluster.end - cluster.begin);
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			cluster.mean[i] = 0.0;
+		}
+
+		for(size_t index = cluster.begin; index < cluster.end; ++index)
+		{
+			const float* const pVector = pVectors + (size_t(order[index]) * dimension);
+
+			for(uint32_t i = 0; i < dimension; ++i)
+			{
+				cluster.mean[i] += pVector[i];
+			}
+		}
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			cluster.mean[i] *= scale;
+		}
+
+		double error = 0.0;
+
+		for(size_t index = cluster.begin; index < cluster.end; ++index)
+		{
+			const float* const pVector = pVectors + (size_t(order[index]) * dimension);
+
+			for(uint32_t i = 0; i < dimension; ++i)
+			{
+				const double delta = pVector[i] - cluster.mean[i];
+				error += delta * delta;
+			}
+		}
+
+		return error;
+	};
+
+	// Split a cluster across its principal axis, returning the position of the first vector of the second half, or
+	// the beginning of the cluster when it can't be split.
+	auto splitCluster = [&](const Cluster& cluster) -> size_t
+	{
+		double covariance[16 * 16] = {};
+		double axis[16];
+
+		for(size_t index = cluster.begin; index < cluster.end; ++index)
+		{
+			const float* const pVector = pVectors + (size_t(order[index]) * dimension);
+
+			double delta[16];
+
+			for(uint32_t i = 0; i < dimension; ++i)
+			{
+				delta[i] = pVector[i] - cluster.mean[i];
+			}
+
+			for(uint32_t i = 0; i < dimension; ++i)
+			{
+				for(uint32_t j = i; j < dimension; ++j)
+				{
+					covariance[(i * dimension) + j] += delta[i] * delta[j];
+				}
+			}
+		}
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			for(uint32_t j = 0; j < i; ++j)
+			{
+				covariance[(i * dimension) + j] = covariance[(j * dimension) + i];
+			}
+		}
+
+		if(!FindPrincipalAxis(covariance, dimension, axis))
+		{
+			return cluster.begin;
+		}
+
+		const auto isBelowMean = [&](const uint32_t vectorIndex) -> bool
+		{
+			const float* const pVector = pVectors + (size_t(vectorIndex) * dimension);
+
+			double projection = 0.0;
+
+			for(uint32_t i = 0; i < dimension; ++i)
+			{
+				projection += (pVector[i] - cluster.mean[i]) * axis[i];
+			}
+
+			return projection < 0.0;
+		};
+
+		const size_t middle = size_t(std::partition(order.begin() + cluster.begin, order.begin() + cluster.end, isBelowMean) - order.begin());
+
+		return (middle == cluster.end) ? cluster.begin : middle;
+	};
+
+	std::priority_queue<std::pair<double, uint32_t>> splitQueue;
+
+	if(vectorCount > 0)
+	{
+		Cluster root;
+		root.begin = 0;
+		root.end = vectorCount;
+
+		splitQueue.push(std::make_pair(measureCluster(root), 0u));
+		clusters.push_back(root);
+	}
+
+	while(clusters.size() < maxEntryCount && !splitQueue.empty() && splitQueue.top().first > 0.0)
+	{
+		const uint32_t clusterIndex = splitQueue.top().second;
+		splitQueue.pop();
+
+		const Cluster cluster = clusters[clusterIndex];
+		const size_t middle = splitCluster(cluster);
+
+		if(middle == cluster.begin)
+		{
+			continue;
+		}
+
+		Cluster lower = cluster;
+		Cluster upper = cluster;
+
+		lower.end = middle;
+		upper.begin = middle;
+
+		const uint32_t upperIndex = uint32_t(clusters.size());
+
+		splitQueue.push(std::make_pair(measureCluster(lower), clusterIndex));
+		splitQueue.push(std::make_pair(measureCluster(upper), upperIndex));
+
+		clusters[clusterIndex] = lower;
+		clusters.push_back(upper);
+	}
+
+	outCentroids.resize(clusters.size() * dimension);
+	outAssignments.resize(vectorCount);
+
+	for(size_t clusterIndex = 0; clusterIndex < clusters.size(); ++clusterIndex)
+	{
+		const Cluster& cluster = clusters[clusterIndex];
+
+		for(uint32_t i = 0; i < dimension; ++i)
+		{
+			outCentroids[(clusterIndex * dimension) + i] = float(cluster.mean[i]);
+		}
+
+		for(size_t index = cluster.begin; index < cluster.end; ++index)
+		{
+			outAssignments[order[index]] = uint32_t(clusterIndex);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fit a line segment through the texels of a block plane. Color blocks use the extent of the texels along their
+// principal axis, while single channel blocks use the range of the channel from its maximum to its minimum.
+static void FitEndpoints(const uint8_t* const pTexels, const uint32_t channelCount, float* const pOutEndpoints)
+{
+	if(channelCount == 1)
+	{
+		const uint8_t* const pEnd = pTexels + DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT;
+
+		pOutEndpoints[0] = float(*std::max_element(pTexels, pEnd));
+		pOutEndpoints[1] = float(*std::min_element(pTexels, pEnd));
+		return;
+	}
+
+	double mean[4] = {};
+	double covariance[4 * 4] = {};
+	double axis[4];
+
+	for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+	{
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			mean[i] += pTexels[(texelIndex * 4) + i];
+		}
+	}
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		mean[i] /= double(DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT);
+	}
+
+	for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+	{
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			for(uint32_t j = 0; j < 4; ++j)
+			{
+				covariance[(i * 4) + j] += (pTexels[(texelIndex * 4) + i] - mean[i]) * (pTexels[(texelIndex * 4) + j] - mean[j]);
+			}
+		}
+	}
+
+	if(!FindPrincipalAxis(covariance, 4, axis))
+	{
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			pOutEndpoints[i] = float(mean[i]);
+			pOutEndpoints[i + 4] = float(mean[i]);
+		}
+
+		return;
+	}
+
+	double minProjection = 0.0;
+	double maxProjection = 0.0;
+
+	for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+	{
+		double projection = 0.0;
+
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			projection += (pTexels[(texelIndex * 4) + i] - mean[i]) * axis[i];
+		}
+
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		pOutEndpoints[i] = float(std::min(std::max(mean[i] + (axis[i] * minProjection), 0.0), 255.0));
+		pOutEndpoints[i + 4] = float(std::min(std::max(mean[i] + (axis[i] * maxProjection), 0.0), 255.0));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Pick the selector of each texel of a block plane that lands closest to it between a pair of endpoints.
+static void FitSelectors(
+	const uint8_t* const pTexels,
+	const uint8_t* const pEndpoints,
+	const uint32_t channelCount,
+	float* const pOutSelectors)
+{
+	const uint32_t paletteSize = (channelCount == 1) ? 8 : 4;
+
+	float palette[8][4];
+
+	for(uint32_t selector = 0; selector < paletteSize; ++selector)
+	{
+		for(uint32_t i = 0; i < channelCount; ++i)
+		{
+			const float e0 = float(pEndpoints[i]);
+			const float e1 = float(pEndpoints[i + channelCount]);
+
+			palette[selector][i] = (channelCount == 1)
+				? ((e0 * float(7 - selector)) + (e1 * float(selector))) / 7.0f
+				: ((e0 * float(64 - ColorSelectorWeights[selector])) + (e1 * float(ColorSelectorWeights[selector]))) / 64.0f;
+		}
+	}
+
+	for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+	{
+		const uint8_t* const pTexel = pTexels + (texelIndex * channelCount);
+
+		float bestError = FLT_MAX;
+		uint32_t bestSelector = 0;
+
+		for(uint32_t selector = 0; selector < paletteSize; ++selector)
+		{
+			float error = 0.0f;
+
+			for(uint32_t i = 0; i < channelCount; ++i)
+			{
+				const float delta = float(pTexel[i]) - palette[selector][i];
+				error += delta * delta;
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+				bestSelector = selector;
+			}
+		}
+
+		pOutSelectors[texelIndex] = float(bestSelector);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Quantize an RGBA8 endpoint to the 7-bit color and shared p-bit of BC7 mode 6, picking the p-bit that reproduces the
+// endpoint most closely.
+static void QuantizeBc7Endpoint(const uint8_t* const pEndpoint, uint32_t* const pOutChannels, uint32_t& outPBit)
+{
+	uint32_t bestError = UINT32_MAX;
+
+	for(uint32_t pBit = 0; pBit < 2; ++pBit)
+	{
+		uint32_t channels[4];
+		uint32_t error = 0;
+
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			const int32_t value = (int32_t(pEndpoint[i]) - int32_t(pBit) + 1) >> 1;
+
+			channels[i] = uint32_t(std::min(std::max(value, 0), 127));
+
+			const int32_t delta = int32_t((channels[i] << 1) | pBit) - int32_t(pEndpoint[i]);
+			error += uint32_t(delta * delta);
+		}
+
+		if(error < bestError)
+		{
+			bestError = error;
+			outPBit = pBit;
+
+			memcpy(pOutChannels, channels, sizeof(channels));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline void SetBits(uint64_t* const pBits, const uint32_t offset, const uint64_t value)
+{
+	pBits[offset >> 6] |= value << (offset & 63);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t PackRgb565(const uint8_t* const pColor)
+{
+	const uint32_t r = ((uint32_t(pColor[0]) * 31) + 127) / 255;
+	const uint32_t g = ((uint32_t(pColor[1]) * 63) + 127) / 255;
+	const uint32_t b = ((uint32_t(pColor[2]) * 31) + 127) / 255;
+
+	return (r << 11) | (g << 5) | b;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::SupercompressedTexture::SupercompressedTexture()
+	: m_file()
+	, m_desc()
+	, m_pEndpoints(nullptr)
+	, m_pSelectors(nullptr)
+	, m_pBlocks(nullptr)
+	, m_mipBlockOffsets()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::SupercompressedTexture::Ptr DemoFramework::Utility::SupercompressedTexture::Open(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	MappedFile::Ptr file = MappedFile::Open(filePath);
+	if(!file)
+	{
+		LOG_ERROR("Failed to open supercompressed texture file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	if(file->GetSize() < sizeof(SupercompressedTextureFileHeader))
+	{
+		LOG_ERROR("Supercompressed texture file is too small: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	SupercompressedTextureFileHeader header;
+	memcpy(&header, file->GetData(), sizeof(header));
+
+	const Desc& desc = header.desc;
+
+	if(header.magic != DF_SUPERCOMPRESSED_TEXTURE_FILE_MAGIC
+		|| header.version != DF_SUPERCOMPRESSED_TEXTURE_FILE_VERSION
+		|| desc.layout > Layout::RG
+		|| desc.width == 0
+		|| desc.height == 0
+		|| desc.mipCount == 0
+		|| desc.mipCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT
+		|| desc.mipCount > TextureFootprint::GetMaxMipCount(desc.width, desc.height)
+		|| desc.endpointCount == 0
+		|| desc.endpointCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE
+		|| desc.selectorCount == 0
+		|| desc.selectorCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE)
+	{
+		LOG_ERROR("Invalid supercompressed texture file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	Ptr output = std::make_shared<SupercompressedTexture>();
+
+	output->m_desc = desc;
+
+	const uint64_t planeCount = _getPlaneCount(desc.layout);
+
+	uint64_t blockSize = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < desc.mipCount; ++mipIndex)
+	{
+		output->m_mipBlockOffsets[mipIndex] = blockSize / sizeof(uint16_t);
+
+		blockSize += uint64_t(GetBlockCount(desc.width, mipIndex))
+			* uint64_t(GetBlockCount(desc.height, mipIndex))
+			* planeCount
+			* sizeof(uint16_t) * 2;
+	}
+
+	const uint64_t endpointSize = uint64_t(desc.endpointCount) * GetEndpointSize(desc.layout);
+	const uint64_t selectorSize = uint64_t(desc.selectorCount) * sizeof(uint64_t);
+
+	// Reject files that were truncated while being written.
+	if(header.blockSize != blockSize
+		|| header.endpointOffset < sizeof(SupercompressedTextureFileHeader)
+		|| header.endpointOffset + endpointSize > header.selectorOffset
+		|| (header.selectorOffset % sizeof(uint64_t)) != 0
+		|| header.selectorOffset + selectorSize > header.blockOffset
+		|| (header.blockOffset % sizeof(uint16_t)) != 0
+		|| header.blockOffset + blockSize > file->GetSize())
+	{
+		LOG_ERROR("Supercompressed texture file is incomplete: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	output->m_pEndpoints = file->GetData() + header.endpointOffset;
+	output->m_pSelectors = reinterpret_cast<const uint64_t*>(file->GetData() + header.selectorOffset);
+	output->m_pBlocks = reinterpret_cast<const uint16_t*>(file->GetData() + header.blockOffset);
+
+	// Transcoding indexes straight into the codebooks, so check every index once up front rather than in the inner
+	// loop of every transcode.
+	const size_t blockIndexCount = size_t(blockSize / sizeof(uint16_t));
+
+	for(size_t index = 0; index < blockIndexCount; index += 2)
+	{
+		if(output->m_pBlocks[index] >= desc.endpointCount || output->m_pBlocks[index + 1] >= desc.selectorCount)
+		{
+			LOG_ERROR("Supercompressed texture file is corrupt: path=\"%s\"", filePath);
+			return Ptr();
+		}
+	}
+
+	// Plane endpoints are stored with the first one no smaller than the second, which the BC4 transcode relies on.
+	if(desc.layout != Layout::Color)
+	{
+		for(uint32_t entryIndex = 0; entryIndex < desc.endpointCount; ++entryIndex)
+		{
+			if(output->m_pEndpoints[entryIndex * 2] < output->m_pEndpoints[(entryIndex * 2) + 1])
+			{
+				LOG_ERROR("Supercompressed texture file is corrupt: path=\"%s\"", filePath);
+				return Ptr();
+			}
+		}
+	}
+
+	output->m_file = file;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SupercompressedTexture::Write(
+	const char* const filePath,
+	const Layout layout,
+	const ImageResampler::ConstImage* const pMips,
+	const uint32_t mipCount,
+	const EncodeOptions& options,
+	ThreadPool* const pThreadPool)
+{
+	if(!filePath
+		|| filePath[0] == '\0'
+		|| layout > Layout::RG
+		|| !pMips
+		|| mipCount == 0
+		|| mipCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT
+		|| pMips[0].width == 0
+		|| pMips[0].height == 0
+		|| mipCount > TextureFootprint::GetMaxMipCount(pMips[0].width, pMips[0].height)
+		|| options.maxEndpointCount == 0
+		|| options.maxEndpointCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE
+		|| options.maxSelectorCount == 0
+		|| options.maxSelectorCount > DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const uint32_t width = pMips[0].width;
+	const uint32_t height = pMips[0].height;
+	const uint32_t planeCount = _getPlaneCount(layout);
+	const uint32_t channelCount = GetChannelCount(layout);
+	const uint32_t endpointSize = GetEndpointSize(layout);
+	const uint32_t maxSelector = GetMaxSelector(layout);
+	const size_t texelSize = size_t(ImageResampler::GetTexelSize(GetSourceFormat(layout)));
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const ImageResampler::ConstImage& mip = pMips[mipIndex];
+
+		if(!mip.pData
+			|| mip.width != TextureFootprint::GetMipDimension(width, mipIndex)
+			|| mip.height != TextureFootprint::GetMipDimension(height, mipIndex)
+			|| mip.rowPitch < size_t(mip.width) * texelSize)
+		{
+			LOG_ERROR("Invalid supercompressed texture mip image: mip=%" PRIu32, mipIndex);
+			return false;
+		}
+	}
+
+	// Every block plane of every mip is encoded as one unit. Units are ordered by mip, then by block in row-major
+	// order, then by plane, which is also the order they're stored in the file.
+	size_t mipUnitOffsets[DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT + 1];
+	size_t unitCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		mipUnitOffsets[mipIndex] = unitCount;
+		unitCount += size_t(GetBlockCount(width, mipIndex)) * size_t(GetBlockCount(height, mipIndex)) * planeCount;
+	}
+
+	mipUnitOffsets[mipCount] = unitCount;
+
+	const size_t unitTexelSize = size_t(DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT) * channelCount;
+	const size_t batchCount = (unitCount + DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE - 1) / DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE;
+
+	std::vector<uint8_t> unitTexels(unitCount * unitTexelSize);
+	std::vector<float> unitEndpoints(unitCount * endpointSize);
+	std::vector<float> unitSelectors(unitCount * DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT);
+
+	// Gather the texels of each unit, repeating the edge texels of the mip for blocks that hang over it, and fit a
+	// pair of endpoints to each one.
+	auto gatherUnits = [&](const size_t batchIndex)
+	{
+		const size_t unitBegin = batchIndex * DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE;
+		const size_t unitEnd = std::min(unitBegin + DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE, unitCount);
+
+		uint32_t mipIndex = 0;
+
+		for(size_t unitIndex = unitBegin; unitIndex < unitEnd; ++unitIndex)
+		{
+			while(unitIndex >= mipUnitOffsets[mipIndex + 1])
+			{
+				++mipIndex;
+			}
+
+			const ImageResampler::ConstImage& mip = pMips[mipIndex];
+
+			const size_t mipUnitIndex = unitIndex - mipUnitOffsets[mipIndex];
+			const size_t blockIndex = mipUnitIndex / planeCount;
+			const uint32_t planeIndex = uint32_t(mipUnitIndex % planeCount);
+			const uint32_t blockCountX = GetBlockCount(width, mipIndex);
+			const uint32_t blockX = uint32_t(blockIndex % blockCountX);
+			const uint32_t blockY = uint32_t(blockIndex / blockCountX);
+
+			uint8_t* const pTexels = unitTexels.data() + (unitIndex * unitTexelSize);
+
+			for(uint32_t y = 0; y < 4; ++y)
+			{
+				const uint32_t sourceY = std::min((blockY * 4) + y, mip.height - 1);
+				const uint8_t* const pSourceRow = mip.pData + (mip.rowPitch * sourceY);
+
+				for(uint32_t x = 0; x < 4; ++x)
+				{
+					const uint32_t sourceX = std::min((blockX * 4) + x, mip.width - 1);
+					const uint8_t* const pSourceTexel = pSourceRow + (sourceX * texelSize) + planeIndex;
+
+					memcpy(pTexels + ((((y * 4) + x)) * channelCount), pSourceTexel, channelCount);
+				}
+			}
+
+			FitEndpoints(pTexels, channelCount, unitEndpoints.data() + (unitIndex * endpointSize));
+		}
+	};
+
+	RunTasks(pThreadPool, batchCount, gatherUnits);
+
+	// Cluster the endpoints into the endpoint codebook.
+	std::vector<float> endpointCentroids;
+	std::vector<uint32_t> endpointAssignments;
+
+	BuildCodebook(unitEndpoints.data(), unitCount, endpointSize, options.maxEndpointCount, endpointCentroids, endpointAssignments);
+
+	const uint32_t endpointCount = uint32_t(endpointCentroids.size() / endpointSize);
+
+	std::vector<uint8_t> endpoints(size_t(endpointCount) * endpointSize);
+
+	for(size_t index = 0; index < endpoints.size(); ++index)
+	{
+		endpoints[index] = RoundToByte(endpointCentroids[index]);
+	}
+
+	// Pick the selectors of every unit against the endpoints it was assigned, then cluster those into the selector
+	// codebook.
+	auto fitUnitSelectors = [&](const size_t batchIndex)
+	{
+		const size_t unitBegin = batchIndex * DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE;
+		const size_t unitEnd = std::min(unitBegin + DF_SUPERCOMPRESSED_TEXTURE_ENCODE_BATCH_SIZE, unitCount);
+
+		for(size_t unitIndex = unitBegin; unitIndex < unitEnd; ++unitIndex)
+		{
+			FitSelectors(
+				unitTexels.data() + (unitIndex * unitTexelSize),
+				endpoints.data() + (size_t(endpointAssignments[unitIndex]) * endpointSize),
+				channelCount,
+				unitSelectors.data() + (unitIndex * DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT));
+		}
+	};
+
+	RunTasks(pThreadPool, batchCount, fitUnitSelectors);
+
+	std::vector<float> selectorCentroids;
+	std::vector<uint32_t> selectorAssignments;
+
+	BuildCodebook(
+		unitSelectors.data(),
+		unitCount,
+		DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT,
+		options.maxSelectorCount,
+		selectorCentroids,
+		selectorAssignments);
+
+	const uint32_t selectorCount = uint32_t(selectorCentroids.size() / DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT);
+
+	std::vector<uint64_t> selectors(selectorCount, 0);
+	std::vector<uint8_t> selectorValues(selectorCentroids.size());
+
+	for(size_t index = 0; index < selectorCentroids.size(); ++index)
+	{
+		selectorValues[index] = uint8_t(std::min(uint32_t(RoundToByte(selectorCentroids[index])), maxSelector));
+		selectors[index / DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT] |= uint64_t(selectorValues[index]) << ((index % DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT) * 4);
+	}
+
+	// Clustering moved the selectors of most units, so refit each endpoint entry to the texels of every unit using it
+	// by least squares, given the selectors those units ended up with. Each channel of an entry solves the same 2x2
+	// system with a different right-hand side.
+	{
+		struct RefitSums
+		{
+			double a00;
+			double a01;
+			double a11;
+			double b0[4];
+			double b1[4];
+		};
+
+		std::vector<RefitSums> sums(endpointCount, RefitSums());
+
+		for(size_t unitIndex = 0; unitIndex < unitCount; ++unitIndex)
+		{
+			RefitSums& entrySums = sums[endpointAssignments[unitIndex]];
+
+			const uint8_t* const pTexels = unitTexels.data() + (unitIndex * unitTexelSize);
+			const uint8_t* const pSelectors = selectorValues.data() + (size_t(selectorAssignments[unitIndex]) * DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT);
+
+			for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+			{
+				const double w1 = (channelCount == 1)
+					? double(pSelectors[texelIndex]) / 7.0
+					: double(ColorSelectorWeights[pSelectors[texelIndex]]) / 64.0;
+				const double w0 = 1.0 - w1;
+
+				entrySums.a00 += w0 * w0;
+				entrySums.a01 += w0 * w1;
+				entrySums.a11 += w1 * w1;
+
+				for(uint32_t i = 0; i < channelCount; ++i)
+				{
+					entrySums.b0[i] += w0 * pTexels[(texelIndex * channelCount) + i];
+					entrySums.b1[i] += w1 * pTexels[(texelIndex * channelCount) + i];
+				}
+			}
+		}
+
+		for(uint32_t entryIndex = 0; entryIndex < endpointCount; ++entryIndex)
+		{
+			const RefitSums& entrySums = sums[entryIndex];
+
+			const double determinant = (entrySums.a00 * entrySums.a11) - (entrySums.a01 * entrySums.a01);
+
+			// Entries whose units all use a single selector have no line to fit.
+			if(fabs(determinant) < 1.0e-6)
+			{
+				continue;
+			}
+
+			uint8_t refit[8];
+
+			for(uint32_t i = 0; i < channelCount; ++i)
+			{
+				const double e0 = ((entrySums.a11 * entrySums.b0[i]) - (entrySums.a01 * entrySums.b1[i])) / determinant;
+				const double e1 = ((entrySums.a00 * entrySums.b1[i]) - (entrySums.a01 * entrySums.b0[i])) / determinant;
+
+				refit[i] = RoundToByte(float(e0));
+				refit[i + channelCount] = RoundToByte(float(e1));
+			}
+
+			// Plane endpoints have to stay in order, since the selectors can't be flipped to match.
+			if(channelCount == 1 && refit[0] < refit[1])
+			{
+				continue;
+			}
+
+			memcpy(endpoints.data() + (size_t(entryIndex) * endpointSize), refit, endpointSize);
+		}
+	}
+
+	std::vector<uint16_t> blocks(unitCount * 2);
+
+	for(size_t unitIndex = 0; unitIndex < unitCount; ++unitIndex)
+	{
+		blocks[(unitIndex * 2) + 0] = uint16_t(endpointAssignments[unitIndex]);
+		blocks[(unitIndex * 2) + 1] = uint16_t(selectorAssignments[unitIndex]);
+	}
+
+	SupercompressedTextureFileHeader header;
+	memset(&header, 0, sizeof(header));
+
+	header.magic = DF_SUPERCOMPRESSED_TEXTURE_FILE_MAGIC;
+	header.version = DF_SUPERCOMPRESSED_TEXTURE_FILE_VERSION;
+	header.desc.layout = layout;
+	header.desc.width = width;
+	header.desc.height = height;
+	header.desc.mipCount = mipCount;
+	header.desc.endpointCount = endpointCount;
+	header.desc.selectorCount = selectorCount;
+	header.endpointOffset = sizeof(header);
+	header.selectorOffset = Math::GetAlignedSize(header.endpointOffset + endpoints.size(), uint64_t(sizeof(uint64_t)));
+	header.blockOffset = header.selectorOffset + (selectors.size() * sizeof(uint64_t));
+	header.blockSize = blocks.size() * sizeof(uint16_t);
+
+	FILE* const pFile = fopen(filePath, "wb");
+	if(!pFile)
+	{
+		LOG_ERROR("Failed to open supercompressed texture file for writing: path=\"%s\"", filePath);
+		return false;
+	}
+
+	const uint64_t padding = 0;
+	const size_t paddingSize = size_t(header.selectorOffset - (header.endpointOffset + endpoints.size()));
+
+	const bool result = (fwrite(&header, sizeof(header), 1, pFile) == 1)
+		&& (fwrite(endpoints.data(), 1, endpoints.size(), pFile) == endpoints.size())
+		&& (fwrite(&padding, 1, paddingSize, pFile) == paddingSize)
+		&& (fwrite(selectors.data(), sizeof(uint64_t), selectors.size(), pFile) == selectors.size())
+		&& (fwrite(blocks.data(), sizeof(uint16_t), blocks.size(), pFile) == blocks.size());
+
+	fclose(pFile);
+
+	if(!result)
+	{
+		LOG_ERROR("Failed to write supercompressed texture file: path=\"%s\"", filePath);
+		remove(filePath);
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SupercompressedTexture::HasFileExtension(const char* const filePath)
+{
+	if(!filePath)
+	{
+		return false;
+	}
+
+	const char* const extension = DF_SUPERCOMPRESSED_TEXTURE_FILE_EXTENSION;
+
+	const size_t pathLength = strlen(filePath);
+	const size_t extensionLength = strlen(extension);
+
+	if(pathLength < extensionLength)
+	{
+		return false;
+	}
+
+	const char* const pathExtension = filePath + (pathLength - extensionLength);
+
+	for(size_t index = 0; index < extensionLength; ++index)
+	{
+		if(tolower(static_cast<unsigned char>(pathExtension[index])) != extension[index])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::SupercompressedTexture::Transcode(
+	const BlockCompressor::Format format,
+	const ImageResampler::Image* const pDstMips,
+	const uint32_t mipCount,
+	ThreadPool* const pThreadPool) const
+{
+	if(!CanTranscode(format) || !pDstMips || mipCount == 0 || mipCount > m_desc.mipCount)
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	const size_t blockSize = BlockCompressor::GetBlockSize(format);
+
+	// Every block row of every mip is a separate task.
+	uint32_t mipRowOffsets[DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT + 1];
+	uint32_t rowCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const ImageResampler::Image& mip = pDstMips[mipIndex];
+
+		if(!mip.pData || mip.rowPitch < size_t(GetBlockCount(m_desc.width, mipIndex)) * blockSize)
+		{
+			LOG_ERROR("Invalid supercompressed texture transcode destination: mip=%" PRIu32, mipIndex);
+			return false;
+		}
+
+		mipRowOffsets[mipIndex] = rowCount;
+		rowCount += GetBlockCount(m_desc.height, mipIndex);
+	}
+
+	mipRowOffsets[mipCount] = rowCount;
+
+	// Convert every codebook entry to the target format once, so each block only has to combine two of them. Entries
+	// are converted for both orders of the endpoints (or, for BC4, both interpolation modes), and the selector entry
+	// decides which of the two a block uses.
+	struct Bc7Endpoint
+	{
+		uint64_t bits[2][2];
+	};
+
+	struct Bc7Selector
+	{
+		uint64_t bits;
+		uint32_t swap;
+	};
+
+	struct Bc1Endpoint
+	{
+		uint32_t colors;
+		uint32_t mode;
+	};
+
+	struct Bc1Selector
+	{
+		uint32_t bits[3];
+	};
+
+	struct Bc4Endpoint
+	{
+		uint64_t bits;
+		uint32_t flat;
+	};
+
+	struct Bc4Selector
+	{
+		uint64_t bits[2];
+	};
+
+	std::vector<Bc7Endpoint> bc7Endpoints;
+	std::vector<Bc7Selector> bc7Selectors;
+	std::vector<Bc1Endpoint> bc1Endpoints;
+	std::vector<Bc1Selector> bc1Selectors;
+	std::vector<Bc4Endpoint> bc4Endpoints;
+	std::vector<Bc4Selector> bc4Selectors;
+
+	switch(format)
+	{
+		case BlockCompressor::Format::BC7:
+		{
+			bc7Endpoints.resize(m_desc.endpointCount);
+			bc7Selectors.resize(m_desc.selectorCount);
+
+			// Mode 6 stores a single subset with two RGBA endpoints of 7 bits per channel plus a p-bit each, and a
+			// 4-bit index per texel. The first index drops its most significant bit, so the endpoints are swapped
+			// (and the indices inverted) for selector entries that would set it.
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.endpointCount; ++entryIndex)
+			{
+				const uint8_t* const pEndpoints = m_pEndpoints + (entryIndex * 8);
+
+				uint32_t channels[2][4];
+				uint32_t parity[2];
+
+				QuantizeBc7Endpoint(pEndpoints, channels[0], parity[0]);
+				QuantizeBc7Endpoint(pEndpoints + 4, channels[1], parity[1]);
+
+				for(uint32_t swap = 0; swap < 2; ++swap)
+				{
+					uint64_t* const pBits = bc7Endpoints[entryIndex].bits[swap];
+
+					pBits[0] = uint64_t(1) << 6;
+					pBits[1] = 0;
+
+					for(uint32_t endpoint = 0; endpoint < 2; ++endpoint)
+					{
+						const uint32_t source = endpoint ^ swap;
+
+						for(uint32_t i = 0; i < 4; ++i)
+						{
+							SetBits(pBits, 7 + (i * 14) + (endpoint * 7), channels[source][i]);
+						}
+
+						SetBits(pBits, 63 + endpoint, parity[source]);
+					}
+				}
+			}
+
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.selectorCount; ++entryIndex)
+			{
+				const uint64_t selectors = m_pSelectors[entryIndex];
+				const uint32_t swap = (Bc7SelectorIndices[selectors & 0xF] >= 8) ? 1 : 0;
+
+				uint64_t bits[2] = { 0, 0 };
+
+				for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+				{
+					const uint32_t index = Bc7SelectorIndices[(selectors >> (texelIndex * 4)) & 0xF];
+
+					SetBits(bits, (texelIndex == 0) ? 65 : (64 + (texelIndex * 4)), swap ? (15 - index) : index);
+				}
+
+				bc7Selectors[entryIndex].bits = bits[1];
+				bc7Selectors[entryIndex].swap = swap;
+			}
+
+			break;
+		}
+
+		case BlockCompressor::Format::BC1:
+		{
+			bc1Endpoints.resize(m_desc.endpointCount);
+			bc1Selectors.resize(m_desc.selectorCount);
+
+			// BC1 only interpolates between its endpoints when the first is greater than the second, so entries whose
+			// endpoints quantize the other way around are stored swapped, and entries that quantize to a single color
+			// use the first endpoint for every texel.
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.endpointCount; ++entryIndex)
+			{
+				const uint32_t color0 = PackRgb565(m_pEndpoints + (entryIndex * 8));
+				const uint32_t color1 = PackRgb565(m_pEndpoints + (entryIndex * 8) + 4);
+
+				Bc1Endpoint& endpoint = bc1Endpoints[entryIndex];
+
+				if(color0 > color1)
+				{
+					endpoint.colors = color0 | (color1 << 16);
+					endpoint.mode = 0;
+				}
+				else if(color0 < color1)
+				{
+					endpoint.colors = color1 | (color0 << 16);
+					endpoint.mode = 1;
+				}
+				else
+				{
+					endpoint.colors = color0 | (color1 << 16);
+					endpoint.mode = 2;
+				}
+			}
+
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.selectorCount; ++entryIndex)
+			{
+				const uint64_t selectors = m_pSelectors[entryIndex];
+
+				Bc1Selector& selector = bc1Selectors[entryIndex];
+				memset(&selector, 0, sizeof(selector));
+
+				for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+				{
+					const uint32_t value = uint32_t(selectors >> (texelIndex * 4)) & 0xF;
+
+					selector.bits[0] |= Bc1SelectorIndices[0][value] << (texelIndex * 2);
+					selector.bits[1] |= Bc1SelectorIndices[1][value] << (texelIndex * 2);
+				}
+			}
+
+			break;
+		}
+
+		default:
+		{
+			bc4Endpoints.resize(m_desc.endpointCount);
+			bc4Selectors.resize(m_desc.selectorCount);
+
+			// Plane endpoints are stored with the first no smaller than the second. When they differ they select the
+			// 8-value mode of BC4 directly; when they're equal the block is flat, and every texel uses index 0.
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.endpointCount; ++entryIndex)
+			{
+				const uint8_t* const pEndpoints = m_pEndpoints + (entryIndex * 2);
+
+				bc4Endpoints[entryIndex].bits = uint64_t(pEndpoints[0]) | (uint64_t(pEndpoints[1]) << 8);
+				bc4Endpoints[entryIndex].flat = (pEndpoints[0] == pEndpoints[1]) ? 1 : 0;
+			}
+
+			for(uint32_t entryIndex = 0; entryIndex < m_desc.selectorCount; ++entryIndex)
+			{
+				const uint64_t selectors = m_pSelectors[entryIndex];
+
+				uint64_t bits = 0;
+
+				for(uint32_t texelIndex = 0; texelIndex < DF_SUPERCOMPRESSED_TEXTURE_BLOCK_TEXEL_COUNT; ++texelIndex)
+				{
+					bits |= uint64_t(Bc4SelectorIndices[(selectors >> (texelIndex * 4)) & 0x7]) << (16 + (texelIndex * 3));
+				}
+
+				bc4Selectors[entryIndex].bits[0] = bits;
+				bc4Selectors[entryIndex].bits[1] = 0;
+			}
+
+			break;
+		}
+	}
+
+	const uint32_t planeCount = _getPlaneCount(m_desc.layout);
+
+	auto transcodeRow = [&](const size_t rowIndex)
+	{
+		uint32_t mipIndex = 0;
+
+		while(rowIndex >= mipRowOffsets[mipIndex + 1])
+		{
+			++mipIndex;
+		}
+
+		const uint32_t blockY = uint32_t(rowIndex - mipRowOffsets[mipIndex]);
+		const uint32_t blockCountX = GetBlockCount(m_desc.width, mipIndex);
+
+		const uint16_t* pBlock = m_pBlocks + m_mipBlockOffsets[mipIndex] + (size_t(blockY) * blockCountX * planeCount * 2);
+		uint64_t* pOutput = reinterpret_cast<uint64_t*>(pDstMips[mipIndex].pData + (pDstMips[mipIndex].rowPitch * blockY));
+
+		switch(format)
+		{
+			case BlockCompressor::Format::BC7:
+				for(uint32_t blockX = 0; blockX < blockCountX; ++blockX, pBlock += 2, pOutput += 2)
+				{
+					const Bc7Endpoint& endpoint = bc7Endpoints[pBlock[0]];
+					const Bc7Selector& selector = bc7Selectors[pBlock[1]];
+
+					pOutput[0] = endpoint.bits[selector.swap][0];
+					pOutput[1] = endpoint.bits[selector.swap][1] | selector.bits;
+				}
+				break;
+
+			case BlockCompressor::Format::BC1:
+				for(uint32_t blockX = 0; blockX < blockCountX; ++blockX, pBlock += 2, ++pOutput)
+				{
+					const Bc1Endpoint& endpoint = bc1Endpoints[pBlock[0]];
+
+					pOutput[0] = uint64_t(endpoint.colors) | (uint64_t(bc1Selectors[pBlock[1]].bits[endpoint.mode]) << 32);
+				}
+				break;
+
+			default:
+				for(uint32_t blockIndex = 0; blockIndex < blockCountX * planeCount; ++blockIndex, pBlock += 2, ++pOutput)
+				{
+					const Bc4Endpoint& endpoint = bc4Endpoints[pBlock[0]];
+
+					pOutput[0] = endpoint.bits | bc4Selectors[pBlock[1]].bits[endpoint.flat];
+				}
+				break;
+		}
+	};
+
+	RunTasks(pThreadPool, rowCount, transcodeRow);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "BlockCompressor.hpp"
+#include "MappedFile.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_SUPERCOMPRESSED_TEXTURE_FILE_EXTENSION ".dfsc"
+
+#define DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT      16
+#define DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE  65536
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class SupercompressedTexture;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Compact on-disk texture format that is transcoded to a block-compressed format at load time. Every 4x4 block is
+// described by a pair of endpoints and a selector per texel picking a point on the line between them, like the BC
+// formats themselves, but instead of storing those per block, the file holds a codebook of endpoint pairs and a
+// codebook of selector patterns, and each block only stores a 16-bit index into each of them. That puts a block at 4
+// bytes per channel plane, a quarter of BC7 and half of BC1.
+//
+// Transcoding converts each codebook entry to the target format once, after which every block is two table lookups
+// and a store, so the cost is close to copying the output. Block rows are transcoded in parallel on a thread pool.
+//
+// The color layout holds RGBA endpoints with 2-bit selectors and transcodes to BC7 (mode 6) or, dropping alpha, to
+// BC1. The single and dual channel layouts hold one or two planes of single-channel endpoints with 3-bit selectors,
+// and transcode to BC4 and BC5.
+class DF_API DemoFramework::Utility::SupercompressedTexture
+{
+public:
+
+	typedef std::shared_ptr<SupercompressedTexture> Ptr;
+
+	enum class Layout : uint32_t
+	{
+		Color, // RGBA8 source; transcodes to BC1 (dropping alpha) or BC7
+		R,     // R8 source; transcodes to BC4
+		RG,    // RG8 source; transcodes to BC5
+	};
+
+	struct Desc
+	{
+		Layout layout;
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipCount;
+		uint32_t endpointCount; // Entries in the endpoint codebook
+		uint32_t selectorCount; // Entries in the selector codebook
+	};
+
+	struct EncodeOptions
+	{
+		EncodeOptions();
+
+		// Upper bounds on the size of each codebook, up to DF_SUPERCOMPRESSED_TEXTURE_MAX_CODEBOOK_SIZE. Larger
+		// codebooks preserve more detail at the cost of encoding time and a slightly larger file.
+		uint32_t maxEndpointCount;
+		uint32_t maxSelectorCount;
+	};
+
+	SupercompressedTexture();
+	SupercompressedTexture(const SupercompressedTexture&) = delete;
+	SupercompressedTexture(SupercompressedTexture&&) = delete;
+
+	SupercompressedTexture& operator =(const SupercompressedTexture&) = delete;
+	SupercompressedTexture& operator =(SupercompressedTexture&&) = delete;
+
+	static Ptr Open(const char* filePath);
+
+	// Encode a full mip chain held in memory, with the image of each mip in 'pMips', and write it to a file. The
+	// source images must be in the format returned by GetSourceFormat() for the layout; blocks that hang over the edge
+	// of a mip repeat its edge texels. A null thread pool runs everything on the calling thread.
+	static bool Write(
+		const char* filePath,
+		Layout layout,
+		const ImageResampler::ConstImage* pMips,
+		uint32_t mipCount,
+		const EncodeOptions& options,
+		ThreadPool* pThreadPool);
+
+	// True when the path ends with DF_SUPERCOMPRESSED_TEXTURE_FILE_EXTENSION, ignoring case.
+	static bool HasFileExtension(const char* filePath);
+
+	static ImageResampler::Format GetSourceFormat(Layout layout);
+
+	bool CanTranscode(BlockCompressor::Format format) const;
+
+	// Transcode mips [0, mipCount) into rows of blocks, with the destination of each mip in 'pDstMips'. The mip count
+	// may be less than the number of mips in the file to skip the least detailed ones.
+	bool Transcode(BlockCompressor::Format format, const ImageResampler::Image* pDstMips, uint32_t mipCount, ThreadPool* pThreadPool) const;
+
+	const Desc& GetDesc() const;
+
+	// Size of the file the texture was read from.
+	uint64_t GetFileSize() const;
+
+
+private:
+
+	static uint32_t _getPlaneCount(Layout);
+
+	MappedFile::Ptr m_file;
+
+	Desc m_desc;
+
+	const uint8_t* m_pEndpoints;
+	const uint64_t* m_pSelectors;
+	const uint16_t* m_pBlocks;
+
+	uint64_t m_mipBlockOffsets[DF_SUPERCOMPRESSED_TEXTURE_MAX_MIP_COUNT];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::Utility::SupercompressedTexture>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::SupercompressedTexture::EncodeOptions::EncodeOptions()
+	: maxEndpointCount(8192)
+	, maxSelectorCount(8192)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::ImageResampler::Format DemoFramework::Utility::SupercompressedTexture::GetSourceFormat(const Layout layout)
+{
+	switch(layout)
+	{
+		case Layout::R:  return ImageResampler::Format::R8Unorm;
+		case Layout::RG: return ImageResampler::Format::RG8Unorm;
+
+		default:
+			break;
+	}
+
+	return ImageResampler::Format::RGBA8Unorm;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::Utility::SupercompressedTexture::CanTranscode(const BlockCompressor::Format format) const
+{
+	switch(m_desc.layout)
+	{
+		case Layout::Color: return format == BlockCompressor::Format::BC1 || format == BlockCompressor::Format::BC7;
+		case Layout::R:     return format == BlockCompressor::Format::BC4;
+		case Layout::RG:    return format == BlockCompressor::Format::BC5;
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::Utility::SupercompressedTexture::Desc& DemoFramework::Utility::SupercompressedTexture::GetDesc() const
+{
+	return m_desc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::SupercompressedTexture::GetFileSize() const
+{
+	return m_file ? m_file->GetSize() : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::SupercompressedTexture::_getPlaneCount(const Layout layout)
+{
+	return (layout == Layout::RG) ? 2 : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
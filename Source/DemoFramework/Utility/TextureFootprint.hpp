@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Math.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class TextureFootprint;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Portable equivalent of ID3D12Device::GetCopyableFootprints() for 2D textures. This computes the layout of every mip
+// level in a linear upload buffer without needing a device, following the same placement and row pitch rules that
+// D3D12 requires for buffer-to-texture copies.
+class DF_API DemoFramework::Utility::TextureFootprint
+{
+public:
+
+	// Matches D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
+	static constexpr uint32_t PitchAlignment = 256;
+
+	// Matches D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT.
+	static constexpr uint32_t PlacementAlignment = 512;
+
+	struct FormatInfo
+	{
+		uint32_t blockWidth;    // 1 for uncompressed formats
+		uint32_t blockHeight;   // 1 for uncompressed formats
+		uint32_t bytesPerBlock; // Texel size for uncompressed formats
+	};
+
+	struct Subresource
+	{
+		uint64_t offset;   // Offset from the start of the buffer
+		uint64_t rowSize;  // Number of bytes of actual data in each row
+		uint32_t rowPitch; // Stride between rows, including padding
+		uint32_t rowCount; // Number of rows; for block-compressed formats, each row is a row of blocks
+		uint32_t width;    // Texel width, rounded up to a whole number of blocks
+		uint32_t height;   // Texel height, rounded up to a whole number of blocks
+	};
+
+	TextureFootprint() = delete;
+	TextureFootprint(const TextureFootprint&) = delete;
+	TextureFootprint(TextureFootprint&&) = delete;
+
+	// Number of mip levels in a full mip chain for the given dimensions.
+	static uint32_t GetMaxMipCount(uint32_t width, uint32_t height);
+
+	// Size of a single mip level dimension.
+	static uint32_t GetMipDimension(uint32_t size, uint32_t mipIndex);
+
+	// Fill in the layout of each mip level and return the total number of bytes required to hold all of them.
+	// The output array must have room for 'mipCount' entries and may be null when only the total size is needed.
+	static uint64_t Compute(
+		const FormatInfo& formatInfo,
+		uint32_t width,
+		uint32_t height,
+		uint32_t mipCount,
+		Subresource* pOutSubresources);
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::TextureFootprint::GetMaxMipCount(const uint32_t width, const uint32_t height)
+{
+	uint32_t size = (width > height) ? width : height;
+	uint32_t mipCount = 1;
+
+	while(size > 1)
+	{
+		size >>= 1;
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::TextureFootprint::GetMipDimension(const uint32_t size, const uint32_t mipIndex)
+{
+	const uint32_t mipSize = (mipIndex < 32) ? (size >> mipIndex) : 0;
+	return (mipSize > 0) ? mipSize : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::TextureFootprint::Compute(
+	const FormatInfo& formatInfo,
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t mipCount,
+	Subresource* const pOutSubresources)
+{
+	if(formatInfo.blockWidth == 0 || formatInfo.blockHeight == 0 || formatInfo.bytesPerBlock == 0)
+	{
+		return 0;
+	}
+
+	uint64_t totalSize = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t blockCountX = (GetMipDimension(width, mipIndex) + formatInfo.blockWidth - 1) / formatInfo.blockWidth;
+		const uint32_t blockCountY = (GetMipDimension(height, mipIndex) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+
+		const uint64_t rowSize = uint64_t(blockCountX) * uint64_t(formatInfo.bytesPerBlock);
+		const uint64_t rowPitch = Math::GetAlignedSize(rowSize, uint64_t(PitchAlignment));
+		const uint64_t offset = Math::GetAlignedSize(totalSize, uint64_t(PlacementAlignment));
+
+		if(pOutSubresources)
+		{
+			Subresource& subresource = pOutSubresources[mipIndex];
+
+			subresource.offset = offset;
+			subresource.rowSize = rowSize;
+			subresource.rowPitch = uint32_t(rowPitch);
+			subresource.rowCount = blockCountY;
+			subresource.width = blockCountX * formatInfo.blockWidth;
+			subresource.height = blockCountY * formatInfo.blockHeight;
+		}
+
+		// The last row doesn't need to be padded out to the full pitch.
+		totalSize = offset + (rowPitch * (blockCountY - 1)) + rowSize;
+	}
+
+	return totalSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the thread state using PIMPL to make MSVC shut up about the std containers needing DLL interfaces.
+struct DemoFramework::Utility::ThreadPool::Job
+{
+	const TaskFunc* pTask;
+
+	// Storage for the task of a job submitted without waiting for it since the submitting thread's copy is gone by
+	// the time the job runs.
+	TaskFunc ownedTask;
+
+	size_t taskCount;
+
+	std::atomic<size_t> nextIndex;
+	std::atomic<size_t> completedCount;
+
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+};
+
+struct DemoFramework::Utility::ThreadPool::InternalData
+{
+	std::mutex mutex;
+	std::condition_variable wakeCondition;
+
+	std::deque<std::shared_ptr<Job>> jobs;
+	std::vector<std::thread> threads;
+
+	bool shutdown;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static thread_local bool isPoolWorkerThread = false;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void RunPoolJob(
+	const DemoFramework::Utility::ThreadPool::TaskFunc* const pTask,
+	std::atomic<size_t>& nextIndex,
+	std::atomic<size_t>& completedCount,
+	const size_t taskCount,
+	std::mutex& doneMutex,
+	std::condition_variable& doneCondition)
+{
+	// The task function is owned by the thread that called ParallelFor(), so it
+	// must not be touched once every task of the job has been claimed.
+	for(;;)
+	{
+		const size_t index = nextIndex.fetch_add(1);
+		if(index >= taskCount)
+		{
+			break;
+		}
+
+		(*pTask)(index);
+
+		if(completedCount.fetch_add(1) + 1 == taskCount)
+		{
+			// This was the last task, so wake up the thread waiting on the job.
+			std::lock_guard<std::mutex> lock(doneMutex);
+			doneCondition.notify_all();
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ThreadPool::~ThreadPool()
+{
+	if(m_pData)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_pData->mutex);
+			m_pData->shutdown = true;
+		}
+
+		m_pData->wakeCondition.notify_all();
+
+		for(std::thread& thread : m_pData->threads)
+		{
+			thread.join();
+		}
+
+		delete m_pData;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ThreadPool::Ptr DemoFramework::Utility::ThreadPool::Create(const uint32_t workerCount)
+{
+	Ptr output = std::make_shared<ThreadPool>();
+
+	output->_start(workerCount);
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::ThreadPool* DemoFramework::Utility::ThreadPool::GetShared()
+{
+	// The shared pool is intentionally never destroyed. Joining threads while the
+	// module is being unloaded at process exit can deadlock on Windows.
+	static ThreadPool* const pSharedPool = []() -> ThreadPool*
+	{
+		ThreadPool* const pPool = new ThreadPool();
+		pPool->_start(0);
+
+		return pPool;
+	}();
+
+	return pSharedPool;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ThreadPool::ParallelFor(const size_t taskCount, const TaskFunc& task)
+{
+	if(taskCount == 0)
+	{
+		return;
+	}
+
+	if(taskCount == 1 || m_workerCount == 0 || isPoolWorkerThread)
+	{
+		// Nothing to gain from (or no safe way of) distributing the tasks, so just run them here.
+		for(size_t i = 0; i < taskCount; ++i)
+		{
+			task(i);
+		}
+
+		return;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->pTask = &task;
+	job->taskCount = taskCount;
+	job->nextIndex = 0;
+	job->completedCount = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_pData->mutex);
+		m_pData->jobs.push_back(job);
+	}
+
+	m_pData->wakeCondition.notify_all();
+
+	// Work on the job from this thread too.
+	RunPoolJob(&task, job->nextIndex, job->completedCount, taskCount, job->doneMutex, job->doneCondition);
+
+	// Wait for any tasks still running on the worker threads.
+	{
+		std::unique_lock<std::mutex> lock(job->doneMutex);
+		job->doneCondition.wait(lock, [&job]() { return job->completedCount.load() == job->taskCount; });
+	}
+
+	// Make sure the job is no longer queued. The workers normally remove it as soon as all
+	// of its tasks have been claimed, but that's not guaranteed to have happened yet.
+	{
+		std::lock_guard<std::mutex> lock(m_pData->mutex);
+
+		for(auto it = m_pData->jobs.begin(); it != m_pData->jobs.end(); ++it)
+		{
+			if(*it == job)
+			{
+				m_pData->jobs.erase(it);
+				break;
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ThreadPool::Submit(const std::function<void()>& task)
+{
+	if(m_workerCount == 0)
+	{
+		task();
+		return;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->ownedTask = [task](size_t) { task(); };
+	job->pTask = &job->ownedTask;
+	job->taskCount = 1;
+	job->nextIndex = 0;
+	job->completedCount = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_pData->mutex);
+		m_pData->jobs.push_back(job);
+	}
+
+	m_pData->wakeCondition.notify_one();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ThreadPool::_start(uint32_t workerCount)
+{
+	if(workerCount == 0)
+	{
+		const uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+
+		workerCount = (hardwareThreadCount > 1) ? hardwareThreadCount - 1 : 0;
+	}
+
+	m_pData = new InternalData();
+	m_pData->shutdown = false;
+	m_pData->threads.reserve(workerCount);
+
+	for(uint32_t i = 0; i < workerCount; ++i)
+	{
+		m_pData->threads.emplace_back([this]() { _workerMain(); });
+	}
+
+	m_workerCount = workerCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::ThreadPool::_workerMain()
+{
+	isPoolWorkerThread = true;
+
+	for(;;)
+	{
+		std::shared_ptr<Job> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_pData->mutex);
+			m_pData->wakeCondition.wait(lock, [this]() { return m_pData->shutdown || !m_pData->jobs.empty(); });
+
+			if(m_pData->shutdown)
+			{
+				break;
+			}
+
+			job = m_pData->jobs.front();
+
+			if(job->nextIndex.load() >= job->taskCount)
+			{
+				// Every task in this job has already been claimed, so there's nothing left to do for it.
+				m_pData->jobs.pop_front();
+				continue;
+			}
+		}
+
+		RunPoolJob(job->pTask, job->nextIndex, job->completedCount, job->taskCount, job->doneMutex, job->doneCondition);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
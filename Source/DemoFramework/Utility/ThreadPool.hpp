@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <functional>
+#include <memory>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ThreadPool;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fixed set of worker threads for splitting CPU-heavy loops (image processing, encoding, etc.) into parallel tasks.
+class DF_API DemoFramework::Utility::ThreadPool
+{
+public:
+
+	typedef std::shared_ptr<ThreadPool> Ptr;
+	typedef std::function<void(size_t)> TaskFunc;
+
+	ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	~ThreadPool();
+
+	ThreadPool& operator =(const ThreadPool&) = delete;
+	ThreadPool& operator =(ThreadPool&&) = delete;
+
+	// Create a pool with the given number of worker threads. A worker count
+	// of zero creates one worker per hardware thread, minus the calling thread.
+	static Ptr Create(uint32_t workerCount = 0);
+
+	// Pool shared by everything in the framework that doesn't need a dedicated pool of its own.
+	static ThreadPool* GetShared();
+
+	// Run the task once for every index in [0, taskCount), blocking until all of them have finished. The calling
+	// thread works through tasks as well, so this is safe to call with an empty pool. Calls from inside a
+	// task run serially on the calling worker to avoid deadlocking the pool.
+	void ParallelFor(size_t taskCount, const TaskFunc& task);
+
+	// Queue a task to run on a worker thread without waiting for it. When the pool has no workers,
+	// the task runs on the calling thread before this returns.
+	void Submit(const std::function<void()>& task);
+
+	uint32_t GetWorkerCount() const;
+
+
+private:
+
+	struct InternalData;
+	struct Job;
+
+	void _start(uint32_t);
+	void _workerMain();
+
+	InternalData* m_pData;
+
+	uint32_t m_workerCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::Utility::ThreadPool>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::ThreadPool::ThreadPool()
+	: m_pData(nullptr)
+	, m_workerCount(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::ThreadPool::GetWorkerCount() const
+{
+	return m_workerCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
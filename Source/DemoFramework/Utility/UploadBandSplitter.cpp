@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "UploadBandSplitter.hpp"
+
+#include <string.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::UploadBandSplitter::UploadBandSplitter()
+	: m_subresources()
+	, m_windowSize(0)
+	, m_windowUsed(0)
+	, m_subresourceCount(0)
+	, m_subresource(0)
+	, m_row(0)
+	, m_submission(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::UploadBandSplitter::Reset(
+	const TextureFootprint::Subresource* const pSubresources,
+	const uint32_t subresourceCount,
+	const uint64_t windowSize)
+{
+	m_windowSize = 0;
+	m_windowUsed = 0;
+	m_subresourceCount = 0;
+	m_subresource = 0;
+	m_row = 0;
+	m_submission = 0;
+
+	if(!pSubresources || subresourceCount > DF_UPLOAD_BAND_SPLITTER_MAX_SUBRESOURCE_COUNT)
+	{
+		return false;
+	}
+
+	// Every band must hold at least one row, otherwise splitting would never make progress.
+	for(uint32_t index = 0; index < subresourceCount; ++index)
+	{
+		if(GetFittingRowCount(pSubresources[index], 0, windowSize) == 0 && pSubresources[index].rowCount > 0)
+		{
+			return false;
+		}
+	}
+
+	memcpy(m_subresources, pSubresources, sizeof(TextureFootprint::Subresource) * subresourceCount);
+
+	m_windowSize = windowSize;
+	m_subresourceCount = subresourceCount;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::UploadBandSplitter::Next(Band& outBand)
+{
+	// Skip past empty subresources.
+	while(m_subresource < m_subresourceCount && m_row >= m_subresources[m_subresource].rowCount)
+	{
+		++m_subresource;
+		m_row = 0;
+	}
+
+	if(m_subresource >= m_subresourceCount)
+	{
+		return false;
+	}
+
+	const TextureFootprint::Subresource& subresource = m_subresources[m_subresource];
+
+	uint64_t windowOffset = Math::GetAlignedSize(m_windowUsed, uint64_t(TextureFootprint::PlacementAlignment));
+	uint32_t fittingRowCount = GetFittingRowCount(subresource, windowOffset, m_windowSize);
+
+	if(fittingRowCount == 0)
+	{
+		// The window is full, so start over at the beginning of it with a new submission. Reset() already made sure at
+		// least one row fits in an empty window.
+		windowOffset = 0;
+		fittingRowCount = GetFittingRowCount(subresource, 0, m_windowSize);
+
+		++m_submission;
+	}
+
+	const uint32_t rowsLeft = subresource.rowCount - m_row;
+	const uint32_t rowCount = (fittingRowCount < rowsLeft) ? fittingRowCount : rowsLeft;
+
+	outBand.subresource = m_subresource;
+	outBand.firstRow = m_row;
+	outBand.rowCount = rowCount;
+	outBand.submission = m_submission;
+	outBand.windowOffset = windowOffset;
+	outBand.size = (uint64_t(subresource.rowPitch) * (rowCount - 1)) + subresource.rowSize;
+
+	m_windowUsed = windowOffset + outBand.size;
+	m_row += rowCount;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
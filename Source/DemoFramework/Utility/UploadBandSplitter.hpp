@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "TextureFootprint.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_UPLOAD_BAND_SPLITTER_MAX_SUBRESOURCE_COUNT 16
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class UploadBandSplitter;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Splits the subresources of a texture into bands of rows that fit inside a fixed-size staging window. Bands are
+// handed out in subresource order, top to bottom, and packed one after another into the window. When the next band
+// can't fit in what's left of the window, it starts a new submission at the beginning of the window, which the caller
+// may only write to once the GPU is done with the copies from the previous submission. Like the stream scheduler, this
+// only does the bookkeeping and never touches any GPU objects.
+class DF_API DemoFramework::Utility::UploadBandSplitter
+{
+public:
+
+	struct Band
+	{
+		uint32_t subresource;  // Index into the subresources passed to Reset()
+		uint32_t firstRow;     // First row of the subresource in the band; rows of blocks for compressed formats
+		uint32_t rowCount;
+		uint32_t submission;   // Increases by one each time the band starts over at the beginning of the window
+		uint64_t windowOffset; // Offset of the band in the window, aligned to the texture data placement alignment
+		uint64_t size;         // Bytes used by the band; the last row isn't padded out to the full pitch
+	};
+
+	UploadBandSplitter();
+	UploadBandSplitter(const UploadBandSplitter&) = delete;
+	UploadBandSplitter(UploadBandSplitter&&) = delete;
+
+	UploadBandSplitter& operator =(const UploadBandSplitter&) = delete;
+	UploadBandSplitter& operator =(UploadBandSplitter&&) = delete;
+
+	// Start splitting a new set of subresources. Fails when there are too many subresources, or when a single row of
+	// one of them is larger than the window.
+	bool Reset(const TextureFootprint::Subresource* pSubresources, uint32_t subresourceCount, uint64_t windowSize);
+
+	// Get the next band, returning false once every row of every subresource has been handed out.
+	bool Next(Band& outBand);
+
+	// Number of rows of a subresource that fit in the window starting at the given offset.
+	static uint32_t GetFittingRowCount(const TextureFootprint::Subresource& subresource, uint64_t windowOffset, uint64_t windowSize);
+
+
+private:
+
+	TextureFootprint::Subresource m_subresources[DF_UPLOAD_BAND_SPLITTER_MAX_SUBRESOURCE_COUNT];
+
+	uint64_t m_windowSize;
+	uint64_t m_windowUsed;
+
+	uint32_t m_subresourceCount;
+	uint32_t m_subresource;
+	uint32_t m_row;
+	uint32_t m_submission;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::UploadBandSplitter::GetFittingRowCount(
+	const TextureFootprint::Subresource& subresource,
+	const uint64_t windowOffset,
+	const uint64_t windowSize)
+{
+	if(subresource.rowPitch == 0 || windowOffset > windowSize || windowSize - windowOffset < subresource.rowSize)
+	{
+		return 0;
+	}
+
+	// Like the full footprint, the last row of a band only takes up the row size rather than the whole pitch.
+	const uint64_t rowCount = 1 + ((windowSize - windowOffset - subresource.rowSize) / subresource.rowPitch);
+
+	return (rowCount < subresource.rowCount) ? uint32_t(rowCount) : subresource.rowCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,254 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "VirtualPageTable.hpp"
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the slot table using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::Utility::VirtualPageTable::SlotTable
+{
+	// Slot of every page of every mip, laid out the same way as the indirection entries.
+	std::vector<SlotIndex> slots;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualPageTable::VirtualPageTable()
+	: m_pSlots(new SlotTable())
+	, m_pageCountX()
+	, m_pageCountY()
+	, m_mipOffsets()
+	, m_mipCount(0)
+	, m_pageSize(0)
+	, m_mappedCount(0)
+	, m_dirty(false)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualPageTable::~VirtualPageTable()
+{
+	if(m_pSlots)
+	{
+		delete m_pSlots;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualPageTable::Reset(
+	const uint32_t width,
+	const uint32_t height,
+	const uint32_t pageSize,
+	const uint32_t mipCount)
+{
+	m_pSlots->slots.clear();
+	m_mipCount = 0;
+	m_pageSize = 0;
+	m_mappedCount = 0;
+	m_dirty = true;
+
+	if(width == 0 || height == 0 || pageSize == 0 || mipCount == 0 || mipCount > DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT)
+	{
+		return false;
+	}
+
+	// The page coordinates of the most detailed mip have to fit in a page ID.
+	if(GetPageCount(width, 0, pageSize) > PageIdCoordMask + 1 || GetPageCount(height, 0, pageSize) > PageIdCoordMask + 1)
+	{
+		return false;
+	}
+
+	size_t offset = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		m_pageCountX[mipIndex] = GetPageCount(width, mipIndex, pageSize);
+		m_pageCountY[mipIndex] = GetPageCount(height, mipIndex, pageSize);
+		m_mipOffsets[mipIndex] = offset;
+
+		offset += size_t(m_pageCountX[mipIndex]) * size_t(m_pageCountY[mipIndex]);
+	}
+
+	m_mipOffsets[mipCount] = offset;
+	m_mipCount = mipCount;
+	m_pageSize = pageSize;
+
+	m_pSlots->slots.assign(offset, InvalidSlot);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualPageTable::Map(const PageId pageId, const SlotIndex slot)
+{
+	if(!IsValidPage(pageId) || slot == InvalidSlot)
+	{
+		return false;
+	}
+
+	const uint32_t mipIndex = GetPageMip(pageId);
+
+	SlotIndex& entry = m_pSlots->slots[m_mipOffsets[mipIndex] + (size_t(GetPageY(pageId)) * m_pageCountX[mipIndex]) + GetPageX(pageId)];
+
+	if(entry == InvalidSlot)
+	{
+		++m_mappedCount;
+	}
+
+	entry = slot;
+	m_dirty = true;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualPageTable::Unmap(const PageId pageId)
+{
+	if(!IsValidPage(pageId))
+	{
+		return false;
+	}
+
+	const uint32_t mipIndex = GetPageMip(pageId);
+
+	SlotIndex& entry = m_pSlots->slots[m_mipOffsets[mipIndex] + (size_t(GetPageY(pageId)) * m_pageCountX[mipIndex]) + GetPageX(pageId)];
+
+	if(entry == InvalidSlot)
+	{
+		return false;
+	}
+
+	entry = InvalidSlot;
+
+	--m_mappedCount;
+	m_dirty = true;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualPageTable::SlotIndex DemoFramework::Utility::VirtualPageTable::GetSlot(const PageId pageId) const
+{
+	if(!IsValidPage(pageId))
+	{
+		return InvalidSlot;
+	}
+
+	const uint32_t mipIndex = GetPageMip(pageId);
+
+	return m_pSlots->slots[m_mipOffsets[mipIndex] + (size_t(GetPageY(pageId)) * m_pageCountX[mipIndex]) + GetPageX(pageId)];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualPageTable::IsValidPage(const PageId pageId) const
+{
+	const uint32_t mipIndex = GetPageMip(pageId);
+
+	return mipIndex < m_mipCount
+		&& GetPageX(pageId) < m_pageCountX[mipIndex]
+		&& GetPageY(pageId) < m_pageCountY[mipIndex];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualPageTable::PageId DemoFramework::Utility::VirtualPageTable::GetParentPageId(const PageId pageId) const
+{
+	const uint32_t parentMip = GetPageMip(pageId) + 1;
+
+	if(!IsValidPage(pageId) || parentMip >= m_mipCount)
+	{
+		return InvalidPageId;
+	}
+
+	// Mips that aren't a whole number of pages in size can have one more page along an axis than twice the number of
+	// pages in the next mip, so the last page is clamped to the edge.
+	const uint32_t parentX = GetPageX(pageId) >> 1;
+	const uint32_t parentY = GetPageY(pageId) >> 1;
+
+	return MakePageId(
+		parentMip,
+		(parentX < m_pageCountX[parentMip]) ? parentX : (m_pageCountX[parentMip] - 1),
+		(parentY < m_pageCountY[parentMip]) ? parentY : (m_pageCountY[parentMip] - 1));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::VirtualPageTable::BuildIndirection(const uint32_t slotCountX, uint32_t* const pOutEntries)
+{
+	if(!pOutEntries || slotCountX == 0 || m_mipCount == 0)
+	{
+		return;
+	}
+
+	const std::vector<SlotIndex>& slots = m_pSlots->slots;
+
+	// Work up from the least detailed mip so every unmapped page can take the entry its parent already resolved.
+	for(uint32_t mipIndex = m_mipCount; mipIndex > 0; --mipIndex)
+	{
+		const uint32_t currentMip = mipIndex - 1;
+		const uint32_t pageCountX = m_pageCountX[currentMip];
+		const uint32_t pageCountY = m_pageCountY[currentMip];
+
+		const SlotIndex* const pSlots = slots.data() + m_mipOffsets[currentMip];
+		uint32_t* const pEntries = pOutEntries + m_mipOffsets[currentMip];
+
+		const bool hasParent = (mipIndex < m_mipCount);
+
+		const uint32_t* const pParentEntries = hasParent ? (pOutEntries + m_mipOffsets[mipIndex]) : nullptr;
+		const uint32_t parentCountX = hasParent ? m_pageCountX[mipIndex] : 0;
+		const uint32_t parentCountY = hasParent ? m_pageCountY[mipIndex] : 0;
+
+		for(uint32_t y = 0; y < pageCountY; ++y)
+		{
+			const uint32_t parentY = hasParent ? (((y >> 1) < parentCountY) ? (y >> 1) : (parentCountY - 1)) : 0;
+
+			for(uint32_t x = 0; x < pageCountX; ++x)
+			{
+				const size_t index = (size_t(y) * pageCountX) + x;
+				const SlotIndex slot = pSlots[index];
+
+				if(slot != InvalidSlot)
+				{
+					pEntries[index] = MakeIndirectionEntry(slot, slotCountX, currentMip);
+				}
+				else if(hasParent)
+				{
+					const uint32_t parentX = ((x >> 1) < parentCountX) ? (x >> 1) : (parentCountX - 1);
+
+					pEntries[index] = pParentEntries[(size_t(parentY) * parentCountX) + parentX];
+				}
+				else
+				{
+					pEntries[index] = 0;
+				}
+			}
+		}
+	}
+
+	m_dirty = false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
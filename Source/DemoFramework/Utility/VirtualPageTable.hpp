@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../BuildSetup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT 15
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class VirtualPageTable;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Maps the pages of a virtual texture to slots in a physical page cache and builds the indirection data shaders use to
+// find them. Every mip level of the virtual texture is divided into square pages of the same size, so each mip has
+// half as many pages along each axis as the one above it (rounded up). A page is identified by its mip and its page
+// coordinates packed into a single 32-bit value, the same value the feedback pass writes out.
+//
+// The indirection data has one 32-bit entry per page of every mip, stored mip after mip with the pages of each mip in
+// row order. Page counts are rounded up on every mip, so they don't always halve from one mip to the next, which is
+// why the entries are meant to be read from a buffer rather than the mip chain of a texture. Each entry holds the slot
+// coordinates in bits [7:0] and [15:8], the mip of the mapped page in bits [23:16], and 255 in bits [31:24] (or 0 when
+// nothing is mapped). Pages that aren't mapped take the entry of their closest mapped ancestor, so sampling falls back
+// to a less detailed page rather than a hole.
+class DF_API DemoFramework::Utility::VirtualPageTable
+{
+public:
+
+	typedef uint32_t PageId;
+	typedef uint32_t SlotIndex;
+
+	static constexpr PageId InvalidPageId = UINT32_MAX;
+	static constexpr SlotIndex InvalidSlot = UINT32_MAX;
+
+	// Page ID layout: [31:28] mip, [27:14] page y, [13:0] page x.
+	static constexpr uint32_t PageIdMipShift = 28;
+	static constexpr uint32_t PageIdYShift = 14;
+	static constexpr uint32_t PageIdCoordMask = 0x3FFF;
+
+	// Indirection entries can only address this many slots along each axis.
+	static constexpr uint32_t MaxSlotCountPerAxis = 256;
+
+	VirtualPageTable();
+	VirtualPageTable(const VirtualPageTable&) = delete;
+	VirtualPageTable(VirtualPageTable&&) = delete;
+	~VirtualPageTable();
+
+	VirtualPageTable& operator =(const VirtualPageTable&) = delete;
+	VirtualPageTable& operator =(VirtualPageTable&&) = delete;
+
+	// Set up the table for a virtual texture of the given size, removing every mapping.
+	bool Reset(uint32_t width, uint32_t height, uint32_t pageSize, uint32_t mipCount);
+
+	// Map a page to a slot, replacing any slot it was already mapped to.
+	bool Map(PageId pageId, SlotIndex slot);
+	bool Unmap(PageId pageId);
+
+	SlotIndex GetSlot(PageId pageId) const;
+
+	bool IsValidPage(PageId pageId) const;
+
+	// Page of the next mip covering the given page, or an invalid page ID for pages of the last mip.
+	PageId GetParentPageId(PageId pageId) const;
+
+	// Fill in the indirection entries for every mip, with the entries of each mip starting at GetIndirectionOffset(). The
+	// physical page cache is assumed to be 'slotCountX' slots wide, with slot N at (N % slotCountX, N / slotCountX).
+	void BuildIndirection(uint32_t slotCountX, uint32_t* pOutEntries);
+
+	size_t GetIndirectionSize() const;
+	size_t GetIndirectionOffset(uint32_t mipIndex) const;
+
+	uint32_t GetPageCountX(uint32_t mipIndex) const;
+	uint32_t GetPageCountY(uint32_t mipIndex) const;
+	uint32_t GetMipCount() const;
+	uint32_t GetPageSize() const;
+	uint32_t GetMappedCount() const;
+
+	// Whether any mapping has changed since the indirection data was last built.
+	bool IsDirty() const;
+
+	static PageId MakePageId(uint32_t mipIndex, uint32_t x, uint32_t y);
+
+	static uint32_t GetPageMip(PageId pageId);
+	static uint32_t GetPageX(PageId pageId);
+	static uint32_t GetPageY(PageId pageId);
+
+	// Number of pages needed to cover one axis of a mip level.
+	static uint32_t GetPageCount(uint32_t size, uint32_t mipIndex, uint32_t pageSize);
+
+	static uint32_t MakeIndirectionEntry(SlotIndex slot, uint32_t slotCountX, uint32_t mipIndex);
+
+
+private:
+
+	struct SlotTable;
+
+	SlotTable* m_pSlots;
+
+	uint32_t m_pageCountX[DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT];
+	uint32_t m_pageCountY[DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT];
+	size_t m_mipOffsets[DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT + 1];
+
+	uint32_t m_mipCount;
+	uint32_t m_pageSize;
+	uint32_t m_mappedCount;
+
+	bool m_dirty;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::VirtualPageTable::GetIndirectionSize() const
+{
+	return m_mipOffsets[m_mipCount];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline size_t DemoFramework::Utility::VirtualPageTable::GetIndirectionOffset(const uint32_t mipIndex) const
+{
+	return (mipIndex < m_mipCount) ? m_mipOffsets[mipIndex] : m_mipOffsets[m_mipCount];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageCountX(const uint32_t mipIndex) const
+{
+	return (mipIndex < m_mipCount) ? m_pageCountX[mipIndex] : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageCountY(const uint32_t mipIndex) const
+{
+	return (mipIndex < m_mipCount) ? m_pageCountY[mipIndex] : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetMipCount() const
+{
+	return m_mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageSize() const
+{
+	return m_pageSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetMappedCount() const
+{
+	return m_mappedCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline bool DemoFramework::Utility::VirtualPageTable::IsDirty() const
+{
+	return m_dirty;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline DemoFramework::Utility::VirtualPageTable::PageId DemoFramework::Utility::VirtualPageTable::MakePageId(
+	const uint32_t mipIndex,
+	const uint32_t x,
+	const uint32_t y)
+{
+	return (mipIndex << PageIdMipShift) | ((y & PageIdCoordMask) << PageIdYShift) | (x & PageIdCoordMask);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageMip(const PageId pageId)
+{
+	return pageId >> PageIdMipShift;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageX(const PageId pageId)
+{
+	return pageId & PageIdCoordMask;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageY(const PageId pageId)
+{
+	return (pageId >> PageIdYShift) & PageIdCoordMask;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::GetPageCount(const uint32_t size, const uint32_t mipIndex, const uint32_t pageSize)
+{
+	const uint32_t mipSize = (mipIndex < 32) ? (size >> mipIndex) : 0;
+	return (((mipSize > 0) ? mipSize : 1) + pageSize - 1) / pageSize;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualPageTable::MakeIndirectionEntry(
+	const SlotIndex slot,
+	const uint32_t slotCountX,
+	const uint32_t mipIndex)
+{
+	return (slot % slotCountX) | ((slot / slotCountX) << 8) | (mipIndex << 16) | (0xFFu << 24);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "VirtualTextureFeedback.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Defining the page lists using PIMPL to make MSVC shut up about std::vector<> needing a DLL interface.
+struct DemoFramework::Utility::VirtualTextureFeedback::PageLists
+{
+	// Number of feedback texels seen for each page.
+	std::unordered_map<PageId, uint32_t> counts;
+
+	// Texel counts of the missing pages, including ancestors. Kept around to reuse its memory between frames.
+	std::unordered_map<PageId, uint32_t> missing;
+
+	std::vector<PageId> usedPages;
+	std::vector<Request> requests;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualTextureFeedback::VirtualTextureFeedback()
+	: m_pLists(new PageLists())
+	, m_texelCount(0)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualTextureFeedback::~VirtualTextureFeedback()
+{
+	if(m_pLists)
+	{
+		delete m_pLists;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::VirtualTextureFeedback::Clear()
+{
+	m_pLists->counts.clear();
+	m_pLists->missing.clear();
+	m_pLists->usedPages.clear();
+	m_pLists->requests.clear();
+
+	m_texelCount = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::VirtualTextureFeedback::Parse(
+	const uint32_t* const pTexels,
+	const uint32_t width,
+	const uint32_t height,
+	const size_t rowPitch,
+	const VirtualPageTable& pageTable)
+{
+	if(!pTexels || rowPitch < sizeof(uint32_t) * width)
+	{
+		return;
+	}
+
+	std::unordered_map<PageId, uint32_t>& counts = m_pLists->counts;
+
+	const uint8_t* const pRows = reinterpret_cast<const uint8_t*>(pTexels);
+
+	for(uint32_t y = 0; y < height; ++y)
+	{
+		const uint32_t* const pRow = reinterpret_cast<const uint32_t*>(pRows + (rowPitch * y));
+
+		uint32_t x = 0;
+
+		while(x < width)
+		{
+			const PageId pageId = pRow[x];
+
+			// Neighboring texels usually sample the same page, so count whole runs of them with a single lookup.
+			uint32_t runEnd = x + 1;
+			while(runEnd < width && pRow[runEnd] == pageId)
+			{
+				++runEnd;
+			}
+
+			if(pageId != VirtualPageTable::InvalidPageId && pageTable.IsValidPage(pageId))
+			{
+				counts[pageId] += runEnd - x;
+				m_texelCount += runEnd - x;
+			}
+
+			x = runEnd;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void DemoFramework::Utility::VirtualTextureFeedback::Resolve(const VirtualPageTable& pageTable)
+{
+	std::unordered_map<PageId, uint32_t>& counts = m_pLists->counts;
+	std::vector<PageId>& usedPages = m_pLists->usedPages;
+	std::vector<Request>& requests = m_pLists->requests;
+	std::unordered_map<PageId, uint32_t>& missing = m_pLists->missing;
+
+	usedPages.clear();
+	requests.clear();
+	missing.clear();
+
+	for(const auto& pair : counts)
+	{
+		PageId pageId = pair.first;
+
+		// Walk up from each page until reaching one that's resident, requesting every missing page along the way.
+		while(pageId != VirtualPageTable::InvalidPageId)
+		{
+			if(pageTable.GetSlot(pageId) != VirtualPageTable::InvalidSlot)
+			{
+				usedPages.push_back(pageId);
+				break;
+			}
+
+			missing[pageId] += pair.second;
+
+			pageId = pageTable.GetParentPageId(pageId);
+		}
+	}
+
+	// Pages reached from more than one descendant were added more than once.
+	std::sort(usedPages.begin(), usedPages.end());
+	usedPages.erase(std::unique(usedPages.begin(), usedPages.end()), usedPages.end());
+
+	requests.reserve(missing.size());
+
+	for(const auto& pair : missing)
+	{
+		const Request request =
+		{
+			pair.first,  // PageId pageId
+			pair.second, // uint32_t texelCount
+		};
+
+		requests.push_back(request);
+	}
+
+	std::sort(
+		requests.begin(),
+		requests.end(),
+		[](const Request& left, const Request& right)
+		{
+			const uint32_t leftMip = VirtualPageTable::GetPageMip(left.pageId);
+			const uint32_t rightMip = VirtualPageTable::GetPageMip(right.pageId);
+
+			if(leftMip != rightMip)
+			{
+				return leftMip > rightMip;
+			}
+
+			if(left.texelCount != right.texelCount)
+			{
+				return left.texelCount > right.texelCount;
+			}
+
+			return left.pageId < right.pageId;
+		});
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::Utility::VirtualTextureFeedback::PageId* DemoFramework::Utility::VirtualTextureFeedback::GetUsedPages() const
+{
+	return m_pLists->usedPages.data();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::VirtualTextureFeedback::GetUsedPageCount() const
+{
+	return m_pLists->usedPages.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const DemoFramework::Utility::VirtualTextureFeedback::Request* DemoFramework::Utility::VirtualTextureFeedback::GetRequests() const
+{
+	return m_pLists->requests.data();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+size_t DemoFramework::Utility::VirtualTextureFeedback::GetRequestCount() const
+{
+	return m_pLists->requests.size();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "VirtualPageTable.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class VirtualTextureFeedback;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Turns the feedback buffer written while rendering with a virtual texture into a list of pages to load. Each texel of
+// the feedback buffer holds the ID of the page that was sampled there (or an invalid page ID where nothing was). The
+// pages that were seen are split into the ones already resident, which the cache should mark as used, and the missing
+// ones, which become load requests. Every missing ancestor of a requested page is requested as well, and resident
+// ancestors of missing pages count as used since sampling falls back to them.
+//
+// Requests are ordered from the least detailed mip to the most detailed one, so the pages that cover the most screen
+// area arrive first and sampling never has to fall back across more than a few mips. Within a mip, pages seen by more
+// texels come first, and ties are broken by page ID so the order only depends on the feedback.
+class DF_API DemoFramework::Utility::VirtualTextureFeedback
+{
+public:
+
+	typedef VirtualPageTable::PageId PageId;
+
+	struct Request
+	{
+		PageId pageId;
+		uint32_t texelCount; // Feedback texels that asked for the page or one of its descendants
+	};
+
+	VirtualTextureFeedback();
+	VirtualTextureFeedback(const VirtualTextureFeedback&) = delete;
+	VirtualTextureFeedback(VirtualTextureFeedback&&) = delete;
+	~VirtualTextureFeedback();
+
+	VirtualTextureFeedback& operator =(const VirtualTextureFeedback&) = delete;
+	VirtualTextureFeedback& operator =(VirtualTextureFeedback&&) = delete;
+
+	// Forget every page seen so far.
+	void Clear();
+
+	// Count the pages in a feedback buffer. This can be called more than once before resolving, e.g. once per view.
+	// Page IDs that don't belong to the page table are ignored.
+	void Parse(const uint32_t* pTexels, uint32_t width, uint32_t height, size_t rowPitch, const VirtualPageTable& pageTable);
+
+	// Split the pages seen since the last Clear() into used and requested pages.
+	void Resolve(const VirtualPageTable& pageTable);
+
+	const PageId* GetUsedPages() const;
+	size_t GetUsedPageCount() const;
+
+	const Request* GetRequests() const;
+	size_t GetRequestCount() const;
+
+	// Feedback texels parsed since the last Clear() that held a valid page ID.
+	uint64_t GetTexelCount() const;
+
+
+private:
+
+	struct PageLists;
+
+	PageLists* m_pLists;
+
+	uint64_t m_texelCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::VirtualTextureFeedback::GetTexelCount() const
+{
+	return m_texelCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,302 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "VirtualTextureFile.hpp"
+
+#include "Math.hpp"
+#include "TextureFootprint.hpp"
+
+#include "../Application/Log.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_VIRTUAL_TEXTURE_FILE_MAGIC   0x58545644ul // "DVTX"
+#define DF_VIRTUAL_TEXTURE_FILE_VERSION 1
+
+// Page data starts on a boundary of the system page size so every tile copy reads from aligned memory.
+#define DF_VIRTUAL_TEXTURE_FILE_DATA_ALIGNMENT 4096
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct VirtualTextureFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	DemoFramework::Utility::VirtualTextureFile::Desc desc;
+
+	uint32_t pageCount;
+
+	uint64_t dataOffset;
+	uint64_t dataSize;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static inline int64_t ClampInt64(const int64_t value, const int64_t minValue, const int64_t maxValue)
+{
+	return (value < minValue) ? minValue : ((value > maxValue) ? maxValue : value);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualTextureFile::VirtualTextureFile()
+	: m_file()
+	, m_desc()
+	, m_pPageData(nullptr)
+	, m_mipPageOffsets()
+	, m_pageCountX()
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DemoFramework::Utility::VirtualTextureFile::Ptr DemoFramework::Utility::VirtualTextureFile::Open(const char* const filePath)
+{
+	if(!filePath || filePath[0] == '\0')
+	{
+		LOG_ERROR("Invalid parameter");
+		return Ptr();
+	}
+
+	MappedFile::Ptr file = MappedFile::Open(filePath);
+	if(!file)
+	{
+		LOG_ERROR("Failed to open virtual texture file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	if(file->GetSize() < sizeof(VirtualTextureFileHeader))
+	{
+		LOG_ERROR("Virtual texture file is too small: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	VirtualTextureFileHeader header;
+	memcpy(&header, file->GetData(), sizeof(header));
+
+	Ptr output = std::make_shared<VirtualTextureFile>();
+
+	output->m_desc = header.desc;
+
+	if(header.magic != DF_VIRTUAL_TEXTURE_FILE_MAGIC
+		|| header.version != DF_VIRTUAL_TEXTURE_FILE_VERSION
+		|| !_validateDesc(header.desc))
+	{
+		LOG_ERROR("Invalid virtual texture file: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	uint32_t pageCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < header.desc.mipCount; ++mipIndex)
+	{
+		output->m_pageCountX[mipIndex] = VirtualPageTable::GetPageCount(header.desc.width, mipIndex, header.desc.pageSize);
+		output->m_mipPageOffsets[mipIndex] = pageCount;
+
+		pageCount += output->m_pageCountX[mipIndex] * VirtualPageTable::GetPageCount(header.desc.height, mipIndex, header.desc.pageSize);
+	}
+
+	output->m_mipPageOffsets[header.desc.mipCount] = pageCount;
+
+	// Reject files that were truncated while being written.
+	if(header.pageCount != pageCount
+		|| header.dataSize != uint64_t(pageCount) * output->GetTileByteSize()
+		|| header.dataOffset < sizeof(VirtualTextureFileHeader)
+		|| header.dataOffset + header.dataSize > file->GetSize())
+	{
+		LOG_ERROR("Virtual texture file is incomplete: path=\"%s\"", filePath);
+		return Ptr();
+	}
+
+	output->m_pPageData = file->GetData() + header.dataOffset;
+	output->m_file = file;
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualTextureFile::Write(
+	const char* const filePath,
+	const Desc& desc,
+	const ImageResampler::ConstImage* const pMips)
+{
+	if(!filePath || filePath[0] == '\0' || !pMips || !_validateDesc(desc))
+	{
+		LOG_ERROR("Invalid parameter");
+		return false;
+	}
+
+	for(uint32_t mipIndex = 0; mipIndex < desc.mipCount; ++mipIndex)
+	{
+		const ImageResampler::ConstImage& mip = pMips[mipIndex];
+
+		if(!mip.pData
+			|| mip.width != TextureFootprint::GetMipDimension(desc.width, mipIndex)
+			|| mip.height != TextureFootprint::GetMipDimension(desc.height, mipIndex)
+			|| mip.rowPitch < size_t(mip.width) * desc.texelSize)
+		{
+			LOG_ERROR("Invalid virtual texture mip image: mip=%" PRIu32, mipIndex);
+			return false;
+		}
+	}
+
+	const uint32_t tileSize = desc.pageSize + (desc.borderSize * 2);
+	const size_t texelSize = size_t(desc.texelSize);
+	const size_t tileRowSize = size_t(tileSize) * texelSize;
+
+	uint32_t pageCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < desc.mipCount; ++mipIndex)
+	{
+		pageCount += VirtualPageTable::GetPageCount(desc.width, mipIndex, desc.pageSize)
+			* VirtualPageTable::GetPageCount(desc.height, mipIndex, desc.pageSize);
+	}
+
+	VirtualTextureFileHeader header;
+	memset(&header, 0, sizeof(header));
+
+	header.magic = DF_VIRTUAL_TEXTURE_FILE_MAGIC;
+	header.version = DF_VIRTUAL_TEXTURE_FILE_VERSION;
+	header.desc = desc;
+	header.pageCount = pageCount;
+	header.dataOffset = Math::GetAlignedSize(uint64_t(sizeof(header)), uint64_t(DF_VIRTUAL_TEXTURE_FILE_DATA_ALIGNMENT));
+	header.dataSize = uint64_t(pageCount) * uint64_t(tileRowSize) * uint64_t(tileSize);
+
+	FILE* const pFile = fopen(filePath, "wb");
+	if(!pFile)
+	{
+		LOG_ERROR("Failed to open virtual texture file for writing: path=\"%s\"", filePath);
+		return false;
+	}
+
+	std::vector<uint8_t> tile(tileRowSize * tileSize, 0);
+
+	bool result = (fwrite(&header, sizeof(header), 1, pFile) == 1)
+		&& (fwrite(tile.data(), 1, size_t(header.dataOffset - sizeof(header)), pFile) == size_t(header.dataOffset - sizeof(header)));
+
+	for(uint32_t mipIndex = 0; result && mipIndex < desc.mipCount; ++mipIndex)
+	{
+		const ImageResampler::ConstImage& mip = pMips[mipIndex];
+
+		const uint32_t pageCountX = VirtualPageTable::GetPageCount(desc.width, mipIndex, desc.pageSize);
+		const uint32_t pageCountY = VirtualPageTable::GetPageCount(desc.height, mipIndex, desc.pageSize);
+
+		for(uint32_t pageY = 0; result && pageY < pageCountY; ++pageY)
+		{
+			for(uint32_t pageX = 0; result && pageX < pageCountX; ++pageX)
+			{
+				const int64_t originX = int64_t(pageX) * desc.pageSize - desc.borderSize;
+				const int64_t originY = int64_t(pageY) * desc.pageSize - desc.borderSize;
+
+				// Texels of the tile that fall inside the mip horizontally can be copied as a single run; the rest are
+				// clamped to the edge of the mip one texel at a time.
+				const int64_t runBegin = ClampInt64(-originX, 0, tileSize);
+				const int64_t runEnd = ClampInt64(int64_t(mip.width) - originX, runBegin, tileSize);
+
+				for(uint32_t tileY = 0; tileY < tileSize; ++tileY)
+				{
+					const int64_t sourceY = ClampInt64(originY + tileY, 0, int64_t(mip.height) - 1);
+
+					const uint8_t* const pSourceRow = mip.pData + (mip.rowPitch * size_t(sourceY));
+					uint8_t* const pTileRow = tile.data() + (tileRowSize * tileY);
+
+					for(int64_t tileX = 0; tileX < runBegin; ++tileX)
+					{
+						memcpy(pTileRow + (size_t(tileX) * texelSize), pSourceRow, texelSize);
+					}
+
+					if(runEnd > runBegin)
+					{
+						memcpy(
+							pTileRow + (size_t(runBegin) * texelSize),
+							pSourceRow + (size_t(originX + runBegin) * texelSize),
+							size_t(runEnd - runBegin) * texelSize);
+					}
+
+					for(int64_t tileX = runEnd; tileX < tileSize; ++tileX)
+					{
+						memcpy(pTileRow + (size_t(tileX) * texelSize), pSourceRow + (size_t(mip.width - 1) * texelSize), texelSize);
+					}
+				}
+
+				result = (fwrite(tile.data(), 1, tile.size(), pFile) == tile.size());
+			}
+		}
+	}
+
+	fclose(pFile);
+
+	if(!result)
+	{
+		LOG_ERROR("Failed to write virtual texture file: path=\"%s\"", filePath);
+
+		// Don't leave a partial file behind.
+		remove(filePath);
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const uint8_t* DemoFramework::Utility::VirtualTextureFile::GetPageData(const VirtualPageTable::PageId pageId) const
+{
+	const uint32_t mipIndex = VirtualPageTable::GetPageMip(pageId);
+
+	if(!m_pPageData || mipIndex >= m_desc.mipCount)
+	{
+		return nullptr;
+	}
+
+	const uint32_t pageX = VirtualPageTable::GetPageX(pageId);
+	const uint32_t pageY = VirtualPageTable::GetPageY(pageId);
+
+	const uint32_t pageCountX = m_pageCountX[mipIndex];
+	const uint32_t pageIndex = m_mipPageOffsets[mipIndex] + (pageY * pageCountX) + pageX;
+
+	if(pageX >= pageCountX || pageIndex >= m_mipPageOffsets[mipIndex + 1])
+	{
+		return nullptr;
+	}
+
+	return m_pPageData + (uint64_t(pageIndex) * GetTileByteSize());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool DemoFramework::Utility::VirtualTextureFile::_validateDesc(const Desc& desc)
+{
+	// Page IDs only have room for so many pages along each axis, and the texture itself can't have more mips than a
+	// full mip chain.
+	return desc.texelSize > 0
+		&& desc.width > 0
+		&& desc.height > 0
+		&& desc.pageSize > 0
+		&& desc.mipCount > 0
+		&& desc.mipCount <= DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT
+		&& desc.mipCount <= TextureFootprint::GetMaxMipCount(desc.width, desc.height)
+		&& VirtualPageTable::GetPageCount(desc.width, 0, desc.pageSize) <= VirtualPageTable::PageIdCoordMask + 1
+		&& VirtualPageTable::GetPageCount(desc.height, 0, desc.pageSize) <= VirtualPageTable::PageIdCoordMask + 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ImageResampler.hpp"
+#include "MappedFile.hpp"
+#include "VirtualPageTable.hpp"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_VIRTUAL_TEXTURE_FILE_EXTENSION ".dfvt"
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class VirtualTextureFile;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Tiled on-disk layout of a virtual texture. The file holds a small header followed by every page of every mip, most
+// detailed mip first and row by row within each mip, matching the page layout of a VirtualPageTable. Each page is
+// stored as a tile including a border of texels copied from the neighboring pages (clamped at the edges of the
+// texture), so pages can be filtered bilinearly wherever they end up in the physical cache. Every tile is the same
+// size, so the location of a page is computed rather than looked up, and the file is mapped so loading a page is a
+// single copy straight out of the mapping.
+class DF_API DemoFramework::Utility::VirtualTextureFile
+{
+public:
+
+	typedef std::shared_ptr<VirtualTextureFile> Ptr;
+
+	struct Desc
+	{
+		uint32_t format;     // DXGI_FORMAT of the texels; block-compressed formats aren't supported
+		uint32_t texelSize;  // Bytes per texel
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipCount;
+		uint32_t pageSize;   // Texels along each side of a page, not counting the border
+		uint32_t borderSize; // Texels of the neighboring pages repeated around each side of a page
+	};
+
+	VirtualTextureFile();
+	VirtualTextureFile(const VirtualTextureFile&) = delete;
+	VirtualTextureFile(VirtualTextureFile&&) = delete;
+
+	VirtualTextureFile& operator =(const VirtualTextureFile&) = delete;
+	VirtualTextureFile& operator =(VirtualTextureFile&&) = delete;
+
+	static Ptr Open(const char* filePath);
+
+	// Write a virtual texture file from a full mip chain held in memory, with the image of each mip in 'pMips'.
+	static bool Write(const char* filePath, const Desc& desc, const ImageResampler::ConstImage* pMips);
+
+	// Get the tile of a page, stored as GetTileSize() rows of GetTileSize() texels with no padding in between.
+	const uint8_t* GetPageData(VirtualPageTable::PageId pageId) const;
+
+	const Desc& GetDesc() const;
+
+	uint32_t GetTileSize() const;
+	uint64_t GetTileByteSize() const;
+	uint32_t GetPageCount() const;
+
+
+private:
+
+	static bool _validateDesc(const Desc&);
+
+	MappedFile::Ptr m_file;
+
+	Desc m_desc;
+
+	const uint8_t* m_pPageData;
+
+	uint32_t m_mipPageOffsets[DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT + 1];
+	uint32_t m_pageCountX[DF_VIRTUAL_PAGE_TABLE_MAX_MIP_COUNT];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+template class DF_API std::shared_ptr<DemoFramework::Utility::VirtualTextureFile>;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline const DemoFramework::Utility::VirtualTextureFile::Desc& DemoFramework::Utility::VirtualTextureFile::GetDesc() const
+{
+	return m_desc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualTextureFile::GetTileSize() const
+{
+	return m_desc.pageSize + (m_desc.borderSize * 2);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t DemoFramework::Utility::VirtualTextureFile::GetTileByteSize() const
+{
+	return uint64_t(GetTileSize()) * uint64_t(GetTileSize()) * uint64_t(m_desc.texelSize);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t DemoFramework::Utility::VirtualTextureFile::GetPageCount() const
+{
+	return m_mipPageOffsets[m_desc.mipCount];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/BlockCompressor.hpp>
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::BlockCompressor BlockCompressor;
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t BenchmarkEdgeLength = 1024;
+static constexpr uint32_t BenchmarkIterationCount = 2;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkFormat
+{
+	BlockCompressor::Format format;
+	const char* name;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Smooth gradients and soft-edged shapes with a little noise on top, which is closer to real texture content than
+// pure noise and gives PSNR numbers that mean something. HDR sources get the same pattern scaled up to 16.
+static void FillSourceImage(const ImageResampler::Format format, std::vector<uint8_t>& outData)
+{
+	const size_t texelSize = ImageResampler::GetTexelSize(format);
+	const uint32_t channelCount = ImageResampler::GetChannelCount(format);
+
+	outData.resize(size_t(BenchmarkEdgeLength) * BenchmarkEdgeLength * texelSize);
+
+	Test::Random random(33);
+
+	for(uint32_t y = 0; y < BenchmarkEdgeLength; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkEdgeLength; ++x)
+		{
+			const float u = float(x) / float(BenchmarkEdgeLength);
+			const float v = float(y) / float(BenchmarkEdgeLength);
+
+			const float values[4] =
+			{
+				0.5f + (0.5f * sinf(u * 9.0f + v * 3.0f)),
+				0.5f + (0.5f * cosf(v * 7.0f - u * 2.0f)),
+				(((x / 64) + (y / 64)) % 2 == 0) ? 0.8f : 0.2f,
+				u,
+			};
+
+			const size_t texelIndex = (size_t(y) * BenchmarkEdgeLength) + x;
+
+			for(uint32_t channel = 0; channel < channelCount; ++channel)
+			{
+				const float noise = (float(random.Next(0, 1000)) / 1000.0f - 0.5f) * 0.02f;
+				const float value = fminf(fmaxf(values[channel] + noise, 0.0f), 1.0f);
+
+				if(format == ImageResampler::Format::RGBA32Float)
+				{
+					reinterpret_cast<float*>(outData.data())[(texelIndex * 4) + channel] = value * 16.0f;
+				}
+				else
+				{
+					outData[(texelIndex * channelCount) + channel] = uint8_t(value * 255.0f + 0.5f);
+				}
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Encode throughput, PSNR and size reduction for every format and quality preset. Throughput counts the bytes of
+// source texels encoded.
+DF_TEST_CASE(BlockCompressor_Compress)
+{
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf("    avx2=%d, workers=%" PRIu32 "\n", CpuFeatures::HasAvx2() ? 1 : 0, pSharedPool->GetWorkerCount());
+
+	const BenchmarkFormat formats[] =
+	{
+		{ BlockCompressor::Format::BC1,  "BC1"  },
+		{ BlockCompressor::Format::BC3,  "BC3"  },
+		{ BlockCompressor::Format::BC4,  "BC4"  },
+		{ BlockCompressor::Format::BC5,  "BC5"  },
+		{ BlockCompressor::Format::BC6H, "BC6H" },
+		{ BlockCompressor::Format::BC7,  "BC7"  },
+	};
+
+	const uint32_t blockCount = BenchmarkEdgeLength / 4;
+
+	for(const BenchmarkFormat& format : formats)
+	{
+		const ImageResampler::Format sourceFormat = BlockCompressor::GetSourceFormat(format.format);
+		const size_t dstRowPitch = size_t(blockCount) * BlockCompressor::GetBlockSize(format.format);
+
+		std::vector<uint8_t> source;
+		FillSourceImage(sourceFormat, source);
+
+		std::vector<uint8_t> compressed(dstRowPitch * blockCount);
+
+		const ImageResampler::ConstImage src =
+		{
+			source.data(),
+			size_t(BenchmarkEdgeLength) * ImageResampler::GetTexelSize(sourceFormat),
+			BenchmarkEdgeLength,
+			BenchmarkEdgeLength,
+		};
+
+		double psnr[2] = {};
+
+		for(const BlockCompressor::Quality quality : { BlockCompressor::Quality::Fast, BlockCompressor::Quality::Quality })
+		{
+			const bool isFast = (quality == BlockCompressor::Quality::Fast);
+
+			char name[64];
+			snprintf(name, sizeof(name), "%s %s", format.name, isFast ? "fast" : "quality");
+
+			Test::RunBenchmarkVariants(name, BenchmarkIterationCount, source.size(), [&](ThreadPool* const pThreadPool)
+			{
+				BlockCompressor::Stats stats = {};
+
+				DF_CHECK(BlockCompressor::Compress(src, format.format, quality, compressed.data(), dstRowPitch, pThreadPool, &stats));
+
+				psnr[isFast ? 0 : 1] = stats.GetPsnr(format.format);
+			});
+		}
+
+		printf(
+			"    %s psnr: fast=%.2f dB, quality=%.2f dB; size: %zu KB -> %zu KB\n",
+			format.name,
+			psnr[0],
+			psnr[1],
+			source.size() / 1024,
+			compressed.size() / 1024);
+
+		// The quality preset only ever adds to what the fast one does.
+		DF_CHECK(psnr[1] >= psnr[0] - 0.01);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
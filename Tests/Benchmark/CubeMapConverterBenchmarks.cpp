@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/CubeMapConverter.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::CubeMapConverter CubeMapConverter;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Same size as the 2k equirect environment maps the samples load.
+static constexpr uint32_t BenchmarkEquirectWidth = 2048;
+static constexpr uint32_t BenchmarkEquirectHeight = 1024;
+static constexpr uint32_t BenchmarkIterationCount = 2;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetMipCount(const uint32_t edgeLength)
+{
+	uint32_t mipCount = 1;
+
+	while((edgeLength >> mipCount) > 0)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Full conversion, mips included, at the cube sizes of each EnvMapQuality and one below them.
+DF_TEST_CASE(CubeMapConverter_Convert)
+{
+	std::vector<float> equirectTexels(size_t(BenchmarkEquirectWidth) * BenchmarkEquirectHeight * 4);
+
+	for(uint32_t y = 0; y < BenchmarkEquirectHeight; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkEquirectWidth; ++x)
+		{
+			float* const pTexel = equirectTexels.data() + (((size_t(y) * BenchmarkEquirectWidth) + x) * 4);
+
+			pTexel[0] = 0.5f + 0.5f * sinf(float(x) * 0.013f);
+			pTexel[1] = 0.5f + 0.5f * cosf(float(y) * 0.021f);
+			pTexel[2] = float((x ^ y) & 0xFF) / 64.0f;
+			pTexel[3] = 1.0f;
+		}
+	}
+
+	const ImageResampler::ConstImage equirect =
+	{
+		reinterpret_cast<const uint8_t*>(equirectTexels.data()),
+		size_t(BenchmarkEquirectWidth) * sizeof(float) * 4,
+		BenchmarkEquirectWidth,
+		BenchmarkEquirectHeight,
+	};
+
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf("    avx2=%d, workers=%" PRIu32 "\n", CpuFeatures::HasAvx2() ? 1 : 0, pSharedPool->GetWorkerCount());
+
+	for(const uint32_t edgeLength : { 256u, 512u, 1024u, 2048u })
+	{
+		const uint32_t mipCount = GetMipCount(edgeLength);
+
+		std::vector<std::vector<float>> faceData(size_t(mipCount) * DF_CUBE_MAP_FACE_COUNT);
+		std::vector<ImageResampler::Image> faces(size_t(mipCount) * DF_CUBE_MAP_FACE_COUNT);
+
+		size_t cubeSize = 0;
+
+		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+		{
+			for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+			{
+				const size_t imageIndex = (faceIndex * mipCount) + mipIndex;
+				const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+				faceData[imageIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * 4);
+				faces[imageIndex] =
+				{
+					reinterpret_cast<uint8_t*>(faceData[imageIndex].data()),
+					size_t(mipEdgeLength) * sizeof(float) * 4,
+					mipEdgeLength,
+					mipEdgeLength,
+				};
+
+				cubeSize += faceData[imageIndex].size() * sizeof(float);
+			}
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "Cube %" PRIu32, edgeLength);
+
+		Test::RunBenchmarkVariants(name, BenchmarkIterationCount, cubeSize, [&](ThreadPool* const pThreadPool)
+		{
+			DF_CHECK(CubeMapConverter::Convert(equirect, faces.data(), edgeLength, mipCount, pThreadPool));
+		});
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
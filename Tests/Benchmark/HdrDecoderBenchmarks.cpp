@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/HdrDecoder.hpp>
+#include <DemoFramework/Utility/PixelConvert.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <stb_image.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::HdrDecoder HdrDecoder;
+typedef Utility::PixelConvert PixelConvert;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Same size as the 2k equirect environment maps the samples load.
+static constexpr uint32_t BenchmarkWidth = 2048;
+static constexpr uint32_t BenchmarkHeight = 1024;
+static constexpr uint32_t BenchmarkIterationCount = 8;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Append one channel of a scanline using the per-channel run length encoding: runs of 3 or more equal bytes are
+// written as a run, everything else as literals.
+static void EncodeChannel(const uint8_t* const pValues, const uint32_t count, std::vector<uint8_t>& outData)
+{
+	uint32_t index = 0;
+
+	while(index < count)
+	{
+		uint32_t runLength = 1;
+
+		while(index + runLength < count && runLength < 127 && pValues[index + runLength] == pValues[index])
+		{
+			++runLength;
+		}
+
+		if(runLength >= 3)
+		{
+			outData.push_back(uint8_t(128 + runLength));
+			outData.push_back(pValues[index]);
+
+			index += runLength;
+			continue;
+		}
+
+		// Gather literals up to the next run of 3.
+		uint32_t literalCount = 0;
+
+		while(index + literalCount < count && literalCount < 128)
+		{
+			const uint32_t next = index + literalCount;
+
+			if(next + 2 < count && pValues[next] == pValues[next + 1] && pValues[next] == pValues[next + 2])
+			{
+				break;
+			}
+
+			++literalCount;
+		}
+
+		outData.push_back(uint8_t(literalCount));
+		outData.insert(outData.end(), pValues + index, pValues + index + literalCount);
+
+		index += literalCount;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Build an RLE-encoded .hdr file of a sky-like gradient with a bright sun, which gives runs of equal exponents the
+// way real environment maps do.
+static void MakeHdrFile(std::vector<uint8_t>& outData)
+{
+	char header[128];
+	const int headerLength = snprintf(
+		header,
+		sizeof(header),
+		"#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %" PRIu32 " +X %" PRIu32 "\n",
+		BenchmarkHeight,
+		BenchmarkWidth);
+
+	outData.assign(header, header + headerLength);
+
+	std::vector<uint8_t> channels[4];
+
+	for(std::vector<uint8_t>& channel : channels)
+	{
+		channel.resize(BenchmarkWidth);
+	}
+
+	Test::Random random(36);
+
+	for(uint32_t y = 0; y < BenchmarkHeight; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkWidth; ++x)
+		{
+			const float u = float(x) / float(BenchmarkWidth);
+			const float v = float(y) / float(BenchmarkHeight);
+
+			const float sunDistance = sqrtf(((u - 0.3f) * (u - 0.3f)) + ((v - 0.25f) * (v - 0.25f)));
+			const float sun = (sunDistance < 0.01f) ? 5000.0f : 0.0f;
+			const float noise = float(random.Next(0, 1000)) / 100000.0f;
+
+			const float rgb[3] =
+			{
+				(0.4f * (1.0f - v)) + sun + noise,
+				(0.6f * (1.0f - v)) + sun + noise,
+				(1.2f * (1.0f - v)) + sun + noise,
+			};
+
+			uint8_t rgbe[4];
+			PixelConvert::FloatToRgbe(rgb, rgbe);
+
+			for(uint32_t channel = 0; channel < 4; ++channel)
+			{
+				channels[channel][x] = rgbe[channel];
+			}
+		}
+
+		outData.push_back(2);
+		outData.push_back(2);
+		outData.push_back(uint8_t(BenchmarkWidth >> 8));
+		outData.push_back(uint8_t(BenchmarkWidth & 0xFF));
+
+		for(const std::vector<uint8_t>& channel : channels)
+		{
+			EncodeChannel(channel.data(), BenchmarkWidth, outData);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Decode time for each output format against stb_image decoding the same file to RGBA32 float, and the memory the
+// decoded image takes compared to that expansion. Throughput counts the bytes of the encoded file.
+DF_TEST_CASE(HdrDecoder_Decode)
+{
+	std::vector<uint8_t> fileData;
+	MakeHdrFile(fileData);
+
+	HdrDecoder::Header header;
+	DF_CHECK(HdrDecoder::ReadHeader(fileData.data(), fileData.size(), header));
+	DF_CHECK(header.width == BenchmarkWidth && header.height == BenchmarkHeight);
+
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf(
+		"    avx2=%d, f16c=%d, workers=%" PRIu32 ", fileSize=%zu KB\n",
+		CpuFeatures::HasAvx2() ? 1 : 0,
+		CpuFeatures::HasF16c() ? 1 : 0,
+		pSharedPool->GetWorkerCount(),
+		fileData.size() / 1024);
+
+	const size_t floatImageSize = size_t(BenchmarkWidth) * BenchmarkHeight * sizeof(float) * 4;
+
+	// The path HDR files took before the native decoder, which is single threaded and has no SIMD variants.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t iteration = 0; iteration < BenchmarkIterationCount; ++iteration)
+		{
+			int width = 0;
+			int height = 0;
+			int channelCount = 0;
+
+			float* const pPixels = stbi_loadf_from_memory(fileData.data(), int(fileData.size()), &width, &height, &channelCount, 4);
+
+			DF_CHECK(pPixels != nullptr);
+			DF_CHECK(width == int(BenchmarkWidth) && height == int(BenchmarkHeight));
+
+			stbi_image_free(pPixels);
+		}
+
+		Test::ReportBenchmark("HdrDecoder stbi_loadf RGBA32F (1 thread)", stopwatch.GetElapsedMs(), BenchmarkIterationCount, fileData.size());
+	}
+
+	for(const HdrDecoder::Format format : { HdrDecoder::Format::RGBA16Float, HdrDecoder::Format::RGB9E5 })
+	{
+		const char* const formatName = (format == HdrDecoder::Format::RGB9E5) ? "RGB9E5" : "RGBA16F";
+		const size_t rowPitch = size_t(BenchmarkWidth) * HdrDecoder::GetTexelSize(format);
+
+		std::vector<uint8_t> baselineImage(rowPitch * BenchmarkHeight);
+		std::vector<uint8_t> image(rowPitch * BenchmarkHeight);
+
+		char name[64];
+		snprintf(name, sizeof(name), "HdrDecoder %s", formatName);
+
+		Test::RunBenchmarkVariants(name, BenchmarkIterationCount, fileData.size(), [&](ThreadPool* const pThreadPool)
+		{
+			std::vector<uint8_t>& output = CpuFeatures::IsBaselineOnly() ? baselineImage : image;
+
+			DF_CHECK(HdrDecoder::Decode(fileData.data(), fileData.size(), header, format, output.data(), rowPitch, pThreadPool));
+		});
+
+		// The kernels have to agree for the timing comparison to be fair.
+		DF_CHECK(memcmp(baselineImage.data(), image.data(), image.size()) == 0);
+
+		printf("    %s image: %zu KB (RGBA32F: %zu KB)\n", formatName, image.size() / 1024, floatImageSize / 1024);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
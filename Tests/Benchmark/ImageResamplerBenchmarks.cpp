@@ -0,0 +1,191 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/ImageResampler.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <DirectXTex.h>
+
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Enough source texels per configuration for the timing to settle without the 8k images taking forever.
+static constexpr uint64_t BenchmarkBytesPerConfig = 64ull * 1024 * 1024;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkFormat
+{
+	ImageResampler::Format format;
+	DXGI_FORMAT dxgiFormat;
+	const char* name;
+	uint32_t maxEdgeLength;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Time a DirectXTex operation, which has no SIMD or thread pool variants to compare.
+template <typename RunFunc>
+static void RunDirectXTex(const char* const name, const uint32_t iterationCount, const uint64_t bytesPerIteration, const RunFunc run)
+{
+	Utility::Stopwatch stopwatch;
+
+	for(uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+	{
+		DirectX::ScratchImage output;
+		DF_CHECK(SUCCEEDED(run(output)));
+	}
+
+	Test::ReportBenchmark(name, stopwatch.GetElapsedMs(), iterationCount, bytesPerIteration);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The two operations Texture2D::Load runs on every image: a Lanczos resize (here a 2x downscale, the largest step a
+// non-power-of-two texture would take) and a box-filtered mip chain. Each is compared against the DirectXTex calls it
+// replaced, a cubic Resize() and a box-filtered GenerateMipMaps(). Throughput counts the source bytes.
+DF_TEST_CASE(ImageResampler_Operations)
+{
+	printf("    avx2=%d, workers=%" PRIu32 "\n", CpuFeatures::HasAvx2() ? 1 : 0, ThreadPool::GetShared()->GetWorkerCount());
+
+	// DirectXTex may filter through WIC, which needs COM on the calling thread.
+	const HRESULT coInitResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	const BenchmarkFormat formats[] =
+	{
+		{ ImageResampler::Format::RGBA8Unorm,  DXGI_FORMAT_R8G8B8A8_UNORM,     "RGBA8",   8192 },
+		{ ImageResampler::Format::RGBA32Float, DXGI_FORMAT_R32G32B32A32_FLOAT, "RGBA32F", 4096 },
+	};
+
+	const uint32_t edgeLengths[] = { 2048, 4096, 8192 };
+
+	for(const BenchmarkFormat& format : formats)
+	{
+		const size_t texelSize = ImageResampler::GetTexelSize(format.format);
+
+		for(const uint32_t edgeLength : edgeLengths)
+		{
+			if(edgeLength > format.maxEdgeLength)
+			{
+				continue;
+			}
+
+			uint32_t mipCount = 1;
+
+			while((edgeLength >> mipCount) > 0)
+			{
+				++mipCount;
+			}
+
+			std::vector<std::vector<uint8_t>> mipData(mipCount);
+			std::vector<ImageResampler::Image> mips(mipCount);
+
+			for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+			{
+				const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+				mipData[mipIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * texelSize);
+
+				mips[mipIndex].pData = mipData[mipIndex].data();
+				mips[mipIndex].rowPitch = size_t(mipEdgeLength) * texelSize;
+				mips[mipIndex].width = mipEdgeLength;
+				mips[mipIndex].height = mipEdgeLength;
+			}
+
+			// Random texels; float images get values in [0, 1).
+			Test::Random random(30);
+
+			if(format.format == ImageResampler::Format::RGBA32Float)
+			{
+				float* const pTexels = reinterpret_cast<float*>(mipData[0].data());
+
+				for(size_t index = 0; index < mipData[0].size() / sizeof(float); ++index)
+				{
+					pTexels[index] = float(random.Next()) / float(0xFFFFFFFFu);
+				}
+			}
+			else
+			{
+				for(uint8_t& value : mipData[0])
+				{
+					value = uint8_t(random.Next());
+				}
+			}
+
+			const ImageResampler::ConstImage source = { mips[0].pData, mips[0].rowPitch, mips[0].width, mips[0].height };
+
+			const uint64_t sourceSize = mipData[0].size();
+			const uint32_t iterationCount = uint32_t((BenchmarkBytesPerConfig + sourceSize - 1) / sourceSize);
+
+			char name[48];
+
+			snprintf(name, sizeof(name), "Resample %s %" PRIu32, format.name, edgeLength);
+			Test::RunBenchmarkVariants(name, iterationCount, sourceSize, [&](ThreadPool* const pThreadPool)
+			{
+				DF_CHECK(ImageResampler::Resample(source, mips[1], format.format, ImageResampler::Filter::Lanczos, pThreadPool));
+			});
+
+			snprintf(name, sizeof(name), "GenerateMips %s %" PRIu32, format.name, edgeLength);
+			Test::RunBenchmarkVariants(name, iterationCount, sourceSize, [&](ThreadPool* const pThreadPool)
+			{
+				DF_CHECK(ImageResampler::GenerateMips(mips.data(), mipCount, format.format, ImageResampler::Filter::Box, pThreadPool));
+			});
+
+			DirectX::Image dxSource;
+			dxSource.width = size_t(edgeLength);
+			dxSource.height = size_t(edgeLength);
+			dxSource.format = format.dxgiFormat;
+			dxSource.rowPitch = mips[0].rowPitch;
+			dxSource.slicePitch = mipData[0].size();
+			dxSource.pixels = mipData[0].data();
+
+			snprintf(name, sizeof(name), "DirectXTex Resize %s %" PRIu32, format.name, edgeLength);
+			RunDirectXTex(name, iterationCount, sourceSize, [&](DirectX::ScratchImage& output)
+			{
+				return DirectX::Resize(dxSource, size_t(mips[1].width), size_t(mips[1].height), DirectX::TEX_FILTER_CUBIC, output);
+			});
+
+			snprintf(name, sizeof(name), "DirectXTex GenerateMipMaps %s %" PRIu32, format.name, edgeLength);
+			RunDirectXTex(name, iterationCount, sourceSize, [&](DirectX::ScratchImage& output)
+			{
+				return DirectX::GenerateMipMaps(dxSource, DirectX::TEX_FILTER_BOX, size_t(mipCount), output);
+			});
+		}
+	}
+
+	if(SUCCEEDED(coInitResult))
+	{
+		CoUninitialize();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
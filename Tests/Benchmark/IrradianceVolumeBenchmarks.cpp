@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/IrradianceVolume.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::IrradianceVolume IrradianceVolume;
+typedef Utility::ShProjection ShProjection;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// A grid large enough that its probes don't all fit in cache, sampled at random points spread across all of it.
+static constexpr uint32_t BenchmarkProbeCount[3] = { 32, 16, 32 };
+static constexpr uint32_t BenchmarkPointCount = 1 << 20;
+static constexpr uint32_t BenchmarkIterationCount = 4;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Lookup time for each storage and interpolation mode. Throughput counts the coefficients written, one set per lookup.
+DF_TEST_CASE(IrradianceVolume_Lookups)
+{
+	Test::Random random(0x49525244u);
+
+	std::vector<ShProjection::Coefficients> probes(size_t(BenchmarkProbeCount[0]) * BenchmarkProbeCount[1] * BenchmarkProbeCount[2]);
+
+	for(ShProjection::Coefficients& probe : probes)
+	{
+		for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+		{
+			for(uint32_t channel = 0; channel < 3; ++channel)
+			{
+				probe.value[coeffIndex][channel] = (float(random.Next(0, 2000)) / 1000.0f) - 1.0f;
+			}
+		}
+	}
+
+	// Points run from a little outside of the grid on one side to a little outside of it on the other, so some of
+	// them get clamped.
+	std::vector<float> positions(size_t(BenchmarkPointCount) * 3);
+
+	for(uint32_t pointIndex = 0; pointIndex < BenchmarkPointCount; ++pointIndex)
+	{
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const float extent = float(BenchmarkProbeCount[axis] - 1) * 2.0f;
+
+			positions[(pointIndex * 3) + axis] = (float(random.Next(0, 100000)) / 100000.0f) * (extent + 2.0f) - 1.0f;
+		}
+	}
+
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf(
+		"    avx2=%d, f16c=%d, workers=%" PRIu32 ", probes=%zu, points=%" PRIu32 "\n",
+		CpuFeatures::HasAvx2() ? 1 : 0,
+		CpuFeatures::HasF16c() ? 1 : 0,
+		pSharedPool->GetWorkerCount(),
+		probes.size(),
+		BenchmarkPointCount);
+
+	std::vector<ShProjection::Coefficients> baselineOutput(BenchmarkPointCount);
+	std::vector<ShProjection::Coefficients> output(BenchmarkPointCount);
+
+	const uint64_t outputSize = uint64_t(output.size()) * sizeof(ShProjection::Coefficients);
+
+	for(const IrradianceVolume::Storage storage : { IrradianceVolume::Storage::Float32, IrradianceVolume::Storage::Float16 })
+	{
+		const char* const storageName = (storage == IrradianceVolume::Storage::Float16) ? "half" : "float";
+
+		IrradianceVolume::Desc desc;
+		desc.probeCount[0] = BenchmarkProbeCount[0];
+		desc.probeCount[1] = BenchmarkProbeCount[1];
+		desc.probeCount[2] = BenchmarkProbeCount[2];
+		desc.origin[0] = 0.0f;
+		desc.origin[1] = 0.0f;
+		desc.origin[2] = 0.0f;
+		desc.spacing[0] = 2.0f;
+		desc.spacing[1] = 2.0f;
+		desc.spacing[2] = 2.0f;
+		desc.storage = storage;
+
+		IrradianceVolume volume;
+		DF_CHECK(volume.Reset(desc));
+
+		for(uint32_t z = 0; z < BenchmarkProbeCount[2]; ++z)
+		{
+			for(uint32_t y = 0; y < BenchmarkProbeCount[1]; ++y)
+			{
+				for(uint32_t x = 0; x < BenchmarkProbeCount[0]; ++x)
+				{
+					const size_t probeIndex = x + (size_t(BenchmarkProbeCount[0]) * (y + (size_t(BenchmarkProbeCount[1]) * z)));
+
+					volume.SetProbe(x, y, z, probes[probeIndex]);
+				}
+			}
+		}
+
+		for(const IrradianceVolume::Interpolation interpolation : { IrradianceVolume::Interpolation::Trilinear, IrradianceVolume::Interpolation::Tetrahedral })
+		{
+			const char* const interpolationName = (interpolation == IrradianceVolume::Interpolation::Tetrahedral) ? "tetrahedral" : "trilinear";
+
+			char name[64];
+			snprintf(name, sizeof(name), "%s %s", storageName, interpolationName);
+
+			Test::RunBenchmarkVariants(name, BenchmarkIterationCount, outputSize, [&](ThreadPool* const pThreadPool)
+			{
+				std::vector<ShProjection::Coefficients>& outCoefficients = CpuFeatures::IsBaselineOnly() ? baselineOutput : output;
+
+				volume.Sample(positions.data(), BenchmarkPointCount, interpolation, pThreadPool, outCoefficients.data());
+			});
+
+			// Both paths do the same float operations in the same order.
+			DF_CHECK(memcmp(baselineOutput.data(), output.data(), output.size() * sizeof(ShProjection::Coefficients)) == 0);
+		}
+
+		printf(
+			"    %s probe: %zu bytes on the CPU, %zu bytes on the GPU, %zu KB per volume\n",
+			storageName,
+			volume.GetProbeSize(),
+			volume.GetGpuProbeSize(),
+			(volume.GetProbeSize() * volume.GetProbeCount()) / 1024);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/PixelConvert.hpp>
+
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::PixelConvert PixelConvert;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// A 1024x1024 RGB image's worth of channels, converted enough times for the timing to settle.
+static constexpr size_t BenchmarkTexelCount = 1024 * 1024;
+static constexpr size_t BenchmarkValueCount = BenchmarkTexelCount * 3;
+static constexpr uint32_t BenchmarkIterationCount = 20;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Time a bulk conversion on the baseline path and on whatever path the CPU supports. Throughput counts the bytes read
+// and written by each pass.
+template <typename SrcType, typename DstType, typename ConvertFunc>
+static void RunConversion(
+	const char* const name,
+	const std::vector<SrcType>& src,
+	std::vector<DstType>& dst,
+	const size_t count,
+	const ConvertFunc convert)
+{
+	const uint64_t bytesPerIteration = uint64_t(src.size() * sizeof(SrcType)) + uint64_t(dst.size() * sizeof(DstType));
+
+	// Warm the caches and any lazily built tables of both paths before timing.
+	for(const bool baselineOnly : { true, false })
+	{
+		CpuFeatures::SetBaselineOnly(baselineOnly);
+
+		convert(src.data(), dst.data(), count);
+	}
+
+	Test::RunBenchmarkVariants(
+		name,
+		BenchmarkIterationCount,
+		bytesPerIteration,
+		[&](Utility::ThreadPool*)
+		{
+			convert(src.data(), dst.data(), count);
+		},
+		false);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_Throughput)
+{
+	printf("    avx2=%d, f16c=%d\n", CpuFeatures::HasAvx2() ? 1 : 0, CpuFeatures::HasF16c() ? 1 : 0);
+
+	Test::Random random(43);
+
+	// HDR-ish values, mostly in [0, 1] with some highlights up to 64.
+	std::vector<float> floats(BenchmarkValueCount);
+
+	for(float& value : floats)
+	{
+		const float unit = float(random.Next()) / float(0xFFFFFFFFu);
+
+		value = (random.Next(0, 15) == 0) ? (unit * 64.0f) : unit;
+	}
+
+	std::vector<uint16_t> halves(BenchmarkValueCount);
+	std::vector<uint8_t> bytes(BenchmarkValueCount);
+	std::vector<uint32_t> texels(BenchmarkTexelCount);
+	std::vector<uint8_t> rgbes(BenchmarkTexelCount * 4);
+	std::vector<float> decoded(BenchmarkValueCount);
+
+	RunConversion("FloatToHalf", floats, halves, BenchmarkValueCount, static_cast<void(*)(const float*, uint16_t*, size_t)>(PixelConvert::FloatToHalf));
+	RunConversion("HalfToFloat", halves, decoded, BenchmarkValueCount, static_cast<void(*)(const uint16_t*, float*, size_t)>(PixelConvert::HalfToFloat));
+
+	RunConversion("FloatToUnorm", floats, bytes, BenchmarkValueCount, static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToUnorm));
+	RunConversion("UnormToFloat", bytes, decoded, BenchmarkValueCount, static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::UnormToFloat));
+
+	RunConversion("FloatToSrgb", floats, bytes, BenchmarkValueCount, static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToSrgb));
+	RunConversion("SrgbToFloat", bytes, decoded, BenchmarkValueCount, static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::SrgbToFloat));
+
+	RunConversion("FloatToSharedExponent", floats, texels, BenchmarkTexelCount, static_cast<void(*)(const float*, uint32_t*, size_t)>(PixelConvert::FloatToSharedExponent));
+	RunConversion("SharedExponentToFloat", texels, decoded, BenchmarkTexelCount, static_cast<void(*)(const uint32_t*, float*, size_t)>(PixelConvert::SharedExponentToFloat));
+
+	RunConversion("FloatToR11G11B10", floats, texels, BenchmarkTexelCount, static_cast<void(*)(const float*, uint32_t*, size_t)>(PixelConvert::FloatToR11G11B10));
+	RunConversion("R11G11B10ToFloat", texels, decoded, BenchmarkTexelCount, static_cast<void(*)(const uint32_t*, float*, size_t)>(PixelConvert::R11G11B10ToFloat));
+
+	RunConversion("FloatToRgbe", floats, rgbes, BenchmarkTexelCount, static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToRgbe));
+	RunConversion("RgbeToFloat", rgbes, decoded, BenchmarkTexelCount, static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::RgbeToFloat));
+
+	RunConversion("FloatRgbToUnormRgba", floats, texels, BenchmarkTexelCount, PixelConvert::FloatRgbToUnormRgba);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Direct3D12/ProbeCache.hpp>
+#include <DemoFramework/Utility/CubeMapConverter.hpp>
+#include <DemoFramework/Utility/Hash.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef D3D12::ProbeCache ProbeCache;
+typedef Utility::CubeMapConverter CubeMapConverter;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ShProjection ShProjection;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* const BenchmarkSourceFilePath = "probe-cache-benchmark.bin";
+
+static constexpr uint32_t BenchmarkEquirectWidth = 2048;
+static constexpr uint32_t BenchmarkEquirectHeight = 1024;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cube map sizes of each EnvMapQuality, as ReflectionProbe::Create() picks them.
+struct BenchmarkQuality
+{
+	const char* name;
+	uint32_t envEdgeLength;
+	uint32_t irrEdgeLength;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetMipCount(const uint32_t edgeLength)
+{
+	uint32_t mipCount = 1;
+
+	while((edgeLength >> mipCount) > 0)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Startup cost of a reflection probe with and without its cache entry, for each quality level. The cold path is the
+// CPU equivalent of the bake the cache replaces (equirect to cube conversion with mips, SH projection and the
+// irradiance cube reconstructed from it) plus storing the entry; the specular prefilter has its own benchmark. The
+// warm path hashes the source, maps the entry and copies it into staging memory, which is all a cache hit does before
+// its uploads.
+DF_TEST_CASE(ProbeCache_ColdWarmStartup)
+{
+	ProbeCache::Ptr cache = ProbeCache::Create(".");
+	DF_CHECK(cache != nullptr);
+
+	if(!cache)
+	{
+		return;
+	}
+
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	// A sky gradient, written out as the source file so the key has real contents to hash.
+	std::vector<float> equirectTexels(size_t(BenchmarkEquirectWidth) * BenchmarkEquirectHeight * 4);
+
+	for(uint32_t y = 0; y < BenchmarkEquirectHeight; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkEquirectWidth; ++x)
+		{
+			float* const pTexel = equirectTexels.data() + (((size_t(y) * BenchmarkEquirectWidth) + x) * 4);
+			const float v = float(y) / float(BenchmarkEquirectHeight);
+
+			pTexel[0] = 0.4f * (1.0f - v) + 0.1f * sinf(float(x) * 0.01f);
+			pTexel[1] = 0.6f * (1.0f - v);
+			pTexel[2] = 1.2f * (1.0f - v);
+			pTexel[3] = 1.0f;
+		}
+	}
+
+	FILE* const pFile = fopen(BenchmarkSourceFilePath, "wb");
+	DF_CHECK(pFile != nullptr);
+
+	if(!pFile)
+	{
+		return;
+	}
+
+	fwrite(equirectTexels.data(), sizeof(float), equirectTexels.size(), pFile);
+	fclose(pFile);
+
+	const ImageResampler::ConstImage equirect =
+	{
+		reinterpret_cast<const uint8_t*>(equirectTexels.data()),
+		size_t(BenchmarkEquirectWidth) * sizeof(float) * 4,
+		BenchmarkEquirectWidth,
+		BenchmarkEquirectHeight,
+	};
+
+	const BenchmarkQuality qualities[] =
+	{
+		{ "Low",  512,  16 },
+		{ "Mid",  1024, 32 },
+		{ "High", 2048, 64 },
+	};
+
+	for(const BenchmarkQuality& quality : qualities)
+	{
+		const uint32_t envMipCount = GetMipCount(quality.envEdgeLength);
+
+		std::vector<std::vector<float>> envData(DF_CUBE_MAP_FACE_COUNT * envMipCount);
+		std::vector<ImageResampler::Image> envFaces(DF_CUBE_MAP_FACE_COUNT * envMipCount);
+
+		size_t envDataSize = 0;
+
+		for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+		{
+			for(uint32_t mipIndex = 0; mipIndex < envMipCount; ++mipIndex)
+			{
+				const size_t imageIndex = (faceIndex * envMipCount) + mipIndex;
+				const uint32_t mipEdgeLength = quality.envEdgeLength >> mipIndex;
+
+				envData[imageIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * 4);
+				envFaces[imageIndex] =
+				{
+					reinterpret_cast<uint8_t*>(envData[imageIndex].data()),
+					size_t(mipEdgeLength) * sizeof(float) * 4,
+					mipEdgeLength,
+					mipEdgeLength,
+				};
+
+				envDataSize += envData[imageIndex].size() * sizeof(float);
+			}
+		}
+
+		const size_t irrFaceFloatCount = size_t(quality.irrEdgeLength) * quality.irrEdgeLength * 4;
+
+		std::vector<float> irrData(irrFaceFloatCount * DF_CUBE_MAP_FACE_COUNT);
+
+		// The probe stores its cube maps contiguously, so do the same here.
+		std::vector<uint8_t> envBlob(envDataSize);
+
+		const uint64_t paramHash = Utility::Hash::Combine(uint64_t(quality.envEdgeLength), uint64_t(quality.irrEdgeLength));
+
+		ProbeCache::Key key;
+		ShProjection::Coefficients coefficients;
+
+		char benchmarkName[64];
+
+		{
+			Utility::Stopwatch stopwatch;
+
+			DF_CHECK(cache->MakeKey(BenchmarkSourceFilePath, paramHash, key));
+			DF_CHECK(CubeMapConverter::Convert(equirect, envFaces.data(), quality.envEdgeLength, envMipCount, pThreadPool));
+
+			ImageResampler::ConstImage topFaces[DF_CUBE_MAP_FACE_COUNT];
+
+			for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+			{
+				const ImageResampler::Image& face = envFaces[faceIndex * envMipCount];
+
+				topFaces[faceIndex] = { face.pData, face.rowPitch, face.width, face.height };
+			}
+
+			DF_CHECK(ShProjection::Project(topFaces, quality.envEdgeLength, pThreadPool, coefficients));
+
+			const float invIrrEdgeLength = 1.0f / float(quality.irrEdgeLength);
+
+			for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+			{
+				for(uint32_t y = 0; y < quality.irrEdgeLength; ++y)
+				{
+					for(uint32_t x = 0; x < quality.irrEdgeLength; ++x)
+					{
+						float* const pTexel = irrData.data() + (irrFaceFloatCount * faceIndex) + (((size_t(y) * quality.irrEdgeLength) + x) * 4);
+
+						float normal[3];
+						ShProjection::CalculateNormalFromPixelCoord(x, y, faceIndex, invIrrEdgeLength, normal);
+						ShProjection::ReconstructColor(coefficients, normal, pTexel);
+
+						pTexel[3] = 1.0f;
+					}
+				}
+			}
+
+			uint64_t offset = 0;
+
+			for(const std::vector<float>& image : envData)
+			{
+				memcpy(envBlob.data() + offset, image.data(), image.size() * sizeof(float));
+				offset += image.size() * sizeof(float);
+			}
+
+			DF_CHECK(cache->Store(
+				key,
+				coefficients,
+				envBlob.data(),
+				envBlob.size(),
+				reinterpret_cast<const uint8_t*>(irrData.data()),
+				irrData.size() * sizeof(float)));
+
+			snprintf(benchmarkName, sizeof(benchmarkName), "Probe startup %s (bake + store)", quality.name);
+			Test::ReportBenchmark(benchmarkName, stopwatch.GetElapsedMs(), 1);
+		}
+
+		{
+			std::vector<uint8_t> staging(envBlob.size() + (irrData.size() * sizeof(float)));
+
+			Utility::Stopwatch stopwatch;
+
+			ProbeCache::Entry entry;
+
+			DF_CHECK(cache->MakeKey(BenchmarkSourceFilePath, paramHash, key));
+			DF_CHECK(cache->Find(key, entry));
+			DF_CHECK(entry.envDataSize == envDataSize);
+
+			if(entry.envDataSize + entry.irrDataSize == staging.size())
+			{
+				memcpy(staging.data(), entry.pEnvData, size_t(entry.envDataSize));
+				memcpy(staging.data() + entry.envDataSize, entry.pIrrData, size_t(entry.irrDataSize));
+			}
+
+			snprintf(benchmarkName, sizeof(benchmarkName), "Probe startup %s (cache hit)", quality.name);
+			Test::ReportBenchmark(benchmarkName, stopwatch.GetElapsedMs(), 1, staging.size());
+
+			DF_CHECK(memcmp(&entry.coefficients, &coefficients, sizeof(coefficients)) == 0);
+		}
+
+		printf("    %s entry: %" PRIu64 " KB\n", quality.name, uint64_t(envBlob.size() + (irrData.size() * sizeof(float))) / 1024);
+
+		// Entries are named after the path and parameter hashes.
+		char entryPath[64];
+		snprintf(entryPath, sizeof(entryPath), "./%016" PRIx64 DF_PROBE_CACHE_FILE_EXTENSION, Utility::Hash::Combine(key.pathHash, key.paramHash));
+
+		remove(entryPath);
+	}
+
+	remove(BenchmarkSourceFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/ShProjection.hpp>
+#include <DemoFramework/Utility/ThreadPool.hpp>
+
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ShProjection ShProjection;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Roughly 64 MB of cube map texels per configuration, so the small sizes get enough iterations to time.
+static constexpr uint64_t BenchmarkBytesPerSize = 64ull * 1024 * 1024;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ShProjection_Project)
+{
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	printf("    avx2=%d, workers=%" PRIu32 "\n", CpuFeatures::HasAvx2() ? 1 : 0, pThreadPool->GetWorkerCount());
+
+	const uint32_t edgeLengths[] = { 32, 64, 128, 256, 512 };
+
+	for(const uint32_t edgeLength : edgeLengths)
+	{
+		const size_t faceFloatCount = size_t(edgeLength) * edgeLength * 4;
+		const uint64_t bytesPerIteration = uint64_t(faceFloatCount) * sizeof(float) * 6;
+		const uint32_t iterationCount = uint32_t((BenchmarkBytesPerSize + bytesPerIteration - 1) / bytesPerIteration);
+
+		Test::Random random(45);
+
+		std::vector<float> texels(faceFloatCount * 6);
+
+		for(float& value : texels)
+		{
+			value = float(random.Next()) / float(0xFFFFFFFFu);
+		}
+
+		ImageResampler::ConstImage faces[6];
+
+		for(uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+		{
+			faces[faceIndex].pData = reinterpret_cast<const uint8_t*>(texels.data() + (faceFloatCount * faceIndex));
+			faces[faceIndex].rowPitch = size_t(edgeLength) * sizeof(float) * 4;
+			faces[faceIndex].width = edgeLength;
+			faces[faceIndex].height = edgeLength;
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "ShProjection::Project %" PRIu32, edgeLength);
+
+		Test::RunBenchmarkVariants(name, iterationCount, bytesPerIteration, [&](ThreadPool* const pPool)
+		{
+			ShProjection::Coefficients coefficients;
+
+			DF_CHECK(ShProjection::Project(faces, edgeLength, pPool, coefficients));
+		});
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CubeMapConverter.hpp>
+#include <DemoFramework/Utility/SpecularPrefilter.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CubeMapConverter CubeMapConverter;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::SpecularPrefilter SpecularPrefilter;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t BenchmarkEquirectWidth = 2048;
+static constexpr uint32_t BenchmarkEquirectHeight = 1024;
+
+// Same as DF_REFL_SPEC_SAMPLE_COUNT, which the reflection probe bakes with.
+static constexpr uint32_t BenchmarkSampleCount = 64;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkCube
+{
+	std::vector<std::vector<float>> data;
+	std::vector<ImageResampler::Image> faces;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetMipCount(const uint32_t edgeLength)
+{
+	uint32_t mipCount = 1;
+
+	while((edgeLength >> mipCount) > 0)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void MakeBenchmarkCube(const uint32_t edgeLength, const uint32_t mipCount, BenchmarkCube& outCube)
+{
+	outCube.data.resize(size_t(mipCount) * DF_CUBE_MAP_FACE_COUNT);
+	outCube.faces.resize(size_t(mipCount) * DF_CUBE_MAP_FACE_COUNT);
+
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+		{
+			const size_t imageIndex = (faceIndex * mipCount) + mipIndex;
+			const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+			outCube.data[imageIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * 4);
+			outCube.faces[imageIndex] =
+			{
+				reinterpret_cast<uint8_t*>(outCube.data[imageIndex].data()),
+				size_t(mipEdgeLength) * sizeof(float) * 4,
+				mipEdgeLength,
+				mipEdgeLength,
+			};
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Bake cost of the specular cube map at the sizes of each EnvMapQuality. The source cube map is converted from an
+// equirect up front, outside of the timing.
+DF_TEST_CASE(SpecularPrefilter_Prefilter)
+{
+	std::vector<float> equirectTexels(size_t(BenchmarkEquirectWidth) * BenchmarkEquirectHeight * 4);
+
+	for(uint32_t y = 0; y < BenchmarkEquirectHeight; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkEquirectWidth; ++x)
+		{
+			float* const pTexel = equirectTexels.data() + (((size_t(y) * BenchmarkEquirectWidth) + x) * 4);
+
+			pTexel[0] = 0.5f + 0.5f * sinf(float(x) * 0.013f);
+			pTexel[1] = 0.5f + 0.5f * cosf(float(y) * 0.021f);
+			pTexel[2] = float((x ^ y) & 0xFF) / 64.0f;
+			pTexel[3] = 1.0f;
+		}
+	}
+
+	const ImageResampler::ConstImage equirect =
+	{
+		reinterpret_cast<const uint8_t*>(equirectTexels.data()),
+		size_t(BenchmarkEquirectWidth) * sizeof(float) * 4,
+		BenchmarkEquirectWidth,
+		BenchmarkEquirectHeight,
+	};
+
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf("    workers=%" PRIu32 ", samples=%" PRIu32 "\n", pSharedPool->GetWorkerCount(), BenchmarkSampleCount);
+
+	const struct
+	{
+		const char* name;
+		uint32_t edgeLength;
+	} qualities[] =
+	{
+		{ "Low",  512 },
+		{ "Mid",  1024 },
+		{ "High", 2048 },
+	};
+
+	for(const auto& quality : qualities)
+	{
+		const uint32_t mipCount = GetMipCount(quality.edgeLength);
+
+		BenchmarkCube srcCube;
+		BenchmarkCube dstCube;
+
+		MakeBenchmarkCube(quality.edgeLength, mipCount, srcCube);
+		MakeBenchmarkCube(quality.edgeLength, mipCount, dstCube);
+
+		DF_CHECK(CubeMapConverter::Convert(equirect, srcCube.faces.data(), quality.edgeLength, mipCount, pSharedPool));
+
+		std::vector<ImageResampler::ConstImage> srcFaces(srcCube.faces.size());
+
+		for(size_t imageIndex = 0; imageIndex < srcFaces.size(); ++imageIndex)
+		{
+			const ImageResampler::Image& face = srcCube.faces[imageIndex];
+
+			srcFaces[imageIndex] = { face.pData, face.rowPitch, face.width, face.height };
+		}
+
+		// Every mip below the mirror takes the full sample count per texel.
+		uint64_t sampleTotal = 0;
+
+		for(uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+		{
+			const uint64_t mipEdgeLength = quality.edgeLength >> mipIndex;
+
+			sampleTotal += mipEdgeLength * mipEdgeLength * DF_CUBE_MAP_FACE_COUNT * BenchmarkSampleCount;
+		}
+
+		for(ThreadPool* const pThreadPool : { static_cast<ThreadPool*>(nullptr), pSharedPool })
+		{
+			Utility::Stopwatch stopwatch;
+
+			DF_CHECK(SpecularPrefilter::Prefilter(
+				srcFaces.data(),
+				dstCube.faces.data(),
+				quality.edgeLength,
+				mipCount,
+				BenchmarkSampleCount,
+				pThreadPool));
+
+			const double elapsedMs = stopwatch.GetElapsedMs();
+			const double samplesPerSec = (elapsedMs > 0.0) ? (double(sampleTotal) * 1000.0 / elapsedMs) : 0.0;
+
+			char benchmarkName[96];
+			snprintf(
+				benchmarkName,
+				sizeof(benchmarkName),
+				"%s %" PRIu32 " (%s, %.0f Msamples/s)",
+				quality.name,
+				quality.edgeLength,
+				pThreadPool ? "pool" : "1 thread",
+				samplesPerSec / 1000000.0);
+
+			Test::ReportBenchmark(benchmarkName, elapsedMs, 1);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/Stopwatch.hpp>
+#include <DemoFramework/Utility/SupercompressedTexture.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::BlockCompressor BlockCompressor;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::SupercompressedTexture SupercompressedTexture;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* const BenchmarkFilePath = "supercompressed-texture-benchmark" DF_SUPERCOMPRESSED_TEXTURE_FILE_EXTENSION;
+
+static constexpr uint32_t BenchmarkEdgeLength = 2048;
+static constexpr uint32_t BenchmarkMipCount = 12;
+static constexpr uint32_t BenchmarkIterationCount = 8;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkLayout
+{
+	SupercompressedTexture::Layout layout;
+	const char* name;
+
+	BlockCompressor::Format formats[2];
+	const char* formatNames[2];
+	uint32_t formatCount;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Mip chain of smooth gradients and soft shapes with some noise, so the codebooks have real content to fit.
+static void MakeMipChain(
+	const ImageResampler::Format format,
+	std::vector<std::vector<uint8_t>>& outMipData,
+	std::vector<ImageResampler::ConstImage>& outMips)
+{
+	const size_t texelSize = ImageResampler::GetTexelSize(format);
+
+	outMipData.resize(BenchmarkMipCount);
+	outMips.resize(BenchmarkMipCount);
+
+	std::vector<ImageResampler::Image> mips(BenchmarkMipCount);
+
+	for(uint32_t mipIndex = 0; mipIndex < BenchmarkMipCount; ++mipIndex)
+	{
+		const uint32_t mipEdgeLength = BenchmarkEdgeLength >> mipIndex;
+
+		outMipData[mipIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * texelSize);
+
+		mips[mipIndex] = { outMipData[mipIndex].data(), size_t(mipEdgeLength) * texelSize, mipEdgeLength, mipEdgeLength };
+		outMips[mipIndex] = { outMipData[mipIndex].data(), size_t(mipEdgeLength) * texelSize, mipEdgeLength, mipEdgeLength };
+	}
+
+	Test::Random random(44);
+
+	for(uint32_t y = 0; y < BenchmarkEdgeLength; ++y)
+	{
+		for(uint32_t x = 0; x < BenchmarkEdgeLength; ++x)
+		{
+			const float u = float(x) / float(BenchmarkEdgeLength);
+			const float v = float(y) / float(BenchmarkEdgeLength);
+
+			const float values[4] =
+			{
+				0.5f + (0.5f * sinf(u * 9.0f + v * 3.0f)),
+				0.5f + (0.5f * cosf(v * 7.0f - u * 2.0f)),
+				(((x / 64) + (y / 64)) % 2 == 0) ? 0.8f : 0.2f,
+				1.0f,
+			};
+
+			uint8_t* const pTexel = outMipData[0].data() + (((size_t(y) * BenchmarkEdgeLength) + x) * texelSize);
+
+			for(size_t channel = 0; channel < texelSize; ++channel)
+			{
+				const float noise = (float(random.Next(0, 1000)) / 1000.0f - 0.5f) * 0.02f;
+
+				pTexel[channel] = uint8_t(fminf(fmaxf(values[channel] + noise, 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	ImageResampler::GenerateMips(mips.data(), BenchmarkMipCount, format, ImageResampler::Filter::Box, ThreadPool::GetShared());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Transcode throughput for every target format of each layout, with the encode time and file size of the layout next
+// to the size of the block-compressed data it replaces. Throughput counts the bytes of block-compressed output.
+DF_TEST_CASE(SupercompressedTexture_Transcode)
+{
+	ThreadPool* const pSharedPool = ThreadPool::GetShared();
+
+	printf("    workers=%" PRIu32 "\n", pSharedPool->GetWorkerCount());
+
+	const BenchmarkLayout layouts[] =
+	{
+		{ SupercompressedTexture::Layout::Color, "Color", { BlockCompressor::Format::BC1, BlockCompressor::Format::BC7 }, { "BC1", "BC7" }, 2 },
+		{ SupercompressedTexture::Layout::R,     "R",     { BlockCompressor::Format::BC4 },                               { "BC4" },        1 },
+		{ SupercompressedTexture::Layout::RG,    "RG",    { BlockCompressor::Format::BC5 },                               { "BC5" },        1 },
+	};
+
+	uint64_t texelCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < BenchmarkMipCount; ++mipIndex)
+	{
+		const uint64_t mipEdgeLength = BenchmarkEdgeLength >> mipIndex;
+
+		texelCount += mipEdgeLength * mipEdgeLength;
+	}
+
+	for(const BenchmarkLayout& layout : layouts)
+	{
+		const ImageResampler::Format sourceFormat = SupercompressedTexture::GetSourceFormat(layout.layout);
+
+		std::vector<std::vector<uint8_t>> sourceData;
+		std::vector<ImageResampler::ConstImage> sourceMips;
+		MakeMipChain(sourceFormat, sourceData, sourceMips);
+
+		Utility::Stopwatch encodeStopwatch;
+
+		const bool written = SupercompressedTexture::Write(
+			BenchmarkFilePath,
+			layout.layout,
+			sourceMips.data(),
+			BenchmarkMipCount,
+			SupercompressedTexture::EncodeOptions(),
+			pSharedPool);
+
+		const double encodeMs = encodeStopwatch.GetElapsedMs();
+
+		DF_CHECK(written);
+
+		const SupercompressedTexture::Ptr texture = written ? SupercompressedTexture::Open(BenchmarkFilePath) : SupercompressedTexture::Ptr();
+		DF_CHECK(texture != nullptr);
+
+		if(!texture)
+		{
+			remove(BenchmarkFilePath);
+			continue;
+		}
+
+		printf("    %s layout: encode=%.1f ms, file=%" PRIu64 " KB\n", layout.name, encodeMs, texture->GetFileSize() / 1024);
+
+		for(uint32_t formatIndex = 0; formatIndex < layout.formatCount; ++formatIndex)
+		{
+			const BlockCompressor::Format format = layout.formats[formatIndex];
+			const uint32_t blockSize = BlockCompressor::GetBlockSize(format);
+
+			std::vector<std::vector<uint8_t>> dstData(BenchmarkMipCount);
+			std::vector<ImageResampler::Image> dstMips(BenchmarkMipCount);
+
+			uint64_t compressedSize = 0;
+
+			for(uint32_t mipIndex = 0; mipIndex < BenchmarkMipCount; ++mipIndex)
+			{
+				const uint32_t mipEdgeLength = BenchmarkEdgeLength >> mipIndex;
+				const uint32_t blockCount = (mipEdgeLength + 3) / 4;
+				const size_t rowPitch = size_t(blockCount) * blockSize;
+
+				dstData[mipIndex].resize(rowPitch * blockCount);
+				dstMips[mipIndex] = { dstData[mipIndex].data(), rowPitch, mipEdgeLength, mipEdgeLength };
+
+				compressedSize += dstData[mipIndex].size();
+			}
+
+			for(ThreadPool* const pThreadPool : { static_cast<ThreadPool*>(nullptr), pSharedPool })
+			{
+				Utility::Stopwatch stopwatch;
+
+				for(uint32_t iteration = 0; iteration < BenchmarkIterationCount; ++iteration)
+				{
+					DF_CHECK(texture->Transcode(format, dstMips.data(), BenchmarkMipCount, pThreadPool));
+				}
+
+				const double elapsedMs = stopwatch.GetElapsedMs();
+				const double megapixelsPerSecond = (double(texelCount) * BenchmarkIterationCount) / (elapsedMs * 1000.0);
+
+				char benchmarkName[64];
+				snprintf(
+					benchmarkName,
+					sizeof(benchmarkName),
+					"Transcode to %s (%s, %.0f MP/s)",
+					layout.formatNames[formatIndex],
+					pThreadPool ? "pool" : "1 thread",
+					megapixelsPerSecond);
+
+				Test::ReportBenchmark(benchmarkName, elapsedMs, BenchmarkIterationCount, compressedSize);
+			}
+
+			printf("    %s data: %" PRIu64 " KB\n", layout.formatNames[formatIndex], compressedSize / 1024);
+		}
+
+		remove(BenchmarkFilePath);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,263 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/HdrDecoder.hpp>
+#include <DemoFramework/Utility/ImageResampler.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::HdrDecoder HdrDecoder;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// A scene's worth of material textures, with every 4th one an HDR image.
+static constexpr uint32_t BenchmarkTextureCount = 200;
+static constexpr uint32_t BenchmarkEdgeLength = 512;
+static constexpr uint32_t BenchmarkMipCount = 10;
+static constexpr uint32_t BenchmarkHdrInterval = 4;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkTexture
+{
+	std::vector<uint8_t> fileData;
+	std::vector<std::vector<uint8_t>> mipData;
+	ImageResampler::Image mips[BenchmarkMipCount];
+	ImageResampler::Format format;
+	bool hdr;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void AppendEncodedData(void* const pContext, void* const pData, const int size)
+{
+	std::vector<uint8_t>& output = *reinterpret_cast<std::vector<uint8_t>*>(pContext);
+	const uint8_t* const pBytes = reinterpret_cast<const uint8_t*>(pData);
+
+	output.insert(output.end(), pBytes, pBytes + size);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Encode a noisy gradient, which compresses about as well as a typical material texture, as a PNG file or, for HDR
+// textures, as an RLE .hdr file. HDR textures are decoded to RGBA16 float, like Texture2D's HalfFloat data type.
+static bool InitTexture(const uint32_t textureIndex, BenchmarkTexture& outTexture)
+{
+	outTexture.hdr = (textureIndex % BenchmarkHdrInterval) == 0;
+	outTexture.format = outTexture.hdr ? ImageResampler::Format::RGBA16Float : ImageResampler::Format::RGBA8Unorm;
+
+	const size_t texelSize = ImageResampler::GetTexelSize(outTexture.format);
+
+	outTexture.mipData.resize(BenchmarkMipCount);
+
+	for(uint32_t mipIndex = 0; mipIndex < BenchmarkMipCount; ++mipIndex)
+	{
+		const uint32_t mipEdgeLength = BenchmarkEdgeLength >> mipIndex;
+
+		outTexture.mipData[mipIndex].resize(size_t(mipEdgeLength) * mipEdgeLength * texelSize);
+
+		outTexture.mips[mipIndex].pData = outTexture.mipData[mipIndex].data();
+		outTexture.mips[mipIndex].rowPitch = size_t(mipEdgeLength) * texelSize;
+		outTexture.mips[mipIndex].width = mipEdgeLength;
+		outTexture.mips[mipIndex].height = mipEdgeLength;
+	}
+
+	Test::Random random(35 + textureIndex);
+
+	const size_t texelCount = size_t(BenchmarkEdgeLength) * BenchmarkEdgeLength;
+
+	if(outTexture.hdr)
+	{
+		std::vector<float> pixels(texelCount * 3);
+
+		for(size_t i = 0; i < texelCount; ++i)
+		{
+			const float gradient = float(i / BenchmarkEdgeLength) / float(BenchmarkEdgeLength);
+
+			pixels[(i * 3) + 0] = (0.5f * gradient) + (float(random.Next(0, 100)) / 1000.0f);
+			pixels[(i * 3) + 1] = (1.0f * gradient) + (float(random.Next(0, 100)) / 1000.0f);
+			pixels[(i * 3) + 2] = (4.0f * gradient) + (float(random.Next(0, 100)) / 1000.0f);
+		}
+
+		return stbi_write_hdr_to_func(AppendEncodedData, &outTexture.fileData, BenchmarkEdgeLength, BenchmarkEdgeLength, 3, pixels.data()) != 0;
+	}
+
+	std::vector<uint8_t> pixels(texelCount * 4);
+
+	for(size_t i = 0; i < texelCount; ++i)
+	{
+		const uint32_t gradient = uint32_t((i % BenchmarkEdgeLength) * 192 / BenchmarkEdgeLength);
+
+		pixels[(i * 4) + 0] = uint8_t(gradient + random.Next(0, 15));
+		pixels[(i * 4) + 1] = uint8_t(gradient + random.Next(0, 15));
+		pixels[(i * 4) + 2] = uint8_t(gradient + random.Next(0, 15));
+		pixels[(i * 4) + 3] = 255;
+	}
+
+	const int rowPitch = int(BenchmarkEdgeLength * 4);
+
+	return stbi_write_png_to_func(AppendEncodedData, &outTexture.fileData, BenchmarkEdgeLength, BenchmarkEdgeLength, 4, pixels.data(), rowPitch) != 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Decode a texture's file into its top mip the same way Texture2D does for its data type.
+static bool DecodeTexture(BenchmarkTexture& texture, ThreadPool* const pThreadPool)
+{
+	const uint8_t* const pFileData = texture.fileData.data();
+	const size_t fileSize = texture.fileData.size();
+
+	if(texture.hdr)
+	{
+		HdrDecoder::Header header;
+
+		if(!HdrDecoder::ReadHeader(pFileData, fileSize, header) || header.width != BenchmarkEdgeLength || header.height != BenchmarkEdgeLength)
+		{
+			return false;
+		}
+
+		return HdrDecoder::Decode(pFileData, fileSize, header, HdrDecoder::Format::RGBA16Float, texture.mips[0].pData, texture.mips[0].rowPitch, pThreadPool);
+	}
+
+	int width = 0;
+	int height = 0;
+
+	stbi_uc* const pPixels = stbi_load_from_memory(pFileData, int(fileSize), &width, &height, nullptr, 4);
+	if(!pPixels)
+	{
+		return false;
+	}
+
+	const bool result = (width == int(BenchmarkEdgeLength) && height == int(BenchmarkEdgeLength));
+
+	if(result)
+	{
+		memcpy(texture.mips[0].pData, pPixels, texture.mipData[0].size());
+	}
+
+	stbi_image_free(pPixels);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The CPU side of loading a batch of textures: decoding each file from memory, then generating its mips. Loading one
+// texture at a time can only spread each image's own work across the pool (and stb_image's PNG decode not at all),
+// while Texture2D::LoadMany hands whole images to the pool, one task each, so it scales with core count even when every
+// image is small. Throughput counts the bytes of the decoded top mips.
+DF_TEST_CASE(Texture2D_LoadManyProcessing)
+{
+	ThreadPool* const pThreadPool = ThreadPool::GetShared();
+
+	printf("    textures=%" PRIu32 ", size=%" PRIu32 ", workers=%" PRIu32 "\n", BenchmarkTextureCount, BenchmarkEdgeLength, pThreadPool->GetWorkerCount());
+
+	std::vector<BenchmarkTexture> textures(BenchmarkTextureCount);
+	std::vector<uint8_t> encoded(BenchmarkTextureCount, 0);
+
+	// Encoding is far slower than decoding, so spread it out to keep the setup short.
+	pThreadPool->ParallelFor(
+		BenchmarkTextureCount,
+		[&textures, &encoded](const size_t textureIndex)
+		{
+			encoded[textureIndex] = InitTexture(uint32_t(textureIndex), textures[textureIndex]) ? 1 : 0;
+		});
+
+	uint64_t batchSize = 0;
+	uint64_t fileSize = 0;
+
+	for(uint32_t textureIndex = 0; textureIndex < BenchmarkTextureCount; ++textureIndex)
+	{
+		DF_CHECK(encoded[textureIndex] != 0);
+
+		batchSize += textures[textureIndex].mipData[0].size();
+		fileSize += textures[textureIndex].fileData.size();
+	}
+
+	printf("    encodedSize=%" PRIu64 " KB, decodedSize=%" PRIu64 " KB\n", fileSize / 1024, batchSize / 1024);
+
+	auto processTexture = [&textures](const size_t textureIndex, ThreadPool* const pTexturePool)
+	{
+		BenchmarkTexture& texture = textures[textureIndex];
+
+		return DecodeTexture(texture, pTexturePool)
+			&& ImageResampler::GenerateMips(texture.mips, BenchmarkMipCount, texture.format, ImageResampler::Filter::Box, pTexturePool);
+	};
+
+	// Everything on the calling thread.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t textureIndex = 0; textureIndex < BenchmarkTextureCount; ++textureIndex)
+		{
+			DF_CHECK(processTexture(textureIndex, nullptr));
+		}
+
+		Test::ReportBenchmark("Texture batch (serial)", stopwatch.GetElapsedMs(), 1, batchSize);
+	}
+
+	// One texture at a time, each spreading its rows across the pool, like a loop of Texture2D::Load calls.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t textureIndex = 0; textureIndex < BenchmarkTextureCount; ++textureIndex)
+		{
+			DF_CHECK(processTexture(textureIndex, pThreadPool));
+		}
+
+		Test::ReportBenchmark("Texture batch (one at a time, pool per image)", stopwatch.GetElapsedMs(), 1, batchSize);
+	}
+
+	// One pool task per texture, like Texture2D::LoadMany.
+	{
+		std::vector<uint8_t> results(BenchmarkTextureCount, 0);
+
+		Utility::Stopwatch stopwatch;
+
+		pThreadPool->ParallelFor(
+			BenchmarkTextureCount,
+			[&processTexture, &results](const size_t textureIndex)
+			{
+				results[textureIndex] = processTexture(textureIndex, nullptr) ? 1 : 0;
+			});
+
+		Test::ReportBenchmark("Texture batch (LoadMany, task per image)", stopwatch.GetElapsedMs(), 1, batchSize);
+
+		for(const uint8_t result : results)
+		{
+			DF_CHECK(result != 0);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
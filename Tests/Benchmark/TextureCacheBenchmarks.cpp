@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Direct3D12/TextureCache.hpp>
+#include <DemoFramework/Utility/Hash.hpp>
+#include <DemoFramework/Utility/ImageResampler.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef D3D12::TextureCache TextureCache;
+typedef Utility::ImageResampler ImageResampler;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* const BenchmarkSourceFilePath = "texture-cache-benchmark.png";
+
+static constexpr uint32_t BenchmarkIterationCount = 4;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void AppendEncodedData(void* const pContext, void* const pData, const int size)
+{
+	std::vector<uint8_t>& output = *reinterpret_cast<std::vector<uint8_t>*>(pContext);
+	const uint8_t* const pBytes = reinterpret_cast<const uint8_t*>(pData);
+
+	output.insert(output.end(), pBytes, pBytes + size);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// The cache only reads the source file to hash its contents for the key.
+static bool WriteSourceFile(const std::vector<uint8_t>& data)
+{
+	FILE* const pFile = fopen(BenchmarkSourceFilePath, "wb");
+	if(!pFile)
+	{
+		return false;
+	}
+
+	const bool result = (fwrite(data.data(), data.size(), 1, pFile) == 1);
+
+	fclose(pFile);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Cold and warm loads of an RGBA8 PNG texture with a full mip chain. The cold path is everything Texture2D::Load does
+// on a cache miss: decoding the PNG with stb_image, building the mips and writing the cache entry. The warm path is what
+// replaces it on a cache hit: hashing the source, mapping the entry and copying it into staging.
+DF_TEST_CASE(TextureCache_ColdWarmLoad)
+{
+	TextureCache::Ptr cache = TextureCache::Create(".");
+	DF_CHECK(cache != nullptr);
+
+	if(!cache)
+	{
+		return;
+	}
+
+	const uint32_t edgeLengths[] = { 2048, 4096 };
+
+	for(const uint32_t edgeLength : edgeLengths)
+	{
+		uint32_t mipCount = 1;
+
+		while((edgeLength >> mipCount) > 0)
+		{
+			++mipCount;
+		}
+
+		std::vector<std::vector<uint8_t>> mipData(mipCount);
+		ImageResampler::Image mips[D3D12_REQ_MIP_LEVELS];
+		TextureCache::SourceSubresource subresources[D3D12_REQ_MIP_LEVELS];
+
+		uint64_t chainSize = 0;
+
+		for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+		{
+			const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+			const size_t rowPitch = size_t(mipEdgeLength) * 4;
+
+			mipData[mipIndex].resize(rowPitch * mipEdgeLength);
+
+			mips[mipIndex].pData = mipData[mipIndex].data();
+			mips[mipIndex].rowPitch = rowPitch;
+			mips[mipIndex].width = mipEdgeLength;
+			mips[mipIndex].height = mipEdgeLength;
+
+			subresources[mipIndex].pData = mipData[mipIndex].data();
+			subresources[mipIndex].rowPitch = rowPitch;
+			subresources[mipIndex].rowSize = rowPitch;
+			subresources[mipIndex].rowCount = mipEdgeLength;
+			subresources[mipIndex].width = mipEdgeLength;
+			subresources[mipIndex].height = mipEdgeLength;
+
+			chainSize += mipData[mipIndex].size();
+		}
+
+		Test::Random random(29);
+
+		// A noisy gradient compresses about as well as a typical material texture.
+		for(size_t i = 0; i < mipData[0].size(); ++i)
+		{
+			const uint32_t gradient = uint32_t(((i / 4) % edgeLength) * 192 / edgeLength);
+
+			mipData[0][i] = ((i % 4) == 3) ? 255 : uint8_t(gradient + random.Next(0, 15));
+		}
+
+		std::vector<uint8_t> fileData;
+
+		if(!stbi_write_png_to_func(AppendEncodedData, &fileData, int(edgeLength), int(edgeLength), 4, mipData[0].data(), int(mips[0].rowPitch))
+			|| !WriteSourceFile(fileData))
+		{
+			DF_CHECK(false);
+			return;
+		}
+
+		const uint64_t paramHash = Utility::Hash::Combine(uint64_t(edgeLength), uint64_t(mipCount));
+
+		TextureCache::Key key;
+
+		char benchmarkName[64];
+
+		// Decode and process the texture and store it, as on the first launch.
+		{
+			Utility::Stopwatch stopwatch;
+
+			for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+			{
+				DF_CHECK(cache->MakeKey(BenchmarkSourceFilePath, paramHash, key));
+
+				int width = 0;
+				int height = 0;
+
+				stbi_uc* const pPixels = stbi_load_from_memory(fileData.data(), int(fileData.size()), &width, &height, nullptr, 4);
+
+				DF_CHECK(pPixels != nullptr);
+				DF_CHECK(width == int(edgeLength) && height == int(edgeLength));
+
+				if(!pPixels)
+				{
+					break;
+				}
+
+				memcpy(mipData[0].data(), pPixels, mipData[0].size());
+				stbi_image_free(pPixels);
+
+				DF_CHECK(ImageResampler::GenerateMips(mips, mipCount, ImageResampler::Format::RGBA8Unorm, ImageResampler::Filter::Box, Utility::ThreadPool::GetShared()));
+				DF_CHECK(cache->Store(key, DXGI_FORMAT_R8G8B8A8_UNORM, edgeLength, edgeLength, mipCount, subresources));
+			}
+
+			snprintf(benchmarkName, sizeof(benchmarkName), "TextureCache cold %" PRIu32 " (decode + mips + store)", edgeLength);
+			Test::ReportBenchmark(benchmarkName, stopwatch.GetElapsedMs(), BenchmarkIterationCount, chainSize);
+		}
+
+		// Find the stored entry and copy it into staging memory, as on every later launch.
+		{
+			std::vector<uint8_t> staging;
+
+			Utility::Stopwatch stopwatch;
+
+			for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+			{
+				TextureCache::Entry entry;
+
+				DF_CHECK(cache->MakeKey(BenchmarkSourceFilePath, paramHash, key));
+				DF_CHECK(cache->Find(key, entry));
+				DF_CHECK(entry.mipCount == mipCount);
+
+				staging.resize(size_t(entry.dataSize));
+				memcpy(staging.data(), entry.pData, staging.size());
+			}
+
+			snprintf(benchmarkName, sizeof(benchmarkName), "TextureCache warm %" PRIu32 " (find + copy)", edgeLength);
+			Test::ReportBenchmark(benchmarkName, stopwatch.GetElapsedMs(), BenchmarkIterationCount, chainSize);
+
+			// The cached level 0 is the decoded source image, padded out to the D3D12 row pitch.
+			TextureCache::Entry entry;
+			DF_CHECK(cache->Find(key, entry));
+			DF_CHECK(memcmp(entry.pData + entry.pSubresources[0].offset, mipData[0].data(), size_t(entry.pSubresources[0].rowSize)) == 0);
+		}
+
+		// Entries are named after the path and parameter hashes.
+		char entryPath[64];
+		snprintf(entryPath, sizeof(entryPath), "./%016" PRIx64 DF_TEXTURE_CACHE_FILE_EXTENSION, Utility::Hash::Combine(key.pathHash, key.paramHash));
+
+		remove(entryPath);
+	}
+
+	remove(BenchmarkSourceFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/PageCache.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+#include <DemoFramework/Utility/VirtualPageTable.hpp>
+#include <DemoFramework/Utility/VirtualTextureFeedback.hpp>
+
+#include <stdio.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::PageCache PageCache;
+typedef Utility::VirtualPageTable VirtualPageTable;
+typedef Utility::VirtualTextureFeedback VirtualTextureFeedback;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// A 16K virtual texture in 128 texel pages, with a 32x32 slot page cache and a quarter-resolution 1080p feedback buffer.
+static constexpr uint32_t BenchmarkTextureSize = 16384;
+static constexpr uint32_t BenchmarkPageSize = 128;
+static constexpr uint32_t BenchmarkMipCount = 8;
+static constexpr uint32_t BenchmarkSlotCountX = 32;
+static constexpr uint32_t BenchmarkSlotCount = BenchmarkSlotCountX * BenchmarkSlotCountX;
+static constexpr uint32_t BenchmarkFeedbackWidth = 480;
+static constexpr uint32_t BenchmarkFeedbackHeight = 270;
+static constexpr uint32_t BenchmarkMaxUploadCount = 64;
+static constexpr uint32_t BenchmarkFrameCount = 500;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fill the feedback buffer the way a camera looking across a large textured ground plane would: the bottom rows see
+// the most detailed mips up close and the top rows see the least detailed ones in the distance. The view pans a little
+// every frame, so each frame requests a band of new pages and the cache keeps having to evict old ones.
+static void FillFeedback(const VirtualPageTable& pageTable, const uint32_t frameIndex, std::vector<uint32_t>& outTexels)
+{
+	outTexels.resize(size_t(BenchmarkFeedbackWidth) * BenchmarkFeedbackHeight);
+
+	for(uint32_t y = 0; y < BenchmarkFeedbackHeight; ++y)
+	{
+		const uint32_t mipIndex = ((BenchmarkFeedbackHeight - 1 - y) * BenchmarkMipCount) / BenchmarkFeedbackHeight;
+
+		const uint32_t pageCountX = pageTable.GetPageCountX(mipIndex);
+		const uint32_t pageCountY = pageTable.GetPageCountY(mipIndex);
+
+		// Texels further away cover more of the texture, so the pan moves through fewer pages on less detailed mips.
+		const uint32_t pageY = ((y * pageCountY) / BenchmarkFeedbackHeight + (frameIndex >> mipIndex)) % pageCountY;
+
+		uint32_t* const pRow = outTexels.data() + (size_t(y) * BenchmarkFeedbackWidth);
+
+		for(uint32_t x = 0; x < BenchmarkFeedbackWidth; ++x)
+		{
+			const uint32_t pageX = ((x * pageCountX) / (BenchmarkFeedbackWidth * 4) + (frameIndex >> (mipIndex + 1))) % pageCountX;
+
+			pRow[x] = VirtualPageTable::MakePageId(mipIndex, pageX, pageY);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(VirtualTexture_PageRequests)
+{
+	VirtualPageTable pageTable;
+	PageCache pageCache;
+	VirtualTextureFeedback feedback;
+
+	DF_CHECK(pageTable.Reset(BenchmarkTextureSize, BenchmarkTextureSize, BenchmarkPageSize, BenchmarkMipCount));
+	DF_CHECK(pageCache.Reset(BenchmarkSlotCount));
+
+	std::vector<std::vector<uint32_t>> feedbackFrames(BenchmarkFrameCount);
+	std::vector<uint32_t> indirection(pageTable.GetIndirectionSize());
+
+	// The feedback is generated up front so only the request processing is timed.
+	for(uint32_t frameIndex = 0; frameIndex < BenchmarkFrameCount; ++frameIndex)
+	{
+		FillFeedback(pageTable, frameIndex, feedbackFrames[frameIndex]);
+	}
+
+	uint64_t requestCount = 0;
+	uint64_t uploadCount = 0;
+	uint64_t evictCount = 0;
+
+	Utility::Stopwatch stopwatch;
+
+	// The same steps VirtualTexture::Update() takes each frame, minus the GPU work.
+	for(uint32_t frameIndex = 0; frameIndex < BenchmarkFrameCount; ++frameIndex)
+	{
+		const uint64_t cacheFrame = uint64_t(frameIndex) + 1;
+
+		feedback.Clear();
+		feedback.Parse(
+			feedbackFrames[frameIndex].data(),
+			BenchmarkFeedbackWidth,
+			BenchmarkFeedbackHeight,
+			BenchmarkFeedbackWidth * sizeof(uint32_t),
+			pageTable);
+		feedback.Resolve(pageTable);
+
+		const VirtualPageTable::PageId* const pUsedPages = feedback.GetUsedPages();
+
+		for(size_t pageIndex = 0; pageIndex < feedback.GetUsedPageCount(); ++pageIndex)
+		{
+			const VirtualPageTable::SlotIndex slot = pageCache.Find(pUsedPages[pageIndex]);
+			if(slot != VirtualPageTable::InvalidSlot)
+			{
+				pageCache.Touch(slot, cacheFrame);
+			}
+		}
+
+		const VirtualTextureFeedback::Request* const pRequests = feedback.GetRequests();
+
+		requestCount += feedback.GetRequestCount();
+
+		for(size_t requestIndex = 0; requestIndex < feedback.GetRequestCount() && requestIndex < BenchmarkMaxUploadCount; ++requestIndex)
+		{
+			VirtualPageTable::PageId evictedPageId;
+			const VirtualPageTable::SlotIndex slot = pageCache.Allocate(pRequests[requestIndex].pageId, cacheFrame, evictedPageId);
+
+			if(slot == VirtualPageTable::InvalidSlot)
+			{
+				break;
+			}
+
+			if(evictedPageId != VirtualPageTable::InvalidPageId)
+			{
+				pageTable.Unmap(evictedPageId);
+				++evictCount;
+			}
+
+			pageTable.Map(pRequests[requestIndex].pageId, slot);
+			++uploadCount;
+		}
+
+		if(pageTable.IsDirty())
+		{
+			pageTable.BuildIndirection(BenchmarkSlotCountX, indirection.data());
+		}
+	}
+
+	Test::ReportBenchmark(
+		"VirtualTexture page requests (per frame)",
+		stopwatch.GetElapsedMs(),
+		BenchmarkFrameCount,
+		uint64_t(BenchmarkFeedbackWidth) * BenchmarkFeedbackHeight * sizeof(uint32_t));
+
+	printf("    requests=%" PRIu64 ", uploads=%" PRIu64 ", evictions=%" PRIu64 "\n", requestCount, uploadCount, evictCount);
+
+	// The pan has to keep the cache busy for the numbers above to mean anything.
+	DF_CHECK(uploadCount > BenchmarkSlotCount);
+	DF_CHECK(evictCount > 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_Operations)
+{
+	// Single operations are too quick to time, so they're reported in batches.
+	constexpr uint32_t batchCount = 1000;
+	constexpr uint32_t operationCount = batchCount * 1024;
+
+	PageCache pageCache;
+	pageCache.Reset(BenchmarkSlotCount);
+
+	Test::Random random(41);
+
+	std::vector<VirtualPageTable::SlotIndex> slots(operationCount);
+
+	for(VirtualPageTable::SlotIndex& slot : slots)
+	{
+		slot = random.Next(0, BenchmarkSlotCount - 1);
+	}
+
+	VirtualPageTable::PageId evictedPageId;
+
+	// Every allocation after the cache fills up evicts the least recently used page.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t index = 0; index < operationCount; ++index)
+		{
+			pageCache.Allocate(index, uint64_t(index) + 1, evictedPageId);
+		}
+
+		Test::ReportBenchmark("PageCache::Allocate (evicting, per 1024)", stopwatch.GetElapsedMs(), batchCount);
+	}
+
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t index = 0; index < operationCount; ++index)
+		{
+			pageCache.Touch(slots[index], uint64_t(operationCount) + index);
+		}
+
+		Test::ReportBenchmark("PageCache::Touch (per 1024)", stopwatch.GetElapsedMs(), batchCount);
+	}
+
+	// Unpinning walks the list to put the slot back where it belongs, so this is the one operation that isn't
+	// constant time. Half the slots are pinned at a time to keep the walk representative.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t index = 0; index < operationCount; ++index)
+		{
+			const bool pinned = (index / BenchmarkSlotCount) % 2 == 0;
+
+			pageCache.SetPinned(slots[index], pinned);
+		}
+
+		Test::ReportBenchmark("PageCache::SetPinned (per 1024)", stopwatch.GetElapsedMs(), batchCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
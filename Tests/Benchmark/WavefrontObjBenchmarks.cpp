@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Direct3D12/WavefrontObjIndex.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+
+#include <tiny_obj_loader.h>
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef D3D12::WavefrontObjIndex WavefrontObjIndex;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* const BenchmarkObjFilePath = "wavefront-obj-benchmark.obj";
+
+static constexpr uint32_t BenchmarkObjectCount = 128;
+static constexpr uint32_t BenchmarkGridSize = 64;
+static constexpr uint32_t BenchmarkIterationCount = 4;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Write a large OBJ file made of many separate grid objects, similar to a scene exported from a DCC tool. Returns the
+// size of the file in bytes, or zero on failure.
+static uint64_t WriteBenchmarkFile()
+{
+	FILE* const pFile = fopen(BenchmarkObjFilePath, "wb");
+	if(!pFile)
+	{
+		return 0;
+	}
+
+	constexpr uint32_t vertexCount = (BenchmarkGridSize + 1) * (BenchmarkGridSize + 1);
+
+	std::string text;
+	char line[128];
+
+	uint64_t fileSize = 0;
+	bool result = true;
+
+	for(uint32_t objectIndex = 0; result && objectIndex < BenchmarkObjectCount; ++objectIndex)
+	{
+		const uint32_t vertexBase = (objectIndex * vertexCount) + 1;
+
+		text.clear();
+
+		snprintf(line, sizeof(line), "o object_%u\n", objectIndex);
+		text += line;
+
+		for(uint32_t y = 0; y <= BenchmarkGridSize; ++y)
+		{
+			for(uint32_t x = 0; x <= BenchmarkGridSize; ++x)
+			{
+				snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", float64_t(x) * 0.125, float64_t(objectIndex), float64_t(y) * 0.125);
+				text += line;
+			}
+		}
+
+		for(uint32_t y = 0; y <= BenchmarkGridSize; ++y)
+		{
+			for(uint32_t x = 0; x <= BenchmarkGridSize; ++x)
+			{
+				snprintf(line, sizeof(line), "vt %.6f %.6f\n", float64_t(x) / BenchmarkGridSize, float64_t(y) / BenchmarkGridSize);
+				text += line;
+			}
+		}
+
+		for(uint32_t y = 0; y < BenchmarkGridSize; ++y)
+		{
+			for(uint32_t x = 0; x < BenchmarkGridSize; ++x)
+			{
+				const uint32_t i0 = vertexBase + (y * (BenchmarkGridSize + 1)) + x;
+				const uint32_t i1 = i0 + 1;
+				const uint32_t i2 = i1 + BenchmarkGridSize + 1;
+				const uint32_t i3 = i0 + BenchmarkGridSize + 1;
+
+				snprintf(line, sizeof(line), "f %u/%u %u/%u %u/%u %u/%u\n", i0, i0, i1, i1, i2, i2, i3, i3);
+				text += line;
+			}
+		}
+
+		result = (fwrite(text.data(), 1, text.size(), pFile) == text.size());
+		fileSize += text.size();
+	}
+
+	fclose(pFile);
+
+	return result ? fileSize : 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Parse the first few shapes of the benchmark file through the index, the same way a shape-filtered OBJ load does.
+static bool ParseFirstShapes(const WavefrontObjIndex& index, const size_t shapeCount)
+{
+	FILE* const pFile = fopen(BenchmarkObjFilePath, "rb");
+	if(!pFile)
+	{
+		return false;
+	}
+
+	std::vector<const WavefrontObjIndex::Shape*> selectedShapes;
+
+	for(size_t i = 0; i < shapeCount && i < index.GetShapes().size(); ++i)
+	{
+		selectedShapes.push_back(&index.GetShapes()[i]);
+	}
+
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+
+	const bool result = index.ParseShapes(pFile, selectedShapes, attrib, shapes);
+	fclose(pFile);
+
+	return result && (shapes.size() == selectedShapes.size());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(WavefrontObj_LoadPaths)
+{
+	const uint64_t fileSize = WriteBenchmarkFile();
+	DF_CHECK(fileSize > 0);
+
+	if(fileSize == 0)
+	{
+		return;
+	}
+
+	const std::string indexFilePath = std::string(BenchmarkObjFilePath) + DF_OBJ_INDEX_FILE_EXTENSION;
+
+	// Full load of every shape through tinyobjloader, which is what an unfiltered OBJ load does.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+		{
+			tinyobj::attrib_t attrib;
+			std::vector<tinyobj::shape_t> shapes;
+			std::vector<tinyobj::material_t> materials;
+			std::string warnings;
+			std::string errors;
+
+			DF_CHECK(tinyobj::LoadObj(&attrib, &shapes, &materials, &warnings, &errors, BenchmarkObjFilePath, nullptr, false, false));
+			DF_CHECK(shapes.size() == BenchmarkObjectCount);
+		}
+
+		Test::ReportBenchmark("tinyobj::LoadObj (all shapes)", stopwatch.GetElapsedMs(), BenchmarkIterationCount, fileSize);
+	}
+
+	// Scan the entire file to build its index. This only happens when the sidecar index is missing or stale.
+	{
+		Utility::Stopwatch stopwatch;
+
+		for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+		{
+			const WavefrontObjIndex::Ptr index = WavefrontObjIndex::Build(BenchmarkObjFilePath);
+
+			DF_CHECK(index != nullptr && index->GetShapes().size() == BenchmarkObjectCount);
+		}
+
+		Test::ReportBenchmark("WavefrontObjIndex::Build", stopwatch.GetElapsedMs(), BenchmarkIterationCount, fileSize);
+	}
+
+	remove(indexFilePath.c_str());
+
+	const WavefrontObjIndex::Ptr index = WavefrontObjIndex::LoadOrBuild(BenchmarkObjFilePath);
+	DF_CHECK(index != nullptr);
+
+	if(index)
+	{
+		// Load the saved sidecar index.
+		{
+			Utility::Stopwatch stopwatch;
+
+			for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+			{
+				DF_CHECK(WavefrontObjIndex::LoadOrBuild(BenchmarkObjFilePath) != nullptr);
+			}
+
+			Test::ReportBenchmark("WavefrontObjIndex::LoadOrBuild (cached)", stopwatch.GetElapsedMs(), BenchmarkIterationCount);
+		}
+
+		// Parse only a subset of the shapes through the index.
+		const size_t parsedShapeCounts[] = { 1, 8 };
+
+		for(const size_t parsedShapeCount : parsedShapeCounts)
+		{
+			char benchmarkName[64];
+			snprintf(benchmarkName, sizeof(benchmarkName), "WavefrontObjIndex::ParseShapes (%zu shapes)", parsedShapeCount);
+
+			Utility::Stopwatch stopwatch;
+
+			for(uint32_t i = 0; i < BenchmarkIterationCount; ++i)
+			{
+				DF_CHECK(ParseFirstShapes(*index, parsedShapeCount));
+			}
+
+			Test::ReportBenchmark(benchmarkName, stopwatch.GetElapsedMs(), BenchmarkIterationCount);
+		}
+	}
+
+	remove(indexFilePath.c_str());
+	remove(BenchmarkObjFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "TestFramework.hpp"
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/Stopwatch.hpp>
+#include <DemoFramework/Utility/ThreadPool.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace Test
+{
+	// Cases are chained together as they register since the order of static initialization across translation
+	// units isn't something a container could safely depend on.
+	static Case* s_pFirstCase = nullptr;
+	static Case* s_pLastCase = nullptr;
+
+	static uint32_t s_failedCheckCount = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+Test::Registrar::Registrar(Case& testCase)
+{
+	testCase.pNext = nullptr;
+
+	if(s_pLastCase)
+	{
+		s_pLastCase->pNext = &testCase;
+	}
+	else
+	{
+		s_pFirstCase = &testCase;
+	}
+
+	s_pLastCase = &testCase;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void Test::Fail(const char* const file, const int line, const char* const expression)
+{
+	// Only report the first few failures of each case so a broken loop doesn't bury everything else.
+	if(s_failedCheckCount < 16)
+	{
+		printf("    %s(%d): check failed: %s\n", file, line, expression);
+	}
+
+	++s_failedCheckCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32_t Test::RunCases(const char* const filter)
+{
+	uint32_t runCount = 0;
+	uint32_t failedCount = 0;
+
+	for(Case* pCase = s_pFirstCase; pCase; pCase = pCase->pNext)
+	{
+		if(filter && filter[0] != '\0' && !strstr(pCase->name, filter))
+		{
+			continue;
+		}
+
+		printf("[ RUN  ] %s\n", pCase->name);
+		fflush(stdout);
+
+		s_failedCheckCount = 0;
+		pCase->func();
+
+		if(s_failedCheckCount > 0)
+		{
+			printf("[ FAIL ] %s (%" PRIu32 " failed checks)\n", pCase->name, s_failedCheckCount);
+			++failedCount;
+		}
+		else
+		{
+			printf("[  OK  ] %s\n", pCase->name);
+		}
+
+		fflush(stdout);
+		++runCount;
+	}
+
+	printf("%" PRIu32 " of %" PRIu32 " cases passed\n", runCount - failedCount, runCount);
+
+	return failedCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void Test::ReportBenchmark(
+	const char* const name,
+	const float64_t totalMs,
+	const uint32_t iterationCount,
+	const uint64_t bytesPerIteration)
+{
+	const float64_t iterationMs = (iterationCount > 0) ? (totalMs / float64_t(iterationCount)) : 0.0;
+
+	if(bytesPerIteration > 0 && iterationMs > 0.0)
+	{
+		const float64_t gbPerSecond = float64_t(bytesPerIteration) / (iterationMs * 1.0e6);
+
+		printf("    %-48s %10.3f ms %9.2f GB/s\n", name, iterationMs, gbPerSecond);
+	}
+	else
+	{
+		printf("    %-48s %10.3f ms\n", name, iterationMs);
+	}
+
+	fflush(stdout);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void Test::RunBenchmarkVariants(
+	const char* const name,
+	const uint32_t iterationCount,
+	const uint64_t bytesPerIteration,
+	const BenchmarkFunc& func,
+	const bool threaded)
+{
+	typedef DemoFramework::Utility::CpuFeatures CpuFeatures;
+	typedef DemoFramework::Utility::ThreadPool ThreadPool;
+
+	ThreadPool* const threadPools[] = { nullptr, threaded ? ThreadPool::GetShared() : nullptr };
+	const size_t threadPoolCount = threaded ? 2 : 1;
+
+	for(const bool baselineOnly : { true, false })
+	{
+		for(size_t threadPoolIndex = 0; threadPoolIndex < threadPoolCount; ++threadPoolIndex)
+		{
+			ThreadPool* const pThreadPool = threadPools[threadPoolIndex];
+
+			CpuFeatures::SetBaselineOnly(baselineOnly);
+
+			DemoFramework::Utility::Stopwatch stopwatch;
+
+			for(uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				func(pThreadPool);
+			}
+
+			const float64_t elapsedMs = stopwatch.GetElapsedMs();
+
+			CpuFeatures::SetBaselineOnly(false);
+
+			char benchmarkName[96];
+
+			if(threaded)
+			{
+				snprintf(
+					benchmarkName,
+					sizeof(benchmarkName),
+					"%s (%s, %s)",
+					name,
+					baselineOnly ? "baseline" : "native",
+					pThreadPool ? "pool" : "1 thread");
+			}
+			else
+			{
+				snprintf(benchmarkName, sizeof(benchmarkName), "%s (%s)", name, baselineOnly ? "baseline" : "native");
+			}
+
+			ReportBenchmark(benchmarkName, elapsedMs, iterationCount, bytesPerIteration);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	const char* const filter = (argc > 1) ? argv[1] : nullptr;
+
+	return (Test::RunCases(filter) == 0) ? 0 : 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#pragma once
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <DemoFramework/BuildSetup.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace DemoFramework { namespace Utility {
+	class ThreadPool;
+}}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Minimal self-registering test harness shared by the unit test and benchmark applications. Each case is a plain
+// function registered at static initialization time, and the runner executes every case whose name contains the
+// filter given on the command line. Checks don't abort the case they're in, so a single run reports every failure.
+namespace Test
+{
+	typedef void (*CaseFunc)();
+
+	struct Case
+	{
+		const char* name;
+		CaseFunc func;
+		Case* pNext;
+	};
+
+	struct Registrar
+	{
+		explicit Registrar(Case& testCase);
+	};
+
+	// Record a failed check against the case currently running.
+	void Fail(const char* file, int line, const char* expression);
+
+	// Run every registered case whose name contains the filter, in registration order. A null or empty filter runs
+	// everything. Returns the number of cases that failed.
+	uint32_t RunCases(const char* filter);
+
+	// Log a benchmark result as the average time per iteration and, when a byte count is given, the throughput.
+	void ReportBenchmark(const char* name, float64_t totalMs, uint32_t iterationCount, uint64_t bytesPerIteration = 0);
+
+	typedef std::function<void(DemoFramework::Utility::ThreadPool*)> BenchmarkFunc;
+
+	// Time and report an operation on the baseline and native SIMD paths, each on the calling thread (a null thread
+	// pool) and on the shared thread pool. Operations that can't use a thread pool pass 'threaded' as false to only
+	// run on the calling thread. The native path is restored before returning.
+	void RunBenchmarkVariants(
+		const char* name,
+		uint32_t iterationCount,
+		uint64_t bytesPerIteration,
+		const BenchmarkFunc& func,
+		bool threaded = true);
+
+	// Small xorshift generator so randomized cases see the same inputs on every run and every platform.
+	class Random
+	{
+	public:
+
+		explicit Random(uint64_t seed);
+
+		uint32_t Next();
+
+		// Uniform value in [minValue, maxValue].
+		uint32_t Next(uint32_t minValue, uint32_t maxValue);
+
+
+	private:
+
+		uint64_t m_state;
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define DF_TEST_CASE(name) \
+	static void name(); \
+	static Test::Case _dfTestCase_##name = { #name, name, nullptr }; \
+	static const Test::Registrar _dfTestRegistrar_##name(_dfTestCase_##name); \
+	static void name()
+
+#define DF_CHECK(expression) \
+	do \
+	{ \
+		if(!(expression)) \
+		{ \
+			Test::Fail(__FILE__, __LINE__, #expression); \
+		} \
+	} while(false)
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline Test::Random::Random(const uint64_t seed)
+	: m_state((seed != 0) ? seed : 0x9E3779B97F4A7C15ull)
+{
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t Test::Random::Next()
+{
+	m_state ^= m_state << 13;
+	m_state ^= m_state >> 7;
+	m_state ^= m_state << 17;
+
+	return uint32_t(m_state >> 32);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline uint32_t Test::Random::Next(const uint32_t minValue, const uint32_t maxValue)
+{
+	const uint64_t range = uint64_t(maxValue) - uint64_t(minValue) + 1;
+
+	return minValue + uint32_t(uint64_t(Next()) % range);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
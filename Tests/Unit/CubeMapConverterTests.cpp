@@ -0,0 +1,253 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/CubeMapConverter.hpp>
+#include <DemoFramework/Utility/ThreadPool.hpp>
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::CubeMapConverter CubeMapConverter;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct TestEquirect
+{
+	std::vector<float> texels;
+	ImageResampler::ConstImage image;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct TestCube
+{
+	std::vector<float> texels;
+	std::vector<ImageResampler::Image> faces;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fill an equirect with random HDR colors.
+static void MakeTestEquirect(const uint32_t width, const uint32_t height, const uint64_t seed, TestEquirect& outEquirect)
+{
+	Test::Random random(seed);
+
+	outEquirect.texels.resize(size_t(width) * height * 4);
+
+	for(float& value : outEquirect.texels)
+	{
+		value = (float(random.Next()) / float(0xFFFFFFFFu)) * 4.0f;
+	}
+
+	outEquirect.image.pData = reinterpret_cast<const uint8_t*>(outEquirect.texels.data());
+	outEquirect.image.rowPitch = size_t(width) * sizeof(float) * 4;
+	outEquirect.image.width = width;
+	outEquirect.image.height = height;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Allocate every mip of every face, with rows padded so the row pitch differs from the packed width.
+static void MakeTestCube(const uint32_t edgeLength, const uint32_t mipCount, TestCube& outCube)
+{
+	size_t floatCount = 0;
+
+	for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+
+		floatCount += (size_t(mipEdgeLength) + 3) * 4 * mipEdgeLength;
+	}
+
+	outCube.texels.assign(floatCount * DF_CUBE_MAP_FACE_COUNT, 0.0f);
+	outCube.faces.resize(size_t(mipCount) * DF_CUBE_MAP_FACE_COUNT);
+
+	size_t offset = 0;
+
+	for(uint32_t faceIndex = 0; faceIndex < DF_CUBE_MAP_FACE_COUNT; ++faceIndex)
+	{
+		for(uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+		{
+			const uint32_t mipEdgeLength = edgeLength >> mipIndex;
+			const size_t rowFloatCount = (size_t(mipEdgeLength) + 3) * 4;
+
+			ImageResampler::Image& face = outCube.faces[(faceIndex * mipCount) + mipIndex];
+
+			face.pData = reinterpret_cast<uint8_t*>(outCube.texels.data() + offset);
+			face.rowPitch = rowFloatCount * sizeof(float);
+			face.width = mipEdgeLength;
+			face.height = mipEdgeLength;
+
+			offset += rowFloatCount * mipEdgeLength;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetMipCount(const uint32_t edgeLength)
+{
+	uint32_t mipCount = 1;
+
+	while((edgeLength >> mipCount) > 0)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool ConvertWith(
+	const TestEquirect& equirect,
+	const uint32_t edgeLength,
+	const uint32_t mipCount,
+	ThreadPool* const pThreadPool,
+	const bool baselineOnly,
+	TestCube& outCube)
+{
+	MakeTestCube(edgeLength, mipCount, outCube);
+
+	CpuFeatures::SetBaselineOnly(baselineOnly);
+	const bool result = CubeMapConverter::Convert(equirect.image, outCube.faces.data(), edgeLength, mipCount, pThreadPool);
+	CpuFeatures::SetBaselineOnly(false);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(CubeMapConverter_Validation)
+{
+	TestEquirect equirect;
+	MakeTestEquirect(64, 32, 1, equirect);
+
+	TestCube cube;
+	MakeTestCube(8, 4, cube);
+
+	DF_CHECK(CubeMapConverter::Convert(equirect.image, cube.faces.data(), 8, 4, nullptr));
+	DF_CHECK(!CubeMapConverter::Convert(equirect.image, nullptr, 8, 4, nullptr));
+	DF_CHECK(!CubeMapConverter::Convert(equirect.image, cube.faces.data(), 0, 4, nullptr));
+	DF_CHECK(!CubeMapConverter::Convert(equirect.image, cube.faces.data(), 8, 0, nullptr));
+	DF_CHECK(!CubeMapConverter::Convert(equirect.image, cube.faces.data(), 8, 5, nullptr));
+
+	ImageResampler::ConstImage badEquirect = equirect.image;
+	badEquirect.rowPitch = 63 * sizeof(float) * 4;
+	DF_CHECK(!CubeMapConverter::Convert(badEquirect, cube.faces.data(), 8, 4, nullptr));
+
+	cube.faces[5].width = 2;
+	DF_CHECK(!CubeMapConverter::Convert(equirect.image, cube.faces.data(), 8, 4, nullptr));
+	DF_CHECK(!CubeMapConverter::GenerateMips(cube.faces.data(), 8, 4, nullptr));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(CubeMapConverter_Deterministic)
+{
+	const ThreadPool::Ptr singleThreadPool = ThreadPool::Create(1);
+	const ThreadPool::Ptr multiThreadPool = ThreadPool::Create(8);
+
+	// Equirects both smaller and larger than the cube, so some conversions sample a reduced copy of the source.
+	const uint32_t equirectSizes[][2] =
+	{
+		{ 64,   32 },
+		{ 333,  171 },
+		{ 1024, 512 },
+	};
+
+	// Edge lengths around the 8-wide AVX2 kernel and the rows-per-task split.
+	const uint32_t edgeLengths[] = { 1, 7, 8, 37, 64, 130 };
+
+	for(const auto& equirectSize : equirectSizes)
+	{
+		TestEquirect equirect;
+		MakeTestEquirect(equirectSize[0], equirectSize[1], 49 + equirectSize[0], equirect);
+
+		for(const uint32_t edgeLength : edgeLengths)
+		{
+			const uint32_t mipCount = GetMipCount(edgeLength);
+
+			// Everything is compared against the scalar kernels on the calling thread.
+			TestCube expected;
+			DF_CHECK(ConvertWith(equirect, edgeLength, mipCount, nullptr, true, expected));
+
+			for(const bool baselineOnly : { true, false })
+			{
+				ThreadPool* const threadPools[] = { nullptr, singleThreadPool.get(), multiThreadPool.get() };
+
+				for(ThreadPool* const pThreadPool : threadPools)
+				{
+					TestCube cube;
+					DF_CHECK(ConvertWith(equirect, edgeLength, mipCount, pThreadPool, baselineOnly, cube));
+					DF_CHECK(memcmp(cube.texels.data(), expected.texels.data(), expected.texels.size() * sizeof(float)) == 0);
+				}
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(CubeMapConverter_ConstantColor)
+{
+	const float color[4] = { 0.25f, 1.5f, 3.0f, 1.0f };
+
+	TestEquirect equirect;
+	MakeTestEquirect(256, 128, 1, equirect);
+
+	for(size_t i = 0; i < equirect.texels.size(); ++i)
+	{
+		equirect.texels[i] = color[i % 4];
+	}
+
+	// Every texel of every mip is a weighted average of the same color.
+	for(const uint32_t edgeLength : { 4u, 32u, 256u })
+	{
+		const uint32_t mipCount = GetMipCount(edgeLength);
+
+		TestCube cube;
+		DF_CHECK(ConvertWith(equirect, edgeLength, mipCount, nullptr, false, cube));
+
+		for(const ImageResampler::Image& face : cube.faces)
+		{
+			for(uint32_t y = 0; y < face.height; ++y)
+			{
+				const float* const pRow = reinterpret_cast<const float*>(face.pData + (face.rowPitch * y));
+
+				for(uint32_t x = 0; x < face.width * 4; ++x)
+				{
+					DF_CHECK(fabsf(pRow[x] - color[x % 4]) <= color[x % 4] * 1.0e-5f);
+				}
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/MipStreamScheduler.hpp>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::MipStreamScheduler MipStreamScheduler;
+typedef MipStreamScheduler::RowCopy RowCopy;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint64_t TestRowPitch = 256;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Give every mip from 'firstMip' up to (not including) 'endMip' a layout, halving the row count with each mip, and
+// mark it ready.
+static void QueueMips(
+	MipStreamScheduler& scheduler,
+	const uint32_t firstMip,
+	const uint32_t endMip,
+	const uint32_t baseRowCount)
+{
+	for(uint32_t mipIndex = firstMip; mipIndex < endMip; ++mipIndex)
+	{
+		const uint32_t rowCount = ((baseRowCount >> mipIndex) > 0) ? (baseRowCount >> mipIndex) : 1;
+
+		DF_CHECK(scheduler.SetMipLayout(mipIndex, TestRowPitch, rowCount));
+		DF_CHECK(scheduler.MarkMipReady(mipIndex));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Update until nothing is pending, checking that each frame stays inside its budget. Returns every copy in the order
+// it was recorded.
+static std::vector<RowCopy> DrainScheduler(
+	MipStreamScheduler& scheduler,
+	const uint64_t byteBudget,
+	const uint64_t rowPitch,
+	uint32_t* const pOutFrameCount = nullptr)
+{
+	std::vector<RowCopy> allCopies;
+
+	RowCopy copies[DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT];
+
+	uint32_t frameIndex = 0;
+
+	for(; scheduler.GetPendingBytes() > 0; ++frameIndex)
+	{
+		const size_t copyCount = scheduler.Update(byteBudget, copies, DF_ARRAY_LENGTH(copies));
+
+		DF_CHECK(copyCount > 0);
+		DF_CHECK(frameIndex < 100000);
+
+		if(copyCount == 0 || frameIndex >= 100000)
+		{
+			break;
+		}
+
+		uint64_t frameBytes = 0;
+
+		for(size_t i = 0; i < copyCount; ++i)
+		{
+			DF_CHECK(copies[i].rowCount > 0);
+
+			frameBytes += rowPitch * copies[i].rowCount;
+			allCopies.push_back(copies[i]);
+		}
+
+		// A single row is always allowed through so the upload makes progress, even when it's over budget.
+		DF_CHECK(frameBytes <= byteBudget || (copyCount == 1 && copies[0].rowCount == 1));
+	}
+
+	if(pOutFrameCount)
+	{
+		*pOutFrameCount = frameIndex;
+	}
+
+	return allCopies;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_InvalidRequests)
+{
+	MipStreamScheduler scheduler;
+
+	DF_CHECK(!scheduler.Reset(0, 0, 1));
+	DF_CHECK(!scheduler.Reset(DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT + 1, 0, 1));
+	DF_CHECK(!scheduler.Reset(4, 4, 1));
+
+	DF_CHECK(scheduler.Reset(8, 5, 2));
+	DF_CHECK(scheduler.GetResidentMip() == 5);
+	DF_CHECK(!scheduler.IsFullyResident());
+
+	// Resident mips and mips past the end of the chain can't be streamed.
+	DF_CHECK(!scheduler.SetMipLayout(5, TestRowPitch, 4));
+	DF_CHECK(!scheduler.SetMipLayout(8, TestRowPitch, 4));
+	DF_CHECK(!scheduler.MarkMipReady(5));
+	DF_CHECK(!scheduler.MarkMipReady(8));
+
+	// A mip needs a valid layout before it can be marked ready.
+	DF_CHECK(!scheduler.SetMipLayout(3, 0, 4));
+	DF_CHECK(!scheduler.SetMipLayout(3, TestRowPitch, 0));
+	DF_CHECK(!scheduler.MarkMipReady(3));
+
+	DF_CHECK(scheduler.SetMipLayout(3, TestRowPitch, 8));
+	DF_CHECK(scheduler.MarkMipReady(3));
+	DF_CHECK(scheduler.GetPendingBytes() == TestRowPitch * 8);
+
+	// Once queued, a mip can't be queued again or have its layout changed.
+	DF_CHECK(!scheduler.MarkMipReady(3));
+	DF_CHECK(!scheduler.SetMipLayout(3, TestRowPitch, 16));
+	DF_CHECK(scheduler.GetPendingBytes() == TestRowPitch * 8);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_ByteBudget)
+{
+	MipStreamScheduler scheduler;
+	DF_CHECK(scheduler.Reset(6, 5, 1));
+
+	QueueMips(scheduler, 0, 5, 64);
+
+	const uint64_t totalBytes = scheduler.GetPendingBytes();
+	DF_CHECK(totalBytes == TestRowPitch * (64 + 32 + 16 + 8 + 4));
+
+	const uint64_t byteBudget = TestRowPitch * 5;
+
+	uint32_t frameCount = 0;
+	const std::vector<RowCopy> copies = DrainScheduler(scheduler, byteBudget, TestRowPitch, &frameCount);
+
+	uint64_t copiedBytes = 0;
+
+	for(const RowCopy& copy : copies)
+	{
+		copiedBytes += TestRowPitch * copy.rowCount;
+	}
+
+	DF_CHECK(copiedBytes == totalBytes);
+	DF_CHECK(scheduler.GetPendingBytes() == 0);
+
+	// The budget is a whole number of rows, so every frame but the last one should use all of it, even when that means
+	// finishing one mip and starting the next in the same frame.
+	DF_CHECK(frameCount == (totalBytes + byteBudget - 1) / byteBudget);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_RowBandSplitting)
+{
+	const uint64_t rowPitch = 1000;
+	const uint32_t rowCount = 50;
+
+	// Budgets that are not a whole number of rows are rounded down to whole rows, and budgets smaller than a single row
+	// still move one row per frame.
+	const uint64_t byteBudgets[] = { 4096, 1000, 10, 1000000 };
+
+	for(const uint64_t byteBudget : byteBudgets)
+	{
+		MipStreamScheduler scheduler;
+		DF_CHECK(scheduler.Reset(2, 1, 1));
+
+		DF_CHECK(scheduler.SetMipLayout(0, rowPitch, rowCount));
+		DF_CHECK(scheduler.MarkMipReady(0));
+
+		const std::vector<RowCopy> copies = DrainScheduler(scheduler, byteBudget, rowPitch);
+
+		const uint32_t expectedRowsPerCopy = (byteBudget >= rowPitch) ? uint32_t(byteBudget / rowPitch) : 1;
+
+		uint32_t nextRow = 0;
+
+		for(size_t i = 0; i < copies.size(); ++i)
+		{
+			const RowCopy& copy = copies[i];
+			const bool lastCopy = (i + 1 == copies.size());
+
+			DF_CHECK(copy.mipIndex == 0);
+			DF_CHECK(copy.firstRow == nextRow);
+			DF_CHECK(copy.lastCopy == lastCopy);
+			DF_CHECK(copy.rowCount <= expectedRowsPerCopy);
+			DF_CHECK(lastCopy || copy.rowCount == expectedRowsPerCopy);
+
+			nextRow = copy.firstRow + copy.rowCount;
+		}
+
+		DF_CHECK(nextRow == rowCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_TailFirstOrdering)
+{
+	MipStreamScheduler scheduler;
+	DF_CHECK(scheduler.Reset(8, 7, 1));
+
+	// Mark the largest mips ready first; the smallest ones still have to go first.
+	QueueMips(scheduler, 0, 7, 128);
+
+	const std::vector<RowCopy> copies = DrainScheduler(scheduler, TestRowPitch * 3, TestRowPitch);
+
+	uint32_t currentMip = 7;
+	uint32_t nextRow = 0;
+
+	for(const RowCopy& copy : copies)
+	{
+		if(copy.mipIndex != currentMip)
+		{
+			// A mip is only started once the smaller mip before it is finished.
+			DF_CHECK(copy.mipIndex == currentMip - 1);
+			DF_CHECK(currentMip == 7 || nextRow == (128u >> currentMip));
+
+			currentMip = copy.mipIndex;
+			nextRow = 0;
+		}
+
+		DF_CHECK(copy.firstRow == nextRow);
+		nextRow = copy.firstRow + copy.rowCount;
+	}
+
+	DF_CHECK(currentMip == 0);
+	DF_CHECK(nextRow == 128);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_ClampAfterVisibilityDelay)
+{
+	const uint32_t visibilityDelay = 3;
+
+	MipStreamScheduler scheduler;
+	DF_CHECK(scheduler.Reset(3, 2, visibilityDelay));
+
+	QueueMips(scheduler, 1, 2, 8);
+
+	RowCopy copies[DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT];
+
+	DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 1);
+	DF_CHECK(copies[0].mipIndex == 1 && copies[0].lastCopy);
+
+	// The clamp only drops once the GPU has had 'visibilityDelay' frames to finish the copy.
+	for(uint32_t frameIndex = 1; frameIndex < visibilityDelay; ++frameIndex)
+	{
+		DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 0);
+		DF_CHECK(scheduler.GetResidentMip() == 2);
+	}
+
+	scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies));
+	DF_CHECK(scheduler.GetResidentMip() == 1);
+
+	// A finished mip can't be exposed before the mips between it and the clamp.
+	DF_CHECK(scheduler.Reset(4, 3, 1));
+
+	QueueMips(scheduler, 0, 1, 8);
+	DF_CHECK(scheduler.SetMipLayout(1, TestRowPitch, 4));
+	DF_CHECK(scheduler.SetMipLayout(2, TestRowPitch, 2));
+
+	for(uint32_t frameIndex = 0; frameIndex < 4; ++frameIndex)
+	{
+		scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies));
+		DF_CHECK(scheduler.GetResidentMip() == 3);
+	}
+
+	DF_CHECK(scheduler.MarkMipReady(2));
+	DF_CHECK(scheduler.MarkMipReady(1));
+
+	DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 2);
+	DF_CHECK(scheduler.GetResidentMip() == 3);
+
+	// Every mip is copied by now, so the clamp drops all the way in one step.
+	DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 0);
+	DF_CHECK(scheduler.GetResidentMip() == 0);
+	DF_CHECK(scheduler.IsFullyResident());
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(MipStreamScheduler_CancellationAndFailure)
+{
+	RowCopy copies[DF_MIP_STREAM_SCHEDULER_MAX_MIP_COUNT];
+
+	// A partially copied mip never lowers the clamp. Mip 1 has 32 rows and only 4 are copied per frame.
+	{
+		MipStreamScheduler scheduler;
+		DF_CHECK(scheduler.Reset(3, 2, 1));
+
+		QueueMips(scheduler, 1, 2, 64);
+
+		for(uint32_t frameIndex = 0; frameIndex < 7; ++frameIndex)
+		{
+			DF_CHECK(scheduler.Update(TestRowPitch * 4, copies, DF_ARRAY_LENGTH(copies)) == 1);
+			DF_CHECK(!copies[0].lastCopy);
+			DF_CHECK(scheduler.GetResidentMip() == 2);
+		}
+	}
+
+	// When the producer fails partway through, the clamp settles on the last mip that was fully copied and nothing
+	// else is ever scheduled.
+	{
+		MipStreamScheduler scheduler;
+		DF_CHECK(scheduler.Reset(4, 3, 1));
+
+		QueueMips(scheduler, 2, 3, 16);
+		QueueMips(scheduler, 1, 2, 16);
+
+		DrainScheduler(scheduler, UINT64_MAX, TestRowPitch);
+
+		for(uint32_t frameIndex = 0; frameIndex < 4; ++frameIndex)
+		{
+			DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 0);
+		}
+
+		DF_CHECK(scheduler.GetResidentMip() == 1);
+		DF_CHECK(!scheduler.IsFullyResident());
+		DF_CHECK(scheduler.GetPendingBytes() == 0);
+	}
+
+	// Resetting cancels every queued copy, including one that has been partially recorded.
+	{
+		MipStreamScheduler scheduler;
+		DF_CHECK(scheduler.Reset(4, 3, 1));
+
+		QueueMips(scheduler, 0, 3, 64);
+
+		DF_CHECK(scheduler.Update(TestRowPitch * 10, copies, DF_ARRAY_LENGTH(copies)) > 0);
+		DF_CHECK(scheduler.GetPendingBytes() > 0);
+
+		DF_CHECK(scheduler.Reset(4, 2, 1));
+		DF_CHECK(scheduler.GetPendingBytes() == 0);
+		DF_CHECK(scheduler.GetResidentMip() == 2);
+		DF_CHECK(scheduler.Update(UINT64_MAX, copies, DF_ARRAY_LENGTH(copies)) == 0);
+
+		// The mips above the new clamp can be queued again from scratch.
+		QueueMips(scheduler, 0, 2, 64);
+
+		const std::vector<RowCopy> remainingCopies = DrainScheduler(scheduler, UINT64_MAX, TestRowPitch);
+
+		DF_CHECK(remainingCopies.size() == 2);
+
+		for(const RowCopy& copy : remainingCopies)
+		{
+			DF_CHECK(copy.firstRow == 0 && copy.lastCopy);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,295 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/PageCache.hpp>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::PageCache PageCache;
+typedef Utility::VirtualPageTable VirtualPageTable;
+typedef PageCache::PageId PageId;
+typedef PageCache::SlotIndex SlotIndex;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_AllocateFreeSlots)
+{
+	PageCache cache;
+
+	DF_CHECK(!cache.Reset(0));
+	DF_CHECK(cache.Reset(4));
+	DF_CHECK(cache.GetSlotCount() == 4);
+
+	PageId evictedPageId;
+
+	// Free slots are handed out lowest first.
+	for(uint32_t index = 0; index < 4; ++index)
+	{
+		DF_CHECK(cache.Allocate(100 + index, 1, evictedPageId) == index);
+		DF_CHECK(evictedPageId == VirtualPageTable::InvalidPageId);
+	}
+
+	DF_CHECK(cache.GetUsedCount() == 4);
+	DF_CHECK(cache.Find(102) == 2);
+	DF_CHECK(cache.GetPage(2) == 102);
+
+	// Invalid and already cached pages are rejected.
+	DF_CHECK(cache.Allocate(VirtualPageTable::InvalidPageId, 2, evictedPageId) == VirtualPageTable::InvalidSlot);
+	DF_CHECK(cache.Allocate(101, 2, evictedPageId) == VirtualPageTable::InvalidSlot);
+
+	// Freed slots are reused before anything is evicted.
+	cache.Free(1);
+
+	DF_CHECK(cache.Find(101) == VirtualPageTable::InvalidSlot);
+	DF_CHECK(cache.GetUsedCount() == 3);
+	DF_CHECK(cache.Allocate(200, 2, evictedPageId) == 1);
+	DF_CHECK(evictedPageId == VirtualPageTable::InvalidPageId);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_EvictLeastRecentlyUsed)
+{
+	PageCache cache;
+	cache.Reset(3);
+
+	PageId evictedPageId;
+
+	cache.Allocate(10, 1, evictedPageId);
+	cache.Allocate(11, 1, evictedPageId);
+	cache.Allocate(12, 1, evictedPageId);
+
+	// Every page was used on the current frame, so nothing can be replaced.
+	DF_CHECK(cache.Allocate(13, 1, evictedPageId) == VirtualPageTable::InvalidSlot);
+
+	// Touching moves pages to the front, leaving page 11 as the least recently used.
+	cache.Touch(cache.Find(10), 2);
+	cache.Touch(cache.Find(12), 3);
+
+	DF_CHECK(cache.Allocate(13, 4, evictedPageId) == 1);
+	DF_CHECK(evictedPageId == 11);
+
+	DF_CHECK(cache.Allocate(14, 4, evictedPageId) == 0);
+	DF_CHECK(evictedPageId == 10);
+
+	// Page 12 was last used before this frame, but pages 13 and 14 weren't.
+	DF_CHECK(cache.Allocate(15, 4, evictedPageId) == 2);
+	DF_CHECK(evictedPageId == 12);
+
+	DF_CHECK(cache.Allocate(16, 4, evictedPageId) == VirtualPageTable::InvalidSlot);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_PinnedSlots)
+{
+	PageCache cache;
+	cache.Reset(2);
+
+	PageId evictedPageId;
+
+	const SlotIndex pinned = cache.Allocate(10, 1, evictedPageId);
+	const SlotIndex other = cache.Allocate(11, 1, evictedPageId);
+
+	cache.SetPinned(pinned, true);
+
+	// The pinned page is never evicted, even as the least recently used page.
+	DF_CHECK(cache.Allocate(12, 2, evictedPageId) == other);
+	DF_CHECK(evictedPageId == 11);
+	DF_CHECK(cache.Allocate(13, 3, evictedPageId) == other);
+	DF_CHECK(evictedPageId == 12);
+	DF_CHECK(cache.Allocate(14, 3, evictedPageId) == VirtualPageTable::InvalidSlot);
+	DF_CHECK(cache.GetPage(pinned) == 10);
+
+	// Freeing a pinned slot makes it free like any other.
+	cache.Free(pinned);
+
+	DF_CHECK(cache.Allocate(14, 3, evictedPageId) == pinned);
+	DF_CHECK(evictedPageId == VirtualPageTable::InvalidPageId);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_UnpinKeepsLastUsedOrder)
+{
+	PageCache cache;
+	cache.Reset(3);
+
+	PageId evictedPageId;
+
+	const SlotIndex stale = cache.Allocate(10, 1, evictedPageId);
+	cache.Allocate(11, 2, evictedPageId);
+	cache.Allocate(12, 3, evictedPageId);
+
+	cache.SetPinned(stale, true);
+	cache.SetPinned(stale, false);
+
+	// The unpinned page hasn't been used since frame 1, so it goes back to the end of the list rather than the front.
+	DF_CHECK(cache.Allocate(13, 4, evictedPageId) == stale);
+	DF_CHECK(evictedPageId == 10);
+
+	// Unpinning a page that was last used before the current frame keeps it evictable even when every other page
+	// was used this frame.
+	cache.SetPinned(stale, true);
+	cache.Touch(cache.Find(11), 5);
+	cache.Touch(cache.Find(12), 5);
+	cache.SetPinned(stale, false);
+
+	DF_CHECK(cache.Allocate(14, 5, evictedPageId) == stale);
+	DF_CHECK(evictedPageId == 13);
+
+	// Touching a pinned page still records when it was used, so it goes back in the middle of the list.
+	cache.SetPinned(stale, true);
+	cache.Touch(stale, 6);
+	cache.Touch(cache.Find(12), 7);
+	cache.SetPinned(stale, false);
+
+	DF_CHECK(cache.Allocate(15, 8, evictedPageId) == cache.Find(15));
+	DF_CHECK(evictedPageId == 11);
+	DF_CHECK(cache.Allocate(16, 8, evictedPageId) == stale);
+	DF_CHECK(evictedPageId == 14);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PageCache_RandomizedAgainstReference)
+{
+	constexpr uint32_t slotCount = 32;
+
+	struct ReferenceSlot
+	{
+		PageId pageId;
+		uint64_t lastUsedFrame;
+		bool pinned;
+	};
+
+	Test::Random random(41);
+
+	PageCache cache;
+	cache.Reset(slotCount);
+
+	std::vector<ReferenceSlot> reference(slotCount, { VirtualPageTable::InvalidPageId, 0, false });
+
+	for(uint64_t frameIndex = 1; frameIndex <= 2000; ++frameIndex)
+	{
+		const uint32_t operationCount = random.Next(1, 8);
+
+		for(uint32_t operation = 0; operation < operationCount; ++operation)
+		{
+			const SlotIndex slot = random.Next(0, slotCount - 1);
+
+			switch(random.Next(0, 4))
+			{
+				case 0:
+					if(reference[slot].pageId != VirtualPageTable::InvalidPageId)
+					{
+						cache.Touch(slot, frameIndex);
+						reference[slot].lastUsedFrame = frameIndex;
+					}
+					break;
+
+				case 1:
+					cache.SetPinned(slot, !reference[slot].pinned);
+
+					if(reference[slot].pageId != VirtualPageTable::InvalidPageId)
+					{
+						reference[slot].pinned = !reference[slot].pinned;
+					}
+					break;
+
+				case 2:
+					if(random.Next(0, 3) == 0)
+					{
+						cache.Free(slot);
+						reference[slot] = { VirtualPageTable::InvalidPageId, 0, false };
+					}
+					break;
+
+				default:
+				{
+					// The oldest unpinned page not used this frame is the only one that may be evicted. Nothing is
+					// evicted while any slot is free.
+					bool hasFreeSlot = false;
+					uint64_t oldestFrame = frameIndex;
+
+					for(const ReferenceSlot& entry : reference)
+					{
+						if(entry.pageId == VirtualPageTable::InvalidPageId)
+						{
+							hasFreeSlot = true;
+						}
+						else if(!entry.pinned && entry.lastUsedFrame < oldestFrame)
+						{
+							oldestFrame = entry.lastUsedFrame;
+						}
+					}
+
+					const PageId pageId = PageId(frameIndex * 16 + operation);
+
+					PageId evictedPageId;
+					const SlotIndex newSlot = cache.Allocate(pageId, frameIndex, evictedPageId);
+
+					if(hasFreeSlot)
+					{
+						DF_CHECK(newSlot != VirtualPageTable::InvalidSlot);
+						DF_CHECK(evictedPageId == VirtualPageTable::InvalidPageId);
+					}
+					else if(oldestFrame == frameIndex)
+					{
+						DF_CHECK(newSlot == VirtualPageTable::InvalidSlot);
+					}
+					else
+					{
+						DF_CHECK(newSlot != VirtualPageTable::InvalidSlot);
+
+						if(newSlot < slotCount)
+						{
+							DF_CHECK(evictedPageId == reference[newSlot].pageId);
+							DF_CHECK(!reference[newSlot].pinned);
+							DF_CHECK(reference[newSlot].lastUsedFrame == oldestFrame);
+						}
+					}
+
+					if(newSlot < slotCount)
+					{
+						reference[newSlot] = { pageId, frameIndex, false };
+					}
+					break;
+				}
+			}
+		}
+
+		uint32_t usedCount = 0;
+
+		for(SlotIndex slot = 0; slot < slotCount; ++slot)
+		{
+			DF_CHECK(cache.GetPage(slot) == reference[slot].pageId);
+			usedCount += (reference[slot].pageId != VirtualPageTable::InvalidPageId) ? 1 : 0;
+		}
+
+		DF_CHECK(cache.GetUsedCount() == usedCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,412 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/PixelConvert.hpp>
+
+#include <limits>
+#include <string.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::PixelConvert PixelConvert;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Not a multiple of the 8-wide kernels, so the scalar tails get covered too.
+static constexpr size_t TestValueCount = 4099;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t FloatToBits(const float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static float BitsToFloat(const uint32_t bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Mix arbitrary bit patterns (which cover NaN, infinity and denormals) with values spread over the range the packed
+// formats can represent, plus the special values every conversion has to get right.
+static std::vector<float> MakeTestFloats(const size_t count, const uint64_t seed)
+{
+	static const float specialValues[] =
+	{
+		0.0f,
+		-0.0f,
+		1.0f,
+		-1.0f,
+		0.5f,
+		PixelConvert::HalfMax,
+		PixelConvert::SharedExponentMax,
+		PixelConvert::Float11Max,
+		PixelConvert::Float10Max,
+		std::numeric_limits<float>::infinity(),
+		-std::numeric_limits<float>::infinity(),
+		std::numeric_limits<float>::quiet_NaN(),
+		std::numeric_limits<float>::denorm_min(),
+		std::numeric_limits<float>::max(),
+	};
+
+	Test::Random random(seed);
+
+	std::vector<float> output(count);
+
+	for(size_t index = 0; index < count; ++index)
+	{
+		const size_t specialCount = sizeof(specialValues) / sizeof(specialValues[0]);
+
+		if(index < specialCount)
+		{
+			output[index] = specialValues[index];
+			continue;
+		}
+
+		switch(random.Next(0, 3))
+		{
+			case 0:
+				output[index] = BitsToFloat(random.Next());
+				break;
+
+			case 1:
+				output[index] = float(random.Next()) / float(0xFFFFFFFFu);
+				break;
+
+			case 2:
+				output[index] = (float(random.Next()) / float(0xFFFFFFFFu)) * 1.25f - 0.125f;
+				break;
+
+			default:
+				output[index] = (float(random.Next()) / float(0xFFFFFFFFu)) * 70000.0f;
+				break;
+		}
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Run a bulk conversion once on the baseline path and once on whatever path the CPU supports, and check that both
+// produce exactly the same bytes.
+template <typename SrcType, typename DstType, typename ConvertFunc>
+static bool MatchesBaseline(
+	const std::vector<SrcType>& src,
+	const size_t dstCount,
+	const size_t count,
+	const ConvertFunc convert,
+	std::vector<DstType>& outDst)
+{
+	std::vector<DstType> baseline(dstCount);
+
+	outDst.assign(dstCount, DstType());
+
+	CpuFeatures::SetBaselineOnly(true);
+	convert(src.data(), baseline.data(), count);
+	CpuFeatures::SetBaselineOnly(false);
+
+	convert(src.data(), outDst.data(), count);
+
+	return memcmp(baseline.data(), outDst.data(), dstCount * sizeof(DstType)) == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_HalfRoundTrip)
+{
+	std::vector<uint16_t> halves(65536);
+
+	for(size_t index = 0; index < halves.size(); ++index)
+	{
+		halves[index] = uint16_t(index);
+	}
+
+	std::vector<float> floats;
+	DF_CHECK(MatchesBaseline(halves, halves.size(), halves.size(), static_cast<void(*)(const uint16_t*, float*, size_t)>(PixelConvert::HalfToFloat), floats));
+
+	std::vector<uint16_t> roundTrip;
+	DF_CHECK(MatchesBaseline(floats, floats.size(), floats.size(), static_cast<void(*)(const float*, uint16_t*, size_t)>(PixelConvert::FloatToHalf), roundTrip));
+
+	uint32_t mismatchCount = 0;
+
+	for(size_t index = 0; index < halves.size(); ++index)
+	{
+		const uint16_t half = halves[index];
+		const float value = PixelConvert::HalfToFloat(half);
+
+		if(FloatToBits(floats[index]) != FloatToBits(value))
+		{
+			++mismatchCount;
+			continue;
+		}
+
+		// NaN halves come back as zero and infinities are clamped to the largest finite half. Every other half,
+		// including the denormals, survives unchanged.
+		const bool isNan = ((half & 0x7C00) == 0x7C00) && ((half & 0x03FF) != 0);
+		const bool isInfinity = (half & 0x7FFF) == 0x7C00;
+		const uint16_t expected = isNan ? 0 : (isInfinity ? uint16_t(half - 1) : half);
+
+		if(isNan)
+		{
+			mismatchCount += (value == value) ? 1 : 0;
+		}
+
+		if(roundTrip[index] != expected || PixelConvert::FloatToHalf(value) != expected)
+		{
+			++mismatchCount;
+		}
+	}
+
+	DF_CHECK(mismatchCount == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_HalfSpecialValues)
+{
+	DF_CHECK(PixelConvert::FloatToHalf(std::numeric_limits<float>::quiet_NaN()) == 0);
+	DF_CHECK(PixelConvert::FloatToHalf(-std::numeric_limits<float>::quiet_NaN()) == 0);
+	DF_CHECK(PixelConvert::FloatToHalf(PixelConvert::HalfMax) == 0x7BFF);
+	DF_CHECK(PixelConvert::FloatToHalf(-PixelConvert::HalfMax) == 0xFBFF);
+	DF_CHECK(PixelConvert::FloatToHalf(1.0e10f) == 0x7BFF);
+	DF_CHECK(PixelConvert::FloatToHalf(-0.0f) == 0x8000);
+	DF_CHECK(PixelConvert::FloatToHalf(1.0f) == 0x3C00);
+
+	// Infinity is clamped like any other out of range value, on the bulk paths as well as the scalar one.
+	const std::vector<float> values =
+	{
+		std::numeric_limits<float>::infinity(),
+		-std::numeric_limits<float>::infinity(),
+		std::numeric_limits<float>::quiet_NaN(),
+		65520.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+	};
+
+	DF_CHECK(PixelConvert::FloatToHalf(values[0]) == 0x7BFF);
+	DF_CHECK(PixelConvert::FloatToHalf(values[1]) == 0xFBFF);
+
+	for(const bool baselineOnly : { true, false })
+	{
+		std::vector<uint16_t> halves(values.size());
+
+		CpuFeatures::SetBaselineOnly(baselineOnly);
+		PixelConvert::FloatToHalf(values.data(), halves.data(), values.size());
+		CpuFeatures::SetBaselineOnly(false);
+
+		DF_CHECK(halves[0] == 0x7BFF);
+		DF_CHECK(halves[1] == 0xFBFF);
+		DF_CHECK(halves[2] == 0);
+		DF_CHECK(halves[3] == 0x7BFF);
+		DF_CHECK(halves[4] == 0x3C00);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_UnormRoundTrip)
+{
+	std::vector<uint8_t> bytes(256);
+
+	for(size_t index = 0; index < bytes.size(); ++index)
+	{
+		bytes[index] = uint8_t(index);
+	}
+
+	std::vector<float> unormFloats;
+	std::vector<float> srgbFloats;
+	DF_CHECK(MatchesBaseline(bytes, bytes.size(), bytes.size(), static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::UnormToFloat), unormFloats));
+	DF_CHECK(MatchesBaseline(bytes, bytes.size(), bytes.size(), static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::SrgbToFloat), srgbFloats));
+
+	std::vector<uint8_t> unormRoundTrip;
+	std::vector<uint8_t> srgbRoundTrip;
+	DF_CHECK(MatchesBaseline(unormFloats, bytes.size(), bytes.size(), static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToUnorm), unormRoundTrip));
+	DF_CHECK(MatchesBaseline(srgbFloats, bytes.size(), bytes.size(), static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToSrgb), srgbRoundTrip));
+
+	uint32_t mismatchCount = 0;
+
+	for(size_t index = 0; index < bytes.size(); ++index)
+	{
+		const uint8_t value = bytes[index];
+
+		mismatchCount += (FloatToBits(unormFloats[index]) != FloatToBits(PixelConvert::UnormToFloat(value))) ? 1 : 0;
+		mismatchCount += (FloatToBits(srgbFloats[index]) != FloatToBits(PixelConvert::SrgbToFloat(value))) ? 1 : 0;
+
+		mismatchCount += (unormRoundTrip[index] != value) ? 1 : 0;
+		mismatchCount += (srgbRoundTrip[index] != value) ? 1 : 0;
+
+		mismatchCount += (PixelConvert::FloatToUnorm(unormFloats[index]) != value) ? 1 : 0;
+		mismatchCount += (PixelConvert::FloatToSrgb(srgbFloats[index]) != value) ? 1 : 0;
+	}
+
+	DF_CHECK(mismatchCount == 0);
+
+	// Both encodings are monotonic and pin the ends of the range.
+	for(size_t index = 1; index < bytes.size(); ++index)
+	{
+		DF_CHECK(unormFloats[index] > unormFloats[index - 1]);
+		DF_CHECK(srgbFloats[index] > srgbFloats[index - 1]);
+	}
+
+	DF_CHECK(unormFloats[0] == 0.0f && unormFloats[255] == 1.0f);
+	DF_CHECK(srgbFloats[0] == 0.0f && srgbFloats[255] == 1.0f);
+
+	DF_CHECK(PixelConvert::FloatToUnorm(-1.0f) == 0);
+	DF_CHECK(PixelConvert::FloatToUnorm(2.0f) == 255);
+	DF_CHECK(PixelConvert::FloatToUnorm(std::numeric_limits<float>::quiet_NaN()) == 0);
+	DF_CHECK(PixelConvert::FloatToSrgb(std::numeric_limits<float>::infinity()) == 255);
+	DF_CHECK(PixelConvert::FloatToSrgb(std::numeric_limits<float>::quiet_NaN()) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_BulkMatchesScalar)
+{
+	const std::vector<float> floats = MakeTestFloats(TestValueCount * 3, 43);
+
+	std::vector<uint16_t> halves;
+	std::vector<uint8_t> unorms;
+	std::vector<uint8_t> srgbs;
+
+	DF_CHECK(MatchesBaseline(floats, floats.size(), floats.size(), static_cast<void(*)(const float*, uint16_t*, size_t)>(PixelConvert::FloatToHalf), halves));
+	DF_CHECK(MatchesBaseline(floats, floats.size(), floats.size(), static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToUnorm), unorms));
+	DF_CHECK(MatchesBaseline(floats, floats.size(), floats.size(), static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToSrgb), srgbs));
+
+	std::vector<uint32_t> sharedExponents;
+	std::vector<uint32_t> smallFloats;
+	std::vector<uint8_t> rgbes;
+	std::vector<uint32_t> rgbas;
+
+	DF_CHECK(MatchesBaseline(floats, TestValueCount, TestValueCount, static_cast<void(*)(const float*, uint32_t*, size_t)>(PixelConvert::FloatToSharedExponent), sharedExponents));
+	DF_CHECK(MatchesBaseline(floats, TestValueCount, TestValueCount, static_cast<void(*)(const float*, uint32_t*, size_t)>(PixelConvert::FloatToR11G11B10), smallFloats));
+	DF_CHECK(MatchesBaseline(floats, TestValueCount * 4, TestValueCount, static_cast<void(*)(const float*, uint8_t*, size_t)>(PixelConvert::FloatToRgbe), rgbes));
+	DF_CHECK(MatchesBaseline(floats, TestValueCount, TestValueCount, PixelConvert::FloatRgbToUnormRgba, rgbas));
+
+	uint32_t mismatchCount = 0;
+
+	for(size_t index = 0; index < floats.size(); ++index)
+	{
+		mismatchCount += (halves[index] != PixelConvert::FloatToHalf(floats[index])) ? 1 : 0;
+		mismatchCount += (unorms[index] != PixelConvert::FloatToUnorm(floats[index])) ? 1 : 0;
+		mismatchCount += (srgbs[index] != PixelConvert::FloatToSrgb(floats[index])) ? 1 : 0;
+	}
+
+	for(size_t texelIndex = 0; texelIndex < TestValueCount; ++texelIndex)
+	{
+		const float* const pRgb = floats.data() + (texelIndex * 3);
+
+		uint8_t rgbe[4];
+		PixelConvert::FloatToRgbe(pRgb, rgbe);
+
+		const uint32_t rgba = uint32_t(PixelConvert::FloatToUnorm(pRgb[0]))
+			| (uint32_t(PixelConvert::FloatToUnorm(pRgb[1])) << 8)
+			| (uint32_t(PixelConvert::FloatToUnorm(pRgb[2])) << 16)
+			| 0xFF000000u;
+
+		mismatchCount += (sharedExponents[texelIndex] != PixelConvert::FloatToSharedExponent(pRgb)) ? 1 : 0;
+		mismatchCount += (smallFloats[texelIndex] != PixelConvert::FloatToR11G11B10(pRgb)) ? 1 : 0;
+		mismatchCount += (memcmp(rgbes.data() + (texelIndex * 4), rgbe, sizeof(rgbe)) != 0) ? 1 : 0;
+		mismatchCount += (rgbas[texelIndex] != rgba) ? 1 : 0;
+	}
+
+	DF_CHECK(mismatchCount == 0);
+
+	// Decode everything that was just encoded, which covers every packed format's full range of exponents.
+	std::vector<float> decodedSharedExponents;
+	std::vector<float> decodedSmallFloats;
+	std::vector<float> decodedRgbes;
+
+	DF_CHECK(MatchesBaseline(sharedExponents, floats.size(), TestValueCount, static_cast<void(*)(const uint32_t*, float*, size_t)>(PixelConvert::SharedExponentToFloat), decodedSharedExponents));
+	DF_CHECK(MatchesBaseline(smallFloats, floats.size(), TestValueCount, static_cast<void(*)(const uint32_t*, float*, size_t)>(PixelConvert::R11G11B10ToFloat), decodedSmallFloats));
+	DF_CHECK(MatchesBaseline(rgbes, floats.size(), TestValueCount, static_cast<void(*)(const uint8_t*, float*, size_t)>(PixelConvert::RgbeToFloat), decodedRgbes));
+
+	for(size_t texelIndex = 0; texelIndex < TestValueCount; ++texelIndex)
+	{
+		float sharedExponentRgb[3];
+		float smallFloatRgb[3];
+		float rgbeRgb[3];
+
+		PixelConvert::SharedExponentToFloat(sharedExponents[texelIndex], sharedExponentRgb);
+		PixelConvert::R11G11B10ToFloat(smallFloats[texelIndex], smallFloatRgb);
+		PixelConvert::RgbeToFloat(rgbes.data() + (texelIndex * 4), rgbeRgb);
+
+		mismatchCount += (memcmp(decodedSharedExponents.data() + (texelIndex * 3), sharedExponentRgb, sizeof(sharedExponentRgb)) != 0) ? 1 : 0;
+		mismatchCount += (memcmp(decodedSmallFloats.data() + (texelIndex * 3), smallFloatRgb, sizeof(smallFloatRgb)) != 0) ? 1 : 0;
+		mismatchCount += (memcmp(decodedRgbes.data() + (texelIndex * 3), rgbeRgb, sizeof(rgbeRgb)) != 0) ? 1 : 0;
+	}
+
+	DF_CHECK(mismatchCount == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(PixelConvert_PackedSpecialValues)
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+
+	const float hugeRgb[3] = { infinity, 1.0e10f, PixelConvert::SharedExponentMax };
+	const float invalidRgb[3] = { nan, -infinity, -1.0f };
+
+	float rgb[3];
+
+	// Out of range channels clamp to the largest value each format can hold.
+	PixelConvert::SharedExponentToFloat(PixelConvert::FloatToSharedExponent(hugeRgb), rgb);
+	DF_CHECK(rgb[0] == PixelConvert::SharedExponentMax && rgb[1] == PixelConvert::SharedExponentMax && rgb[2] == PixelConvert::SharedExponentMax);
+
+	PixelConvert::R11G11B10ToFloat(PixelConvert::FloatToR11G11B10(hugeRgb), rgb);
+	DF_CHECK(rgb[0] == PixelConvert::Float11Max && rgb[1] == PixelConvert::Float11Max && rgb[2] == PixelConvert::Float10Max);
+
+	// None of the packed formats have a sign, so NaN and negative channels become zero.
+	DF_CHECK(PixelConvert::FloatToSharedExponent(invalidRgb) == 0);
+	DF_CHECK(PixelConvert::FloatToR11G11B10(invalidRgb) == 0);
+
+	uint8_t rgbe[4];
+	PixelConvert::FloatToRgbe(invalidRgb, rgbe);
+	DF_CHECK(rgbe[0] == 0 && rgbe[1] == 0 && rgbe[2] == 0 && rgbe[3] == 0);
+
+	// Exact powers of two survive every packed format.
+	const float exactRgb[3] = { 1.0f, 0.5f, 4.0f };
+
+	PixelConvert::SharedExponentToFloat(PixelConvert::FloatToSharedExponent(exactRgb), rgb);
+	DF_CHECK(rgb[0] == 1.0f && rgb[1] == 0.5f && rgb[2] == 4.0f);
+
+	PixelConvert::R11G11B10ToFloat(PixelConvert::FloatToR11G11B10(exactRgb), rgb);
+	DF_CHECK(rgb[0] == 1.0f && rgb[1] == 0.5f && rgb[2] == 4.0f);
+
+	PixelConvert::FloatToRgbe(exactRgb, rgbe);
+	PixelConvert::RgbeToFloat(rgbe, rgb);
+	DF_CHECK(rgb[0] == 1.0f && rgb[1] == 0.5f && rgb[2] == 4.0f);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
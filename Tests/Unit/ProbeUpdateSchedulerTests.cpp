@@ -0,0 +1,434 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/ProbeUpdateScheduler.hpp>
+
+#include <math.h>
+
+#include <map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::ProbeUpdateScheduler ProbeUpdateScheduler;
+typedef Utility::ProbeUpdateScheduler::Pass Pass;
+typedef Utility::ProbeUpdateScheduler::Step Step;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t TestFaceCount = 6;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint32_t GetMipCount(const uint32_t edgeLength)
+{
+	uint32_t mipCount = 1;
+
+	while((edgeLength >> mipCount) > 0)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Descriptions matching the cube map sizes of each EnvMapQuality.
+static ProbeUpdateScheduler::Desc MakeDesc(
+	const uint32_t envEdgeLength,
+	const uint32_t irrEdgeLength,
+	const uint32_t swapDelay,
+	const uint32_t specSampleCount)
+{
+	ProbeUpdateScheduler::Desc desc;
+	desc.envEdgeLength = envEdgeLength;
+	desc.envMipCount = GetMipCount(envEdgeLength);
+	desc.irrEdgeLength = irrEdgeLength;
+	desc.rowAlignment = 32;
+	desc.reduceSegmentSize = 4;
+	desc.reduceGroupSize = 1024;
+	desc.swapDelay = swapDelay;
+	desc.specSampleCount = specSampleCount;
+
+	return desc;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static uint64_t MakeCoverageKey(const Pass pass, const uint32_t mipIndex, const uint32_t faceIndex)
+{
+	return (uint64_t(pass) << 32) | (uint64_t(mipIndex) << 8) | uint64_t(faceIndex);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Number of times each row of every pass should be written over a single update, keyed on the pass, mip and face.
+static std::map<uint64_t, std::vector<uint32_t>> MakeExpectedCoverage(const ProbeUpdateScheduler::Desc& desc)
+{
+	std::map<uint64_t, std::vector<uint32_t>> coverage;
+
+	for(uint32_t mipIndex = 0; mipIndex < desc.envMipCount; ++mipIndex)
+	{
+		const uint32_t mipEdgeLength = desc.envEdgeLength >> mipIndex;
+
+		for(uint32_t faceIndex = 0; faceIndex < TestFaceCount; ++faceIndex)
+		{
+			coverage[MakeCoverageKey(Pass::EquiToCube, mipIndex, faceIndex)].assign((mipEdgeLength > 0) ? mipEdgeLength : 1, 0);
+
+			if(desc.specSampleCount > 0)
+			{
+				coverage[MakeCoverageKey(Pass::SpecPrefilter, mipIndex, faceIndex)].assign((mipEdgeLength > 0) ? mipEdgeLength : 1, 0);
+			}
+		}
+	}
+
+	coverage[MakeCoverageKey(Pass::ShProject, 0, 0)].assign(desc.envEdgeLength, 0);
+
+	uint32_t reducePassIndex = 0;
+
+	for(uint32_t inputCount = desc.envEdgeLength * desc.envEdgeLength; inputCount > 1; inputCount /= desc.reduceSegmentSize)
+	{
+		const uint32_t outputCount = inputCount / desc.reduceSegmentSize;
+
+		coverage[MakeCoverageKey(Pass::ShReduce, reducePassIndex, 0)].assign((outputCount > 0) ? outputCount : 1, 0);
+		++reducePassIndex;
+	}
+
+	coverage[MakeCoverageKey(Pass::ShNormalize, 0, 0)].assign(1, 0);
+	coverage[MakeCoverageKey(Pass::Swap, 0, 0)].assign(1, 0);
+
+	for(uint32_t faceIndex = 0; faceIndex < TestFaceCount; ++faceIndex)
+	{
+		coverage[MakeCoverageKey(Pass::ShReconstruct, 0, faceIndex)].assign(1, 0);
+	}
+
+	return coverage;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Run an update to completion, checking that the steps cover every row of every pass exactly once, in pass order and
+// on aligned rows, and that each frame stays inside the budget unless it's a single forced step. GPU times are
+// reported back 'reportLatency' frames late as 'gpuCostScale' times the unscaled cost model. Returns the number of
+// frames that had work scheduled.
+static uint32_t RunUpdate(
+	ProbeUpdateScheduler& scheduler,
+	const ProbeUpdateScheduler::Desc& desc,
+	const float64_t budgetMs,
+	const float64_t gpuCostScale,
+	const uint32_t reportLatency,
+	float64_t& outMaxFrameMs)
+{
+	std::map<uint64_t, std::vector<uint32_t>> coverage = MakeExpectedCoverage(desc);
+	std::map<uint64_t, float64_t> pendingReports;
+
+	// Enough room for every step of an update, so an unlimited budget fits it all in one frame.
+	Step steps[256];
+
+	Pass lastPass = Pass::EquiToCube;
+
+	uint32_t workFrameCount = 0;
+	uint32_t frameCount = 0;
+
+	outMaxFrameMs = 0.0;
+
+	while(scheduler.IsUpdating() || !pendingReports.empty())
+	{
+		const size_t stepCount = scheduler.Update(budgetMs, steps, DF_ARRAY_LENGTH(steps));
+
+		++frameCount;
+
+		DF_CHECK(frameCount < 1000000);
+
+		if(frameCount >= 1000000)
+		{
+			break;
+		}
+
+		float64_t estimateMs = 0.0;
+		float64_t gpuTimeMs = 0.0;
+
+		size_t workStepCount = 0;
+
+		for(size_t stepIndex = 0; stepIndex < stepCount; ++stepIndex)
+		{
+			const Step& step = steps[stepIndex];
+
+			DF_CHECK(step.pass >= lastPass);
+			lastPass = step.pass;
+
+			const float64_t stepMs = scheduler.EstimateStepMs(step);
+
+			estimateMs += stepMs;
+			gpuTimeMs += stepMs / scheduler.GetCostScale() * gpuCostScale;
+
+			if(step.pass == Pass::Swap)
+			{
+				// Nothing can follow the swap in the same frame.
+				DF_CHECK(stepIndex + 1 == stepCount);
+			}
+			else
+			{
+				++workStepCount;
+			}
+
+			const uint32_t rowAlignment = (step.pass == Pass::ShReduce) ? desc.reduceGroupSize : desc.rowAlignment;
+			const uint32_t rowCount = (step.pass == Pass::Swap) ? 1 : step.rowCount;
+
+			DF_CHECK(step.firstRow % rowAlignment == 0);
+
+			auto it = coverage.find(MakeCoverageKey(step.pass, step.mipIndex, step.faceIndex));
+			DF_CHECK(it != coverage.end());
+
+			if(it == coverage.end())
+			{
+				continue;
+			}
+
+			std::vector<uint32_t>& rows = it->second;
+
+			DF_CHECK(step.firstRow + rowCount <= rows.size());
+
+			for(uint32_t row = step.firstRow; row < step.firstRow + rowCount && row < rows.size(); ++row)
+			{
+				++rows[row];
+			}
+		}
+
+		DF_CHECK(estimateMs <= budgetMs * 1.0001 || workStepCount == 1);
+
+		if(stepCount > 0)
+		{
+			++workFrameCount;
+
+			pendingReports[scheduler.GetFrameIndex()] = gpuTimeMs;
+
+			if(gpuTimeMs > outMaxFrameMs)
+			{
+				outMaxFrameMs = gpuTimeMs;
+			}
+		}
+
+		for(auto it = pendingReports.begin(); it != pendingReports.end();)
+		{
+			if(it->first + reportLatency <= scheduler.GetFrameIndex())
+			{
+				scheduler.ReportGpuTime(it->first, it->second);
+				it = pendingReports.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	for(const auto& pair : coverage)
+	{
+		for(const uint32_t writeCount : pair.second)
+		{
+			DF_CHECK(writeCount == 1);
+		}
+	}
+
+	return workFrameCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProbeUpdateScheduler_Validation)
+{
+	ProbeUpdateScheduler scheduler;
+
+	DF_CHECK(!scheduler.Reset(MakeDesc(0, 16, 3, 0)));
+	DF_CHECK(!scheduler.Reset(MakeDesc(512, 0, 3, 0)));
+
+	ProbeUpdateScheduler::Desc desc = MakeDesc(512, 16, 3, 0);
+	desc.reduceSegmentSize = 1;
+
+	DF_CHECK(!scheduler.Reset(desc));
+
+	// Beginning an update without a probe does nothing.
+	scheduler.Begin();
+	DF_CHECK(!scheduler.IsUpdating());
+
+	Step step;
+	DF_CHECK(scheduler.Update(1.0, &step, 1) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProbeUpdateScheduler_RowCoverage)
+{
+	const uint32_t edgeLengths[][2] =
+	{
+		{ 512,  16 },
+		{ 1024, 32 },
+		{ 2048, 64 },
+	};
+
+	for(const auto& edgeLength : edgeLengths)
+	{
+		for(const uint32_t specSampleCount : { 0u, 32u })
+		{
+			// A zero budget forces a single group of rows per frame; a huge one fits the whole update in a frame.
+			for(const float64_t budgetMs : { 0.0, 0.05, 0.25, 1.0, 1000.0 })
+			{
+				const ProbeUpdateScheduler::Desc desc = MakeDesc(edgeLength[0], edgeLength[1], 3, specSampleCount);
+
+				ProbeUpdateScheduler scheduler;
+				DF_CHECK(scheduler.Reset(desc));
+
+				scheduler.Begin();
+				DF_CHECK(scheduler.IsUpdating());
+
+				float64_t maxFrameMs = 0.0;
+				const uint32_t frameCount = RunUpdate(scheduler, desc, budgetMs, 1.0, 2, maxFrameMs);
+
+				DF_CHECK(!scheduler.IsUpdating());
+
+				if(budgetMs >= 1000.0)
+				{
+					DF_CHECK(frameCount == 1);
+				}
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProbeUpdateScheduler_SwapDelayIdleFrames)
+{
+	const uint32_t swapDelay = 3;
+
+	ProbeUpdateScheduler scheduler;
+	DF_CHECK(scheduler.Reset(MakeDesc(512, 16, swapDelay, 0)));
+
+	scheduler.Begin();
+
+	Step steps[64];
+
+	uint64_t swapFrame = 0;
+
+	while(scheduler.IsUpdating())
+	{
+		const size_t stepCount = scheduler.Update(1000.0, steps, DF_ARRAY_LENGTH(steps));
+
+		if(stepCount > 0 && steps[stepCount - 1].pass == Pass::Swap)
+		{
+			swapFrame = scheduler.GetFrameIndex();
+		}
+	}
+
+	DF_CHECK(swapFrame > 0);
+
+	// The next update can't touch the old front buffers until every frame that might be reading them is done.
+	scheduler.Begin();
+
+	uint32_t idleFrameCount = 0;
+	size_t stepCount = 0;
+
+	while((stepCount = scheduler.Update(1000.0, steps, DF_ARRAY_LENGTH(steps))) == 0 && idleFrameCount < 100)
+	{
+		++idleFrameCount;
+	}
+
+	DF_CHECK(idleFrameCount == swapDelay - 1);
+	DF_CHECK(scheduler.GetFrameIndex() == swapFrame + swapDelay);
+	DF_CHECK(steps[0].pass == Pass::EquiToCube);
+	DF_CHECK(steps[0].firstRow == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProbeUpdateScheduler_Restart)
+{
+	const ProbeUpdateScheduler::Desc desc = MakeDesc(1024, 32, 2, 32);
+
+	ProbeUpdateScheduler scheduler;
+	DF_CHECK(scheduler.Reset(desc));
+
+	scheduler.Begin();
+
+	const float64_t fullMs = scheduler.EstimateRemainingMs();
+
+	Step steps[64];
+
+	for(uint32_t frameIndex = 0; frameIndex < 4; ++frameIndex)
+	{
+		scheduler.Update(0.5, steps, DF_ARRAY_LENGTH(steps));
+	}
+
+	DF_CHECK(scheduler.IsUpdating());
+	DF_CHECK(scheduler.EstimateRemainingMs() < fullMs);
+
+	// Beginning again part way through starts the back buffers over, so every row is still written exactly once.
+	scheduler.Begin();
+
+	DF_CHECK(fabs(scheduler.EstimateRemainingMs() - fullMs) < 1.0e-9);
+
+	float64_t maxFrameMs = 0.0;
+	RunUpdate(scheduler, desc, 0.5, 1.0, 2, maxFrameMs);
+
+	// Cancelling drops the update entirely.
+	scheduler.Begin();
+	scheduler.Update(0.5, steps, DF_ARRAY_LENGTH(steps));
+	scheduler.Cancel();
+
+	DF_CHECK(!scheduler.IsUpdating());
+	DF_CHECK(scheduler.EstimateRemainingMs() == 0.0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProbeUpdateScheduler_CostScaleConvergence)
+{
+	const ProbeUpdateScheduler::Desc desc = MakeDesc(2048, 64, 3, 32);
+
+	// The GPU is both slower and faster than the model, with reports arriving a few frames late.
+	for(const float64_t gpuCostScale : { 3.0, 0.3 })
+	{
+		ProbeUpdateScheduler scheduler;
+		DF_CHECK(scheduler.Reset(desc));
+
+		float64_t maxFrameMs = 0.0;
+
+		// A faster GPU gets through an update in fewer frames, so give the scale a couple of updates to settle.
+		for(uint32_t updateIndex = 0; updateIndex < 2; ++updateIndex)
+		{
+			scheduler.Begin();
+			RunUpdate(scheduler, desc, 1.0, gpuCostScale, 3, maxFrameMs);
+		}
+
+		DF_CHECK(fabs(scheduler.GetCostScale() - gpuCostScale) / gpuCostScale < 0.05);
+
+		// Once calibrated, the measured frame times hold the budget.
+		scheduler.Begin();
+		RunUpdate(scheduler, desc, 1.0, gpuCostScale, 3, maxFrameMs);
+
+		DF_CHECK(maxFrameMs <= 1.02);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
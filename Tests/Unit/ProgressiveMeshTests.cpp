@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Direct3D12/Mesh/ProgressiveMesh.hpp>
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef D3D12::ProgressiveMesh ProgressiveMesh;
+typedef D3D12::StaticMesh::Geometry Geometry;
+typedef Geometry::Vertex Vertex;
+typedef Geometry::Index Index;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Build a flat grid of 'cellCount' x 'cellCount' quads on the XZ plane with vertices at integer coordinates. The
+// normals all face 'normalY' so the whole grid falls in a single normal octant.
+static Geometry CreateGrid(const uint32_t cellCount, const float32_t normalY)
+{
+	const uint32_t rowLength = cellCount + 1;
+
+	Geometry geometry;
+	geometry.vertexBuffer = Geometry::VertexArray::Create(rowLength * rowLength);
+	geometry.indexBuffer = Geometry::IndexArray::Create(cellCount * cellCount * 6);
+
+	Vertex* const pVertices = geometry.vertexBuffer.GetData();
+	Index* const pIndices = geometry.indexBuffer.GetData();
+
+	for(uint32_t z = 0; z < rowLength; ++z)
+	{
+		for(uint32_t x = 0; x < rowLength; ++x)
+		{
+			Vertex& vertex = pVertices[(z * rowLength) + x];
+			memset(&vertex, 0, sizeof(vertex));
+
+			vertex.pos.x = float32_t(x);
+			vertex.pos.z = float32_t(z);
+			vertex.tex.u = float32_t(x) / float32_t(cellCount);
+			vertex.tex.v = float32_t(z) / float32_t(cellCount);
+			vertex.norm.y = normalY;
+			vertex.tan.x = 1.0f;
+			vertex.bin.z = 1.0f;
+		}
+	}
+
+	Index* pIndex = pIndices;
+
+	for(uint32_t z = 0; z < cellCount; ++z)
+	{
+		for(uint32_t x = 0; x < cellCount; ++x)
+		{
+			const Index corner = (z * rowLength) + x;
+
+			*pIndex++ = corner;
+			*pIndex++ = corner + rowLength;
+			*pIndex++ = corner + 1;
+
+			*pIndex++ = corner + 1;
+			*pIndex++ = corner + rowLength;
+			*pIndex++ = corner + rowLength + 1;
+		}
+	}
+
+	return geometry;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Check that every index is in range and that no triangle references the same vertex twice.
+static void CheckTriangles(const Geometry& geometry)
+{
+	const Index* const pIndices = geometry.indexBuffer.GetData();
+	const size_t vertexCount = geometry.vertexBuffer.GetCount();
+	const size_t indexCount = geometry.indexBuffer.GetCount();
+
+	DF_CHECK(indexCount % 3 == 0);
+
+	for(size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		DF_CHECK(pIndices[i + 0] < vertexCount);
+		DF_CHECK(pIndices[i + 1] < vertexCount);
+		DF_CHECK(pIndices[i + 2] < vertexCount);
+
+		DF_CHECK(pIndices[i + 0] != pIndices[i + 1]);
+		DF_CHECK(pIndices[i + 1] != pIndices[i + 2]);
+		DF_CHECK(pIndices[i + 0] != pIndices[i + 2]);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProgressiveMesh_DecimateInvalidInput)
+{
+	const Geometry grid = CreateGrid(4, 1.0f);
+
+	DF_CHECK(ProgressiveMesh::Decimate(Geometry(), 16).indexBuffer.GetCount() == 0);
+	DF_CHECK(ProgressiveMesh::Decimate(grid, 0).indexBuffer.GetCount() == 0);
+	DF_CHECK(ProgressiveMesh::Decimate(grid, 0).vertexBuffer.GetCount() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProgressiveMesh_DecimateBounds)
+{
+	const uint32_t cellCount = 32;
+	const Geometry grid = CreateGrid(cellCount, 1.0f);
+
+	for(const uint32_t gridResolution : { 2u, 3u, 5u, 8u, 16u })
+	{
+		const Geometry output = ProgressiveMesh::Decimate(grid, gridResolution);
+
+		DF_CHECK(output.indexBuffer.GetCount() > 0);
+		DF_CHECK(output.indexBuffer.GetCount() < grid.indexBuffer.GetCount());
+
+		// Each cell holds at most one vertex per normal octant, and the grid only spans two axes.
+		DF_CHECK(output.vertexBuffer.GetCount() <= size_t(gridResolution) * gridResolution);
+
+		CheckTriangles(output);
+
+		// Cluster positions are averages of the source vertices, so they can't leave the source bounds.
+		const Vertex* const pVertices = output.vertexBuffer.GetData();
+
+		for(size_t i = 0; i < output.vertexBuffer.GetCount(); ++i)
+		{
+			DF_CHECK(pVertices[i].pos.x >= 0.0f && pVertices[i].pos.x <= float32_t(cellCount));
+			DF_CHECK(pVertices[i].pos.y == 0.0f);
+			DF_CHECK(pVertices[i].pos.z >= 0.0f && pVertices[i].pos.z <= float32_t(cellCount));
+
+			DF_CHECK(pVertices[i].tex.u >= 0.0f && pVertices[i].tex.u <= 1.0f);
+			DF_CHECK(pVertices[i].tex.v >= 0.0f && pVertices[i].tex.v <= 1.0f);
+
+			DF_CHECK(pVertices[i].norm.y == 1.0f);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProgressiveMesh_DecimateCollapsedTriangles)
+{
+	const Geometry grid = CreateGrid(8, 1.0f);
+
+	// A single cell merges every vertex into one cluster, so every triangle collapses.
+	{
+		const Geometry output = ProgressiveMesh::Decimate(grid, 1);
+
+		DF_CHECK(output.indexBuffer.GetCount() == 0);
+		DF_CHECK(output.vertexBuffer.GetCount() == 0);
+	}
+
+	// With two cells per axis, only the triangles that touch the cell boundary survive, and each one must join three
+	// of the four clusters.
+	{
+		const Geometry output = ProgressiveMesh::Decimate(grid, 2);
+
+		DF_CHECK(output.vertexBuffer.GetCount() == 4);
+		DF_CHECK(output.indexBuffer.GetCount() > 0);
+		DF_CHECK(output.indexBuffer.GetCount() <= 4 * 3);
+
+		CheckTriangles(output);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProgressiveMesh_DecimateIndexRemapping)
+{
+	const uint32_t cellCount = 6;
+	const Geometry grid = CreateGrid(cellCount, 1.0f);
+
+	// One more cell than the grid has quads puts every source vertex in its own cluster, so the triangles must come
+	// back unchanged apart from the vertex order.
+	const Geometry output = ProgressiveMesh::Decimate(grid, cellCount + 1);
+
+	DF_CHECK(output.vertexBuffer.GetCount() == grid.vertexBuffer.GetCount());
+	DF_CHECK(output.indexBuffer.GetCount() == grid.indexBuffer.GetCount());
+
+	if(output.indexBuffer.GetCount() != grid.indexBuffer.GetCount())
+	{
+		return;
+	}
+
+	CheckTriangles(output);
+
+	const Vertex* const pSrcVertices = grid.vertexBuffer.GetData();
+	const Vertex* const pOutVertices = output.vertexBuffer.GetData();
+	const Index* const pSrcIndices = grid.indexBuffer.GetData();
+	const Index* const pOutIndices = output.indexBuffer.GetData();
+
+	for(size_t i = 0; i < grid.indexBuffer.GetCount(); ++i)
+	{
+		const Vertex& srcVertex = pSrcVertices[pSrcIndices[i]];
+		const Vertex& outVertex = pOutVertices[pOutIndices[i]];
+
+		DF_CHECK(outVertex.pos.x == srcVertex.pos.x);
+		DF_CHECK(outVertex.pos.y == srcVertex.pos.y);
+		DF_CHECK(outVertex.pos.z == srcVertex.pos.z);
+		DF_CHECK(outVertex.tex.u == srcVertex.tex.u);
+		DF_CHECK(outVertex.tex.v == srcVertex.tex.v);
+	}
+
+	// Clusters are numbered in the order their first vertex appears in the source.
+	for(size_t i = 0; i < output.vertexBuffer.GetCount(); ++i)
+	{
+		DF_CHECK(pOutVertices[i].pos.x == pSrcVertices[i].pos.x);
+		DF_CHECK(pOutVertices[i].pos.z == pSrcVertices[i].pos.z);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ProgressiveMesh_DecimateKeepsOppositeNormalsApart)
+{
+	const uint32_t cellCount = 8;
+
+	const Geometry front = CreateGrid(cellCount, 1.0f);
+	const Geometry back = CreateGrid(cellCount, -1.0f);
+
+	const size_t frontVertexCount = front.vertexBuffer.GetCount();
+	const size_t frontIndexCount = front.indexBuffer.GetCount();
+
+	// Stack both sides of a two-sided sheet into a single geometry.
+	Geometry sheet;
+	sheet.vertexBuffer = Geometry::VertexArray::Create(frontVertexCount * 2);
+	sheet.indexBuffer = Geometry::IndexArray::Create(frontIndexCount * 2);
+
+	memcpy(sheet.vertexBuffer.GetData(), front.vertexBuffer.GetData(), sizeof(Vertex) * frontVertexCount);
+	memcpy(sheet.vertexBuffer.GetData() + frontVertexCount, back.vertexBuffer.GetData(), sizeof(Vertex) * frontVertexCount);
+
+	for(size_t i = 0; i < frontIndexCount; ++i)
+	{
+		sheet.indexBuffer.GetData()[i] = front.indexBuffer.GetData()[i];
+		sheet.indexBuffer.GetData()[frontIndexCount + i] = back.indexBuffer.GetData()[i] + Index(frontVertexCount);
+	}
+
+	const Geometry output = ProgressiveMesh::Decimate(sheet, 4);
+
+	DF_CHECK(output.indexBuffer.GetCount() > 0);
+
+	CheckTriangles(output);
+
+	// Every triangle must stay entirely on one side of the sheet.
+	const Vertex* const pVertices = output.vertexBuffer.GetData();
+	const Index* const pIndices = output.indexBuffer.GetData();
+
+	size_t frontTriangleCount = 0;
+	size_t backTriangleCount = 0;
+
+	for(size_t i = 0; i + 2 < output.indexBuffer.GetCount(); i += 3)
+	{
+		const float32_t normalY = pVertices[pIndices[i]].norm.y;
+
+		DF_CHECK(fabsf(normalY) == 1.0f);
+		DF_CHECK(pVertices[pIndices[i + 1]].norm.y == normalY);
+		DF_CHECK(pVertices[pIndices[i + 2]].norm.y == normalY);
+
+		if(normalY > 0.0f)
+		{
+			++frontTriangleCount;
+		}
+		else
+		{
+			++backTriangleCount;
+		}
+	}
+
+	DF_CHECK(frontTriangleCount > 0);
+	DF_CHECK(frontTriangleCount == backTriangleCount);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,426 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/ResidencyPolicy.hpp>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::ResidencyPolicy ResidencyPolicy;
+typedef ResidencyPolicy::Action Action;
+typedef ResidencyPolicy::ActionType ActionType;
+typedef ResidencyPolicy::EntryId EntryId;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Sizes of a four mip entry, each mip a quarter the size of the one above it.
+static const uint64_t TestResidentSizes[] = { 1024, 256, 64, 16 };
+
+static constexpr uint32_t TestMipCount = DF_ARRAY_LENGTH(TestResidentSizes);
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static EntryId RegisterTestEntry(ResidencyPolicy& policy, const uint32_t tailMip, const uint32_t residentMip)
+{
+	return policy.Register(TestMipCount, TestResidentSizes, tailMip, residentMip);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool IsAction(const Action& action, const EntryId id, const ActionType type, const uint32_t targetMip)
+{
+	return (action.id == id) && (action.type == type) && (action.targetMip == targetMip);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_RegisterValidation)
+{
+	ResidencyPolicy policy;
+
+	const uint64_t growingSizes[] = { 64, 256, 16 };
+
+	DF_CHECK(policy.Register(0, TestResidentSizes, 0, 0) == ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(policy.Register(TestMipCount, nullptr, 0, 0) == ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(policy.Register(TestMipCount, TestResidentSizes, TestMipCount, 0) == ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(policy.Register(TestMipCount, TestResidentSizes, 0, TestMipCount + 1) == ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(policy.Register(DF_ARRAY_LENGTH(growingSizes), growingSizes, 0, 0) == ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(policy.GetEntryCount() == 0);
+
+	const EntryId first = RegisterTestEntry(policy, 2, 1);
+	const EntryId second = RegisterTestEntry(policy, 2, TestMipCount);
+
+	DF_CHECK(first != ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(second != ResidencyPolicy::InvalidEntryId);
+	DF_CHECK(first != second);
+	DF_CHECK(policy.GetResidentSize() == 256);
+
+	DF_CHECK(policy.Unregister(first));
+	DF_CHECK(!policy.Unregister(first));
+	DF_CHECK(policy.GetResidentSize() == 0);
+	DF_CHECK(policy.GetEntryCount() == 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_TrimBeforeEvictInLruOrder)
+{
+	ResidencyPolicy policy;
+	policy.SetBudget(3 * 1024);
+
+	const EntryId a = RegisterTestEntry(policy, 2, 0);
+	const EntryId b = RegisterTestEntry(policy, 2, 0);
+	const EntryId c = RegisterTestEntry(policy, 2, 0);
+
+	// 'a' is the least recently used entry and 'c' the most.
+	policy.Touch(a, 1);
+	policy.Touch(b, 2);
+	policy.Touch(c, 3);
+
+	Action actions[8];
+
+	DF_CHECK(policy.Update(3, actions, DF_ARRAY_LENGTH(actions)) == 0);
+
+	// Freeing 900 bytes takes more than dropping a single mip from 'a', so it goes straight to its tail.
+	policy.SetBudget(3072 - 900);
+
+	DF_CHECK(policy.Update(4, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], a, ActionType::Trim, 2));
+	DF_CHECK(policy.GetResidentSize() == 64 + 1024 + 1024);
+
+	// Every entry gets trimmed before anything is evicted, and each one drops as few mips as possible.
+	policy.SetBudget(1000);
+
+	DF_CHECK(policy.Update(5, actions, DF_ARRAY_LENGTH(actions)) == 2);
+	DF_CHECK(IsAction(actions[0], b, ActionType::Trim, 2));
+	DF_CHECK(IsAction(actions[1], c, ActionType::Trim, 1));
+	DF_CHECK(policy.GetResidentSize() == 64 + 64 + 256);
+
+	// Once everything is down to its tail, the least recently used entries are evicted.
+	policy.SetBudget(100);
+
+	DF_CHECK(policy.Update(6, actions, DF_ARRAY_LENGTH(actions)) == 3);
+	DF_CHECK(IsAction(actions[0], c, ActionType::Trim, 2));
+	DF_CHECK(IsAction(actions[1], a, ActionType::Evict, TestMipCount));
+	DF_CHECK(IsAction(actions[2], b, ActionType::Evict, TestMipCount));
+	DF_CHECK(policy.GetResidentSize() == 64);
+
+	DF_CHECK(policy.GetResidentMip(a) == TestMipCount);
+	DF_CHECK(policy.GetResidentMip(b) == TestMipCount);
+	DF_CHECK(policy.GetResidentMip(c) == 2);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_TrimAndEvictInOneUpdateIsOneAction)
+{
+	ResidencyPolicy policy;
+	policy.SetBudget(0);
+
+	const EntryId id = RegisterTestEntry(policy, 2, 0);
+
+	Action actions[4];
+
+	// The entry is trimmed to its tail and then evicted, which has to come out as a single eviction.
+	DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], id, ActionType::Evict, TestMipCount));
+	DF_CHECK(policy.GetResidentSize() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_TailClamping)
+{
+	Action actions[4];
+
+	// Trimming never goes past the tail, even when more memory is needed; the rest comes from evictions.
+	{
+		ResidencyPolicy policy;
+		policy.SetBudget(1000);
+
+		const EntryId id = RegisterTestEntry(policy, 1, 0);
+
+		DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 1);
+		DF_CHECK(IsAction(actions[0], id, ActionType::Trim, 1));
+
+		policy.SetBudget(100);
+
+		DF_CHECK(policy.Update(2, actions, DF_ARRAY_LENGTH(actions)) == 1);
+		DF_CHECK(IsAction(actions[0], id, ActionType::Evict, TestMipCount));
+	}
+
+	// An entry in use always gets its tail back, even when that goes over the budget.
+	{
+		ResidencyPolicy policy;
+		policy.SetBudget(0);
+
+		const EntryId id = RegisterTestEntry(policy, 2, TestMipCount);
+
+		policy.Touch(id, 1);
+
+		DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 1);
+		DF_CHECK(IsAction(actions[0], id, ActionType::Restore, 2));
+		DF_CHECK(policy.GetResidentSize() == 64);
+
+		// Entries in use are never trimmed or evicted, so nothing changes while it stays in use.
+		policy.Touch(id, 2);
+
+		DF_CHECK(policy.Update(2, actions, DF_ARRAY_LENGTH(actions)) == 0);
+		DF_CHECK(policy.GetResidentMip(id) == 2);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_PinnedEntries)
+{
+	ResidencyPolicy policy;
+	policy.SetBudget(1000);
+
+	const EntryId pinned = RegisterTestEntry(policy, 2, 0);
+	const EntryId evictedPinned = RegisterTestEntry(policy, 2, TestMipCount);
+	const EntryId idle = RegisterTestEntry(policy, 2, 0);
+
+	policy.SetPinned(pinned, true);
+	policy.SetPinned(evictedPinned, true);
+
+	// Pinned entries still count against the budget.
+	DF_CHECK(policy.GetResidentSize() == 2048);
+
+	policy.Touch(evictedPinned, 1);
+
+	Action actions[4];
+
+	// Only the unpinned entry can give anything up, and the pinned entry in use isn't restored.
+	DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], idle, ActionType::Evict, TestMipCount));
+	DF_CHECK(policy.GetResidentSize() == 1024);
+	DF_CHECK(policy.GetResidentMip(pinned) == 0);
+	DF_CHECK(policy.GetResidentMip(evictedPinned) == TestMipCount);
+
+	// Unpinning lets the policy act on the entries again. Only evicting the idle entry makes enough room to bring the
+	// entry in use back entirely.
+	policy.SetPinned(pinned, false);
+	policy.SetPinned(evictedPinned, false);
+	policy.Touch(evictedPinned, 2);
+
+	DF_CHECK(policy.Update(2, actions, DF_ARRAY_LENGTH(actions)) == 2);
+	DF_CHECK(IsAction(actions[0], pinned, ActionType::Evict, TestMipCount));
+	DF_CHECK(IsAction(actions[1], evictedPinned, ActionType::Restore, 0));
+	DF_CHECK(policy.GetResidentSize() == 1024);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_RestoreUnderBudgetPressure)
+{
+	Action actions[4];
+
+	// Idle entries are trimmed to make room for the entry in use, which then comes back entirely.
+	{
+		ResidencyPolicy policy;
+		policy.SetBudget(1100);
+
+		const EntryId idle = RegisterTestEntry(policy, 2, 0);
+		const EntryId used = RegisterTestEntry(policy, 2, TestMipCount);
+
+		policy.Touch(used, 1);
+
+		DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 2);
+		DF_CHECK(IsAction(actions[0], idle, ActionType::Trim, 2));
+		DF_CHECK(IsAction(actions[1], used, ActionType::Restore, 0));
+		DF_CHECK(policy.GetResidentSize() == 64 + 1024);
+	}
+
+	// When even evicting the idle entries isn't enough, the entry in use gets back as many mips as fit.
+	{
+		ResidencyPolicy policy;
+		policy.SetBudget(400);
+
+		const EntryId idle = RegisterTestEntry(policy, 2, 1);
+		const EntryId used = RegisterTestEntry(policy, 2, TestMipCount);
+
+		policy.Touch(used, 1);
+
+		DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 2);
+		DF_CHECK(IsAction(actions[0], idle, ActionType::Evict, TestMipCount));
+		DF_CHECK(IsAction(actions[1], used, ActionType::Restore, 1));
+		DF_CHECK(policy.GetResidentSize() == 256);
+	}
+
+	// With room for only one action, the restore doesn't happen until the next update.
+	{
+		ResidencyPolicy policy;
+		policy.SetBudget(1100);
+
+		const EntryId idle = RegisterTestEntry(policy, 2, 0);
+		const EntryId used = RegisterTestEntry(policy, 2, TestMipCount);
+
+		policy.Touch(used, 1);
+
+		DF_CHECK(policy.Update(1, actions, 1) == 1);
+		DF_CHECK(IsAction(actions[0], idle, ActionType::Trim, 2));
+		DF_CHECK(policy.GetResidentMip(used) == TestMipCount);
+
+		policy.Touch(used, 2);
+
+		DF_CHECK(policy.Update(2, actions, 1) == 1);
+		DF_CHECK(IsAction(actions[0], used, ActionType::Restore, 0));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_SetResidentMipAfterFailedAction)
+{
+	ResidencyPolicy policy;
+	policy.SetBudget(0);
+
+	const EntryId id = RegisterTestEntry(policy, 2, 0);
+
+	Action actions[4];
+
+	DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], id, ActionType::Evict, TestMipCount));
+	DF_CHECK(policy.GetResidentSize() == 0);
+
+	// The caller couldn't apply the eviction, so it puts the policy back in line and pins the entry.
+	DF_CHECK(!policy.SetResidentMip(id, TestMipCount + 1));
+	DF_CHECK(policy.SetResidentMip(id, 0));
+	DF_CHECK(policy.SetPinned(id, true));
+	DF_CHECK(policy.GetResidentMip(id) == 0);
+	DF_CHECK(policy.GetResidentSize() == 1024);
+
+	DF_CHECK(policy.Update(2, actions, DF_ARRAY_LENGTH(actions)) == 0);
+	DF_CHECK(policy.GetResidentSize() == 1024);
+
+	// Unpinned, it's evicted again from the corrected residency.
+	DF_CHECK(policy.SetPinned(id, false));
+
+	DF_CHECK(policy.Update(3, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], id, ActionType::Evict, TestMipCount));
+	DF_CHECK(policy.GetResidentSize() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_PendingSizeCountsAgainstBudget)
+{
+	ResidencyPolicy policy;
+	policy.SetBudget(2048);
+
+	const EntryId pending = RegisterTestEntry(policy, 2, 0);
+	const EntryId idle = RegisterTestEntry(policy, 2, 0);
+
+	Action actions[4];
+
+	DF_CHECK(policy.Update(1, actions, DF_ARRAY_LENGTH(actions)) == 0);
+
+	DF_CHECK(!policy.SetPendingSize(ResidencyPolicy::InvalidEntryId, 512));
+	DF_CHECK(policy.SetPendingSize(pending, 512));
+	DF_CHECK(policy.SetPinned(pending, true));
+	DF_CHECK(policy.GetPendingSize() == 512);
+	DF_CHECK(policy.GetResidentSize() == 2048);
+
+	// The pending bytes push the policy over budget, and the room has to come from the other entry.
+	DF_CHECK(policy.Update(2, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], idle, ActionType::Trim, 1));
+	DF_CHECK(policy.GetResidentSize() == 1024 + 256);
+
+	// Restoring the idle entry has to wait until the pending bytes are released.
+	policy.Touch(idle, 3);
+
+	DF_CHECK(policy.Update(3, actions, DF_ARRAY_LENGTH(actions)) == 0);
+	DF_CHECK(policy.GetResidentMip(idle) == 1);
+
+	DF_CHECK(policy.SetPendingSize(pending, 0));
+	DF_CHECK(policy.GetPendingSize() == 0);
+
+	policy.Touch(idle, 4);
+
+	DF_CHECK(policy.Update(4, actions, DF_ARRAY_LENGTH(actions)) == 1);
+	DF_CHECK(IsAction(actions[0], idle, ActionType::Restore, 0));
+
+	// Unregistering an entry releases whatever it still had pending.
+	DF_CHECK(policy.SetPendingSize(pending, 128));
+	DF_CHECK(policy.Unregister(pending));
+	DF_CHECK(policy.GetPendingSize() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResidencyPolicy_RandomizedBudget)
+{
+	Test::Random random(37);
+
+	ResidencyPolicy policy;
+
+	EntryId ids[32];
+
+	for(size_t i = 0; i < DF_ARRAY_LENGTH(ids); ++i)
+	{
+		ids[i] = RegisterTestEntry(policy, random.Next(0, TestMipCount - 1), random.Next(0, TestMipCount));
+		DF_CHECK(ids[i] != ResidencyPolicy::InvalidEntryId);
+	}
+
+	Action actions[DF_ARRAY_LENGTH(ids)];
+
+	for(uint64_t frameIndex = 1; frameIndex <= 500; ++frameIndex)
+	{
+		policy.SetBudget(random.Next(0, 16 * 1024));
+
+		uint64_t usedSize = 0;
+
+		for(size_t i = 0; i < DF_ARRAY_LENGTH(ids); ++i)
+		{
+			if(random.Next(0, 7) == 0)
+			{
+				policy.Touch(ids[i], frameIndex);
+				usedSize += TestResidentSizes[0];
+			}
+		}
+
+		const size_t actionCount = policy.Update(frameIndex, actions, DF_ARRAY_LENGTH(actions));
+
+		uint64_t residentSize = 0;
+
+		for(size_t i = 0; i < DF_ARRAY_LENGTH(ids); ++i)
+		{
+			const uint32_t residentMip = policy.GetResidentMip(ids[i]);
+			residentSize += (residentMip < TestMipCount) ? TestResidentSizes[residentMip] : 0;
+		}
+
+		// The resident size always matches the resident mips, and only goes over budget because of entries in use.
+		DF_CHECK(residentSize == policy.GetResidentSize());
+		DF_CHECK(residentSize <= policy.GetBudget() || residentSize <= usedSize);
+
+		for(size_t actionIndex = 0; actionIndex < actionCount; ++actionIndex)
+		{
+			// Each entry gets at most one action per update.
+			for(size_t otherIndex = actionIndex + 1; otherIndex < actionCount; ++otherIndex)
+			{
+				DF_CHECK(actions[actionIndex].id != actions[otherIndex].id);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
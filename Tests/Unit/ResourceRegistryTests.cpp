@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/ResourceRegistry.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::ResourceRegistry ResourceRegistry;
+typedef ResourceRegistry::ObjectPtr ObjectPtr;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t ContentionThreadCount = 8;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Run the same function on several threads at once, releasing them all together so they actually contend.
+template <typename Func>
+static void RunContended(const uint32_t threadCount, const Func& func)
+{
+	std::atomic<uint32_t> readyCount(0);
+	std::atomic<bool> start(false);
+
+	std::vector<std::thread> threads;
+
+	for(uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+	{
+		threads.emplace_back(
+			[&readyCount, &start, &func, threadIndex]()
+			{
+				readyCount.fetch_add(1);
+
+				while(!start.load())
+				{
+					std::this_thread::yield();
+				}
+
+				func(threadIndex);
+			});
+	}
+
+	while(readyCount.load() < threadCount)
+	{
+		std::this_thread::yield();
+	}
+
+	start.store(true);
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Block the load running on this thread until the given number of callers are waiting on it.
+static void WaitForCoalescedCount(const ResourceRegistry& registry, const uint64_t coalescedCount)
+{
+	while(registry.GetStats().coalescedCount < coalescedCount)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResourceRegistry_FindOrLoad)
+{
+	ResourceRegistry registry;
+
+	uint32_t loadCount = 0;
+
+	const ResourceRegistry::LoadFunc load = [&loadCount]() { ++loadCount; return std::make_shared<int>(42); };
+
+	DF_CHECK(!registry.Find(1));
+
+	ObjectPtr object = registry.FindOrLoad(1, load);
+
+	DF_CHECK(object != nullptr);
+	DF_CHECK(loadCount == 1);
+	DF_CHECK(registry.Find(1) == object);
+	DF_CHECK(registry.FindOrLoad(1, load) == object);
+	DF_CHECK(loadCount == 1);
+
+	// Objects are only held weakly, so once the last reference is gone the next request loads the key again.
+	object.reset();
+
+	DF_CHECK(!registry.Find(1));
+	DF_CHECK(registry.GetEntryCount() == 1);
+
+	registry.Prune();
+
+	DF_CHECK(registry.GetEntryCount() == 0);
+
+	object = registry.FindOrLoad(1, load);
+
+	DF_CHECK(object != nullptr);
+	DF_CHECK(loadCount == 2);
+
+	// A missing load function is a failed load.
+	DF_CHECK(!registry.FindOrLoad(2, ResourceRegistry::LoadFunc()));
+
+	const ResourceRegistry::Stats stats = registry.GetStats();
+
+	DF_CHECK(stats.hitCount == 1);
+	DF_CHECK(stats.loadCount == 3);
+	DF_CHECK(stats.coalescedCount == 0);
+	DF_CHECK(stats.failedCount == 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResourceRegistry_ContendedLoad)
+{
+	ResourceRegistry registry;
+
+	std::atomic<uint32_t> loadCount(0);
+
+	ObjectPtr results[ContentionThreadCount];
+
+	// The load holds off until every other thread has asked for the key, so they all have to share its result.
+	RunContended(
+		ContentionThreadCount,
+		[&registry, &loadCount, &results](const uint32_t threadIndex)
+		{
+			results[threadIndex] = registry.FindOrLoad(
+				7,
+				[&registry, &loadCount]()
+				{
+					loadCount.fetch_add(1);
+					WaitForCoalescedCount(registry, ContentionThreadCount - 1);
+
+					return std::make_shared<int>(7);
+				});
+		});
+
+	DF_CHECK(loadCount.load() == 1);
+
+	for(const ObjectPtr& result : results)
+	{
+		DF_CHECK(result != nullptr);
+		DF_CHECK(result == results[0]);
+	}
+
+	const ResourceRegistry::Stats stats = registry.GetStats();
+
+	DF_CHECK(stats.loadCount == 1);
+	DF_CHECK(stats.coalescedCount == ContentionThreadCount - 1);
+	DF_CHECK(stats.failedCount == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResourceRegistry_FailedLoadIsRetried)
+{
+	ResourceRegistry registry;
+
+	std::atomic<uint32_t> loadCount(0);
+
+	ObjectPtr results[ContentionThreadCount];
+
+	// Every caller waiting on a failed load gets nothing.
+	RunContended(
+		ContentionThreadCount,
+		[&registry, &loadCount, &results](const uint32_t threadIndex)
+		{
+			results[threadIndex] = registry.FindOrLoad(
+				7,
+				[&registry, &loadCount]()
+				{
+					loadCount.fetch_add(1);
+					WaitForCoalescedCount(registry, ContentionThreadCount - 1);
+
+					return ObjectPtr();
+				});
+		});
+
+	DF_CHECK(loadCount.load() == 1);
+
+	for(const ObjectPtr& result : results)
+	{
+		DF_CHECK(result == nullptr);
+	}
+
+	DF_CHECK(registry.GetEntryCount() == 0);
+
+	// The failure isn't remembered, so the next request loads the key again.
+	const ObjectPtr object = registry.FindOrLoad(7, []() { return std::make_shared<int>(7); });
+
+	DF_CHECK(object != nullptr);
+	DF_CHECK(registry.Find(7) == object);
+	DF_CHECK(registry.GetStats().failedCount == 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ResourceRegistry_ThrowingLoad)
+{
+	ResourceRegistry registry;
+
+	std::atomic<bool> loaderThrew(false);
+
+	ObjectPtr waiterResult = std::make_shared<int>(0);
+
+	std::thread loader(
+		[&registry, &loaderThrew]()
+		{
+			try
+			{
+				registry.FindOrLoad(
+					7,
+					[&registry]() -> ObjectPtr
+					{
+						WaitForCoalescedCount(registry, 1);
+						throw std::runtime_error("load failed");
+					});
+			}
+			catch(const std::runtime_error&)
+			{
+				loaderThrew.store(true);
+			}
+		});
+
+	// Only start waiting once the load is in flight, so this thread is the one left waiting on it.
+	while(registry.GetStats().loadCount == 0)
+	{
+		std::this_thread::yield();
+	}
+
+	waiterResult = registry.FindOrLoad(7, []() { return std::make_shared<int>(8); });
+
+	loader.join();
+
+	// The exception reaches the caller that ran the load, and the caller waiting on it is let go with nothing.
+	DF_CHECK(loaderThrew.load());
+	DF_CHECK(waiterResult == nullptr);
+	DF_CHECK(registry.GetEntryCount() == 0);
+	DF_CHECK(registry.GetStats().failedCount == 1);
+
+	const ObjectPtr object = registry.FindOrLoad(7, []() { return std::make_shared<int>(7); });
+
+	DF_CHECK(object != nullptr);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,285 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/RingAllocator.hpp>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::RingAllocator RingAllocator;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(RingAllocator_NonPowerOfTwoAlignment)
+{
+	RingAllocator ring;
+	ring.Reset(1000);
+
+	DF_CHECK(ring.Allocate(10, 1) == 0);
+	DF_CHECK(ring.Allocate(10, 24) == 24);
+	DF_CHECK(ring.Allocate(7, 100) == 100);
+
+	// An alignment of 0 is treated as no alignment at all.
+	DF_CHECK(ring.Allocate(5, 0) == 107);
+
+	// Padding in front of an aligned allocation counts toward the used size.
+	DF_CHECK(ring.GetUsedSize() == 112);
+	DF_CHECK(ring.GetOpenSize() == 112);
+
+	const uint64_t alignments[] = { 3, 5, 7, 12, 48, 100 };
+
+	for(const uint64_t alignment : alignments)
+	{
+		const uint64_t offset = ring.Allocate(1, alignment);
+
+		DF_CHECK(offset != RingAllocator::InvalidOffset);
+		DF_CHECK(offset % alignment == 0);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(RingAllocator_WrapSkipsTail)
+{
+	RingAllocator ring;
+	ring.Reset(100);
+
+	DF_CHECK(ring.Allocate(60, 1) == 0);
+	ring.Close(1);
+
+	DF_CHECK(ring.Allocate(30, 1) == 60);
+	ring.Close(2);
+
+	ring.Retire(1);
+	DF_CHECK(ring.GetUsedSize() == 30);
+
+	// Only 10 bytes are left before the end of the ring, so the allocation starts over from the beginning and the
+	// skipped tail is charged to it.
+	DF_CHECK(ring.Allocate(20, 1) == 0);
+	DF_CHECK(ring.GetUsedSize() == 60);
+	DF_CHECK(ring.GetOpenSize() == 30);
+	ring.Close(3);
+
+	// Retiring the allocation that wrapped gives the skipped tail back too.
+	ring.Retire(2);
+	DF_CHECK(ring.GetUsedSize() == 30);
+
+	ring.Retire(3);
+	DF_CHECK(ring.GetUsedSize() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(RingAllocator_InvalidOffsetWhenFull)
+{
+	RingAllocator ring;
+
+	// Nothing fits in a ring that was never given a size.
+	DF_CHECK(ring.Allocate(1, 1) == RingAllocator::InvalidOffset);
+
+	ring.Reset(64);
+
+	DF_CHECK(ring.Allocate(0, 1) == RingAllocator::InvalidOffset);
+	DF_CHECK(ring.Allocate(65, 1) == RingAllocator::InvalidOffset);
+
+	DF_CHECK(ring.Allocate(64, 1) == 0);
+	DF_CHECK(ring.Allocate(1, 1) == RingAllocator::InvalidOffset);
+
+	ring.Close(1);
+	ring.Retire(0);
+	DF_CHECK(ring.Allocate(1, 1) == RingAllocator::InvalidOffset);
+
+	ring.Retire(1);
+	DF_CHECK(ring.Allocate(1, 1) == 0);
+
+	// Wrapping must not run into the oldest allocation still in use.
+	ring.Reset(100);
+
+	DF_CHECK(ring.Allocate(40, 1) == 0);
+	ring.Close(1);
+
+	DF_CHECK(ring.Allocate(40, 1) == 40);
+	ring.Close(2);
+
+	ring.Retire(1);
+
+	DF_CHECK(ring.Allocate(50, 1) == RingAllocator::InvalidOffset);
+	DF_CHECK(ring.GetUsedSize() == 40);
+
+	DF_CHECK(ring.Allocate(40, 1) == 0);
+	DF_CHECK(ring.Allocate(1, 1) == RingAllocator::InvalidOffset);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(RingAllocator_FenceOrdering)
+{
+	RingAllocator ring;
+	ring.Reset(1000);
+
+	uint64_t oldestFenceValue = 0;
+	DF_CHECK(!ring.GetOldestFenceValue(oldestFenceValue));
+
+	DF_CHECK(ring.Allocate(100, 1) == 0);
+	ring.Close(5);
+
+	DF_CHECK(ring.Allocate(200, 1) == 100);
+	ring.Close(7);
+
+	// Closing with nothing open doesn't add a batch.
+	ring.Close(8);
+
+	DF_CHECK(ring.Allocate(50, 1) == 300);
+
+	DF_CHECK(ring.GetOldestFenceValue(oldestFenceValue));
+	DF_CHECK(oldestFenceValue == 5);
+
+	ring.Retire(4);
+	DF_CHECK(ring.GetUsedSize() == 350);
+
+	ring.Retire(6);
+	DF_CHECK(ring.GetUsedSize() == 250);
+	DF_CHECK(ring.GetOldestFenceValue(oldestFenceValue));
+	DF_CHECK(oldestFenceValue == 7);
+
+	// Open allocations are never retired, and the head stays put while they're alive.
+	ring.Retire(100);
+	DF_CHECK(ring.GetUsedSize() == 50);
+	DF_CHECK(ring.GetOpenSize() == 50);
+	DF_CHECK(!ring.GetOldestFenceValue(oldestFenceValue));
+	DF_CHECK(ring.Allocate(10, 1) == 350);
+
+	ring.Close(101);
+	ring.Retire(101);
+	DF_CHECK(ring.GetUsedSize() == 0);
+
+	// An empty ring starts over from the beginning.
+	DF_CHECK(ring.Allocate(10, 1) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(RingAllocator_RandomizedNoOverlap)
+{
+	struct LiveAllocation
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint64_t fenceValue;
+	};
+
+	Test::Random random(34);
+
+	for(uint32_t runIndex = 0; runIndex < 50; ++runIndex)
+	{
+		RingAllocator ring;
+
+		const uint64_t capacity = random.Next(64, 64 * 1024);
+		ring.Reset(capacity);
+
+		std::vector<LiveAllocation> liveAllocations;
+
+		uint64_t nextFenceValue = 1;
+		uint64_t completedFenceValue = 0;
+
+		for(uint32_t stepIndex = 0; stepIndex < 500; ++stepIndex)
+		{
+			const uint32_t action = random.Next(0, 9);
+
+			if(action < 6)
+			{
+				const uint64_t size = random.Next(1, uint32_t(capacity / 4));
+				const uint64_t alignment = random.Next(1, 300);
+
+				const uint64_t offset = ring.Allocate(size, alignment);
+				if(offset == RingAllocator::InvalidOffset)
+				{
+					continue;
+				}
+
+				DF_CHECK(offset % alignment == 0);
+				DF_CHECK(offset + size <= capacity);
+
+				for(const LiveAllocation& other : liveAllocations)
+				{
+					DF_CHECK(offset + size <= other.offset || other.offset + other.size <= offset);
+				}
+
+				// Open allocations have no fence value yet.
+				liveAllocations.push_back({ offset, size, UINT64_MAX });
+			}
+			else if(action < 8)
+			{
+				ring.Close(nextFenceValue);
+
+				for(LiveAllocation& allocation : liveAllocations)
+				{
+					if(allocation.fenceValue == UINT64_MAX)
+					{
+						allocation.fenceValue = nextFenceValue;
+					}
+				}
+
+				++nextFenceValue;
+			}
+			else
+			{
+				// Fences complete in order, but not necessarily one at a time.
+				completedFenceValue = random.Next(uint32_t(completedFenceValue), uint32_t(nextFenceValue - 1));
+				ring.Retire(completedFenceValue);
+
+				for(size_t i = 0; i < liveAllocations.size();)
+				{
+					if(liveAllocations[i].fenceValue <= completedFenceValue)
+					{
+						liveAllocations[i] = liveAllocations.back();
+						liveAllocations.pop_back();
+					}
+					else
+					{
+						++i;
+					}
+				}
+			}
+
+			uint64_t liveSize = 0;
+
+			for(const LiveAllocation& allocation : liveAllocations)
+			{
+				liveSize += allocation.size;
+			}
+
+			DF_CHECK(ring.GetUsedSize() >= liveSize);
+			DF_CHECK(ring.GetUsedSize() <= capacity);
+		}
+
+		// Once everything has been retired, the whole ring is available again.
+		ring.Close(nextFenceValue);
+		ring.Retire(nextFenceValue);
+
+		DF_CHECK(ring.GetUsedSize() == 0);
+		DF_CHECK(ring.Allocate(capacity, 1) == 0);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,246 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/CpuFeatures.hpp>
+#include <DemoFramework/Utility/ShProjection.hpp>
+#include <DemoFramework/Utility/ThreadPool.hpp>
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::CpuFeatures CpuFeatures;
+typedef Utility::ImageResampler ImageResampler;
+typedef Utility::ShProjection ShProjection;
+typedef Utility::ThreadPool ThreadPool;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct TestCube
+{
+	std::vector<float> texels;
+	ImageResampler::ConstImage faces[6];
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Fill a cube map with random HDR colors. Rows are padded so the row pitch differs from the packed width.
+static void MakeTestCube(const uint32_t edgeLength, const uint64_t seed, TestCube& outCube)
+{
+	const size_t rowFloatCount = (size_t(edgeLength) + 3) * 4;
+	const size_t faceFloatCount = rowFloatCount * edgeLength;
+
+	Test::Random random(seed);
+
+	outCube.texels.resize(faceFloatCount * 6);
+
+	for(float& value : outCube.texels)
+	{
+		value = (float(random.Next()) / float(0xFFFFFFFFu)) * 4.0f;
+	}
+
+	for(uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+	{
+		ImageResampler::ConstImage& face = outCube.faces[faceIndex];
+
+		face.pData = reinterpret_cast<const uint8_t*>(outCube.texels.data() + (faceFloatCount * faceIndex));
+		face.rowPitch = rowFloatCount * sizeof(float);
+		face.width = edgeLength;
+		face.height = edgeLength;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool ProjectWith(
+	const TestCube& cube,
+	const uint32_t edgeLength,
+	ThreadPool* const pThreadPool,
+	const bool baselineOnly,
+	ShProjection::Coefficients& outCoefficients)
+{
+	memset(&outCoefficients, 0, sizeof(outCoefficients));
+
+	CpuFeatures::SetBaselineOnly(baselineOnly);
+	const bool result = ShProjection::Project(cube.faces, edgeLength, pThreadPool, outCoefficients);
+	CpuFeatures::SetBaselineOnly(false);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ShProjection_Validation)
+{
+	TestCube cube;
+	MakeTestCube(8, 1, cube);
+
+	ShProjection::Coefficients coefficients;
+
+	DF_CHECK(ShProjection::Project(cube.faces, 8, nullptr, coefficients));
+	DF_CHECK(!ShProjection::Project(nullptr, 8, nullptr, coefficients));
+	DF_CHECK(!ShProjection::Project(cube.faces, 0, nullptr, coefficients));
+	DF_CHECK(!ShProjection::Project(cube.faces, 4, nullptr, coefficients));
+
+	cube.faces[3].rowPitch = 7 * sizeof(float) * 4;
+	DF_CHECK(!ShProjection::Project(cube.faces, 8, nullptr, coefficients));
+
+	cube.faces[3].rowPitch = 8 * sizeof(float) * 4;
+	cube.faces[5].pData = nullptr;
+	DF_CHECK(!ShProjection::Project(cube.faces, 8, nullptr, coefficients));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ShProjection_Deterministic)
+{
+	const ThreadPool::Ptr singleThreadPool = ThreadPool::Create(1);
+	const ThreadPool::Ptr multiThreadPool = ThreadPool::Create(8);
+
+	// Edge lengths around the 8-wide AVX2 kernel and the rows-per-task split.
+	const uint32_t edgeLengths[] = { 1, 7, 8, 37, 64, 130 };
+
+	for(const uint32_t edgeLength : edgeLengths)
+	{
+		TestCube cube;
+		MakeTestCube(edgeLength, 45 + edgeLength, cube);
+
+		// Everything is compared against the scalar kernels on the calling thread.
+		ShProjection::Coefficients expected;
+		DF_CHECK(ProjectWith(cube, edgeLength, nullptr, true, expected));
+
+		for(const bool baselineOnly : { true, false })
+		{
+			ThreadPool* const threadPools[] = { nullptr, singleThreadPool.get(), multiThreadPool.get() };
+
+			for(ThreadPool* const pThreadPool : threadPools)
+			{
+				ShProjection::Coefficients coefficients;
+
+				DF_CHECK(ProjectWith(cube, edgeLength, pThreadPool, baselineOnly, coefficients));
+				DF_CHECK(memcmp(&coefficients, &expected, sizeof(expected)) == 0);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ShProjection_MatchesReference)
+{
+	constexpr uint32_t edgeLength = 24;
+
+	TestCube cube;
+	MakeTestCube(edgeLength, 451, cube);
+
+	ShProjection::Coefficients coefficients;
+	DF_CHECK(ProjectWith(cube, edgeLength, nullptr, false, coefficients));
+
+	// Straightforward double precision sum over every texel using the single-texel helpers.
+	const float invEdgeLength = 1.0f / float(edgeLength);
+
+	double sums[DF_SH_PROJECTION_COEFF_COUNT][3] = {};
+	double weightSum = 0.0;
+
+	for(uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+	{
+		const ImageResampler::ConstImage& face = cube.faces[faceIndex];
+
+		for(uint32_t y = 0; y < edgeLength; ++y)
+		{
+			const float* const pRow = reinterpret_cast<const float*>(face.pData + (face.rowPitch * y));
+
+			for(uint32_t x = 0; x < edgeLength; ++x)
+			{
+				float normal[3];
+				ShProjection::CalculateNormalFromPixelCoord(x, y, faceIndex, invEdgeLength, normal);
+
+				const ShProjection::Basis basis = ShProjection::CalculateShProjectionBasis(normal);
+				const double weight = ShProjection::CalculateDifferentialSolidAngle(x, y, invEdgeLength);
+
+				for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+				{
+					for(uint32_t channel = 0; channel < 3; ++channel)
+					{
+						sums[coeffIndex][channel] += double(pRow[(x * 4) + channel]) * double(basis.value[coeffIndex]) * weight;
+					}
+				}
+
+				weightSum += weight;
+			}
+		}
+	}
+
+	const double fourPi = 4.0 * 3.14159265358979323846;
+
+	double maxError = 0.0;
+
+	for(uint32_t coeffIndex = 0; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+	{
+		for(uint32_t channel = 0; channel < 3; ++channel)
+		{
+			const double expected = (sums[coeffIndex][channel] / weightSum) * fourPi;
+			const double error = fabs(double(coefficients.value[coeffIndex][channel]) - expected);
+
+			maxError = (error > maxError) ? error : maxError;
+		}
+	}
+
+	DF_CHECK(maxError < 1.0e-4);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(ShProjection_ConstantColor)
+{
+	constexpr uint32_t edgeLength = 32;
+
+	TestCube cube;
+	MakeTestCube(edgeLength, 1, cube);
+
+	const float color[3] = { 0.25f, 1.0f, 3.0f };
+
+	for(size_t index = 0; index < cube.texels.size(); ++index)
+	{
+		cube.texels[index] = ((index % 4) < 3) ? color[index % 4] : 1.0f;
+	}
+
+	ShProjection::Coefficients coefficients;
+	DF_CHECK(ProjectWith(cube, edgeLength, nullptr, false, coefficients));
+
+	// A constant sphere only has a DC term: color * Y00 * 4pi.
+	const float dcScale = 0.282095f * 4.0f * 3.14159265f;
+
+	for(uint32_t channel = 0; channel < 3; ++channel)
+	{
+		DF_CHECK(fabsf(coefficients.value[0][channel] - (color[channel] * dcScale)) < 1.0e-3f * color[channel]);
+
+		for(uint32_t coeffIndex = 1; coeffIndex < DF_SH_PROJECTION_COEFF_COUNT; ++coeffIndex)
+		{
+			DF_CHECK(fabsf(coefficients.value[coeffIndex][channel]) < 1.0e-4f);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
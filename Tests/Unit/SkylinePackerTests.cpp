@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/SkylinePacker.hpp>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::SkylinePacker SkylinePacker;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool IsInBounds(const SkylinePacker::Rect& rect, const uint32_t width, const uint32_t height)
+{
+	return (rect.x + rect.width <= width) && (rect.y + rect.height <= height);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool IsOverlapping(const SkylinePacker::Rect& left, const SkylinePacker::Rect& right)
+{
+	return (left.x < right.x + right.width)
+		&& (right.x < left.x + left.width)
+		&& (left.y < right.y + right.height)
+		&& (right.y < left.y + left.height);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void FillRandomSizes(Test::Random& random, const uint32_t maxSize, std::vector<SkylinePacker::Size>& outSizes)
+{
+	for(SkylinePacker::Size& size : outSizes)
+	{
+		// Mostly power-of-2 sizes like the textures the packer is meant for, with some odd ones mixed in.
+		if(random.Next(0, 3) == 0)
+		{
+			size.width = random.Next(1, maxSize);
+			size.height = random.Next(1, maxSize);
+		}
+		else
+		{
+			size.width = 1u << random.Next(0, 6);
+			size.height = 1u << random.Next(0, 6);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_InsertValidation)
+{
+	SkylinePacker packer;
+	packer.Reset(64, 32);
+
+	SkylinePacker::Rect rect;
+
+	DF_CHECK(!packer.Insert(0, 8, rect));
+	DF_CHECK(!packer.Insert(8, 0, rect));
+	DF_CHECK(!packer.Insert(65, 8, rect));
+	DF_CHECK(!packer.Insert(8, 33, rect));
+	DF_CHECK(packer.GetUsedArea() == 0);
+
+	DF_CHECK(packer.Insert(64, 32, rect));
+	DF_CHECK(rect.x == 0 && rect.y == 0 && rect.width == 64 && rect.height == 32);
+	DF_CHECK(packer.GetOccupancy() == 1.0f);
+
+	// Nothing else fits on a full area, no matter how small.
+	DF_CHECK(!packer.Insert(1, 1, rect));
+
+	// Resetting starts over with an empty area.
+	packer.Reset(16, 16);
+
+	DF_CHECK(packer.GetWidth() == 16);
+	DF_CHECK(packer.GetHeight() == 16);
+	DF_CHECK(packer.GetUsedArea() == 0);
+	DF_CHECK(packer.Insert(16, 16, rect));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_BottomLeftPlacement)
+{
+	SkylinePacker packer;
+	packer.Reset(128, 128);
+
+	SkylinePacker::Rect rect;
+
+	// Each rectangle goes where its top edge ends up lowest, so the first row fills up left to right.
+	DF_CHECK(packer.Insert(64, 64, rect));
+	DF_CHECK(rect.x == 0 && rect.y == 0);
+
+	DF_CHECK(packer.Insert(32, 32, rect));
+	DF_CHECK(rect.x == 64 && rect.y == 0);
+
+	DF_CHECK(packer.Insert(32, 32, rect));
+	DF_CHECK(rect.x == 96 && rect.y == 0);
+
+	// The lowest spot left is on top of the two small rectangles, not on top of the big one.
+	DF_CHECK(packer.Insert(64, 32, rect));
+	DF_CHECK(rect.x == 64 && rect.y == 32);
+
+	// Four quadrants fill the area exactly.
+	DF_CHECK(packer.Insert(64, 64, rect));
+	DF_CHECK(rect.x == 0 && rect.y == 64);
+
+	DF_CHECK(packer.Insert(64, 64, rect));
+	DF_CHECK(rect.x == 64 && rect.y == 64);
+
+	DF_CHECK(packer.GetUsedArea() == 128 * 128);
+	DF_CHECK(!packer.Insert(1, 1, rect));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_RandomizedInsert)
+{
+	Test::Random random(38);
+
+	SkylinePacker packer;
+
+	std::vector<SkylinePacker::Rect> rects;
+
+	for(uint32_t round = 0; round < 50; ++round)
+	{
+		const uint32_t width = random.Next(16, 256);
+		const uint32_t height = random.Next(16, 256);
+
+		packer.Reset(width, height);
+		rects.clear();
+
+		uint64_t usedArea = 0;
+
+		for(uint32_t insertIndex = 0; insertIndex < 200; ++insertIndex)
+		{
+			const uint32_t rectWidth = random.Next(1, 48);
+			const uint32_t rectHeight = random.Next(1, 48);
+
+			SkylinePacker::Rect rect;
+
+			if(!packer.Insert(rectWidth, rectHeight, rect))
+			{
+				continue;
+			}
+
+			DF_CHECK(rect.width == rectWidth && rect.height == rectHeight);
+			DF_CHECK(IsInBounds(rect, width, height));
+
+			for(const SkylinePacker::Rect& other : rects)
+			{
+				DF_CHECK(!IsOverlapping(rect, other));
+			}
+
+			rects.push_back(rect);
+			usedArea += uint64_t(rectWidth) * uint64_t(rectHeight);
+		}
+
+		DF_CHECK(packer.GetUsedArea() == usedArea);
+		DF_CHECK(packer.GetOccupancy() <= 1.0f);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_PackPagesValidation)
+{
+	const SkylinePacker::Size sizes[] =
+	{
+		{ 64, 64 },
+		{ 65, 16 },
+	};
+
+	SkylinePacker::PagePlacement placements[DF_ARRAY_LENGTH(sizes)];
+
+	DF_CHECK(SkylinePacker::PackPages(0, 64, sizes, 1, placements) == 0);
+	DF_CHECK(SkylinePacker::PackPages(64, 64, nullptr, 1, placements) == 0);
+	DF_CHECK(SkylinePacker::PackPages(64, 64, sizes, 0, placements) == 0);
+	DF_CHECK(SkylinePacker::PackPages(64, 64, sizes, 1, nullptr) == 0);
+
+	// Any rectangle that's larger than a page fails the whole pack.
+	DF_CHECK(SkylinePacker::PackPages(64, 64, sizes, DF_ARRAY_LENGTH(sizes), placements) == 0);
+
+	DF_CHECK(SkylinePacker::PackPages(64, 64, sizes, 1, placements) == 1);
+	DF_CHECK(placements[0].pageIndex == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_PackPagesCount)
+{
+	std::vector<SkylinePacker::Size> sizes(16);
+	std::vector<SkylinePacker::PagePlacement> placements(17);
+
+	for(SkylinePacker::Size& size : sizes)
+	{
+		size.width = 128;
+		size.height = 128;
+	}
+
+	// Sixteen 128x128 rectangles fill a 512x512 page exactly, and one more needs a page of its own.
+	DF_CHECK(SkylinePacker::PackPages(512, 512, sizes.data(), sizes.size(), placements.data()) == 1);
+
+	sizes.push_back(sizes.back());
+
+	DF_CHECK(SkylinePacker::PackPages(512, 512, sizes.data(), sizes.size(), placements.data()) == 2);
+	DF_CHECK(placements[16].pageIndex == 1);
+
+	// Rectangles are placed tallest first, so the small ones are fit into the gaps left on the first page.
+	const SkylinePacker::Size mixedSizes[] =
+	{
+		{ 16, 16 },
+		{ 256, 192 },
+		{ 16, 16 },
+		{ 256, 256 },
+	};
+
+	SkylinePacker::PagePlacement mixedPlacements[DF_ARRAY_LENGTH(mixedSizes)];
+
+	DF_CHECK(SkylinePacker::PackPages(512, 256, mixedSizes, DF_ARRAY_LENGTH(mixedSizes), mixedPlacements) == 1);
+	DF_CHECK(mixedPlacements[3].rect.x == 0 && mixedPlacements[3].rect.y == 0);
+	DF_CHECK(mixedPlacements[1].rect.x == 256 && mixedPlacements[1].rect.y == 0);
+	DF_CHECK(mixedPlacements[0].rect.x == 256 && mixedPlacements[0].rect.y == 192);
+	DF_CHECK(mixedPlacements[2].rect.x == 272 && mixedPlacements[2].rect.y == 192);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(SkylinePacker_RandomizedPackPages)
+{
+	Test::Random random(3838);
+
+	constexpr uint32_t pageWidth = 256;
+	constexpr uint32_t pageHeight = 128;
+
+	for(uint32_t round = 0; round < 20; ++round)
+	{
+		std::vector<SkylinePacker::Size> sizes(random.Next(1, 400));
+		std::vector<SkylinePacker::PagePlacement> placements(sizes.size());
+		std::vector<SkylinePacker::PagePlacement> repeatPlacements(sizes.size());
+
+		FillRandomSizes(random, 128, sizes);
+
+		const uint32_t pageCount = SkylinePacker::PackPages(pageWidth, pageHeight, sizes.data(), sizes.size(), placements.data());
+
+		uint64_t totalArea = 0;
+
+		std::vector<uint64_t> pageAreas(pageCount, 0);
+
+		for(size_t index = 0; index < sizes.size(); ++index)
+		{
+			const SkylinePacker::PagePlacement& placement = placements[index];
+
+			DF_CHECK(placement.pageIndex < pageCount);
+			DF_CHECK(placement.rect.width == sizes[index].width && placement.rect.height == sizes[index].height);
+			DF_CHECK(IsInBounds(placement.rect, pageWidth, pageHeight));
+
+			for(size_t otherIndex = 0; otherIndex < index; ++otherIndex)
+			{
+				if(placements[otherIndex].pageIndex == placement.pageIndex)
+				{
+					DF_CHECK(!IsOverlapping(placement.rect, placements[otherIndex].rect));
+				}
+			}
+
+			const uint64_t area = uint64_t(sizes[index].width) * uint64_t(sizes[index].height);
+
+			totalArea += area;
+
+			if(placement.pageIndex < pageCount)
+			{
+				pageAreas[placement.pageIndex] += area;
+			}
+		}
+
+		// No page is opened without something on it, and there can't be fewer pages than the area needs.
+		const uint64_t pageArea = uint64_t(pageWidth) * uint64_t(pageHeight);
+
+		DF_CHECK(uint64_t(pageCount) * pageArea >= totalArea);
+
+		for(const uint64_t area : pageAreas)
+		{
+			DF_CHECK(area > 0);
+		}
+
+		// Packing the same list again gives exactly the same result.
+		DF_CHECK(SkylinePacker::PackPages(pageWidth, pageHeight, sizes.data(), sizes.size(), repeatPlacements.data()) == pageCount);
+
+		for(size_t index = 0; index < sizes.size(); ++index)
+		{
+			const SkylinePacker::PagePlacement& left = placements[index];
+			const SkylinePacker::PagePlacement& right = repeatPlacements[index];
+
+			DF_CHECK(left.pageIndex == right.pageIndex);
+			DF_CHECK(left.rect.x == right.rect.x && left.rect.y == right.rect.y);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
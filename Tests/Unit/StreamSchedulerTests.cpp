@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/StreamScheduler.hpp>
+
+#include <map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::StreamScheduler::Chunk Chunk;
+typedef Utility::StreamScheduler::RequestId RequestId;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Schedule frames until the queue is empty, checking that each frame stays inside its budget and that the chunks of
+// every request are contiguous. Returns the order requests completed in.
+static std::vector<RequestId> DrainScheduler(
+	Utility::StreamScheduler& scheduler,
+	const uint64_t byteBudget,
+	const uint64_t minChunkSize,
+	std::map<RequestId, uint64_t>& streamedBytes)
+{
+	std::vector<RequestId> completionOrder;
+
+	Chunk chunks[64];
+
+	for(uint32_t frameIndex = 0; scheduler.GetPendingCount() > 0; ++frameIndex)
+	{
+		const size_t chunkCount = scheduler.Schedule(byteBudget, chunks, DF_ARRAY_LENGTH(chunks));
+
+		DF_CHECK(chunkCount > 0);
+		DF_CHECK(frameIndex < 100000);
+
+		if(chunkCount == 0 || frameIndex >= 100000)
+		{
+			break;
+		}
+
+		uint64_t frameBytes = 0;
+
+		for(size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			const Chunk& chunk = chunks[chunkIndex];
+
+			DF_CHECK(chunk.size > 0);
+			DF_CHECK(chunk.offset == streamedBytes[chunk.requestId]);
+
+			streamedBytes[chunk.requestId] += chunk.size;
+			frameBytes += chunk.size;
+
+			if(chunk.lastChunk)
+			{
+				completionOrder.push_back(chunk.requestId);
+			}
+		}
+
+		// The budget may only be exceeded by a single forced chunk when nothing else fits.
+		DF_CHECK(frameBytes <= byteBudget || (chunkCount == 1 && frameBytes <= minChunkSize));
+	}
+
+	return completionOrder;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_PriorityThenFifoOrder)
+{
+	Utility::StreamScheduler scheduler;
+
+	const RequestId lowA = scheduler.Enqueue(1000, 2);
+	const RequestId highA = scheduler.Enqueue(1000, 0);
+	const RequestId midA = scheduler.Enqueue(1000, 1);
+	const RequestId highB = scheduler.Enqueue(1000, 0);
+	const RequestId lowB = scheduler.Enqueue(1000, 2);
+
+	DF_CHECK(scheduler.GetPendingCount() == 5);
+	DF_CHECK(scheduler.GetPendingBytes() == 5000);
+
+	std::map<RequestId, uint64_t> streamedBytes;
+
+	const std::vector<RequestId> order = DrainScheduler(scheduler, 1500, 64 * 1024, streamedBytes);
+	const std::vector<RequestId> expectedOrder = { highA, highB, midA, lowA, lowB };
+
+	DF_CHECK(order == expectedOrder);
+	DF_CHECK(scheduler.GetPendingBytes() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_BudgetAndAlignment)
+{
+	Utility::StreamScheduler scheduler;
+	scheduler.SetMinChunkSize(256);
+
+	// Alignments don't need to be a power of 2, since row pitches of odd-sized textures aren't.
+	const RequestId request = scheduler.Enqueue(10000, 0, 768);
+
+	Chunk chunks[8];
+
+	const size_t chunkCount = scheduler.Schedule(2000, chunks, DF_ARRAY_LENGTH(chunks));
+
+	DF_CHECK(chunkCount == 1);
+	DF_CHECK(chunks[0].requestId == request);
+	DF_CHECK(chunks[0].offset == 0);
+	DF_CHECK(chunks[0].size == 1536);
+	DF_CHECK(!chunks[0].lastChunk);
+	DF_CHECK(scheduler.GetPendingBytes() == 10000 - 1536);
+
+	std::map<RequestId, uint64_t> streamedBytes;
+	streamedBytes[request] = 1536;
+
+	DrainScheduler(scheduler, 2000, 256, streamedBytes);
+
+	DF_CHECK(streamedBytes[request] == 10000);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_SmallBudgetForcesMinimumChunk)
+{
+	Utility::StreamScheduler scheduler;
+	scheduler.SetMinChunkSize(1000);
+
+	const RequestId request = scheduler.Enqueue(5000, 0, 300);
+
+	Chunk chunks[8];
+
+	// Nothing fits in the budget, so one minimum-sized chunk is rounded up to the alignment and forced through.
+	size_t chunkCount = scheduler.Schedule(100, chunks, DF_ARRAY_LENGTH(chunks));
+
+	DF_CHECK(chunkCount == 1);
+	DF_CHECK(chunks[0].requestId == request);
+	DF_CHECK(chunks[0].size == 1200);
+	DF_CHECK(!chunks[0].lastChunk);
+
+	// With something already scheduled, a second request that doesn't fit waits for the next frame.
+	Utility::StreamScheduler secondScheduler;
+	secondScheduler.SetMinChunkSize(1000);
+	secondScheduler.Enqueue(500, 0);
+	secondScheduler.Enqueue(5000, 0);
+
+	chunkCount = secondScheduler.Schedule(1200, chunks, DF_ARRAY_LENGTH(chunks));
+
+	DF_CHECK(chunkCount == 1);
+	DF_CHECK(chunks[0].size == 500);
+	DF_CHECK(chunks[0].lastChunk);
+	DF_CHECK(secondScheduler.GetPendingBytes() == 5000);
+
+	// A zero budget never schedules anything.
+	DF_CHECK(secondScheduler.Schedule(0, chunks, DF_ARRAY_LENGTH(chunks)) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_ChunkCountLimit)
+{
+	Utility::StreamScheduler scheduler;
+
+	for(uint32_t i = 0; i < 10; ++i)
+	{
+		scheduler.Enqueue(100, 0);
+	}
+
+	Chunk chunks[4];
+
+	DF_CHECK(scheduler.Schedule(1000000, chunks, 4) == 4);
+	DF_CHECK(scheduler.GetPendingCount() == 6);
+	DF_CHECK(scheduler.Schedule(1000000, chunks, 0) == 0);
+	DF_CHECK(scheduler.Schedule(1000000, nullptr, 4) == 0);
+	DF_CHECK(scheduler.GetPendingCount() == 6);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_CancelAndClear)
+{
+	Utility::StreamScheduler scheduler;
+	scheduler.SetMinChunkSize(1);
+
+	DF_CHECK(scheduler.Enqueue(0, 0) == Utility::StreamScheduler::InvalidRequestId);
+
+	const RequestId first = scheduler.Enqueue(1000, 0);
+	const RequestId second = scheduler.Enqueue(1000, 0);
+
+	Chunk chunks[4];
+
+	// Cancelling a request that's partially streamed drops whatever it had left.
+	DF_CHECK(scheduler.Schedule(400, chunks, DF_ARRAY_LENGTH(chunks)) == 1);
+	DF_CHECK(scheduler.Cancel(first));
+	DF_CHECK(!scheduler.Cancel(first));
+	DF_CHECK(scheduler.GetPendingBytes() == 1000);
+
+	DF_CHECK(scheduler.Schedule(2000, chunks, DF_ARRAY_LENGTH(chunks)) == 1);
+	DF_CHECK(chunks[0].requestId == second);
+	DF_CHECK(chunks[0].offset == 0);
+	DF_CHECK(chunks[0].lastChunk);
+
+	scheduler.Enqueue(1000, 0);
+	scheduler.Enqueue(1000, 1);
+	scheduler.Clear();
+
+	DF_CHECK(scheduler.GetPendingCount() == 0);
+	DF_CHECK(scheduler.GetPendingBytes() == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(StreamScheduler_RandomizedCoverage)
+{
+	Test::Random random(27);
+
+	for(uint32_t runIndex = 0; runIndex < 50; ++runIndex)
+	{
+		Utility::StreamScheduler scheduler;
+
+		const uint64_t minChunkSize = random.Next(1, 4096);
+		const uint64_t byteBudget = random.Next(1, 64 * 1024);
+
+		scheduler.SetMinChunkSize(minChunkSize);
+
+		std::map<RequestId, uint64_t> requestSizes;
+		std::map<RequestId, int32_t> requestPriorities;
+
+		const uint32_t requestCount = random.Next(1, 40);
+
+		for(uint32_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+		{
+			const uint64_t size = random.Next(1, 256 * 1024);
+			const int32_t priority = int32_t(random.Next(0, 3));
+
+			const RequestId id = scheduler.Enqueue(size, priority, random.Next(0, 1000));
+
+			requestSizes[id] = size;
+			requestPriorities[id] = priority;
+		}
+
+		std::map<RequestId, uint64_t> streamedBytes;
+
+		// The forced chunk may be rounded up to the alignment, so allow for the largest alignment used above.
+		const std::vector<RequestId> order = DrainScheduler(scheduler, byteBudget, minChunkSize + 1000, streamedBytes);
+
+		DF_CHECK(order.size() == requestCount);
+		DF_CHECK(streamedBytes.size() == requestSizes.size());
+
+		for(const auto& kv : requestSizes)
+		{
+			DF_CHECK(streamedBytes[kv.first] == kv.second);
+		}
+
+		// Nothing was enqueued while draining, so requests complete in priority order, then in the order they were
+		// enqueued, which is also the order of their IDs.
+		for(size_t i = 1; i < order.size(); ++i)
+		{
+			const int32_t prevPriority = requestPriorities[order[i - 1]];
+			const int32_t priority = requestPriorities[order[i]];
+
+			DF_CHECK(prevPriority < priority || (prevPriority == priority && order[i - 1] < order[i]));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
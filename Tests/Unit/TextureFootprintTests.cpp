@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/TextureFootprint.hpp>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::TextureFootprint TextureFootprint;
+typedef TextureFootprint::FormatInfo FormatInfo;
+typedef TextureFootprint::Subresource Subresource;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static constexpr FormatInfo FormatRgba8 = { 1, 1, 4 };
+static constexpr FormatInfo FormatRgba32Float = { 1, 1, 16 };
+static constexpr FormatInfo FormatBc1 = { 4, 4, 8 };
+static constexpr FormatInfo FormatBc7 = { 4, 4, 16 };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Compare the computed layout against footprints reported by ID3D12Device::GetCopyableFootprints() for the same
+// format, dimensions and mip count, with the buffer starting at offset 0.
+static void CheckFootprint(
+	const FormatInfo& formatInfo,
+	const uint32_t width,
+	const uint32_t height,
+	const Subresource* const pExpected,
+	const uint32_t mipCount,
+	const uint64_t expectedTotalSize)
+{
+	Subresource subresources[16] = {};
+
+	DF_CHECK(mipCount <= DF_ARRAY_LENGTH(subresources));
+
+	const uint64_t totalSize = TextureFootprint::Compute(formatInfo, width, height, mipCount, subresources);
+
+	DF_CHECK(totalSize == expectedTotalSize);
+	DF_CHECK(TextureFootprint::Compute(formatInfo, width, height, mipCount, nullptr) == expectedTotalSize);
+
+	for(uint32_t i = 0; i < mipCount && i < DF_ARRAY_LENGTH(subresources); ++i)
+	{
+		DF_CHECK(subresources[i].offset == pExpected[i].offset);
+		DF_CHECK(subresources[i].rowSize == pExpected[i].rowSize);
+		DF_CHECK(subresources[i].rowPitch == pExpected[i].rowPitch);
+		DF_CHECK(subresources[i].rowCount == pExpected[i].rowCount);
+		DF_CHECK(subresources[i].width == pExpected[i].width);
+		DF_CHECK(subresources[i].height == pExpected[i].height);
+
+		DF_CHECK(subresources[i].offset % TextureFootprint::PlacementAlignment == 0);
+		DF_CHECK(subresources[i].rowPitch % TextureFootprint::PitchAlignment == 0);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(TextureFootprint_MipCount)
+{
+	DF_CHECK(TextureFootprint::GetMaxMipCount(1, 1) == 1);
+	DF_CHECK(TextureFootprint::GetMaxMipCount(2049, 1023) == 12);
+	DF_CHECK(TextureFootprint::GetMaxMipCount(1023, 2049) == 12);
+	DF_CHECK(TextureFootprint::GetMaxMipCount(2048, 2048) == 12);
+	DF_CHECK(TextureFootprint::GetMaxMipCount(8, 2) == 4);
+
+	DF_CHECK(TextureFootprint::GetMipDimension(2049, 1) == 1024);
+	DF_CHECK(TextureFootprint::GetMipDimension(1023, 11) == 1);
+	DF_CHECK(TextureFootprint::GetMipDimension(1, 40) == 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(TextureFootprint_NonPowerOfTwoRgba8)
+{
+	// offset, rowSize, rowPitch, rowCount, width, height
+	const Subresource expected[] =
+	{
+		{        0, 8196, 8448, 1023, 2049, 1023 },
+		{  8642560, 4096, 4096,  511, 1024,  511 },
+		{ 10735616, 2048, 2048,  255,  512,  255 },
+		{ 11257856, 1024, 1024,  127,  256,  127 },
+		{ 11387904,  512,  512,   63,  128,   63 },
+		{ 11420160,  256,  256,   31,   64,   31 },
+		{ 11428352,  128,  256,   15,   32,   15 },
+		{ 11432448,   64,  256,    7,   16,    7 },
+		{ 11434496,   32,  256,    3,    8,    3 },
+		{ 11435520,   16,  256,    1,    4,    1 },
+		{ 11436032,    8,  256,    1,    2,    1 },
+		{ 11436544,    4,  256,    1,    1,    1 },
+	};
+
+	CheckFootprint(FormatRgba8, 2049, 1023, expected, DF_ARRAY_LENGTH(expected), 11436548);
+
+	// A single mip is the first entry of the full chain, and its last row isn't padded out to the pitch.
+	CheckFootprint(FormatRgba8, 2049, 1023, expected, 1, 8642052);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(TextureFootprint_BlockCompressedSmallMips)
+{
+	// Mips below 4x4 still take up a whole block, and their footprint is rounded up to the block size.
+	{
+		const Subresource expected[] =
+		{
+			{    0, 32, 256, 4, 16, 16 },
+			{ 1024, 16, 256, 2,  8,  8 },
+			{ 1536,  8, 256, 1,  4,  4 },
+			{ 2048,  8, 256, 1,  4,  4 },
+			{ 2560,  8, 256, 1,  4,  4 },
+		};
+
+		CheckFootprint(FormatBc1, 16, 16, expected, DF_ARRAY_LENGTH(expected), 2568);
+		CheckFootprint(FormatBc1, 16, 16, expected, 1, 800);
+	}
+
+	{
+		const Subresource expected[] =
+		{
+			{    0, 32, 256, 1, 8, 4 },
+			{  512, 16, 256, 1, 4, 4 },
+			{ 1024, 16, 256, 1, 4, 4 },
+			{ 1536, 16, 256, 1, 4, 4 },
+		};
+
+		CheckFootprint(FormatBc7, 8, 2, expected, DF_ARRAY_LENGTH(expected), 1552);
+		CheckFootprint(FormatBc7, 8, 2, expected, 1, 32);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(TextureFootprint_Rgba32Float)
+{
+	const Subresource expected[] =
+	{
+		{      0, 1600, 1792, 60, 100, 60 },
+		{ 107520,  800, 1024, 30,  50, 30 },
+		{ 138240,  400,  512, 15,  25, 15 },
+		{ 145920,  192,  256,  7,  12,  7 },
+		{ 147968,   96,  256,  3,   6,  3 },
+		{ 148992,   48,  256,  1,   3,  1 },
+		{ 149504,   16,  256,  1,   1,  1 },
+	};
+
+	CheckFootprint(FormatRgba32Float, 100, 60, expected, DF_ARRAY_LENGTH(expected), 149520);
+	CheckFootprint(FormatRgba32Float, 100, 60, expected, 1, 107328);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(TextureFootprint_InvalidFormat)
+{
+	const FormatInfo invalidFormat = { 0, 0, 0 };
+
+	DF_CHECK(TextureFootprint::Compute(invalidFormat, 64, 64, 1, nullptr) == 0);
+	DF_CHECK(TextureFootprint::Compute(FormatRgba8, 64, 64, 0, nullptr) == 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
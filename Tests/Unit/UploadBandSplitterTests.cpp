@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Utility/UploadBandSplitter.hpp>
+
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef Utility::UploadBandSplitter UploadBandSplitter;
+typedef Utility::TextureFootprint TextureFootprint;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static TextureFootprint::Subresource MakeSubresource(const uint64_t rowSize, const uint32_t rowPitch, const uint32_t rowCount)
+{
+	TextureFootprint::Subresource subresource = {};
+
+	subresource.rowSize = rowSize;
+	subresource.rowPitch = rowPitch;
+	subresource.rowCount = rowCount;
+
+	return subresource;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Split every subresource and check that the bands cover each row exactly once, in order, while staying inside the
+// window and never overlapping another band of the same submission. Returns the number of submissions used.
+static uint32_t CheckBands(
+	const TextureFootprint::Subresource* const pSubresources,
+	const uint32_t subresourceCount,
+	const uint64_t windowSize,
+	std::vector<UploadBandSplitter::Band>* const pOutBands = nullptr)
+{
+	UploadBandSplitter splitter;
+
+	DF_CHECK(splitter.Reset(pSubresources, subresourceCount, windowSize));
+
+	UploadBandSplitter::Band band;
+
+	uint32_t subresourceIndex = 0;
+	uint32_t nextRow = 0;
+	uint32_t submission = 0;
+	uint64_t windowEnd = 0;
+	bool first = true;
+
+	while(splitter.Next(band))
+	{
+		while(subresourceIndex < subresourceCount && nextRow >= pSubresources[subresourceIndex].rowCount)
+		{
+			++subresourceIndex;
+			nextRow = 0;
+		}
+
+		DF_CHECK(subresourceIndex < subresourceCount);
+
+		if(subresourceIndex >= subresourceCount)
+		{
+			break;
+		}
+
+		const TextureFootprint::Subresource& subresource = pSubresources[subresourceIndex];
+
+		DF_CHECK(band.subresource == subresourceIndex);
+		DF_CHECK(band.firstRow == nextRow);
+		DF_CHECK(band.rowCount > 0);
+		DF_CHECK(band.firstRow + band.rowCount <= subresource.rowCount);
+
+		// The last row of a band takes up only the row size, not the full pitch.
+		DF_CHECK(band.size == (uint64_t(subresource.rowPitch) * (band.rowCount - 1)) + subresource.rowSize);
+
+		DF_CHECK((band.windowOffset % TextureFootprint::PlacementAlignment) == 0);
+		DF_CHECK(band.windowOffset + band.size <= windowSize);
+
+		if(first)
+		{
+			DF_CHECK(band.submission == 0);
+			DF_CHECK(band.windowOffset == 0);
+		}
+		else if(band.submission == submission)
+		{
+			// Bands of the same submission are packed one after another.
+			DF_CHECK(band.windowOffset >= windowEnd);
+		}
+		else
+		{
+			// Each new submission starts over at the beginning of the window, one at a time.
+			DF_CHECK(band.submission == submission + 1);
+			DF_CHECK(band.windowOffset == 0);
+		}
+
+		submission = band.submission;
+		windowEnd = band.windowOffset + band.size;
+		nextRow += band.rowCount;
+		first = false;
+
+		if(pOutBands)
+		{
+			pOutBands->push_back(band);
+		}
+	}
+
+	while(subresourceIndex < subresourceCount && nextRow >= pSubresources[subresourceIndex].rowCount)
+	{
+		++subresourceIndex;
+		nextRow = 0;
+	}
+
+	// Every row of every subresource was handed out, and nothing is left once the splitter is done.
+	DF_CHECK(subresourceIndex == subresourceCount);
+	DF_CHECK(!splitter.Next(band));
+
+	return first ? 0 : (submission + 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_ResetValidation)
+{
+	UploadBandSplitter splitter;
+
+	const TextureFootprint::Subresource subresources[] =
+	{
+		MakeSubresource(1024, 1024, 4),
+		MakeSubresource(512, 512, 2),
+		MakeSubresource(256, 256, 0),
+	};
+
+	TextureFootprint::Subresource tooMany[DF_UPLOAD_BAND_SPLITTER_MAX_SUBRESOURCE_COUNT + 1];
+
+	for(TextureFootprint::Subresource& subresource : tooMany)
+	{
+		subresource = MakeSubresource(256, 256, 1);
+	}
+
+	DF_CHECK(!splitter.Reset(nullptr, 1, 4096));
+	DF_CHECK(!splitter.Reset(tooMany, DF_ARRAY_LENGTH(tooMany), 4096));
+	DF_CHECK(splitter.Reset(tooMany, DF_ARRAY_LENGTH(tooMany) - 1, 4096));
+
+	// A single row larger than the window can never be uploaded.
+	DF_CHECK(!splitter.Reset(subresources, DF_ARRAY_LENGTH(subresources), 1023));
+	DF_CHECK(splitter.Reset(subresources, DF_ARRAY_LENGTH(subresources), 1024));
+
+	// A failed reset leaves nothing to split.
+	UploadBandSplitter::Band band;
+
+	DF_CHECK(!splitter.Reset(subresources, DF_ARRAY_LENGTH(subresources), 512));
+	DF_CHECK(!splitter.Next(band));
+
+	// Subresources without any rows are skipped rather than rejected.
+	DF_CHECK(splitter.Reset(subresources + 2, 1, 128));
+	DF_CHECK(!splitter.Next(band));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_FittingRowCount)
+{
+	const TextureFootprint::Subresource subresource = MakeSubresource(400, 512, 10);
+
+	// The last row only needs the row size, so a window of exactly (n - 1) pitches plus one row holds n rows.
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 0, (512 * 3) + 400) == 4);
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 0, (512 * 3) + 399) == 3);
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 512, (512 * 3) + 400) == 3);
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 0, 399) == 0);
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 4096, 4096) == 0);
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 5000, 4096) == 0);
+
+	// Never more rows than the subresource has.
+	DF_CHECK(UploadBandSplitter::GetFittingRowCount(subresource, 0, 1024 * 1024) == 10);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_WindowWrap)
+{
+	// 400 byte rows at a 512 byte pitch; eight rows fit in the 4 KiB window with the last one unpadded.
+	const TextureFootprint::Subresource subresources[] =
+	{
+		MakeSubresource(400, 512, 10),
+		MakeSubresource(200, 256, 3),
+	};
+
+	std::vector<UploadBandSplitter::Band> bands;
+
+	DF_CHECK(CheckBands(subresources, DF_ARRAY_LENGTH(subresources), 4096, &bands) == 2);
+	DF_CHECK(bands.size() == 3);
+
+	if(bands.size() == 3)
+	{
+		DF_CHECK(bands[0].subresource == 0 && bands[0].firstRow == 0 && bands[0].rowCount == 8);
+		DF_CHECK(bands[0].submission == 0 && bands[0].windowOffset == 0);
+		DF_CHECK(bands[0].size == (512 * 7) + 400);
+
+		// The rest of the first subresource doesn't fit in what's left, so it starts a new submission.
+		DF_CHECK(bands[1].subresource == 0 && bands[1].firstRow == 8 && bands[1].rowCount == 2);
+		DF_CHECK(bands[1].submission == 1 && bands[1].windowOffset == 0);
+		DF_CHECK(bands[1].size == 512 + 400);
+
+		// The next subresource is packed right after it, at the placement alignment.
+		DF_CHECK(bands[2].subresource == 1 && bands[2].firstRow == 0 && bands[2].rowCount == 3);
+		DF_CHECK(bands[2].submission == 1 && bands[2].windowOffset == 1024);
+		DF_CHECK(bands[2].size == (256 * 2) + 200);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_PlacementAlignment)
+{
+	// Every mip of a 64x64 RGBA8 texture is small enough to share the window; each one starts at a 512 byte boundary.
+	const TextureFootprint::FormatInfo formatInfo = { 1, 1, 4 };
+
+	TextureFootprint::Subresource subresources[7];
+
+	const uint64_t totalSize = TextureFootprint::Compute(formatInfo, 64, 64, DF_ARRAY_LENGTH(subresources), subresources);
+
+	std::vector<UploadBandSplitter::Band> bands;
+
+	DF_CHECK(CheckBands(subresources, DF_ARRAY_LENGTH(subresources), totalSize, &bands) == 1);
+	DF_CHECK(bands.size() == DF_ARRAY_LENGTH(subresources));
+
+	// With the whole footprint as the window, the bands land exactly where the footprint puts each mip.
+	for(size_t index = 0; index < bands.size(); ++index)
+	{
+		DF_CHECK(bands[index].windowOffset == subresources[index].offset);
+		DF_CHECK(bands[index].rowCount == subresources[index].rowCount);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_BlockCompressedRows)
+{
+	// BC1: 4x4 blocks of 8 bytes. A 256x256 texture has 64 rows of 64 blocks per row, 512 bytes each.
+	const TextureFootprint::FormatInfo formatInfo = { 4, 4, 8 };
+
+	TextureFootprint::Subresource subresources[9];
+
+	TextureFootprint::Compute(formatInfo, 256, 256, DF_ARRAY_LENGTH(subresources), subresources);
+
+	DF_CHECK(subresources[0].rowCount == 64);
+	DF_CHECK(subresources[0].rowSize == 512);
+
+	std::vector<UploadBandSplitter::Band> bands;
+
+	// A 4 KiB window holds 8 rows of blocks, or 32 rows of texels, at a time.
+	CheckBands(subresources, DF_ARRAY_LENGTH(subresources), 4096, &bands);
+
+	DF_CHECK(bands.size() >= 8);
+
+	for(uint32_t index = 0; index < 8 && index < bands.size(); ++index)
+	{
+		DF_CHECK(bands[index].subresource == 0);
+		DF_CHECK(bands[index].firstRow == index * 8);
+		DF_CHECK(bands[index].rowCount == 8);
+		DF_CHECK(bands[index].submission == index);
+	}
+
+	// The smallest mips are still a whole block, which is a single row.
+	DF_CHECK(bands.back().subresource == DF_ARRAY_LENGTH(subresources) - 1);
+	DF_CHECK(bands.back().rowCount == 1);
+	DF_CHECK(bands.back().size == 8);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(UploadBandSplitter_RandomizedCoverage)
+{
+	Test::Random random(40);
+
+	const TextureFootprint::FormatInfo formatInfos[] =
+	{
+		{ 1, 1, 4 },
+		{ 1, 1, 8 },
+		{ 1, 1, 16 },
+		{ 4, 4, 8 },
+		{ 4, 4, 16 },
+	};
+
+	TextureFootprint::Subresource subresources[DF_UPLOAD_BAND_SPLITTER_MAX_SUBRESOURCE_COUNT];
+
+	for(uint32_t round = 0; round < 200; ++round)
+	{
+		const TextureFootprint::FormatInfo& formatInfo = formatInfos[random.Next(0, DF_ARRAY_LENGTH(formatInfos) - 1)];
+
+		const uint32_t width = random.Next(1, 1024);
+		const uint32_t height = random.Next(1, 1024);
+		const uint32_t maxMipCount = TextureFootprint::GetMaxMipCount(width, height);
+		const uint32_t mipCount = random.Next(1, (maxMipCount < DF_ARRAY_LENGTH(subresources)) ? maxMipCount : DF_ARRAY_LENGTH(subresources));
+
+		TextureFootprint::Compute(formatInfo, width, height, mipCount, subresources);
+
+		// Anywhere from a window that holds just the widest row to one that holds everything.
+		const uint64_t windowSize = subresources[0].rowSize + random.Next(0, 64 * 1024);
+
+		CheckBands(subresources, mipCount, windowSize);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include <TestFramework.hpp>
+
+#include <DemoFramework/Direct3D12/WavefrontObjIndex.hpp>
+
+#include <tiny_obj_loader.h>
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+
+using namespace DemoFramework;
+
+typedef D3D12::WavefrontObjIndex WavefrontObjIndex;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static const char* const TestObjFilePath = "wavefront-obj-index-test.obj";
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Covers every way a statement can start or end a shape. The expected shapes follow how tinyobjloader splits a full
+// load of the same file.
+static const char* const ShapeBoundaryObj =
+	"v 0 0 0\n"
+	"v 1 1 1\n"
+	"v 2 2 2\n"
+	"v 3 3 3\n"
+	"f 1 2 3\n"           // Faces before any 'o' or 'g' go in an unnamed shape.
+	"o a\n"
+	"f 1 2 3\n"
+	"g b c\n"             // Groups are named after their first name only.
+	"f 2 3 4\n"
+	"o a\n"               // Reusing a name still starts a new shape.
+	"usemtl red\n"        // Material changes don't split shapes.
+	"f 1 3 4\n"
+	"g\n"                 // A bare keyword isn't a statement, so the faces below stay in the previous shape.
+	"f 1 2 4\r\n"
+	"g empty\n"           // Shapes without faces are dropped.
+	"v 4 4 4\n"
+	"o  padded \n"        // Objects are named with the rest of the line after the keyword and a single separator.
+	"f -3 -2 -1\n";
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool WriteTestFile(const char* const contents)
+{
+	FILE* const pFile = fopen(TestObjFilePath, "wb");
+	if(!pFile)
+	{
+		return false;
+	}
+
+	const size_t length = strlen(contents);
+	const bool result = (fwrite(contents, 1, length, pFile) == length);
+
+	fclose(pFile);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Parse a single indexed shape back into tinyobjloader structures.
+static bool ParseShape(
+	const WavefrontObjIndex& index,
+	const size_t shapeIndex,
+	tinyobj::attrib_t& outAttrib,
+	std::vector<tinyobj::shape_t>& outShapes)
+{
+	FILE* const pFile = fopen(TestObjFilePath, "rb");
+	if(!pFile)
+	{
+		return false;
+	}
+
+	const std::vector<const WavefrontObjIndex::Shape*> selectedShapes = { &index.GetShapes()[shapeIndex] };
+	const bool result = index.ParseShapes(pFile, selectedShapes, outAttrib, outShapes);
+
+	fclose(pFile);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(WavefrontObjIndex_ShapeBoundaries)
+{
+	DF_CHECK(WriteTestFile(ShapeBoundaryObj));
+
+	const WavefrontObjIndex::Ptr index = WavefrontObjIndex::Build(TestObjFilePath);
+	DF_CHECK(index != nullptr);
+
+	if(!index)
+	{
+		remove(TestObjFilePath);
+		return;
+	}
+
+	struct ExpectedShape
+	{
+		const char* name;
+		size_t faceRangeCount;
+	};
+
+	const ExpectedShape expectedShapes[] =
+	{
+		{ "",         1 },
+		{ "a",        1 },
+		{ "b",        1 },
+		{ "a",        1 },
+		{ " padded ", 1 },
+	};
+
+	const std::vector<WavefrontObjIndex::Shape>& shapes = index->GetShapes();
+	DF_CHECK(shapes.size() == DF_ARRAY_LENGTH(expectedShapes));
+
+	for(size_t i = 0; i < shapes.size() && i < DF_ARRAY_LENGTH(expectedShapes); ++i)
+	{
+		DF_CHECK(shapes[i].name == expectedShapes[i].name);
+		DF_CHECK(shapes[i].faceRanges.size() == expectedShapes[i].faceRangeCount);
+	}
+
+	DF_CHECK(index->GetAttributeRanges(WavefrontObjIndex::Position).size() == 2);
+	DF_CHECK(index->GetAttributeRanges(WavefrontObjIndex::TexCoord).empty());
+	DF_CHECK(index->GetAttributeRanges(WavefrontObjIndex::Normal).empty());
+
+	remove(TestObjFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(WavefrontObjIndex_ParseShapesMatchesFullLoad)
+{
+	DF_CHECK(WriteTestFile(ShapeBoundaryObj));
+
+	const WavefrontObjIndex::Ptr index = WavefrontObjIndex::Build(TestObjFilePath);
+	DF_CHECK(index != nullptr && index->GetShapes().size() == 5);
+
+	if(!index || index->GetShapes().size() != 5)
+	{
+		remove(TestObjFilePath);
+		return;
+	}
+
+	// The second "a" shape keeps the face that follows the bare 'g' keyword.
+	{
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+
+		DF_CHECK(ParseShape(*index, 3, attrib, shapes));
+		DF_CHECK(shapes.size() == 1);
+
+		if(shapes.size() == 1)
+		{
+			const int expectedIndices[] = { 0, 2, 3, 0, 1, 3 };
+
+			DF_CHECK(shapes[0].name == "a");
+			DF_CHECK(shapes[0].mesh.num_face_vertices.size() == 2);
+			DF_CHECK(shapes[0].mesh.indices.size() == DF_ARRAY_LENGTH(expectedIndices));
+
+			for(size_t i = 0; i < shapes[0].mesh.indices.size() && i < DF_ARRAY_LENGTH(expectedIndices); ++i)
+			{
+				DF_CHECK(shapes[0].mesh.indices[i].vertex_index == expectedIndices[i]);
+				DF_CHECK(shapes[0].mesh.indices[i].texcoord_index == -1);
+				DF_CHECK(shapes[0].mesh.indices[i].normal_index == -1);
+			}
+		}
+
+		DF_CHECK(attrib.vertices.size() == 4 * 3);
+	}
+
+	// Relative indices resolve against the attributes declared before the face, and the attribute arrays are
+	// compacted to just the referenced range.
+	{
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+
+		DF_CHECK(ParseShape(*index, 4, attrib, shapes));
+		DF_CHECK(shapes.size() == 1);
+
+		if(shapes.size() == 1)
+		{
+			DF_CHECK(shapes[0].mesh.indices.size() == 3);
+
+			for(size_t i = 0; i < shapes[0].mesh.indices.size(); ++i)
+			{
+				DF_CHECK(shapes[0].mesh.indices[i].vertex_index == int(i));
+			}
+		}
+
+		DF_CHECK(attrib.vertices.size() == 3 * 3);
+
+		for(size_t i = 0; i < attrib.vertices.size(); ++i)
+		{
+			DF_CHECK(attrib.vertices[i] == tinyobj::real_t((i / 3) + 2));
+		}
+	}
+
+	remove(TestObjFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DF_TEST_CASE(WavefrontObjIndex_SaveAndLoad)
+{
+	DF_CHECK(WriteTestFile(ShapeBoundaryObj));
+
+	const std::string indexFilePath = std::string(TestObjFilePath) + DF_OBJ_INDEX_FILE_EXTENSION;
+	remove(indexFilePath.c_str());
+
+	// The first call builds and saves the index, the second loads the saved copy.
+	const WavefrontObjIndex::Ptr builtIndex = WavefrontObjIndex::LoadOrBuild(TestObjFilePath);
+	const WavefrontObjIndex::Ptr loadedIndex = WavefrontObjIndex::LoadOrBuild(TestObjFilePath);
+
+	DF_CHECK(builtIndex != nullptr);
+	DF_CHECK(loadedIndex != nullptr);
+
+	if(builtIndex && loadedIndex)
+	{
+		const std::vector<WavefrontObjIndex::Shape>& builtShapes = builtIndex->GetShapes();
+		const std::vector<WavefrontObjIndex::Shape>& loadedShapes = loadedIndex->GetShapes();
+
+		DF_CHECK(builtShapes.size() == loadedShapes.size());
+
+		for(size_t i = 0; i < builtShapes.size() && i < loadedShapes.size(); ++i)
+		{
+			DF_CHECK(builtShapes[i].name == loadedShapes[i].name);
+			DF_CHECK(builtShapes[i].faceRanges.size() == loadedShapes[i].faceRanges.size());
+			DF_CHECK(memcmp(builtShapes[i].minIndex, loadedShapes[i].minIndex, sizeof(builtShapes[i].minIndex)) == 0);
+			DF_CHECK(memcmp(builtShapes[i].maxIndex, loadedShapes[i].maxIndex, sizeof(builtShapes[i].maxIndex)) == 0);
+		}
+	}
+
+	remove(indexFilePath.c_str());
+	remove(TestObjFilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
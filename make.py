@@ -128,6 +128,10 @@ with csbuild.Toolchain("msvc"):
 		"/Zc:__cplusplus",
 		"/EHsc",
 		"/W4",
+
+		# The SIMD and scalar paths of the CPU image code are expected to produce the same bits, which
+		# only holds as long as the compiler doesn't fuse multiplies and adds on its own.
+		"/fp:precise",
 	)
 
 ########################################################################################################################
@@ -479,3 +483,62 @@ with csbuild.Project(SampleEnvDiffuse.projectName, SampleEnvDiffuse.path, Sample
 	)
 
 ###################################################################################################
+
+class Tests(object):
+	rootPath = f"{_REPO_ROOT_PATH}/Tests"
+	commonPath = f"{rootPath}/Common"
+
+	# Framework classes that aren't exported from the framework DLL are compiled directly into the tests that use them.
+	internalSourceFiles = [
+		f"{LibDemoFramework.sourcePath}/DemoFramework/Direct3D12/WavefrontObjIndex.cpp",
+	]
+
+###################################################################################################
+
+class TestUnit(object):
+	projectName = "Test-Unit"
+	outputName = "unit-tests"
+	path = f"{Tests.rootPath}/Unit"
+	dependencies = [
+		ExtLibTinyObjLoader.projectName,
+		LibDemoFramework.projectName,
+	]
+
+with csbuild.Project(TestUnit.projectName, TestUnit.path, TestUnit.dependencies, autoDiscoverSourceFiles=False):
+	csbuild.SetOutput(TestUnit.outputName, csbuild.ProjectType.Application)
+
+	csbuild.AddIncludeDirectories(
+		Tests.commonPath,
+	)
+	csbuild.AddSourceDirectories(
+		Tests.commonPath,
+		TestUnit.path,
+	)
+	csbuild.AddSourceFiles(*Tests.internalSourceFiles)
+
+###################################################################################################
+
+class TestBenchmark(object):
+	projectName = "Test-Benchmark"
+	outputName = "benchmarks"
+	path = f"{Tests.rootPath}/Benchmark"
+	dependencies = [
+		ExtLibDirectXTex.projectName,
+		ExtLibStb.projectName,
+		ExtLibTinyObjLoader.projectName,
+		LibDemoFramework.projectName,
+	]
+
+with csbuild.Project(TestBenchmark.projectName, TestBenchmark.path, TestBenchmark.dependencies, autoDiscoverSourceFiles=False):
+	csbuild.SetOutput(TestBenchmark.outputName, csbuild.ProjectType.Application)
+
+	csbuild.AddIncludeDirectories(
+		Tests.commonPath,
+	)
+	csbuild.AddSourceDirectories(
+		Tests.commonPath,
+		TestBenchmark.path,
+	)
+	csbuild.AddSourceFiles(*Tests.internalSourceFiles)
+
+###################################################################################################